@@ -16,6 +16,8 @@ limitations under the License.
 
 #include "JsonObjects.h"
 
+#include <sstream>
+
 #include "helpers.h"
 #include "lib/json.h"
 
@@ -125,6 +127,7 @@ unsigned JsonObjects::add_header_type(const cstring &name, Util::JsonArray *&fie
     header_type_id[sname] = id;
     header_type->emplace("name", name);
     header_type->emplace("id", id);
+    map_header_type.emplace(name, header_type);
     if (fields != nullptr) {
         header_type->emplace("fields", fields);
     } else {
@@ -167,6 +170,7 @@ unsigned JsonObjects::add_header_type(const cstring &name) {
     header_type_id[sname] = id;
     header_type->emplace("name", name);
     header_type->emplace("id", id);
+    map_header_type.emplace(name, header_type);
     auto temp = new Util::JsonArray();
     header_type->emplace("fields", temp);
     header_types->append(header_type);
@@ -177,9 +181,10 @@ unsigned JsonObjects::add_header_type(const cstring &name) {
 /// The header type is decribed by the name.
 void JsonObjects::add_header_field(const cstring &name, Util::JsonArray *&field) {
     CHECK_NULL(field);
-    Util::JsonObject *headerType = find_object_by_name(header_types, name);
-    Util::JsonArray *fields = headerType->get("fields")->to<Util::JsonArray>();
-    BUG_CHECK(fields != nullptr, "header '%1%' not found", name);
+    auto it = map_header_type.find(name);
+    BUG_CHECK(it != map_header_type.end(), "header '%1%' not found", name);
+    Util::JsonArray *fields = it->second->get("fields")->to<Util::JsonArray>();
+    CHECK_NULL(fields);
     fields->append(field);
 }
 
@@ -269,9 +274,10 @@ void JsonObjects::add_error(const cstring &name, const unsigned type) {
 void JsonObjects::add_enum(const cstring &enum_name, const cstring &entry_name,
                            const unsigned entry_value) {
     // look up enum in json by name
-    Util::JsonObject *enum_json = find_object_by_name(enums, enum_name);
+    Util::JsonObject *enum_json = ::get(map_enum, enum_name);
     if (enum_json == nullptr) {  // first entry in a new enum
         enum_json = new Util::JsonObject();
+        map_enum.emplace(enum_name, enum_json);
         enum_json->emplace("name", enum_name);
         auto entries = insert_array_field(enum_json, "entries");
         auto entry = new Util::JsonArray();
@@ -373,9 +379,18 @@ unsigned JsonObjects::add_action(const cstring &name, Util::JsonArray *&params,
                                  Util::JsonArray *&body) {
     CHECK_NULL(params);
     CHECK_NULL(body);
+    // Copies of an action made for each table or control convert to the same
+    // JSON; they are emitted once, and all tables use the same id.
+    std::stringstream key;
+    key << name << " ";
+    params->serialize(key, true);
+    body->serialize(key, true);
+    auto it = action_ids.find(key.str());
+    if (it != action_ids.end()) return it->second;
     auto action = new Util::JsonObject();
     action->emplace("name", name);
     unsigned id = BMV2::nextId("actions");
+    action_ids.emplace(key.str(), id);
     action->emplace("id", id);
     action->emplace("runtime_data", params);
     action->emplace("primitives", body);
@@ -18,6 +18,7 @@ limitations under the License.
 #define BACKENDS_BMV2_COMMON_JSONOBJECTS_H_
 
 #include <map>
+#include <unordered_map>
 
 #include "lib/json.h"
 #include "lib/ordered_map.h"
@@ -83,6 +84,12 @@ class JsonObjects {
     Util::JsonArray *header_union_stacks;
     ordered_map<std::string, unsigned> header_type_id;
     ordered_map<std::string, unsigned> union_type_id;
+    // Header types and enums by name, so that adding fields or entries to
+    // them does not search the arrays.
+    std::map<cstring, Util::JsonObject *> map_header_type;
+    std::map<cstring, Util::JsonObject *> map_enum;
+    // Actions by name, parameters and body.
+    std::unordered_map<std::string, unsigned> action_ids;
     Util::JsonArray *learn_lists;
     Util::JsonArray *meter_arrays;
     Util::JsonArray *parsers;
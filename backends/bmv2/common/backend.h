@@ -77,7 +77,9 @@ class Backend {
           json(new BMV2::JsonObjects()) {
         refMap->setIsV1(options.isv1());
     }
-    void serialize(std::ostream &out) const { json->toplevel->serialize(out); }
+    void serialize(std::ostream &out) const {
+        json->toplevel->serialize(out, options.compactJson);
+    }
     virtual void convert(const IR::ToplevelBlock *block) = 0;
 };
 
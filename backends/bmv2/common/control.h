@@ -29,6 +29,7 @@ limitations under the License.
 #include "lib/algorithm.h"
 #include "lib/json.h"
 #include "midend/convertEnums.h"
+#include "options.h"
 #include "sharedActionSelectorCheck.h"
 
 namespace BMV2 {
@@ -763,6 +764,8 @@ class ControlConverter : public Inspector {
         cfg->build(cont, ctxt->refMap, ctxt->typeMap);
         bool success = cfg->checkImplementable();
         if (!success) return false;
+        if (BMV2Context::get().options().optimizeControlGraph)
+            cfg->optimize(ctxt->refMap, ctxt->typeMap);
 
         if (cfg->entryPoint->successors.size() == 0) {
             result->emplace("init_table", Util::JsonValue::null);
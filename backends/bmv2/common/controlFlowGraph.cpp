@@ -163,6 +163,146 @@ bool CFG::checkImplementable() const {
     return true;
 }
 
+void CFG::bypass(Node *from, Node *to) {
+    for (auto e : from->successors.edges) {
+        ordered_set<Edge *> predecessors;
+        for (auto p : e->endpoint->predecessors.edges)
+            if (p->endpoint != from) predecessors.emplace(p);
+        e->endpoint->predecessors.edges = predecessors;
+    }
+    for (auto p : from->predecessors.edges) {
+        BUG_CHECK(to != nullptr, "%1%: cannot remove a reachable node", from->name);
+        auto predecessor = p->endpoint;
+        ordered_set<Edge *> successors;
+        for (auto e : predecessor->successors.edges)
+            successors.emplace(e->endpoint == from ? e->clone(to) : e);
+        predecessor->successors.edges = successors;
+        to->predecessors.emplace(p);
+    }
+    allNodes.erase(from);
+}
+
+bool CFG::mergeConditionals(IfNode *node, P4::TypeMap *typeMap) {
+    auto branch = [](Node *node, bool value) -> Node * {
+        for (auto e : node->successors.edges)
+            if (e->isBool() && e->getBool() == value) return e->endpoint;
+        return nullptr;
+    };
+    for (bool value : {true, false}) {
+        // if (a) { if (b) X else Y } else Y  =>  if (a && b) X else Y
+        // if (a) X else { if (b) X else Y }  =>  if (a || b) X else Y
+        auto next = branch(node, value);
+        auto nextIf = next ? next->to<IfNode>() : nullptr;
+        if (nextIf == nullptr || nextIf->predecessors.size() != 1) continue;
+        auto shared = branch(node, !value);
+        if (shared == nullptr || branch(nextIf, !value) != shared) continue;
+        auto kept = branch(nextIf, value);
+        if (kept == nullptr) continue;
+
+        auto statement = node->statement;
+        auto left = statement->condition;
+        auto right = nextIf->statement->condition;
+        IR::Expression *condition;
+        if (value)
+            condition = new IR::LAnd(left->srcInfo + right->srcInfo, left, right);
+        else
+            condition = new IR::LOr(left->srcInfo + right->srcInfo, left, right);
+        typeMap->setType(condition, IR::Type_Boolean::get());
+        node->statement = new IR::IfStatement(statement->srcInfo, condition, statement->ifTrue,
+                                              statement->ifFalse);
+        LOG2("Merged conditional " << nextIf->name << " into " << node->name);
+
+        // The conditional now leads to the other successor of the merged one.
+        nextIf->predecessors = EdgeSet();
+        bypass(nextIf, nullptr);
+        ordered_set<Edge *> successors;
+        for (auto e : node->successors.edges)
+            successors.emplace(e->endpoint == nextIf ? e->clone(kept) : e);
+        node->successors.edges = successors;
+        kept->predecessors.emplace(new Edge(node, value));
+        return true;
+    }
+    return false;
+}
+
+CFG::Node *CFG::emptyTableDestination(TableNode *node, P4::ReferenceMap *refMap) const {
+    auto table = node->table;
+    auto key = table->getKey();
+    if (key != nullptr && !key->keyElements.empty()) return nullptr;
+    // Any other property, such as entries, counters or an implementation, has an effect.
+    for (auto property : table->properties->properties) {
+        if (property->name != IR::TableProperties::keyPropertyName &&
+            property->name != IR::TableProperties::actionsPropertyName &&
+            property->name != IR::TableProperties::defaultActionPropertyName &&
+            property->name != IR::TableProperties::sizePropertyName)
+            return nullptr;
+    }
+    auto defaultAction =
+        table->properties->getProperty(IR::TableProperties::defaultActionPropertyName);
+    if (defaultAction == nullptr || !defaultAction->isConstant) return nullptr;
+    auto expression = table->getDefaultAction();
+    if (auto mce = expression->to<IR::MethodCallExpression>()) expression = mce->method;
+    auto path = expression->to<IR::PathExpression>();
+    if (path == nullptr) return nullptr;
+    auto action = refMap->getDeclaration(path->path, true)->to<IR::P4Action>();
+    if (action == nullptr || !action->body->components.empty()) return nullptr;
+
+    // A table without a key always misses and runs its default action.
+    Node *miss = nullptr, *actionLabel = nullptr, *defaultLabel = nullptr;
+    Node *unconditional = nullptr;
+    for (auto e : node->successors.edges) {
+        if (e->isBool()) {
+            if (!e->getBool()) miss = e->endpoint;
+        } else if (e->isUnconditional()) {
+            unconditional = e->endpoint;
+        } else if (e->label == path->path->name.name) {
+            actionLabel = e->endpoint;
+        } else if (e->label == "default") {
+            defaultLabel = e->endpoint;
+        }
+    }
+    if (miss != nullptr) return miss;
+    if (actionLabel != nullptr) return actionLabel;
+    if (defaultLabel != nullptr) return defaultLabel;
+    return unconditional;
+}
+
+void CFG::optimize(P4::ReferenceMap *refMap, P4::TypeMap *typeMap) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        std::vector<Node *> nodes(allNodes.begin(), allNodes.end());
+        for (auto node : nodes) {
+            if (node == entryPoint || node == exitPoint || !allNodes.count(node)) continue;
+            if (node->predecessors.size() == 0) {
+                LOG2("Removing unreachable node " << node->name);
+                bypass(node, nullptr);
+                changed = true;
+            } else if (auto in = node->to<IfNode>()) {
+                // Conditions have no side effects, so a conditional whose branches
+                // meet right away can be skipped.
+                auto first = (*in->successors.edges.begin())->endpoint;
+                bool same = true;
+                for (auto e : in->successors.edges) same = same && e->endpoint == first;
+                if (same) {
+                    LOG2("Removing conditional " << in->name);
+                    bypass(in, first);
+                    changed = true;
+                } else if (mergeConditionals(in, typeMap)) {
+                    changed = true;
+                }
+            } else if (auto tn = node->to<TableNode>()) {
+                if (auto destination = emptyTableDestination(tn, refMap)) {
+                    LOG2("Removing empty table " << tn->name);
+                    bypass(tn, destination);
+                    changed = true;
+                }
+            }
+        }
+    }
+    LOG2(this);
+}
+
 namespace {
 class CFGBuilder : public Inspector {
     CFG *cfg;
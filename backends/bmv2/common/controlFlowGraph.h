@@ -185,6 +185,11 @@ class CFG final : public IHasDbPrint {
     /// BMv2 is very restricted in the kinds of graphs it supports.
     /// Thie method checks whether a CFG is implementable.
     bool checkImplementable() const;
+    /// Reduces the number of nodes BMv2 traverses: nested conditionals sharing a
+    /// destination are merged into a single conditional, conditionals whose branches
+    /// lead to the same node are removed, and so are tables that can only run an
+    /// empty constant default action.  Must be called on an implementable CFG.
+    void optimize(P4::ReferenceMap *refMap, P4::TypeMap *typeMap);
 
  private:
     bool dfs(Node *node, std::set<Node *> &visited, std::set<const IR::P4Table *> &stack) const;
@@ -194,6 +199,13 @@ class CFG final : public IHasDbPrint {
     /// This requires their successor edgesets to be "compatible" with
     /// each other.  This is a constraint specific to BMv2.
     bool checkMergeable(std::set<TableNode *> nodes) const;
+    /// Makes all the edges leading to @p from lead to @p to instead, and removes @p from.
+    void bypass(Node *from, Node *to);
+    /// Merges @p node with a conditional it leads to, if both share a destination.
+    bool mergeConditionals(IfNode *node, P4::TypeMap *typeMap);
+    /// @returns the node reached after @p node if its table never does anything,
+    /// nullptr otherwise.
+    Node *emptyTableDestination(TableNode *node, P4::ReferenceMap *refMap) const;
 };
 
 }  // namespace BMV2
@@ -17,6 +17,7 @@ limitations under the License.
 
 #include "helpers.h"
 #include "lib/algorithm.h"
+#include "options.h"
 
 namespace BMV2 {
 
@@ -56,6 +57,10 @@ const IR::Node *ArithmeticFixup::postorder(IR::Operation_Binary *expression) {
         expression->is<IR::AddSat>() || expression->is<IR::SubSat>())
         // no need to clamp these
         return updateType(expression);
+    if (elideMasks && type->is<IR::Type_Bits>() && !type->to<IR::Type_Bits>()->isSigned &&
+        (expression->is<IR::Shr>() || expression->is<IR::Div>() || expression->is<IR::Mod>()))
+        // the left operand is already narrowed, and these cannot make it larger
+        return updateType(expression);
     if (type->is<IR::Type_Bits>()) return fix(expression, type->to<IR::Type_Bits>());
     return updateType(expression);
 }
@@ -74,6 +79,13 @@ const IR::Node *ArithmeticFixup::postorder(IR::Cmpl *expression) {
 
 const IR::Node *ArithmeticFixup::postorder(IR::Cast *expression) {
     auto type = typeMap->getType(getOriginal(), true);
+    if (elideMasks && type->is<IR::Type_Bits>()) {
+        auto tb = type->to<IR::Type_Bits>();
+        auto source = typeMap->getType(getOriginal<IR::Cast>()->expr, true)->to<IR::Type_Bits>();
+        if (source && !source->isSigned && !tb->isSigned && source->size <= tb->size)
+            // widening an unsigned value which is already narrowed
+            return updateType(expression);
+    }
     if (type->is<IR::Type_Bits>()) return fix(expression, type->to<IR::Type_Bits>());
     return updateType(expression);
 }
@@ -768,7 +780,7 @@ Util::IJson *ExpressionConverter::convert(const IR::Expression *e, bool doFixup,
                                           bool convertBool) {
     const IR::Expression *expr = e;
     if (doFixup) {
-        ArithmeticFixup af(typeMap);
+        ArithmeticFixup af(typeMap, BMV2Context::get().options().elideMasks);
         auto r = e->apply(af);
         CHECK_NULL(r);
         expr = r->to<IR::Expression>();
@@ -818,7 +830,7 @@ Util::IJson *ExpressionConverter::convert(const IR::Expression *e, bool doFixup,
 Util::IJson *ExpressionConverter::convertLeftValue(const IR::Expression *e) {
     leftValue = true;
     const IR::Expression *expr = e;
-    ArithmeticFixup af(typeMap);
+    ArithmeticFixup af(typeMap, BMV2Context::get().options().elideMasks);
     auto r = e->apply(af);
     CHECK_NULL(r);
     expr = r->to<IR::Expression>();
@@ -38,6 +38,10 @@ namespace BMV2 {
  */
 class ArithmeticFixup : public Transform {
     P4::TypeMap *typeMap;
+    /// If true, skip the narrowing of operations whose result provably fits in its type:
+    /// unsigned shifts right, divisions and modulos, and unsigned widening casts, whose
+    /// operands are already narrowed.
+    bool elideMasks;
 
  public:
     const IR::Expression *fix(const IR::Expression *expr, const IR::Type_Bits *type);
@@ -47,7 +51,10 @@ class ArithmeticFixup : public Transform {
     const IR::Node *postorder(IR::Neg *expression) override;
     const IR::Node *postorder(IR::Cmpl *expression) override;
     const IR::Node *postorder(IR::Cast *expression) override;
-    explicit ArithmeticFixup(P4::TypeMap *typeMap) : typeMap(typeMap) { CHECK_NULL(typeMap); }
+    explicit ArithmeticFixup(P4::TypeMap *typeMap, bool elideMasks = false)
+        : typeMap(typeMap), elideMasks(elideMasks) {
+        CHECK_NULL(typeMap);
+    }
 };
 
 class ExpressionConverter : public Inspector {
@@ -58,7 +58,7 @@ class RemoveComplexExpressions : public P4::RemoveComplexExpressions {
  public:
     RemoveComplexExpressions(P4::ReferenceMap *refMap, P4::TypeMap *typeMap,
                              P4::RemoveComplexExpressionsPolicy *policy = nullptr)
-        : P4::RemoveComplexExpressions(refMap, typeMap, policy) {}
+        : P4::RemoveComplexExpressions(refMap, typeMap, policy, true) {}
 
     const IR::Node *postorder(IR::MethodCallExpression *expression) override;
 };
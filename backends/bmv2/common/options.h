@@ -31,6 +31,14 @@ class BMV2Options : public CompilerOptions {
     cstring outputFile = nullptr;
     // read from json
     bool loadIRFromJson = false;
+    // Simplify the control flow graphs of controls
+    bool optimizeControlGraph = false;
+    // Only narrow the results of arithmetic expressions which can overflow
+    bool elideMasks = false;
+    // Write the JSON without whitespace
+    bool compactJson = false;
+    // file to write the resource estimates to
+    cstring resourceReportFile = nullptr;
 
     BMV2Options() {
         registerOption(
@@ -41,6 +49,42 @@ class BMV2Options : public CompilerOptions {
             },
             "[BMv2 back-end] Force externs be emitted by the backend.\n"
             "The generated code follows the BMv2 JSON specification.");
+        registerOption(
+            "--optimize-control-graph", nullptr,
+            [this](const char *) {
+                optimizeControlGraph = true;
+                return true;
+            },
+            "[BMv2 back-end] Merge nested conditionals and remove conditionals and keyless\n"
+            "tables with an empty constant default action that have no effect, so that\n"
+            "fewer pipeline nodes are traversed per packet.  Removed tables are not\n"
+            "available to the control plane.");
+        registerOption(
+            "--elide-masks", nullptr,
+            [this](const char *) {
+                elideMasks = true;
+                return true;
+            },
+            "[BMv2 back-end] Do not mask the results of unsigned shifts right, divisions,\n"
+            "modulos and widening casts, whose values always fit in their type, so that\n"
+            "expressions evaluated per packet are smaller.");
+        registerOption(
+            "--compact-json", nullptr,
+            [this](const char *) {
+                compactJson = true;
+                return true;
+            },
+            "[BMv2 back-end] Write the JSON output without any whitespace, which makes\n"
+            "it smaller and faster to write and to load.");
+        registerOption(
+            "--resource-report", "file",
+            [this](const char *arg) {
+                resourceReportFile = arg;
+                return true;
+            },
+            "[BMv2 back-end] Write to file a JSON estimate of the header bytes extracted by\n"
+            "each parser, and of the table lookups, primitives and register, counter and\n"
+            "meter accesses on the longest path through each pipeline.");
         registerOption(
             "-o", "outfile",
             [this](const char *arg) {
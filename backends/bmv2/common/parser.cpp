@@ -449,9 +449,30 @@ Util::IJson *ParserConverter::stateName(IR::ID state) {
     }
 }
 
+namespace {
+
+/// A transition of a parser state, with what is needed to reorder it.
+struct Transition {
+    Util::IJson *json;
+    /// The value and mask on all the bits of the key, or no mask for default and value set
+    /// transitions, which may overlap with any other transition.
+    big_int value, mask;
+    bool hasMask;
+    /// 0 for transitions to states annotated with @likely, 2 for @unlikely, 1 otherwise.
+    int priority;
+
+    bool overlaps(const Transition &other) const {
+        if (!hasMask || !other.hasMask) return true;
+        return ((value ^ other.value) & mask & other.mask) == 0;
+    }
+};
+
+}  // namespace
+
 std::vector<Util::IJson *> ParserConverter::convertSelectExpression(
     const IR::SelectExpression *expr) {
-    std::vector<Util::IJson *> result;
+    std::vector<Transition> transitions;
+    bool annotated = false;
     auto se = expr->to<IR::SelectExpression>();
     for (auto sc : se->selectCases) {
         auto trans = new Util::JsonObject();
@@ -480,8 +501,35 @@ std::vector<Util::IJson *> ParserConverter::convertSelectExpression(
                 trans->emplace("next_state", stateName(sc->state->path->name));
             }
         }
-        result.push_back(trans);
+        int priority = 1;
+        auto state = ctxt->refMap->getDeclaration(sc->state->path, false);
+        if (state && state->is<IR::ParserState>()) {
+            auto annotations = state->to<IR::ParserState>()->annotations;
+            if (annotations->getSingle("likely"))
+                priority = 0;
+            else if (annotations->getSingle("unlikely"))
+                priority = 2;
+        }
+        annotated |= priority != 1;
+        bool hasMask = !is_vset && mask != 0;
+        if (mask == -1) mask = Util::mask(8 * bytes);
+        transitions.push_back({trans, value, mask, hasMask, priority});
     }
+
+    // bmv2 tries the transitions in order, so the likely ones are moved ahead of the
+    // others, as long as no key can match both.
+    std::vector<Transition> ordered;
+    for (auto &t : transitions) {
+        auto position = ordered.size();
+        if (annotated) {
+            while (position > 0 && ordered[position - 1].priority > t.priority &&
+                   !ordered[position - 1].overlaps(t))
+                position--;
+        }
+        ordered.insert(ordered.begin() + position, t);
+    }
+    std::vector<Util::IJson *> result;
+    for (auto &t : ordered) result.push_back(t.json);
     return result;
 }
 
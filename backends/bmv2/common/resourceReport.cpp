@@ -0,0 +1,225 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "resourceReport.h"
+
+#include <algorithm>
+#include <functional>
+#include <set>
+
+#include "lib/algorithm.h"
+
+namespace BMV2 {
+
+namespace {
+
+const Util::JsonArray *getArray(const Util::IJson *obj, cstring label) {
+    auto result = obj->to<Util::JsonObject>()->get(label);
+    return result ? result->to<Util::JsonArray>() : nullptr;
+}
+
+/// @returns the string @p obj holds under @p label, or nullptr if it is not a string.
+cstring getString(const Util::IJson *obj, cstring label) {
+    auto value = obj ? obj->to<Util::JsonObject>()->get(label) : nullptr;
+    auto v = value ? value->to<Util::JsonValue>() : nullptr;
+    return v && v->isString() ? v->getString() : cstring();
+}
+
+/// @returns the string in @p value, or nullptr if it is not a string.
+cstring asString(const Util::IJson *value) {
+    auto v = value ? value->to<Util::JsonValue>() : nullptr;
+    return v && v->isString() ? v->getString() : cstring();
+}
+
+/// The primitives that access registers, counters and meters.
+bool isExternAccess(cstring op) {
+    return op == "register_read" || op == "register_write" || op == "count" ||
+           op == "execute_meter";
+}
+
+/// Cost of the path from a node of a parser or pipeline to its end.
+struct PathCost {
+    unsigned first = 0, second = 0, third = 0;
+    void maximize(const PathCost &other) {
+        first = std::max(first, other.first);
+        second = std::max(second, other.second);
+        third = std::max(third, other.third);
+    }
+};
+
+/// Computes the cost of the longest path starting at each node of a graph whose nodes
+/// are named, ignoring the edges that close a cycle.
+class LongestPath {
+    std::function<PathCost(cstring)> cost;
+    std::function<std::vector<cstring>(cstring)> successors;
+    std::map<cstring, PathCost> done;
+    std::set<cstring> visiting;
+
+ public:
+    LongestPath(std::function<PathCost(cstring)> cost,
+                std::function<std::vector<cstring>(cstring)> successors)
+        : cost(cost), successors(successors) {}
+    PathCost from(cstring node) {
+        if (node.isNullOrEmpty() || visiting.count(node)) return PathCost();
+        auto it = done.find(node);
+        if (it != done.end()) return it->second;
+        visiting.insert(node);
+        PathCost next;
+        for (auto s : successors(node)) next.maximize(from(s));
+        visiting.erase(node);
+        auto own = cost(node);
+        PathCost result{own.first + next.first, own.second + next.second,
+                        own.third + next.third};
+        done.emplace(node, result);
+        return result;
+    }
+};
+
+}  // namespace
+
+ResourceReport::ResourceReport(const JsonObjects *json) : json(json) {
+    std::map<cstring, unsigned> typeBits;
+    for (auto ht : *json->header_types) {
+        unsigned bits = 0;
+        for (auto f : *getArray(ht, "fields")) {
+            auto field = f->to<Util::JsonArray>();
+            auto width = field && field->size() > 1 ? field->at(1)->to<Util::JsonValue>() : nullptr;
+            if (width && width->isNumber()) bits += width->getInt();
+        }
+        typeBits[getString(ht, "name")] = bits;
+    }
+    for (auto h : *json->headers)
+        headerBytes[getString(h, "name")] = ROUNDUP(typeBits[getString(h, "header_type")], 8);
+    for (auto s : *json->header_stacks)
+        headerBytes[getString(s, "name")] = ROUNDUP(typeBits[getString(s, "header_type")], 8);
+
+    for (auto a : *json->actions) {
+        unsigned primitives = 0, externs = 0;
+        for (auto p : *getArray(a, "primitives")) {
+            primitives++;
+            if (isExternAccess(getString(p, "op"))) externs++;
+        }
+        auto id = a->to<Util::JsonObject>()->get("id")->to<Util::JsonValue>()->getInt();
+        actionCosts[id] = {primitives, externs};
+    }
+}
+
+unsigned ResourceReport::extractedBytes(const Util::JsonObject *op) const {
+    auto name = getString(op, "op");
+    if (name != "extract" && name != "extract_VL") return 0;
+    auto params = getArray(op, "parameters");
+    if (params == nullptr || params->empty()) return 0;
+    auto it = headerBytes.find(asString(params->at(0)->to<Util::JsonObject>()->get("value")));
+    return it == headerBytes.end() ? 0 : it->second;
+}
+
+Util::JsonObject *ResourceReport::parserReport(const Util::JsonObject *parser) const {
+    std::map<cstring, const Util::JsonObject *> states;
+    for (auto s : *getArray(parser, "parse_states"))
+        states[getString(s, "name")] = s->to<Util::JsonObject>();
+
+    // first: header bytes extracted, second: parser operations
+    LongestPath path(
+        [&](cstring name) {
+            PathCost result;
+            for (auto op : *getArray(states.at(name), "parser_ops")) {
+                result.first += extractedBytes(op->to<Util::JsonObject>());
+                result.second++;
+            }
+            return result;
+        },
+        [&](cstring name) {
+            std::vector<cstring> result;
+            for (auto t : *getArray(states.at(name), "transitions")) {
+                auto next = getString(t, "next_state");
+                if (states.count(next)) result.push_back(next);
+            }
+            return result;
+        });
+    auto longest = path.from(getString(parser, "init_state"));
+
+    auto result = new Util::JsonObject();
+    result->emplace("name", getString(parser, "name"));
+    result->emplace("parse_states", states.size());
+    result->emplace("header_bytes_longest_path", longest.first);
+    result->emplace("parser_ops_longest_path", longest.second);
+    return result;
+}
+
+Util::JsonObject *ResourceReport::pipelineReport(const Util::JsonObject *pipeline) const {
+    std::map<cstring, const Util::JsonObject *> tables, conditionals;
+    for (auto t : *getArray(pipeline, "tables"))
+        tables[getString(t, "name")] = t->to<Util::JsonObject>();
+    for (auto c : *getArray(pipeline, "conditionals"))
+        conditionals[getString(c, "name")] = c->to<Util::JsonObject>();
+
+    // first: table lookups, second: action primitives, third: extern accesses
+    LongestPath path(
+        [&](cstring name) {
+            PathCost result;
+            auto it = tables.find(name);
+            if (it == tables.end()) return result;
+            auto table = it->second;
+            result.first = 1;
+            for (auto id : *getArray(table, "action_ids")) {
+                auto cost = actionCosts.find(id->to<Util::JsonValue>()->getInt());
+                if (cost == actionCosts.end()) continue;
+                result.second = std::max(result.second, cost->second.first);
+                result.third = std::max(result.third, cost->second.second);
+            }
+            auto counters = table->get("with_counters");
+            if (counters && *counters->to<Util::JsonValue>() == Util::JsonValue(true))
+                result.third++;
+            if (!getString(table, "direct_meters").isNullOrEmpty()) result.third++;
+            return result;
+        },
+        [&](cstring name) {
+            std::vector<cstring> result;
+            if (auto c = ::get(conditionals, name)) {
+                result.push_back(asString(c->get("true_next")));
+                result.push_back(asString(c->get("false_next")));
+            } else if (auto t = ::get(tables, name)) {
+                result.push_back(asString(t->get("base_default_next")));
+                for (auto &next : *t->get("next_tables")->to<Util::JsonObject>())
+                    result.push_back(asString(next.second));
+            }
+            return result;
+        });
+    auto longest = path.from(asString(pipeline->get("init_table")));
+
+    auto result = new Util::JsonObject();
+    result->emplace("name", getString(pipeline, "name"));
+    result->emplace("tables", tables.size());
+    result->emplace("conditionals", conditionals.size());
+    result->emplace("table_lookups_longest_path", longest.first);
+    result->emplace("primitives_longest_path", longest.second);
+    result->emplace("extern_accesses_longest_path", longest.third);
+    return result;
+}
+
+Util::JsonObject *ResourceReport::report() const {
+    auto result = new Util::JsonObject();
+    auto parsers = new Util::JsonArray();
+    for (auto p : *json->parsers) parsers->append(parserReport(p->to<Util::JsonObject>()));
+    result->emplace("parsers", parsers);
+    auto pipelines = new Util::JsonArray();
+    for (auto p : *json->pipelines) pipelines->append(pipelineReport(p->to<Util::JsonObject>()));
+    result->emplace("pipelines", pipelines);
+    return result;
+}
+
+}  // namespace BMV2
@@ -0,0 +1,53 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#ifndef BACKENDS_BMV2_COMMON_RESOURCEREPORT_H_
+#define BACKENDS_BMV2_COMMON_RESOURCEREPORT_H_
+
+#include "JsonObjects.h"
+#include "lib/json.h"
+
+namespace BMV2 {
+
+/**
+  Estimates how expensive each parser and pipeline of a converted program is
+  to interpret, from the bmv2 JSON.  For parsers it reports the number of
+  header bytes extracted and of parser operations on the longest path; for
+  pipelines the number of table lookups, action primitives and register,
+  counter and meter accesses on the longest path.  Each quantity is maximized
+  separately, so together they are an upper bound of the cost of a packet.
+  Loops over header stacks in parsers are counted once.
+*/
+class ResourceReport {
+    const JsonObjects *json;
+    /// Size in bytes of each header instance and header stack element, by name.
+    std::map<cstring, unsigned> headerBytes;
+    /// Number of primitives and of extern accesses of each action, by id.
+    std::map<int, std::pair<unsigned, unsigned>> actionCosts;
+
+    unsigned extractedBytes(const Util::JsonObject *op) const;
+    Util::JsonObject *parserReport(const Util::JsonObject *parser) const;
+    Util::JsonObject *pipelineReport(const Util::JsonObject *pipeline) const;
+
+ public:
+    explicit ResourceReport(const JsonObjects *json);
+    Util::JsonObject *report() const;
+};
+
+}  // namespace BMV2
+
+#endif /* BACKENDS_BMV2_COMMON_RESOURCEREPORT_H_ */
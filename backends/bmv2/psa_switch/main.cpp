@@ -20,6 +20,7 @@ limitations under the License.
 #include <string>
 
 #include "backends/bmv2/common/JsonObjects.h"
+#include "backends/bmv2/common/resourceReport.h"
 #include "backends/bmv2/psa_switch/midend.h"
 #include "backends/bmv2/psa_switch/options.h"
 #include "backends/bmv2/psa_switch/psaSwitch.h"
@@ -44,6 +45,8 @@ int main(int argc, char *const argv[]) {
     auto &options = BMV2::PsaSwitchContext::get().options();
     options.langVersion = CompilerOptions::FrontendVersion::P4_16;
     options.compilerVersion = BMV2_PSA_VERSION_STRING;
+    // Runs P4::FrontEnd without a policy, and shares its IR cache entries.
+    options.irCacheScope = "P4::FrontEnd";
 
     if (options.process(argc, argv) != nullptr) {
         if (options.loadIRFromJson == false) options.setInputFile();
@@ -126,6 +129,13 @@ int main(int argc, char *const argv[]) {
             out->flush();
         }
     }
+    if (!options.resourceReportFile.isNullOrEmpty()) {
+        std::ostream *out = openFile(options.resourceReportFile, false);
+        if (out != nullptr) {
+            BMV2::ResourceReport(backend->json).report()->serialize(*out);
+            *out << std::endl;
+        }
+    }
 
     return ::errorCount() > 0;
 }
@@ -42,8 +42,8 @@ limitations under the License.
 #include "midend/expandEmit.h"
 #include "midend/expandLookahead.h"
 #include "midend/fillEnumMap.h"
-#include "midend/flattenHeaders.h"
-#include "midend/flattenInterfaceStructs.h"
+#include "midend/flattenAggregates.h"
+#include "midend/foldIsValid.h"
 #include "midend/local_copyprop.h"
 #include "midend/midEndLast.h"
 #include "midend/nestedStructs.h"
@@ -133,13 +133,13 @@ PsaSwitchMidEnd::PsaSwitchMidEnd(CompilerOptions &options, std::ostream *outStre
             new P4::NestedStructs(&refMap, &typeMap),
             new P4::SimplifySelectList(&refMap, &typeMap),
             new P4::RemoveSelectBooleans(&refMap, &typeMap),
-            new P4::FlattenHeaders(&refMap, &typeMap),
-            new P4::FlattenInterfaceStructs(&refMap, &typeMap),
+            new P4::FlattenAggregates(&refMap, &typeMap),
             new P4::ReplaceSelectRange(&refMap, &typeMap),
             new P4::Predication(&refMap),
             new P4::MoveDeclarations(),  // more may have been introduced
             new P4::ConstantFolding(&refMap, &typeMap),
             new P4::LocalCopyPropagation(&refMap, &typeMap, nullptr, policy),
+            new P4::FoldIsValid(&refMap, &typeMap),
             new PassRepeated({new P4::ConstantFolding(&refMap, &typeMap),
                               new P4::StrengthReduction(&refMap, &typeMap)}),
             new P4::MoveDeclarations(),
@@ -279,7 +279,7 @@ void PsaSwitchBackend::convert(const IR::ToplevelBlock *tlb) {
             {new P4::ConstantFolding(refMap, typeMap), new P4::StrengthReduction(refMap, typeMap)}),
         new P4::TypeChecking(refMap, typeMap),
         new P4::RemoveComplexExpressions(refMap, typeMap,
-                                         new ProcessControls(&structure.pipeline_controls)),
+                                         new ProcessControls(&structure.pipeline_controls), true),
         new P4::SimplifyControlFlow(refMap, typeMap),
         new P4::RemoveAllUnusedDeclarations(refMap),
         // Converts the DAG into a TREE (at least for expressions)
@@ -18,10 +18,12 @@
 
 import argparse
 import logging
+import multiprocessing
 import os
 import shutil
 import sys
 import tempfile
+from concurrent.futures import ProcessPoolExecutor
 from pathlib import Path
 from subprocess import Popen
 from threading import Thread
@@ -91,13 +93,23 @@ def parse_args():
     parser.add_argument(
         "-tf",
         "--testFile",
-        dest="testFile",
+        dest="testFiles",
+        default=[],
+        action="append",
         help=(
             "Provide the path for the stf file for this test. "
             "If no path is provided, the script will search for an"
-            " stf file in the same folder."
+            " stf file in the same folder. Can be repeated to run several"
+            " stf tests against a single compilation of the program."
         ),
     )
+    parser.add_argument(
+        "-j",
+        "--jobs",
+        type=int,
+        default=1,
+        help="Run up to this many of the stf tests in parallel, each with its own switch.",
+    )
     return parser.parse_known_args()
 
 
@@ -109,6 +121,8 @@ class Options:
         self.compilerSrcDir = ""  # path to compiler source tree
         self.compilerBuildDir = ""  # path to compiler build directory
         self.testFile = ""  # path to stf test file that is used
+        self.testFiles = []  # paths to the stf test files, if there is more than one
+        self.jobs = 1  # number of stf tests to run in parallel
         self.testName = None  # Name of the test
         self.verbose = False
         self.replace = False  # replace previous outputs
@@ -215,13 +229,14 @@ def run_timeout(options, args, timeout, stderr):
 timeout = 10 * 60
 
 
-def run_model(options, tmpdir, jsonfile):
+def run_model(options, tmpdir, jsonfile, testFile=None):
     # We can do this if an *.stf file is present
     basename = os.path.basename(options.p4filename)
     base, _ = os.path.splitext(basename)
     dirname = os.path.dirname(options.p4filename)
 
-    testFile = options.testFile
+    if testFile is None:
+        testFile = options.testFile
     # If no test file is provided, try to find it in the folder.
     if not testFile:
         testFile = dirname + "/" + base + ".stf"
@@ -253,6 +268,37 @@ def run_model(options, tmpdir, jsonfile):
     return result
 
 
+def run_model_in_folder(options, tmpdir, jsonfile, index, testFile):
+    # Each test gets its own folder for the pcap files and logs of its switch. The switches of
+    # parallel tests use distinct Thrift ports and device ids (see ConcurrentInteger).
+    folder = os.path.join(tmpdir, f"test{index}")
+    os.mkdir(folder)
+    result = run_model(options, folder, jsonfile, testFile)
+    print("PASS" if result == SUCCESS else "FAIL", testFile, flush=True)
+    return result
+
+
+def run_models(options, tmpdir, jsonfile):
+    # Runs all the stf tests against the same compiled program.
+    if len(options.testFiles) <= 1:
+        return run_model(options, tmpdir, jsonfile)
+    # The tests are run in separate processes, as RunBMV2 relies on SIGALRM for its timeouts.
+    jsonfile = os.path.abspath(jsonfile)
+    context = multiprocessing.get_context("fork")
+    with ProcessPoolExecutor(max_workers=max(1, options.jobs), mp_context=context) as pool:
+        futures = [
+            pool.submit(run_model_in_folder, options, tmpdir, jsonfile, index, testFile)
+            for index, testFile in enumerate(options.testFiles)
+        ]
+        results = [future.result() for future in futures]
+    failed = [
+        testFile for testFile, result in zip(options.testFiles, results) if result != SUCCESS
+    ]
+    for testFile in failed:
+        reportError("Test failed:", testFile)
+    return FAILURE if failed else SUCCESS
+
+
 def run_init_commands(options):
     if not options.initCommands:
         return SUCCESS
@@ -317,7 +363,7 @@ def process_file(options, argv):
             result = SUCCESS
 
     if result == SUCCESS and not expected_error:
-        result = run_model(options, tmpdir, jsonfile)
+        result = run_models(options, tmpdir, jsonfile)
 
     if options.cleanupTmp:
         if options.verbose:
@@ -355,7 +401,10 @@ if __name__ == "__main__":
     options.verbose = args.verbose
     options.replace = args.replace
     options.cleanupTmp = args.nocleanup
-    options.testFile = args.testFile
+    options.testFiles = args.testFiles
+    if len(options.testFiles) == 1:
+        options.testFile = options.testFiles[0]
+    options.jobs = args.jobs
 
     # We have to be careful here, passing compiler options is ambiguous in
     # argparse because the parser is not positional.
@@ -19,18 +19,21 @@ limitations under the License.
 #include <string>
 
 #include "backends/bmv2/common/JsonObjects.h"
+#include "backends/bmv2/common/resourceReport.h"
 #include "backends/bmv2/simple_switch/midend.h"
 #include "backends/bmv2/simple_switch/options.h"
 #include "backends/bmv2/simple_switch/simpleSwitch.h"
 #include "backends/bmv2/simple_switch/version.h"
 #include "control-plane/p4RuntimeSerializer.h"
 #include "frontends/common/applyOptionsPragmas.h"
+#include "frontends/common/compileServer.h"
 #include "frontends/common/parseInput.h"
 #include "frontends/p4/frontend.h"
 #include "fstream"
 #include "ir/ir.h"
 #include "ir/json_generator.h"
 #include "ir/json_loader.h"
+#include "ir/pass_profile.h"
 #include "lib/algorithm.h"
 #include "lib/error.h"
 #include "lib/exceptions.h"
@@ -38,13 +41,13 @@ limitations under the License.
 #include "lib/log.h"
 #include "lib/nullstream.h"
 
-int main(int argc, char *const argv[]) {
-    setup_gc_logging();
-
+static int compileMain(int argc, char *const argv[]) {
     AutoCompileContext autoBMV2Context(new BMV2::SimpleSwitchContext);
     auto &options = BMV2::SimpleSwitchContext::get().options();
     options.langVersion = CompilerOptions::FrontendVersion::P4_16;
     options.compilerVersion = BMV2_SIMPLESWITCH_VERSION_STRING;
+    // Runs P4::FrontEnd without a policy, and shares its IR cache entries.
+    options.irCacheScope = "P4::FrontEnd";
 
     if (options.process(argc, argv) != nullptr) {
         if (options.loadIRFromJson == false) options.setInputFile();
@@ -121,12 +124,25 @@ int main(int argc, char *const argv[]) {
     if (::errorCount() > 0) return 1;
 
     if (!options.outputFile.isNullOrEmpty()) {
+        PassProfile::Stage profile("SerializeJson");
         std::ostream *out = openFile(options.outputFile, false);
         if (out != nullptr) {
             backend->serialize(*out);
             out->flush();
         }
     }
+    if (!options.resourceReportFile.isNullOrEmpty()) {
+        std::ostream *out = openFile(options.resourceReportFile, false);
+        if (out != nullptr) {
+            BMV2::ResourceReport(backend->json).report()->serialize(*out);
+            *out << std::endl;
+        }
+    }
 
     return ::errorCount() > 0;
 }
+
+int main(int argc, char *const argv[]) {
+    setup_gc_logging();
+    return P4::CompileServer::main(argc, argv, compileMain);
+}
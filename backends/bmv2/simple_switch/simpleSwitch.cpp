@@ -1005,6 +1005,77 @@ void SimpleSwitchBackend::convertChecksum(const IR::BlockStatement *block,
     }
 }
 
+namespace {
+/// Collects the fields of the user metadata that a block reads. Any use of a field, except
+/// writing it as a whole, counts as a read; a use of the whole struct reads all its fields.
+class ReadUserMetadataFields : public Inspector {
+    const P4::TypeMap *typeMap;
+    const IR::Type_Struct *userMetaType;
+
+    bool isUserMetadata(const IR::Expression *expression) const {
+        auto type = typeMap->getType(expression);
+        return type != nullptr && type->is<IR::Type_Struct>() &&
+               type->to<IR::Type_Struct>()->name == userMetaType->name;
+    }
+
+ public:
+    std::set<cstring> fields;
+    bool allFields = false;
+
+    ReadUserMetadataFields(const P4::TypeMap *typeMap, const IR::Type_Struct *userMetaType)
+        : typeMap(typeMap), userMetaType(userMetaType) {
+        setName("ReadUserMetadataFields");
+    }
+    bool preorder(const IR::AssignmentStatement *statement) override {
+        auto left = statement->left->to<IR::Member>();
+        if (left == nullptr || !isUserMetadata(left->expr)) visit(statement->left, "left");
+        visit(statement->right, "right");
+        return false;
+    }
+    bool preorder(const IR::Member *member) override {
+        if (!isUserMetadata(member->expr)) return true;
+        fields.insert(member->member.name);
+        return false;
+    }
+    bool preorder(const IR::PathExpression *path) override {
+        if (isUserMetadata(path)) allFields = true;
+        return false;
+    }
+};
+
+/// Finds the field lists preserved by the clone, resubmit and recirculate calls of a block.
+/// A clone goes through the egress pipeline only, the other packets through the whole
+/// pipeline.
+class FindPreservedFieldLists : public Inspector {
+ public:
+    std::set<unsigned> egressLists;
+    std::set<unsigned> pipelineLists;
+
+    FindPreservedFieldLists() { setName("FindPreservedFieldLists"); }
+    bool preorder(const IR::MethodCallExpression *call) override {
+        auto method = call->method->to<IR::PathExpression>();
+        if (method == nullptr) return true;
+        auto name = method->path->name.name;
+        size_t index;
+        std::set<unsigned> *lists;
+        if (name == P4V1::V1Model::instance.clone.clone3.name) {
+            index = 2;
+            lists = &egressLists;
+        } else if (name == P4V1::V1Model::instance.resubmit.name ||
+                   name == P4V1::V1Model::instance.recirculate.name) {
+            index = 0;
+            lists = &pipelineLists;
+        } else {
+            return true;
+        }
+        if (call->arguments->size() > index)
+            if (auto cst = call->arguments->at(index)->expression->to<IR::Constant>())
+                lists->insert(cst->asUnsigned());
+        return true;
+    }
+};
+}  // namespace
+
 void SimpleSwitchBackend::createActions(ConversionContext *ctxt, V1ProgramStructure *structure) {
     auto cvt = new ActionConverter(ctxt, options.emitExterns);
     for (auto it : structure->actions) {
@@ -1037,6 +1108,37 @@ void SimpleSwitchBackend::createRecirculateFieldsList(ConversionContext *ctxt,
     /// These fields lists will be named "field_list0", "field_list1", etc.
     std::map<unsigned, Util::JsonObject *> fieldLists;
 
+    /// The fields of a list that no block reads after the packet is cloned, resubmitted or
+    /// recirculated are not preserved, since their value cannot make a difference.
+    FindPreservedFieldLists preserved;
+    ReadUserMetadataFields egressReads(ctxt->typeMap, userMetaType);
+    ReadUserMetadataFields pipelineReads(ctxt->typeMap, userMetaType);
+    for (auto name : {v1model.sw.parser.name, v1model.sw.verify.name, v1model.sw.ingress.name,
+                      v1model.sw.egress.name, v1model.sw.compute.name,
+                      v1model.sw.deparser.name}) {
+        auto block = main->findParameterValue(name)->to<IR::Block>();
+        CHECK_NULL(block);
+        const IR::Node *container = nullptr;
+        if (auto parserBlock = block->to<IR::ParserBlock>())
+            container = parserBlock->container;
+        else if (auto controlBlock = block->to<IR::ControlBlock>())
+            container = controlBlock->container;
+        CHECK_NULL(container);
+        container->apply(preserved);
+        container->apply(pipelineReads);
+        if (name == v1model.sw.egress.name || name == v1model.sw.compute.name ||
+            name == v1model.sw.deparser.name)
+            container->apply(egressReads);
+    }
+    auto isRead = [&](unsigned index, cstring field) {
+        if (preserved.pipelineLists.count(index))
+            return pipelineReads.allFields || pipelineReads.fields.count(field) != 0;
+        if (preserved.egressLists.count(index))
+            return egressReads.allFields || egressReads.fields.count(field) != 0;
+        // Not preserved by any call.
+        return true;
+    };
+
     LOG2("Scanning user metadata fields for annotations");
     for (auto f : userMetaType->fields) {
         LOG3("Scanning field " << f);
@@ -1067,6 +1169,11 @@ void SimpleSwitchBackend::createRecirculateFieldsList(ConversionContext *ctxt,
                 elements = fl->get("elements")->to<Util::JsonArray>();
                 CHECK_NULL(elements);
             }
+            if (!isRead(index, f->name.name)) {
+                LOG2("Not preserving " << f << " in field list " << index
+                                       << ", it is not read after the packet is copied");
+                continue;
+            }
 
             auto field = new Util::JsonObject();
             field->emplace("type", "field");
@@ -22,9 +22,12 @@ limitations under the License.
 #include "dpdkAsmOpt.h"
 #include "dpdkCheckExternInvocation.h"
 #include "dpdkContext.h"
+#include "dpdkCostReport.h"
+#include "dpdkNativeCode.h"
 #include "dpdkHelpers.h"
 #include "dpdkMetadata.h"
 #include "dpdkProgram.h"
+#include "dpdkTableStats.h"
 #include "frontends/p4/moveDeclarations.h"
 #include "ir/dbprint.h"
 #include "ir/ir.h"
@@ -49,6 +52,10 @@ void DpdkBackend::convert(const IR::ToplevelBlock *tlb) {
     auto convertToDpdk = new ConvertToDpdkProgram(refMap, typeMap, &structure, options);
     auto genContextJson = new DpdkContextGenerator(refMap, &structure, p4info, options);
     bool is_all_args_header_fields = true;
+    ordered_map<cstring, TableStats> tableStats;
+    if (!options.tableStatsFile.isNullOrEmpty() &&
+        !readTableStats(options.tableStatsFile, tableStats))
+        return;
     PassManager simplify = {
         new DpdkArchFirst(),
         new ValidateOperandSize(),
@@ -56,6 +63,10 @@ void DpdkBackend::convert(const IR::ToplevelBlock *tlb) {
         new P4::EliminateTypedef(refMap, typeMap),
         new P4::ClearTypeMap(typeMap),
         new P4::TypeChecking(refMap, typeMap),
+        options.tableStatsFile.isNullOrEmpty()
+            ? nullptr
+            : new OrderBranchesByHitRate(refMap, typeMap, tableStats),
+        options.tableStatsFile.isNullOrEmpty() ? nullptr : new ApplyTableStats(tableStats),
         new ByteAlignment(typeMap, refMap, &structure),
         new P4::SimplifyKey(
             refMap, typeMap,
@@ -70,7 +81,8 @@ void DpdkBackend::convert(const IR::ToplevelBlock *tlb) {
         new EliminateHeaderCopy(refMap, typeMap),
         new P4::TypeChecking(refMap, typeMap),
         new P4::RemoveAllUnusedDeclarations(refMap),
-        new ConvertActionSelectorAndProfile(refMap, typeMap, &structure),
+        new ConvertActionSelectorAndProfile(refMap, typeMap, &structure,
+                                            options.consistentHashSelectors),
         new CollectTableInfo(&structure),
         new CollectAddOnMissTable(refMap, typeMap, &structure),
         new ValidateAddOnMissExterns(refMap, typeMap, &structure),
@@ -91,6 +103,11 @@ void DpdkBackend::convert(const IR::ToplevelBlock *tlb) {
         new P4::ClearTypeMap(typeMap),
         new P4::TypeChecking(refMap, typeMap, true),
         new ConvertBinaryOperationTo2Params(refMap),
+        options.coalesceKeyFields
+            ? new PassManager({new CoalesceMetadataKeyFields(&structure),
+                               new P4::ClearTypeMap(typeMap),
+                               new P4::TypeChecking(refMap, typeMap, true)})
+            : nullptr,
         new CollectProgramStructure(refMap, typeMap, &structure),
         new CopyMatchKeysToSingleStruct(refMap, typeMap, &invokedInKey, &structure),
         new P4::ResolveReferences(refMap),
@@ -107,7 +124,8 @@ void DpdkBackend::convert(const IR::ToplevelBlock *tlb) {
         new P4::TypeChecking(refMap, typeMap, true),
         new CollectDirectCounterMeter(refMap, typeMap, &structure),
         new ValidateDirectCounterMeter(refMap, typeMap, &structure),
-        new DpdkAddPseudoHeader(refMap, typeMap, is_all_args_header_fields),
+        new DpdkAddPseudoHeader(refMap, typeMap, is_all_args_header_fields,
+                                options.reusePseudoHeaderFields),
         new CollectProgramStructure(refMap, typeMap, &structure),
         new InspectDpdkProgram(refMap, typeMap, &structure),
         new CheckExternInvocation(refMap, typeMap, &structure),
@@ -144,6 +162,9 @@ void DpdkBackend::convert(const IR::ToplevelBlock *tlb) {
         new EliminateUnusedAction(),
         new DpdkAsmOptimization,
         new CopyPropagationAndElimination(typeMap),
+        options.peephole ? new PassManager({new PeepholeOptimization(), new DpdkAsmOptimization})
+                         : nullptr,
+        options.shareMetadataFields ? new ShareMetadataFields() : nullptr,
         new CollectUsedMetadataField(used_fields),
         new RemoveUnusedMetadataFields(used_fields),
         new ShortenTokenLength(newNameMap),
@@ -151,6 +172,25 @@ void DpdkBackend::convert(const IR::ToplevelBlock *tlb) {
     };
 
     dpdk_program = dpdk_program->apply(post_code_gen)->to<IR::DpdkAsmProgram>();
+
+    if (!options.costReportFile.isNullOrEmpty()) {
+        DpdkCostReport costReport;
+        dpdk_program->apply(costReport);
+        std::ostream *out = openFile(options.costReportFile, false);
+        if (out != nullptr) {
+            costReport.serialize(out);
+            out->flush();
+        }
+    }
+    if (!options.nativeCodeFile.isNullOrEmpty()) {
+        DpdkNativeCode nativeCode;
+        dpdk_program->apply(nativeCode);
+        std::ostream *out = openFile(options.nativeCodeFile, false);
+        if (out != nullptr) {
+            nativeCode.serialize(out);
+            out->flush();
+        }
+    }
 }
 
 void DpdkBackend::codegen(std::ostream &out) const { dpdk_program->toSpec(out) << std::endl; }
@@ -49,6 +49,7 @@ class DpdkBackend {
                 const p4configv1::P4Info &p4info)
         : options(options), refMap(refMap), typeMap(typeMap), p4info(p4info) {}
     void codegen(std::ostream &) const;
+    const IR::DpdkAsmProgram *getDpdkProgram() const { return dpdk_program; }
 };
 
 }  // namespace DPDK
@@ -49,6 +49,10 @@ const cstring tdiSchemaVersion = "0.1";
 // Initial values for group_id and member_id for action selector and action profile tables
 const unsigned initial_member_id = 0;
 const unsigned initial_group_id = 0xFFFFFFFF;
+// With consistent hashing, the member array of each action selector group holds this many
+// slots per member, up to the maximum size, for the control plane to fill as a lookup table.
+const unsigned dpdk_selector_lookup_array_factor = 16;
+const unsigned dpdk_selector_max_lookup_array_size = 0x10000;
 
 // Ipsec related constants
 #define IPSEC_SUCCESS 0
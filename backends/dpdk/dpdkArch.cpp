@@ -25,6 +25,8 @@ limitations under the License.
 
 #include "dpdkArch.h"
 
+#include <algorithm>
+
 #include "dpdkHelpers.h"
 #include "dpdkUtils.h"
 #include "frontends/common/resolveReferences/referenceMap.h"
@@ -1746,6 +1748,109 @@ const IR::Node *CopyMatchKeysToSingleStruct::doStatement(const IR::Statement *st
     return block;
 }
 
+namespace {
+
+/// @returns true if @p fields are adjacent in @p order.
+bool isContiguous(const std::vector<cstring> &order, const std::vector<cstring> &fields) {
+    size_t first = order.size(), last = 0;
+    for (auto f : fields) {
+        auto it = std::find(order.begin(), order.end(), f);
+        if (it == order.end()) return false;
+        size_t pos = it - order.begin();
+        first = std::min(first, pos);
+        last = std::max(last, pos);
+    }
+    return last - first + 1 == fields.size();
+}
+
+}  // namespace
+
+const IR::Node *CoalesceMetadataKeyFields::preorder(IR::P4Program *program) {
+    const IR::Type_Struct *metadata = nullptr;
+    for (auto obj : program->objects) {
+        if (auto st = obj->to<IR::Type_Struct>())
+            if (st->name.name == structure->local_metadata_type) metadata = st;
+    }
+    if (metadata == nullptr) {
+        prune();
+        return program;
+    }
+    std::vector<cstring> original;
+    for (auto field : metadata->fields) original.push_back(field->name.name);
+
+    // Keys of the exact match tables made of distinct metadata fields only.
+    std::vector<std::vector<cstring>> keys;
+    forAllMatching<IR::P4Table>(program, [&](const IR::P4Table *table) {
+        auto key = table->getKey();
+        if (key == nullptr || key->keyElements.size() < 2) return;
+        std::vector<cstring> fields;
+        for (auto ke : key->keyElements) {
+            auto mem = ke->expression->to<IR::Member>();
+            if (ke->matchType->toString() != "exact" || mem == nullptr ||
+                !mem->expr->is<IR::PathExpression>() || mem->expr->toString() != "m")
+                return;
+            auto name = mem->member.name;
+            if (std::find(fields.begin(), fields.end(), name) != fields.end() ||
+                std::find(original.begin(), original.end(), name) == original.end())
+                return;
+            fields.push_back(name);
+        }
+        keys.push_back(std::move(fields));
+    });
+
+    // Keys that are already contiguous come first, so that they keep their fields together.
+    std::stable_partition(keys.begin(), keys.end(), [&original](const std::vector<cstring> &k) {
+        return isContiguous(original, k);
+    });
+    std::vector<std::vector<cstring>> blocks;
+    std::map<cstring, size_t> blockOf;
+    for (auto &key : keys) {
+        bool free = true;
+        for (auto f : key) free = free && !blockOf.count(f);
+        if (free) {
+            for (auto f : key) blockOf.emplace(f, blocks.size());
+            blocks.push_back(key);
+            continue;
+        }
+        // A key made of the same fields as a previous one is contiguous with it.
+        auto block = blockOf.find(key.front());
+        bool same = block != blockOf.end() && blocks.at(block->second).size() == key.size();
+        for (auto f : key) same = same && blockOf.count(f) && blockOf.at(f) == block->second;
+        if (!same) LOG3("Key fields of a table overlap another key, they will be copied");
+    }
+
+    // Each block of key fields takes the place of its first field in the struct.
+    std::vector<cstring> order;
+    std::set<size_t> placed;
+    for (auto f : original) {
+        auto it = blockOf.find(f);
+        if (it == blockOf.end()) {
+            order.push_back(f);
+        } else if (placed.insert(it->second).second) {
+            auto &block = blocks.at(it->second);
+            order.insert(order.end(), block.begin(), block.end());
+        }
+    }
+    for (auto &key : keys) {
+        if (isContiguous(original, key) && !isContiguous(order, key)) {
+            prune();
+            return program;
+        }
+    }
+    if (order != original) newOrder = std::move(order);
+    return program;
+}
+
+const IR::Node *CoalesceMetadataKeyFields::preorder(IR::Type_Struct *s) {
+    prune();
+    if (newOrder.empty() || s->name.name != structure->local_metadata_type) return s;
+    IR::IndexedVector<IR::StructField> fields;
+    for (auto name : newOrder) fields.push_back(s->fields.getDeclaration<IR::StructField>(name));
+    LOG3("Metadata structure after coalescing key fields:" << std::endl << fields);
+    s->fields = std::move(fields);
+    return s;
+}
+
 namespace Helpers {
 
 std::optional<P4::ExternInstance> getExternInstanceFromProperty(
@@ -1890,7 +1995,8 @@ const IR::P4Table *SplitP4TableCommon::create_group_table(const IR::P4Table *tbl
                                                           cstring selectorTableName,
                                                           cstring group_id, cstring member_id,
                                                           unsigned n_groups_max,
-                                                          unsigned n_members_per_group_max) {
+                                                          unsigned n_members_per_group_max,
+                                                          unsigned lookupArraySize) {
     IR::Vector<IR::KeyElement> selector_keys;
     for (auto key : tbl->getKey()->keyElements) {
         if (key->matchType->toString() == "selector") {
@@ -1912,10 +2018,19 @@ const IR::P4Table *SplitP4TableCommon::create_group_table(const IR::P4Table *tbl
     selector_properties.push_back(new IR::Property(
         "n_groups_max",
         new IR::ExpressionValue(new IR::Constant(IR::Type_Bits::get(32), n_groups_max)), false));
+    // The member array of a group holds the lookup table of consistent hashing if there is
+    // one, while the control plane still limits the number of members.
+    unsigned n_slots_per_group_max = lookupArraySize ? lookupArraySize : n_members_per_group_max;
     selector_properties.push_back(new IR::Property(
         "n_members_per_group_max",
-        new IR::ExpressionValue(new IR::Constant(IR::Type_Bits::get(32), n_members_per_group_max)),
+        new IR::ExpressionValue(new IR::Constant(IR::Type_Bits::get(32), n_slots_per_group_max)),
         false));
+    if (lookupArraySize)
+        selector_properties.push_back(new IR::Property(
+            "consistent_hash_members_max",
+            new IR::ExpressionValue(
+                new IR::Constant(IR::Type_Bits::get(32), n_members_per_group_max)),
+            false));
     selector_properties.push_back(new IR::Property("actions", new IR::ActionList({}), false));
     auto group_table =
         new IR::P4Table(selectorTableName, hidden, new IR::TableProperties(selector_properties));
@@ -1976,6 +2091,13 @@ const IR::Node *SplitActionSelectorTable::postorder(IR::P4Table *tbl) {
         return tbl;
     }
     int n_members_per_group_max = 1 << outputWidth;
+    unsigned lookupArraySize = 0;
+    if (consistentHashing) {
+        lookupArraySize = std::max<unsigned>(
+            n_members_per_group_max,
+            std::min<unsigned>(n_members_per_group_max * dpdk_selector_lookup_array_factor,
+                               dpdk_selector_max_lookup_array_size));
+    }
 
     auto decls = new IR::IndexedVector<IR::Declaration>();
 
@@ -2019,7 +2141,8 @@ const IR::Node *SplitActionSelectorTable::postorder(IR::P4Table *tbl) {
     if (!isAsInstanceShared) {
         // group table match on group_id
         auto group_table = create_group_table(tbl, group_table_name, group_id, member_id,
-                                              n_groups_max, n_members_per_group_max);
+                                              n_groups_max, n_members_per_group_max,
+                                              lookupArraySize);
         decls->push_back(group_table);
 
         // member table match on member_id
@@ -2953,9 +3076,18 @@ MoveNonHeaderFieldsToPseudoHeader::addAssignmentStmt(const IR::Expression *e) {
     if (e->is<IR::Constant>() && (type->width_bits() > 64)) {
         type = IR::Type_Bits::get(64);
     }
-    auto name = refMap->newName("pseudo");
     auto aligned_type = getEightBitAlignedType(type);
-    pseudoFieldNameType.push_back(std::pair<cstring, const IR::Type *>(name, aligned_type));
+    auto &pool = fieldPool[aligned_type->toString()];
+    auto &used = fieldsUsed[aligned_type->toString()];
+    cstring name;
+    if (reuseFields && used < pool.size()) {
+        name = pool.at(used);
+    } else {
+        name = refMap->newName("pseudo");
+        pseudoFieldNameType.push_back(std::pair<cstring, const IR::Type *>(name, aligned_type));
+        pool.push_back(name);
+    }
+    used++;
     auto mem0 = new IR::Member(new IR::PathExpression(IR::ID("h")),
                                IR::ID(DpdkAddPseudoHeaderDecl::pseudoHeaderInstanceName));
     auto mem1 = new IR::Member(mem0, IR::ID(name));
@@ -2970,6 +3102,7 @@ MoveNonHeaderFieldsToPseudoHeader::addAssignmentStmt(const IR::Expression *e) {
 
 const IR::Node *MoveNonHeaderFieldsToPseudoHeader::postorder(IR::AssignmentStatement *assn) {
     if (is_all_args_header) return assn;
+    fieldsUsed.clear();
     auto result = new IR::IndexedVector<IR::StatOrDecl>();
     if ((isLargeFieldOperand(assn->left) && !isLargeFieldOperand(assn->right) &&
          !isInsideHeader(assn->right)) ||
@@ -3020,6 +3153,7 @@ const IR::Node *MoveNonHeaderFieldsToPseudoHeader::postorder(IR::AssignmentState
 
 const IR::Node *MoveNonHeaderFieldsToPseudoHeader::postorder(IR::MethodCallStatement *statement) {
     if (is_all_args_header) return statement;
+    fieldsUsed.clear();
     auto mce = statement->methodCall;
     bool added_copy = false;
     IR::Type_Name *newTname = nullptr;
@@ -846,6 +846,26 @@ class CopyMatchKeysToSingleStruct : public P4::KeySideEffect {
     bool isLearnerTable(const IR::P4Table *t);
 };
 
+// This pass reorders the fields of the metadata struct so that the keys of exact match
+// tables made only of metadata fields become contiguous, which lets
+// CopyMatchKeysToSingleStruct use them in place instead of copying them into new metadata
+// fields before every lookup. Keys that are already contiguous stay contiguous. Header
+// fields keep their wire order, so tables with header fields in their key are still
+// copied, as are tables whose key partially overlaps the key of another table.
+// This pass must be followed by type checking, to update the types of metadata accesses.
+class CoalesceMetadataKeyFields : public Transform {
+    DpdkProgramStructure *structure;
+    /// New order of the fields of the metadata struct, if it changes.
+    std::vector<cstring> newOrder;
+
+ public:
+    explicit CoalesceMetadataKeyFields(DpdkProgramStructure *structure) : structure(structure) {
+        setName("CoalesceMetadataKeyFields");
+    }
+    const IR::Node *preorder(IR::P4Program *program) override;
+    const IR::Node *preorder(IR::Type_Struct *s) override;
+};
+
 class SwitchHandler {
     // Map which holds the switch expression variable and constant tuple per switch statement for
     // each action.
@@ -912,7 +932,7 @@ class SplitP4TableCommon : public Transform {
     const IR::P4Action *create_action(cstring /* actionName */, cstring /* id */, cstring);
     const IR::P4Table *create_member_table(const IR::P4Table *, cstring, cstring);
     const IR::P4Table *create_group_table(const IR::P4Table *, cstring, cstring, cstring, unsigned,
-                                          unsigned);
+                                          unsigned, unsigned lookupArraySize = 0);
     IR::Expression *initializeMemberAndGroupId(cstring tableName,
                                                IR::IndexedVector<IR::StatOrDecl> *decls);
 };
@@ -922,12 +942,20 @@ class SplitP4TableCommon : public Transform {
  *   match table that matches on exact/ternary key and generates a group id
  *   group table that matches on group id and generates a member id
  *   member table that runs an action based on member id.
+ * With consistent hashing, the member array of each group gets several slots per member, so
+ * that the control plane can fill it as a Maglev-style lookup table in which adding or removing
+ * a member only remaps the flows of that member.
  */
 class SplitActionSelectorTable : public SplitP4TableCommon {
+    /// Size the member array of each group for consistent hashing instead of modulo selection.
+    bool consistentHashing;
+
  public:
     SplitActionSelectorTable(P4::ReferenceMap *refMap, P4::TypeMap *typeMap,
-                             DpdkProgramStructure *structure, SwitchHandler &sw)
-        : SplitP4TableCommon(refMap, typeMap, structure, sw) {
+                             DpdkProgramStructure *structure, SwitchHandler &sw,
+                             bool consistentHashing = false)
+        : SplitP4TableCommon(refMap, typeMap, structure, sw),
+          consistentHashing(consistentHashing) {
         implementation = TableImplementation::ACTION_SELECTOR;
     }
     const IR::Node *postorder(IR::P4Table *tbl) override;
@@ -981,9 +1009,11 @@ class ConvertActionSelectorAndProfile : public PassManager {
 
  public:
     ConvertActionSelectorAndProfile(P4::ReferenceMap *refMap, P4::TypeMap *typeMap,
-                                    DpdkProgramStructure *structure) {
+                                    DpdkProgramStructure *structure,
+                                    bool consistentHashing = false) {
         passes.emplace_back(new P4::TypeChecking(refMap, typeMap));
-        passes.emplace_back(new SplitActionSelectorTable(refMap, typeMap, structure, sw));
+        passes.emplace_back(
+            new SplitActionSelectorTable(refMap, typeMap, structure, sw, consistentHashing));
         passes.emplace_back(new UpdateActionForSwitch(sw));
         passes.push_back(new P4::ClearTypeMap(typeMap));
         passes.emplace_back(new P4::TypeChecking(refMap, typeMap, true));
@@ -1301,17 +1331,28 @@ class DpdkAddPseudoHeaderDecl : public Transform {
 ///    f1 = h.dpdk_pseudo_header.pseudo_0,f2 = h.dpdk_pseudo_header.pseudo_1,
 ///    f3 = h.dpdk_pseudo_header.pseudo_2,f4 = h.dpdk_pseudo_header.pseudo_3});
 
+/// A pseudo header field is only live between its initialization and the statement using
+/// it, so with @p reuseFields the fields of each type are shared by all statements instead
+/// of being added for every copy.
 class MoveNonHeaderFieldsToPseudoHeader : public Transform {
     P4::ReferenceMap *refMap;
     P4::TypeMap *typeMap;
     bool &is_all_args_header;
     IR::Vector<IR::Node> newStructTypes;
+    bool reuseFields;
+    /// Pseudo header fields added so far, by type.
+    std::map<cstring, std::vector<cstring>> fieldPool;
+    /// Pseudo header fields of each type used by the current statement.
+    std::map<cstring, size_t> fieldsUsed;
 
  public:
     static std::vector<std::pair<cstring, const IR::Type *>> pseudoFieldNameType;
     MoveNonHeaderFieldsToPseudoHeader(P4::ReferenceMap *refMap, P4::TypeMap *typeMap,
-                                      bool &is_all_args_header)
-        : refMap(refMap), typeMap(typeMap), is_all_args_header(is_all_args_header) {}
+                                      bool &is_all_args_header, bool reuseFields = false)
+        : refMap(refMap),
+          typeMap(typeMap),
+          is_all_args_header(is_all_args_header),
+          reuseFields(reuseFields) {}
     std::pair<IR::AssignmentStatement *, IR::Member *> addAssignmentStmt(const IR::Expression *ne);
 
     const IR::Node *postorder(IR::P4Program *p) override {
@@ -1351,7 +1392,7 @@ struct DpdkAddPseudoHeader : public PassManager {
 
  public:
     DpdkAddPseudoHeader(P4::ReferenceMap *refMap, P4::TypeMap *typeMap,
-                        bool &is_all_args_header_fields)
+                        bool &is_all_args_header_fields, bool reuseFields = false)
         : refMap(refMap), typeMap(typeMap), is_all_args_header(is_all_args_header_fields) {
         passes.push_back(new HaveNonHeaderChecksumArgs(typeMap, is_all_args_header));
         passes.push_back(new HaveNonHeaderLargeOperandAssignment(is_all_args_header));
@@ -1359,7 +1400,8 @@ struct DpdkAddPseudoHeader : public PassManager {
         passes.push_back(new P4::ClearTypeMap(typeMap));
         passes.push_back(new P4::TypeChecking(refMap, typeMap));
         passes.push_back(
-            new MoveNonHeaderFieldsToPseudoHeader(refMap, typeMap, is_all_args_header));
+            new MoveNonHeaderFieldsToPseudoHeader(refMap, typeMap, is_all_args_header,
+                                                  reuseFields));
         passes.push_back(new AddFieldsToPseudoHeader(refMap, typeMap, is_all_args_header));
         passes.push_back(new P4::ClearTypeMap(typeMap));
         passes.push_back(new P4::TypeChecking(refMap, typeMap));
@@ -17,6 +17,7 @@ limitations under the License.
 #include "dpdkAsmOpt.h"
 
 #include "dpdkUtils.h"
+#include "lib/bitvec.h"
 
 namespace DPDK {
 // The assumption is compiler can only produce forward jumps.
@@ -197,6 +198,349 @@ const IR::Node *RemoveUnusedMetadataFields::preorder(IR::DpdkAsmProgram *p) {
     return p;
 }
 
+namespace {
+
+/// @returns the name of the metadata field @p e refers to, as in m.<field_name>
+cstring metadataField(const IR::Expression *e) {
+    auto m = e ? e->to<IR::Member>() : nullptr;
+    if (m == nullptr || m->expr->toString() != "m") return cstring();
+    return m->member.name;
+}
+
+// Counts every reference to each metadata field in the program.
+class CountMetadataUses : public Inspector {
+ public:
+    std::unordered_map<cstring, unsigned> uses;
+    CountMetadataUses() { visitDagOnce = false; }
+    bool preorder(const IR::Member *m) override {
+        auto field = metadataField(m);
+        if (!field.isNullOrEmpty()) uses[field]++;
+        return true;
+    }
+};
+
+/// Collects the operands an instruction reads into @p uses and the one it writes into @p def.
+/// Instructions other than moves, casts, arithmetic and conditional jumps have no operands
+/// that can be shared.
+void instructionOperands(const IR::DpdkAsmStatement *s, std::vector<const IR::Expression *> &uses,
+                         const IR::Expression *&def) {
+    if (auto u = s->to<IR::DpdkUnaryStatement>()) {
+        def = u->dst;
+        uses = {u->src};
+    } else if (auto b = s->to<IR::DpdkBinaryStatement>()) {
+        def = b->dst;
+        uses = {b->src1, b->src2};
+    } else if (auto c = s->to<IR::DpdkCastStatement>()) {
+        def = c->dst;
+        uses = {c->src};
+    } else if (auto j = s->to<IR::DpdkJmpCondStatement>()) {
+        uses = {j->src1, j->src2};
+    }
+}
+
+}  // namespace
+
+void ShareMetadataFields::allocate(const IR::DpdkListStatement *l,
+                                   const ordered_map<cstring, cstring> &types,
+                                   const std::unordered_map<cstring, unsigned> &uses) {
+    auto &instr = l->statements;
+    size_t count = instr.size();
+    std::vector<std::vector<const IR::Expression *>> operands(count);
+    std::vector<const IR::Expression *> defs(count, nullptr);
+    std::unordered_map<cstring, unsigned> operandUses;
+    for (size_t i = 0; i < count; i++) {
+        instructionOperands(instr[i], operands[i], defs[i]);
+        for (auto e : operands[i]) {
+            auto field = metadataField(e);
+            if (!field.isNullOrEmpty()) operandUses[field]++;
+        }
+        auto field = metadataField(defs[i]);
+        if (!field.isNullOrEmpty()) operandUses[field]++;
+    }
+
+    // Fields all references of which are operands of this list can be shared.
+    std::vector<cstring> candidates;
+    std::unordered_map<cstring, size_t> index;
+    for (auto &t : types) {
+        auto field = t.first;
+        if (field.startsWith("pna_") || field.startsWith("psa_")) continue;
+        auto it = uses.find(field);
+        if (it == uses.end() || operandUses[field] != it->second) continue;
+        index.emplace(field, candidates.size());
+        candidates.push_back(field);
+    }
+    if (candidates.empty()) return;
+
+    auto candidate = [&](const IR::Expression *e) -> int {
+        auto it = index.find(metadataField(e));
+        return it == index.end() ? -1 : static_cast<int>(it->second);
+    };
+    std::vector<bitvec> use(count), def(count);
+    std::unordered_map<cstring, size_t> labels;
+    for (size_t i = 0; i < count; i++) {
+        for (auto e : operands[i]) {
+            int c = candidate(e);
+            if (c >= 0) use[i].setbit(c);
+        }
+        int c = candidate(defs[i]);
+        if (c >= 0) def[i].setbit(c);
+        if (auto label = instr[i]->to<IR::DpdkLabelStatement>()) labels[label->label] = i;
+    }
+    std::vector<std::vector<size_t>> successors(count);
+    for (size_t i = 0; i < count; i++) {
+        if (auto jmp = instr[i]->to<IR::DpdkJmpStatement>()) {
+            auto it = labels.find(jmp->label);
+            if (it == labels.end()) return;
+            successors[i].push_back(it->second);
+            if (jmp->is<IR::DpdkJmpLabelStatement>()) continue;
+        }
+        if (i + 1 < count) successors[i].push_back(i + 1);
+    }
+
+    std::vector<bitvec> liveIn(count), liveOut(count);
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (size_t i = count; i-- > 0;) {
+            bitvec out;
+            for (auto s : successors[i]) out |= liveIn[s];
+            bitvec in = out;
+            in -= def[i];
+            in |= use[i];
+            if (in != liveIn[i] || out != liveOut[i]) changed = true;
+            liveIn[i] = in;
+            liveOut[i] = out;
+        }
+    }
+
+    // A field written while another one is live cannot share its slot.
+    std::vector<bitvec> interferes(candidates.size());
+    for (size_t i = 0; i < count; i++) {
+        for (auto d : def[i]) {
+            interferes[d] |= liveOut[i];
+            for (auto o : liveOut[i]) interferes[o].setbit(d);
+        }
+    }
+
+    // Greedily assign fields to the first slot of their type they do not interfere with.
+    std::vector<std::pair<cstring, bitvec>> slots;
+    std::vector<size_t> representative;
+    for (size_t c = 0; c < candidates.size(); c++) {
+        // Fields that may be read before they are written keep their own slot.
+        if (liveIn[0].getbit(c)) continue;
+        auto type = types.at(candidates[c]);
+        size_t s = 0;
+        for (; s < slots.size(); s++) {
+            if (slots[s].first == type && !(slots[s].second & interferes[c])) break;
+        }
+        if (s == slots.size()) {
+            slots.emplace_back(type, bitvec());
+            representative.push_back(c);
+        }
+        slots[s].second.setbit(c);
+        if (representative[s] != c) {
+            LOG3("Sharing metadata field " << candidates[c] << " with "
+                                           << candidates[representative[s]]);
+            renamed.emplace(candidates[c], candidates[representative[s]]);
+        }
+    }
+}
+
+const IR::Node *ShareMetadataFields::preorder(IR::DpdkAsmProgram *p) {
+    ordered_map<cstring, cstring> types;
+    for (auto st : p->structType) {
+        if (!isMetadataStruct(st)) continue;
+        for (auto field : st->fields) types.emplace(field->name.name, field->type->toString());
+    }
+    CountMetadataUses count;
+    p->apply(count);
+    for (auto s : p->statements)
+        if (auto l = s->to<IR::DpdkListStatement>()) allocate(l, types, count.uses);
+    if (renamed.empty()) prune();
+    return p;
+}
+
+const IR::Node *ShareMetadataFields::preorder(IR::Member *m) {
+    auto it = renamed.find(metadataField(m));
+    if (it != renamed.end()) m->member = IR::ID(m->member.srcInfo, it->second);
+    return m;
+}
+
+namespace {
+
+/// @returns true if @p s only moves or computes a value.
+bool isArithmetic(const IR::DpdkAsmStatement *s) {
+    return s->is<IR::DpdkUnaryStatement>() || s->is<IR::DpdkBinaryStatement>() ||
+           s->is<IR::DpdkCastStatement>();
+}
+
+/// @returns true if the straight-line code after instruction @p i of @p s writes @p dst
+/// before reading it.
+bool overwritten(const IR::IndexedVector<IR::DpdkAsmStatement> &s, size_t i,
+                 const IR::Expression *dst) {
+    for (size_t j = i + 1; j < s.size(); j++) {
+        if (s[j]->is<IR::DpdkValidateStatement>() || s[j]->is<IR::DpdkInvalidateStatement>())
+            continue;
+        if (!isArithmetic(s[j])) return false;
+        std::vector<const IR::Expression *> reads;
+        const IR::Expression *write = nullptr;
+        instructionOperands(s[j], reads, write);
+        for (auto r : reads)
+            if (r->equiv(*dst)) return false;
+        if (write->equiv(*dst)) return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+IR::IndexedVector<IR::DpdkAsmStatement> PeepholeOptimization::fuseMovArithmetic(
+    const IR::IndexedVector<IR::DpdkAsmStatement> &s) {
+    auto typeOf = [this](cstring field) {
+        auto it = types.find(field);
+        return it == types.end() ? cstring() : it->second;
+    };
+    IR::IndexedVector<IR::DpdkAsmStatement> result;
+    for (size_t i = 0; i < s.size(); i++) {
+        auto mov = s[i]->to<IR::DpdkMovStatement>();
+        auto op = i + 1 < s.size() ? s[i + 1]->to<IR::DpdkBinaryStatement>() : nullptr;
+        auto res = i + 2 < s.size() ? s[i + 2]->to<IR::DpdkMovStatement>() : nullptr;
+        if (mov == nullptr || op == nullptr || res == nullptr) {
+            result.push_back(s[i]);
+            continue;
+        }
+        // mov tmp A; op tmp B; mov dst tmp  =>  mov dst A; op dst B
+        auto tmp = metadataField(mov->dst);
+        auto dst = metadataField(res->dst);
+        if (tmp.isNullOrEmpty() || dst.isNullOrEmpty() || tmp == dst ||
+            typeOf(tmp).isNullOrEmpty() || typeOf(tmp) != typeOf(dst) ||
+            !op->dst->equiv(*mov->dst) || !res->src->equiv(*mov->dst) ||
+            op->src2->equiv(*res->dst) || uses[tmp] != 4) {
+            result.push_back(s[i]);
+            continue;
+        }
+        LOG3("Fusing " << mov << ", " << op << " and " << res);
+        result.push_back(new IR::DpdkMovStatement(res->dst, mov->src));
+        auto fused = op->clone();
+        fused->dst = res->dst;
+        fused->src1 = res->dst;
+        result.push_back(fused);
+        i += 2;
+    }
+    return result;
+}
+
+IR::IndexedVector<IR::DpdkAsmStatement> PeepholeOptimization::removeDeadStores(
+    const IR::IndexedVector<IR::DpdkAsmStatement> &s) {
+    IR::IndexedVector<IR::DpdkAsmStatement> result;
+    for (size_t i = 0; i < s.size(); i++) {
+        if (isArithmetic(s[i])) {
+            std::vector<const IR::Expression *> reads;
+            const IR::Expression *write = nullptr;
+            instructionOperands(s[i], reads, write);
+            if (!metadataField(write).isNullOrEmpty() && overwritten(s, i, write)) {
+                LOG3("Removing dead store " << s[i]);
+                continue;
+            }
+        }
+        result.push_back(s[i]);
+    }
+    return result;
+}
+
+IR::IndexedVector<IR::DpdkAsmStatement> PeepholeOptimization::removeRedundantValidity(
+    const IR::IndexedVector<IR::DpdkAsmStatement> &s) {
+    // Known validity of headers in the current straight-line code.
+    std::map<cstring, bool> valid;
+    auto redundant = [&valid](const IR::Expression *header, bool validity) {
+        auto it = valid.find(header->toString());
+        if (it != valid.end() && it->second == validity) return true;
+        valid[header->toString()] = validity;
+        return false;
+    };
+    IR::IndexedVector<IR::DpdkAsmStatement> result;
+    for (auto stmt : s) {
+        if (auto v = stmt->to<IR::DpdkValidateStatement>()) {
+            if (redundant(v->header, true)) {
+                LOG3("Removing redundant " << stmt);
+                continue;
+            }
+        } else if (auto v = stmt->to<IR::DpdkInvalidateStatement>()) {
+            if (redundant(v->header, false)) {
+                LOG3("Removing redundant " << stmt);
+                continue;
+            }
+        } else if (!isArithmetic(stmt) && !stmt->is<IR::DpdkJmpStatement>()) {
+            // Labels join other paths, and other instructions may extract headers
+            // or run actions.
+            valid.clear();
+        }
+        result.push_back(stmt);
+    }
+    return result;
+}
+
+IR::IndexedVector<IR::DpdkAsmStatement> PeepholeOptimization::removeRedundantCondJmp(
+    const IR::IndexedVector<IR::DpdkAsmStatement> &s) {
+    IR::IndexedVector<IR::DpdkAsmStatement> result;
+    for (size_t i = 0; i < s.size(); i++) {
+        auto jmp = s[i]->to<IR::DpdkJmpStatement>();
+        auto next = i + 1 < s.size() ? s[i + 1]->to<IR::DpdkJmpLabelStatement>() : nullptr;
+        if (jmp && !jmp->is<IR::DpdkJmpLabelStatement>() && next && next->label == jmp->label) {
+            LOG3("Removing " << jmp << " followed by " << next);
+            continue;
+        }
+        result.push_back(s[i]);
+    }
+    return result;
+}
+
+IR::IndexedVector<IR::DpdkAsmStatement> PeepholeOptimization::optimize(
+    const IR::IndexedVector<IR::DpdkAsmStatement> &s) {
+    auto result = s;
+    for (size_t size = 0; size != result.size();) {
+        size = result.size();
+        result = fuseMovArithmetic(result);
+        result = removeDeadStores(result);
+        result = removeRedundantValidity(result);
+        result = removeRedundantCondJmp(result);
+    }
+    return result;
+}
+
+size_t PeepholeOptimization::countInstructions(const IR::DpdkAsmProgram *p) {
+    size_t count = 0;
+    auto add = [&count](const IR::IndexedVector<IR::DpdkAsmStatement> &s) {
+        for (auto stmt : s)
+            if (!stmt->is<IR::DpdkLabelStatement>()) count++;
+    };
+    for (auto a : p->actions) add(a->statements);
+    for (auto s : p->statements) {
+        if (auto l = s->to<IR::DpdkListStatement>())
+            add(l->statements);
+        else
+            count++;
+    }
+    return count;
+}
+
+const IR::Node *PeepholeOptimization::preorder(IR::DpdkAsmProgram *p) {
+    for (auto st : p->structType) {
+        if (!isMetadataStruct(st)) continue;
+        for (auto field : st->fields) types.emplace(field->name.name, field->type->toString());
+    }
+    CountMetadataUses count;
+    p->apply(count);
+    uses = count.uses;
+    instructionsBefore = countInstructions(p);
+    return p;
+}
+
+const IR::Node *PeepholeOptimization::postorder(IR::DpdkAsmProgram *p) {
+    ::info(ErrorType::INFO_PROGRESS, "%1% instructions after peephole optimization (%2% before)",
+           countInstructions(p), instructionsBefore);
+    return p;
+}
+
 const IR::Expression *CopyPropagationAndElimination::getIrreplaceableExpr(cstring str,
                                                                           bool allowConst) {
     if (collectUseDef->dontEliminate.count(str) != 0) return nullptr;
@@ -166,6 +166,74 @@ class RemoveUnusedMetadataFields : public Transform {
     bool isByteSizeField(const IR::Type *field_type);
 };
 
+// This pass lets metadata fields of the same type share one field when their
+// live ranges in the apply block do not overlap, like a register allocator
+// does for temporaries. Only fields that are used exclusively as operands of
+// mov, cast, arithmetic/logic instructions and conditional jumps are shared;
+// fields used by tables, actions, externs or the architecture are left alone,
+// as are fields that may be read before they are written. The fields that no
+// longer have uses are then removed by RemoveUnusedMetadataFields.
+class ShareMetadataFields : public Transform {
+    /// For each shared field, the field it is renamed to.
+    ordered_map<cstring, cstring> renamed;
+
+    void allocate(const IR::DpdkListStatement *l, const ordered_map<cstring, cstring> &types,
+                  const std::unordered_map<cstring, unsigned> &uses);
+
+ public:
+    ShareMetadataFields() { setName("ShareMetadataFields"); }
+    const IR::Node *preorder(IR::DpdkAsmProgram *p) override;
+    const IR::Node *preorder(IR::Member *m) override;
+};
+
+// This pass performs peephole optimizations on the instructions of the
+// actions and the apply block:
+// - a move into a metadata temporary, an arithmetic or logic instruction on it
+//   and a move of the result into a metadata field of the same type are fused
+//   into a move and an instruction on the destination field, when the
+//   temporary has no other uses;
+// - writes to metadata fields that are overwritten before they are read are
+//   removed;
+// - validate and invalidate instructions that do not change the validity of
+//   the header are removed;
+// - conditional jumps followed by an unconditional jump to the same label are
+//   removed.
+// The number of instructions before and after the optimizations is reported.
+class PeepholeOptimization : public Transform {
+    /// Type of each metadata field.
+    ordered_map<cstring, cstring> types;
+    /// Number of references to each metadata field.
+    std::unordered_map<cstring, unsigned> uses;
+    size_t instructionsBefore = 0;
+
+    IR::IndexedVector<IR::DpdkAsmStatement> fuseMovArithmetic(
+        const IR::IndexedVector<IR::DpdkAsmStatement> &s);
+    IR::IndexedVector<IR::DpdkAsmStatement> removeDeadStores(
+        const IR::IndexedVector<IR::DpdkAsmStatement> &s);
+    IR::IndexedVector<IR::DpdkAsmStatement> removeRedundantValidity(
+        const IR::IndexedVector<IR::DpdkAsmStatement> &s);
+    IR::IndexedVector<IR::DpdkAsmStatement> removeRedundantCondJmp(
+        const IR::IndexedVector<IR::DpdkAsmStatement> &s);
+    IR::IndexedVector<IR::DpdkAsmStatement> optimize(
+        const IR::IndexedVector<IR::DpdkAsmStatement> &s);
+
+ public:
+    PeepholeOptimization() { setName("PeepholeOptimization"); }
+    /// @returns the number of instructions of the actions and the apply block of @p p.
+    static size_t countInstructions(const IR::DpdkAsmProgram *p);
+
+    const IR::Node *preorder(IR::DpdkAsmProgram *p) override;
+    const IR::Node *postorder(IR::DpdkAsmProgram *p) override;
+    const IR::Node *postorder(IR::DpdkAction *a) override {
+        a->statements = optimize(a->statements);
+        return a;
+    }
+    const IR::Node *postorder(IR::DpdkListStatement *l) override {
+        l->statements = optimize(l->statements);
+        return l;
+    }
+};
+
 // This pass shorten the Identifier length
 class ShortenTokenLength : public Transform {
     ordered_map<cstring, cstring> &newNameMap;
@@ -523,6 +523,10 @@ void DpdkContextGenerator::addMatchTables(Util::JsonArray *tablesJson) {
             sel.setAttributes(tbl, tableAttrmap);
             tableJson->emplace("max_n_groups", sel.max_n_groups);
             tableJson->emplace("max_n_members_per_group", sel.max_n_members_per_group);
+            if (sel.lookup_array_size) {
+                tableJson->emplace("selection_mode", "consistent_hash");
+                tableJson->emplace("lookup_array_size", sel.lookup_array_size);
+            }
             tableJson->emplace("bound_to_action_data_table_handle",
                                sel.bound_to_action_data_table_handle);
         }
@@ -545,11 +549,35 @@ void DpdkContextGenerator::addExternInfo(Util::JsonArray *externsJson) {
         if (externAttr.externType == "DirectCounter" || externAttr.externType == "DirectMeter") {
             attrJson->emplace("table_id", externAttr.table_id);
         }
+        if (options.numPipelines > 1) addExternSharding(externAttr, attrJson);
         externJson->emplace("attributes", attrJson);
         externsJson->append(externJson);
     }
 }
 
+// Every pipeline holds its own instance of each extern, so that cores never write the same
+// state. The control plane sums counters over all pipelines, divides the rates of meters
+// among them, and accesses register entry i in pipeline i % n_pipelines only, the packets
+// updating that entry being steered to that pipeline.
+void DpdkContextGenerator::addExternSharding(const struct externAttributes &externAttr,
+                                             Util::JsonObject *attrJson) {
+    auto *shardingJson = new Util::JsonObject();
+    if (externAttr.externType == "Counter" || externAttr.externType == "DirectCounter") {
+        shardingJson->emplace("mode", "per_pipeline");
+        shardingJson->emplace("read", "sum");
+    } else if (externAttr.externType == "Meter" || externAttr.externType == "DirectMeter") {
+        shardingJson->emplace("mode", "per_pipeline");
+        shardingJson->emplace("rate", "divide");
+    } else if (externAttr.externType == "Register") {
+        shardingJson->emplace("mode", "partitioned");
+        shardingJson->emplace("partition", "index_modulo");
+    } else {
+        // Hash and checksum units hold no state.
+        return;
+    }
+    attrJson->emplace("sharding", shardingJson);
+}
+
 const Util::JsonObject *DpdkContextGenerator::genContextJsonObject() {
     auto *json = new Util::JsonObject();
     auto *tablesJson = new Util::JsonArray();
@@ -562,6 +590,7 @@ const Util::JsonObject *DpdkContextGenerator::genContextJsonObject() {
     json->emplace("compiler_version", tlinfo.compilerVersion);
     json->emplace("schema_version", cstring("0.1"));
     json->emplace("target", cstring("DPDK"));
+    if (options.numPipelines > 1) json->emplace("n_pipelines", options.numPipelines);
     json->emplace("tables", tablesJson);
     addMatchTables(tablesJson);
     json->emplace("externs", externsJson);
@@ -103,6 +103,8 @@ struct TopLevelCtxt {
 struct SelectionTable {
     unsigned max_n_groups;
     unsigned max_n_members_per_group;
+    /// Size of the member array of a group filled by consistent hashing, 0 for modulo selection.
+    unsigned lookup_array_size;
     unsigned bound_to_action_data_table_handle;
     void setAttributes(const IR::P4Table *tbl,
                        const std::map<const cstring, struct TableAttributes> &tableAttrmap) {
@@ -118,6 +120,12 @@ struct SelectionTable {
             auto n_members_expr = n_members->value->to<IR::ExpressionValue>()->expression;
             max_n_members_per_group = n_members_expr->to<IR::Constant>()->asInt();
         }
+        lookup_array_size = 0;
+        if (auto n_members = tbl->properties->getProperty("consistent_hash_members_max")) {
+            auto n_members_expr = n_members->value->to<IR::ExpressionValue>()->expression;
+            lookup_array_size = max_n_members_per_group;
+            max_n_members_per_group = n_members_expr->to<IR::Constant>()->asInt();
+        }
         // Fetch associated member table handle
         cstring actionDataTableName = tbl->name.originalName;
         actionDataTableName = actionDataTableName.replace("_sel", "");
@@ -155,6 +163,7 @@ class DpdkContextGenerator : public Inspector {
     size_t getHandleId(cstring name);
     void collectHandleId();
     void addExternInfo(Util::JsonArray *externsJson);
+    void addExternSharding(const struct externAttributes &externAttr, Util::JsonObject *attrJson);
     Util::JsonObject *initTableCommonJson(const cstring name, const struct TableAttributes &attr);
     void addKeyField(Util::JsonArray *keyJson, const cstring name, const cstring annon,
                      const IR::KeyElement *key, int position);
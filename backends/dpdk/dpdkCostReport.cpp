@@ -0,0 +1,223 @@
+/*
+Copyright 2023 Intel Corp.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "dpdkCostReport.h"
+
+#include <algorithm>
+
+#include "dpdkUtils.h"
+#include "printUtils.h"
+
+namespace DPDK {
+
+namespace {
+
+// Estimated cycles of the SWX instructions and table lookups.
+const size_t instructionCycles = 1;       // move, arithmetic, jump
+const size_t headerCycles = 10;           // extract or emit of a header
+const size_t hashCycles = 20;             // hash of the fields of a struct
+const size_t checksumCycles = 8;          // checksum update with a field
+const size_t externCycles = 5;            // register or counter access
+const size_t meterCycles = 30;            // meter execution
+const size_t exactLookupCycles = 40;      // hash table lookup
+const size_t lpmLookupCycles = 100;       // longest prefix match lookup
+const size_t wildcardLookupCycles = 200;  // search of the masks of a wildcard table
+const size_t selectorCycles = 60;         // hash of the selector fields and group lookup
+
+size_t statementCycles(const IR::DpdkAsmStatement *s) {
+    if (s->is<IR::DpdkLabelStatement>()) return 0;
+    if (s->is<IR::DpdkExtractStatement>() || s->is<IR::DpdkEmitStatement>() ||
+        s->is<IR::DpdkLookaheadStatement>())
+        return headerCycles;
+    if (s->is<IR::DpdkGetHashStatement>()) return hashCycles;
+    if (s->is<IR::DpdkChecksumAddStatement>() || s->is<IR::DpdkChecksumSubStatement>())
+        return checksumCycles;
+    if (s->is<IR::DpdkRegisterReadStatement>() || s->is<IR::DpdkRegisterWriteStatement>() ||
+        s->is<IR::DpdkCounterCountStatement>())
+        return externCycles;
+    if (s->is<IR::DpdkMeterExecuteStatement>()) return meterCycles;
+    return instructionCycles;
+}
+
+// Collects the metadata fields referenced by instructions.
+class CollectMetadataFields : public Inspector {
+ public:
+    std::set<cstring> fields;
+    bool preorder(const IR::Member *m) override {
+        if (m->expr->toString() == "m") fields.insert(m->member.name);
+        return true;
+    }
+};
+
+cstring actionName(const IR::ActionListElement *ale) {
+    if (auto mce = ale->expression->to<IR::MethodCallExpression>()) return toStr(mce->method);
+    return toStr(ale->expression);
+}
+
+}  // namespace
+
+InstructionCost DpdkCostReport::cost(
+    const IR::IndexedVector<IR::DpdkAsmStatement> &statements) const {
+    InstructionCost result;
+    CollectMetadataFields collect;
+    for (auto s : statements) {
+        if (!s->is<IR::DpdkLabelStatement>()) result.instructions++;
+        result.cycles += statementCycles(s);
+        s->apply(collect);
+    }
+    for (auto field : collect.fields) {
+        auto it = metadataWidths.find(field);
+        if (it != metadataWidths.end()) result.metadataBytes += (it->second + 7) / 8;
+    }
+    return result;
+}
+
+size_t DpdkCostReport::actionListCycles(const IR::ActionList *actions) const {
+    size_t cycles = 0;
+    if (actions == nullptr) return cycles;
+    for (auto ale : actions->actionList) {
+        auto it = actionCosts.find(actionName(ale));
+        if (it != actionCosts.end()) cycles = std::max(cycles, it->second.cycles);
+    }
+    return cycles;
+}
+
+Util::JsonObject *DpdkCostReport::tableReport(cstring name, cstring kind, const IR::Key *key,
+                                              size_t lookup, const IR::ActionList *actions) {
+    size_t keyBits = 0;
+    if (key != nullptr) {
+        for (auto ke : key->keyElements) {
+            auto match = ke->matchType->toString();
+            if (match == "lpm")
+                lookup = std::max(lookup, lpmLookupCycles);
+            else if (match != "exact")
+                lookup = std::max(lookup, wildcardLookupCycles);
+            auto field = ke->expression->to<IR::Member>();
+            if (field == nullptr) continue;
+            auto it = metadataWidths.find(field->member.name);
+            if (field->expr->toString() == "m" && it != metadataWidths.end())
+                keyBits += it->second;
+            else if (ke->expression->type->is<IR::Type_Bits>())
+                keyBits += ke->expression->type->width_bits();
+        }
+    }
+    size_t actionCycles = actionListCycles(actions);
+    tableCycles[name] = lookup + actionCycles;
+
+    auto *json = new Util::JsonObject();
+    json->emplace("name", name);
+    json->emplace("kind", kind);
+    json->emplace("key_bytes", (keyBits + 7) / 8);
+    json->emplace("lookup_cycles", lookup);
+    json->emplace("max_action_cycles", actionCycles);
+    json->emplace("cycles", lookup + actionCycles);
+    return json;
+}
+
+Util::JsonObject *DpdkCostReport::pipelineReport(
+    const IR::IndexedVector<IR::DpdkAsmStatement> &statements) {
+    IR::IndexedVector<IR::DpdkAsmStatement> code;
+    for (auto s : statements) {
+        if (auto list = s->to<IR::DpdkListStatement>())
+            code.append(list->statements);
+        else
+            code.push_back(s);
+    }
+    std::map<cstring, size_t> labels;
+    for (size_t i = 0; i < code.size(); i++)
+        if (auto label = code[i]->to<IR::DpdkLabelStatement>()) labels[label->label] = i;
+
+    // The code only jumps forward, except to loop over the elements of header stacks in the
+    // parser; backward jumps are ignored, so that each loop is counted once.
+    std::vector<size_t> lookups(code.size() + 1, 0), cycles(code.size() + 1, 0);
+    for (size_t i = code.size(); i-- > 0;) {
+        auto s = code[i];
+        size_t nextLookups = 0, nextCycles = 0;
+        bool fallsThrough =
+            !s->is<IR::DpdkJmpLabelStatement>() && !s->is<IR::DpdkReturnStatement>();
+        if (fallsThrough) {
+            nextLookups = lookups[i + 1];
+            nextCycles = cycles[i + 1];
+        }
+        if (auto jmp = s->to<IR::DpdkJmpStatement>()) {
+            auto it = labels.find(jmp->label);
+            if (it != labels.end() && it->second > i) {
+                nextLookups = std::max(nextLookups, lookups[it->second]);
+                nextCycles = std::max(nextCycles, cycles[it->second]);
+            }
+        }
+        lookups[i] = nextLookups;
+        cycles[i] = nextCycles + statementCycles(s);
+        if (auto apply = s->to<IR::DpdkApplyStatement>()) {
+            lookups[i]++;
+            auto it = tableCycles.find(apply->table);
+            if (it != tableCycles.end()) cycles[i] += it->second;
+        }
+    }
+
+    auto *json = new Util::JsonObject();
+    auto total = cost(code);
+    json->emplace("instructions", total.instructions);
+    json->emplace("metadata_bytes", total.metadataBytes);
+    json->emplace("table_lookups_longest_path", lookups[0]);
+    json->emplace("cycles_longest_path", cycles[0]);
+    return json;
+}
+
+bool DpdkCostReport::preorder(const IR::DpdkAsmProgram *program) {
+    for (auto st : program->structType) {
+        if (!isMetadataStruct(st)) continue;
+        for (auto field : st->fields)
+            if (auto bits = field->type->to<IR::Type_Bits>())
+                metadataWidths[field->name.name] = bits->width_bits();
+    }
+
+    report = new Util::JsonObject();
+    auto *actionsJson = new Util::JsonArray();
+    for (auto action : program->actions) {
+        auto actionCost = cost(action->statements);
+        actionCosts[action->name.name] = actionCost;
+        auto *json = new Util::JsonObject();
+        json->emplace("name", action->name.name);
+        json->emplace("instructions", actionCost.instructions);
+        json->emplace("metadata_bytes", actionCost.metadataBytes);
+        json->emplace("cycles", actionCost.cycles);
+        actionsJson->append(json);
+    }
+    report->emplace("actions", actionsJson);
+
+    auto *tablesJson = new Util::JsonArray();
+    for (auto table : program->tables)
+        tablesJson->append(tableReport(table->name, "table", table->match_keys,
+                                       exactLookupCycles, table->actions));
+    for (auto selector : program->selectors)
+        tablesJson->append(
+            tableReport(selector->name, "selector", nullptr, selectorCycles, nullptr));
+    for (auto learner : program->learners)
+        tablesJson->append(tableReport(learner->name, "learner", learner->match_keys,
+                                       exactLookupCycles, learner->actions));
+    report->emplace("tables", tablesJson);
+    report->emplace("pipeline", pipelineReport(program->statements));
+    return false;
+}
+
+void DpdkCostReport::serialize(std::ostream *out) const {
+    if (report == nullptr) return;
+    report->serialize(*out);
+    *out << std::endl;
+}
+
+}  // namespace DPDK
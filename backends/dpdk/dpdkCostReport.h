@@ -0,0 +1,61 @@
+/*
+Copyright 2023 Intel Corp.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef BACKENDS_DPDK_DPDKCOSTREPORT_H_
+#define BACKENDS_DPDK_DPDKCOSTREPORT_H_
+
+#include "ir/ir.h"
+#include "lib/json.h"
+
+namespace DPDK {
+
+/// Cost of a sequence of SWX instructions.
+struct InstructionCost {
+    size_t instructions = 0;
+    /// Bytes of the metadata fields the instructions read or write.
+    size_t metadataBytes = 0;
+    size_t cycles = 0;
+};
+
+/// This pass estimates the cost of each action, table and of the longest path through the
+/// pipeline of a DpdkAsmProgram, and builds a JSON report of it. The cycle counts come from a
+/// rough model of the SWX pipeline; they are meant for comparing two versions of a program,
+/// not for predicting its throughput. The report holds no build date or path, so that the
+/// reports of two compilations can be diffed.
+class DpdkCostReport : public Inspector {
+    /// Width in bits of each metadata field.
+    std::map<cstring, size_t> metadataWidths;
+    std::map<cstring, InstructionCost> actionCosts;
+    /// Cycles of a lookup in each table, selector or learner, including the most expensive
+    /// of their actions.
+    std::map<cstring, size_t> tableCycles;
+    Util::JsonObject *report = nullptr;
+
+    InstructionCost cost(const IR::IndexedVector<IR::DpdkAsmStatement> &statements) const;
+    size_t actionListCycles(const IR::ActionList *actions) const;
+    Util::JsonObject *tableReport(cstring name, cstring kind, const IR::Key *key, size_t lookup,
+                                  const IR::ActionList *actions);
+    Util::JsonObject *pipelineReport(const IR::IndexedVector<IR::DpdkAsmStatement> &statements);
+
+ public:
+    DpdkCostReport() { setName("DpdkCostReport"); }
+    bool preorder(const IR::DpdkAsmProgram *program) override;
+    void serialize(std::ostream *out) const;
+};
+
+}  // namespace DPDK
+
+#endif /* BACKENDS_DPDK_DPDKCOSTREPORT_H_ */
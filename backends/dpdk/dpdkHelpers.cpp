@@ -434,16 +434,22 @@ bool ConvertStatementToDpdk::preorder(const IR::AssignmentStatement *a) {
                     // For DPDK, the status is always SUCCESS
                     add_instr(new IR::DpdkMovStatement(status, new IR::Constant(IPSEC_SUCCESS)));
                     BUG_CHECK(metadataStruct, "Metadata structure missing unexpectedly!");
-                    IR::ID portInInbound(refmap->newName("ipsec_port_inbound"));
-                    IR::ID portInOutbound(refmap->newName("ipsec_port_outbound"));
-                    auto port_in_inbound =
-                        new IR::Member(new IR::PathExpression("m"), portInInbound);
-                    auto port_in_outbound =
-                        new IR::Member(new IR::PathExpression("m"), portInOutbound);
-                    metadataStruct->fields.push_back(
-                        new IR::StructField(portInInbound, IR::Type_Bits::get(32)));
-                    metadataStruct->fields.push_back(
-                        new IR::StructField(portInOutbound, IR::Type_Bits::get(32)));
+                    // The ports are read right before they are compared, so all calls can
+                    // read them into the same pair of metadata fields.
+                    if (structure->ipsec_port_in_inbound == nullptr) {
+                        IR::ID portInInbound(refmap->newName("ipsec_port_inbound"));
+                        IR::ID portInOutbound(refmap->newName("ipsec_port_outbound"));
+                        structure->ipsec_port_in_inbound =
+                            new IR::Member(new IR::PathExpression("m"), portInInbound);
+                        structure->ipsec_port_in_outbound =
+                            new IR::Member(new IR::PathExpression("m"), portInOutbound);
+                        metadataStruct->fields.push_back(
+                            new IR::StructField(portInInbound, IR::Type_Bits::get(32)));
+                        metadataStruct->fields.push_back(
+                            new IR::StructField(portInOutbound, IR::Type_Bits::get(32)));
+                    }
+                    auto port_in_inbound = structure->ipsec_port_in_inbound;
+                    auto port_in_outbound = structure->ipsec_port_in_outbound;
                     add_instr(new IR::DpdkRegisterReadStatement(
                         port_in_inbound, "ipsec_port_in_inbound", new IR::Constant(0)));
                     add_instr(new IR::DpdkRegisterReadStatement(
@@ -0,0 +1,573 @@
+/*
+Copyright 2023 Intel Corp.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "dpdkNativeCode.h"
+
+#include "dpdkUtils.h"
+#include "printUtils.h"
+
+namespace DPDK {
+
+namespace {
+
+// Helpers of the generated code that do not depend on the program.
+const char *prelude = R"(#include <stdint.h>
+#include <string.h>
+
+#define SWX_PACKED __attribute__((packed))
+
+/* Return values of swx_pipeline_run(). */
+#define SWX_TX 0
+#define SWX_DROP 1
+
+static inline uint64_t swx_load_h(const uint8_t *p, unsigned n) {
+    uint64_t v = 0;
+    for (unsigned i = 0; i < n; i++) v = (v << 8) | p[i];
+    return v;
+}
+
+static inline void swx_store_h(uint8_t *p, unsigned n, uint64_t v) {
+    for (unsigned i = n; i-- > 0; v >>= 8) p[i] = (uint8_t)v;
+}
+
+/* Metadata fields of 3, 5, 6 or 7 bytes, little endian as in the SWX pipeline. */
+static inline uint64_t swx_load_m(const uint8_t *p, unsigned n) {
+    uint64_t v = 0;
+    for (unsigned i = n; i-- > 0;) v = (v << 8) | p[i];
+    return v;
+}
+
+static inline void swx_store_m(uint8_t *p, unsigned n, uint64_t v) {
+    for (unsigned i = 0; i < n; i++, v >>= 8) p[i] = (uint8_t)v;
+}
+
+static inline uint64_t swx_shl(uint64_t a, uint64_t b) { return b < 64 ? a << b : 0; }
+static inline uint64_t swx_shr(uint64_t a, uint64_t b) { return b < 64 ? a >> b : 0; }
+
+/* ckadd and cksub: adds or subtracts the 16-bit words of src, taken in memory order, to the
+ * one's complement checksum in dst. */
+static inline void swx_cksum(uint8_t *dst, const uint8_t *src, unsigned n, int subtract) {
+    uint32_t sum = 0;
+    for (unsigned i = 0; i + 1 < n; i += 2) sum += src[i] | (uint32_t)src[i + 1] << 8;
+    if (n & 1) sum += src[n - 1];
+    while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+    uint32_t r = ~(dst[0] | (uint32_t)dst[1] << 8) & 0xFFFF;
+    r += subtract ? 0xFFFF - sum : sum;
+    while (r >> 16) r = (r & 0xFFFF) + (r >> 16);
+    r = ~r & 0xFFFF;
+    if (r == 0) r = 0xFFFF;
+    dst[0] = (uint8_t)r;
+    dst[1] = (uint8_t)(r >> 8);
+}
+
+)";
+
+// Declarations of the functions of the application, and helpers using swx_thread.
+const char *interlude = R"(/* Provided by the application. swx_table_lookup() sets hit, action_id and
+ * action_args; action_id is SWX_N_ACTIONS when no action is to run, e.g. for selectors. */
+void swx_table_lookup(struct swx_thread *t, uint32_t table_id);
+uint64_t swx_regrd(struct swx_thread *t, uint32_t register_id, uint64_t index);
+void swx_regwr(struct swx_thread *t, uint32_t register_id, uint64_t index, uint64_t value);
+void swx_regadd(struct swx_thread *t, uint32_t register_id, uint64_t index, uint64_t value);
+/* Runs an instruction of the spec that has no C translation. args are the arguments of the
+ * running action, if any. The result is only used by jumps, which jump when it is not 0. */
+int swx_instruction(struct swx_thread *t, const void *args, const char *instruction);
+
+/* Packets too short for a header are dropped. */
+static inline int swx_extract(struct swx_thread *t, void *h, uint32_t n, uint32_t advance) {
+    if (t->pkt_length - t->pkt_offset < n) return 0;
+    memcpy(h, t->pkt + t->pkt_offset, n);
+    t->pkt_offset += advance;
+    return 1;
+}
+
+static inline void swx_emit(struct swx_thread *t, const void *h, uint32_t n) {
+    if (sizeof(t->out) - t->out_length < n) return;
+    memcpy(t->out + t->out_length, h, n);
+    t->out_length += n;
+}
+
+)";
+
+std::string quote(const std::string &text) {
+    std::string result = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\')
+            result += std::string("\\") + c;
+        else if (c == '\n')
+            result += "\\n";
+        else if (c == '\t')
+            result += "\\t";
+        else
+            result += c;
+    }
+    return result + "\"";
+}
+
+std::vector<std::string> split(const std::string &name) {
+    std::vector<std::string> result;
+    std::stringstream in(name);
+    std::string part;
+    while (std::getline(in, part, '.')) result.push_back(part);
+    return result;
+}
+
+}  // namespace
+
+cstring DpdkNativeCode::headerType(cstring instance) const {
+    for (auto &header : headers)
+        if (header.first == instance) return header.second;
+    return cstring();
+}
+
+DpdkNativeCode::Operand DpdkNativeCode::operand(const IR::Expression *e, cstring args) const {
+    Operand op;
+    while (auto cast = e->to<IR::Cast>()) e = cast->expr;
+    if (auto c = e->to<IR::Constant>()) {
+        if (c->fitsUint64()) {
+            std::stringstream value;
+            value << "0x" << std::hex << c->value << "ULL";
+            op.kind = Operand::Constant;
+            op.code = value.str();
+            op.bytes = 8;
+        }
+        return op;
+    }
+    if (auto b = e->to<IR::BoolLiteral>()) {
+        op.kind = Operand::Constant;
+        op.code = b->value ? "1" : "0";
+        op.bytes = 1;
+        return op;
+    }
+    if (!e->is<IR::Member>()) return op;
+
+    auto path = split(toStr(e).c_str());
+    cstring type;
+    std::string prefix;
+    bool header = false;
+    if (path.size() == 2 && path[0] == "m") {
+        type = metadataType;
+        prefix = "t->m.";
+    } else if (path.size() == 2 && path[0] == "t") {
+        type = args;
+        prefix = "args->";
+    } else if ((path.size() == 2 || path.size() == 3) && path[0] == "h") {
+        type = headerType(path[1]);
+        prefix = "t->h." + path[1];
+        header = true;
+    }
+    auto fields = fieldBytes.find(type);
+    if (type.isNullOrEmpty() || fields == fieldBytes.end()) return op;
+
+    if (header && path.size() == 2) {
+        // A whole header, e.g. the source of ckadd.
+        if (varbitHeaderTypes.count(type)) return op;
+        op.kind = Operand::Bytes;
+        op.code = "(uint8_t *)&" + prefix;
+        for (auto &field : fields->second) op.bytes += field.second;
+        return op;
+    }
+    if (header) prefix += ".";
+    auto field = fields->second.find(path.back());
+    if (field == fields->second.end()) return op;
+    op.code = prefix + path.back();
+    op.bytes = field->second;
+    if (header)
+        op.kind = op.bytes <= 8 ? Operand::Header : Operand::Bytes;
+    else if (op.bytes == 1 || op.bytes == 2 || op.bytes == 4 || op.bytes == 8)
+        op.kind = Operand::Host;
+    else
+        op.kind = op.bytes <= 8 ? Operand::HostArray : Operand::Bytes;
+    return op;
+}
+
+std::string DpdkNativeCode::load(const Operand &op) {
+    auto n = std::to_string(op.bytes);
+    switch (op.kind) {
+        case Operand::Constant:
+            return op.code;
+        case Operand::Host:
+            return "(uint64_t)" + op.code;
+        case Operand::HostArray:
+            return "swx_load_m(" + op.code + ", " + n + ")";
+        case Operand::Header:
+            return "swx_load_h(" + op.code + ", " + n + ")";
+        default:
+            return "";
+    }
+}
+
+std::string DpdkNativeCode::store(const Operand &op, const std::string &value) {
+    if (value.empty()) return "";
+    auto n = std::to_string(op.bytes);
+    switch (op.kind) {
+        case Operand::Host:
+            return op.code + " = (uint" + std::to_string(op.bytes * 8) + "_t)(" + value + ");";
+        case Operand::HostArray:
+            return "swx_store_m(" + op.code + ", " + n + ", " + value + ");";
+        case Operand::Header:
+            return "swx_store_h(" + op.code + ", " + n + ", " + value + ");";
+        default:
+            return "";
+    }
+}
+
+std::string DpdkNativeCode::move(const Operand &dst, const Operand &src) {
+    if (dst.kind == Operand::Bytes && src.kind == Operand::Bytes && dst.bytes == src.bytes)
+        return "memcpy(" + dst.code + ", " + src.code + ", " + std::to_string(dst.bytes) + ");";
+    return store(dst, load(src));
+}
+
+/// Appends the C translation of @s to the code and returns true, or returns false if @s is
+/// left to swx_instruction(). @args is the type of the arguments of the action of @s, if any.
+bool DpdkNativeCode::emitStatement(const IR::DpdkAsmStatement *s, cstring args, bool inAction) {
+    std::string line;
+    auto headerId = [this](const IR::Expression *e) -> std::string {
+        auto path = split(toStr(e).c_str());
+        if (path.size() != 2 || path[0] != "h" || headerType(path[1]).isNullOrEmpty()) return "";
+        return "SWX_HEADER_" + path[1];
+    };
+    auto checksumState = [this](cstring value) {
+        auto state = new IR::Member(new IR::Member(new IR::PathExpression("h"), "cksum_state"),
+                                    value);
+        return operand(state, cstring());
+    };
+
+    if (auto label = s->to<IR::DpdkLabelStatement>()) {
+        code << label->label << ":;" << std::endl;
+        return true;
+    } else if (auto mov = s->to<IR::DpdkMovStatement>()) {
+        line = move(operand(mov->dst, args), operand(mov->src, args));
+    } else if (auto cast = s->to<IR::DpdkCastStatement>()) {
+        line = move(operand(cast->dst, args), operand(cast->src, args));
+    } else if (auto bin = s->to<IR::DpdkBinaryStatement>()) {
+        auto a = load(operand(bin->src1, args));
+        auto b = load(operand(bin->src2, args));
+        if (a.empty() || b.empty()) return false;
+        std::string value;
+        if (s->is<IR::DpdkAddStatement>())
+            value = a + " + " + b;
+        else if (s->is<IR::DpdkSubStatement>())
+            value = a + " - " + b;
+        else if (s->is<IR::DpdkAndStatement>())
+            value = a + " & " + b;
+        else if (s->is<IR::DpdkOrStatement>())
+            value = a + " | " + b;
+        else if (s->is<IR::DpdkXorStatement>())
+            value = a + " ^ " + b;
+        else if (s->is<IR::DpdkShlStatement>())
+            value = "swx_shl(" + a + ", " + b + ")";
+        else if (s->is<IR::DpdkShrStatement>())
+            value = "swx_shr(" + a + ", " + b + ")";
+        line = store(operand(bin->dst, args), value);
+    } else if (auto jmp = s->to<IR::DpdkJmpStatement>()) {
+        std::string condition;
+        if (s->is<IR::DpdkJmpLabelStatement>()) {
+            condition = "1";
+        } else if (s->is<IR::DpdkJmpHitStatement>()) {
+            condition = "t->hit";
+        } else if (s->is<IR::DpdkJmpMissStatement>()) {
+            condition = "!t->hit";
+        } else if (auto ja = s->to<IR::DpdkJmpActionStatement>()) {
+            if (!actionArgs.count(ja->action.name)) return false;
+            condition = "t->action_id " +
+                        std::string(s->is<IR::DpdkJmpIfActionRunStatement>() ? "==" : "!=") +
+                        " SWX_ACTION_" + ja->action.name.c_str();
+        } else if (auto jh = s->to<IR::DpdkJmpHeaderStatement>()) {
+            auto id = headerId(jh->header);
+            if (id.empty()) return false;
+            condition = std::string(s->is<IR::DpdkJmpIfInvalidStatement>() ? "!" : "") +
+                        "t->valid[" + id + "]";
+        } else if (auto jc = s->to<IR::DpdkJmpCondStatement>()) {
+            auto src1 = operand(jc->src1, args);
+            auto src2 = operand(jc->src2, args);
+            std::string op = "<";
+            if (s->is<IR::DpdkJmpEqualStatement>())
+                op = "==";
+            else if (s->is<IR::DpdkJmpNotEqualStatement>())
+                op = "!=";
+            else if (s->is<IR::DpdkJmpGreaterEqualStatement>())
+                op = ">=";
+            else if (s->is<IR::DpdkJmpGreaterStatement>())
+                op = ">";
+            else if (s->is<IR::DpdkJmpLessOrEqualStatement>())
+                op = "<=";
+            if (src1.kind == Operand::Bytes && src2.kind == Operand::Bytes &&
+                src1.bytes == src2.bytes && (op == "==" || op == "!=")) {
+                condition = "memcmp(" + src1.code + ", " + src2.code + ", " +
+                            std::to_string(src1.bytes) + ") " + op + " 0";
+            } else {
+                auto a = load(src1), b = load(src2);
+                if (a.empty() || b.empty()) return false;
+                condition = a + " " + op + " " + b;
+            }
+        }
+        if (condition.empty()) return false;
+        line = (condition == "1" ? "" : "if (" + condition + ") ") + "goto " +
+               jmp->label.c_str() + ";";
+    } else if (auto rx = s->to<IR::DpdkRxStatement>()) {
+        if (inAction) return false;
+        line = store(operand(rx->port, args), "t->port_in");
+        if (line.empty()) return false;
+        line += "\n    memset(t->valid, 0, sizeof(t->valid));";
+        line += "\n    t->pkt_offset = 0;\n    t->out_length = 0;";
+    } else if (auto tx = s->to<IR::DpdkTxStatement>()) {
+        auto port = load(operand(tx->port, args));
+        if (inAction || port.empty()) return false;
+        line = "t->port_out = (uint32_t)(" + port + ");\n    return SWX_TX;";
+    } else if (s->is<IR::DpdkDropStatement>()) {
+        if (inAction) return false;
+        line = "return SWX_DROP;";
+    } else if (s->is<IR::DpdkReturnStatement>()) {
+        if (!inAction) return false;
+        line = "return;";
+    } else if (auto v = s->to<IR::DpdkValidateStatement>()) {
+        auto id = headerId(v->header);
+        if (id.empty()) return false;
+        line = "t->valid[" + id + "] = 1;";
+    } else if (auto iv = s->to<IR::DpdkInvalidateStatement>()) {
+        auto id = headerId(iv->header);
+        if (id.empty()) return false;
+        line = "t->valid[" + id + "] = 0;";
+    } else if (s->is<IR::DpdkExtractStatement>() || s->is<IR::DpdkLookaheadStatement>()) {
+        auto extract = s->to<IR::DpdkExtractStatement>();
+        auto header = extract ? extract->header : s->to<IR::DpdkLookaheadStatement>()->header;
+        auto id = headerId(header);
+        auto h = operand(header, args);
+        if (inAction || (extract && extract->length) || id.empty() || h.kind != Operand::Bytes)
+            return false;
+        auto n = std::to_string(h.bytes);
+        line = "if (!swx_extract(t, " + h.code + ", " + n + ", " + (extract ? n : "0") +
+               ")) return SWX_DROP;\n    t->valid[" + id + "] = 1;";
+    } else if (auto emit = s->to<IR::DpdkEmitStatement>()) {
+        auto id = headerId(emit->header);
+        auto h = operand(emit->header, args);
+        if (id.empty() || h.kind != Operand::Bytes) return false;
+        line = "if (t->valid[" + id + "]) swx_emit(t, " + h.code + ", " +
+               std::to_string(h.bytes) + ");";
+    } else if (auto apply = s->to<IR::DpdkApplyStatement>()) {
+        if (inAction) return false;
+        line = "swx_table_lookup(t, SWX_TABLE_" + std::string(apply->table.c_str()) +
+               ");\n    swx_action_run(t);";
+    } else if (s->is<IR::DpdkChecksumAddStatement>() || s->is<IR::DpdkChecksumSubStatement>()) {
+        auto add = s->to<IR::DpdkChecksumAddStatement>();
+        auto sub = s->to<IR::DpdkChecksumSubStatement>();
+        auto dst = checksumState(add ? add->intermediate_value : sub->intermediate_value);
+        auto src = operand(add ? add->field : sub->field, args);
+        if (dst.kind != Operand::Header || dst.bytes != 2) return false;
+        if (src.kind != Operand::Header && src.kind != Operand::Bytes) return false;
+        line = "swx_cksum(" + dst.code + ", " + src.code + ", " +
+               std::to_string(src.bytes) + ", " + (add ? "0" : "1") + ");";
+    } else if (auto clear = s->to<IR::DpdkChecksumClearStatement>()) {
+        line = store(checksumState(clear->intermediate_value), "0");
+    } else if (auto get = s->to<IR::DpdkGetChecksumStatement>()) {
+        line = move(operand(get->dst, args), checksumState(get->intermediate_value));
+    } else if (auto rd = s->to<IR::DpdkRegisterReadStatement>()) {
+        auto index = load(operand(rd->index, args));
+        if (index.empty()) return false;
+        line = store(operand(rd->dst, args), "swx_regrd(t, SWX_REGISTER_" +
+                                                 std::string(rd->reg.c_str()) + ", " + index +
+                                                 ")");
+    } else if (auto wr = s->to<IR::DpdkRegisterWriteStatement>()) {
+        auto index = load(operand(wr->index, args));
+        auto value = load(operand(wr->src, args));
+        if (index.empty() || value.empty()) return false;
+        line = "swx_regwr(t, SWX_REGISTER_" + std::string(wr->reg.c_str()) + ", " + index +
+               ", " + value + ");";
+    } else if (auto count = s->to<IR::DpdkCounterCountStatement>()) {
+        auto index = load(operand(count->index, args));
+        auto value = count->incr ? load(operand(count->incr, args)) : "1";
+        if (index.empty() || value.empty()) return false;
+        line = "swx_regadd(t, SWX_REGISTER_" + std::string(count->counter.c_str()) + ", " +
+               index + ", " + value + ");";
+    }
+    if (line.empty()) return false;
+    code << "    " << line << std::endl;
+    return true;
+}
+
+void DpdkNativeCode::emitStatements(const IR::IndexedVector<IR::DpdkAsmStatement> &statements,
+                                    cstring args, bool inAction) {
+    for (auto s : statements) {
+        if (auto list = s->to<IR::DpdkListStatement>()) {
+            emitStatements(list->statements, args, inAction);
+            continue;
+        }
+        if (emitStatement(s, args, inAction)) continue;
+        std::stringstream spec;
+        s->toSpec(spec);
+        auto call = "swx_instruction(t, " + std::string(inAction ? "args" : "NULL") + ", " +
+                    quote(spec.str()) + ")";
+        if (auto jmp = s->to<IR::DpdkJmpStatement>())
+            code << "    if (" << call << ") goto " << jmp->label << ";" << std::endl;
+        else
+            code << "    " << call << ";" << std::endl;
+    }
+}
+
+void DpdkNativeCode::emitStruct(const IR::Type_StructLike *type, bool header) {
+    auto &bytes = fieldBytes[type->name.name];
+    code << "struct " << type->name << " {" << std::endl;
+    for (auto field : type->fields) {
+        unsigned width = 0;
+        auto name = field->type->to<IR::Type_Name>();
+        if (auto bits = field->type->to<IR::Type_Bits>()) {
+            width = bits->width_bits();
+        } else if (auto varbits = field->type->to<IR::Type_Varbits>()) {
+            width = varbits->size;
+            varbitHeaderTypes.insert(type->name.name);
+        } else if (field->type->is<IR::Type_Boolean>() || field->type->is<IR::Type_Error>() ||
+                   (name && name->path->name == "error")) {
+            // DPDK implements bool and error as bit<8>
+            width = 8;
+        } else {
+            ::error(ErrorType::ERR_UNSUPPORTED, "%1%: type not supported with --native-code",
+                    field);
+            continue;
+        }
+        if (header && width % 8 != 0) {
+            ::error(ErrorType::ERR_UNSUPPORTED,
+                    "%1%: header fields must be a multiple of 8 bits with --native-code", field);
+            continue;
+        }
+        unsigned n = (width + 7) / 8;
+        bytes[field->name.name] = n;
+        if (!header && (n == 1 || n == 2 || n == 4 || n == 8))
+            code << "    uint" << n * 8 << "_t " << field->name << ";" << std::endl;
+        else
+            code << "    uint8_t " << field->name << "[" << n << "];" << std::endl;
+    }
+    if (type->fields.empty()) code << "    uint8_t unused;" << std::endl;
+    code << "} SWX_PACKED;" << std::endl << std::endl;
+}
+
+bool DpdkNativeCode::preorder(const IR::DpdkAsmProgram *program) {
+    code << "/* Generated by p4c-dpdk from the spec of the same program, do not edit. */"
+         << std::endl;
+    code << prelude;
+
+    code << "/* Headers, in network byte order */" << std::endl;
+    for (auto h : program->headerType) emitStruct(h, true);
+    code << "/* Metadata and action arguments, in host byte order */" << std::endl;
+    for (auto st : program->structType) {
+        if (isHeadersStruct(st)) {
+            for (auto field : st->fields) {
+                if (auto name = field->type->to<IR::Type_Name>()) {
+                    headers.emplace_back(field->name.name, name->path->name.name);
+                } else if (auto stack = field->type->to<IR::Type_Stack>()) {
+                    auto element = stack->elementType->to<IR::Type_Name>();
+                    if (element == nullptr || !stack->size->is<IR::Constant>()) continue;
+                    for (size_t i = 0; i < stack->getSize(); i++)
+                        headers.emplace_back(field->name.name + "_" + Util::toString(i),
+                                             element->path->name.name);
+                }
+            }
+            continue;
+        }
+        if (isMetadataStruct(st)) metadataType = st->name.name;
+        emitStruct(st, false);
+    }
+
+    code << "struct swx_headers {" << std::endl;
+    for (auto &header : headers)
+        code << "    struct " << header.second << " " << header.first << ";" << std::endl;
+    if (headers.empty()) code << "    uint8_t unused;" << std::endl;
+    code << "};" << std::endl << std::endl;
+
+    code << "enum swx_header_id {" << std::endl;
+    for (auto &header : headers) code << "    SWX_HEADER_" << header.first << "," << std::endl;
+    code << "    SWX_N_HEADERS" << std::endl << "};" << std::endl << std::endl;
+
+    code << "enum swx_action_id {" << std::endl;
+    for (auto action : program->actions) {
+        cstring args;
+        if (!action->para.parameters.empty())
+            if (auto name = action->para.parameters.front()->type->to<IR::Type_Name>())
+                args = name->path->name.name;
+        actionArgs[action->name.name] = args;
+        code << "    SWX_ACTION_" << action->name << "," << std::endl;
+    }
+    code << "    SWX_N_ACTIONS" << std::endl << "};" << std::endl << std::endl;
+
+    code << "enum swx_table_id {" << std::endl;
+    for (auto table : program->tables) code << "    SWX_TABLE_" << table->name << "," << std::endl;
+    for (auto s : program->selectors) code << "    SWX_TABLE_" << s->name << "," << std::endl;
+    for (auto l : program->learners) code << "    SWX_TABLE_" << l->name << "," << std::endl;
+    code << "    SWX_N_TABLES" << std::endl << "};" << std::endl << std::endl;
+
+    forAllMatching<IR::DpdkRegisterReadStatement>(
+        program, [this](const IR::DpdkRegisterReadStatement *s) { registers.insert(s->reg); });
+    forAllMatching<IR::DpdkRegisterWriteStatement>(
+        program, [this](const IR::DpdkRegisterWriteStatement *s) { registers.insert(s->reg); });
+    forAllMatching<IR::DpdkCounterCountStatement>(
+        program, [this](const IR::DpdkCounterCountStatement *s) { registers.insert(s->counter); });
+    code << "enum swx_register_id {" << std::endl;
+    for (auto reg : registers) code << "    SWX_REGISTER_" << reg << "," << std::endl;
+    code << "    SWX_N_REGISTERS" << std::endl << "};" << std::endl << std::endl;
+
+    code << "struct swx_thread {" << std::endl;
+    if (!metadataType.isNullOrEmpty()) code << "    struct " << metadataType << " m;" << std::endl;
+    code << "    struct swx_headers h;" << std::endl;
+    code << "    uint8_t valid[SWX_N_HEADERS + 1];" << std::endl;
+    code << "    /* Input packet, set by the application, and offset of the first byte that was "
+            "not\n     * extracted. */"
+         << std::endl;
+    code << "    const uint8_t *pkt;" << std::endl;
+    code << "    uint32_t pkt_length;" << std::endl;
+    code << "    uint32_t pkt_offset;" << std::endl;
+    code << "    /* Emitted headers, to be followed by the input packet from pkt_offset. */"
+         << std::endl;
+    code << "    uint8_t out[sizeof(struct swx_headers)];" << std::endl;
+    code << "    uint32_t out_length;" << std::endl;
+    code << "    uint32_t port_in;" << std::endl;
+    code << "    uint32_t port_out;" << std::endl;
+    code << "    /* Result of the last table lookup */" << std::endl;
+    code << "    int hit;" << std::endl;
+    code << "    uint32_t action_id;" << std::endl;
+    code << "    const void *action_args;" << std::endl;
+    code << "};" << std::endl << std::endl;
+    code << interlude;
+
+    for (auto action : program->actions) {
+        auto args = actionArgs[action->name.name];
+        code << "static void swx_action_" << action->name << "(struct swx_thread *t, ";
+        if (args.isNullOrEmpty())
+            code << "const void *args) {" << std::endl;
+        else
+            code << "const struct " << args << " *args) {" << std::endl;
+        code << "    (void)args;" << std::endl;
+        emitStatements(action->statements, args, true);
+        code << "}" << std::endl << std::endl;
+    }
+
+    code << "static inline void swx_action_run(struct swx_thread *t) {" << std::endl;
+    code << "    switch (t->action_id) {" << std::endl;
+    for (auto action : program->actions) {
+        code << "        case SWX_ACTION_" << action->name << ":" << std::endl;
+        code << "            swx_action_" << action->name << "(t, t->action_args);" << std::endl;
+        code << "            break;" << std::endl;
+    }
+    code << "        default:" << std::endl << "            break;" << std::endl;
+    code << "    }" << std::endl << "}" << std::endl << std::endl;
+
+    code << "/* Runs the pipeline on t->pkt, returns SWX_TX or SWX_DROP. */" << std::endl;
+    code << "int swx_pipeline_run(struct swx_thread *t) {" << std::endl;
+    emitStatements(program->statements, cstring(), false);
+    code << "    return SWX_DROP;" << std::endl << "}" << std::endl;
+    return false;
+}
+
+}  // namespace DPDK
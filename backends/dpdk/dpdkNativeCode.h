@@ -0,0 +1,78 @@
+/*
+Copyright 2023 Intel Corp.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef BACKENDS_DPDK_DPDKNATIVECODE_H_
+#define BACKENDS_DPDK_DPDKNATIVECODE_H_
+
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ir/ir.h"
+
+namespace DPDK {
+
+/// This pass translates the actions and the apply block of a DpdkAsmProgram to C, so that the
+/// pipeline can be compiled ahead of time instead of being interpreted by the SWX pipeline.
+/// Headers, metadata and action arguments are packed structs with the layout of the spec;
+/// header fields are byte arrays in network order, metadata and action arguments are in host
+/// order. Tables, registers and the instructions that have no C translation (meters, hashes,
+/// learners, varbit headers...) are left to functions of the application, declared at the
+/// top of the file.
+class DpdkNativeCode : public Inspector {
+    /// A field, header or constant operand of an instruction.
+    struct Operand {
+        /// Host fields are 1, 2, 4 or 8 bytes wide, HostArray fields 3, 5, 6 or 7 bytes wide. Bytes
+        /// operands, wider fields and whole headers, are only copied and compared.
+        enum Kind { Invalid, Constant, Host, HostArray, Header, Bytes } kind = Invalid;
+        /// C lvalue of the field, pointer to the header, or value of the constant.
+        std::string code;
+        unsigned bytes = 0;
+    };
+
+    /// Size in bytes of the fields of each header and struct type.
+    std::map<cstring, std::map<cstring, unsigned>> fieldBytes;
+    /// Header types with a varbit field, which are extracted and emitted by the application.
+    std::set<cstring> varbitHeaderTypes;
+    /// Type of each header instance, in the order of the spec.
+    std::vector<std::pair<cstring, cstring>> headers;
+    cstring metadataType;
+    /// Type of the arguments of each action, empty for actions without arguments.
+    std::map<cstring, cstring> actionArgs;
+    std::set<cstring> registers;
+    std::stringstream code;
+
+    cstring headerType(cstring instance) const;
+    Operand operand(const IR::Expression *e, cstring args) const;
+    static std::string load(const Operand &op);
+    static std::string store(const Operand &op, const std::string &value);
+    static std::string move(const Operand &dst, const Operand &src);
+    bool emitStatement(const IR::DpdkAsmStatement *s, cstring args, bool inAction);
+    void emitStatements(const IR::IndexedVector<IR::DpdkAsmStatement> &statements, cstring args,
+                        bool inAction);
+    void emitStruct(const IR::Type_StructLike *type, bool header);
+
+ public:
+    DpdkNativeCode() { setName("DpdkNativeCode"); }
+    bool preorder(const IR::DpdkAsmProgram *program) override;
+    void serialize(std::ostream *out) const { *out << code.str(); }
+};
+
+}  // namespace DPDK
+
+#endif /* BACKENDS_DPDK_DPDKNATIVECODE_H_ */
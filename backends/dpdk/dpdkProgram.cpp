@@ -16,7 +16,10 @@ limitations under the License.
 
 #include "dpdkProgram.h"
 
+#include <algorithm>
+#include <set>
 #include <unordered_map>
+#include <vector>
 
 #include "backend.h"
 #include "dpdkHelpers.h"
@@ -107,10 +110,10 @@ const IR::DpdkAsmProgram *ConvertToDpdkProgram::create(IR::P4Program *prog) {
 
     IR::IndexedVector<IR::DpdkAsmStatement> statements;
 
-    auto ingress_parser_converter =
-        new ConvertToDpdkParser(refmap, typemap, structure, metadataStruct);
-    auto egress_parser_converter =
-        new ConvertToDpdkParser(refmap, typemap, structure, metadataStruct);
+    auto ingress_parser_converter = new ConvertToDpdkParser(refmap, typemap, structure,
+                                                            metadataStruct, options.selectTree);
+    auto egress_parser_converter = new ConvertToDpdkParser(refmap, typemap, structure,
+                                                           metadataStruct, options.selectTree);
     for (auto kv : structure->parsers) {
         if (kv.first == "IngressParser")
             kv.second->apply(*ingress_parser_converter);
@@ -337,6 +340,98 @@ void ConvertToDpdkParser::handleTupleExpression(const IR::ListExpression *cl,
     add_instr(new IR::DpdkJmpLabelStatement(trueLabel));
 }
 
+namespace {
+// Selects with fewer cases are compared one by one, and so are the leaves of the search tree.
+const size_t minSelectTreeCases = 8;
+const size_t selectTreeLeafCases = 3;
+}  // namespace
+
+/* This is a helper function for handling a select on a single expression whose keysets are
+   distinct constants. At most one case matches, so the cases can be compared in any order:
+   the cases going to a state annotated with @likely are compared first, and with
+   --parser-select-tree, the others are found by a binary search on the value of the
+   expression, with jmplt instructions, instead of being compared one by one.
+
+   transition select(a) {                Equivalent dpdk assembly, with a tree:
+       1 : s1;                           jmplt lt_0 a, 5
+       ...                   ==>         jmplt lt_1 a, 7
+       8 : s8;                           jmpeq s7 a, 7
+       default : s0;                     jmpeq s8 a, 8
+   }                                     jmp s0
+                                         lt_1 : ...   (cases 5 and 6)
+                                         lt_0 : ...   (cases 1 to 4)
+   Returns false, when the select is left to the default lowering. */
+bool ConvertToDpdkParser::lowerConstantSelect(const IR::P4Parser *p,
+                                              const IR::Expression *switchVar,
+                                              const IR::Vector<IR::SelectCase> &cases) {
+    if (switchVar->is<IR::Constant>() || switchVar->type->width_bits() > 64) return false;
+    std::vector<const IR::SelectCase *> likely, others;
+    std::set<big_int> values;
+    const IR::SelectCase *defaultCase = nullptr;
+    for (auto sc : cases) {
+        if (sc->keyset->is<IR::DefaultExpression>()) {
+            // The cases after the default one are never reached.
+            defaultCase = sc;
+            break;
+        }
+        auto value = sc->keyset->to<IR::Constant>();
+        if (value == nullptr || !values.insert(value->value).second) return false;
+        auto target = p->states.getDeclaration<IR::ParserState>(sc->state->path->name);
+        if (target != nullptr && target->getAnnotation("likely"))
+            likely.push_back(sc);
+        else
+            others.push_back(sc);
+    }
+    bool tree = selectTree && others.size() >= minSelectTreeCases;
+    if (likely.empty() && !tree) return false;
+
+    for (auto sc : likely)
+        add_instr(new IR::DpdkJmpEqualStatement(append_parser_name(p, sc->state->path->name),
+                                                switchVar->clone(), sc->keyset->clone()));
+    // Without a default case, nothing matches and the code falls through, as in the default
+    // lowering.
+    cstring missLabel = defaultCase != nullptr
+                            ? append_parser_name(p, defaultCase->state->path->name)
+                            : append_parser_name(p, refmap->newName("select_miss"));
+    if (tree) {
+        std::sort(others.begin(), others.end(),
+                  [](const IR::SelectCase *a, const IR::SelectCase *b) {
+                      return a->keyset->to<IR::Constant>()->value <
+                             b->keyset->to<IR::Constant>()->value;
+                  });
+        emitSelectTree(p, switchVar, others, 0, others.size(), missLabel);
+    } else {
+        for (auto sc : others)
+            add_instr(new IR::DpdkJmpEqualStatement(append_parser_name(p, sc->state->path->name),
+                                                    switchVar->clone(), sc->keyset->clone()));
+        if (defaultCase != nullptr) add_instr(new IR::DpdkJmpLabelStatement(missLabel));
+    }
+    if (defaultCase == nullptr) add_instr(new IR::DpdkLabelStatement(missLabel));
+    return true;
+}
+
+/* Emits the search of switchVar among the cases [begin, end), sorted by value, jumping to
+   missLabel when it is none of them. */
+void ConvertToDpdkParser::emitSelectTree(const IR::P4Parser *p, const IR::Expression *switchVar,
+                                         const std::vector<const IR::SelectCase *> &cases,
+                                         size_t begin, size_t end, cstring missLabel) {
+    if (end - begin <= selectTreeLeafCases) {
+        for (auto i = begin; i < end; i++)
+            add_instr(new IR::DpdkJmpEqualStatement(
+                append_parser_name(p, cases[i]->state->path->name), switchVar->clone(),
+                cases[i]->keyset->clone()));
+        add_instr(new IR::DpdkJmpLabelStatement(missLabel));
+        return;
+    }
+    auto middle = begin + (end - begin) / 2;
+    auto lower = append_parser_name(p, refmap->newName("select_lt"));
+    add_instr(new IR::DpdkJmpLessStatement(lower, switchVar->clone(),
+                                           cases[middle]->keyset->clone()));
+    emitSelectTree(p, switchVar, cases, middle, end, missLabel);
+    add_instr(new IR::DpdkLabelStatement(lower));
+    emitSelectTree(p, switchVar, cases, begin, middle, missLabel);
+}
+
 bool ConvertToDpdkParser::preorder(const IR::P4Parser *p) {
     for (auto l : p->parserLocals) {
         structure->push_variable(new IR::DpdkDeclaration(l));
@@ -403,7 +498,10 @@ bool ConvertToDpdkParser::preorder(const IR::P4Parser *p) {
                      tuple expressions would anyways require additional and conversion to
                      ListExpression.
                 */
-                if (e->select->components.size() == 1) {
+                if (e->select->components.size() == 1 &&
+                    lowerConstantSelect(p, e->select->components.at(0), caseList)) {
+                    // Lowered to a search among constants.
+                } else if (e->select->components.size() == 1) {
                     switch_var = e->select->components.at(0);
                     for (auto sc : caseList) {
                         caseExpr = sc->keyset;
@@ -64,11 +64,18 @@ class ConvertToDpdkParser : public Inspector {
     P4::TypeMap *typemap;
     DpdkProgramStructure *structure;
     IR::Type_Struct *metadataStruct;
+    // Lower the selects on many constants to a binary search.
+    bool selectTree;
 
  public:
     ConvertToDpdkParser(P4::ReferenceMap *refmap, P4::TypeMap *typemap,
-                        DpdkProgramStructure *structure, IR::Type_Struct *metadataStruct)
-        : refmap(refmap), typemap(typemap), structure(structure), metadataStruct(metadataStruct) {}
+                        DpdkProgramStructure *structure, IR::Type_Struct *metadataStruct,
+                        bool selectTree = false)
+        : refmap(refmap),
+          typemap(typemap),
+          structure(structure),
+          metadataStruct(metadataStruct),
+          selectTree(selectTree) {}
     IR::IndexedVector<IR::DpdkAsmStatement> getInstructions() { return instructions; }
 
     bool preorder(const IR::P4Parser *a) override;
@@ -80,6 +87,11 @@ class ConvertToDpdkParser : public Inspector {
                                int inputSize, cstring trueLabel, cstring falseLabel);
     void getCondVars(const IR::Expression *sv, const IR::Expression *ce, IR::Expression **leftExpr,
                      IR::Expression **rightExpr);
+    bool lowerConstantSelect(const IR::P4Parser *p, const IR::Expression *switchVar,
+                             const IR::Vector<IR::SelectCase> &cases);
+    void emitSelectTree(const IR::P4Parser *p, const IR::Expression *switchVar,
+                        const std::vector<const IR::SelectCase *> &cases, size_t begin,
+                        size_t end, cstring missLabel);
 };
 
 class ConvertToDpdkControl : public Inspector {
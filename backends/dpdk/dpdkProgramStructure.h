@@ -57,6 +57,9 @@ struct DpdkProgramStructure {
 
     IR::Type_Struct *metadataStruct;
     IR::Expression *ipsec_header;
+    // Metadata fields holding the ipsec input ports, shared by all calls to from_ipsec.
+    IR::Expression *ipsec_port_in_inbound = nullptr;
+    IR::Expression *ipsec_port_in_outbound = nullptr;
     cstring local_metadata_type = "";
     cstring header_type = "";
     IR::IndexedVector<IR::StructField> compiler_added_fields;
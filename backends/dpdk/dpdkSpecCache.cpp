@@ -0,0 +1,247 @@
+/*
+Copyright 2023 Intel Corp.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "dpdkSpecCache.h"
+
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+
+#include "backends/dpdk/version.h"
+#include "frontends/p4/toP4/toP4.h"
+#include "ir/binary_loader.h"
+#include "ir/binary_writer.h"
+#include "lib/hash.h"
+#include "lib/log.h"
+
+namespace DPDK {
+
+namespace {
+
+std::filesystem::path entryPath(cstring dir, cstring key, const char *suffix) {
+    return std::filesystem::path(dir.c_str()) / (key + suffix).c_str();
+}
+
+/// @returns the source position of @p node as file:line:column, or an empty string.
+cstring position(const IR::Node *node) {
+    if (!node->srcInfo.isValid()) return cstring();
+    auto start = node->srcInfo.getStart();
+    std::stringstream result;
+    result << node->srcInfo.getSourceFile() << ":" << start.getLineNumber() << ":"
+           << start.getColumnNumber();
+    return result.str();
+}
+
+/// @returns the constant value of the size property of a table, or nullptr.
+const IR::Constant *sizeValue(const IR::TableProperties *properties) {
+    auto size = properties->getProperty(IR::TableProperties::sizePropertyName);
+    if (size == nullptr) return nullptr;
+    auto ev = size->value->to<IR::ExpressionValue>();
+    return ev ? ev->expression->to<IR::Constant>() : nullptr;
+}
+
+// Replaces the sizes of tables by 0, so that they are not part of the cache key.
+class RemoveTableSizes : public Transform {
+ public:
+    const IR::Node *postorder(IR::Property *property) override {
+        if (property->name == IR::TableProperties::sizePropertyName)
+            property->value = new IR::ExpressionValue(new IR::Constant(0));
+        return property;
+    }
+};
+
+// Collects the sizes of tables, and finds whether the output depends on them in other ways.
+class CollectTableSizes : public Inspector {
+    std::map<cstring, const IR::Constant *> &sizes;
+    bool &cacheable;
+
+    void checkExtern(const IR::Type *type) {
+        if (auto ts = type->to<IR::Type_Specialized>()) type = ts->baseType;
+        auto tn = type->to<IR::Type_Name>();
+        if (tn && (tn->path->name == "DirectCounter" || tn->path->name == "DirectMeter"))
+            cacheable = false;
+    }
+
+ public:
+    CollectTableSizes(std::map<cstring, const IR::Constant *> &sizes, bool &cacheable)
+        : sizes(sizes), cacheable(cacheable) {}
+    bool preorder(const IR::P4Table *table) override {
+        if (table->properties->getProperty(IR::TableProperties::sizePropertyName)) {
+            auto size = sizeValue(table->properties);
+            auto pos = size ? position(size) : cstring();
+            if (pos.isNullOrEmpty())
+                cacheable = false;
+            else
+                sizes[pos] = size;
+        }
+        return true;
+    }
+    bool preorder(const IR::Declaration_Instance *di) override {
+        checkExtern(di->type);
+        return true;
+    }
+    bool preorder(const IR::ConstructorCallExpression *cce) override {
+        checkExtern(cce->constructedType);
+        return true;
+    }
+};
+
+// Sets the sizes of the DPDK tables and learners to the given constants.
+class ReplaceTableSizes : public Transform {
+    const std::map<cstring, const IR::Constant *> &sizes;
+
+    const IR::TableProperties *replace(cstring table, const IR::TableProperties *properties) {
+        auto it = sizes.find(table);
+        if (it == sizes.end()) return properties;
+        IR::IndexedVector<IR::Property> result;
+        for (auto property : properties->properties) {
+            if (property->name == IR::TableProperties::sizePropertyName)
+                property = new IR::Property(property->srcInfo, property->name,
+                                            new IR::ExpressionValue(it->second), false);
+            result.push_back(property);
+        }
+        return new IR::TableProperties(properties->srcInfo, std::move(result));
+    }
+
+ public:
+    explicit ReplaceTableSizes(const std::map<cstring, const IR::Constant *> &sizes)
+        : sizes(sizes) {}
+    const IR::Node *postorder(IR::DpdkTable *table) override {
+        table->properties = replace(table->name, table->properties);
+        return table;
+    }
+    const IR::Node *postorder(IR::DpdkLearner *learner) override {
+        learner->properties = replace(learner->name, learner->properties);
+        return learner;
+    }
+};
+
+// Writes @p write's output to @p path through a private file, so that concurrent
+// compilations never observe a partially written entry.
+template <typename Writer>
+bool writeEntry(const std::filesystem::path &path, Writer write) {
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    auto tmp = path;
+    tmp += "." + std::to_string(getpid()) + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary);
+        if (out) write(out);
+        if (!out) {
+            ::warning(ErrorType::WARN_FAILED, "Could not write spec cache entry %1%",
+                      tmp.string());
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        ::warning(ErrorType::WARN_FAILED, "Could not write spec cache entry %1%: %2%",
+                  path.string(), ec.message());
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+SpecCache::SpecCache(DpdkOptions &options, const IR::P4Program *program)
+    : dir(options.specCacheDir) {
+    if (dir.isNullOrEmpty() || !options.ctxtFile.isNullOrEmpty() ||
+        !options.tableStatsFile.isNullOrEmpty() || !options.nativeCodeFile.isNullOrEmpty())
+        return;
+    bool cacheable = true;
+    program->apply(CollectTableSizes(sizes, cacheable));
+    if (!cacheable) {
+        LOG2("Not caching the DPDK program, whose output depends on table sizes");
+        return;
+    }
+
+    std::stringstream text;
+    program->apply(RemoveTableSizes())->apply(P4::ToP4(&text, false));
+    std::stringstream opts;
+    opts << DPDK_VERSION_STRING << " " << options.getCompileCommand();
+    std::stringstream result;
+    result << std::hex << std::setfill('0') << std::setw(16) << Util::hash(text.str())
+           << std::setw(16) << Util::hash(opts.str());
+    key = result.str();
+}
+
+const IR::DpdkAsmProgram *SpecCache::load() const {
+    if (key.isNullOrEmpty()) return nullptr;
+    auto path = entryPath(dir, key, ".dpdk.p4ir");
+    std::ifstream in(path, std::ios::binary);
+    std::ifstream sizesIn(entryPath(dir, key, ".sizes"));
+    if (!in || !sizesIn) {
+        LOG2("Spec cache miss for " << path);
+        return nullptr;
+    }
+    BinaryIRLoader loader(in);
+    if (!loader.valid()) {
+        LOG2("Ignoring spec cache entry " << path << " written by another compiler version");
+        return nullptr;
+    }
+    const auto *node = loader.readNode();
+    if (!node || !node->is<IR::DpdkAsmProgram>()) return nullptr;
+
+    // Each line holds the name of a table and the source position of its size.
+    std::map<cstring, const IR::Constant *> tableSizes;
+    std::string table, pos;
+    while (sizesIn >> table && std::getline(sizesIn >> std::ws, pos)) {
+        auto it = sizes.find(pos);
+        if (it == sizes.end()) {
+            LOG2("Ignoring spec cache entry " << path << ", the size of " << table << " moved");
+            return nullptr;
+        }
+        tableSizes[table] = it->second;
+    }
+    LOG2("Spec cache hit for " << path);
+    return node->apply(ReplaceTableSizes(tableSizes))->to<IR::DpdkAsmProgram>();
+}
+
+void SpecCache::store(const IR::DpdkAsmProgram *program) const {
+    if (key.isNullOrEmpty() || program == nullptr) return;
+    std::stringstream tableSizes;
+    auto record = [&](cstring table, const IR::TableProperties *properties) {
+        if (!properties->getProperty(IR::TableProperties::sizePropertyName)) return true;
+        auto size = sizeValue(properties);
+        auto pos = size ? position(size) : cstring();
+        if (sizes.count(pos)) {
+            tableSizes << table << " " << pos << std::endl;
+            return true;
+        }
+        // Sizes that do not come from a table are part of the key; others cannot be told
+        // apart from them without a source position.
+        return !pos.isNullOrEmpty();
+    };
+    for (auto table : program->tables)
+        if (!record(table->name, table->properties)) return;
+    for (auto learner : program->learners)
+        if (!record(learner->name, learner->properties)) return;
+
+    if (!writeEntry(entryPath(dir, key, ".sizes"),
+                    [&](std::ostream &out) { out << tableSizes.str(); }))
+        return;
+    writeEntry(entryPath(dir, key, ".dpdk.p4ir"),
+               [&](std::ostream &out) { BinaryIRWriter(out) << program; });
+}
+
+}  // namespace DPDK
@@ -0,0 +1,54 @@
+/*
+Copyright 2023 Intel Corp.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef BACKENDS_DPDK_DPDKSPECCACHE_H_
+#define BACKENDS_DPDK_DPDKSPECCACHE_H_
+
+#include "ir/ir.h"
+#include "options.h"
+
+namespace DPDK {
+
+/// An on-disk cache of the DpdkAsmProgram the midend and the back end produce for a program.
+/// Entries are keyed by the frontend output with the sizes of the tables left out, and by the
+/// compiler options. On a hit, the sizes of the tables of the cached program are replaced by
+/// those of the program being compiled, so that resizing tables does not need the midend and
+/// the back end to run again.
+///
+/// The sizes are matched by the source position of their value, which the cache records next
+/// to each entry since the binary IR format does not keep source positions. Programs whose
+/// output depends on table sizes in other ways (direct counters and meters, whose arrays are
+/// sized after their table, or table statistics) and compilations that write a context JSON,
+/// which is built during the conversion, or a C translation of the pipeline, are not cached.
+class SpecCache {
+    cstring dir;
+    /// Empty if the program cannot be cached.
+    cstring key;
+    /// Size of each table of the program being compiled, by the source position of its value.
+    std::map<cstring, const IR::Constant *> sizes;
+
+ public:
+    SpecCache(DpdkOptions &options, const IR::P4Program *program);
+    /// @returns the cached program with the table sizes of the program being compiled, or
+    /// nullptr on a miss.
+    const IR::DpdkAsmProgram *load() const;
+    /// Saves @p program; failures only produce a warning, as the cache is an optimization.
+    void store(const IR::DpdkAsmProgram *program) const;
+};
+
+}  // namespace DPDK
+
+#endif /* BACKENDS_DPDK_DPDKSPECCACHE_H_ */
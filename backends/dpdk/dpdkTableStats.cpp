@@ -0,0 +1,139 @@
+/*
+Copyright 2023 Intel Corp.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "dpdkTableStats.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "frontends/p4/coreLibrary.h"
+#include "frontends/p4/tableApply.h"
+
+namespace DPDK {
+
+bool readTableStats(cstring file, ordered_map<cstring, TableStats> &stats) {
+    std::ifstream in(file.c_str());
+    if (!in) {
+        ::error(ErrorType::ERR_IO, "%1%: cannot open table statistics file", file);
+        return false;
+    }
+    std::string line;
+    for (unsigned lineNumber = 1; std::getline(in, line); lineNumber++) {
+        auto comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        std::istringstream fields(line);
+        std::string name;
+        if (!(fields >> name)) continue;
+        TableStats entry;
+        if (!(fields >> entry.entries >> entry.hitRate)) {
+            ::error(ErrorType::ERR_INVALID,
+                    "%1%:%2%: expected a table name, its number of entries and its hit rate",
+                    file, lineNumber);
+            return false;
+        }
+        fields >> entry.insertsPerSecond;
+        stats[name] = entry;
+    }
+    return true;
+}
+
+const IR::Node *ApplyTableStats::postorder(IR::P4Table *table) {
+    auto it = stats.find(table->controlPlaneName());
+    if (it == stats.end()) return table;
+    auto &entry = it->second;
+
+    bool exact = true;
+    size_t keyWidth = 0;
+    if (auto key = table->getKey()) {
+        for (auto ke : key->keyElements) {
+            if (ke->matchType->path->name != P4::P4CoreLibrary::instance().exactMatch.name)
+                exact = false;
+            keyWidth += ke->expression->type->width_bits();
+        }
+    }
+    bool learner = false;
+    if (auto prop = table->properties->getProperty("add_on_miss")) {
+        if (auto ev = prop->value->to<IR::ExpressionValue>())
+            if (auto b = ev->expression->to<IR::BoolLiteral>()) learner = b->value;
+    }
+
+    // Wildcard tables are searched in full, hash tables keep room for collisions.
+    size_t size = 1;
+    size_t needed = exact ? entry.entries * exactLoadFactor : entry.entries;
+    while (size < needed) size <<= 1;
+    auto declared = table->getSizeProperty();
+    if (declared && declared->fitsUint64() && declared->asUint64() < entry.entries)
+        ::warning(ErrorType::WARN_OVERFLOW, "%1%: size %2% is too small for %3% entries", table,
+                  declared, entry.entries);
+    LOG1(table->controlPlaneName() << ": " << entry.entries << " entries, hit rate "
+                                   << entry.hitRate << ", size " << size);
+
+    if (exact && !learner && entry.insertsPerSecond >= learnerInsertRate)
+        ::warning(ErrorType::WARN_UNSUPPORTED,
+                  "%1%: %2% entries are inserted per second; consider making it a learner table "
+                  "with 'add_on_miss = true'",
+                  table, entry.insertsPerSecond);
+
+    IR::IndexedVector<IR::Property> properties;
+    for (auto prop : table->properties->properties) {
+        if (prop->name == IR::TableProperties::sizePropertyName || prop->name == "hash") continue;
+        properties.push_back(prop);
+    }
+    properties.push_back(new IR::Property(IR::ID(IR::TableProperties::sizePropertyName),
+                                          new IR::ExpressionValue(new IR::Constant(size)), false));
+    if (exact && keyWidth > 0) {
+        cstring hash = keyWidth <= crc32MaxKeyWidth ? "crc32" : "jhash";
+        properties.push_back(new IR::Property(
+            IR::ID("hash"), new IR::ExpressionValue(new IR::StringLiteral(hash)), false));
+    }
+    table->properties = new IR::TableProperties(table->properties->srcInfo, std::move(properties));
+    return table;
+}
+
+const IR::Node *OrderBranchesByHitRate::postorder(IR::IfStatement *statement) {
+    auto empty = [](const IR::Statement *s) {
+        if (s == nullptr || s->is<IR::EmptyStatement>()) return true;
+        auto block = s->to<IR::BlockStatement>();
+        return block != nullptr && block->components.empty();
+    };
+    if (empty(statement->ifTrue) || empty(statement->ifFalse)) return statement;
+
+    auto condition = statement->condition;
+    bool negated = false;
+    if (auto lnot = condition->to<IR::LNot>()) {
+        condition = lnot->expr;
+        negated = true;
+    }
+    auto table = P4::TableApplySolver::isHit(condition, refMap, typeMap);
+    if (table == nullptr) return statement;
+    auto it = stats.find(table->controlPlaneName());
+    if (it == stats.end()) return statement;
+
+    // The branch taken on a hit should be the one jumped to, i.e. the else branch.
+    bool hitFirst = !negated;
+    if (hitFirst != (it->second.hitRate > 0.5)) return statement;
+    LOG2(table->controlPlaneName() << ": hit rate " << it->second.hitRate
+                                   << ", swapping the branches of " << statement->condition);
+    const IR::Expression *swapped = condition;
+    if (!negated) {
+        swapped = new IR::LNot(statement->condition->srcInfo, condition);
+        typeMap->setType(swapped, IR::Type_Boolean::get());
+    }
+    return new IR::IfStatement(statement->srcInfo, swapped, statement->ifFalse,
+                               statement->ifTrue);
+}
+
+}  // namespace DPDK
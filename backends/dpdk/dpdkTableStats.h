@@ -0,0 +1,88 @@
+/*
+Copyright 2023 Intel Corp.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef BACKENDS_DPDK_DPDKTABLESTATS_H_
+#define BACKENDS_DPDK_DPDKTABLESTATS_H_
+
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/typeMap.h"
+#include "ir/ir.h"
+#include "lib/ordered_map.h"
+
+namespace DPDK {
+
+/// Statistics of a table exported from a running pipeline.
+struct TableStats {
+    /// Number of entries installed in the table.
+    size_t entries = 0;
+    /// Fraction of the lookups that hit an entry.
+    double hitRate = 0;
+    /// Number of entries the control plane adds per second.
+    double insertsPerSecond = 0;
+};
+
+/// Reads table statistics from @p file. Each line holds the control plane name of a table,
+/// its number of entries, its hit rate and optionally the number of entries inserted per
+/// second, separated by spaces; '#' starts a comment.
+/// @returns false, after reporting an error, if the file cannot be read.
+bool readTableStats(cstring file, ordered_map<cstring, TableStats> &stats);
+
+/// This pass sizes the tables listed in the statistics for the number of entries they hold,
+/// and chooses the hash function of exact match and learner tables from the width of their
+/// key. The hash function is stored in the 'hash' property, which is emitted in the .spec
+/// file. It also warns about exact match tables updated so often by the control plane that
+/// they are better implemented as learner tables (add_on_miss = true).
+class ApplyTableStats : public Transform {
+    const ordered_map<cstring, TableStats> &stats;
+
+ public:
+    /// Hash tables are sized so that they are at most half full.
+    static const size_t exactLoadFactor = 2;
+    /// Keys up to this width are hashed with crc32, which the CPU computes 8 bytes at a
+    /// time; wider keys are hashed with jhash.
+    static const size_t crc32MaxKeyWidth = 256;
+    /// Exact match tables receiving more insertions per second should be learner tables.
+    static constexpr double learnerInsertRate = 1000;
+
+    explicit ApplyTableStats(const ordered_map<cstring, TableStats> &stats) : stats(stats) {
+        setName("ApplyTableStats");
+    }
+    const IR::Node *postorder(IR::P4Table *table) override;
+};
+
+/// This pass lays out the branches of the conditionals on the hit of a table so that the
+/// most frequent outcome takes the jump. The SWX code of 'if (t.apply().hit) A else B' falls
+/// through to A and jumps over B at the end of it, so the path through A runs one more jump
+/// than the path through B. The pass rewrites the conditional as 'if (!t.apply().hit) B else
+/// A' when the table hits more often than it misses, and the other way around. Conditionals
+/// with an empty branch run a single jump on both paths and are left alone.
+class OrderBranchesByHitRate : public Transform {
+    P4::ReferenceMap *refMap;
+    P4::TypeMap *typeMap;
+    const ordered_map<cstring, TableStats> &stats;
+
+ public:
+    OrderBranchesByHitRate(P4::ReferenceMap *refMap, P4::TypeMap *typeMap,
+                           const ordered_map<cstring, TableStats> &stats)
+        : refMap(refMap), typeMap(typeMap), stats(stats) {
+        setName("OrderBranchesByHitRate");
+    }
+    const IR::Node *postorder(IR::IfStatement *statement) override;
+};
+
+}  // namespace DPDK
+
+#endif /* BACKENDS_DPDK_DPDKTABLESTATS_H_ */
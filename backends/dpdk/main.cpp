@@ -16,11 +16,20 @@ limitations under the License.
 
 #include <cstdio>
 #include <fstream>  // IWYU pragma: keep
+#include <functional>
 #include <iostream>
+#include <optional>
 #include <string>
+#include <vector>
+#ifdef MULTITHREAD
+#include <exception>
+#include <mutex>
+#include <thread>
+#endif  // MULTITHREAD
 
 #include "backends/dpdk/backend.h"
 #include "backends/dpdk/control-plane/bfruntime_arch_handler.h"
+#include "backends/dpdk/dpdkSpecCache.h"
 #include "backends/dpdk/midend.h"
 #include "backends/dpdk/options.h"
 #include "backends/dpdk/tdiConf.h"
@@ -28,6 +37,7 @@ limitations under the License.
 #include "control-plane/bfruntime_ext.h"
 #include "control-plane/p4RuntimeSerializer.h"
 #include "frontends/common/applyOptionsPragmas.h"
+#include "frontends/common/compileServer.h"
 #include "frontends/common/parseInput.h"
 #include "frontends/common/parser_options.h"
 #include "frontends/p4/frontend.h"
@@ -40,7 +50,7 @@ limitations under the License.
 #include "lib/log.h"
 #include "lib/nullstream.h"
 
-void generateTDIBfrtJson(bool isTDI, const IR::P4Program *program, DPDK::DpdkOptions &options) {
+void registerDpdkArchHandlers(DPDK::DpdkOptions &options) {
     auto p4RuntimeSerializer = P4::P4RuntimeSerializer::get();
     if (options.arch == "psa")
         p4RuntimeSerializer->registerArch(
@@ -48,8 +58,10 @@ void generateTDIBfrtJson(bool isTDI, const IR::P4Program *program, DPDK::DpdkOpt
     if (options.arch == "pna")
         p4RuntimeSerializer->registerArch(
             "pna", new P4::ControlPlaneAPI::Standard::PNAArchHandlerBuilderForDPDK());
-    auto p4Runtime = P4::generateP4Runtime(program, options.arch);
+}
 
+void generateTDIBfrtJson(bool isTDI, const P4::P4RuntimeAPI &p4Runtime,
+                         DPDK::DpdkOptions &options) {
     cstring filename = isTDI ? options.tdiFile : options.bfRtSchema;
     auto p4rt = new P4::BFRT::BFRuntimeSchemaGenerator(*p4Runtime.p4Info, isTDI, options);
     std::ostream *out = openFile(filename, false);
@@ -60,13 +72,37 @@ void generateTDIBfrtJson(bool isTDI, const IR::P4Program *program, DPDK::DpdkOpt
     p4rt->serializeBFRuntimeSchema(out);
 }
 
-int main(int argc, char *const argv[]) {
-    setup_gc_logging();
+/// Runs @p tasks, which only read the program and the P4Runtime API, each on its own thread
+/// when built with MULTITHREAD and in turn otherwise.
+void runConcurrently(const std::vector<std::function<void()>> &tasks) {
+#ifdef MULTITHREAD
+    std::exception_ptr failure;
+    std::mutex failureLock;
+    std::vector<std::thread> threads;
+    for (const auto &task : tasks) {
+        threads.emplace_back([&]() {
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> acquire(failureLock);
+                if (!failure) failure = std::current_exception();
+            }
+        });
+    }
+    for (auto &t : threads) t.join();
+    if (failure) std::rethrow_exception(failure);
+#else
+    for (const auto &task : tasks) task();
+#endif  // MULTITHREAD
+}
 
+static int compileMain(int argc, char *const argv[]) {
     AutoCompileContext autoDpdkContext(new DPDK::DpdkContext);
     auto &options = DPDK::DpdkContext::get().options();
     options.langVersion = CompilerOptions::FrontendVersion::P4_16;
     options.compilerVersion = DPDK_VERSION_STRING;
+    // Runs P4::FrontEnd without a policy, and shares its IR cache entries.
+    options.irCacheScope = "P4::FrontEnd";
 
     if (options.process(argc, argv) != nullptr) {
         if (options.loadIRFromJson == false) options.setInputFile();
@@ -110,22 +146,57 @@ int main(int argc, char *const argv[]) {
         fb.close();
     }
 
-    P4::serializeP4RuntimeIfRequired(program, options);
-    if (::errorCount() > 0) return 1;
-
+    // The TDI builder configuration picks the names of the schema and context files.
     if (!options.tdiBuilderConf.isNullOrEmpty()) {
         DPDK::TdiBfrtConf::generate(program, options);
     }
 
-    if (!options.bfRtSchema.isNullOrEmpty()) {
-        generateTDIBfrtJson(false, program, options);
+    // The P4Runtime API is generated once with the standard arch handlers for the P4Runtime
+    // files, and once with the DPDK ones for the BF-Runtime and TDI schemas. The files built
+    // from it are independent, and are written concurrently.
+    std::optional<P4::P4RuntimeAPI> p4Runtime, dpdkP4Runtime;
+    P4::P4RuntimeSerializer::get()->readPreviousP4Info(options);
+    if (P4::P4RuntimeSerializer::isRequired(options))
+        p4Runtime = P4::generateP4Runtime(program, P4::P4RuntimeSerializer::resolveArch(options));
+    if (!options.bfRtSchema.isNullOrEmpty() || !options.tdiFile.isNullOrEmpty()) {
+        registerDpdkArchHandlers(options);
+        dpdkP4Runtime = P4::generateP4Runtime(program, options.arch);
     }
-    if (!options.tdiFile.isNullOrEmpty()) {
-        generateTDIBfrtJson(true, program, options);
+    if (::errorCount() > 0) return 1;
+
+    std::vector<std::function<void()>> tasks;
+    if (p4Runtime) {
+        tasks.push_back([&]() {
+            P4::P4RuntimeSerializer::get()->serializeP4RuntimeIfRequired(*p4Runtime, options);
+        });
     }
+    if (!options.bfRtSchema.isNullOrEmpty())
+        tasks.push_back([&]() { generateTDIBfrtJson(false, *dpdkP4Runtime, options); });
+    if (!options.tdiFile.isNullOrEmpty())
+        tasks.push_back([&]() { generateTDIBfrtJson(true, *dpdkP4Runtime, options); });
+    runConcurrently(tasks);
 
     if (::errorCount() > 0) return 1;
-    auto p4info = *P4::generateP4Runtime(program, options.arch).p4Info;
+    DPDK::SpecCache specCache(options, program);
+    if (auto cached = specCache.load()) {
+        if (!options.outputFile.isNullOrEmpty()) {
+            std::ostream *out = openFile(options.outputFile, false);
+            if (out != nullptr) {
+                cached->toSpec(*out) << std::endl;
+                out->flush();
+            }
+        }
+        return ::errorCount() > 0;
+    }
+
+    // The back end uses the P4Info of the arch handlers registered last, for the target arch.
+    const P4::P4RuntimeAPI *backendP4Runtime = nullptr;
+    if (dpdkP4Runtime)
+        backendP4Runtime = &*dpdkP4Runtime;
+    else if (p4Runtime && P4::P4RuntimeSerializer::resolveArch(options) == options.arch)
+        backendP4Runtime = &*p4Runtime;
+    auto p4info = backendP4Runtime ? *backendP4Runtime->p4Info
+                                   : *P4::generateP4Runtime(program, options.arch).p4Info;
     DPDK::DpdkMidEnd midEnd(options);
     midEnd.addDebugHook(hook);
     try {
@@ -143,6 +214,7 @@ int main(int argc, char *const argv[]) {
 
     backend->convert(toplevel);
     if (::errorCount() > 0) return 1;
+    specCache.store(backend->getDpdkProgram());
 
     if (!options.outputFile.isNullOrEmpty()) {
         std::ostream *out = openFile(options.outputFile, false);
@@ -154,3 +226,8 @@ int main(int argc, char *const argv[]) {
 
     return ::errorCount() > 0;
 }
+
+int main(int argc, char *const argv[]) {
+    setup_gc_logging();
+    return P4::CompileServer::main(argc, argv, compileMain);
+}
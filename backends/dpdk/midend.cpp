@@ -45,9 +45,9 @@ limitations under the License.
 #include "midend/expandEmit.h"
 #include "midend/expandLookahead.h"
 #include "midend/fillEnumMap.h"
-#include "midend/flattenHeaders.h"
-#include "midend/flattenInterfaceStructs.h"
+#include "midend/flattenAggregates.h"
 #include "midend/flattenUnions.h"
+#include "midend/foldIsValid.h"
 #include "midend/hsIndexSimplify.h"
 #include "midend/local_copyprop.h"
 #include "midend/midEndLast.h"
@@ -201,8 +201,7 @@ DpdkMidEnd::DpdkMidEnd(CompilerOptions &options, std::ostream *outStream) {
             new P4::NestedStructs(&refMap, &typeMap),
             new P4::SimplifySelectList(&refMap, &typeMap),
             new P4::RemoveSelectBooleans(&refMap, &typeMap),
-            new P4::FlattenHeaders(&refMap, &typeMap),
-            new P4::FlattenInterfaceStructs(&refMap, &typeMap),
+            new P4::FlattenAggregates(&refMap, &typeMap),
             new P4::EliminateTypedef(&refMap, &typeMap),
             new P4::HSIndexSimplifier(&refMap, &typeMap),
             new P4::ParsersUnroll(true, &refMap, &typeMap),
@@ -212,6 +211,7 @@ DpdkMidEnd::DpdkMidEnd(CompilerOptions &options, std::ostream *outStream) {
             new P4::MoveDeclarations(),  // more may have been introduced
             new P4::ConstantFolding(&refMap, &typeMap),
             new P4::LocalCopyPropagation(&refMap, &typeMap, nullptr, policy),
+            new P4::FoldIsValid(&refMap, &typeMap),
             new PassRepeated({new P4::ConstantFolding(&refMap, &typeMap),
                               new P4::StrengthReduction(&refMap, &typeMap)}),
             new P4::MoveDeclarations(),
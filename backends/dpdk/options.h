@@ -36,6 +36,28 @@ class DpdkOptions : public CompilerOptions {
     bool loadIRFromJson = false;
     // Enable/disable Egress pipeline in PSA.
     bool enableEgress = false;
+    // Share metadata fields whose live ranges do not overlap.
+    bool shareMetadataFields = false;
+    // Lower the parser selects on many constants to a binary search.
+    bool selectTree = false;
+    // Run peephole optimizations on the generated instructions.
+    bool peephole = false;
+    // Share pseudo header fields between the statements copying wide operands.
+    bool reusePseudoHeaderFields = false;
+    // File with the statistics of the tables of a running pipeline.
+    cstring tableStatsFile = "";
+    // Reorder metadata fields so that table keys are contiguous.
+    bool coalesceKeyFields = false;
+    // Size action selector groups for consistent hashing.
+    bool consistentHashSelectors = false;
+    // Number of pipelines, one per core, sharing the state of the program.
+    unsigned numPipelines = 1;
+    // File to output the instruction and cycle estimates of actions and tables to.
+    cstring costReportFile = "";
+    // File to output the C translation of the pipeline to.
+    cstring nativeCodeFile = "";
+    // Directory of the cache of DPDK programs (see SpecCache), if any.
+    cstring specCacheDir = "";
 
     DpdkOptions() {
         registerOption(
@@ -54,6 +76,103 @@ class DpdkOptions : public CompilerOptions {
                 return true;
             },
             "[Dpdk back-end] Enable egress pipeline's codegen\n", OptionFlags::Hide);
+        registerOption(
+            "--share-metadata-fields", nullptr,
+            [this](const char *) {
+                shareMetadataFields = true;
+                return true;
+            },
+            "[Dpdk back-end] Let metadata fields of the same type whose live ranges do not\n"
+            "overlap share one field, reducing the size of the metadata struct.\n");
+        registerOption(
+            "--peephole", nullptr,
+            [this](const char *) {
+                peephole = true;
+                return true;
+            },
+            "[Dpdk back-end] Run peephole optimizations on the generated instructions and\n"
+            "report the number of instructions.\n");
+        registerOption(
+            "--parser-select-tree", nullptr,
+            [this](const char *) {
+                selectTree = true;
+                return true;
+            },
+            "[Dpdk back-end] Lower the parser selects on 8 constants or more to a binary\n"
+            "search with jmplt instructions, instead of comparing the constants one by one.\n");
+        registerOption(
+            "--reuse-pseudo-header-fields", nullptr,
+            [this](const char *) {
+                reusePseudoHeaderFields = true;
+                return true;
+            },
+            "[Dpdk back-end] Share the pseudo header fields holding copies of operands wider\n"
+            "than 64 bits between statements instead of adding fields for every copy.\n");
+        registerOption(
+            "--table-stats", "file",
+            [this](const char *arg) {
+                tableStatsFile = arg;
+                return true;
+            },
+            "[Dpdk back-end] Size tables, choose their hash function and lay out the branches\n"
+            "on their hits from the entry counts and hit rates in file, one\n"
+            "'table entries hit_rate [inserts_per_second]' per line.\n");
+        registerOption(
+            "--coalesce-key-fields", nullptr,
+            [this](const char *) {
+                coalesceKeyFields = true;
+                return true;
+            },
+            "[Dpdk back-end] Reorder metadata fields so that the keys of exact match tables\n"
+            "are contiguous and need not be copied before each lookup.\n");
+        registerOption(
+            "--consistent-hash-selectors", nullptr,
+            [this](const char *) {
+                consistentHashSelectors = true;
+                return true;
+            },
+            "[Dpdk back-end] Size the member array of action selector groups as a lookup\n"
+            "table the control plane fills by consistent hashing, so that membership changes\n"
+            "only remap the flows of the changed members.\n");
+        registerOption(
+            "--pipelines", "N",
+            [this](const char *arg) {
+                numPipelines = std::strtoul(arg, nullptr, 0);
+                if (numPipelines == 0) {
+                    ::error(ErrorType::ERR_INVALID, "--pipelines: expected a positive number");
+                    return false;
+                }
+                return true;
+            },
+            "[Dpdk back-end] Describe in the context JSON how the state of counters, meters\n"
+            "and registers is sharded across N pipelines running the program on separate\n"
+            "cores (default: 1).\n");
+        registerOption(
+            "--cost-report", "file",
+            [this](const char *arg) {
+                costReportFile = arg;
+                return true;
+            },
+            "[Dpdk back-end] Write the instruction count, metadata bytes and estimated cycles\n"
+            "of each action and table, and of the longest path of the pipeline, to file.\n");
+        registerOption(
+            "--native-code", "file",
+            [this](const char *arg) {
+                nativeCodeFile = arg;
+                return true;
+            },
+            "[Dpdk back-end] Write a C translation of the actions and of the apply block of\n"
+            "the pipeline to file, to be compiled ahead of time instead of being interpreted.\n");
+        registerOption(
+            "--spec-cache", "dir",
+            [this](const char *arg) {
+                specCacheDir = arg;
+                return true;
+            },
+            "[Dpdk back-end] Cache the DPDK program in dir, keyed by the program without its\n"
+            "table sizes, so that only changing table sizes skips the midend and the\n"
+            "back end. Not used with --context, --table-stats, --native-code, or direct\n"
+            "counters and meters.\n");
 
         registerOption(
             "--bf-rt-schema", "file",
@@ -450,6 +450,11 @@ std::ostream &IR::DpdkTable::toSpec(std::ostream &out) const {
     if (auto psa_implementation = properties->getProperty("psa_implementation")) {
         out << "\taction_selector " << DPDK::toStr(psa_implementation->value) << std::endl;
     }
+    if (auto hash = properties->getProperty("hash")) {
+        auto ev = hash->value->to<IR::ExpressionValue>();
+        if (auto name = ev ? ev->expression->to<IR::StringLiteral>() : nullptr)
+            out << "\thash " << name->value << std::endl;
+    }
     if (auto size = properties->getProperty("size")) {
         out << "\tsize " << DPDK::toStr(size->value) << "" << std::endl;
     } else {
@@ -502,6 +507,11 @@ std::ostream &IR::DpdkLearner::toSpec(std::ostream &out) const {
         BUG("non-zero default action arguments not supported yet");
     }
     out << std::endl;
+    if (auto hash = properties->getProperty("hash")) {
+        auto ev = hash->value->to<IR::ExpressionValue>();
+        if (auto name = ev ? ev->expression->to<IR::StringLiteral>() : nullptr)
+            out << "\thash " << name->value << std::endl;
+    }
     if (auto size = properties->getProperty("size")) {
         out << "\tsize " << DPDK::toStr(size->value) << "" << std::endl;
     } else {
@@ -16,6 +16,8 @@ limitations under the License.
 
 #include "codeGen.h"
 
+#include <algorithm>
+
 #include "ebpfObject.h"
 #include "ebpfType.h"
 #include "frontends/common/resolveReferences/referenceMap.h"
@@ -262,6 +264,72 @@ bool CodeGenInspector::preorder(const IR::ListExpression *expression) {
     return false;
 }
 
+void CodeGenInspector::emitStackShift(const P4::BuiltInMethod *method) {
+    auto stack = typeMap->getType(method->appliedTo, true)->to<IR::Type_Stack>();
+    BUG_CHECK(stack != nullptr, "%1%: expected a header stack", method->appliedTo);
+    auto count = method->expr->arguments->at(0)->expression->to<IR::Constant>();
+    if (!stack->sizeKnown() || count == nullptr ||
+        !typeMap->getTypeType(stack->elementType, true)->is<IR::Type_Header>()) {
+        ::error(ErrorType::ERR_UNSUPPORTED,
+                "%1%: only constant shifts of header stacks are supported", method->expr);
+        return;
+    }
+    bool push = method->name == IR::Type_Stack::push_front;
+    int size = static_cast<int>(stack->getSize());
+    int shift = std::min(count->asInt(), size);
+    // Elements that receive a copy of another element; the others become invalid.
+    int moved = size - shift;
+
+    auto element = [this, method](const std::string &index) {
+        visit(method->appliedTo);
+        builder->appendFormat("[%s]", index.c_str());
+    };
+    bool first = true;
+    auto statement = [this, &first]() {
+        if (!first) {
+            builder->endOfStatement(true);
+            builder->emitIndent();
+        }
+        first = false;
+    };
+
+    if (stack->getSize() <= maxUnrolledStackSize) {
+        for (int k = 0; k < moved; k++) {
+            // push_front copies from the end, so that no element is overwritten before it is read.
+            int to = push ? size - 1 - k : k;
+            statement();
+            element(std::to_string(to));
+            builder->append(" = ");
+            element(std::to_string(push ? to - shift : to + shift));
+        }
+        for (int k = 0; k < shift; k++) {
+            statement();
+            element(std::to_string(push ? k : moved + k));
+            builder->append(".ebpf_valid = false");
+        }
+        return;
+    }
+
+    std::string i = refMap->newName("i").c_str();
+    if (moved > 0) {
+        statement();
+        if (push)
+            builder->appendFormat("for (int %s = %d; %s >= %d; %s--) ", i.c_str(), size - 1,
+                                  i.c_str(), shift, i.c_str());
+        else
+            builder->appendFormat("for (int %s = 0; %s < %d; %s++) ", i.c_str(), i.c_str(), moved,
+                                  i.c_str());
+        element(i);
+        builder->append(" = ");
+        element(i + (push ? " - " : " + ") + std::to_string(shift));
+    }
+    statement();
+    builder->appendFormat("for (int %s = %d; %s < %d; %s++) ", i.c_str(), push ? 0 : moved,
+                          i.c_str(), push ? shift : size, i.c_str());
+    element(i);
+    builder->append(".ebpf_valid = false");
+}
+
 bool CodeGenInspector::preorder(const IR::MethodCallExpression *expression) {
     auto mi = P4::MethodInstance::resolve(expression, refMap, typeMap);
     auto bim = mi->to<P4::BuiltInMethod>();
@@ -279,6 +347,10 @@ bool CodeGenInspector::preorder(const IR::MethodCallExpression *expression) {
             visit(bim->appliedTo);
             builder->append(".ebpf_valid = false");
             return false;
+        } else if (bim->name == IR::Type_Stack::push_front ||
+                   bim->name == IR::Type_Stack::pop_front) {
+            emitStackShift(bim);
+            return false;
         }
     }
 
@@ -24,6 +24,7 @@ limitations under the License.
 
 namespace P4 {
 
+class BuiltInMethod;
 class ReferenceMap;
 
 }
@@ -126,6 +127,13 @@ class CodeGenInspector : public Inspector {
     bool preorder(const IR::IfStatement *s) override;
 
     void widthCheck(const IR::Node *node) const;
+
+    /// Stacks with at most this many elements are shifted by push_front and pop_front
+    /// one element copy at a time; larger stacks are shifted in bounded loops, so that
+    /// the code size does not grow with the depth of the stack.
+    static const size_t maxUnrolledStackSize = 4;
+    /// Emits a push_front or pop_front of a header stack.
+    void emitStackShift(const P4::BuiltInMethod *method);
 };
 
 class EBPFInitializerUtils {
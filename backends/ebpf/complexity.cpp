@@ -0,0 +1,206 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "complexity.h"
+
+#include <algorithm>
+
+#include "frontends/p4/coreLibrary.h"
+#include "frontends/p4/methodInstance.h"
+#include "lib/log.h"
+
+namespace EBPF {
+
+namespace {
+
+// Upper bounds of the instructions emitted for common constructs.
+const size_t helperCall = 20;    // argument setup, the call and the check of its result
+const size_t keyField = 4;       // load, byte swap, mask and store of a key field
+const size_t headerField = 4;    // load, byte swap, shift and store of a field up to 64 bits
+const size_t wideFieldByte = 3;  // load, store and offset update of each byte of a wider field
+const size_t boundsCheck = 4;    // packet length check before accessing a header
+
+}  // namespace
+
+ComplexityEstimate EstimateComplexity::headerCost(const IR::Expression *header) const {
+    ComplexityEstimate cost;
+    cost.instructions = boundsCheck;
+    cost.branches = 2;  // header validity and packet length
+    auto type = typeMap->getType(header, true);
+    if (auto st = type->to<IR::Type_StructLike>()) {
+        for (auto field : st->fields) {
+            auto width = static_cast<size_t>(typeMap->widthBits(field->type, field, true));
+            cost.instructions += width <= 64 ? headerField : (width + 7) / 8 * wideFieldByte;
+        }
+    }
+    return cost;
+}
+
+void EstimateComplexity::tableApply(const IR::P4Table *table) {
+    size_t lookups = 1;
+    size_t keyFields = 0;
+    if (auto key = table->getKey()) {
+        keyFields = key->keyElements.size();
+        for (auto ke : key->keyElements)
+            if (ke->matchType->path->name == P4::P4CoreLibrary::instance().ternaryMatch.name)
+                lookups = ternaryMasks;
+    }
+    // A lookup in the default action map follows a miss.
+    estimate.instructions += (helperCall + keyFields * keyField) * lookups + helperCall;
+    estimate.branches += 2 * lookups + 1;
+
+    auto actions = table->getActionList();
+    if (actions == nullptr) return;
+    for (auto ale : actions->actionList) {
+        auto mce = ale->expression->to<IR::MethodCallExpression>();
+        auto path = mce ? mce->method->to<IR::PathExpression>()
+                        : ale->expression->to<IR::PathExpression>();
+        if (path == nullptr) continue;
+        auto action = refMap->getDeclaration(path->path)->to<IR::P4Action>();
+        if (action == nullptr) continue;
+        // The action is selected by a switch on the action id of the entry.
+        estimate.instructions += 2;
+        estimate.branches++;
+        visit(action->body);
+    }
+}
+
+bool EstimateComplexity::preorder(const IR::P4Parser *parser) {
+    visit(parser->states);
+    return false;
+}
+
+bool EstimateComplexity::preorder(const IR::ParserState *state) {
+    // States extracting the next element of a stack run once per element.
+    size_t times = 1;
+    for (auto component : state->components) {
+        auto mcs = component->to<IR::MethodCallStatement>();
+        if (mcs == nullptr) continue;
+        for (auto arg : *mcs->methodCall->arguments) {
+            auto member = arg->expression->to<IR::Member>();
+            if (member == nullptr || member->member.name != IR::Type_Stack::next) continue;
+            auto stack = typeMap->getType(member->expr, true)->to<IR::Type_Stack>();
+            if (stack != nullptr && stack->sizeKnown()) times = std::max(times, stack->getSize());
+        }
+    }
+
+    auto saved = estimate;
+    estimate = ComplexityEstimate();
+    visit(state->components);
+    if (state->selectExpression != nullptr) visit(state->selectExpression);
+    estimate.instructions++;  // the transition
+    auto stateCost = estimate * times;
+    estimate = saved;
+    estimate += stateCost;
+    return false;
+}
+
+bool EstimateComplexity::preorder(const IR::SelectExpression *expression) {
+    visit(expression->select);
+    estimate.instructions += 2 * expression->selectCases.size();
+    estimate.branches += expression->selectCases.size();
+    return false;
+}
+
+bool EstimateComplexity::preorder(const IR::P4Control *control) {
+    visit(control->body);
+    return false;
+}
+
+bool EstimateComplexity::preorder(const IR::AssignmentStatement *) {
+    estimate.instructions++;
+    return true;
+}
+
+bool EstimateComplexity::preorder(const IR::IfStatement *) {
+    estimate.instructions++;
+    estimate.branches++;
+    return true;
+}
+
+bool EstimateComplexity::preorder(const IR::SwitchStatement *statement) {
+    estimate.instructions += statement->cases.size();
+    estimate.branches += statement->cases.size();
+    return true;
+}
+
+bool EstimateComplexity::preorder(const IR::MethodCallExpression *expression) {
+    auto mi = P4::MethodInstance::resolve(expression, refMap, typeMap);
+    if (auto am = mi->to<P4::ApplyMethod>()) {
+        if (am->isTableApply()) {
+            tableApply(am->object->to<IR::P4Table>());
+            return false;
+        }
+    } else if (auto em = mi->to<P4::ExternMethod>()) {
+        auto &corelib = P4::P4CoreLibrary::instance();
+        auto externName = em->originalExternType->name.name;
+        auto methodName = em->method->name.name;
+        if ((externName == corelib.packetIn.name && methodName == corelib.packetIn.extract.name) ||
+            (externName == corelib.packetOut.name && methodName == corelib.packetOut.emit.name)) {
+            if (!expression->arguments->empty())
+                estimate += headerCost(expression->arguments->at(0)->expression);
+            return false;
+        }
+        estimate.instructions += helperCall;
+        estimate.branches++;
+    } else if (mi->is<P4::ExternFunction>()) {
+        estimate.instructions += helperCall;
+        estimate.branches++;
+    } else if (auto ac = mi->to<P4::ActionCall>()) {
+        visit(ac->action->body);
+    } else if (auto fc = mi->to<P4::FunctionCall>()) {
+        visit(fc->function->body);
+    } else if (auto bm = mi->to<P4::BuiltInMethod>()) {
+        auto stack = typeMap->getType(bm->appliedTo, true)->to<IR::Type_Stack>();
+        if (stack != nullptr && stack->sizeKnown()) {
+            // Every element is copied or invalidated, eight bytes per load and store
+            // pair; the verifier walks each iteration of a loop.
+            auto width = typeMap->widthBits(stack->elementType, bm->appliedTo, true);
+            size_t copy = 2 * ((static_cast<size_t>(width) + 63) / 64) + 2;
+            estimate.instructions += copy * stack->getSize();
+            estimate.branches += stack->getSize();
+        }
+    }
+    visit(expression->arguments);
+    return false;
+}
+
+bool EstimateComplexity::preorder(const IR::Operation *) {
+    estimate.instructions += 2;
+    return true;
+}
+
+bool EstimateComplexity::preorder(const IR::PathExpression *) {
+    estimate.instructions++;
+    return false;
+}
+
+bool EstimateComplexity::preorder(const IR::Literal *) {
+    estimate.instructions++;
+    return false;
+}
+
+bool EstimateComplexity::report(cstring section, const ComplexityEstimate &estimate,
+                                size_t limit) {
+    LOG1(section << ": at most " << estimate.instructions << " instructions and "
+                 << estimate.branches << " branches");
+    if (limit == 0 || estimate.instructions <= limit) return false;
+    ::warning("%1%: estimated %2% instructions may exceed the verifier limit of %3%", section,
+              estimate.instructions, limit);
+    return true;
+}
+
+}  // namespace EBPF
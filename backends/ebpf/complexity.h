@@ -0,0 +1,94 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef BACKENDS_EBPF_COMPLEXITY_H_
+#define BACKENDS_EBPF_COMPLEXITY_H_
+
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/typeMap.h"
+#include "ir/ir.h"
+
+namespace EBPF {
+
+/// Upper bounds on the size of the code generated for a program section.
+struct ComplexityEstimate {
+    size_t instructions = 0;
+    size_t branches = 0;
+
+    ComplexityEstimate &operator+=(const ComplexityEstimate &other) {
+        instructions += other.instructions;
+        branches += other.branches;
+        return *this;
+    }
+    ComplexityEstimate operator*(size_t times) const {
+        ComplexityEstimate result;
+        result.instructions = instructions * times;
+        result.branches = branches * times;
+        return result;
+    }
+};
+
+/**
+ * Estimates the eBPF instructions and conditional branches the backend
+ * generates for a parser or a control, so that sections likely to exceed the
+ * verifier limits are reported at compile time instead of at load time.
+ *
+ * The estimate is conservative: each construct is charged an upper bound of
+ * the code emitted for it, both arms of conditionals and every action of a
+ * table are counted, parser states extracting into header stacks are counted
+ * once per stack element, and ternary lookups once per mask.
+ */
+class EstimateComplexity : public Inspector {
+    P4::ReferenceMap *refMap;
+    P4::TypeMap *typeMap;
+    /// Number of masks a ternary lookup may iterate over.
+    size_t ternaryMasks;
+
+    /// Instructions copying a header between the packet and its structure.
+    ComplexityEstimate headerCost(const IR::Expression *header) const;
+    void tableApply(const IR::P4Table *table);
+
+ public:
+    ComplexityEstimate estimate;
+
+    EstimateComplexity(P4::ReferenceMap *refMap, P4::TypeMap *typeMap, size_t ternaryMasks)
+        : refMap(refMap), typeMap(typeMap), ternaryMasks(ternaryMasks) {
+        CHECK_NULL(refMap);
+        CHECK_NULL(typeMap);
+        visitDagOnce = false;
+        setName("EstimateComplexity");
+    }
+
+    bool preorder(const IR::P4Parser *parser) override;
+    bool preorder(const IR::ParserState *state) override;
+    bool preorder(const IR::SelectExpression *expression) override;
+    bool preorder(const IR::P4Control *control) override;
+    bool preorder(const IR::AssignmentStatement *statement) override;
+    bool preorder(const IR::IfStatement *statement) override;
+    bool preorder(const IR::SwitchStatement *statement) override;
+    bool preorder(const IR::MethodCallExpression *expression) override;
+    bool preorder(const IR::Operation *expression) override;
+    bool preorder(const IR::PathExpression *expression) override;
+    bool preorder(const IR::Literal *expression) override;
+
+    /// Logs the estimate of a section, and warns if it exceeds @p limit instructions.
+    /// @returns true if the estimate exceeds the limit.
+    static bool report(cstring section, const ComplexityEstimate &estimate, size_t limit);
+};
+
+}  // namespace EBPF
+
+#endif /* BACKENDS_EBPF_COMPLEXITY_H_ */
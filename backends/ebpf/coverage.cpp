@@ -0,0 +1,122 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "coverage.h"
+
+#include "ebpfModel.h"
+#include "lib/json.h"
+#include "lib/nullstream.h"
+
+namespace EBPF {
+
+const cstring CoverageCounters::mapName = EBPFModel::reserved("coverage");
+
+namespace {
+class FindCoveragePoints : public Inspector {
+    CoverageCounters *counters;
+
+    cstring qualified(cstring name) const {
+        if (auto parser = findContext<IR::P4Parser>())
+            return parser->name.name + "." + name;
+        if (auto control = findContext<IR::P4Control>())
+            return control->name.name + "." + name;
+        return name;
+    }
+
+ public:
+    explicit FindCoveragePoints(CoverageCounters *counters) : counters(counters) {}
+    bool preorder(const IR::ParserState *state) override {
+        if (!state->isBuiltin()) counters->add("state", qualified(state->name.name), state);
+        return false;
+    }
+    bool preorder(const IR::P4Table *table) override {
+        counters->add("table", qualified(table->name.name), table);
+        return false;
+    }
+    bool preorder(const IR::P4Action *action) override {
+        counters->add("action", qualified(action->name.name), action);
+        return false;
+    }
+    bool preorder(const IR::Expression *) override { return false; }
+};
+}  // namespace
+
+CoverageCounters::CoverageCounters(const IR::P4Program *program) {
+    CHECK_NULL(program);
+    FindCoveragePoints finder(this);
+    program->apply(finder);
+}
+
+void CoverageCounters::add(cstring kind, cstring name, const IR::Node *node) {
+    if (ids.count(node)) return;
+    unsigned id = points.size();
+    ids.emplace(node, id);
+    points.push_back({id, kind, name, node});
+}
+
+void CoverageCounters::emitInstance(CodeBuilder *builder) const {
+    // An array map cannot be empty.
+    unsigned size = points.empty() ? 1 : points.size();
+    builder->target->emitTableDecl(builder, mapName, TablePerCPUArray, "u32", "u64", size);
+}
+
+void CoverageCounters::emitIncrement(CodeBuilder *builder, const IR::Node *node) const {
+    auto it = ids.find(node);
+    if (it == ids.end()) return;
+    cstring key = EBPFModel::reserved("coverage_key");
+    cstring value = EBPFModel::reserved("coverage_value");
+    builder->emitIndent();
+    builder->blockStart();
+    builder->emitIndent();
+    builder->appendFormat("u32 %s = %u", key.c_str(), it->second);
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("u64 *%s = ", value.c_str());
+    builder->target->emitTableLookup(builder, mapName, key, nullptr);
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    // The counters are per CPU, so the increment needs no atomic operation.
+    builder->appendFormat("if (%s != NULL) *%s += 1", value.c_str(), value.c_str());
+    builder->endOfStatement(true);
+    builder->blockEnd(true);
+}
+
+void CoverageCounters::writeSourceMap(std::ostream &out) const {
+    auto result = new Util::JsonObject();
+    result->emplace("map", mapName);
+    auto counters = new Util::JsonArray();
+    for (const auto &point : points) {
+        auto counter = new Util::JsonObject();
+        counter->emplace("id", point.id);
+        counter->emplace("kind", point.kind);
+        counter->emplace("name", point.name);
+        counter->emplace("source", point.node->srcInfo.toPositionString());
+        counters->append(counter);
+    }
+    result->emplace("counters", counters);
+    result->serialize(out);
+    out << std::endl;
+}
+
+bool CoverageCounters::writeSourceMap(cstring fileName) const {
+    auto out = openFile(fileName, false);
+    if (out == nullptr) return false;
+    writeSourceMap(*out);
+    out->flush();
+    return true;
+}
+
+}  // namespace EBPF
@@ -0,0 +1,75 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef BACKENDS_EBPF_COVERAGE_H_
+#define BACKENDS_EBPF_COVERAGE_H_
+
+#include <map>
+#include <vector>
+
+#include "codeGen.h"
+#include "ir/ir.h"
+
+namespace EBPF {
+
+/**
+ * Path coverage counters for the generated programs, enabled with --emit-coverage.
+ *
+ * Every parser state, table and action of the program is given an id.  The
+ * generated code keeps a per-CPU u64 counter for each id in the map @ref mapName,
+ * and increments it each time the state is entered, the table is applied or the
+ * action is run; this costs one array lookup and one non-atomic increment.
+ * Reading the map from user space gives both the coverage and the hot paths of
+ * the program.  writeSourceMap() relates the ids to the P4 source.
+ *
+ * The ids only depend on the program, so all the pipelines generated from a
+ * program can share the same counters.
+ */
+class CoverageCounters {
+ public:
+    struct Point {
+        unsigned id;
+        cstring kind;  // "state", "table" or "action"
+        cstring name;
+        const IR::Node *node;
+    };
+
+ private:
+    std::vector<Point> points;
+    std::map<const IR::Node *, unsigned> ids;
+
+ public:
+    static const cstring mapName;
+
+    explicit CoverageCounters(const IR::P4Program *program);
+
+    /// Adds a counter for @p node, unless it already has one.
+    void add(cstring kind, cstring name, const IR::Node *node);
+    const std::vector<Point> &getPoints() const { return points; }
+
+    /// Declares the map holding the counters.
+    void emitInstance(CodeBuilder *builder) const;
+    /// Increments the counter of @p node; does nothing if @p node has no counter.
+    void emitIncrement(CodeBuilder *builder, const IR::Node *node) const;
+    /// Writes the id, kind, name and source position of every counter as JSON.
+    void writeSourceMap(std::ostream &out) const;
+    /// Writes the source map to @p fileName; returns false on failure.
+    bool writeSourceMap(cstring fileName) const;
+};
+
+}  // namespace EBPF
+
+#endif /* BACKENDS_EBPF_COVERAGE_H_ */
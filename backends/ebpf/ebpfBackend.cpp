@@ -28,6 +28,12 @@ limitations under the License.
 
 namespace EBPF {
 
+/// The coverage source map is written next to the C file.
+static cstring coverageFileName(cstring cfile) {
+    const char *dot = cfile.findlast('.');
+    return (dot == nullptr ? cfile : cfile.before(dot)) + ".coverage.json";
+}
+
 void emitFilterModel(const EbpfOptions &options, Target *target, const IR::ToplevelBlock *toplevel,
                      P4::ReferenceMap *refMap, P4::TypeMap *typeMap) {
     CodeBuilder c(target);
@@ -54,10 +60,13 @@ void emitFilterModel(const EbpfOptions &options, Target *target, const IR::Tople
 
     ebpfprog->emitH(&h, hfile);
     ebpfprog->emitC(&c, hfile);
-    *cstream << c.toString();
-    *hstream << h.toString();
+    c.writeTo(*cstream);
+    h.writeTo(*hstream);
     cstream->flush();
     hstream->flush();
+
+    if (ebpfprog->coverage != nullptr)
+        ebpfprog->coverage->writeSourceMap(coverageFileName(cfile));
 }
 
 void run_ebpf_backend(const EbpfOptions &options, const IR::ToplevelBlock *toplevel,
@@ -104,6 +113,9 @@ void run_ebpf_backend(const EbpfOptions &options, const IR::ToplevelBlock *tople
 
         backend->codegen(*cstream);
         cstream->flush();
+
+        auto coverage = backend->ebpf_program->ingress->coverage;
+        if (coverage != nullptr) coverage->writeSourceMap(coverageFileName(cfile));
     } else {
         ::error(ErrorType::ERR_UNKNOWN,
                 "Unknown architecture %s; legal choices are 'filter', and 'psa'", options.arch);
@@ -134,6 +134,10 @@ bool ControlBodyTranslator::preorder(const IR::MethodCallExpression *expression)
             visit(bim->appliedTo);
             builder->append(".ebpf_valid = false");
             return false;
+        } else if (bim->name == IR::Type_Stack::push_front ||
+                   bim->name == IR::Type_Stack::pop_front) {
+            emitStackShift(bim);
+            return false;
         }
     }
     auto ac = mi->to<P4::ActionCall>();
@@ -305,6 +309,8 @@ void ControlBodyTranslator::processApply(const P4::ApplyMethod *method) {
 
     msgStr = Util::printf_format("Control: applying %s", method->object->getName().name);
     builder->target->emitTraceMessage(builder, msgStr.c_str());
+    if (auto coverage = control->program->coverage)
+        coverage->emitIncrement(builder, method->object->getNode());
 
     builder->emitIndent();
 
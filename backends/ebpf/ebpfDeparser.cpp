@@ -17,8 +17,171 @@ limitations under the License.
 
 #include "ebpfDeparser.h"
 
+#include <functional>
+
 namespace EBPF {
 
+namespace {
+
+/// @returns the name of a header instance relative to the parameter holding
+/// it, e.g. "$.ethernet" for 'hdr.ethernet', so that the parser and deparser
+/// names match; empty for stack elements and other expressions.
+cstring instanceName(const IR::Expression *expression) {
+    if (expression->is<IR::PathExpression>()) return cstring("$");
+    if (auto member = expression->to<IR::Member>()) {
+        auto base = instanceName(member->expr);
+        if (base.isNullOrEmpty()) return cstring();
+        return base + "." + member->member.name;
+    }
+    return cstring();
+}
+
+}  // namespace
+
+void UnchangedHeaderFields::writesWhole(const IR::Type *type) {
+    if (type == nullptr) return;
+    if (auto ht = type->to<IR::Type_Header>()) {
+        writtenWhole.emplace(ht->name.name);
+        layoutMayChange = true;
+    } else if (auto st = type->to<IR::Type_StructLike>()) {
+        for (auto f : st->fields) writesWhole(typeMap->getTypeType(f->type, false));
+    } else if (auto stack = type->to<IR::Type_Stack>()) {
+        writesWhole(typeMap->getTypeType(stack->elementType, false));
+    }
+}
+
+void UnchangedHeaderFields::writes(const IR::Expression *expression) {
+    while (auto slice = expression->to<IR::Slice>()) expression = slice->e0;
+    if (auto member = expression->to<IR::Member>()) {
+        auto baseType = typeMap->getType(member->expr);
+        if (auto ht = baseType ? baseType->to<IR::Type_Header>() : nullptr) {
+            written[ht->name.name].emplace(member->member.name);
+            return;
+        }
+    }
+    writesWhole(typeMap->getType(expression));
+}
+
+bool UnchangedHeaderFields::preorder(const IR::AssignmentStatement *statement) {
+    writes(statement->left);
+    return true;
+}
+
+bool UnchangedHeaderFields::preorder(const IR::MethodCallExpression *expression) {
+    auto mi = P4::MethodInstance::resolve(expression, refMap, typeMap);
+    if (auto bm = mi->to<P4::BuiltInMethod>()) {
+        if (bm->name != IR::Type_Header::isValid) layoutMayChange = true;
+        return true;
+    }
+    if (auto em = mi->to<P4::ExternMethod>()) {
+        auto &packetIn = P4::P4CoreLibrary::instance().packetIn;
+        if (em->originalExternType->name.name == packetIn.name) {
+            if (em->method->name.name == packetIn.extract.name && expression->arguments->size() == 1)
+                return true;
+            if (em->method->name.name != packetIn.lookahead.name) layoutMayChange = true;
+            return true;
+        }
+    }
+    for (auto param : *mi->substitution.getParametersInArgumentOrder()) {
+        if (param->direction != IR::Direction::Out && param->direction != IR::Direction::InOut)
+            continue;
+        if (auto arg = mi->substitution.lookup(param)) writes(arg->expression);
+    }
+    return true;
+}
+
+void UnchangedHeaderFields::checkLayout(const IR::P4Parser *parser,
+                                        const IR::P4Control *deparser) {
+    if (layoutMayChange) return;
+    auto &p4lib = P4::P4CoreLibrary::instance();
+
+    // The position of each header instance in the deparser.
+    std::map<cstring, int> emitIndex;
+    for (auto c : deparser->body->components) {
+        auto mcs = c->to<IR::MethodCallStatement>();
+        if (mcs == nullptr) continue;
+        auto mi = P4::MethodInstance::resolve(mcs, refMap, typeMap);
+        auto em = mi->to<P4::ExternMethod>();
+        if (em == nullptr || em->method->name.name != p4lib.packetOut.emit.name) continue;
+        auto name = instanceName(mcs->methodCall->arguments->at(0)->expression);
+        if (name.isNullOrEmpty() || emitIndex.count(name)) {
+            layoutMayChange = true;
+            return;
+        }
+        emitIndex.emplace(name, static_cast<int>(emitIndex.size()));
+    }
+
+    // Visit the states in topological order, keeping the last emit index that
+    // may have been extracted on any path reaching each state.
+    std::map<cstring, const IR::ParserState *> states;
+    for (auto state : parser->states) states.emplace(state->name.name, state);
+    auto successors = [&](const IR::ParserState *state) {
+        std::vector<const IR::ParserState *> result;
+        auto add = [&](const IR::Expression *e) {
+            if (auto path = e->to<IR::PathExpression>()) {
+                auto it = states.find(path->path->name.name);
+                if (it != states.end()) result.push_back(it->second);
+            }
+        };
+        if (state->selectExpression == nullptr) return result;
+        if (auto select = state->selectExpression->to<IR::SelectExpression>()) {
+            for (auto sc : select->selectCases) add(sc->state);
+        } else {
+            add(state->selectExpression);
+        }
+        return result;
+    };
+    std::vector<const IR::ParserState *> order;
+    std::map<const IR::ParserState *, int> mark;  // 1: on stack, 2: done
+    std::function<bool(const IR::ParserState *)> sort = [&](const IR::ParserState *state) {
+        auto &m = mark[state];
+        if (m == 1) return false;
+        if (m == 2) return true;
+        m = 1;
+        for (auto next : successors(state))
+            if (!sort(next)) return false;
+        mark[state] = 2;
+        order.push_back(state);
+        return true;
+    };
+    auto start = states.find(IR::ParserState::start);
+    if (start == states.end() || !sort(start->second)) {
+        layoutMayChange = true;
+        return;
+    }
+
+    std::map<const IR::ParserState *, int> lastBefore;
+    lastBefore[start->second] = -1;
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        auto state = *it;
+        int last = lastBefore[state];
+        for (auto c : state->components) {
+            auto mcs = c->to<IR::MethodCallStatement>();
+            if (mcs == nullptr) continue;
+            auto mi = P4::MethodInstance::resolve(mcs, refMap, typeMap);
+            auto em = mi->to<P4::ExternMethod>();
+            if (em == nullptr || em->method->name.name != p4lib.packetIn.extract.name) continue;
+            auto name = instanceName(mcs->methodCall->arguments->at(0)->expression);
+            auto index = emitIndex.find(name);
+            if (name.isNullOrEmpty() || index == emitIndex.end() || index->second <= last) {
+                layoutMayChange = true;
+                return;
+            }
+            last = index->second;
+        }
+        for (auto next : successors(state)) {
+            auto prev = lastBefore.find(next);
+            if (prev == lastBefore.end() || prev->second < last) lastBefore[next] = last;
+        }
+    }
+}
+
+bool UnchangedHeaderFields::isUnchanged(const IR::Type_Header *type, cstring field) const {
+    if (layoutMayChange || writtenWhole.count(type->name.name)) return false;
+    auto it = written.find(type->name.name);
+    return it == written.end() || !it->second.count(field);
+}
+
 DeparserBodyTranslator::DeparserBodyTranslator(const EBPFDeparser *deparser)
     : CodeGenInspector(deparser->program->refMap, deparser->program->typeMap),
       ControlBodyTranslator(deparser),
@@ -151,6 +314,8 @@ void DeparserHdrEmitTranslator::processMethod(const P4::ExternMethod *method) {
             builder->emitIndent();
             builder->newline();
             unsigned hdrOffsetBits = 0;
+            // Unchanged fields, with their offsets, to write only if the packet was resized.
+            std::vector<std::pair<const IR::StructField *, unsigned>> unchanged;
             for (auto f : headerToEmit->fields) {
                 auto ftype = deparser->program->typeMap->getType(f);
                 auto etype = EBPFTypeFactory::instance->create(ftype);
@@ -160,9 +325,23 @@ void DeparserHdrEmitTranslator::processMethod(const P4::ExternMethod *method) {
                             "Only headers with fixed widths supported %1%", f);
                     return;
                 }
-                emitField(builder, f->name, expr, hdrOffsetBits, etype);
+                if (unchangedFields && unchangedFields->isUnchanged(headerToEmit, f->name.name))
+                    unchanged.emplace_back(f, hdrOffsetBits);
+                else
+                    emitField(builder, f->name, expr, hdrOffsetBits, etype);
                 hdrOffsetBits += et->widthInBits();
             }
+            if (!unchanged.empty()) {
+                builder->emitIndent();
+                builder->appendFormat("if (%s != 0) ", deparser->outerHdrOffsetVar.c_str());
+                builder->blockStart();
+                for (auto [f, offset] : unchanged) {
+                    auto etype =
+                        EBPFTypeFactory::instance->create(deparser->program->typeMap->getType(f));
+                    emitField(builder, f->name, expr, offset, etype);
+                }
+                builder->blockEnd(true);
+            }
 
             // Increment header pointer
             builder->emitIndent();
@@ -382,7 +561,11 @@ void EBPFDeparser::emit(CodeBuilder *builder) {
     builder->newline();
 
     // emit headers
+    auto unchangedFields = new UnchangedHeaderFields(program->refMap, program->typeMap);
+    program->program->apply(*unchangedFields);
+    unchangedFields->checkLayout(program->parser->parserBlock->container, controlBlock->container);
     auto hdrEmitTranslator = new DeparserHdrEmitTranslator(this);
+    hdrEmitTranslator->unchangedFields = unchangedFields;
     hdrEmitTranslator->setBuilder(builder);
     hdrEmitTranslator->copyPointerVariables(codeGen);
     hdrEmitTranslator->substitute(this->headers, this->parserHeaders);
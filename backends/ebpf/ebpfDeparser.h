@@ -23,6 +23,39 @@ namespace EBPF {
 
 class EBPFDeparser;
 
+/// Finds the header fields that the deparser does not have to write back,
+/// because the packet still holds the bytes the parser extracted them from.
+/// That requires that
+/// - the program never writes the field outside of extract();
+/// - the program never changes the validity of a header other than by
+///   extract(), never advances the packet and extracts no varbit fields;
+/// - the parser state graph is acyclic and, on every path, extracts headers in
+///   the order the deparser emits them, and the deparser emits every header the
+///   parser can extract.
+/// Writes are tracked per header type, not per instance.
+class UnchangedHeaderFields : public Inspector {
+    const P4::ReferenceMap *refMap;
+    const P4::TypeMap *typeMap;
+    std::map<cstring, std::set<cstring>> written;
+    std::set<cstring> writtenWhole;
+    bool layoutMayChange = false;
+
+    void writes(const IR::Expression *expression);
+    void writesWhole(const IR::Type *type);
+
+ public:
+    UnchangedHeaderFields(const P4::ReferenceMap *refMap, const P4::TypeMap *typeMap)
+        : refMap(refMap), typeMap(typeMap) {
+        setName("UnchangedHeaderFields");
+    }
+    bool preorder(const IR::AssignmentStatement *statement) override;
+    bool preorder(const IR::MethodCallExpression *expression) override;
+
+    /// Checks the order of extracts in @p parser against the emits of @p deparser.
+    void checkLayout(const IR::P4Parser *parser, const IR::P4Control *deparser);
+    bool isUnchanged(const IR::Type_Header *type, cstring field) const;
+};
+
 // this translator emits deparser externs
 class DeparserBodyTranslator : public ControlBodyTranslator {
  protected:
@@ -55,6 +88,10 @@ class DeparserHdrEmitTranslator : public DeparserPrepareBufferTranslator {
  public:
     explicit DeparserHdrEmitTranslator(const EBPFDeparser *deparser);
 
+    /// If set, fields that it reports as unchanged are only written when the
+    /// packet had to be resized.
+    const UnchangedHeaderFields *unchangedFields = nullptr;
+
     void processMethod(const P4::ExternMethod *method) override;
     void emitField(CodeBuilder *builder, cstring field, const IR::Expression *hdrExpr,
                    unsigned alignment, EBPF::EBPFType *type);
@@ -91,6 +91,54 @@ EbpfOptions::EbpfOptions() {
             return true;
         },
         "[psa only] Enable caching entries for tables with lpm or ternary key");
+    registerOption(
+        "--split-egress", nullptr,
+        [this](const char *) {
+            splitEgressPipeline = true;
+            return true;
+        },
+        "[psa only] Run the egress deparser in a separate eBPF program entered with a tail "
+        "call, to keep large pipelines within the verifier limits");
+    registerOption(
+        "--auto-split-egress", nullptr,
+        [this](const char *) {
+            autoSplitEgressPipeline = true;
+            return true;
+        },
+        "[psa only] Like --split-egress, but only if the egress program is estimated to "
+        "exceed the verifier instruction limit");
+    registerOption(
+        "--verifier-insn-limit", "N",
+        [this](const char *arg) {
+            verifierInstructionLimit = std::strtoul(arg, nullptr, 0);
+            return true;
+        },
+        "[psa only] Warn about programs estimated at more than N eBPF instructions "
+        "(default: 1000000, 0 disables the estimate)");
+    registerOption(
+        "--digest-ringbuf", nullptr,
+        [this](const char *) {
+            digestRingBuffer = true;
+            return true;
+        },
+        "[psa only] Send digests through BPF ring buffers (BPF_MAP_TYPE_RINGBUF) instead of "
+        "queue maps");
+    registerOption(
+        "--emit-coverage", nullptr,
+        [this](const char *) {
+            emitCoverage = true;
+            return true;
+        },
+        "Count the executions of every parser state, table and action in a per-CPU map, "
+        "and write the mapping from counters to the P4 source next to the output file");
+    registerOption(
+        "--emit-burst", nullptr,
+        [this](const char *) {
+            emitBurst = true;
+            return true;
+        },
+        "[ubpf only] Generate entry_burst(), processing a struct ubpf_burst of packets in one "
+        "call, instead of entry()");
     registerOption(
         "--xdp", nullptr,
         [this](const char *) {
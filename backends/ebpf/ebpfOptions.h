@@ -41,6 +41,18 @@ class EbpfOptions : public CompilerOptions {
     unsigned int maxTernaryMasks = 128;
     // Enable table cache for LPM and ternary tables
     bool enableTableCache = false;
+    // Run the PSA egress deparser in a separate program, entered with a tail call
+    bool splitEgressPipeline = false;
+    // Split the egress pipeline only if its estimated size exceeds the verifier limit
+    bool autoSplitEgressPipeline = false;
+    // Instructions a program may be estimated at before a warning; 0 disables the check
+    unsigned verifierInstructionLimit = 1000000;
+    // Send digests through BPF ring buffers instead of queue maps
+    bool digestRingBuffer = false;
+    // Count the executions of parser states, tables and actions in a per-CPU map
+    bool emitCoverage = false;
+    // Generate a uBPF entry point processing a burst of packets
+    bool emitBurst = false;
 
     EbpfOptions();
 
@@ -20,6 +20,7 @@ limitations under the License.
 #include "ebpfType.h"
 #include "frontends/p4/coreLibrary.h"
 #include "frontends/p4/methodInstance.h"
+#include "midend/selectSwitch.h"
 
 namespace EBPF {
 
@@ -161,6 +162,8 @@ bool StateTranslationVisitor::preorder(const IR::ParserState *parserState) {
     cstring offsetStr = Util::printf_format("%s - (u8*)%s", state->parser->program->headerStartVar,
                                             state->parser->program->packetStartVar);
     builder->target->emitTraceMessage(builder, msgStr.c_str(), 1, offsetStr.c_str());
+    if (auto coverage = state->parser->program->coverage)
+        coverage->emitIncrement(builder, parserState);
 
     visit(parserState->components, "components");
     if (parserState->selectExpression == nullptr) {
@@ -201,6 +204,11 @@ bool StateTranslationVisitor::preorder(const IR::SelectExpression *expression) {
     emitAssignStatement(type, nullptr, selectValue, expression->select);
     builder->newline();
 
+    if (P4::AnnotateSelectSwitch::isSwitch(state->state)) {
+        emitSelectSwitch(expression);
+        return false;
+    }
+
     // Init value_sets
     for (auto e : expression->selectCases) {
         if (e->keyset->is<IR::PathExpression>()) {
@@ -222,6 +230,33 @@ bool StateTranslationVisitor::preorder(const IR::SelectExpression *expression) {
     return false;
 }
 
+void StateTranslationVisitor::emitSelectSwitch(const IR::SelectExpression *expression) {
+    builder->emitIndent();
+    builder->appendFormat("switch (%s) ", selectValue);
+    builder->blockStart();
+    bool hasDefault = false;
+    for (auto e : expression->selectCases) {
+        builder->emitIndent();
+        if (P4::AnnotateSelectSwitch::isDefault(e->keyset)) {
+            hasDefault = true;
+            builder->append("default: ");
+        } else {
+            builder->append("case ");
+            visit(P4::AnnotateSelectSwitch::exactValue(e->keyset));
+            builder->append(": ");
+        }
+        builder->append("goto ");
+        visit(e->state);
+        builder->endOfStatement(true);
+    }
+    if (!hasDefault) {
+        builder->emitIndent();
+        builder->appendFormat("default: goto %s;", IR::ParserState::reject.c_str());
+        builder->newline();
+    }
+    builder->blockEnd(true);
+}
+
 bool StateTranslationVisitor::preorder(const IR::SelectCase *selectCase) {
     unsigned width = EBPFInitializerUtils::ebpfTypeWidth(typeMap, selectCase->keyset);
     bool scalar = EBPFScalarType::generatesScalar(width);
@@ -401,6 +436,111 @@ void StateTranslationVisitor::compileExtractField(const IR::Expression *expr,
     }
 }
 
+void HeaderFieldUses::useWhole(const IR::Type *type) {
+    if (type == nullptr) return;
+    if (auto ht = type->to<IR::Type_Header>()) {
+        wholeHeaders.emplace(ht->name.name);
+    } else if (auto st = type->to<IR::Type_StructLike>()) {
+        for (auto f : st->fields) useWhole(typeMap->getTypeType(f->type, false));
+    } else if (auto stack = type->to<IR::Type_Stack>()) {
+        useWhole(typeMap->getTypeType(stack->elementType, false));
+    }
+}
+
+void HeaderFieldUses::visitIndexes(const IR::Expression *expression) {
+    while (true) {
+        if (auto member = expression->to<IR::Member>()) {
+            expression = member->expr;
+        } else if (auto array = expression->to<IR::ArrayIndex>()) {
+            visit(array->right);
+            expression = array->left;
+        } else {
+            return;
+        }
+    }
+}
+
+bool HeaderFieldUses::preorder(const IR::Expression *expression) {
+    useWhole(typeMap->getType(expression));
+    return true;
+}
+
+bool HeaderFieldUses::preorder(const IR::Member *member) {
+    auto baseType = typeMap->getType(member->expr);
+    if (auto ht = baseType ? baseType->to<IR::Type_Header>() : nullptr) {
+        // A field read, or a method such as isValid(), which reads no field.
+        if (ht->getField(member->member)) fields[ht->name.name].emplace(member->member.name);
+    } else {
+        useWhole(typeMap->getType(member));
+    }
+    visitIndexes(member->expr);
+    return false;
+}
+
+bool HeaderFieldUses::preorder(const IR::MethodCallExpression *expression) {
+    auto method = expression->method->to<IR::Member>();
+    auto baseType = method ? typeMap->getType(method->expr) : nullptr;
+    auto ext = baseType ? baseType->to<IR::Type_Extern>() : nullptr;
+    if (ext == nullptr || ext->name != P4::P4CoreLibrary::instance().packetIn.name ||
+        method->member != P4::P4CoreLibrary::instance().packetIn.extract.name)
+        return true;
+    // extract() only writes the header.
+    for (auto arg : *expression->arguments) visitIndexes(arg->expression);
+    return false;
+}
+
+bool HeaderFieldUses::isUsed(const IR::Type_Header *type, cstring field) const {
+    if (wholeHeaders.count(type->name.name)) return true;
+    auto it = fields.find(type->name.name);
+    return it != fields.end() && it->second.count(field);
+}
+
+void StateTranslationVisitor::compileExtractFieldGroup(
+    const IR::Expression *expr, const std::vector<const IR::StructField *> &fields,
+    unsigned hdrOffsetBits, unsigned loadSize) {
+    auto program = state->parser->program;
+    const char *helper = loadSize == 8    ? "load_byte"
+                         : loadSize == 16 ? "load_half"
+                         : loadSize == 32 ? "load_word"
+                                          : "load_dword";
+
+    std::string names;
+    for (auto f : fields) {
+        if (!names.empty()) names += ", ";
+        names += f->name.name.c_str();
+    }
+    cstring msgStr = Util::printf_format("Parser: extracting fields %s", names.c_str());
+    builder->target->emitTraceMessage(builder, msgStr.c_str());
+
+    builder->emitIndent();
+    builder->blockStart();
+    builder->emitIndent();
+    builder->appendFormat("u%u ebpf_chunk = %s(%s, BYTES(%u))", loadSize, helper,
+                          program->headerStartVar.c_str(), hdrOffsetBits);
+    builder->endOfStatement(true);
+
+    unsigned shift = loadSize;
+    for (auto f : fields) {
+        auto type = EBPFTypeFactory::instance->create(state->parser->typeMap->getType(f));
+        unsigned width = type->as<IHasWidth>().widthInBits();
+        shift -= width;
+        builder->emitIndent();
+        visit(expr);
+        builder->appendFormat(".%s = (", f->name.name.c_str());
+        type->emit(builder);
+        builder->append(")(");
+        if (shift != 0)
+            builder->appendFormat("(ebpf_chunk >> %u)", shift);
+        else
+            builder->append("ebpf_chunk");
+        builder->append(" & EBPF_MASK(");
+        type->emit(builder);
+        builder->appendFormat(", %u))", width);
+        builder->endOfStatement(true);
+    }
+    builder->blockEnd(true);
+}
+
 void StateTranslationVisitor::compileExtract(const IR::Expression *destination) {
     cstring msgStr;
     auto type = state->parser->typeMap->getType(destination);
@@ -469,8 +609,15 @@ void StateTranslationVisitor::compileExtract(const IR::Expression *destination)
     builder->target->emitTraceMessage(builder, msgStr.c_str());
     builder->newline();
 
+    auto header = ht->to<IR::Type_Header>();
+    if (header && skipUnusedFields() && fieldUses == nullptr) {
+        fieldUses = new HeaderFieldUses(state->parser->typeMap);
+        program->program->apply(*fieldUses);
+    }
+
     unsigned hdrOffsetBits = 0;
-    for (auto f : ht->fields) {
+    for (size_t i = 0; i < ht->fields.size(); i++) {
+        auto f = ht->fields.at(i);
         auto ftype = state->parser->typeMap->getType(f);
         auto etype = EBPFTypeFactory::instance->create(ftype);
         auto et = etype->to<IHasWidth>();
@@ -479,7 +626,35 @@ void StateTranslationVisitor::compileExtract(const IR::Expression *destination)
                     "Only headers with fixed widths supported %1%", f);
             return;
         }
-        compileExtractField(destination, f, hdrOffsetBits, etype);
+
+        // A byte-aligned run of scalar fields that starts with a field narrower
+        // than a byte and ends on a byte boundary is read with a single load,
+        // instead of one load per field.
+        if (coalesceFieldLoads() && hdrOffsetBits % 8 == 0 && et->widthInBits() % 8 != 0) {
+            std::vector<const IR::StructField *> group;
+            unsigned groupWidth = 0;
+            for (size_t j = i; j < ht->fields.size() && groupWidth < 64; j++) {
+                auto gf = ht->fields.at(j);
+                auto gtype = EBPFTypeFactory::instance->create(state->parser->typeMap->getType(gf));
+                if (!gtype->is<EBPFScalarType>()) break;
+                group.push_back(gf);
+                groupWidth += gtype->to<EBPFScalarType>()->widthInBits();
+                if (groupWidth % 8 == 0) break;
+            }
+            if (group.size() > 1 && (groupWidth == 8 || groupWidth == 16 || groupWidth == 32 ||
+                                     groupWidth == 64)) {
+                compileExtractFieldGroup(destination, group, hdrOffsetBits, groupWidth);
+                hdrOffsetBits += groupWidth;
+                i += group.size() - 1;
+                continue;
+            }
+        }
+
+        if (header && fieldUses && !fieldUses->isUsed(header, f->name.name)) {
+            LOG2("Not extracting unused field " << f->name << " of " << destination);
+        } else {
+            compileExtractField(destination, f, hdrOffsetBits, etype);
+        }
         hdrOffsetBits += et->widthInBits();
     }
     builder->newline();
@@ -586,6 +761,10 @@ bool StateTranslationVisitor::preorder(const IR::MethodCallExpression *expressio
             visit(bim->appliedTo);
             builder->append(".ebpf_valid = false");
             return false;
+        } else if (bim->name == IR::Type_Stack::push_front ||
+                   bim->name == IR::Type_Stack::pop_front) {
+            emitStackShift(bim);
+            return false;
         }
     }
 
@@ -28,6 +28,29 @@ namespace EBPF {
 class EBPFParser;
 class EBPFParserState;
 
+/// Finds the fields of each header type that a program may read.  Field
+/// reads are tracked per header type, not per instance.  A header used as a
+/// whole (emitted, copied, passed to a function or extern), other than in an
+/// extract() call, counts as reading all its fields.
+class HeaderFieldUses : public Inspector {
+    const P4::TypeMap *typeMap;
+    std::map<cstring, std::set<cstring>> fields;
+    std::set<cstring> wholeHeaders;
+
+    void useWhole(const IR::Type *type);
+    void visitIndexes(const IR::Expression *expression);
+
+ public:
+    explicit HeaderFieldUses(const P4::TypeMap *typeMap) : typeMap(typeMap) {
+        setName("HeaderFieldUses");
+    }
+    bool preorder(const IR::Expression *expression) override;
+    bool preorder(const IR::Member *member) override;
+    bool preorder(const IR::MethodCallExpression *expression) override;
+
+    bool isUsed(const IR::Type_Header *type, cstring field) const;
+};
+
 class StateTranslationVisitor : public CodeGenInspector {
  protected:
     // stores the result of evaluating the select argument
@@ -38,10 +61,25 @@ class StateTranslationVisitor : public CodeGenInspector {
 
     virtual void compileExtractField(const IR::Expression *expr, const IR::StructField *field,
                                      unsigned hdrOffsetBits, EBPFType *type);
+    /// Extracts adjacent @p fields, which start and end on byte boundaries and
+    /// together span @p loadSize bits, with a single load.
+    virtual void compileExtractFieldGroup(const IR::Expression *expr,
+                                          const std::vector<const IR::StructField *> &fields,
+                                          unsigned hdrOffsetBits, unsigned loadSize);
+    /// If true, compileExtract reads runs of fields narrower than a byte (e.g.
+    /// IPv4 version and ihl) with compileExtractFieldGroup.
+    virtual bool coalesceFieldLoads() const { return true; }
+    /// If true, compileExtract does not copy fields that the program never reads
+    /// into the header structure.  The fields' contents are then unspecified.
+    virtual bool skipUnusedFields() const { return true; }
+    /// Computed on first use by compileExtract.
+    HeaderFieldUses *fieldUses = nullptr;
     virtual void compileExtract(const IR::Expression *destination);
     virtual void compileLookahead(const IR::Expression *destination);
     void compileAdvance(const P4::ExternMethod *ext);
     void compileVerify(const IR::MethodCallExpression *expression);
+    /// Emits a select annotated by AnnotateSelectSwitch as a switch statement.
+    void emitSelectSwitch(const IR::SelectExpression *expression);
 
     virtual void processFunction(const P4::ExternFunction *function);
     virtual void processMethod(const P4::ExternMethod *method);
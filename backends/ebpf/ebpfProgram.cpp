@@ -54,6 +54,8 @@ bool EBPFProgram::build() {
         model.arch = ModelArchitecture::EbpfFilter;
     }
 
+    if (options.emitCoverage) coverage = new CoverageCounters(program);
+
     auto prsName = (model.arch == ModelArchitecture::XdpSwitch) ? model.xdp.parser.name
                                                                 : model.filter.parser.name;
     auto ctlName = (model.arch == ModelArchitecture::XdpSwitch) ? model.xdp.switch_.name
@@ -100,6 +102,7 @@ void EBPFProgram::emitC(CodeBuilder *builder, cstring header) {
     builder->append("REGISTER_START()\n");
     control->emitTableInstances(builder);
     parser->emitValueSetInstances(builder);
+    if (coverage != nullptr) coverage->emitInstance(builder);
     builder->append("REGISTER_END()\n");
     builder->newline();
     builder->emitIndent();
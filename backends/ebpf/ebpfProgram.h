@@ -18,6 +18,7 @@ limitations under the License.
 #define BACKENDS_EBPF_EBPFPROGRAM_H_
 
 #include "codeGen.h"
+#include "coverage.h"
 #include "ebpfModel.h"
 #include "ebpfObject.h"
 #include "ebpfOptions.h"
@@ -52,6 +53,8 @@ class EBPFProgram : public EBPFObject {
     EBPFModel &model;
     // Deparser may be NULL if not supported (e.g. ebpfFilter package)
     EBPFDeparser *deparser;
+    // Coverage counters; NULL unless --emit-coverage is used
+    const CoverageCounters *coverage = nullptr;
 
     cstring endLabel, offsetVar, lengthVar, headerStartVar;
     cstring zeroKey, functionName, errorVar;
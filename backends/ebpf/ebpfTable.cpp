@@ -16,6 +16,8 @@ limitations under the License.
 
 #include "ebpfTable.h"
 
+#include <algorithm>
+
 #include "ebpfType.h"
 #include "frontends/p4/coreLibrary.h"
 #include "frontends/p4/methodInstance.h"
@@ -57,6 +59,22 @@ bool ActionTranslationVisitor::preorder(const IR::P4Action *act) {
 
 ////////////////////////////////////////////////////////////////
 
+const cstring EBPFTable::tuplePriorityPruningAnnotation = "tuple_priority_pruning";
+const cstring EBPFTable::packKeyAnnotation = "pack_key";
+const cstring EBPFTable::dir24_8Annotation = "dir_24_8";
+
+namespace {
+
+/// Layout of the entries of the DIR-24-8 arrays, shared with
+/// runtime/ebpf_dir_24_8.h: the top bit marks a direct entry that refers to
+/// an extension group, the low 24 bits hold the group or the value slot
+/// (0 for no value), and the bits in between keep the prefix length for the
+/// control plane.
+constexpr unsigned dir24_8Extended = 0x80000000;
+constexpr unsigned dir24_8IndexMask = 0x00ffffff;
+
+}  // namespace
+
 EBPFTable::EBPFTable(const EBPFProgram *program, const IR::TableBlock *table,
                      CodeGenInspector *codeGen)
     : EBPFTableBase(program, EBPFObject::externalName(table->container), codeGen), table(table) {
@@ -74,6 +92,40 @@ EBPFTable::EBPFTable(const EBPFProgram *program, const IR::TableBlock *table,
     actionList = table->container->getActionList();
 
     initKey();
+
+    tuplePriorityPruning =
+        table->container->getAnnotation(tuplePriorityPruningAnnotation) != nullptr;
+    if (tuplePriorityPruning && !isTernaryTable()) {
+        ::warning(ErrorType::WARN_IGNORE, "%1%: ignoring @%2% on a table without ternary keys",
+                  table->container, tuplePriorityPruningAnnotation);
+        tuplePriorityPruning = false;
+    }
+
+    packKey = table->container->getAnnotation(packKeyAnnotation) != nullptr;
+    if (packKey && isLPMTable()) {
+        ::warning(ErrorType::WARN_IGNORE,
+                  "%1%: ignoring @%2% on an LPM table, the LPM field must be the last one",
+                  table->container, packKeyAnnotation);
+        packKey = false;
+    }
+
+    dir24_8 = table->container->getAnnotation(dir24_8Annotation) != nullptr;
+    if (dir24_8) {
+        cstring reason;
+        const EBPFScalarType *scalar = nullptr;
+        if (keyTypes.size() == 1) scalar = keyTypes.begin()->second->to<EBPFScalarType>();
+        if (!program->options.arch.isNullOrEmpty() && program->options.arch != "filter")
+            reason = "is only supported by the filter model";
+        else if (!isLPMTable() || scalar == nullptr)
+            reason = "requires a table with a single LPM key";
+        else if (scalar->implementationWidthInBits() > 32)
+            reason = "requires an LPM key of at most 32 bits";
+        if (!reason.isNullOrEmpty()) {
+            ::warning(ErrorType::WARN_IGNORE, "%1%: ignoring @%2%, which %3%", table->container,
+                      dir24_8Annotation, reason);
+            dir24_8 = false;
+        }
+    }
 }
 
 EBPFTable::EBPFTable(const EBPFProgram *program, CodeGenInspector *codeGen, cstring name)
@@ -111,7 +163,7 @@ void EBPFTable::initKey() {
 void EBPFTable::validateKeys() const {
     if (keyGenerator == nullptr) return;
 
-    if (isTernaryTable()) {
+    if (isTernaryTable() && !packKey) {
         unsigned last_key_size = std::numeric_limits<unsigned>::max();
         for (auto it : keyGenerator->keyElements) {
             if (it->matchType->path->name.name == "selector") continue;
@@ -168,7 +220,7 @@ void EBPFTable::emitKeyType(CodeBuilder *builder) {
             builder->endOfStatement(true);
         }
 
-        for (auto c : keyGenerator->keyElements) {
+        for (auto c : keyLayout()) {
             auto mtdecl = program->refMap->getDeclaration(c->matchType->path, true);
             auto matchType = mtdecl->getNode()->to<IR::Declaration_ID>();
 
@@ -278,6 +330,10 @@ void EBPFTable::emitValueType(CodeBuilder *builder) {
 
         builder->emitIndent();
         builder->appendLine("__u32 tuple_id;");
+        if (tuplePriorityPruning) {
+            builder->emitIndent();
+            builder->appendLine("__u32 max_priority;");
+        }
         builder->emitIndent();
         builder->appendFormat("struct %s_mask next_tuple_mask;", keyTypeName.c_str());
         builder->newline();
@@ -347,6 +403,15 @@ void EBPFTable::emitTypes(CodeBuilder *builder) {
     validateKeys();
     emitKeyType(builder);
     emitValueType(builder);
+    if (dir24_8) {
+        // Lets the control plane know that the table must be filled with
+        // dir_24_8_update(), and the width of the key field.
+        auto scalar = keyTypes.begin()->second->to<EBPFScalarType>();
+        builder->emitIndent();
+        builder->appendFormat("#define %s_DIR_24_8 %d", instanceName.toUpper().c_str(),
+                              scalar->implementationWidthInBits());
+        builder->newline();
+    }
 }
 
 void EBPFTable::emitTernaryInstance(CodeBuilder *builder) {
@@ -436,15 +501,91 @@ void EBPFTable::emitInstance(CodeBuilder *builder) {
             }
 
             cstring name = EBPFObject::externalName(table->container);
-            builder->target->emitTableDecl(builder, name, tableKind,
-                                           cstring("struct ") + keyTypeName,
-                                           cstring("struct ") + valueTypeName, size);
+            if (dir24_8)
+                emitDir24_8Instance(builder, size);
+            else
+                builder->target->emitTableDecl(builder, name, tableKind,
+                                               cstring("struct ") + keyTypeName,
+                                               cstring("struct ") + valueTypeName, size);
         }
     }
     builder->target->emitTableDecl(builder, defaultActionMapName, TableArray,
                                    program->arrayIndexType, cstring("struct ") + valueTypeName, 1);
 }
 
+void EBPFTable::emitDir24_8Instance(CodeBuilder *builder, unsigned size) {
+    if (size > dir24_8IndexMask) {
+        ::error(ErrorType::ERR_UNSUPPORTED, "%1%: @%2% tables hold at most %3% entries",
+                table->container, dir24_8Annotation, dir24_8IndexMask);
+        return;
+    }
+    // Slot 0 of the values stands for no value, and each prefix longer
+    // than 24 bits needs at most one extension group.
+    builder->target->emitTableDecl(builder, dataMapName, TableArray, "u32",
+                                   cstring("struct ") + valueTypeName, size + 1);
+    builder->target->emitTableDecl(builder, dataMapName + "_dir24", TableArray, "u32", "u32",
+                                   1 << 24);
+    builder->target->emitTableDecl(builder, dataMapName + "_dir8", TableArray, "u32", "u32",
+                                   size << 8);
+    // The numbers of value slots and of extension groups in use.
+    builder->target->emitTableDecl(builder, dataMapName + "_dir_state", TableArray, "u32", "u32",
+                                   2);
+}
+
+void EBPFTable::emitDir24_8Lookup(CodeBuilder *builder, cstring key, cstring value) {
+    auto keyElement = keyTypes.begin()->first;
+    auto scalar = keyTypes.begin()->second->to<EBPFScalarType>();
+    unsigned width = scalar->implementationWidthInBits();
+    cstring field = key + "." + ::get(keyFieldNames, keyElement);
+    cstring address;
+    if (width <= 8)
+        address = field;
+    else if (width <= 16)
+        address = "bpf_ntohs(" + field + ")";
+    else
+        address = "bpf_ntohl(" + field + ")";
+
+    builder->blockStart();
+    builder->emitIndent();
+    builder->appendFormat("__u32 address = (__u32)%s << %d", address.c_str(), 32 - width);
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->append("__u32 index = address >> 8");
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->append("__u32 *entry = ");
+    builder->target->emitTableLookup(builder, dataMapName + "_dir24", "index", "");
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->append("__u32 slot = entry != NULL ? *entry : 0");
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("if (slot & 0x%x) ", dir24_8Extended);
+    builder->blockStart();
+    builder->emitIndent();
+    builder->appendFormat("index = ((slot & 0x%x) << 8) | (address & 0xff)", dir24_8IndexMask);
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->append("entry = ");
+    builder->target->emitTableLookup(builder, dataMapName + "_dir8", "index", "");
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->append("slot = entry != NULL ? *entry : 0");
+    builder->endOfStatement(true);
+    builder->blockEnd(true);
+    builder->emitIndent();
+    builder->appendFormat("index = slot & 0x%x", dir24_8IndexMask);
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->append("if (index != 0) ");
+    builder->blockStart();
+    builder->emitIndent();
+    builder->target->emitTableLookup(builder, dataMapName, "index", value);
+    builder->endOfStatement(true);
+    builder->blockEnd(true);
+    builder->blockEnd(true);
+}
+
 void EBPFTable::emitKey(CodeBuilder *builder, cstring keyName) {
     if (keyGenerator == nullptr) {
         return;
@@ -539,6 +680,7 @@ void EBPFTable::emitAction(CodeBuilder *builder, cstring valueName, cstring acti
 
         msgStr = Util::printf_format("Control: executing action %s", name);
         builder->target->emitTraceMessage(builder, msgStr.c_str());
+        if (program->coverage != nullptr) program->coverage->emitIncrement(builder, action);
         for (auto param : *(action->parameters)) {
             auto etype = EBPFTypeFactory::instance->create(param->type);
             unsigned width = etype->as<IHasWidth>().widthInBits();
@@ -732,6 +874,11 @@ void EBPFTable::emitInitializer(CodeBuilder *builder) {
 void EBPFTable::emitLookup(CodeBuilder *builder, cstring key, cstring value) {
     if (cacheEnabled()) emitCacheLookup(builder, key, value);
 
+    if (dir24_8) {
+        emitDir24_8Lookup(builder, key, value);
+        return;
+    }
+
     if (!isTernaryTable()) {
         builder->target->emitTableLookup(builder, dataMapName, key, value);
         builder->endOfStatement(true);
@@ -767,6 +914,17 @@ void EBPFTable::emitLookup(CodeBuilder *builder, cstring key, cstring value) {
     builder->emitIndent();
     builder->appendLine("break;");
     builder->blockEnd(true);
+    if (tuplePriorityPruning) {
+        // Masks are sorted by decreasing max_priority: no later tuple can do better.
+        builder->emitIndent();
+        builder->appendFormat("if (%s != NULL && %s->priority >= v->max_priority) ", value,
+                              value);
+        builder->blockStart();
+        builder->target->emitTraceMessage(builder, "Control: [Ternary] Pruning remaining tuples");
+        builder->emitIndent();
+        builder->appendLine("break;");
+        builder->blockEnd(true);
+    }
     builder->emitIndent();
     cstring new_key = "k";
     builder->appendFormat("struct %s %s = {};", keyTypeName, new_key);
@@ -883,6 +1041,26 @@ bool EBPFTable::isLPMTable() const {
     return isLPM;
 }
 
+std::vector<const IR::KeyElement *> EBPFTable::keyLayout() const {
+    std::vector<const IR::KeyElement *> layout;
+    if (keyGenerator == nullptr) return layout;
+    layout.assign(keyGenerator->keyElements.begin(), keyGenerator->keyElements.end());
+    if (!packKey) return layout;
+
+    // Selector fields are not part of the key struct, keep them at the end.
+    auto alignment = [this](const IR::KeyElement *key) -> unsigned {
+        auto it = keyTypes.find(key);
+        if (it == keyTypes.end()) return 0;
+        if (auto scalar = it->second->to<EBPFScalarType>()) return scalar->alignment();
+        return 1;
+    };
+    std::stable_sort(layout.begin(), layout.end(),
+                     [&](const IR::KeyElement *a, const IR::KeyElement *b) {
+                         return alignment(a) > alignment(b);
+                     });
+    return layout;
+}
+
 bool EBPFTable::isTernaryTable() const {
     if (keyGenerator != nullptr) {
         // If any key field is a ternary field we will generate a ternary table
@@ -76,10 +76,14 @@ class EBPFTable : public EBPFTableBase {
 
  public:
     bool isLPMTable() const;
+    /// @returns the key elements in the order their fields appear in the key struct.
+    std::vector<const IR::KeyElement *> keyLayout() const;
     bool isTernaryTable() const;
 
  protected:
     void emitTernaryInstance(CodeBuilder *builder);
+    void emitDir24_8Instance(CodeBuilder *builder, unsigned size);
+    void emitDir24_8Lookup(CodeBuilder *builder, cstring key, cstring value);
 
     virtual void validateKeys() const;
     virtual ActionTranslationVisitor *createActionTranslationVisitor(
@@ -98,6 +102,29 @@ class EBPFTable : public EBPFTableBase {
     // TODO: make it configurable using compiler options.
     size_t size = 1024;
     const cstring prefixFieldName = "prefixlen";
+    /// Set by the @tuple_priority_pruning annotation on a ternary table.  Each
+    /// mask then also stores the highest priority of the entries in its tuple,
+    /// masks are kept in decreasing order of it, and the lookup stops as soon
+    /// as no remaining tuple can hold a better match.  The control plane must
+    /// maintain that order and the per-mask priorities.
+    bool tuplePriorityPruning = false;
+    static const cstring tuplePriorityPruningAnnotation;
+    /// Set by the @pack_key annotation on a table without LPM keys.  Key
+    /// fields are then laid out in decreasing order of alignment instead of
+    /// declaration order, so that the key struct has no padding between
+    /// fields.  Key fields are referred to by name; the control plane sees
+    /// the layout through the BTF of the key struct.
+    bool packKey = false;
+    static const cstring packKeyAnnotation;
+    /// Set by the @dir_24_8 annotation on a filter-model table whose only key
+    /// is an LPM field of at most 32 bits.  The table is then not an LPM trie
+    /// but a DIR-24-8 array pair: the top 24 bits of the key index a direct
+    /// table, whose entries either select a value or a 256-entry group of the
+    /// extension table, indexed by the low 8 bits.  A lookup costs one or two
+    /// array accesses; the control plane expands each prefix into the array
+    /// entries it covers (see runtime/ebpf_dir_24_8.h).
+    bool dir24_8 = false;
+    static const cstring dir24_8Annotation;
 
     EBPFTable(const EBPFProgram *program, const IR::TableBlock *table, CodeGenInspector *codeGen);
     EBPFTable(const EBPFProgram *program, CodeGenInspector *codeGen, cstring name);
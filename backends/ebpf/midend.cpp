@@ -36,7 +36,9 @@ limitations under the License.
 #include "midend/eliminateNewtype.h"
 #include "midend/eliminateTuples.h"
 #include "midend/expandEmit.h"
+#include "midend/foldIsValid.h"
 #include "midend/local_copyprop.h"
+#include "midend/mergeParserStates.h"
 #include "midend/midEndLast.h"
 #include "midend/noMatch.h"
 #include "midend/parserUnroll.h"
@@ -44,6 +46,7 @@ limitations under the License.
 #include "midend/removeLeftSlices.h"
 #include "midend/removeMiss.h"
 #include "midend/removeSelectBooleans.h"
+#include "midend/selectSwitch.h"
 #include "midend/simplifyKey.h"
 #include "midend/simplifySelectCases.h"
 #include "midend/simplifySelectList.h"
@@ -100,12 +103,15 @@ const IR::ToplevelBlock *MidEnd::run(EbpfOptions &options, const IR::P4Program *
              new P4::MoveDeclarations(),  // more may have been introduced
              new P4::RemoveSelectBooleans(&refMap, &typeMap),
              new P4::SingleArgumentSelect(&refMap, &typeMap),
+             new P4::FoldIsValid(&refMap, &typeMap),
              new P4::ConstantFolding(&refMap, &typeMap),
              new P4::SimplifyControlFlow(&refMap, &typeMap),
              new P4::TableHit(&refMap, &typeMap),
              new P4::RemoveLeftSlices(&refMap, &typeMap),
              new EBPF::Lower(&refMap, &typeMap),
              new P4::ParsersUnroll(true, &refMap, &typeMap),
+             new P4::MergeParserStates(&refMap),
+             new P4::AnnotateSelectSwitch(),
              evaluator,
              new P4::MidEndLast()});
 
@@ -95,6 +95,8 @@ int main(int argc, char *const argv[]) {
     AutoCompileContext autoEbpfContext(new EbpfContext);
     auto &options = EbpfContext::get().options();
     options.compilerVersion = P4C_EBPF_VERSION_STRING;
+    // Runs P4::FrontEnd without a policy, and shares its IR cache entries.
+    options.irCacheScope = "P4::FrontEnd";
 
     if (options.process(argc, argv) != nullptr) {
         if (options.loadIRFromJson == false) options.setInputFile();
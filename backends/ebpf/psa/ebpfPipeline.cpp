@@ -456,6 +456,136 @@ void EBPFEgressPipeline::emit(CodeBuilder *builder) {
     msgStr = Util::printf_format("%s control: packet processing finished", sectionName);
     builder->target->emitTraceMessage(builder, msgStr.c_str());
 
+    if (isSplit()) {
+        cstring state = refMap->newName("split_state");
+        builder->emitIndent();
+        builder->appendFormat("struct %s *%s = ", splitStateTypeName.c_str(), state.c_str());
+        builder->target->emitTableLookup(builder, splitStateMapName, zeroKey, "");
+        builder->endOfStatement(true);
+        builder->emitIndent();
+        builder->appendFormat("if (!%s) return %s;", state.c_str(), dropReturnCode().c_str());
+        builder->newline();
+        builder->emitIndent();
+        builder->appendFormat("%s->istd = %s", state.c_str(),
+                              control->inputStandardMetadata->name.name);
+        builder->endOfStatement(true);
+        builder->emitIndent();
+        builder->appendFormat("%s->ostd = %s", state.c_str(),
+                              control->outputStandardMetadata->name.name);
+        builder->endOfStatement(true);
+        builder->emitIndent();
+        builder->appendFormat("%s->error = %s", state.c_str(), errorVar.c_str());
+        builder->endOfStatement(true);
+        builder->emitIndent();
+        builder->appendFormat("%s->hdr_offset = %s - (u8*)%s", state.c_str(),
+                              headerStartVar.c_str(), packetStartVar.c_str());
+        builder->endOfStatement(true);
+        builder->emitIndent();
+        builder->appendFormat("bpf_tail_call(%s, &%s, 0)", model.CPacketName.str(),
+                              splitProgMapName.c_str());
+        builder->endOfStatement(true);
+        msgStr = Util::printf_format("%s: tail call to deparser failed, dropping packet",
+                                     sectionName);
+        builder->target->emitTraceMessage(builder, msgStr.c_str());
+        builder->emitIndent();
+        builder->appendFormat("return %s;", dropReturnCode().c_str());
+        builder->newline();
+        builder->blockEnd(true);
+
+        emitSplitDeparser(builder);
+        return;
+    }
+
+    // DEPARSER
+    builder->emitIndent();
+    builder->blockStart();
+    msgStr = Util::printf_format("%s deparser: packet deparsing started", sectionName);
+    builder->target->emitTraceMessage(builder, msgStr.c_str());
+    deparser->emit(builder);
+    msgStr = Util::printf_format("%s deparser: packet deparsing finished", sectionName);
+    builder->target->emitTraceMessage(builder, msgStr.c_str());
+    builder->blockEnd(true);
+
+    this->emitTrafficManager(builder);
+    builder->blockEnd(true);
+}
+
+void EBPFEgressPipeline::emitSplitInstances(CodeBuilder *builder) const {
+    builder->appendFormat("struct %s ", splitStateTypeName.c_str());
+    builder->blockStart();
+    builder->emitIndent();
+    builder->append("struct psa_egress_input_metadata_t istd");
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->append("struct psa_egress_output_metadata_t ostd");
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("%s error", errorEnum.c_str());
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->append("u32 hdr_offset");
+    builder->endOfStatement(true);
+    builder->blockEnd(false);
+    builder->endOfStatement(true);
+
+    builder->target->emitTableDecl(builder, splitStateMapName, TablePerCPUArray, "u32",
+                                   "struct " + splitStateTypeName, 1);
+    builder->target->emitTableDecl(builder, splitProgMapName, TableProgArray, "u32", "u32", 1);
+}
+
+void EBPFEgressPipeline::emitSplitDeparser(CodeBuilder *builder) {
+    cstring msgStr;
+
+    builder->newline();
+    progTarget->emitCodeSection(builder, sectionName + "_deparser");
+    builder->emitIndent();
+    progTarget->emitMain(builder, functionName + "_deparser", model.CPacketName.str());
+    builder->spc();
+    builder->blockStart();
+
+    emitGlobalMetadataInitializer(builder);
+    emitLocalVariables(builder);
+    emitUserMetadataInstance(builder);
+    builder->newline();
+
+    emitHeaderInstances(builder);
+    builder->newline();
+
+    emitCPUMAPLookup(builder);
+    builder->emitIndent();
+    builder->appendFormat("if (!hdrMd) return %s;", dropReturnCode().c_str());
+    builder->newline();
+    emitHeadersFromCPUMAP(builder);
+    builder->newline();
+    emitMetadataFromCPUMAP(builder);
+    builder->newline();
+
+    // Restore the state saved by the first half of the pipeline.
+    cstring state = refMap->newName("split_state");
+    builder->emitIndent();
+    builder->appendFormat("struct %s *%s = ", splitStateTypeName.c_str(), state.c_str());
+    builder->target->emitTableLookup(builder, splitStateMapName, zeroKey, "");
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("if (!%s) return %s;", state.c_str(), dropReturnCode().c_str());
+    builder->newline();
+    builder->emitIndent();
+    builder->appendFormat("struct psa_egress_input_metadata_t %s = %s->istd",
+                          control->inputStandardMetadata->name.name, state.c_str());
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("struct psa_egress_output_metadata_t %s = %s->ostd",
+                          control->outputStandardMetadata->name.name, state.c_str());
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("%s = %s->error", errorVar.c_str(), state.c_str());
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("%s = (u8*)%s + %s->hdr_offset", headerStartVar.c_str(),
+                          packetStartVar.c_str(), state.c_str());
+    builder->endOfStatement(true);
+    builder->newline();
+
     // DEPARSER
     builder->emitIndent();
     builder->blockStart();
@@ -705,6 +835,30 @@ void XDPIngressPipeline::emitTrafficManager(CodeBuilder *builder) {
         Util::printf_format("%s.egress_port", control->outputStandardMetadata->name.name);
     builder->target->emitTraceMessage(builder, "IngressTM: Sending packet out of port %u", 1,
                                       portVar);
+
+    // Pass the metadata used by the egress pipeline in the XDP metadata area, which is kept
+    // when the packet is redirected to the egress program attached to the DEVMAP. Some drivers
+    // do not support it; the egress pipeline then uses default values.
+    builder->emitIndent();
+    builder->appendFormat(
+        "if (bpf_xdp_adjust_meta(%s, -(int)sizeof(struct xdp_egress_metadata)) == 0) ",
+        contextVar.c_str());
+    builder->blockStart();
+    builder->emitIndent();
+    builder->appendFormat("struct xdp_egress_metadata *egress_md = (void *)(long)%s->data_meta",
+                          contextVar.c_str());
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("if ((void *)(egress_md + 1) <= (void *)(long)%s->data) ",
+                          contextVar.c_str());
+    builder->blockStart();
+    builder->emitIndent();
+    builder->appendFormat("egress_md->class_of_service = %s.class_of_service",
+                          control->outputStandardMetadata->name.name);
+    builder->endOfStatement(true);
+    builder->blockEnd(true);
+    builder->blockEnd(true);
+
     builder->emitIndent();
     builder->appendFormat("return bpf_redirect_map(&tx_port, %s.egress_port%s, 0);",
                           control->outputStandardMetadata->name.name, "%DEVMAP_SIZE");
@@ -722,6 +876,23 @@ void XDPEgressPipeline::emitGlobalMetadataInitializer(CodeBuilder *builder) {
     builder->emitIndent();
     builder->appendFormat("%s->packet_path = NORMAL_UNICAST", compilerGlobalMetadata);
     builder->endOfStatement(true);
+
+    // metadata passed by the XDP ingress, if the driver supports the XDP metadata area
+    builder->emitIndent();
+    builder->appendFormat("u8 %s = 0", priorityVar.c_str());
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("struct xdp_egress_metadata *egress_md = (void *)(long)%s->data_meta",
+                          contextVar.c_str());
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("if ((void *)(egress_md + 1) <= (void *)(long)%s->data) ",
+                          contextVar.c_str());
+    builder->blockStart();
+    builder->emitIndent();
+    builder->appendFormat("%s = egress_md->class_of_service", priorityVar.c_str());
+    builder->endOfStatement(true);
+    builder->blockEnd(true);
 }
 
 void XDPEgressPipeline::emitTrafficManager(CodeBuilder *builder) {
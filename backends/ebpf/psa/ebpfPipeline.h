@@ -188,11 +188,29 @@ class EBPFIngressPipeline : public EBPFPipeline {
  * It includes common definitions for TC and XDP.
  */
 class EBPFEgressPipeline : public EBPFPipeline {
+    /* Emits the program that runs the deparser of a split pipeline. */
+    void emitSplitDeparser(CodeBuilder *builder);
+
  public:
+    /* With --split-egress the deparser runs in a second program, entered with a tail call
+     * once the control has finished, so that each program is verified separately.  The
+     * headers and user metadata already live in the per-CPU hdr_md map; the rest of the
+     * state the deparser needs goes through the per-CPU map 'splitStateMapName'.  The
+     * loader must store the deparser program at index 0 of 'splitProgMapName'; if the
+     * tail call fails the packet is dropped. */
+    const cstring splitStateTypeName = "egress_deparser_state";
+    const cstring splitStateMapName = "egress_deparser_state";
+    const cstring splitProgMapName = "egress_deparser_prog";
+
+    /* Set from --split-egress, or by --auto-split-egress for large pipelines. */
+    bool split;
+
     EBPFEgressPipeline(cstring name, const EbpfOptions &options, P4::ReferenceMap *refMap,
                        P4::TypeMap *typeMap)
-        : EBPFPipeline(name, options, refMap, typeMap) {}
+        : EBPFPipeline(name, options, refMap, typeMap), split(options.splitEgressPipeline) {}
 
+    bool isSplit() const { return split; }
+    void emitSplitInstances(CodeBuilder *builder) const;
     void emit(CodeBuilder *builder) override;
     void emitPSAControlInputMetadata(CodeBuilder *builder) override;
     void emitPSAControlOutputMetadata(CodeBuilder *builder) override;
@@ -256,10 +274,11 @@ class XDPEgressPipeline : public EBPFEgressPipeline {
         : EBPFEgressPipeline(name, options, refMap, typeMap) {
         sectionName = "xdp_devmap/" + name;
         ifindexVar = cstring("skb->egress_ifindex");
-        // we do not support packet path, instance & priority in the XDP egress.
+        // we do not support packet path & instance in the XDP egress. The class of service
+        // is passed by the XDP ingress in the XDP metadata area.
         packetPathVar = cstring("0");
         pktInstanceVar = cstring("0");
-        priorityVar = cstring("0");
+        priorityVar = cstring("xdp_class_of_service");
         progTarget = new XdpTarget(options.emitTraceMessages);
     }
 
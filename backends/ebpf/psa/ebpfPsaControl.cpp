@@ -19,6 +19,22 @@ limitations under the License.
 
 namespace EBPF {
 
+namespace {
+
+/// True if @p expression may refer to the variable written by assigning to @p lvalue.
+bool mentions(const IR::Expression *expression, const IR::Expression *lvalue) {
+    while (auto member = lvalue->to<IR::Member>()) lvalue = member->expr;
+    auto root = lvalue->to<IR::PathExpression>();
+    if (root == nullptr) return true;
+    bool found = false;
+    forAllMatching<IR::PathExpression>(expression, [&](const IR::PathExpression *path) {
+        if (path->path->name == root->path->name) found = true;
+    });
+    return found;
+}
+
+}  // namespace
+
 ControlBodyTranslatorPSA::ControlBodyTranslatorPSA(const EBPFControlPSA *control)
     : CodeGenInspector(control->program->refMap, control->program->typeMap),
       ControlBodyTranslator(control) {}
@@ -56,6 +72,74 @@ bool ControlBodyTranslatorPSA::preorder(const IR::AssignmentStatement *a) {
     return CodeGenInspector::preorder(a);
 }
 
+bool ControlBodyTranslatorPSA::preorder(const IR::BlockStatement *s) {
+    builder->blockStart();
+    bool first = true;
+    for (auto it = s->components.begin(); it != s->components.end(); ++it) {
+        if (!first) {
+            builder->newline();
+            builder->emitIndent();
+        }
+        first = false;
+        auto next = std::next(it);
+        if (next != s->components.end() && emitRegisterReadModifyWrite(*it, *next)) {
+            it = next;
+            continue;
+        }
+        visit(*it);
+    }
+    if (!s->components.empty()) builder->newline();
+    builder->blockEnd(false);
+    return false;
+}
+
+bool ControlBodyTranslatorPSA::emitRegisterReadModifyWrite(const IR::StatOrDecl *first,
+                                                           const IR::StatOrDecl *second) {
+    auto assignment = first->to<IR::AssignmentStatement>();
+    auto call = second->to<IR::MethodCallStatement>();
+    if (assignment == nullptr || call == nullptr) return false;
+    auto readCall = assignment->right->to<IR::MethodCallExpression>();
+    if (readCall == nullptr) return false;
+
+    auto refMap = control->program->refMap;
+    auto typeMap = control->program->typeMap;
+    auto read = P4::MethodInstance::resolve(readCall, refMap, typeMap)->to<P4::ExternMethod>();
+    auto write =
+        P4::MethodInstance::resolve(call->methodCall, refMap, typeMap)->to<P4::ExternMethod>();
+    if (read == nullptr || write == nullptr || read->object != write->object ||
+        read->originalExternType->name.name != "Register" ||
+        read->method->type->name != "read" || write->method->type->name != "write")
+        return false;
+
+    // The write must store the value read plus or minus an expression, at
+    // the same index, and neither may depend on the value read.
+    auto left = assignment->left;
+    auto index = readCall->arguments->at(0)->expression;
+    auto written = call->methodCall->arguments->at(1)->expression;
+    if (!index->equiv(*call->methodCall->arguments->at(0)->expression) || mentions(index, left))
+        return false;
+    const IR::Expression *increment = nullptr;
+    bool negate = false;
+    if (auto add = written->to<IR::Add>()) {
+        if (add->left->equiv(*left))
+            increment = add->right;
+        else if (add->right->equiv(*left))
+            increment = add->left;
+    } else if (auto sub = written->to<IR::Sub>()) {
+        if (sub->left->equiv(*left)) {
+            increment = sub->right;
+            negate = true;
+        }
+    }
+    if (increment == nullptr || mentions(increment, left)) return false;
+
+    cstring name = EBPFObject::externalName(read->object);
+    auto reg = control->to<EBPFControlPSA>()->getRegister(name);
+    if (!reg->supportsAtomicAdd(typeMap->getType(left, true))) return false;
+    reg->emitRegisterAtomicAdd(builder, read, this, left, increment, negate);
+    return true;
+}
+
 void ControlBodyTranslatorPSA::processMethod(const P4::ExternMethod *method) {
     auto decl = method->object;
     auto declType = method->originalExternType;
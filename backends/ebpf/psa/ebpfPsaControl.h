@@ -32,10 +32,17 @@ class ControlBodyTranslatorPSA : public ControlBodyTranslator {
     explicit ControlBodyTranslatorPSA(const EBPFControlPSA *control);
 
     bool preorder(const IR::AssignmentStatement *a) override;
+    bool preorder(const IR::BlockStatement *s) override;
 
     void processMethod(const P4::ExternMethod *method) override;
 
     virtual cstring getParamName(const IR::PathExpression *);
+
+ private:
+    /// Emits @p first and @p second as a single atomic update if they are a
+    /// read-modify-write `l = r.read(i); r.write(i, l + e)` (or `l - e`) of a
+    /// Register r, and @returns true if it did.
+    bool emitRegisterReadModifyWrite(const IR::StatOrDecl *first, const IR::StatOrDecl *second);
 };
 
 class ActionTranslationVisitorPSA : public ActionTranslationVisitor,
@@ -16,6 +16,7 @@ limitations under the License.
 */
 #include "ebpfPsaGen.h"
 
+#include "backends/ebpf/complexity.h"
 #include "ebpfPsaControl.h"
 #include "ebpfPsaDeparser.h"
 #include "ebpfPsaParser.h"
@@ -178,6 +179,10 @@ void PSAEbpfGenerator::emitPipelineInstances(CodeBuilder *builder) const {
 
     builder->target->emitTableDecl(builder, "hdr_md_cpumap", TablePerCPUArray, "u32",
                                    "struct hdr_md", 2);
+    if (options.enableTableCache) EBPFTablePSA::emitCacheGenerationInstance(builder);
+    if (ingress->coverage != nullptr) ingress->coverage->emitInstance(builder);
+    if (auto split = egress->to<EBPFEgressPipeline>())
+        if (split->isSplit()) split->emitSplitInstances(builder);
 }
 
 void PSAEbpfGenerator::emitInitializer(CodeBuilder *builder) const {
@@ -325,6 +330,9 @@ void PSAEbpfGenerator::emitCRC32LookupTableTypes(CodeBuilder *builder) const {
     builder->emitIndent();
     builder->append("u32 table[2048]");
     builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->append("u16 crc16_table[256]");
+    builder->endOfStatement(true);
     builder->blockEnd(false);
     builder->endOfStatement(true);
 }
@@ -365,6 +373,19 @@ void PSAEbpfGenerator::emitCRC32LookupTableInitializer(CodeBuilder *builder) con
     builder->emitIndent();
     builder->appendFormat("%s->table[i] = crc", valueName.c_str());
     builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("u16 crc16 = i");
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("for (u16 j = 0; j < 8; j++)");
+    builder->blockStart();
+    builder->emitIndent();
+    builder->appendFormat("crc16 = (crc16 >> 1) ^ ((crc16 & 1) * 40961)");
+    builder->endOfStatement(true);
+    builder->blockEnd(true);
+    builder->emitIndent();
+    builder->appendFormat("%s->crc16_table[i] = crc16", valueName.c_str());
+    builder->endOfStatement(true);
     builder->blockEnd(true);
     builder->emitIndent();
     builder->appendFormat("for (u16 i = 0; i <= 255; i++)");
@@ -591,6 +612,11 @@ void PSAArchXDP::emitXDP2TCInternalStructures(CodeBuilder *builder) const {
         "} __attribute__((aligned(4)));",
         tcIngressForXDP->parser->headerType->to<EBPFStructType>()->name);
     builder->newline();
+    // The size of the XDP metadata area must be a multiple of 4 bytes.
+    builder->appendLine(
+        "struct xdp_egress_metadata {\n"
+        "    __u8 class_of_service;\n"
+        "} __attribute__((aligned(4)));");
 }
 
 void PSAArchXDP::emitDummyProgram(CodeBuilder *builder) const {
@@ -719,6 +745,16 @@ const IR::Node *ConvertToEbpfPSA::preorder(IR::ToplevelBlock *tlb) {
     ebpf_psa_arch = build(tlb);
     ebpf_psa_arch->ingress->program = tlb->getProgram();
     ebpf_psa_arch->egress->program = tlb->getProgram();
+    if (options.emitCoverage) {
+        // All the pipelines share the counters.
+        auto coverage = new CoverageCounters(tlb->getProgram());
+        ebpf_psa_arch->ingress->coverage = coverage;
+        ebpf_psa_arch->egress->coverage = coverage;
+        if (auto xdp = dynamic_cast<const PSAArchXDP *>(ebpf_psa_arch)) {
+            xdp->tcIngressForXDP->coverage = coverage;
+            xdp->tcEgressForXDP->coverage = coverage;
+        }
+    }
     return tlb;
 }
 
@@ -757,9 +793,46 @@ bool ConvertToEbpfPipeline::preorder(const IR::PackageBlock *block) {
     pipeline->deparser = deparser_converter->getEBPFDeparser();
     CHECK_NULL(pipeline->deparser);
 
+    estimateComplexity();
     return true;
 }
 
+void ConvertToEbpfPipeline::estimateComplexity() {
+    if (options.verifierInstructionLimit == 0) return;
+    auto estimate = [this](const IR::Node *container) {
+        EstimateComplexity estimator(refmap, typemap, options.maxTernaryMasks);
+        container->apply(estimator);
+        return estimator.estimate;
+    };
+    auto parserCost = estimate(parserBlock->container);
+    auto controlCost = estimate(controlBlock->container);
+    auto deparserCost = estimate(deparserBlock->container);
+    size_t limit = options.verifierInstructionLimit;
+    EstimateComplexity::report(name + " parser", parserCost, 0);
+    EstimateComplexity::report(name + " control", controlCost, 0);
+    EstimateComplexity::report(name + " deparser", deparserCost, 0);
+
+    auto program = parserCost;
+    program += controlCost;
+    auto egress = pipeline->to<EBPFEgressPipeline>();
+    if (egress && !egress->isSplit() && options.autoSplitEgressPipeline) {
+        auto whole = program;
+        whole += deparserCost;
+        if (whole.instructions > limit) {
+            LOG1(name << ": splitting the egress pipeline, estimated at " << whole.instructions
+                      << " instructions");
+            egress->split = true;
+        }
+    }
+    if (egress && egress->isSplit()) {
+        EstimateComplexity::report(name, program, limit);
+        EstimateComplexity::report(name + "_deparser", deparserCost, limit);
+    } else {
+        program += deparserCost;
+        EstimateComplexity::report(name, program, limit);
+    }
+}
+
 // =====================EBPFParser=============================
 bool ConvertToEBPFParserPSA::preorder(const IR::ParserBlock *prsr) {
     auto pl = prsr->container->type->applyParams;
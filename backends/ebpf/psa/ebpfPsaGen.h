@@ -144,6 +144,10 @@ class ConvertToEbpfPipeline : public Inspector {
     P4::ReferenceMap *refmap;
     EBPFPipeline *pipeline;
 
+    /// Reports the estimated size of the pipeline programs, and splits large egress
+    /// pipelines with --auto-split-egress.
+    void estimateComplexity();
+
  public:
     ConvertToEbpfPipeline(cstring name, pipeline_type type, const EbpfOptions &options,
                           const IR::ParserBlock *parserBlock, const IR::ControlBlock *controlBlock,
@@ -716,7 +716,7 @@ void EBPFTablePSA::emitTernaryConstEntriesInitializer(CodeBuilder *builder) {
     cstring valueMask = program->refMap->newName("value_mask");
     cstring nextMask = keyMasksNames[0];
     int noTupleId = -1;
-    emitValueMask(builder, valueMask, nextMask, noTupleId);
+    emitValueMask(builder, valueMask, nextMask, noTupleId, 0);
     builder->newline();
 
     builder->emitIndent();
@@ -740,7 +740,8 @@ void EBPFTablePSA::emitTernaryConstEntriesInitializer(CodeBuilder *builder) {
         } else {
             nextMask = nullptr;
         }
-        emitValueMask(builder, valueMask, nextMask, tuple_id);
+        emitValueMask(builder, valueMask, nextMask, tuple_id,
+                      sameMaskEntries.front().priority);
         builder->newline();
         emitKeysAndValues(builder, sameMaskEntries, keyNames, valueNames);
 
@@ -817,8 +818,11 @@ void EBPFTablePSA::emitKeyMasks(CodeBuilder *builder, EntriesGroupedByMask_t &en
         builder->appendFormat("char *%s = &%s.mask", keyFieldNamePtr, keyFieldName);
         builder->endOfStatement(true);
 
-        for (size_t i = 0; i < keyGenerator->keyElements.size(); i++) {
-            auto keyElement = keyGenerator->keyElements[i];
+        // The mask is filled field by field in the order of the key struct.
+        for (auto keyElement : keyLayout()) {
+            size_t i = std::find(keyGenerator->keyElements.begin(),
+                                 keyGenerator->keyElements.end(), keyElement) -
+                       keyGenerator->keyElements.begin();
             auto expr = firstEntry->keys->components[i];
             cstring fieldName = program->refMap->newName("field");
             auto ebpfType = get(keyTypes, keyElement);
@@ -840,11 +844,18 @@ void EBPFTablePSA::emitKeyMasks(CodeBuilder *builder, EntriesGroupedByMask_t &en
 }
 
 void EBPFTablePSA::emitValueMask(CodeBuilder *builder, const cstring valueMask,
-                                 const cstring nextMask, int tupleId) const {
+                                 const cstring nextMask, int tupleId,
+                                 unsigned maxPriority) const {
     builder->emitIndent();
     builder->appendFormat("struct %s_mask %s = {0}", valueTypeName, valueMask);
     builder->endOfStatement(true);
 
+    if (tuplePriorityPruning) {
+        builder->emitIndent();
+        builder->appendFormat("%s.max_priority = %u", valueMask, maxPriority);
+        builder->endOfStatement(true);
+    }
+
     builder->emitIndent();
     builder->appendFormat("%s.tuple_id = %s", valueMask, cstring::to_cstring(tupleId));
     builder->endOfStatement(true);
@@ -892,6 +903,15 @@ EBPFTablePSA::EntriesGroupedByMask_t EBPFTablePSA::getConstEntriesGroupedByMask(
     for (auto &vec : entriesGroupedByMask) {
         result.emplace_back(std::move(vec.second));
     }
+    // With tuple pruning the lookup stops at the first tuple that cannot beat the best match
+    // so far, which requires the masks in decreasing order of their highest priority. Entries
+    // within a group keep program order, so the first one has the highest priority.
+    if (tuplePriorityPruning) {
+        std::sort(result.begin(), result.end(),
+                  [](const EntriesGroup_t &a, const EntriesGroup_t &b) {
+                      return a.front().priority > b.front().priority;
+                  });
+    }
     return result;
 }
 
@@ -959,6 +979,8 @@ cstring EBPFTablePSA::addPrefixFunc(bool trace) {
     return addPrefixFunc;
 }
 
+const cstring EBPFTablePSA::cacheGenerationMapName = "table_cache_generation";
+
 void EBPFTablePSA::tryEnableTableCache() {
     if (!program->options.enableTableCache) return;
     if (!isLPMTable() && !isTernaryTable()) return;
@@ -983,6 +1005,27 @@ void EBPFTablePSA::createCacheTypeNames(bool isCacheKeyType, bool isCacheValueTy
     if (isCacheValueType) cacheValueTypeName = valueTypeName + "_cache";
 }
 
+void EBPFTablePSA::emitCacheGenerationInstance(CodeBuilder *builder) {
+    builder->target->emitTableDecl(builder, cacheGenerationMapName, TableArray, "u32", "u32", 1);
+}
+
+void EBPFTablePSA::emitCacheGeneration(CodeBuilder *builder) {
+    cacheGenerationVar = program->refMap->newName("cache_generation");
+    cstring ptrName = program->refMap->newName("cache_generation_ptr");
+
+    builder->emitIndent();
+    builder->appendFormat("u32 %s = 0", cacheGenerationVar.c_str());
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("u32 *");
+    builder->target->emitTableLookup(builder, cacheGenerationMapName, program->zeroKey, ptrName);
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("if (%s != NULL) %s = *%s", ptrName.c_str(), cacheGenerationVar.c_str(),
+                          ptrName.c_str());
+    builder->endOfStatement(true);
+}
+
 void EBPFTablePSA::emitCacheTypes(CodeBuilder *builder) {
     if (!tableCacheEnabled) return;
 
@@ -1000,6 +1043,9 @@ void EBPFTablePSA::emitCacheTypes(CodeBuilder *builder) {
     builder->emitIndent();
     builder->append("u8 hit");
     builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->append("u32 generation");
+    builder->endOfStatement(true);
 
     builder->blockEnd(false);
     builder->endOfStatement(true);
@@ -1020,6 +1066,7 @@ void EBPFTablePSA::emitCacheLookup(CodeBuilder *builder, cstring key, cstring va
 
     builder->appendFormat("struct %s* %s = NULL", cacheValueTypeName.c_str(), cacheVal.c_str());
     builder->endOfStatement(true);
+    emitCacheGeneration(builder);
 
     builder->target->emitTraceMessage(builder, "Control: trying table cache...");
 
@@ -1028,7 +1075,8 @@ void EBPFTablePSA::emitCacheLookup(CodeBuilder *builder, cstring key, cstring va
     builder->endOfStatement(true);
 
     builder->emitIndent();
-    builder->appendFormat("if (%s != NULL) ", cacheVal.c_str());
+    builder->appendFormat("if (%s != NULL && %s->generation == %s) ", cacheVal.c_str(),
+                          cacheVal.c_str(), cacheGenerationVar.c_str());
     builder->blockStart();
 
     builder->target->emitTraceMessage(builder,
@@ -1070,6 +1118,10 @@ void EBPFTablePSA::emitCacheUpdate(CodeBuilder *builder, cstring key, cstring va
     builder->appendFormat("%s.hit = %s", cacheUpdateVarName.c_str(),
                           program->control->hitVariable.c_str());
     builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("%s.generation = %s", cacheUpdateVarName.c_str(),
+                          cacheGenerationVar.c_str());
+    builder->endOfStatement(true);
 
     builder->emitIndent();
     builder->appendFormat("__builtin_memcpy((void *) &(%s.value), (void *) %s, sizeof(struct %s))",
@@ -52,8 +52,12 @@ class EBPFTablePSA : public EBPFTable {
     cstring cacheValueTypeName;
     cstring cacheTableName;
     cstring cacheKeyTypeName;
+    /// Variable holding the cache generation read by the last emitted cache lookup.
+    cstring cacheGenerationVar;
     void tryEnableTableCache();
     void createCacheTypeNames(bool isCacheKeyType, bool isCacheValueType);
+    /// Declares 'cacheGenerationVar' and reads the current cache generation into it.
+    void emitCacheGeneration(CodeBuilder *builder);
 
     void emitTableValue(CodeBuilder *builder, const IR::Expression *expr, cstring valueName);
     void emitDefaultActionInitializer(CodeBuilder *builder);
@@ -61,7 +65,7 @@ class EBPFTablePSA : public EBPFTable {
     void emitTernaryConstEntriesInitializer(CodeBuilder *builder);
     void emitMapUpdateTraceMsg(CodeBuilder *builder, cstring mapName, cstring returnCode) const;
     void emitValueMask(CodeBuilder *builder, cstring valueMask, cstring nextMask,
-                       int tupleId) const;
+                       int tupleId, unsigned maxPriority) const;
     void emitKeyMasks(CodeBuilder *builder, EntriesGroupedByMask_t &entriesGroupedByMask,
                       std::vector<cstring> &keyMasksNames);
     void emitKeysAndValues(CodeBuilder *builder, EntriesGroup_t &sameMaskEntries,
@@ -91,6 +95,12 @@ class EBPFTablePSA : public EBPFTable {
     bool dropOnNoMatchingEntryFound() const override;
     static cstring addPrefixFunc(bool trace);
 
+    /// Cache entries record the generation they were created in and are ignored once the
+    /// control plane increments the generation stored in this map, e.g. after it modified
+    /// any table.  This invalidates all caches at once without walking the LRU maps.
+    static const cstring cacheGenerationMapName;
+    static void emitCacheGenerationInstance(CodeBuilder *builder);
+
     virtual void emitCacheTypes(CodeBuilder *builder);
     void emitCacheInstance(CodeBuilder *builder);
     void emitCacheLookup(CodeBuilder *builder, cstring key, cstring value) override;
@@ -22,6 +22,8 @@ limitations under the License.
 
 namespace EBPF {
 
+const cstring EBPFCounterPSA::perCPUAnnotation = "per_cpu";
+
 EBPFCounterPSA::EBPFCounterPSA(const EBPFProgram *program, const IR::Declaration_Instance *di,
                                cstring name, CodeGenInspector *codeGen)
     : EBPFCounterTable(program, name, codeGen, 1, false) {
@@ -113,6 +115,15 @@ EBPFCounterPSA::EBPFCounterPSA(const EBPFProgram *program, const IR::Declaration
 
     auto typeArg = di->arguments->at(di->arguments->size() - 1)->expression->to<IR::Constant>();
     type = toCounterType(typeArg->asInt());
+
+    if (di->getAnnotation(perCPUAnnotation) != nullptr) {
+        if (isDirect)
+            ::warning(ErrorType::WARN_IGNORE,
+                      "%1%: ignoring @%2%, direct counters are stored in the table", di,
+                      perCPUAnnotation);
+        else
+            perCPU = true;
+    }
 }
 
 EBPFCounterPSA::CounterType EBPFCounterPSA::toCounterType(const int type) {
@@ -166,7 +177,11 @@ void EBPFCounterPSA::emitValueType(CodeBuilder *builder) {
 }
 
 void EBPFCounterPSA::emitInstance(CodeBuilder *builder) {
-    TableKind kind = isHash ? TableHash : TableArray;
+    TableKind kind;
+    if (isHash)
+        kind = perCPU ? TablePerCPUHash : TableHash;
+    else
+        kind = perCPU ? TablePerCPUArray : TableArray;
     builder->target->emitTableDecl(builder, dataMapName, kind, keyTypeName,
                                    "struct " + valueTypeName, size);
 }
@@ -259,8 +274,11 @@ void EBPFCounterPSA::emitCounterUpdate(CodeBuilder *builder, const cstring targe
 
     if (type == CounterType::BYTES || type == CounterType::PACKETS_AND_BYTES) {
         builder->emitIndent();
-        builder->appendFormat("__sync_fetch_and_add(&(%sbytes), %s)", targetWAccess.c_str(),
-                              program->lengthVar);
+        if (perCPU)
+            builder->appendFormat("%sbytes += %s", targetWAccess.c_str(), program->lengthVar);
+        else
+            builder->appendFormat("__sync_fetch_and_add(&(%sbytes), %s)", targetWAccess.c_str(),
+                                  program->lengthVar);
         builder->endOfStatement(true);
 
         varStr = Util::printf_format("%sbytes", targetWAccess.c_str());
@@ -268,7 +286,10 @@ void EBPFCounterPSA::emitCounterUpdate(CodeBuilder *builder, const cstring targe
     }
     if (type == CounterType::PACKETS || type == CounterType::PACKETS_AND_BYTES) {
         builder->emitIndent();
-        builder->appendFormat("__sync_fetch_and_add(&(%spackets), 1)", targetWAccess.c_str());
+        if (perCPU)
+            builder->appendFormat("%spackets += 1", targetWAccess.c_str());
+        else
+            builder->appendFormat("__sync_fetch_and_add(&(%spackets), 1)", targetWAccess.c_str());
         builder->endOfStatement(true);
 
         varStr = Util::printf_format("%spackets", targetWAccess.c_str());
@@ -28,11 +28,16 @@ class EBPFCounterPSA : public EBPFCounterTable {
     EBPFType *dataplaneWidthType;
     EBPFType *indexWidthType;
     bool isDirect;
+    /// Set by @per_cpu: every CPU updates its own copy of the counters without atomic
+    /// operations, and the control plane sums the copies when reading them.
+    bool perCPU = false;
 
  public:
     enum CounterType { PACKETS, BYTES, PACKETS_AND_BYTES };
     CounterType type;
 
+    static const cstring perCPUAnnotation;
+
     EBPFCounterPSA(const EBPFProgram *program, const IR::Declaration_Instance *di, cstring name,
                    CodeGenInspector *codeGen);
 
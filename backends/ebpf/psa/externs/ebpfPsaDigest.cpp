@@ -112,6 +112,15 @@ EBPFDigestPSA::EBPFDigestPSA(const EBPFProgram *program, const IR::Declaration_I
             valueTypeName = instanceName + "_value";
         }
     }
+
+    useRingBuffer = program->options.digestRingBuffer;
+    if (useRingBuffer) {
+        // Each record is preceded by an 8-byte header and aligned to 8 bytes.
+        unsigned bytes = (valueType->as<IHasWidth>().implementationWidthInBits() + 7) / 8;
+        unsigned recordSize = 8 + (bytes + 7) / 8 * 8;
+        ringBufferSize = 4096;
+        while (ringBufferSize < recordSize * maxDigestQueueSize) ringBufferSize *= 2;
+    }
 }
 
 void EBPFDigestPSA::emitTypes(CodeBuilder *builder) {
@@ -123,6 +132,11 @@ void EBPFDigestPSA::emitTypes(CodeBuilder *builder) {
 }
 
 void EBPFDigestPSA::emitInstance(CodeBuilder *builder) const {
+    if (useRingBuffer) {
+        builder->appendFormat("REGISTER_RINGBUF(%s, %u)", instanceName.c_str(), ringBufferSize);
+        builder->newline();
+        return;
+    }
     builder->appendFormat("REGISTER_TABLE_NO_KEY_TYPE(%s, BPF_MAP_TYPE_QUEUE, 0, ", instanceName);
 
     if (valueTypeName.isNullOrEmpty()) {
@@ -150,6 +164,10 @@ void EBPFDigestPSA::processMethod(CodeBuilder *builder, cstring method,
 
 void EBPFDigestPSA::emitPushElement(CodeBuilder *builder, const IR::Expression *elem,
                                     Inspector *codegen) const {
+    if (useRingBuffer) {
+        emitRingBufferOutput(builder, [elem, codegen]() { codegen->visit(elem); });
+        return;
+    }
     builder->emitIndent();
     builder->appendFormat("bpf_map_push_elem(&%s, &", instanceName);
     codegen->visit(elem);
@@ -158,9 +176,43 @@ void EBPFDigestPSA::emitPushElement(CodeBuilder *builder, const IR::Expression *
 }
 
 void EBPFDigestPSA::emitPushElement(CodeBuilder *builder, cstring elem) const {
+    if (useRingBuffer) {
+        emitRingBufferOutput(builder, [builder, elem]() { builder->append(elem); });
+        return;
+    }
     builder->emitIndent();
     builder->appendFormat("bpf_map_push_elem(&%s, &%s, BPF_EXIST)", instanceName, elem);
     builder->endOfStatement(true);
 }
 
+void EBPFDigestPSA::emitRingBufferOutput(CodeBuilder *builder,
+                                         std::function<void()> emitElement) const {
+    // The message is copied straight into the reserved record; if the ring buffer is
+    // full the message is dropped, as it is when the queue map is full.
+    cstring record = program->refMap->newName("digest_record");
+    builder->emitIndent();
+    builder->blockStart();
+    builder->emitIndent();
+    if (valueTypeName.isNullOrEmpty())
+        valueType->declare(builder, record, true);
+    else
+        builder->appendFormat("%s *%s", valueTypeName.c_str(), record.c_str());
+    builder->appendFormat(" = bpf_ringbuf_reserve(&%s, sizeof(*%s), 0)", instanceName.c_str(),
+                          record.c_str());
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("if (%s != NULL) ", record.c_str());
+    builder->blockStart();
+    builder->emitIndent();
+    builder->appendFormat("__builtin_memcpy(%s, &", record.c_str());
+    emitElement();
+    builder->appendFormat(", sizeof(*%s))", record.c_str());
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("bpf_ringbuf_submit(%s, 0)", record.c_str());
+    builder->endOfStatement(true);
+    builder->blockEnd(true);
+    builder->blockEnd(true);
+}
+
 }  // namespace EBPF
@@ -17,6 +17,8 @@ limitations under the License.
 #ifndef BACKENDS_EBPF_PSA_EXTERNS_EBPFPSADIGEST_H_
 #define BACKENDS_EBPF_PSA_EXTERNS_EBPFPSADIGEST_H_
 
+#include <functional>
+
 #include "backends/ebpf/ebpfObject.h"
 #include "backends/ebpf/ebpfProgram.h"
 
@@ -34,6 +36,12 @@ class EBPFDigestPSA : public EBPFObject {
     // arbitrary value for max queue size
     // TODO: make it configurable
     int maxDigestQueueSize = 128;
+    // With --digest-ringbuf digests are written to a BPF ring buffer instead of a queue,
+    // so that consumers can wait with epoll and drain many messages at once.
+    bool useRingBuffer;
+    // Size of the ring buffer in bytes: room for maxDigestQueueSize messages, rounded up
+    // to a power of 2 number of pages as required by the kernel.
+    unsigned ringBufferSize = 0;
 
  public:
     EBPFDigestPSA(const EBPFProgram *program, const IR::Declaration_Instance *di);
@@ -46,6 +54,9 @@ class EBPFDigestPSA : public EBPFObject {
     void emitPushElement(CodeBuilder *builder, const IR::Expression *elem,
                          Inspector *codegen) const;
     void emitPushElement(CodeBuilder *builder, cstring elem) const;
+    /// Emits the reservation, copy and submission of a ring buffer record;
+    /// @p emitElement emits the l-value holding the message.
+    void emitRingBufferOutput(CodeBuilder *builder, std::function<void()> emitElement) const;
 };
 
 }  // namespace EBPF
@@ -49,35 +49,57 @@ void EBPFHashAlgorithmPSA::emitAddData(CodeBuilder *builder, int dataPos,
 
 // ===========================CRCChecksumAlgorithm===========================
 
-void CRCChecksumAlgorithm::emitUpdateMethod(CodeBuilder *builder, int crcWidth) {
+const CRCChecksumAlgorithm::LookupTables CRCChecksumAlgorithm::mapLookupTables = {
+    "    struct lookup_tbl_val* lookup_table;\n"
+    "    u32 index = 0;\n"
+    "    lookup_table = BPF_MAP_LOOKUP_ELEM(crc_lookup_tbl, &index);\n",
+    "lookup_table->crc16_table", "lookup_table->table", "lookup_table != NULL"};
+
+void CRCChecksumAlgorithm::emitUpdateMethod(CodeBuilder *builder, int crcWidth,
+                                            const LookupTables &tables) {
     // Note that this update method is optimized for our CRC16 and CRC32, custom
     // version may require other method of update. When data_size <= 64 bits,
     // applies host byte order for input data, otherwise network byte order is expected.
     if (crcWidth == 16) {
-        // This function calculates CRC16 by definition, it is bit by bit. If input data has more
-        // than 64 bit, the outer loop process bytes in network byte order - data pointer is
-        // incremented. For data shorter than or equal 64 bits, bytes are processed in little endian
-        // byte order - data pointer is decremented by outer loop in this case.
-        // There is no need for lookup table.
+        // This function calculates CRC16 one byte at a time using the lookup table for the
+        // reflected 0xA001 polynomial. If the table may be unavailable, the byte is then
+        // processed by definition, bit by bit. If input data has more than 64 bit, the outer
+        // loop process bytes in network byte order - data pointer is incremented. For data
+        // shorter than or equal 64 bits, bytes are processed in little endian byte order - data
+        // pointer is decremented by outer loop in this case.
         cstring code =
             "static __always_inline\n"
             "void crc16_update(u16 * reg, const u8 * data, "
             "u16 data_size, const u16 poly) {\n"
+            "$SETUP$"
             "    if (data_size <= 8)\n"
             "        data += data_size - 1;\n"
             "    #pragma clang loop unroll(full)\n"
             "    for (u16 i = 0; i < data_size; i++) {\n"
             "        bpf_trace_message(\"CRC16: data byte: %x\\n\", *data);\n"
-            "        *reg ^= *data;\n"
-            "        for (u8 bit = 0; bit < 8; bit++) {\n"
-            "            *reg = (*reg) & 1 ? ((*reg) >> 1) ^ poly : (*reg) >> 1;\n"
-            "        }\n"
+            "$UPDATE$"
             "        if (data_size <= 8)\n"
             "            data--;\n"
             "        else\n"
             "            data++;\n"
             "    }\n"
             "}";
+        cstring update = "        *reg = ((*reg) >> 8) ^ $TABLE$[(u8)((*reg) ^ *data)];\n";
+        if (!tables.available.isNullOrEmpty()) {
+            update =
+                "        if ($AVAILABLE$) {\n"
+                "    " + update +
+                "        } else {\n"
+                "            *reg ^= *data;\n"
+                "            for (u8 bit = 0; bit < 8; bit++) {\n"
+                "                *reg = (*reg) & 1 ? ((*reg) >> 1) ^ poly : (*reg) >> 1;\n"
+                "            }\n"
+                "        }\n";
+        }
+        code = code.replace("$SETUP$", tables.setup)
+                   .replace("$UPDATE$", update)
+                   .replace("$AVAILABLE$", tables.available)
+                   .replace("$TABLE$", tables.crc16);
         builder->appendLine(code);
     } else if (crcWidth == 32) {
         // This function calculates CRC32 using two optimisations: slice-by-8 and Standard
@@ -95,9 +117,7 @@ void CRCChecksumAlgorithm::emitUpdateMethod(CodeBuilder *builder, int crcWidth)
             "static __always_inline\n"
             "void crc32_update(u32 * reg, const u8 * data, u16 data_size, const u32 poly) {\n"
             "    u32* current = (u32*) data;\n"
-            "    struct lookup_tbl_val* lookup_table;\n"
-            "    u32 index = 0;\n"
-            "    lookup_table = BPF_MAP_LOOKUP_ELEM(crc_lookup_tbl, &index);\n"
+            "$SETUP$"
             "    u32 lookup_key = 0;\n"
             "    u32 lookup_value = 0;\n"
             "    u32 lookup_value1 = 0;\n"
@@ -109,31 +129,31 @@ void CRCChecksumAlgorithm::emitUpdateMethod(CodeBuilder *builder, int crcWidth)
             "    u32 lookup_value7 = 0;\n"
             "    u32 lookup_value8 = 0;\n"
             "    u16 tmp = 0;\n"
-            "    if (lookup_table != NULL) {\n"
+            "    $CHECK$\n"
             "        for (u16 i = data_size; i >= 8; i -= 8) {\n"
             "            /* Vars one and two will have swapped byte order if data_size == 8 */\n"
-            "            if (data_size == 8) current = data + 4;\n"
+            "            if (data_size == 8) current = (u32 *)(data + 4);\n"
             "            bpf_trace_message(\"CRC32: data dword: %x\\n\", *current);\n"
             "            u32 one = (data_size == 8 ? __builtin_bswap32(*current--) : *current++) ^ "
             "*reg;\n"
             "            bpf_trace_message(\"CRC32: data dword: %x\\n\", *current);\n"
             "            u32 two = (data_size == 8 ? __builtin_bswap32(*current--) : *current++);\n"
             "            lookup_key = (one & 0x000000FF);\n"
-            "            lookup_value8 = lookup_table->table[(u16)(1792 + (u8)lookup_key)];\n"
+            "            lookup_value8 = $TABLE$[(u16)(1792 + (u8)lookup_key)];\n"
             "            lookup_key = (one >> 8) & 0x000000FF;\n"
-            "            lookup_value7 = lookup_table->table[(u16)(1536 + (u8)lookup_key)];\n"
+            "            lookup_value7 = $TABLE$[(u16)(1536 + (u8)lookup_key)];\n"
             "            lookup_key = (one >> 16) & 0x000000FF;\n"
-            "            lookup_value6 = lookup_table->table[(u16)(1280 + (u8)lookup_key)];\n"
+            "            lookup_value6 = $TABLE$[(u16)(1280 + (u8)lookup_key)];\n"
             "            lookup_key = one >> 24;\n"
-            "            lookup_value5 = lookup_table->table[(u16)(1024 + (u8)(lookup_key))];\n"
+            "            lookup_value5 = $TABLE$[(u16)(1024 + (u8)(lookup_key))];\n"
             "            lookup_key = (two & 0x000000FF);\n"
-            "            lookup_value4 = lookup_table->table[(u16)(768 + (u8)lookup_key)];\n"
+            "            lookup_value4 = $TABLE$[(u16)(768 + (u8)lookup_key)];\n"
             "            lookup_key = (two >> 8) & 0x000000FF;\n"
-            "            lookup_value3 = lookup_table->table[(u16)(512 + (u8)lookup_key)];\n"
+            "            lookup_value3 = $TABLE$[(u16)(512 + (u8)lookup_key)];\n"
             "            lookup_key = (two >> 16) & 0x000000FF;\n"
-            "            lookup_value2 = lookup_table->table[(u16)(256 + (u8)lookup_key)];\n"
+            "            lookup_value2 = $TABLE$[(u16)(256 + (u8)lookup_key)];\n"
             "            lookup_key = two >> 24;\n"
-            "            lookup_value1 = lookup_table->table[(u8)(lookup_key)];\n"
+            "            lookup_value1 = $TABLE$[(u8)(lookup_key)];\n"
             "            *reg = lookup_value8 ^ lookup_value7 ^ lookup_value6 ^ lookup_value5 ^\n"
             "                   lookup_value4 ^ lookup_value3 ^ lookup_value2 ^ lookup_value1;\n"
             "            tmp += 8;\n"
@@ -148,7 +168,7 @@ void CRCChecksumAlgorithm::emitUpdateMethod(CodeBuilder *builder, int crcWidth)
             "                std_algo_lookup_key = (u32)(((*reg) & 0xFF) ^ *currentChar--);\n"
             "                if (std_algo_lookup_key >= 0) {\n"
             "                    lookup_value = "
-            "lookup_table->table[(u8)(std_algo_lookup_key & 255)];\n"
+            "$TABLE$[(u8)(std_algo_lookup_key & 255)];\n"
             "                }\n"
             "                *reg = ((*reg) >> 8) ^ lookup_value;\n"
             "            }\n"
@@ -162,13 +182,19 @@ void CRCChecksumAlgorithm::emitUpdateMethod(CodeBuilder *builder, int crcWidth)
             "                std_algo_lookup_key = (u32)(((*reg) & 0xFF) ^ *currentChar++);\n"
             "                if (std_algo_lookup_key >= 0) {\n"
             "                    lookup_value = "
-            "lookup_table->table[(u8)(std_algo_lookup_key & 255)];\n"
+            "$TABLE$[(u8)(std_algo_lookup_key & 255)];\n"
             "                }\n"
             "                *reg = ((*reg) >> 8) ^ lookup_value;\n"
             "            }\n"
             "        }\n"
             "    }\n"
             "}";
+        // A plain block keeps the layout when the tables are always available.
+        cstring check = "{";
+        if (!tables.available.isNullOrEmpty()) check = "if (" + tables.available + ") {";
+        code = code.replace("$SETUP$", tables.setup)
+                   .replace("$CHECK$", check)
+                   .replace("$TABLE$", tables.crc32);
         builder->appendLine(code);
     }
 }
@@ -393,6 +419,37 @@ void InternetChecksumAlgorithm::updateChecksum(CodeBuilder *builder, const Argum
                 continue;
             }
 
+            if (width % 32 == 0) {
+                // Sum the whole field at once with bpf_csum_diff(), which works on 32-bit words
+                // in network byte order. The folded sum is converted to host byte order, because
+                // one's complement sum does not depend on byte order up to a byte swap.
+                cstring sumVar = program->refMap->newName(baseName + "_sum");
+                builder->emitIndent();
+                builder->appendFormat("u32 %s = (u32) bpf_csum_diff(NULL, 0, (__be32 *)(",
+                                      sumVar.c_str());
+                visitor->visit(field);
+                builder->appendFormat("), %d, 0)", width / 8);
+                builder->endOfStatement(true);
+                for (int i = 0; i < 2; ++i) {
+                    builder->emitIndent();
+                    builder->appendFormat("%s = (%s & 0xFFFF) + (%s >> 16)", sumVar.c_str(),
+                                          sumVar.c_str(), sumVar.c_str());
+                    builder->endOfStatement(true);
+                }
+                builder->emitIndent();
+                builder->appendFormat("%s = htons((u16) %s)", tmpVar.c_str(), sumVar.c_str());
+                builder->endOfStatement(true);
+
+                builder->target->emitTraceMessage(builder, "InternetChecksum: sum=0x%llx", 1,
+                                                  tmpVar.c_str());
+                builder->emitIndent();
+                builder->appendFormat("%s = %s(%s, %s)", stateVar.c_str(),
+                                      addData ? "csum16_add" : "csum16_sub", stateVar.c_str(),
+                                      tmpVar.c_str());
+                builder->endOfStatement(true);
+                continue;
+            }
+
             // Let's convert internal array into an array of u16 and calc csum for such entries.
             // Byte order conversion is required, because csum is calculated in host byte order
             // but data is preserved in network byte order
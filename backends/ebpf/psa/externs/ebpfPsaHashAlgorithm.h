@@ -86,7 +86,21 @@ class CRCChecksumAlgorithm : public EBPFHashAlgorithmPSA {
 
     unsigned getOutputWidth() const override { return crcWidth; }
 
-    static void emitUpdateMethod(CodeBuilder *builder, int crcWidth);
+    /// How the generated update functions reach the precomputed lookup tables.
+    struct LookupTables {
+        /// Statements emitted at the start of the update functions to find the tables.
+        cstring setup;
+        /// Expressions denoting the CRC16 table and the slice-by-8 CRC32 table.
+        cstring crc16, crc32;
+        /// Condition under which the tables can be used; empty if they always can.
+        /// When it does not hold, CRC16 is computed bit by bit and CRC32 is not updated.
+        cstring available;
+    };
+    /// Tables kept in the crc_lookup_tbl map, filled by the map initializer.
+    static const LookupTables mapLookupTables;
+
+    static void emitUpdateMethod(CodeBuilder *builder, int crcWidth,
+                                 const LookupTables &tables = mapLookupTables);
 
     void emitVariables(CodeBuilder *builder, const IR::Declaration_Instance *decl) override;
 
@@ -17,6 +17,8 @@ limitations under the License.
 
 namespace EBPF {
 
+const cstring EBPFMeterPSA::perCPUAnnotation = "per_cpu";
+
 EBPFMeterPSA::EBPFMeterPSA(const EBPFProgram *program, cstring instanceName,
                            const IR::Declaration_Instance *di, CodeGenInspector *codeGen)
     : EBPFTableBase(program, instanceName, codeGen) {
@@ -43,6 +45,15 @@ EBPFMeterPSA::EBPFMeterPSA(const EBPFProgram *program, cstring instanceName,
 
     auto typeExpr = di->arguments->at(isDirect ? 0 : 1)->expression->to<IR::Constant>();
     this->type = toType(typeExpr->asInt());
+
+    if (di->getAnnotation(perCPUAnnotation) != nullptr) {
+        if (isDirect)
+            ::warning(ErrorType::WARN_IGNORE,
+                      "%1%: ignoring @%2%, direct meters are stored in the table", di,
+                      perCPUAnnotation);
+        else
+            perCPU = true;
+    }
 }
 
 EBPFType *EBPFMeterPSA::getBaseValueType(P4::ReferenceMap *refMap) {
@@ -140,13 +151,16 @@ void EBPFMeterPSA::emitValueType(CodeBuilder *builder) const {
         builder->emitIndent();
         getBaseValueType(program->refMap)->declare(builder, instanceName, false);
         builder->endOfStatement(true);
-    } else {
+    } else if (!perCPU) {
         getIndirectValueType()->emit(builder);
     }
 }
 
 void EBPFMeterPSA::emitInstance(CodeBuilder *builder) const {
-    if (!isDirect) {
+    if (perCPU) {
+        builder->target->emitTableDecl(builder, instanceName, TablePerCPUHash, this->keyTypeName,
+                                       "struct " + getBaseStructName(program->refMap), size);
+    } else if (!isDirect) {
         builder->target->emitTableDeclSpinlock(builder, instanceName, TableHash, this->keyTypeName,
                                                "struct " + getIndirectStructName(), size);
     } else {
@@ -167,6 +181,7 @@ void EBPFMeterPSA::emitExecute(CodeBuilder *builder, const P4::ExternMethod *met
     } else {
         functionNameSuffix = "";
     }
+    if (perCPU) functionNameSuffix = "_percpu" + functionNameSuffix;
 
     if (type == BYTES) {
         builder->appendFormat("meter_execute_bytes%s(&%s, &%s, ", functionNameSuffix, instanceName,
@@ -411,6 +426,52 @@ cstring EBPFMeterPSA::meterExecuteFunc(bool trace, P4::ReferenceMap *refMap) {
         "time_ns, color);\n"
         "}\n";
 
+    // Per-CPU meters own their value: the same algorithm without the spin lock.
+    const char *wrappers = meterExecuteFunc.find(
+        "static __always_inline\nenum PSA_MeterColor_t meter_execute_bytes_value(");
+    cstring perCPUFuncs = meterExecuteFunc.before(wrappers);
+    perCPUFuncs = perCPUFuncs.replace(cstring("            bpf_spin_unlock(lock);\n"), "")
+                      .replace(cstring("        bpf_spin_unlock(lock);\n"), "")
+                      .replace(cstring("        bpf_spin_lock(lock);\n"), "")
+                      .replace(cstring("meter_execute("), "meter_execute_percpu(")
+                      .replace(cstring("meter_execute_color_aware("),
+                               "meter_execute_percpu_color_aware(");
+    meterExecuteFunc = meterExecuteFunc + "\n" + perCPUFuncs +
+                       "static __always_inline\n"
+                       "enum PSA_MeterColor_t meter_execute_bytes_percpu("
+                       "void *map, u32 *packet_len, void *key, u64 *time_ns) {\n"
+                       "%trace_msg_meter_execute_bytes%"
+                       "    return meter_execute_percpu(BPF_MAP_LOOKUP_ELEM(*map, key), NULL, "
+                       "packet_len, time_ns);\n"
+                       "}\n"
+                       "\n"
+                       "static __always_inline\n"
+                       "enum PSA_MeterColor_t meter_execute_packets_percpu("
+                       "void *map, void *key, u64 *time_ns) {\n"
+                       "%trace_msg_meter_execute_packets%"
+                       "    u32 len = 1;\n"
+                       "    return meter_execute_percpu(BPF_MAP_LOOKUP_ELEM(*map, key), NULL, "
+                       "&len, time_ns);\n"
+                       "}\n"
+                       "\n"
+                       "static __always_inline\n"
+                       "enum PSA_MeterColor_t meter_execute_bytes_percpu_color_aware("
+                       "void *map, u32 *packet_len, void *key, u64 *time_ns, "
+                       "enum PSA_MeterColor_t color) {\n"
+                       "%trace_msg_meter_execute_bytes%"
+                       "    return meter_execute_percpu_color_aware("
+                       "BPF_MAP_LOOKUP_ELEM(*map, key), NULL, packet_len, time_ns, color);\n"
+                       "}\n"
+                       "\n"
+                       "static __always_inline\n"
+                       "enum PSA_MeterColor_t meter_execute_packets_percpu_color_aware("
+                       "void *map, void *key, u64 *time_ns, enum PSA_MeterColor_t color) {\n"
+                       "%trace_msg_meter_execute_packets%"
+                       "    u32 len = 1;\n"
+                       "    return meter_execute_percpu_color_aware("
+                       "BPF_MAP_LOOKUP_ELEM(*map, key), NULL, &len, time_ns, color);\n"
+                       "}\n";
+
     if (trace) {
         meterExecuteFunc = meterExecuteFunc.replace(cstring("%trace_msg_meter_green%"),
                                                     "        bpf_trace_message(\""
@@ -39,11 +39,17 @@ class EBPFMeterPSA : public EBPFTableBase {
     size_t size{};
     EBPFType *keyType{};
     bool isDirect;
+    /// Set by @per_cpu: every CPU keeps its own token buckets, updated without a spin lock.
+    /// The control plane splits the configured rates and burst sizes between the CPUs, so
+    /// the meter approximates the configured rates when traffic is spread over several CPUs.
+    bool perCPU = false;
 
  public:
     enum MeterType { PACKETS, BYTES };
     MeterType type;
 
+    static const cstring perCPUAnnotation;
+
     EBPFMeterPSA(const EBPFProgram *program, cstring instanceName,
                  const IR::Declaration_Instance *di, CodeGenInspector *codeGen);
 
@@ -188,31 +188,34 @@ void EBPFRegisterPSA::emitRegisterRead(CodeBuilder *builder, const P4::ExternMet
     builder->blockStart();
     builder->emitIndent();
 
-    if (leftExpression != nullptr) {
-        if (initialValue != nullptr || leftExpression->type->is<IR::Type_Bits>()) {
-            // let's create fake assigment statement and use it to generate valid code
-            const IR::Expression *right =
-                initialValue != nullptr ? initialValue : new IR::Constant(leftExpression->type, 0);
-            const auto *assigment = new IR::AssignmentStatement(leftExpression, right);
-            ControlBodyTranslatorPSA cg(*translator);
-            assigment->apply(cg);
-            builder->newline();
-        } else if (leftExpression->type->is<IR::Type_StructLike>()) {
-            translator->visit(leftExpression);
-            builder->append(" = (");
-            this->valueType->declare(builder, cstring::empty, false);
-            builder->append(")");
-            this->valueType->emitInitializer(builder);
-            builder->endOfStatement(true);
-        } else {
-            BUG("%1%: unsupported type for register read", leftExpression);
-        }
-    }
+    if (leftExpression != nullptr) emitInitialValue(builder, translator, leftExpression);
 
     builder->target->emitTraceMessage(builder, "Register: Entry not found, using default value");
     builder->blockEnd(true);
 }
 
+void EBPFRegisterPSA::emitInitialValue(CodeBuilder *builder, ControlBodyTranslatorPSA *translator,
+                                       const IR::Expression *leftExpression) {
+    if (initialValue != nullptr || leftExpression->type->is<IR::Type_Bits>()) {
+        // let's create fake assigment statement and use it to generate valid code
+        const IR::Expression *right =
+            initialValue != nullptr ? initialValue : new IR::Constant(leftExpression->type, 0);
+        const auto *assigment = new IR::AssignmentStatement(leftExpression, right);
+        ControlBodyTranslatorPSA cg(*translator);
+        assigment->apply(cg);
+        builder->newline();
+    } else if (leftExpression->type->is<IR::Type_StructLike>()) {
+        translator->visit(leftExpression);
+        builder->append(" = (");
+        this->valueType->declare(builder, cstring::empty, false);
+        builder->append(")");
+        this->valueType->emitInitializer(builder);
+        builder->endOfStatement(true);
+    } else {
+        BUG("%1%: unsupported type for register read", leftExpression);
+    }
+}
+
 void EBPFRegisterPSA::emitRegisterWrite(CodeBuilder *builder, const P4::ExternMethod *method,
                                         ControlBodyTranslatorPSA *translator) {
     cstring msgStr = Util::printf_format("Register: writing %s", instanceName.c_str());
@@ -237,4 +240,83 @@ void EBPFRegisterPSA::emitRegisterWrite(CodeBuilder *builder, const P4::ExternMe
     builder->blockEnd(true);
 }
 
+bool EBPFRegisterPSA::supportsAtomicAdd(const IR::Type *type) const {
+    // eBPF has atomic adds of 32 and 64 bits only.
+    auto scalar = valueType->to<EBPFScalarType>();
+    if (scalar == nullptr) return false;
+    unsigned width = scalar->widthInBits();
+    if (width != 32 && width != 64) return false;
+    auto bits = type->to<IR::Type_Bits>();
+    return bits != nullptr && static_cast<unsigned>(bits->width_bits()) == width;
+}
+
+void EBPFRegisterPSA::emitRegisterAtomicAdd(CodeBuilder *builder, const P4::ExternMethod *read,
+                                            ControlBodyTranslatorPSA *translator,
+                                            const IR::Expression *leftExpression,
+                                            const IR::Expression *increment, bool negate) {
+    auto index = read->expr->arguments->at(0)->expression;
+    cstring valueName = program->refMap->newName("value");
+
+    builder->emitIndent();
+    this->valueType->declare(builder, valueName, true);
+    builder->endOfStatement(true);
+
+    cstring msgStr = Util::printf_format("Register: updating %s", instanceName.c_str());
+    builder->target->emitTraceMessage(builder, msgStr.c_str());
+
+    builder->emitIndent();
+    builder->appendFormat("%s = BPF_MAP_LOOKUP_ELEM(%s, &", valueName.c_str(),
+                          instanceName.c_str());
+    translator->visit(index);
+    builder->append(")");
+    builder->endOfStatement(true);
+
+    builder->emitIndent();
+    builder->appendFormat("if (%s != NULL) ", valueName.c_str());
+    builder->blockStart();
+    builder->emitIndent();
+    translator->visit(leftExpression);
+    builder->appendFormat(" = *%s", valueName.c_str());
+    builder->endOfStatement(true);
+    // The result of the add is not used, so that this compiles to an atomic
+    // add on every eBPF instruction set, not only those with atomic fetches.
+    builder->emitIndent();
+    builder->appendFormat("__sync_fetch_and_add(%s, %s(", valueName.c_str(), negate ? "-" : "");
+    translator->visit(increment);
+    builder->append("))");
+    builder->endOfStatement(true);
+    builder->target->emitTraceMessage(builder, "Register: Entry found!");
+    builder->blockEnd(false);
+    builder->appendFormat(" else ");
+    builder->blockStart();
+    builder->emitIndent();
+    emitInitialValue(builder, translator, leftExpression);
+
+    cstring newValueName = program->refMap->newName("new_value");
+    builder->emitIndent();
+    builder->appendFormat("%s %s = ", valueTypeName.c_str(), newValueName.c_str());
+    translator->visit(leftExpression);
+    builder->appendFormat(" %s (", negate ? "-" : "+");
+    translator->visit(increment);
+    builder->append(")");
+    builder->endOfStatement(true);
+
+    builder->emitIndent();
+    auto ret = program->refMap->newName("ret");
+    builder->appendFormat("int %s = BPF_MAP_UPDATE_ELEM(%s, &", ret.c_str(), instanceName.c_str());
+    translator->visit(index);
+    builder->appendFormat(", &%s, BPF_ANY)", newValueName.c_str());
+    builder->endOfStatement(true);
+
+    builder->emitIndent();
+    builder->appendFormat("if (%s) ", ret.c_str());
+    builder->blockStart();
+    msgStr =
+        Util::printf_format("Register: Error while map (%s) update, code: %s", instanceName, "%d");
+    builder->target->emitTraceMessage(builder, msgStr, 1, ret.c_str());
+    builder->blockEnd(true);
+
+    builder->blockEnd(true);
+}
+
 }  // namespace EBPF
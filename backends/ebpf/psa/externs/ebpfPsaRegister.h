@@ -36,6 +36,8 @@ class EBPFRegisterPSA : public EBPFTableBase {
     EBPFType *valueType;
 
     bool shouldUseArrayMap();
+    void emitInitialValue(CodeBuilder *builder, ControlBodyTranslatorPSA *translator,
+                          const IR::Expression *leftExpression);
 
  public:
     EBPFRegisterPSA(const EBPFProgram *program, cstring instanceName,
@@ -52,6 +54,17 @@ class EBPFRegisterPSA : public EBPFTableBase {
                           const IR::Expression *leftExpression);
     void emitRegisterWrite(CodeBuilder *builder, const P4::ExternMethod *method,
                            ControlBodyTranslatorPSA *translator);
+    /// @returns true if a read-modify-write of this register that assigns the
+    /// old value to an expression of @p type can be an atomic add.
+    bool supportsAtomicAdd(const IR::Type *type) const;
+    /// Emits `leftExpression = read(index); write(index, leftExpression + increment)`,
+    /// where @p read is the read, as a single lookup followed by an atomic add
+    /// of @p increment (or of its opposite if @p negate) to the register cell.
+    /// Concurrent updates of the cell are then never lost.
+    void emitRegisterAtomicAdd(CodeBuilder *builder, const P4::ExternMethod *read,
+                               ControlBodyTranslatorPSA *translator,
+                               const IR::Expression *leftExpression,
+                               const IR::Expression *increment, bool negate);
 };
 
 }  // namespace EBPF
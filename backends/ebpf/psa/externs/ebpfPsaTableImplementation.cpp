@@ -668,6 +668,10 @@ void EBPFActionSelectorPSA::emitCacheTypes(CodeBuilder *builder) {
     builder->emitIndent();
     builder->appendFormat("u32 group_ref");
     builder->endOfStatement(true);
+    // entries of older generations are never found again and age out of the LRU map
+    builder->emitIndent();
+    builder->appendFormat("u32 generation");
+    builder->endOfStatement(true);
 
     unsigned int fieldNumber = 0;
     for (auto s : selectors) {
@@ -713,6 +717,10 @@ void EBPFActionSelectorPSA::emitCacheLookup(CodeBuilder *builder, cstring key, c
     builder->appendFormat("%s.group_ref = %s->%s", cacheKeyVar.c_str(), key.c_str(),
                           referenceName.c_str());
     builder->endOfStatement(true);
+    emitCacheGeneration(builder);
+    builder->emitIndent();
+    builder->appendFormat("%s.generation = %s", cacheKeyVar.c_str(), cacheGenerationVar.c_str());
+    builder->endOfStatement(true);
 
     unsigned int fieldNumber = 0;
     for (auto s : selectors) {
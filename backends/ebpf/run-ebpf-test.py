@@ -79,6 +79,18 @@ PARSER.add_argument(
         " stf file in the same folder."
     ),
 )
+PARSER.add_argument(
+    "--benchmark",
+    dest="benchmark",
+    type=int,
+    default=0,
+    metavar="REPEAT",
+    help=(
+        "Instead of checking the outputs, report the latency of each input packet, run REPEAT "
+        "times in the kernel with BPF_PROG_TEST_RUN, and the size of the program. "
+        "Only supported by the kernel target."
+    ),
+)
 PARSER.add_argument(
     "-ll",
     "--log_level",
@@ -127,6 +139,7 @@ class Options:
         # The location of the eBPF runtime, some targets may overwrite this.
         self.runtimedir = str(FILE_DIR.joinpath("runtime"))
         self.extern = ""  # Path to C file with extern definition.
+        self.benchmark = 0  # Repetitions per packet in benchmark mode, 0 to test.
 
 
 def run_model(ebpf, testfile):
@@ -138,6 +151,12 @@ def run_model(ebpf, testfile):
     if result != testutils.SUCCESS:
         return result
 
+    if ebpf.options.benchmark > 0:
+        result = ebpf.benchmark(ebpf.options.benchmark)
+        if result == testutils.SKIPPED:
+            return testutils.SUCCESS
+        return result
+
     result = ebpf.run()
     if result == testutils.SKIPPED:
         return testutils.SUCCESS
@@ -247,6 +266,7 @@ if __name__ == "__main__":
         options.testfile = testutils.check_if_file(args.testfile).as_posix()
     options.target = args.target
     options.extern = args.extern
+    options.benchmark = args.benchmark
     options.testdir = tempfile.mkdtemp(dir=os.path.abspath("./"))
     os.chmod(options.testdir, 0o755)
     # Configure logging.
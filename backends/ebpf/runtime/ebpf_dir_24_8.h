@@ -0,0 +1,164 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+ * Control plane of the tables compiled with the @dir_24_8 annotation. Such a
+ * table TBL is made of four array maps:
+ *  - TBL_dir24, indexed by the top 24 bits of the key;
+ *  - TBL_dir8, groups of 256 entries indexed by the low 8 bits of the key;
+ *  - TBL, the values, slot 0 standing for no value;
+ *  - TBL_dir_state, the numbers of value slots and of groups in use.
+ * An entry of TBL_dir24 with DIR_24_8_EXTENDED set refers to a group of
+ * TBL_dir8, any other entry refers to a value slot. Entries also keep the
+ * length of the prefix they were expanded from, so that adding a prefix only
+ * overwrites the entries of shorter prefixes.
+ *
+ * Entries cannot be deleted, and the slot of a value is not reused when its
+ * prefix is added again. This header must be included after the target
+ * header, which defines the BPF_OBJ_GET and BPF_USER_MAP_* macros.
+ */
+
+#ifndef BACKENDS_EBPF_RUNTIME_EBPF_DIR_24_8_H_
+#define BACKENDS_EBPF_RUNTIME_EBPF_DIR_24_8_H_
+
+#include <stdint.h>
+#include <stdio.h>   // snprintf()
+#include <string.h>  // memcpy()
+
+/* Must match the layout used by the compiler, see backends/ebpf/ebpfTable.cpp */
+#define DIR_24_8_EXTENDED 0x80000000u
+#define DIR_24_8_LENGTH_SHIFT 24
+#define DIR_24_8_LENGTH_MASK 0x3f000000u
+#define DIR_24_8_INDEX_MASK 0x00ffffffu
+
+/* Entries of the TBL_dir_state map */
+#define DIR_24_8_STATE_VALUES 0
+#define DIR_24_8_STATE_GROUPS 1
+
+struct dir_24_8_maps {
+    int dir24;
+    int dir8;
+    int values;
+    int state;
+};
+
+static inline int dir_24_8_open_map(const char *table, const char *suffix) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s%s", table, suffix);
+    return BPF_OBJ_GET(path);
+}
+
+static inline int dir_24_8_open(const char *table, struct dir_24_8_maps *maps) {
+    maps->values = dir_24_8_open_map(table, "");
+    maps->dir24 = dir_24_8_open_map(table, "_dir24");
+    maps->dir8 = dir_24_8_open_map(table, "_dir8");
+    maps->state = dir_24_8_open_map(table, "_dir_state");
+    if (maps->values < 0 || maps->dir24 < 0 || maps->dir8 < 0 || maps->state < 0)
+        return -1;
+    return 0;
+}
+
+/* Entries that were never written read as 0: no value. */
+static inline uint32_t dir_24_8_read(int map, uint32_t index) {
+    uint32_t entry = 0;
+    if (BPF_USER_MAP_LOOKUP_ELEM(map, &index, &entry) != 0)
+        return 0;
+    return entry;
+}
+
+static inline int dir_24_8_write(int map, uint32_t index, uint32_t entry) {
+    return BPF_USER_MAP_UPDATE_ELEM(map, &index, &entry, BPF_ANY);
+}
+
+static inline uint32_t dir_24_8_length(uint32_t entry) {
+    return (entry & DIR_24_8_LENGTH_MASK) >> DIR_24_8_LENGTH_SHIFT;
+}
+
+/* Writes entry over the count entries of map starting at first, except
+ * those expanded from a longer prefix than length. */
+static inline int dir_24_8_fill(int map, uint32_t first, uint32_t count,
+                                uint32_t length, uint32_t entry) {
+    for (uint32_t i = first; i < first + count; i++) {
+        if (dir_24_8_length(dir_24_8_read(map, i)) > length)
+            continue;
+        if (dir_24_8_write(map, i, entry) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Adds a prefix to a DIR-24-8 table.
+ * @details table is the pinned path of the table, e.g. MAP_PATH "/tbl".
+ * key points to the key struct of the table, laid out as for an LPM trie:
+ * the prefix length as an u32, followed by the key field in network byte
+ * order, of width bits (the value of the TBL_DIR_24_8 macro of the table).
+ * The value is copied into a new slot of the table.
+ * @return 0 on success, -1 if a map is missing or full.
+ */
+static inline int dir_24_8_update(const char *table, const void *key, unsigned width,
+                                  const void *value) {
+    struct dir_24_8_maps maps;
+    if (dir_24_8_open(table, &maps) != 0)
+        return -1;
+
+    const uint8_t *bytes = (const uint8_t *)key;
+    uint32_t length, address = 0;
+    memcpy(&length, bytes, sizeof(length));
+    if (length > width)
+        return -1;
+    for (unsigned i = 0; i < width / 8; i++)
+        address |= (uint32_t)bytes[sizeof(length) + i] << (24 - 8 * i);
+    if (length < 32)
+        address &= ~(0xffffffffu >> length);
+
+    uint32_t slot = dir_24_8_read(maps.state, DIR_24_8_STATE_VALUES) + 1;
+    if (slot > DIR_24_8_INDEX_MASK ||
+        BPF_USER_MAP_UPDATE_ELEM(maps.values, &slot, (void *)value, BPF_ANY) != 0 ||
+        dir_24_8_write(maps.state, DIR_24_8_STATE_VALUES, slot) != 0)
+        return -1;
+    uint32_t entry = (length << DIR_24_8_LENGTH_SHIFT) | slot;
+
+    if (length <= 24) {
+        uint32_t first = address >> 8;
+        for (uint32_t i = first; i < first + (1u << (24 - length)); i++) {
+            uint32_t old = dir_24_8_read(maps.dir24, i);
+            if (old & DIR_24_8_EXTENDED) {
+                uint32_t group = old & DIR_24_8_INDEX_MASK;
+                if (dir_24_8_fill(maps.dir8, group << 8, 256, length, entry) != 0)
+                    return -1;
+            } else if (dir_24_8_length(old) <= length) {
+                if (dir_24_8_write(maps.dir24, i, entry) != 0)
+                    return -1;
+            }
+        }
+        return 0;
+    }
+
+    uint32_t index = address >> 8;
+    uint32_t old = dir_24_8_read(maps.dir24, index);
+    uint32_t group = old & DIR_24_8_INDEX_MASK;
+    if (!(old & DIR_24_8_EXTENDED)) {
+        /* The new group starts with the prefix that covered the whole /24. */
+        group = dir_24_8_read(maps.state, DIR_24_8_STATE_GROUPS);
+        if (dir_24_8_fill(maps.dir8, group << 8, 256, 32, old) != 0 ||
+            dir_24_8_write(maps.state, DIR_24_8_STATE_GROUPS, group + 1) != 0 ||
+            dir_24_8_write(maps.dir24, index, DIR_24_8_EXTENDED | group) != 0)
+            return -1;
+    }
+    return dir_24_8_fill(maps.dir8, (group << 8) | (address & 0xff), 1u << (32 - length),
+                         length, entry);
+}
+
+#endif  // BACKENDS_EBPF_RUNTIME_EBPF_DIR_24_8_H_
@@ -50,10 +50,12 @@ limitations under the License.
  */
 #ifdef CONTROL_PLANE // BEGIN EBPF USER SPACE DEFINITIONS
 
-#include <bpf/bpf.h> // bpf_obj_get/pin, bpf_map_update_elem
+#include <bpf/bpf.h> // bpf_obj_get/pin, bpf_map_update/lookup_elem
 
 #define BPF_USER_MAP_UPDATE_ELEM(index, key, value, flags)\
     bpf_map_update_elem(index, key, value, flags)
+#define BPF_USER_MAP_LOOKUP_ELEM(index, key, value)\
+    bpf_map_lookup_elem(index, key, value)
 #define BPF_OBJ_PIN(table, name) bpf_obj_pin(table, name)
 #define BPF_OBJ_GET(name) bpf_obj_get(name)
 
@@ -177,6 +179,13 @@ struct {                                 \
     __uint(max_entries, MAX_ENTRIES);    \
     __uint(pinning, LIBBPF_PIN_BY_NAME); \
 } NAME SEC(".maps");
+/* SIZE is in bytes and must be a power of 2 multiple of the page size */
+#define REGISTER_RINGBUF(NAME, SIZE)     \
+struct {                                 \
+    __uint(type, BPF_MAP_TYPE_RINGBUF);  \
+    __uint(max_entries, SIZE);           \
+    __uint(pinning, LIBBPF_PIN_BY_NAME); \
+} NAME SEC(".maps");
 #endif
 #define REGISTER_END()
 
@@ -56,23 +56,27 @@ int bpf_map_update_elem(struct bpf_map **map, void *key, unsigned int key_size,
     if (ret)
         return ret;
     if (tmp_map == NULL) {
-        tmp_map = (struct bpf_map *) malloc(sizeof(struct bpf_map));
-        tmp_map->key = malloc(key_size);
+        /* The element, its key and its value share a single allocation.
+           The value is placed at an 8-byte aligned offset after the key. */
+        size_t value_offset = (key_size + 7) & ~(size_t)7;
+        tmp_map = (struct bpf_map *) malloc(sizeof(struct bpf_map) + value_offset + value_size);
+        if (tmp_map == NULL)
+            return EXIT_FAILURE;
+        tmp_map->key = (char *)(tmp_map + 1);
+        tmp_map->value = (char *)tmp_map->key + value_offset;
         memcpy(tmp_map->key, key, key_size);
         HASH_ADD_KEYPTR(hh, *map, tmp_map->key, key_size, tmp_map);
     }
-    tmp_map->value = malloc(value_size);
+    /* Existing values are updated in place */
     memcpy(tmp_map->value, value, value_size);
     return EXIT_SUCCESS;
 }
 
-int bpf_map_delete_elem(struct bpf_map *map, void *key, unsigned int key_size) {
+int bpf_map_delete_elem(struct bpf_map **map, void *key, unsigned int key_size) {
     struct bpf_map *tmp_map;
-    HASH_FIND(hh, map, key, key_size, tmp_map);
+    HASH_FIND(hh, *map, key, key_size, tmp_map);
     if (tmp_map != NULL) {
-        HASH_DEL(map, tmp_map);
-        free(tmp_map->value);
-        free(tmp_map->key);
+        HASH_DEL(*map, tmp_map);
         free(tmp_map);
     }
     return EXIT_SUCCESS;
@@ -82,8 +86,6 @@ int bpf_map_delete_map(struct bpf_map *map) {
     struct bpf_map *curr_map, *tmp_map;
     HASH_ITER(hh, map, curr_map, tmp_map) {
         HASH_DEL(map, curr_map);
-        free(curr_map->value);
-        free(curr_map->key);
         free(curr_map);
     }
     free(map);
@@ -56,7 +56,7 @@ void *bpf_map_lookup_elem(struct bpf_map *map, void *key, unsigned int key_size)
  *
  * @return EXIT_FAILURE if operation fails.
  */
-int bpf_map_delete_elem(struct bpf_map *map, void *key, unsigned int key_size);
+int bpf_map_delete_elem(struct bpf_map **map, void *key, unsigned int key_size);
 
 /**
  * @brief Delete the entire map at once.
@@ -19,6 +19,7 @@ Implementation of ebpf registry. Intended to provide a common access interface b
 */
 
 #include <stdio.h>
+#include <pthread.h>
 #include "ebpf_registry.h"
 
 /**
@@ -36,6 +37,10 @@ typedef struct {
 
 static int table_indexer = 0;
 
+/* Serializes element operations, so that several threads can run the program.
+   Values returned by lookups are accessed without holding it, as in the kernel. */
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+
 /* Instantiation of the central registry by id and name */
 static registry_entry *reg_tables_name = NULL;
 static registry_entry *reg_tables_id = NULL;
@@ -125,7 +130,10 @@ int registry_update_table(const char *name, void *key, void *value, unsigned lon
     if (tmp_tbl == NULL)
         /* not found, return */
         return EXIT_FAILURE;
-    return bpf_map_update_elem(&tmp_tbl->bpf_map, key, tmp_tbl->key_size, value, tmp_tbl->value_size, flags);
+    pthread_mutex_lock(&registry_lock);
+    int ret = bpf_map_update_elem(&tmp_tbl->bpf_map, key, tmp_tbl->key_size, value, tmp_tbl->value_size, flags);
+    pthread_mutex_unlock(&registry_lock);
+    return ret;
 }
 
 int registry_update_table_id(int tbl_id, void *key, void *value, unsigned long long flags) {
@@ -133,7 +141,10 @@ int registry_update_table_id(int tbl_id, void *key, void *value, unsigned long l
     if (tmp_tbl == NULL)
         /* not found, return */
         return EXIT_FAILURE;
-    return bpf_map_update_elem(&tmp_tbl->bpf_map, key, tmp_tbl->key_size, value, tmp_tbl->value_size, flags);
+    pthread_mutex_lock(&registry_lock);
+    int ret = bpf_map_update_elem(&tmp_tbl->bpf_map, key, tmp_tbl->key_size, value, tmp_tbl->value_size, flags);
+    pthread_mutex_unlock(&registry_lock);
+    return ret;
 }
 
 int registry_delete_table_elem(const char *name, void *key) {
@@ -141,7 +152,10 @@ int registry_delete_table_elem(const char *name, void *key) {
     if (tmp_tbl == NULL)
         /* not found, return */
         return EXIT_FAILURE;
-    return bpf_map_delete_elem(tmp_tbl->bpf_map, key, tmp_tbl->key_size);;
+    pthread_mutex_lock(&registry_lock);
+    int ret = bpf_map_delete_elem(&tmp_tbl->bpf_map, key, tmp_tbl->key_size);
+    pthread_mutex_unlock(&registry_lock);
+    return ret;
 }
 
 int registry_delete_table_elem_id(int tbl_id, void *key) {
@@ -149,7 +163,10 @@ int registry_delete_table_elem_id(int tbl_id, void *key) {
     if (tmp_tbl == NULL)
         /* not found, return */
         return EXIT_FAILURE;
-    return bpf_map_delete_elem(tmp_tbl->bpf_map, key, tmp_tbl->key_size);;
+    pthread_mutex_lock(&registry_lock);
+    int ret = bpf_map_delete_elem(&tmp_tbl->bpf_map, key, tmp_tbl->key_size);
+    pthread_mutex_unlock(&registry_lock);
+    return ret;
 }
 
 void *registry_lookup_table_elem(const char *name, void *key) {
@@ -157,7 +174,10 @@ void *registry_lookup_table_elem(const char *name, void *key) {
     if (tmp_tbl == NULL)
         /* not found, return */
         return NULL;
-    return bpf_map_lookup_elem(tmp_tbl->bpf_map, key, tmp_tbl->key_size);
+    pthread_mutex_lock(&registry_lock);
+    void *ret = bpf_map_lookup_elem(tmp_tbl->bpf_map, key, tmp_tbl->key_size);
+    pthread_mutex_unlock(&registry_lock);
+    return ret;
 }
 
 void *registry_lookup_table_elem_id(int tbl_id, void *key) {
@@ -165,7 +185,23 @@ void *registry_lookup_table_elem_id(int tbl_id, void *key) {
     if (tmp_tbl == NULL)
         /* not found, return */
         return NULL;
-    return bpf_map_lookup_elem(tmp_tbl->bpf_map, key, tmp_tbl->key_size);
+    pthread_mutex_lock(&registry_lock);
+    void *ret = bpf_map_lookup_elem(tmp_tbl->bpf_map, key, tmp_tbl->key_size);
+    pthread_mutex_unlock(&registry_lock);
+    return ret;
+}
+
+int registry_copy_table_elem_id(int tbl_id, void *key, void *value) {
+    struct bpf_table *tmp_tbl = registry_lookup_table_id(tbl_id);
+    if (tmp_tbl == NULL)
+        /* not found, return */
+        return EXIT_FAILURE;
+    pthread_mutex_lock(&registry_lock);
+    void *elem = bpf_map_lookup_elem(tmp_tbl->bpf_map, key, tmp_tbl->key_size);
+    if (elem != NULL)
+        memcpy(value, elem, tmp_tbl->value_size);
+    pthread_mutex_unlock(&registry_lock);
+    return elem == NULL ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
 int registry_get_id(const char *name) {
@@ -18,7 +18,8 @@ limitations under the License.
  * This file defines a shared registry. It is required by the p4c-ebpf test framework
  * and acts as an interface between the emulated control and data plane. It provides
  * a mechanism to access shared tables by name or id and is intended to approximate the
- * kernel ebpf object API as closely as possible. This library is currently not thread-safe.
+ * kernel ebpf object API as closely as possible. Element operations may be called from
+ * several threads; adding and removing tables is not thread-safe.
  */
 
 #ifndef BACKENDS_EBPF_RUNTIME_EBPF_REGISTRY_H_
@@ -159,4 +160,14 @@ void *registry_lookup_table_elem(const char *name, void *key);
  */
 void *registry_lookup_table_elem_id(int tbl_id, void *key);
 
+/**
+ * @brief Copy a value out of a bpf map through the registry.
+ * @details A wrapper function with the semantics of the userspace
+ * bpf_map_lookup_elem: the value is copied into the buffer, which must
+ * hold value_size bytes of the table.
+ * This operation uses an integer as the key.
+ * @return EXIT_FAILURE if the table or the value cannot be found.
+ */
+int registry_copy_table_elem_id(int tbl_id, void *key, void *value);
+
 #endif  // BACKENDS_EBPF_RUNTIME_EBPF_REGISTRY_H_
@@ -24,6 +24,7 @@ limitations under the License.
 #include <ctype.h>      // isprint()
 #include <string.h>     // memcpy()
 #include <stdlib.h>     // malloc()
+#include <time.h>       // clock_gettime()
 #include "test.h"
 #ifdef CONTROL_PLANE
 #include "control.h"
@@ -32,8 +33,13 @@ limitations under the License.
 
 #define PCAPIN  "_in.pcap"
 #define DELIM   '_'
+#define MAX_THREADS 256
 
 static int debug = 0;
+static int benchmark = 0;
+static int num_threads = 1;
+static uint32_t repeat = 0;
+static const char *object = NULL;
 
 void usage(char *name) {
     fprintf(stderr, "This program expects a pcap file pattern, "
@@ -41,11 +47,17 @@ void usage(char *name) {
             "in the order given by the packet time,"
             "then feeds the individual packets into a filter function, "
             "and returns the output.\n");
-    fprintf(stderr, "Usage: %s [-d] -f file.pcap -n num_pcaps\n", name);
+    fprintf(stderr, "Usage: %s [-d] [-b] [-t num_threads] [-r repeat -o file.o] "
+            "-f file.pcap -n num_pcaps\n", name);
     fprintf(stderr, "Options:\n");
     fprintf(stderr, "\t-d: Turn on debug messages\n");
+    fprintf(stderr, "\t-b: Report the packet processing rate\n");
+    fprintf(stderr, "\t-t: Process the packets with the given number of threads\n");
     fprintf(stderr, "\t-f: The input pcap file\n");
     fprintf(stderr, "\t-n: Specifies the number of input pcap files\n");
+    fprintf(stderr, "\t-r: Load the eBPF object given with -o into the kernel and report the "
+            "latency of each packet, run repeat times with BPF_PROG_TEST_RUN\n");
+    fprintf(stderr, "\t-o: The eBPF object to benchmark\n");
     exit(EXIT_FAILURE);
 }
 
@@ -85,8 +97,24 @@ void launch_runtime(const char *pcap_name, uint16_t num_pcaps) {
     input_list = get_packets(pcap_base, num_pcaps, input_list);
     /* Sort the list */
     sort_pcap_list(input_list);
+#ifdef BENCHMARK_SUPPORTED
+    if (repeat > 0) {
+        run_benchmark(input_list, repeat, debug);
+        delete_list(input_list);
+        return;
+    }
+#endif
     /* Run the "program" and retrieve output lists */
-    RUN(ebpf_filter, pcap_base, num_pcaps, input_list, debug);
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    RUN(ebpf_filter, pcap_base, num_pcaps, input_list, num_threads, debug);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (benchmark) {
+        uint32_t num_pkts = get_pkt_list_length(input_list);
+        double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+        printf("Processed %u packets with %d thread(s) in %.6f s (%.0f packets/s)\n", num_pkts,
+            num_threads, elapsed, elapsed > 0 ? num_pkts / elapsed : 0);
+    }
     /* Delete the list of input packets */
     delete_list(input_list);
 }
@@ -97,11 +125,23 @@ int main(int argc, char **argv) {
     int c;
     opterr = 0;
 
-    while ((c = getopt (argc, argv, "dn:f:")) != -1) {
+    while ((c = getopt (argc, argv, "dbt:n:f:r:o:")) != -1) {
         switch (c) {
             case 'd':
             debug = 1;
             break;
+            case 'b':
+                benchmark = 1;
+            break;
+            case 't':
+                num_threads = (int)strtol(optarg, (char **)NULL, 10);
+                if (num_threads < 1 || num_threads > MAX_THREADS) {
+                    fprintf(stderr,
+                        "Number of threads out of bounds! Maximum is %d\n",
+                        MAX_THREADS);
+                    return EXIT_FAILURE;
+                }
+            break;
             case 'n':
                 num_pcaps = (int)strtol(optarg, (char **)NULL, 10);
                 if (num_pcaps < 0 || num_pcaps > UINT16_MAX) {
@@ -114,6 +154,12 @@ int main(int argc, char **argv) {
             case 'f':
                 pcap_name = optarg;
             break;
+            case 'r':
+                repeat = (uint32_t)strtoul(optarg, (char **)NULL, 10);
+            break;
+            case 'o':
+                object = optarg;
+            break;
             case '?':
                 if (optopt == 'f')
                     fprintf(stderr, "The input trace file is missing. "
@@ -134,6 +180,20 @@ int main(int argc, char **argv) {
     if (!pcap_name || num_pcaps == -1)
         usage(argv[0]);
 
+    if (repeat > 0) {
+#ifdef BENCHMARK_SUPPORTED
+        if (!object)
+            usage(argv[0]);
+        /* The maps are pinned where the control plane expects them */
+        if (load_benchmark_program(object, MAP_PATH, debug) != 0)
+            return EXIT_FAILURE;
+#else
+        fprintf(stderr, "Benchmarks are only supported by the kernel target "
+                "with a control plane.\n");
+        return EXIT_FAILURE;
+#endif
+    }
+
     INIT_EBPF_TABLES(debug);
 #ifdef CONTROL_PLANE
     /* Set the default action for the userspace hash tables */
@@ -144,5 +204,9 @@ int main(int argc, char **argv) {
 
     launch_runtime(pcap_name, num_pcaps);
     DELETE_EBPF_TABLES(debug);
+#ifdef BENCHMARK_SUPPORTED
+    if (repeat > 0)
+        unload_benchmark_program(debug);
+#endif
     return EXIT_SUCCESS;
 }
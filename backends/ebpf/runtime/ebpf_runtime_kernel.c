@@ -25,6 +25,9 @@ limitations under the License.
 #include <net/if.h>
 #include "ebpf_kernel.h"
 #include "ebpf_runtime_kernel.h"
+#ifdef CONTROL_PLANE
+#include <bpf/libbpf.h>
+#endif
 
 
 int open_socket(char *iface_name) {
@@ -86,3 +89,90 @@ void run_and_record_output(pcap_list_t *pkt_list, char *pcap_base, uint16_t num_
     /* Sleep a bit to allow the remaining processes to finish */
     sleep(2);
 }
+
+#ifdef CONTROL_PLANE
+/* BPF_PROG_TEST_RUN rejects packets shorter than an Ethernet header */
+#define MIN_TEST_RUN_LEN 14
+
+static struct bpf_object *benchmark_object = NULL;
+
+int load_benchmark_program(const char *object, const char *pin_path, int debug) {
+    LIBBPF_OPTS(bpf_object_open_opts, opts, .pin_root_path = pin_path);
+    benchmark_object = bpf_object__open_file(object, &opts);
+    if (libbpf_get_error(benchmark_object)) {
+        fprintf(stderr, "Could not open eBPF object %s\n", object);
+        benchmark_object = NULL;
+        return -1;
+    }
+    struct bpf_program *prog;
+    bpf_object__for_each_program(prog, benchmark_object) {
+        /* libbpf does not know the type of the "prog" section of TC programs */
+        if (bpf_program__type(prog) == BPF_PROG_TYPE_UNSPEC)
+            bpf_program__set_type(prog, BPF_PROG_TYPE_SCHED_CLS);
+    }
+    if (bpf_object__load(benchmark_object)) {
+        perror("Could not load the eBPF object");
+        bpf_object__close(benchmark_object);
+        benchmark_object = NULL;
+        return -1;
+    }
+    if (debug)
+        printf("Loaded %s, maps pinned in %s\n", object, pin_path);
+    return 0;
+}
+
+void run_benchmark(pcap_list_t *pkt_list, uint32_t repeat, int debug) {
+    struct bpf_program *prog = bpf_object__next_program(benchmark_object, NULL);
+    if (!prog) {
+        fprintf(stderr, "No program to benchmark\n");
+        return;
+    }
+    int prog_fd = bpf_program__fd(prog);
+    struct bpf_prog_info info;
+    __u32 info_len = sizeof(info);
+    memset(&info, 0, sizeof(info));
+    if (bpf_obj_get_info_by_fd(prog_fd, &info, &info_len) == 0) {
+        printf("Program %s: %u instructions, %u bytes JIT-compiled\n", bpf_program__name(prog),
+            (unsigned)(info.xlated_prog_len / sizeof(struct bpf_insn)), info.jited_prog_len);
+    }
+
+    uint32_t list_len = get_pkt_list_length(pkt_list);
+    uint32_t num_run = 0;
+    uint64_t total_ns = 0;
+    for (uint32_t i = 0; i < list_len; i++) {
+        pcap_pkt *input_pkt = get_packet(pkt_list, i);
+        uint32_t len = input_pkt->pcap_hdr.len;
+        if (len < MIN_TEST_RUN_LEN) {
+            printf("Packet %u: %u bytes, skipped\n", i, len);
+            continue;
+        }
+        LIBBPF_OPTS(bpf_test_run_opts, opts,
+            .data_in = input_pkt->data,
+            .data_size_in = len,
+            .repeat = repeat,
+        );
+        if (bpf_prog_test_run_opts(prog_fd, &opts) != 0) {
+            perror("BPF_PROG_TEST_RUN failed");
+            continue;
+        }
+        printf("Packet %u: %u bytes, return value %u, %u ns\n", i, len, opts.retval,
+            opts.duration);
+        total_ns += opts.duration;
+        num_run++;
+    }
+    if (num_run > 0) {
+        printf("Average over %u packets, %u runs each: %.1f ns/packet\n", num_run, repeat,
+            (double)total_ns / num_run);
+    }
+}
+
+void unload_benchmark_program(int debug) {
+    if (!benchmark_object)
+        return;
+    bpf_object__unpin_maps(benchmark_object, NULL);
+    bpf_object__close(benchmark_object);
+    benchmark_object = NULL;
+    if (debug)
+        printf("Unloaded the benchmarked program\n");
+}
+#endif
@@ -29,9 +29,22 @@ limitations under the License.
 
 void run_and_record_output(pcap_list_t *pkt_list, char *pcap_base, uint16_t num_pcaps, int debug);
 
-#define RUN(ebpf_filter, pcap_base, num_pcaps, input_list, debug) \
+/* The kernel runs the program, num_threads is not used */
+#define RUN(ebpf_filter, pcap_base, num_pcaps, input_list, num_threads, debug) \
     run_and_record_output(input_list, pcap_base, num_pcaps, debug)
 #define INIT_EBPF_TABLES(debug)
 #define DELETE_EBPF_TABLES(debug)
 
+#ifdef CONTROL_PLANE
+/* Benchmarks load the program themselves instead of attaching it to interfaces */
+#define BENCHMARK_SUPPORTED
+/* Load the eBPF object into the kernel and pin its maps below pin_path */
+int load_benchmark_program(const char *object, const char *pin_path, int debug);
+/* Run each packet repeat times through the first program of the object and
+ * report the average latency, as well as the size of the program. */
+void run_benchmark(pcap_list_t *pkt_list, uint32_t repeat, int debug);
+/* Unpin the maps and unload the object */
+void unload_benchmark_program(int debug);
+#endif
+
 #endif  // BACKENDS_EBPF_RUNTIME_EBPF_RUNTIME_KERNEL_H_
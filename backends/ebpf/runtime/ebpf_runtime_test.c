@@ -18,40 +18,86 @@ limitations under the License.
 #include <ctype.h>      // isprint()
 #include <string.h>     // memcpy()
 #include <stdlib.h>     // malloc()
+#include <pthread.h>    // pthread_create()
 #include "ebpf_test.h"
 #include "ebpf_runtime_test.h"
 
 #define PCAPOUT "_out.pcap"
 
+/* The share of the input packets processed by one thread */
+struct feed_shard {
+    packet_filter ebpf_filter;
+    pcap_list_t *pkt_list;
+    int *results;       // verdict of each packet in the list
+    uint32_t first;     // index of the first packet of the shard
+    uint32_t stride;    // distance between consecutive packets of the shard
+    int debug;
+};
+
+static void *run_shard(void *arg) {
+    struct feed_shard *shard = arg;
+    uint32_t list_len = get_pkt_list_length(shard->pkt_list);
+    for (uint32_t i = shard->first; i < list_len; i += shard->stride) {
+        /* Parse each packet in the shard and record the result */
+        struct sk_buff skb;
+        pcap_pkt *input_pkt = get_packet(shard->pkt_list, i);
+        skb.data = (void *) input_pkt->data;
+        skb.len = input_pkt->pcap_hdr.len;
+        shard->results[i] = shard->ebpf_filter(&skb);
+        if (shard->debug)
+            printf("Result of the eBPF parsing is: %d\n", shard->results[i]);
+    }
+    return NULL;
+}
+
 /**
  * @brief Feed a list packets into an eBPF program.
  * @details This is a mock function emulating the behavior of a running
- * eBPF program. It takes a list of input packets and iteratively parses them
+ * eBPF program. It takes a list of input packets and parses them
  * using the given imported ebpf_filter function. The output defines whether
  * or not the packet is "dropped." If the packet is not dropped, its content is
  * copied and appended to an output packet list.
+ * With more than one thread, packet i is processed by thread i % num_threads,
+ * like packets spread over several CPUs. All the threads share the tables.
+ * The output list keeps the order of the input list regardless.
  *
  * @param pkt_list A list of input packets running through the filter.
  * @return The list of packets "surviving" the filter function
  */
-pcap_list_t *feed_packets(packet_filter ebpf_filter, pcap_list_t *pkt_list, int debug) {
+pcap_list_t *feed_packets(packet_filter ebpf_filter, pcap_list_t *pkt_list, int num_threads,
+                          int debug) {
     pcap_list_t *output_pkts = allocate_pkt_list();
     uint32_t list_len = get_pkt_list_length(pkt_list);
+    int *results = calloc(list_len ? list_len : 1, sizeof(int));
+    struct feed_shard *shards = calloc(num_threads, sizeof(struct feed_shard));
+    pthread_t *threads = calloc(num_threads, sizeof(pthread_t));
+    if (results == NULL || shards == NULL || threads == NULL) {
+        perror("Fatal: Could not allocate memory\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int t = 0; t < num_threads; t++) {
+        shards[t] = (struct feed_shard) { ebpf_filter, pkt_list, results, t, num_threads, debug };
+        if (num_threads == 1)
+            run_shard(&shards[t]);
+        else if (pthread_create(&threads[t], NULL, run_shard, &shards[t]) != 0) {
+            fprintf(stderr, "Fatal: Could not create thread %d\n", t);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (num_threads > 1)
+        for (int t = 0; t < num_threads; t++)
+            pthread_join(threads[t], NULL);
+
     for (uint32_t i = 0; i < list_len; i++) {
-        /* Parse each packet in the list and check the result */
-        struct sk_buff skb;
-        pcap_pkt *input_pkt = get_packet(pkt_list, i);
-        skb.data = (void *) input_pkt->data;
-        skb.len = input_pkt->pcap_hdr.len;
-        int result = ebpf_filter(&skb);
-        if (result != 0) {
+        if (results[i] != 0) {
             /* We copy the entire content to emulate an outgoing packet */
-            pcap_pkt *out_pkt = copy_pkt(input_pkt);
+            pcap_pkt *out_pkt = copy_pkt(get_packet(pkt_list, i));
             output_pkts = append_packet(output_pkts, out_pkt);
         }
-        if (debug)
-            printf("Result of the eBPF parsing is: %d\n", result);
     }
+    free(threads);
+    free(shards);
+    free(results);
     return output_pkts;
 }
 
@@ -67,11 +113,12 @@ void write_pkts_to_pcaps(const char *pcap_base, pcap_list_array_t *output_array,
     }
 }
 
-void *run_and_record_output(packet_filter ebpf_filter, const char *pcap_base, pcap_list_t *pkt_list, int debug) {
+void *run_and_record_output(packet_filter ebpf_filter, const char *pcap_base, pcap_list_t *pkt_list,
+                            int num_threads, int debug) {
     /* Create an array of packet lists */
     pcap_list_array_t *output_array = allocate_pkt_list_array();
     /* Feed the packets into our "loaded" program */
-    pcap_list_t *output_pkts = feed_packets(ebpf_filter, pkt_list, debug);
+    pcap_list_t *output_pkts = feed_packets(ebpf_filter, pkt_list, num_threads, debug);
     /* Split the output packet list by interface. This destroys the list. */
     output_array = split_and_delete_list(output_pkts, output_array);
     /* Write each list to a separate pcap output file */
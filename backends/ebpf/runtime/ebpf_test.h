@@ -100,6 +100,8 @@ struct bpf_table tables[] = {
     registry_delete_table_elem(MAP_PATH"/"#table, key)
 #define BPF_USER_MAP_UPDATE_ELEM(index, key, value, flags)\
     registry_update_table_id(index, key, value, flags)
+#define BPF_USER_MAP_LOOKUP_ELEM(index, key, value)\
+    registry_copy_table_elem_id(index, key, value)
 #define BPF_OBJ_PIN(table, name) registry_add(table)
 #define BPF_OBJ_GET(name) registry_get_id(name)
 
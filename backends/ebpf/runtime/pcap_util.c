@@ -26,6 +26,7 @@ limitations under the License.
 struct pcap_list {
     pcap_pkt **pkts;
     uint32_t len;
+    uint32_t capacity;  // number of allocated slots in pkts
 };
 
 /* An array of lists of packets */
@@ -38,14 +39,17 @@ pcap_list_t *append_packet(pcap_list_t *pkt_list, pcap_pkt *pkt) {
     if (!pkt_list)
         /* If the list is not allocated yet, create it */
         pkt_list = allocate_pkt_list();
-    pkt_list->len++;
-    pkt_list->pkts = realloc(pkt_list->pkts, pkt_list->len * sizeof(pcap_pkt *));
-    if (pkt_list->pkts == NULL) {
-        fprintf(stderr, "Fatal: Failed to expand the"
-            "packet list with size %u !\n", pkt_list->len);
-        exit(EXIT_FAILURE);
+    if (pkt_list->len == pkt_list->capacity) {
+        /* Grow geometrically, so that appending n packets costs O(n) */
+        pkt_list->capacity = pkt_list->capacity ? 2 * pkt_list->capacity : 64;
+        pkt_list->pkts = realloc(pkt_list->pkts, pkt_list->capacity * sizeof(pcap_pkt *));
+        if (pkt_list->pkts == NULL) {
+            fprintf(stderr, "Fatal: Failed to expand the"
+                "packet list with size %u !\n", pkt_list->capacity);
+            exit(EXIT_FAILURE);
+        }
     }
-    pkt_list->pkts[pkt_list->len - 1] = pkt;
+    pkt_list->pkts[pkt_list->len++] = pkt;
     return pkt_list;
 }
 
@@ -31,6 +31,7 @@ enum TableKind {
     TableHash,
     TableArray,
     TablePerCPUArray,
+    TablePerCPUHash,
     TableProgArray,
     TableLPMTrie,  // longest prefix match trie
     TableHashLRU,
@@ -134,6 +135,8 @@ class KernelSamplesTarget : public Target {
             return "BPF_MAP_TYPE_ARRAY";
         } else if (kind == TablePerCPUArray) {
             return "BPF_MAP_TYPE_PERCPU_ARRAY";
+        } else if (kind == TablePerCPUHash) {
+            return "BPF_MAP_TYPE_PERCPU_HASH";
         } else if (kind == TableLPMTrie) {
             return "BPF_MAP_TYPE_LPM_TRIE";
         } else if (kind == TableHashLRU) {
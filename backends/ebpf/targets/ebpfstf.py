@@ -69,11 +69,6 @@ def _generate_control_actions(cmds):
                     )
                     key_field_val = key_field_val[0]
                 generated += "%s.%s = %s;\n\t" % (key_name, field, key_field_val)
-        generated += "tableFileDescriptor = BPF_OBJ_GET(MAP_PATH \"/%s\");\n\t" % tbl_name
-        generated += (
-            "if (tableFileDescriptor < 0) {fprintf(stderr, \"map %s not loaded\"); exit(1); }\n\t"
-            % tbl_name
-        )
         generated += "struct %s_value %s = {\n\t\t" % (cmd.table, value_name)
         if cmd.action[0] == "_NoAction":
             generated += ".action = 0,\n\t\t"
@@ -84,11 +79,30 @@ def _generate_control_actions(cmds):
         for val_num, val_field in enumerate(cmd.action[1]):
             generated += "%s," % val_field[1]
         generated += "}},\n\t"
-        generated += "};\n\t"
+        generated += "};\n"
+        # Tables compiled with @dir_24_8 are arrays the prefixes are expanded into.
+        dir_24_8 = "%s_DIR_24_8" % cmd.table.upper()
+        if cmd.a_type != "setdefault":
+            generated += "#ifdef %s\n\t" % dir_24_8
+            generated += 'ok = dir_24_8_update(MAP_PATH "/%s", &%s, %s, &%s);\n' % (
+                tbl_name,
+                key_name,
+                dir_24_8,
+                value_name,
+            )
+            generated += "#else\n"
+        generated += "\ttableFileDescriptor = BPF_OBJ_GET(MAP_PATH \"/%s\");\n\t" % tbl_name
+        generated += (
+            "if (tableFileDescriptor < 0) {fprintf(stderr, \"map %s not loaded\"); exit(1); }\n\t"
+            % tbl_name
+        )
         generated += (
-            "ok = BPF_USER_MAP_UPDATE_ELEM(tableFileDescriptor, &%s, &%s, BPF_ANY);\n\t"
+            "ok = BPF_USER_MAP_UPDATE_ELEM(tableFileDescriptor, &%s, &%s, BPF_ANY);\n"
             % (key_name, value_name)
         )
+        if cmd.a_type != "setdefault":
+            generated += "#endif\n"
+        generated += "\t"
         generated += 'if (ok != 0) { perror("Could not write in %s");exit(1); }\n' % tbl_name
     return generated
 
@@ -102,7 +116,8 @@ def create_table_file(actions, tmpdir, file_name):
     try:
         with open(tmpdir + "/" + file_name, "w+") as control_file:
             control_file.write('#include "test.h"\n')
-            control_file.write("#include <stddef.h>\n\n")
+            control_file.write("#include <stddef.h>\n")
+            control_file.write('#include "ebpf_dir_24_8.h"\n\n')
             control_file.write("static inline void setup_control_plane() {")
             control_file.write("\n\t")
             control_file.write("int ok;\n\t")
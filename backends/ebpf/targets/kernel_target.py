@@ -183,6 +183,28 @@ class Target(EBPFTarget):
         time.sleep(2)
         return result
 
+    def benchmark(self, repeat):
+        """Loads the program into the kernel without attaching it to an interface, installs the
+        table entries of the STF file into its maps, and runs every input packet @repeat times
+        through it with BPF_PROG_TEST_RUN. The runtime prints the latency per packet and the
+        number of instructions of the program."""
+        # Root is necessary to load ebpf into the kernel
+        if not testutils.check_root():
+            testutils.log.warning("This benchmark requires root privileges; skipping execution.")
+            return testutils.SKIPPED
+        result = self._create_runtime()
+        if result != testutils.SUCCESS:
+            return result
+        direction = "in"
+        cmd = self.template + " "
+        cmd += "-f " + self.filename("", direction) + " "
+        cmd += "-n " + str(len(glob(self.filename("*", direction)))) + " "
+        cmd += f"-r {repeat} -o {self.template}.o"
+        result = testutils.exec_process(cmd)
+        if result.output:
+            print(result.output, end="")
+        return result.returncode
+
     def run(self):
         # Root is necessary to load ebpf into the kernel
         if not testutils.check_root():
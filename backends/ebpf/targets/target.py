@@ -169,6 +169,12 @@ class EBPFTarget:
         """Runs the filter and feeds attached interfaces with packets"""
         raise NotImplementedError("Method run() not implemented!")
 
+    def benchmark(self, repeat):
+        # To override
+        """Reports the latency of the filter for each input packet, run @repeat times"""
+        testutils.log.error(f"Benchmarks are not supported by the {self.options.target} target")
+        return testutils.FAILURE
+
     def check_outputs(self):
         """Checks if the output of the filter matches expectations"""
         testutils.log.info("Comparing outputs")
@@ -16,12 +16,266 @@
 
 #include "graph_visitor.h"
 
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include "graphs.h"
 #include "lib/nullstream.h"
 #include "lib/path.h"
 
 namespace graphs {
 
+namespace {
+
+using Graph = Graphs::Graph;
+using VertexType = Graphs::VertexType;
+
+/// @returns @p text as a dot identifier, which is quoted unless it is a plain name.
+std::string dotId(const std::string &text) {
+    bool isName = !text.empty() && !isdigit(static_cast<unsigned char>(text[0]));
+    for (char c : text) isName = isName && (isalnum(static_cast<unsigned char>(c)) || c == '_');
+    if (isName) return text;
+    std::string result = "\"";
+    for (char c : text) {
+        if (c == '"') result += '\\';
+        result += c;
+    }
+    return result + '"';
+}
+
+const char *vertexShape(VertexType type) {
+    switch (type) {
+        case VertexType::TABLE:
+        case VertexType::ACTION:
+            return "ellipse";
+        default:
+            return "rectangle";
+    }
+}
+
+const char *vertexStyle(VertexType type) {
+    switch (type) {
+        case VertexType::CONTROL:
+            return "dashed";
+        case VertexType::EMPTY:
+            return "invis";
+        case VertexType::KEY:
+        case VertexType::CONDITION:
+        case VertexType::SWITCH:
+            return "rounded";
+        default:
+            return "solid";
+    }
+}
+
+/// Streams a graph and its clusters in dot format. Every vertex is written in the innermost
+/// cluster which contains it, and all edges are written at the end of the root graph.
+class DotWriter {
+    const Graph &root;
+    std::ostream &out;
+    /// The innermost subgraph which contains each vertex.
+    std::vector<const Graph *> owner;
+    /// The vertex drawn in place of each vertex. A collapsed chain is drawn as its first vertex.
+    std::vector<size_t> drawnAs;
+    /// The labels of the vertices which stand for a collapsed chain.
+    std::map<size_t, std::string> chainLabels;
+    /// The name of the program block of each vertex, which is the label of its outermost
+    /// cluster.
+    std::vector<std::string> blockNames;
+    /// The profiled hit count of each drawn vertex, and the largest one.
+    std::vector<uint64_t> hits;
+    uint64_t maxHits = 0;
+
+    void collectOwners(const Graph &g, const std::string &blockName) {
+        for (auto [vit, vend] = boost::vertices(g); vit != vend; ++vit) {
+            owner[g.local_to_global(*vit)] = &g;
+            blockNames[g.local_to_global(*vit)] = blockName;
+        }
+        for (auto [cit, cend] = g.children(); cit != cend; ++cit) {
+            const auto &attributes = boost::get_property(*cit, boost::graph_graph_attribute);
+            auto label = attributes.find("label");
+            collectOwners(*cit, !g.is_root() || label == attributes.end()
+                                    ? blockName
+                                    : std::string(label->second.c_str()));
+        }
+    }
+
+    /// @returns the heat of a profiled vertex, between 0 and 1, as a graphviz HSV color.
+    std::string heatColor(uint64_t vertexHits) const {
+        std::stringstream color;
+        color << std::fixed << std::setprecision(3) << "0.000 "
+              << static_cast<double>(vertexHits) / maxHits << " 1.000";
+        return color.str();
+    }
+
+    static void writeAttributes(std::ostream &out, const Graphs::GraphvizAttributes &attributes) {
+        const char *separator = "";
+        for (const auto &[key, value] : attributes) {
+            out << separator << key << "=" << dotId(value.c_str());
+            separator = ", ";
+        }
+    }
+
+    void writeGraph(const Graph &g) {
+        out << (g.is_root() ? "digraph " : "subgraph ")
+            << dotId(boost::get_property(g, boost::graph_name).c_str()) << " {\n";
+        const auto &graphAttributes = boost::get_property(g, boost::graph_graph_attribute);
+        if (!graphAttributes.empty()) {
+            out << "graph [";
+            writeAttributes(out, graphAttributes);
+            out << "];\n";
+        }
+        for (auto [cit, cend] = g.children(); cit != cend; ++cit) writeGraph(*cit);
+        for (auto [vit, vend] = boost::vertices(g); vit != vend; ++vit) {
+            auto v = g.local_to_global(*vit);
+            if (owner[v] != &g || drawnAs[v] != v) continue;
+            const auto &vertex = root[v];
+            auto chain = chainLabels.find(v);
+            std::string label = chain != chainLabels.end() ? chain->second : vertex.name.c_str();
+            std::string style = vertexStyle(vertex.type);
+            if (hits[v] > 0) {
+                label += "\\n" + std::to_string(hits[v]) + " hits";
+                style += ",filled";
+            }
+            out << v << " [label=" << dotId(label) << ", shape=" << vertexShape(vertex.type)
+                << ", style=" << dotId(style);
+            if (hits[v] > 0) out << ", fillcolor=" << dotId(heatColor(hits[v]));
+            out << "];\n";
+        }
+        if (g.is_root()) writeEdges();
+        out << "}\n";
+    }
+
+    void writeEdges() {
+        for (auto [eit, eend] = boost::edges(root); eit != eend; ++eit) {
+            auto from = boost::source(*eit, root);
+            auto to = boost::target(*eit, root);
+            // Drop the edges inside a collapsed chain.
+            if (from != to && drawnAs[from] == drawnAs[to]) continue;
+            out << drawnAs[from] << " -> " << drawnAs[to] << " [label="
+                << dotId(boost::get(boost::edge_name, root, *eit).c_str());
+            // An edge is as hot as its target, or as its source if the target has no profile.
+            auto edgeHits = hits[drawnAs[to]] > 0 ? hits[drawnAs[to]] : hits[drawnAs[from]];
+            if (edgeHits > 0) {
+                out << ", color=" << dotId(heatColor(edgeHits)) << ", penwidth="
+                    << 1 + 4.0 * edgeHits / maxHits;
+            }
+            const auto &attributes = boost::get(boost::edge_attribute, root, *eit);
+            if (!attributes.empty()) {
+                out << ", ";
+                writeAttributes(out, attributes);
+            }
+            out << "];\n";
+        }
+    }
+
+ public:
+    DotWriter(const Graph &g, std::ostream &out)
+        : root(g.root()),
+          out(out),
+          owner(boost::num_vertices(root)),
+          drawnAs(owner.size()),
+          blockNames(owner.size()),
+          hits(owner.size()) {
+        collectOwners(root, boost::get_property(root, boost::graph_name).c_str());
+        for (size_t v = 0; v < drawnAs.size(); ++v) drawnAs[v] = v;
+    }
+
+    /// Draws every chain of more than @p maxLength vertices as a single vertex. In a chain,
+    /// each vertex but the last has a single successor, which has no other predecessor and is
+    /// in the same cluster. The start and exit vertices are never part of a chain.
+    void collapseChains(unsigned maxLength) {
+        auto count = drawnAs.size();
+        std::vector<unsigned> inDegree(count), outDegree(count);
+        for (auto [eit, eend] = boost::edges(root); eit != eend; ++eit) {
+            outDegree[boost::source(*eit, root)]++;
+            inDegree[boost::target(*eit, root)]++;
+        }
+        auto chains = [this](size_t v) {
+            auto type = root[v].type;
+            return type != VertexType::OTHER && type != VertexType::EMPTY;
+        };
+        std::vector<std::optional<size_t>> next(count);
+        std::vector<bool> hasPrevious(count);
+        for (auto [eit, eend] = boost::edges(root); eit != eend; ++eit) {
+            auto from = boost::source(*eit, root);
+            auto to = boost::target(*eit, root);
+            if (from != to && outDegree[from] == 1 && inDegree[to] == 1 &&
+                owner[from] == owner[to] && chains(from) && chains(to)) {
+                next[from] = to;
+                hasPrevious[to] = true;
+            }
+        }
+        for (size_t first = 0; first < count; ++first) {
+            if (hasPrevious[first] || !next[first]) continue;
+            size_t last = first;
+            size_t length = 1;
+            for (; next[last]; ++length) last = *next[last];
+            if (length <= maxLength) continue;
+            for (auto v = first; v != last; v = *next[v]) drawnAs[v] = first;
+            drawnAs[last] = first;
+            chainLabels[first] = std::string(root[first].name.c_str()) + "\\n...\\n" +
+                                 root[last].name.c_str() + "\\n(" + std::to_string(length) +
+                                 " nodes)";
+        }
+    }
+
+    /// Annotates the tables, actions and parser states with their hit counts in @p profile,
+    /// which names them either "<block>.<name>" or "<name>". A collapsed chain is as hot as its
+    /// hottest vertex. Must be called after collapseChains.
+    void applyProfile(const Graph_visitor::Profile &profile) {
+        for (size_t v = 0; v < hits.size(); ++v) {
+            const auto &vertex = root[v];
+            if (vertex.type != VertexType::TABLE && vertex.type != VertexType::ACTION &&
+                vertex.type != VertexType::STATE) {
+                continue;
+            }
+            // The label of a parser state continues with its select expression.
+            std::string name = vertex.name.c_str();
+            name = name.substr(0, name.find('\n'));
+            auto it = profile.find(blockNames[v] + "." + name);
+            if (it == profile.end()) it = profile.find(name);
+            if (it == profile.end()) continue;
+            hits[drawnAs[v]] = std::max(hits[drawnAs[v]], it->second);
+            maxHits = std::max(maxHits, it->second);
+        }
+    }
+
+    void write() { writeGraph(root); }
+};
+
+}  // namespace
+
+std::optional<Graph_visitor::Profile> Graph_visitor::readProfile(const cstring &path) {
+    std::ifstream in(path.c_str());
+    if (!in) {
+        ::error(ErrorType::ERR_IO, "Failed to open file %1%", path);
+        return std::nullopt;
+    }
+    Profile profile;
+    std::string line;
+    for (size_t lineNumber = 1; std::getline(in, line); ++lineNumber) {
+        std::istringstream fields(line);
+        std::string name;
+        uint64_t count = 0;
+        if (!(fields >> name) || name[0] == '#') continue;
+        if (!(fields >> count)) {
+            ::error(ErrorType::ERR_INVALID, "%1%:%2%: expected a name and a hit count", path,
+                    lineNumber);
+            return std::nullopt;
+        }
+        profile[name] += count;
+    }
+    return profile;
+}
+
 void Graph_visitor::writeGraphToFile(const Graph &g, const cstring &name) {
     auto path = Util::PathName(graphsDir).join(name + ".dot");
     auto out = openFile(path.toString(), false);
@@ -29,9 +283,11 @@ void Graph_visitor::writeGraphToFile(const Graph &g, const cstring &name) {
         ::error(ErrorType::ERR_IO, "Failed to open file %1%", path.toString());
         return;
     }
-    // custom label writers not supported with subgraphs, so we populate
-    // *_attribute_t properties instead using our GraphAttributeSetter class.
-    boost::write_graphviz(*out, g);
+    DotWriter writer(g, *out);
+    if (collapseChains > 0) writer.collapseChains(collapseChains);
+    if (!profile.empty()) writer.applyProfile(profile);
+    writer.write();
+    out->flush();
 }
 
 const char *Graph_visitor::getType(const VertexType &v_type) {
@@ -79,49 +335,41 @@ const char *Graph_visitor::getPrevType(const PrevType &prev_type) {
     }
 }
 
-void Graph_visitor::forLoopJson(std::vector<Graph *> &graphsArray, PrevType node_type) {
+void Graph_visitor::forLoopJson(std::vector<Graph *> &graphsArray, PrevType node_type,
+                                Util::JsonWriter &writer) {
     for (auto g : graphsArray) {
-        auto block = new Util::JsonObject();
-        programBlocks->emplace_back(block);
-
-        block->emplace("type", getPrevType(node_type));
-        block->emplace("name", boost::get_property(*g, boost::graph_name));
-
-        auto nodesArray = new Util::JsonArray();
-        block->emplace("nodes", nodesArray);
-
-        auto parserEdges = new Util::JsonArray();
-        block->emplace("transitions", parserEdges);
-
-        auto subg = *g;
+        writer.beginObject();
+        writer.field("type", getPrevType(node_type));
+        writer.field("name", boost::get_property(*g, boost::graph_name));
 
-        auto vertices = boost::vertices(subg);
+        writer.key("nodes").beginArray();
+        auto vertices = boost::vertices(*g);
         for (auto &vit = vertices.first; vit != vertices.second; ++vit) {
-            auto node = new Util::JsonObject();
-            nodesArray->emplace_back(node);
-            node->emplace("node_nmb", *vit);
-
-            const auto &vinfo = subg[*vit];
-
-            node->emplace("name", vinfo.name.escapeJson());
-            node->emplace("type", getType(vinfo.type));
-            node->emplace("type_enum", (unsigned)vinfo.type);
+            const auto &vinfo = (*g)[*vit];
+            writer.beginObject();
+            writer.field("node_nmb", *vit);
+            writer.field("name", vinfo.name.escapeJson());
+            writer.field("type", getType(vinfo.type));
+            writer.field("type_enum", (unsigned)vinfo.type);
+            writer.endObject();
         }
+        writer.endArray();
 
-        auto edges = boost::edges(subg);
+        writer.key("transitions").beginArray();
+        auto edges = boost::edges(*g);
         for (auto &eit = edges.first; eit != edges.second; ++eit) {
-            auto edge = new Util::JsonObject();
-            parserEdges->emplace_back(edge);
-
             // answer https://stackoverflow.com/a/12001149
-            auto from = boost::source(*eit, subg);
-            auto to = boost::target(*eit, subg);
-
-            edge->emplace("from", from);
-            edge->emplace("to", to);
-
-            edge->emplace("cond", boost::get(boost::edge_name, subg, *eit).escapeJson());
+            auto from = boost::source(*eit, *g);
+            auto to = boost::target(*eit, *g);
+
+            writer.beginObject();
+            writer.field("from", from);
+            writer.field("to", to);
+            writer.field("cond", boost::get(boost::edge_name, *g, *eit).escapeJson());
+            writer.endObject();
         }
+        writer.endArray();
+        writer.endObject();
     }
 }
 
@@ -173,11 +421,9 @@ void Graph_visitor::process(std::vector<Graph *> &controlGraphsArray,
                             std::vector<Graph *> &parserGraphsArray) {
     if (graphs) {
         for (auto g : controlGraphsArray) {
-            GraphAttributeSetter()(*g);
             writeGraphToFile(*g, boost::get_property(*g, boost::graph_name));
         }
         for (auto g : parserGraphsArray) {
-            GraphAttributeSetter()(*g);
             writeGraphToFile(*g, boost::get_property(*g, boost::graph_name));
         }
     }
@@ -192,13 +438,10 @@ void Graph_visitor::process(std::vector<Graph *> &controlGraphsArray,
         forLoopFullGraph(parserGraphsArray, &opts, PrevType::Parser);
         forLoopFullGraph(controlGraphsArray, &opts, PrevType::Parser);
 
-        GraphAttributeSetter()(opts.fg);
         writeGraphToFile(opts.fg, "fullGraph");
     }
 
     if (jsonOut) {
-        json = new Util::JsonObject();
-
         // remove '.p4' and path from program name
         auto file_without_p4 = (filename.findlast('.') == nullptr)
                                    ? filename
@@ -208,17 +451,18 @@ void Graph_visitor::process(std::vector<Graph *> &controlGraphsArray,
             file_without_path = file_without_p4.findlast('/') + 1;  // char* without '/'
         }
 
-        json->emplace("name", file_without_path);
-        programBlocks = new Util::JsonArray();
-        json->emplace("nodes", programBlocks);
-
-        forLoopJson(parserGraphsArray, PrevType::Parser);
-        forLoopJson(controlGraphsArray, PrevType::Control);
-
         std::ofstream file;
         auto path = Util::PathName(graphsDir).join("fullGraph.json");
         file.open(path.toString());
-        file << json->toString() << std::endl;
+        Util::JsonWriter writer(file);
+        writer.beginObject();
+        writer.field("name", file_without_path);
+        writer.key("nodes").beginArray();
+        forLoopJson(parserGraphsArray, PrevType::Parser, writer);
+        forLoopJson(controlGraphsArray, PrevType::Control, writer);
+        writer.endArray();
+        writer.endObject();
+        file << std::endl;
         file.close();
     }
 }
@@ -14,6 +14,12 @@
  * limitations under the License.
  */
 
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/copy.hpp>
 
@@ -30,6 +36,10 @@ namespace graphs {
  * classes Controls and Parsers onto IR, and can only be run after them
  */
 class Graph_visitor : public Graphs {
+ public:
+    /// Hit counts of tables, actions and parser states, by name.
+    using Profile = std::map<std::string, uint64_t>;
+
  private:
     /** Enum used to create correct connection between subgraphs */
     enum class PrevType { Control, Parser };
@@ -66,14 +76,17 @@ class Graph_visitor : public Graphs {
      * @param graphs option to output graph for each function block
      * @param fullGraph option to create fullGraph
      * @param jsonOut option to create json fullGraph
+     * @param collapseChains chains of more than this many nodes are drawn as one node in the
+     *        dot graphs, 0 disables the collapsing
      */
     Graph_visitor(const cstring &graphsDir, const bool graphs, const bool fullGraph,
-                  const bool jsonOut, const cstring &filename)
+                  const bool jsonOut, const cstring &filename, unsigned collapseChains = 0)
         : graphsDir(graphsDir),
           graphs(graphs),
           fullGraph(fullGraph),
           jsonOut(jsonOut),
-          filename(filename) {}
+          filename(filename),
+          collapseChains(collapseChains) {}
     /**
      * @brief Maps VertexType to string
      * @param v_type VertexType to map
@@ -99,8 +112,24 @@ class Graph_visitor : public Graphs {
      * @param parserGraphsArray vector with boost graphs of control parsers
      */
     void process(std::vector<Graph *> &controlGraphsArray, std::vector<Graph *> &parserGraphsArray);
+    /**
+     * @brief Reads a profile of hit counts
+     * @details Each line of the file holds a name and a hit count, separated by whitespace.
+     * A name is either "<block>.<name>" or "<name>", where <block> is a top level control or
+     * parser. Empty lines and lines starting with '#' are ignored.
+     * @param path the file to read
+     * @return the profile, or std::nullopt after reporting an error
+     */
+    static std::optional<Profile> readProfile(const cstring &path);
+    /**
+     * @brief Highlights the profiled tables, actions and parser states in the dot graphs
+     * @param newProfile hit counts, see readProfile
+     */
+    void setProfile(Profile newProfile) { profile = std::move(newProfile); }
     /**
      * @brief Writes boost graph "g" in dot format to file given by "name"
+     * @details The dot output is streamed directly from the graph; boost::write_graphviz is
+     * not used, as it matches every identifier and label against a regular expression.
      * @param g boost graph
      * @param name file name
      */
@@ -111,9 +140,11 @@ class Graph_visitor : public Graphs {
      * @brief Loops over vector graphsArray with boost graphs, creating json representation of CFG
      * @param graphsArray vector containing boost graphs
      * @param prev_type represents whether graphs in graphsArray are of type control or parser
+     * @param writer writer of the json output, inside the top level array "nodes"
      *
      */
-    void forLoopJson(std::vector<Graph *> &graphsArray, PrevType prev_type);
+    void forLoopJson(std::vector<Graph *> &graphsArray, PrevType prev_type,
+                     Util::JsonWriter &writer);
     /**
      * @brief Loops over vector graphsArray with boost graphs, creating fullgraph
      * It basically merges all graphs in graphsArray into one CFG
@@ -124,8 +155,6 @@ class Graph_visitor : public Graphs {
     void forLoopFullGraph(std::vector<Graph *> &graphsArray, fullGraphOpts *opts,
                           PrevType prev_type);
 
-    Util::JsonObject *json = nullptr;          // stores json that will be outputted
-    Util::JsonArray *programBlocks = nullptr;  // stores objects in top level array "nodes"
     const cstring graphsDir;
     // options
     const bool graphs;     // output boost graphs to files
@@ -133,6 +162,8 @@ class Graph_visitor : public Graphs {
     const bool jsonOut;    // iterate over boost graphs, and create json representation of these
                            // graphs
     const cstring filename;
+    const unsigned collapseChains;  // collapse longer chains of nodes in the dot graphs
+    Profile profile;                // hit counts highlighted in the dot graphs
 };
 
 }  // namespace graphs
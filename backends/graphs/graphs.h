@@ -150,63 +150,6 @@ class Graphs : public Inspector {
     void add_edge(const vertex_t &from, const vertex_t &to, const cstring &name,
                   unsigned cluster_id);
 
-    class GraphAttributeSetter {
-     public:
-        void operator()(Graph &g) const {
-            auto vertices = boost::vertices(g);
-            for (auto &vit = vertices.first; vit != vertices.second; ++vit) {
-                const auto &vinfo = g[*vit];
-                auto attrs = boost::get(boost::vertex_attribute, g);
-                attrs[*vit]["label"] = vinfo.name;
-                attrs[*vit]["style"] = vertexTypeGetStyle(vinfo.type);
-                attrs[*vit]["shape"] = vertexTypeGetShape(vinfo.type);
-                attrs[*vit]["margin"] = vertexTypeGetMargin(vinfo.type);
-            }
-            auto edges = boost::edges(g);
-            for (auto &eit = edges.first; eit != edges.second; ++eit) {
-                auto attrs = boost::get(boost::edge_attribute, g);
-                attrs[*eit]["label"] = boost::get(boost::edge_name, g, *eit);
-            }
-        }
-
-     private:
-        static cstring vertexTypeGetShape(VertexType type) {
-            switch (type) {
-                case VertexType::TABLE:
-                case VertexType::ACTION:
-                    return "ellipse";
-                default:
-                    return "rectangle";
-            }
-            BUG("unreachable");
-            return "";
-        }
-
-        static cstring vertexTypeGetStyle(VertexType type) {
-            switch (type) {
-                case VertexType::CONTROL:
-                    return "dashed";
-                case VertexType::EMPTY:
-                    return "invis";
-                case VertexType::KEY:
-                case VertexType::CONDITION:
-                case VertexType::SWITCH:
-                    return "rounded";
-                default:
-                    return "solid";
-            }
-            BUG("unreachable");
-            return "";
-        }
-
-        static cstring vertexTypeGetMargin(VertexType type) {
-            switch (type) {
-                default:
-                    return "";
-            }
-        }
-    };  // end class GraphAttributeSetter
-
  protected:
     Graph *g{nullptr};
     vertex_t start_v{};
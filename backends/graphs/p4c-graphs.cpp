@@ -14,6 +14,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <cstdlib>
+#include <utility>
+
 #include "backends/graphs/version.h"
 #include "controls.h"
 #include "frontends/common/applyOptionsPragmas.h"
@@ -67,6 +70,8 @@ class Options : public CompilerOptions {
     bool graphs = true;           // default behavior
     bool fullGraph = false;
     bool jsonOut = false;
+    unsigned collapseChains = 0;
+    cstring profileFile = nullptr;
     Options() {
         registerOption(
             "--graphs-dir", "dir",
@@ -112,6 +117,30 @@ class Options : public CompilerOptions {
                 return true;
             },
             "Use to generate json output of fullGraph.");
+        registerOption(
+            "--collapse-chains", "N",
+            [this](const char *arg) {
+                char *end = nullptr;
+                collapseChains = strtoul(arg, &end, 10);
+                if (end == arg || *end != '\0') {
+                    ::error(ErrorType::ERR_INVALID, "%1%: expected a number of nodes", arg);
+                    return false;
+                }
+                return true;
+            },
+            "Draw every chain of more than N nodes (e.g. a sequence of tables, or of\n"
+            "parser states with a single transition) as one node in the dot graphs.\n"
+            "0, the default, draws all the nodes.");
+        registerOption(
+            "--profile", "file",
+            [this](const char *arg) {
+                profileFile = arg;
+                return true;
+            },
+            "Highlight the hot tables, actions and parser states in the dot graphs.\n"
+            "Each line of the file holds a name, e.g. 'MyIngress.ipv4_lpm', and its\n"
+            "hit count, separated by whitespace. Use with --fullGraph for a single\n"
+            "graph of the whole program.");
     }
 
  private:
@@ -195,7 +224,12 @@ int main(int argc, char *const argv[]) {
     program->apply(pgg);
 
     graphs::Graph_visitor gvs(options.graphsDir, options.graphs, options.fullGraph, options.jsonOut,
-                              options.file);
+                              options.file, options.collapseChains);
+    if (options.profileFile) {
+        auto profile = graphs::Graph_visitor::readProfile(options.profileFile);
+        if (!profile) return 1;
+        gvs.setProfile(std::move(*profile));
+    }
 
     gvs.process(cgen.controlGraphsArray, pgg.parserGraphsArray);
 
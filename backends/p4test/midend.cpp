@@ -41,8 +41,7 @@ limitations under the License.
 #include "midend/eliminateTypedefs.h"
 #include "midend/expandEmit.h"
 #include "midend/expandLookahead.h"
-#include "midend/flattenHeaders.h"
-#include "midend/flattenInterfaceStructs.h"
+#include "midend/flattenAggregates.h"
 #include "midend/flattenUnions.h"
 #include "midend/global_copyprop.h"
 #include "midend/hsIndexSimplify.h"
@@ -106,8 +105,7 @@ MidEnd::MidEnd(CompilerOptions &options, std::ostream *outStream) {
          new P4::StrengthReduction(&refMap, &typeMap),
          new P4::SimplifySelectList(&refMap, &typeMap),
          new P4::RemoveSelectBooleans(&refMap, &typeMap),
-         new P4::FlattenHeaders(&refMap, &typeMap),
-         new P4::FlattenInterfaceStructs(&refMap, &typeMap),
+         new P4::FlattenAggregates(&refMap, &typeMap),
          new P4::EliminateTypedef(&refMap, &typeMap),
          new P4::ReplaceSelectRange(&refMap, &typeMap),
          new P4::MoveDeclarations(),  // more may have been introduced
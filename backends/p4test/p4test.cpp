@@ -14,16 +14,26 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdlib>
 #include <fstream>  // IWYU pragma: keep
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
 
 #include "backends/p4test/version.h"
 #include "control-plane/p4RuntimeSerializer.h"
 #include "frontends/common/applyOptionsPragmas.h"
+#include "frontends/common/compileServer.h"
 #include "frontends/common/parseInput.h"
 #include "frontends/p4/evaluator/evaluator.h"
 #include "frontends/p4/frontend.h"
 #include "frontends/p4/toP4/toP4.h"
+#include "ir/binary_loader.h"
+#include "ir/binary_writer.h"
 #include "ir/ir.h"
 #include "ir/json_loader.h"
 #include "lib/crash.h"
@@ -39,6 +49,9 @@ class P4TestOptions : public CompilerOptions {
     bool parseOnly = false;
     bool validateOnly = false;
     bool loadIRFromJson = false;
+    bool loadIRFromBinary = false;
+    const char *batchFile = nullptr;
+    unsigned batchJobs = 1;
     P4TestOptions() {
         registerOption(
             "--listMidendPasses", nullptr,
@@ -50,6 +63,14 @@ class P4TestOptions : public CompilerOptions {
                 return false;
             },
             "[p4test] Lists exact name of all midend passes.\n");
+        registerOption(
+            "--ir-node-sizes", nullptr,
+            [](const char *) {
+                IR::printNodeSizes(std::cout);
+                exit(0);
+                return false;
+            },
+            "[p4test] Lists the size in bytes of every concrete IR class.\n");
         registerOption(
             "--parse-only", nullptr,
             [this](const char *) {
@@ -72,6 +93,37 @@ class P4TestOptions : public CompilerOptions {
                 return true;
             },
             "read previously dumped json instead of P4 source code");
+        registerOption(
+            "--fromBinaryIR", "file",
+            [this](const char *arg) {
+                loadIRFromBinary = true;
+                file = arg;
+                return true;
+            },
+            "read IR previously dumped with --toBinaryIR instead of P4 source code");
+        registerOption(
+            "--batch", "file",
+            [this](const char *arg) {
+                batchFile = arg;
+                return true;
+            },
+            "Compile many programs in one process. Each line of the file holds the\n"
+            "p4test arguments of one program, separated by whitespace; empty lines and\n"
+            "lines starting with '#' are ignored. Lines starting with '!' are programs\n"
+            "which are expected to fail to compile.");
+        registerOption(
+            "--batch-jobs", "N",
+            [this](const char *arg) {
+                char *end = nullptr;
+                auto jobs = strtoul(arg, &end, 10);
+                if (end == arg || *end != '\0' || jobs == 0) {
+                    ::error(ErrorType::ERR_INVALID, "%1%: invalid number of batch jobs", arg);
+                    return false;
+                }
+                batchJobs = jobs;
+                return true;
+            },
+            "Split the programs of --batch over N worker processes [default: 1]");
         registerOption(
             "--turn-off-logn", nullptr,
             [](const char *) {
@@ -100,19 +152,9 @@ static void log_dump(const IR::Node *node, const char *head) {
     }
 }
 
-int main(int argc, char *const argv[]) {
-    setup_gc_logging();
-    setup_signals();
-
-    AutoCompileContext autoP4TestContext(new P4TestContext);
-    auto &options = P4TestContext::get().options();
-    options.langVersion = CompilerOptions::FrontendVersion::P4_16;
-    options.compilerVersion = P4TEST_VERSION_STRING;
-
-    if (options.process(argc, argv) != nullptr) {
-        if (options.loadIRFromJson == false) options.setInputFile();
-    }
-    if (::errorCount() > 0) return 1;
+/// Compiles the program of @p options in the current compile context.
+/// @returns the exit status of p4test.
+static int compile(P4TestOptions &options) {
     const IR::P4Program *program = nullptr;
     auto hook = options.getDebugHook();
     if (options.loadIRFromJson) {
@@ -126,6 +168,19 @@ int main(int argc, char *const argv[]) {
         } else {
             error(ErrorType::ERR_IO, "Can't open %s", options.file);
         }
+    } else if (options.loadIRFromBinary) {
+        std::ifstream in(options.file, std::ios::binary);
+        if (in) {
+            BinaryIRLoader loader(in);
+            const IR::Node *node = loader.valid() ? loader.readNode() : nullptr;
+            if (!loader.valid())
+                error(ErrorType::ERR_INVALID, "%s is not a binary IR file of this version",
+                      options.file);
+            else if (!node || !(program = node->to<IR::P4Program>()))
+                error(ErrorType::ERR_INVALID, "%s does not contain a P4Program", options.file);
+        } else {
+            error(ErrorType::ERR_IO, "Can't open %s", options.file);
+        }
     } else {
         program = P4::parseP4File(options);
 
@@ -177,6 +232,10 @@ int main(int argc, char *const argv[]) {
         if (program) {
             if (options.dumpJsonFile)
                 JSONGenerator(*openFile(options.dumpJsonFile, true), true) << program << std::endl;
+            if (options.dumpBinaryIRFile) {
+                std::ofstream out(options.dumpBinaryIRFile, std::ios::binary);
+                BinaryIRWriter(out) << program;
+            }
             if (options.debugJson) {
                 std::stringstream ss1, ss2;
                 JSONGenerator gen1(ss1), gen2(ss2);
@@ -200,6 +259,123 @@ int main(int argc, char *const argv[]) {
         }
     }
 
-    if (Log::verbose()) std::cerr << "Done." << std::endl;
     return ::errorCount() > 0;
 }
+
+/// Compiles the program of one --batch line in a fresh compile context and IR arena, so that
+/// neither its errors nor its IR leak into the next program.
+/// @returns true if the outcome of the compilation was the expected one.
+static bool compileBatchEntry(const char *argv0, std::string line) {
+    bool expectFailure = line[0] == '!';
+    if (expectFailure) line.erase(0, 1);
+    // The options keep pointers to the arguments until the compilation ends.
+    std::vector<std::string> args = {argv0};
+    std::istringstream words(line);
+    for (std::string word; words >> word;) args.push_back(word);
+    std::vector<char *> argvs;
+    for (auto &arg : args) argvs.push_back(arg.data());
+    argvs.push_back(nullptr);
+
+    int status = 1;
+    AutoCompileContext autoP4TestContext(new P4TestContext);
+    auto &options = P4TestContext::get().options();
+    options.langVersion = CompilerOptions::FrontendVersion::P4_16;
+    options.compilerVersion = P4TEST_VERSION_STRING;
+    auto *remaining = options.process(static_cast<int>(args.size()), argvs.data());
+    if (remaining != nullptr && !options.loadIRFromJson && !options.loadIRFromBinary) {
+        // setInputFile exits on a wrong number of inputs, which would stop the whole batch.
+        if (remaining->size() == 1)
+            options.setInputFile();
+        else
+            ::error(ErrorType::ERR_EXPECTED, "Expected exactly one input file");
+    }
+    if (remaining != nullptr && ::errorCount() == 0) {
+        IR::NodeArena nodeArena;
+        status = compile(options);
+    }
+    bool passed = (status == 0) != expectFailure;
+    std::cout << (passed ? "PASS " : "FAIL ") << line << std::endl;
+    return passed;
+}
+
+/// Compiles every program of the --batch file in @p options. The programs are split over
+/// --batch-jobs worker processes, which are forked once and compile their share of the programs
+/// one after the other. The frontend and midend keep global state, so the programs of one
+/// process can not be compiled in parallel threads.
+/// @returns the exit status of p4test: 0 if every program had the expected outcome.
+static int runBatch(const char *argv0, const P4TestOptions &options) {
+    std::ifstream batch(options.batchFile);
+    if (!batch) {
+        error(ErrorType::ERR_IO, "Can't open %s", options.batchFile);
+        return 1;
+    }
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(batch, line);) {
+        auto start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line[start] == '#') continue;
+        lines.push_back(line.substr(start));
+    }
+
+    unsigned failures = 0;
+    if (options.batchJobs == 1) {
+        for (const auto &line : lines) failures += !compileBatchEntry(argv0, line);
+        return failures > 0;
+    }
+    std::vector<pid_t> workers;
+    for (unsigned worker = 0; worker < options.batchJobs && worker < lines.size(); ++worker) {
+        auto pid = fork();
+        if (pid < 0) {
+            error(ErrorType::ERR_IO, "Unable to start a batch worker");
+            break;
+        }
+        if (pid == 0) {
+            for (size_t idx = worker; idx < lines.size(); idx += options.batchJobs)
+                failures += !compileBatchEntry(argv0, lines[idx]);
+            // Skip the destructors of the global state of the compiler.
+            _exit(failures > 0);
+        }
+        workers.push_back(pid);
+    }
+    for (auto pid : workers) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (WIFSIGNALED(status))
+            std::cerr << "A batch worker was terminated by signal " << WTERMSIG(status)
+                      << std::endl;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failures++;
+    }
+    return failures > 0 || ::errorCount() > 0;
+}
+
+static int compileMain(int argc, char *const argv[]) {
+    // Without libgc, allocate the IR from an arena dropped in one go at exit.
+    IR::NodeArena nodeArena;
+
+    AutoCompileContext autoP4TestContext(new P4TestContext);
+    auto &options = P4TestContext::get().options();
+    options.langVersion = CompilerOptions::FrontendVersion::P4_16;
+    options.compilerVersion = P4TEST_VERSION_STRING;
+
+    auto *remaining = options.process(argc, argv);
+    if (::errorCount() > 0) return 1;
+    if (options.batchFile != nullptr) {
+        if (remaining != nullptr && !remaining->empty()) {
+            error(ErrorType::ERR_UNEXPECTED, "--batch takes the input files from the batch file");
+            return 1;
+        }
+        return runBatch(argv[0], options);
+    }
+    if (remaining != nullptr) {
+        if (!options.loadIRFromJson && !options.loadIRFromBinary) options.setInputFile();
+    }
+    if (::errorCount() > 0) return 1;
+    int status = compile(options);
+    if (Log::verbose()) std::cerr << "Done." << std::endl;
+    return status;
+}
+
+int main(int argc, char *const argv[]) {
+    setup_gc_logging();
+    setup_signals();
+    return P4::CompileServer::main(argc, argv, compileMain);
+}
@@ -238,6 +238,8 @@ bool P4ProgramDCGCreator::preorder(const IR::P4Program *program) {
         // Apply to the arguments.,
         visit(arg);
     }
+    // The DCG is complete, reachability queries no longer need to traverse it.
+    dcg->computeReachability();
     return false;
 }
 
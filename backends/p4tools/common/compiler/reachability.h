@@ -1,6 +1,8 @@
 #ifndef COMMON_COMPILER_REACHABILITY_H_
 #define COMMON_COMPILER_REACHABILITY_H_
 
+#include <algorithm>
+#include <limits>
 #include <list>
 #include <set>
 #include <string>
@@ -14,6 +16,7 @@
 #include "ir/ir.h"
 #include "ir/node.h"
 #include "ir/visitor.h"
+#include "lib/bitvec.h"
 #include "lib/cstring.h"
 #include "lib/null.h"
 
@@ -28,6 +31,112 @@ class ExtendedCallGraph : public P4::CallGraph<T> {
     friend class P4ProgramDCGCreator;
     ReachabilityHashType hash;
 
+    /// Index of each vertex in the bit vectors below, set by @ref computeReachability.
+    std::unordered_map<T, size_t> vertexIds;
+    /// The strongly connected component of each vertex.
+    std::vector<size_t> componentIds;
+    /// The vertices reachable from each component, its own vertices included.
+    std::vector<bitvec> componentReach;
+    /// The class of equivalent vertices of each vertex.
+    std::vector<size_t> classIds;
+    /// The vertices of each class of equivalent vertices.
+    std::vector<bitvec> classMembers;
+
+    /// Groups the vertices into classes of equivalent vertices, as @ref isReachable compares
+    /// nodes with IR::Node::equiv.
+    void computeEquivalenceClasses(const std::vector<T> &vertices) {
+        // A vertex of each class, by node type. Only nodes of the same type can be equivalent.
+        std::unordered_map<cstring, std::vector<size_t>> representatives;
+        classIds.assign(vertices.size(), 0);
+        for (size_t id = 0; id < vertices.size(); id++) {
+            auto &candidates = representatives[vertices[id]->node_type_name()];
+            auto it = std::find_if(candidates.begin(), candidates.end(), [&](size_t candidate) {
+                return vertices[candidate]->equiv(*vertices[id]);
+            });
+            if (it == candidates.end()) {
+                classIds[id] = classMembers.size();
+                classMembers.emplace_back();
+                candidates.push_back(id);
+            } else {
+                classIds[id] = classIds[*it];
+            }
+            classMembers[classIds[id]].setbit(id);
+        }
+    }
+
+    /// Computes @ref componentReach with Tarjan's algorithm, which completes the components in
+    /// reverse topological order. The reach of a component is thus complete once the reach of
+    /// its successors is.
+    void computeComponentReach(const std::vector<T> &vertices) {
+        constexpr size_t UNVISITED = std::numeric_limits<size_t>::max();
+        std::vector<size_t> order(vertices.size(), UNVISITED);
+        std::vector<size_t> lowLink(vertices.size(), 0);
+        std::vector<bool> onStack(vertices.size(), false);
+        std::vector<size_t> componentStack;
+        // The vertices of the depth-first search and the index of their next successor.
+        std::vector<std::pair<size_t, size_t>> callStack;
+        componentIds.assign(vertices.size(), 0);
+        size_t nextOrder = 0;
+        auto successors = [this, &vertices](size_t id) -> const std::vector<T> * {
+            auto edges = this->out_edges.find(vertices[id]);
+            return edges == this->out_edges.end() ? nullptr : edges->second;
+        };
+        for (size_t root = 0; root < vertices.size(); root++) {
+            if (order[root] != UNVISITED) {
+                continue;
+            }
+            callStack.emplace_back(root, 0);
+            while (!callStack.empty()) {
+                auto &[id, edgeIdx] = callStack.back();
+                if (edgeIdx == 0) {
+                    order[id] = lowLink[id] = nextOrder++;
+                    componentStack.push_back(id);
+                    onStack[id] = true;
+                }
+                const auto *edges = successors(id);
+                if (edges != nullptr && edgeIdx < edges->size()) {
+                    auto successor = vertexIds.at(edges->at(edgeIdx++));
+                    if (order[successor] == UNVISITED) {
+                        callStack.emplace_back(successor, 0);
+                    } else if (onStack[successor]) {
+                        lowLink[id] = std::min(lowLink[id], order[successor]);
+                    }
+                    continue;
+                }
+                auto vertex = id;
+                callStack.pop_back();
+                if (!callStack.empty()) {
+                    auto caller = callStack.back().first;
+                    lowLink[caller] = std::min(lowLink[caller], lowLink[vertex]);
+                }
+                if (lowLink[vertex] != order[vertex]) {
+                    continue;
+                }
+                // The vertex is the root of a component, which is on top of the stack.
+                auto componentId = componentReach.size();
+                componentReach.emplace_back();
+                std::vector<size_t> members;
+                do {
+                    members.push_back(componentStack.back());
+                    componentStack.pop_back();
+                    onStack[members.back()] = false;
+                    componentIds[members.back()] = componentId;
+                    componentReach[componentId].setbit(members.back());
+                } while (members.back() != vertex);
+                for (auto member : members) {
+                    if (const auto *edges = successors(member)) {
+                        for (auto successor : *edges) {
+                            auto successorComponent = componentIds[vertexIds.at(successor)];
+                            if (successorComponent != componentId) {
+                                componentReach[componentId] |= componentReach[successorComponent];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
  public:
     explicit ExtendedCallGraph(cstring name) : P4::CallGraph<T>(name) {}
     const ReachabilityHashType &getHash() const { return hash; }
@@ -56,9 +165,30 @@ class ExtendedCallGraph : public P4::CallGraph<T> {
         }
     }
 
+    /// Computes which vertices are reachable from each vertex, so that @ref isReachable tests
+    /// bits instead of traversing the graph. The graph must not change afterwards.
+    void computeReachability() {
+        std::vector<T> vertices(this->nodes.begin(), this->nodes.end());
+        vertexIds.clear();
+        componentReach.clear();
+        classMembers.clear();
+        for (size_t id = 0; id < vertices.size(); id++) {
+            vertexIds.emplace(vertices[id], id);
+        }
+        computeEquivalenceClasses(vertices);
+        computeComponentReach(vertices);
+    }
+
+    /// @returns true if a node equivalent to @p element is reachable from @p start.
     bool isReachable(T start, T element) const {
         CHECK_NULL(start);
         CHECK_NULL(element);
+        auto startId = vertexIds.find(start);
+        auto elementId = vertexIds.find(element);
+        if (startId != vertexIds.end() && elementId != vertexIds.end()) {
+            return componentReach[componentIds[startId->second]].intersects(
+                classMembers[classIds[elementId->second]]);
+        }
         std::set<T> work;
         std::set<T> visited;
         work.emplace(start);
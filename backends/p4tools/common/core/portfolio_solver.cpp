@@ -0,0 +1,148 @@
+#include "backends/p4tools/common/core/portfolio_solver.h"
+
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#ifdef MULTITHREAD
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT linter forbids using chrono, but we don't have alternatives
+#include <exception>
+#include <thread>
+#endif
+
+#include "backends/p4tools/common/core/z3_solver.h"
+#include "ir/json_generator.h"
+#include "ir/solver.h"
+#include "lib/cstring.h"
+#include "lib/exceptions.h"
+
+namespace P4Tools {
+
+/// The timeout which Z3 uses when none is set.
+static constexpr unsigned NO_TIMEOUT = std::numeric_limits<unsigned>::max();
+
+PortfolioSolver::PortfolioSolver(unsigned raceThreshold)
+    : primary(true), secondary(false), raceThreshold(raceThreshold) {}
+
+void PortfolioSolver::comment(cstring comment) {
+    primary.comment(comment);
+    secondary.comment(comment);
+}
+
+void PortfolioSolver::seed(unsigned seed) {
+    primary.seed(seed);
+    secondary.seed(seed + 1);
+}
+
+void PortfolioSolver::timeout(unsigned tm) {
+    primary.timeout(tm);
+    secondary.timeout(tm);
+    timeout_ = tm;
+}
+
+std::optional<bool> PortfolioSolver::checkSat(const std::vector<const Constraint *> &asserts) {
+    lastSolver = nullptr;
+    auto fullTimeout = timeout_.value_or(NO_TIMEOUT);
+    if (raceThreshold >= fullTimeout) {
+        auto result = primary.checkSat(asserts);
+        lastSolver = result.has_value() ? &primary : nullptr;
+        return result;
+    }
+    primary.timeout(raceThreshold);
+    auto result = primary.checkSat(asserts);
+    primary.timeout(fullTimeout);
+    if (result.has_value()) {
+        lastSolver = &primary;
+        return result;
+    }
+    auto answer = race(asserts);
+    if (!answer.has_value()) {
+        return std::nullopt;
+    }
+    lastSolver = answer->first == 0 ? &primary : &secondary;
+    return answer->second;
+}
+
+std::optional<std::pair<size_t, bool>> PortfolioSolver::race(
+    const std::vector<const Constraint *> &asserts) {
+#ifdef MULTITHREAD
+    std::array<Z3Solver *, 2> solvers = {&primary, &secondary};
+    std::array<std::optional<bool>, 2> results;
+    std::atomic<bool> finished[2] = {false, false};
+    std::atomic<int> winner(-1);
+    // Interrupts the check of the solver @p index until it has finished. The check may not have
+    // started yet, in which case an interruption has no effect.
+    auto interruptUntilFinished = [&](size_t index) {
+        while (!finished[index]) {
+            solvers[index]->interrupt();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+    auto check = [&](size_t index) {
+        results[index] = solvers[index]->checkSat(asserts);
+        finished[index] = true;
+        int none = -1;
+        if (results[index].has_value() &&
+            winner.compare_exchange_strong(none, static_cast<int>(index))) {
+            interruptUntilFinished(1 - index);
+        }
+    };
+
+    std::exception_ptr failure;
+    std::thread thread([&]() {
+        try {
+            check(1);
+        } catch (...) {
+            failure = std::current_exception();
+            finished[1] = true;
+        }
+    });
+    try {
+        check(0);
+    } catch (...) {
+        finished[0] = true;
+        interruptUntilFinished(1);
+        thread.join();
+        throw;
+    }
+    thread.join();
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    if (winner < 0) {
+        return std::nullopt;
+    }
+    return std::make_pair(static_cast<size_t>(winner), *results[winner]);
+#else
+    auto result = secondary.checkSat(asserts);
+    if (!result.has_value()) {
+        return std::nullopt;
+    }
+    return std::make_pair(size_t(1), *result);
+#endif  // MULTITHREAD
+}
+
+const SymbolicMapping &PortfolioSolver::getSymbolicMapping() const {
+    BUG_CHECK(lastSolver != nullptr, "PortfolioSolver: the last query has no model");
+    return lastSolver->getSymbolicMapping();
+}
+
+void PortfolioSolver::toJSON(JSONGenerator &json) const { primary.toJSON(json); }
+
+bool PortfolioSolver::isInIncrementalMode() const { return primary.isInIncrementalMode(); }
+
+Z3Solver &PortfolioSolver::getSolver(size_t index) {
+    BUG_CHECK(index < 2, "PortfolioSolver: invalid solver index %1%", index);
+    return index == 0 ? primary : secondary;
+}
+
+void PortfolioSolver::clearMemory() {
+    lastSolver = nullptr;
+    primary.clearMemory();
+    secondary.clearMemory();
+}
+
+}  // namespace P4Tools
@@ -0,0 +1,72 @@
+#ifndef BACKENDS_P4TOOLS_COMMON_CORE_PORTFOLIO_SOLVER_H_
+#define BACKENDS_P4TOOLS_COMMON_CORE_PORTFOLIO_SOLVER_H_
+
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "backends/p4tools/common/core/z3_solver.h"
+#include "ir/json_generator.h"
+#include "ir/solver.h"
+#include "lib/cstring.h"
+#include "lib/rtti.h"
+
+namespace P4Tools {
+
+/// A solver which races two differently configured Z3 solvers on slow queries. Each query is
+/// first checked by the primary solver, an incremental solver, with a timeout of a few
+/// milliseconds. If it times out, the query is checked again by the primary solver and, at the
+/// same time, by the secondary solver, a non-incremental solver with another seed. The first
+/// answer is taken and the other check is interrupted. The model of a query is that of the
+/// solver which answered it. Without MULTITHREAD, only the secondary solver checks the query
+/// again.
+class PortfolioSolver : public AbstractSolver {
+ public:
+    /// @param raceThreshold is the time in milliseconds after which a query is raced.
+    explicit PortfolioSolver(unsigned raceThreshold);
+
+    void comment(cstring comment) override;
+
+    void seed(unsigned seed) override;
+
+    void timeout(unsigned tm) override;
+
+    std::optional<bool> checkSat(const std::vector<const Constraint *> &asserts) override;
+
+    [[nodiscard]] const SymbolicMapping &getSymbolicMapping() const override;
+
+    void toJSON(JSONGenerator &json) const override;
+
+    [[nodiscard]] bool isInIncrementalMode() const override;
+
+    /// @returns the primary solver for @param index 0 and the secondary solver for 1.
+    [[nodiscard]] Z3Solver &getSolver(size_t index);
+
+    /// Clears the memory of both solvers. See Z3Solver::clearMemory.
+    void clearMemory();
+
+    DECLARE_TYPEINFO(PortfolioSolver, AbstractSolver);
+
+ private:
+    /// Checks @param asserts on both solvers at the same time. @returns the index of the solver
+    /// which answered first and its answer, or std::nullopt if neither could.
+    std::optional<std::pair<size_t, bool>> race(const std::vector<const Constraint *> &asserts);
+
+    Z3Solver primary;
+
+    Z3Solver secondary;
+
+    /// The solver which answered the last query, if any.
+    const Z3Solver *lastSolver = nullptr;
+
+    /// The time in milliseconds after which a query is raced.
+    unsigned raceThreshold;
+
+    /// Stores the timeout, as last set by @ref timeout.
+    std::optional<unsigned> timeout_;
+};
+
+}  // namespace P4Tools
+
+#endif /* BACKENDS_P4TOOLS_COMMON_CORE_PORTFOLIO_SOLVER_H_ */
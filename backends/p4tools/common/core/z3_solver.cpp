@@ -4,12 +4,16 @@
 #include <z3_api.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <exception>
 #include <iterator>
+#include <limits>
 #include <map>
+#include <numeric>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <boost/multiprecision/cpp_int.hpp>
 
@@ -30,6 +34,23 @@ namespace P4Tools {
 /// Converts a Z3 expression to a string.
 const char *toString(const z3::expr &e) { return Z3_ast_to_string(e.ctx(), e); }
 
+namespace {
+
+/// Collects the labels of the symbolic variables of an expression.
+class CollectSymbolicVariableLabels : public Inspector {
+    std::vector<cstring> &labels;
+
+ public:
+    explicit CollectSymbolicVariableLabels(std::vector<cstring> &labels) : labels(labels) {}
+
+    bool preorder(const IR::SymbolicVariable *var) override {
+        labels.push_back(var->label);
+        return false;
+    }
+};
+
+}  // namespace
+
 #ifndef NDEBUG
 template <typename... Args>
 std::string stringFormat(const char *format, Args... args) {
@@ -83,6 +104,9 @@ z3::expr Z3Solver::declareVar(const IR::SymbolicVariable &var) {
     // Need to take the reference here to avoid accidental copies.
     auto *latestVars = &declaredVarsById.back();
     latestVars->emplace(expr.id(), &var);
+    if (translatedVariables != nullptr) {
+        translatedVariables->emplace_back(expr.id(), &var);
+    }
     return expr;
 }
 
@@ -91,10 +115,13 @@ void Z3Solver::reset() {
     declaredVarsById.clear();
     checkpoints.clear();
     z3Assertions.resize(0);
+    assumptionGuards.clear();
+    guardIds.clear();
 }
 
 void Z3Solver::clearMemory() {
     auto p4AssertionsBuf = p4Assertions;
+    clearContextCaches();
     reset();
     Z3_finalize_memory();
     z3solver = z3::solver(*new z3::context());
@@ -183,18 +210,119 @@ std::optional<bool> Z3Solver::interpretSolverResult(z3::check_result result) {
     }
 }
 
-std::optional<bool> Z3Solver::checkSat() {
+std::optional<bool> Z3Solver::runCheck(z3::solver &solver, const z3::expr_vector *assumptions) {
     Util::ScopedTimer ctCheckSat("checkSat");
-    return interpretSolverResult(z3solver.check());
+    escalatedModel = std::nullopt;
+    // Checks @p checked and returns the result and whether it ran out of its @p limit.
+    auto check = [this, assumptions](z3::solver &checked, std::optional<unsigned> limit) {
+        auto start = std::chrono::steady_clock::now();
+        auto result = assumptions != nullptr ? checked.check(*assumptions) : checked.check();
+        std::chrono::duration<double, std::milli> duration =
+            std::chrono::steady_clock::now() - start;
+        const auto &bounds = QueryStatistics::BUCKET_BOUNDS;
+        auto bucket = std::upper_bound(bounds.begin(), bounds.end(), duration.count());
+        queryStatistics.histogram[std::distance(bounds.begin(), bucket)]++;
+        queryStatistics.checks++;
+        queryStatistics.milliseconds += duration.count();
+        bool timedOut = result == z3::unknown && limit && duration.count() >= *limit;
+        if (timedOut) {
+            queryStatistics.timeouts++;
+        }
+        return std::make_pair(result, timedOut);
+    };
+    auto [result, timedOut] = check(solver, timeout_);
+    if (!timedOut || !escalationTimeout) {
+        return interpretSolverResult(result);
+    }
+
+    Z3_LOG("escalating a check which ran out of time after %d ms", *escalationTimeout);
+    auto setTimeout = [this](z3::solver &timed, unsigned tm) {
+        z3::params param(ctx());
+        param.set(":timeout", tm);
+        timed.set(param);
+    };
+    auto pipeline = z3::tactic(ctx(), "simplify") & z3::tactic(ctx(), "solve-eqs") &
+                    z3::tactic(ctx(), "bit-blast") & z3::tactic(ctx(), "sat");
+    auto tacticSolver = pipeline.mk_solver();
+    unsigned tacticTimeout = *escalationTimeout * ESCALATION_FACTOR;
+    setTimeout(tacticSolver, tacticTimeout);
+    tacticSolver.add(solver.assertions());
+    if (assumptions != nullptr) {
+        tacticSolver.add(*assumptions);
+    }
+    try {
+        auto start = std::chrono::steady_clock::now();
+        result = tacticSolver.check();
+        std::chrono::duration<double, std::milli> duration =
+            std::chrono::steady_clock::now() - start;
+        queryStatistics.milliseconds += duration.count();
+    } catch (z3::exception &e) {
+        // The pipeline only applies to formulas which bit-blast to propositional logic.
+        Z3_LOG("the tactic pipeline failed: %s", e.msg());
+        result = z3::unknown;
+    }
+    if (result != z3::unknown) {
+        queryStatistics.tacticAnswers++;
+        if (result == z3::sat) {
+            escalatedModel = tacticSolver.get_model();
+        }
+        return interpretSolverResult(result);
+    }
+
+    setTimeout(solver, std::numeric_limits<unsigned>::max());
+    result = check(solver, std::nullopt).first;
+    setTimeout(solver, *timeout_);
+    return interpretSolverResult(result);
+}
+
+std::optional<bool> Z3Solver::checkSat() {
+    unsolvedQuery = std::nullopt;
+    return runCheck(z3solver, nullptr);
 }
 
 std::optional<bool> Z3Solver::checkSat(const z3::expr_vector &asserts) {
-    Util::ScopedTimer ctCheckSat("checkSat");
-    return interpretSolverResult(z3solver.check(asserts));
+    unsolvedQuery = std::nullopt;
+    return runCheck(z3solver, &asserts);
 }
 
 std::optional<bool> Z3Solver::checkSat(const std::vector<const Constraint *> &asserts) {
     Util::ScopedTimer ctZ3("z3");
+    if (useQueryCache) {
+        return checkSatWithQueryCache(asserts);
+    }
+    if (useAssumptions) {
+        return checkSatWithAssumptions(asserts);
+    }
+    return checkSatIncremental(asserts);
+}
+
+std::optional<bool> Z3Solver::checkSatWithAssumptions(
+    const std::vector<const Constraint *> &asserts) {
+    unsolvedQuery = std::nullopt;
+    // The implications must not be popped, so they are asserted outside of any checkpoint.
+    if (!checkpoints.empty() || !p4Assertions.empty()) {
+        reset();
+        p4Assertions.clear();
+    }
+    z3::expr_vector assumptions(ctx());
+    for (const auto *assertion : asserts) {
+        auto it = assumptionGuards.find(assertion);
+        if (it == assumptionGuards.end()) {
+            const auto &expr = translateCached(assertion);
+            auto name = "assumption_guard_" + std::to_string(assumptionGuards.size());
+            auto guard = ctx().bool_const(name.c_str());
+            Z3_LOG("add guarded assertion '%s'", toString(expr));
+            z3solver.add(z3::implies(guard, expr));
+            guardIds.emplace(guard.id());
+            it = assumptionGuards.emplace(assertion, guard).first;
+        }
+        assumptions.push_back(it->second);
+    }
+    Z3_LOG("checking satisfiability for %d assumptions", static_cast<int>(assumptions.size()));
+    return runCheck(z3solver, &assumptions);
+}
+
+std::optional<bool> Z3Solver::checkSatIncremental(const std::vector<const Constraint *> &asserts) {
     if (isIncremental) {
         // Find common prefix with the previous invocation's list of assertions
         auto from = asserts.begin();
@@ -207,6 +335,7 @@ std::optional<bool> Z3Solver::checkSat(const std::vector<const Constraint *> &as
         }
     } else {
         reset();
+        p4Assertions.clear();
     }
     // Push all assertions after (including) the first assertion which differs since the last
     // invocation (or all in case of nonincremental mode).
@@ -219,11 +348,159 @@ std::optional<bool> Z3Solver::checkSat(const std::vector<const Constraint *> &as
     return isIncremental ? checkSat() : checkSat(z3Assertions);
 }
 
+std::optional<bool> Z3Solver::checkSatWithQueryCache(
+    const std::vector<const Constraint *> &asserts) {
+    unsolvedQuery = std::nullopt;
+    queryCacheStatistics.queries++;
+    // Group the constraints which share variables, with a union-find over their indices.
+    std::vector<size_t> parent(asserts.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto findRoot = [&parent](size_t index) {
+        while (parent[index] != index) {
+            parent[index] = parent[parent[index]];
+            index = parent[index];
+        }
+        return index;
+    };
+    std::map<cstring, size_t> firstUse;
+    for (size_t i = 0; i < asserts.size(); ++i) {
+        auto it = constraintVariables.find(asserts[i]);
+        if (it == constraintVariables.end()) {
+            std::vector<cstring> labels;
+            asserts[i]->apply(CollectSymbolicVariableLabels(labels));
+            it = constraintVariables.emplace(asserts[i], std::move(labels)).first;
+        }
+        for (auto label : it->second) {
+            auto [use, inserted] = firstUse.emplace(label, i);
+            if (!inserted) {
+                parent[findRoot(i)] = findRoot(use->second);
+            }
+        }
+    }
+    std::map<size_t, std::vector<const Constraint *>> constraintSets;
+    for (size_t i = 0; i < asserts.size(); ++i) {
+        constraintSets[findRoot(i)].push_back(asserts[i]);
+    }
+    // The query is satisfiable if and only if each set is.
+    for (auto &[root, constraintSet] : constraintSets) {
+        std::sort(constraintSet.begin(), constraintSet.end());
+        constraintSet.erase(std::unique(constraintSet.begin(), constraintSet.end()),
+                            constraintSet.end());
+        auto result = checkConstraintSet(constraintSet);
+        if (!result || !*result) {
+            return result;
+        }
+    }
+    Z3_LOG("query cache: %d assertions in %d independent sets are satisfiable",
+           static_cast<int>(asserts.size()), static_cast<int>(constraintSets.size()));
+    unsolvedQuery = asserts;
+    return true;
+}
+
+std::optional<bool> Z3Solver::checkConstraintSet(
+    const std::vector<const Constraint *> &constraintSet) {
+    queryCacheStatistics.constraintSets++;
+    auto cached = queryCache.find(constraintSet);
+    if (cached != queryCache.end()) {
+        queryCacheStatistics.cacheHits++;
+        return cached->second;
+    }
+    std::vector<z3::expr> exprs;
+    for (const auto *constraint : constraintSet) {
+        exprs.push_back(translateCached(constraint));
+    }
+    // A model which satisfies the constraints shows that they are satisfiable.
+    for (auto &model : recentModels) {
+        if (std::all_of(exprs.begin(), exprs.end(), [&model](const z3::expr &expr) {
+                return model.eval(expr, true).is_true();
+            })) {
+            queryCacheStatistics.modelHits++;
+            queryCache.emplace(constraintSet, true);
+            return true;
+        }
+    }
+    queryCacheStatistics.solverCalls++;
+    z3::solver setSolver(ctx());
+    z3::params param(ctx());
+    if (seed_) {
+        param.set("random_seed", *seed_);
+    }
+    if (timeout_) {
+        param.set(":timeout", *timeout_);
+    }
+    setSolver.set(param);
+    for (const auto &expr : exprs) {
+        setSolver.add(expr);
+    }
+    auto result = runCheck(setSolver, nullptr);
+    if (!result.has_value()) {
+        return result;
+    }
+    queryCache.emplace(constraintSet, *result);
+    if (*result) {
+        recentModels.push_front(escalatedModel ? *escalatedModel : setSolver.get_model());
+        if (recentModels.size() > MAX_RECENT_MODELS) {
+            recentModels.pop_back();
+        }
+    }
+    return result;
+}
+
+const z3::expr &Z3Solver::translateCached(const Constraint *assertion) {
+    // Variables are declared in the topmost context, which may not exist after a reset.
+    if (declaredVarsById.empty()) {
+        declaredVarsById.emplace_back();
+    }
+    auto it = translations.find(assertion);
+    if (it != translations.end()) {
+        // The declarations of the translation may have been popped since.
+        auto &latestVars = declaredVarsById.back();
+        for (const auto &variable : it->second.variables) {
+            latestVars.emplace(variable.first, variable.second);
+        }
+        return it->second.expr;
+    }
+    std::vector<std::pair<unsigned, const IR::SymbolicVariable *>> variables;
+    translatedVariables = &variables;
+    z3::expr expr(ctx());
+    try {
+        Z3Translator z3translator(*this);
+        expr = z3translator.translate(assertion);
+    } catch (...) {
+        translatedVariables = nullptr;
+        throw;
+    }
+    translatedVariables = nullptr;
+    return translations.emplace(assertion, Translation{expr, std::move(variables)})
+        .first->second.expr;
+}
+
+void Z3Solver::clearContextCaches() {
+    translations.clear();
+    recentModels.clear();
+    escalatedModel = std::nullopt;
+}
+
+void Z3Solver::enableQueryCache(bool enable) { useQueryCache = enable; }
+
+void Z3Solver::enableAssumptionLiterals(bool enable) { useAssumptions = enable; }
+
+void Z3Solver::interrupt() { ctx().interrupt(); }
+
+const Z3Solver::QueryCacheStatistics &Z3Solver::getQueryCacheStatistics() const {
+    return queryCacheStatistics;
+}
+
+void Z3Solver::enableTimeoutEscalation(unsigned tm) {
+    escalationTimeout = tm;
+    timeout(tm);
+}
+
+const Z3Solver::QueryStatistics &Z3Solver::getQueryStatistics() const { return queryStatistics; }
+
 void Z3Solver::asrt(const Constraint *assertion) {
     CHECK_NULL(assertion);
-    Z3Translator z3translator(*this);
-    auto expr = z3translator.translate(assertion);
-    asrt(expr);
+    asrt(translateCached(assertion));
     p4Assertions.push_back(assertion);
     BUG_CHECK(isIncremental || z3Assertions.size() == p4Assertions.size(),
               "Number of assertion in P4 and Z3 formats aren't equal");
@@ -244,6 +521,15 @@ void Z3Solver::asrt(const z3::expr &assertion) {
 
 const SymbolicMapping &Z3Solver::getSymbolicMapping() const {
     Util::ScopedTimer ctZ3("z3");
+    if (unsolvedQuery.has_value()) {
+        // The query cache answered the last query without Z3, which has to solve it for a model.
+        auto query = *unsolvedQuery;
+        auto *solver = const_cast<Z3Solver *>(this);
+        auto result = useAssumptions ? solver->checkSatWithAssumptions(query)
+                                     : solver->checkSatIncremental(query);
+        BUG_CHECK(result.value_or(false),
+                  "Z3Solver: Z3 could not solve a query that the query cache found satisfiable");
+    }
     auto *result = new SymbolicMapping();
     // First, collect a map of all the declared variables we have encountered in the stack.
     std::map<unsigned int, const IR::SymbolicVariable *> declaredVars;
@@ -256,7 +542,7 @@ const SymbolicMapping &Z3Solver::getSymbolicMapping() const {
     // Then, get the model and match each declaration in the model to its IR::SymbolicVariable.
     try {
         Util::ScopedTimer ctCheckSat("getModel");
-        auto z3Model = z3solver.get_model();
+        auto z3Model = escalatedModel ? *escalatedModel : z3solver.get_model();
         Z3_LOG("z3 model:%s", toString(z3Model));
 
         // Loop through each declaration in the Z3 model and convert to the output model.
@@ -270,6 +556,11 @@ const SymbolicMapping &Z3Solver::getSymbolicMapping() const {
 
             // Convert to a symbolic variable and value.
             auto exprId = z3Expr.id();
+            // The model of the tactic pipeline may also define the variables it introduced.
+            if (guardIds.count(exprId) > 0 ||
+                (escalatedModel && declaredVars.count(exprId) == 0)) {
+                continue;
+            }
             BUG_CHECK(declaredVars.count(exprId) > 0, "Z3Solver: unknown variable declaration: %1%",
                       z3Expr);
             const auto *symbolicVar = declaredVars.at(exprId);
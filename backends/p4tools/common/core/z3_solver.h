@@ -3,10 +3,17 @@
 
 #include <z3++.h>
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <iosfwd>
+#include <map>
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "ir/ir.h"
@@ -25,6 +32,17 @@ namespace P4Tools {
 using Z3DeclaredVariablesMap = std::vector<ordered_map<unsigned, const IR::SymbolicVariable *>>;
 
 /// A Z3-based implementation of AbstractSolver. Encapsulates a z3::solver and a z3::context.
+///
+/// With the query cache enabled, a query is split into sets of constraints that share no
+/// variables, which are satisfiable independently of each other. The result of each set is
+/// cached, and a set is checked against the models of recently solved sets before Z3 is
+/// called. When a query is answered this way, Z3 is only called on the whole query once its
+/// model is requested.
+///
+/// With assumption literals enabled, each constraint is asserted once as an implication from a
+/// fresh boolean guard, and a query is checked by assuming the guards of its constraints. Moving
+/// to another path then neither pops nor re-asserts constraints, and Z3 keeps what it learned
+/// from previous queries.
 class Z3Solver : public AbstractSolver {
     friend class Z3Translator;
     friend class Z3JSON;
@@ -33,6 +51,37 @@ class Z3Solver : public AbstractSolver {
  public:
     ~Z3Solver() override = default;
 
+    /// Counters of the query cache.
+    struct QueryCacheStatistics {
+        /// Number of calls to checkSat with a list of constraints.
+        uint64_t queries = 0;
+        /// Number of independent sets of constraints these queries were split into.
+        uint64_t constraintSets = 0;
+        /// Number of sets whose result was cached.
+        uint64_t cacheHits = 0;
+        /// Number of sets satisfied by the model of a recently solved set.
+        uint64_t modelHits = 0;
+        /// Number of sets solved by Z3.
+        uint64_t solverCalls = 0;
+    };
+
+    /// Counters of the checks run on Z3.
+    struct QueryStatistics {
+        /// Upper bounds, in milliseconds, of the buckets of @ref histogram. The last bucket
+        /// counts the slower checks.
+        static constexpr std::array<double, 4> BUCKET_BOUNDS = {1, 10, 100, 1000};
+        /// Number of checks run on Z3, escalations included.
+        uint64_t checks = 0;
+        /// Total duration of the checks, in milliseconds.
+        double milliseconds = 0;
+        /// Number of checks in each bucket of durations.
+        std::array<uint64_t, BUCKET_BOUNDS.size() + 1> histogram = {};
+        /// Number of checks which ran out of time.
+        uint64_t timeouts = 0;
+        /// Number of these checks which the tactic pipeline of an escalation answered.
+        uint64_t tacticAnswers = 0;
+    };
+
     explicit Z3Solver(bool isIncremental = true,
                       std::optional<std::istream *> inOpt = std::nullopt);
 
@@ -67,6 +116,27 @@ class Z3Solver : public AbstractSolver {
     /// @returns the list of active assertions on this solver.
     [[nodiscard]] safe_vector<const Constraint *> getAssertions() const;
 
+    /// Enables or disables the query cache. It is disabled by default.
+    void enableQueryCache(bool enable);
+
+    [[nodiscard]] const QueryCacheStatistics &getQueryCacheStatistics() const;
+
+    /// Enables or disables solving with assumption literals. It is disabled by default.
+    void enableAssumptionLiterals(bool enable);
+
+    /// Gives each check @p tm milliseconds. A check which runs out of time is escalated: it is
+    /// retried with a `simplify; solve-eqs; bit-blast; sat` tactic pipeline, which solves many
+    /// bit-vector queries such as checksums much faster, for ESCALATION_FACTOR times as long,
+    /// and then without timeout. Escalation thus never changes the answer of a check.
+    void enableTimeoutEscalation(unsigned tm);
+
+    /// @returns the counters of the checks run on Z3.
+    [[nodiscard]] const QueryStatistics &getQueryStatistics() const;
+
+    /// Interrupts a check which runs on another thread, which then returns std::nullopt. Does
+    /// nothing if no check is running.
+    void interrupt();
+
     /// Resets the internal state: pops all assertions from previous solver
     /// invocation, removes variable declarations.
     void reset();
@@ -113,6 +183,30 @@ class Z3Solver : public AbstractSolver {
     /// Helps to restore a state of incremental solver in a constructor.
     void addZ3Pushes(size_t &chkIndex, size_t asrtIndex);
 
+    /// Checks @param asserts on the Z3 solver, reusing the assertions of the previous check.
+    std::optional<bool> checkSatIncremental(const std::vector<const Constraint *> &asserts);
+
+    /// Checks @param asserts by splitting them into independent sets of constraints, which are
+    /// looked up in the query cache or checked separately.
+    std::optional<bool> checkSatWithQueryCache(const std::vector<const Constraint *> &asserts);
+
+    /// Checks @param asserts by assuming the guards of the constraints on @ref z3solver.
+    std::optional<bool> checkSatWithAssumptions(const std::vector<const Constraint *> &asserts);
+
+    /// Checks a set of constraints which share variables, without modifying @ref z3solver.
+    std::optional<bool> checkConstraintSet(const std::vector<const Constraint *> &constraintSet);
+
+    /// @returns the Z3 translation of @param assertion, which is cached. The variables of the
+    /// translation are declared in the topmost set of @ref declaredVarsById.
+    const z3::expr &translateCached(const Constraint *assertion);
+
+    /// Forgets the Z3 expressions and models which belong to the current context.
+    void clearContextCaches();
+
+    /// Checks @p solver, under @p assumptions if not null, records the check in
+    /// @ref queryStatistics, and escalates it if it runs out of time.
+    std::optional<bool> runCheck(z3::solver &solver, const z3::expr_vector *assumptions);
+
     /// Helper function which converts a z3::check_result to a std::optional<bool>.
     static std::optional<bool> interpretSolverResult(z3::check_result result);
 
@@ -137,12 +231,68 @@ class Z3Solver : public AbstractSolver {
     /// The Z3 counterpart to @ref p4Assertions. This is only used when @a isIncremental is false.
     z3::expr_vector z3Assertions;
 
+    /// The Z3 translation of a constraint, with the variables declared while translating it.
+    struct Translation {
+        z3::expr expr;
+        std::vector<std::pair<unsigned, const IR::SymbolicVariable *>> variables;
+    };
+
+    /// The translation of each constraint asserted or checked in the current context. IR nodes
+    /// are immutable, so a constraint is only translated once until the context is reset.
+    std::unordered_map<const Constraint *, Translation> translations;
+
+    /// The variables declared by the translation in progress in @ref translateCached, if any.
+    std::vector<std::pair<unsigned, const IR::SymbolicVariable *>> *translatedVariables =
+        nullptr;
+
     /// Stores the RNG seed, as last set by @ref seed.
     std::optional<unsigned> seed_;
 
     /// Stores the timeout, as last set by @ref timeout.
     std::optional<unsigned> timeout_;
 
+    /// Maximum number of models of recently solved sets of constraints that are kept.
+    static constexpr size_t MAX_RECENT_MODELS = 16;
+
+    /// Whether the query cache is enabled.
+    bool useQueryCache = false;
+
+    /// Results of sets of constraints, by the constraints of the set sorted by address. Timeouts
+    /// are not cached.
+    std::map<std::vector<const Constraint *>, bool> queryCache;
+
+    /// The labels of the symbolic variables of each constraint.
+    std::unordered_map<const Constraint *, std::vector<cstring>> constraintVariables;
+
+    /// Models of recently solved sets of constraints, most recent first.
+    std::deque<z3::model> recentModels;
+
+    /// The last query, if it was found satisfiable without checking it on @ref z3solver. It is
+    /// checked when its model is requested.
+    std::optional<std::vector<const Constraint *>> unsolvedQuery;
+
+    QueryCacheStatistics queryCacheStatistics;
+
+    /// Factor by which the timeout of the tactic pipeline exceeds the timeout of a check.
+    static constexpr unsigned ESCALATION_FACTOR = 4;
+
+    /// The timeout of a check, if out of time checks are escalated.
+    std::optional<unsigned> escalationTimeout;
+
+    QueryStatistics queryStatistics;
+
+    /// The model of the last check, if the tactic pipeline of an escalation answered it.
+    std::optional<z3::model> escalatedModel;
+
+    /// Whether queries are checked with assumption literals.
+    bool useAssumptions = false;
+
+    /// The literal which guards each constraint asserted as an implication on @ref z3solver.
+    std::unordered_map<const Constraint *, z3::expr> assumptionGuards;
+
+    /// The Z3 expression IDs of the guards, which are not variables of the program.
+    std::unordered_set<unsigned> guardIds;
+
     DECLARE_TYPEINFO(Z3Solver, AbstractSolver);
 };
 
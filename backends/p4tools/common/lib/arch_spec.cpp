@@ -8,11 +8,11 @@ namespace P4Tools {
 
 ArchSpec::ArchSpec(cstring packageName, const std::vector<ArchMember> &archVectorInput)
     : packageName(packageName) {
+    archVector.reserve(archVectorInput.size());
     for (size_t idx = 0; idx < archVectorInput.size(); ++idx) {
-        auto archMember = archVectorInput.at(idx);
+        const auto &archMember = archVectorInput.at(idx);
         archVector.emplace_back(archMember);
-        auto blockName = archMember.blockName;
-        blockIndices[blockName] = idx;
+        blockIndices[archMember.blockName] = idx;
     }
 }
 
@@ -26,7 +26,7 @@ size_t ArchSpec::getBlockIndex(cstring blockName) const {
 
 cstring ArchSpec::getParamName(cstring blockName, size_t paramIndex) const {
     auto blockIndex = getBlockIndex(blockName);
-    auto params = archVector.at(blockIndex).blockParams;
+    const auto &params = archVector.at(blockIndex).blockParams;
     BUG_CHECK(paramIndex < params.size(), "Param index %s out of range. Vector size: %s",
               paramIndex, params.size());
     return params.at(paramIndex);
@@ -35,7 +35,7 @@ cstring ArchSpec::getParamName(cstring blockName, size_t paramIndex) const {
 cstring ArchSpec::getParamName(size_t blockIndex, size_t paramIndex) const {
     BUG_CHECK(blockIndex < archVector.size(), "Block index %s out of range. Vector size: %s",
               blockIndex, archVector.size());
-    auto params = archVector.at(blockIndex).blockParams;
+    const auto &params = archVector.at(blockIndex).blockParams;
     BUG_CHECK(paramIndex < params.size(), "Param index %s out of range. Vector size: %s",
               paramIndex, params.size());
     return params.at(paramIndex);
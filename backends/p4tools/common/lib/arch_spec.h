@@ -2,10 +2,10 @@
 #define BACKENDS_P4TOOLS_COMMON_LIB_ARCH_SPEC_H_
 
 #include <cstddef>
-#include <map>
 #include <vector>
 
 #include "lib/cstring.h"
+#include "lib/hvec_map.h"
 
 namespace P4Tools {
 
@@ -27,7 +27,7 @@ class ArchSpec {
 
     /// Keeps track of the block indices in the architecture specification.
     /// This is useful to lookup the index for a particular block label.
-    std::map<cstring, size_t> blockIndices;
+    hvec_map<cstring, size_t> blockIndices;
 
  public:
     explicit ArchSpec(cstring packageName, const std::vector<ArchMember> &archVectorInput);
@@ -0,0 +1,244 @@
+#include "backends/p4tools/common/lib/conflict_check.h"
+
+#include <algorithm>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+#include "backends/p4tools/common/lib/taint.h"
+#include "ir/ir.h"
+#include "ir/solver.h"
+#include "lib/big_int_util.h"
+
+namespace P4Tools {
+
+namespace {
+
+/// The maximum number of values of a range whose values are checked one by one against the
+/// excluded values.
+constexpr int MAX_ENUMERATED_RANGE = 64;
+
+/// A comparison of a term with a constant. Strict comparisons are turned into non-strict ones.
+struct Atom {
+    enum class Relation { Equ, Neq, Leq, Geq };
+
+    const IR::Expression *term;
+    Relation relation;
+    big_int value;
+};
+
+/// What the constraints imply about the value of a term.
+struct Fact {
+    const IR::Expression *term;
+    big_int low;
+    big_int high;
+    std::optional<big_int> value;
+    std::set<big_int> excluded;
+
+    explicit Fact(const IR::Expression *term) : term(term), low(0) {
+        if (const auto *bits = term->type->to<IR::Type_Bits>()) {
+            high = (big_int(1) << bits->width_bits()) - 1;
+        } else {
+            high = 1;
+        }
+    }
+
+    /// Adds @param atom to the fact. @returns false if the fact becomes contradictory.
+    bool add(const Atom &atom) {
+        switch (atom.relation) {
+            case Atom::Relation::Equ:
+                if (value.has_value() && *value != atom.value) {
+                    return false;
+                }
+                value = atom.value;
+                break;
+            case Atom::Relation::Neq:
+                excluded.insert(atom.value);
+                break;
+            case Atom::Relation::Leq:
+                high = std::min(high, atom.value);
+                break;
+            case Atom::Relation::Geq:
+                low = std::max(low, atom.value);
+                break;
+        }
+        if (low > high) {
+            return false;
+        }
+        if (value.has_value()) {
+            return *value >= low && *value <= high && excluded.count(*value) == 0;
+        }
+        // Check whether the excluded values cover the whole range.
+        if (high - low < MAX_ENUMERATED_RANGE && excluded.size() > high - low) {
+            for (auto candidate = low; candidate <= high; ++candidate) {
+                if (excluded.count(candidate) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        return true;
+    }
+};
+
+/// @returns whether the values of @param type can be compared as unsigned integers.
+bool isComparable(const IR::Type *type) {
+    if (const auto *bits = type->to<IR::Type_Bits>()) {
+        return !bits->isSigned;
+    }
+    return type->is<IR::Type_Boolean>();
+}
+
+/// @returns @param relation, or its negation if @param negated is true, as a comparison of a
+/// term with a constant, if it is one.
+std::optional<Atom> toComparison(const IR::Operation_Relation *relation, bool negated) {
+    using Relation = Atom::Relation;
+    const auto *term = relation->left;
+    const IR::Expression *constant = relation->right;
+    auto isConstant = [](const IR::Expression *e) {
+        return e->is<IR::Constant>() || e->is<IR::BoolLiteral>();
+    };
+    // Put the constant on the right, which mirrors the relation.
+    bool mirrored = false;
+    if (!isConstant(constant)) {
+        std::swap(term, constant);
+        mirrored = true;
+    }
+    if (!isConstant(constant) || isConstant(term) || !isComparable(term->type) ||
+        Taint::hasTaint(term)) {
+        return std::nullopt;
+    }
+    big_int value;
+    if (const auto *boolLiteral = constant->to<IR::BoolLiteral>()) {
+        value = boolLiteral->value ? 1 : 0;
+    } else {
+        value = constant->checkedTo<IR::Constant>()->value;
+    }
+    // Z3 compares bit vectors modulo their width, and so does this check.
+    if (const auto *bits = term->type->to<IR::Type_Bits>()) {
+        big_int modulus = big_int(1) << bits->width_bits();
+        value = ((value % modulus) + modulus) % modulus;
+    }
+    // Turn the relation into "term <relation> value".
+    std::optional<Atom> atom;
+    if (relation->is<IR::Equ>()) {
+        atom = Atom{term, Relation::Equ, value};
+    } else if (relation->is<IR::Neq>()) {
+        atom = Atom{term, Relation::Neq, value};
+    } else if (relation->is<IR::Lss>()) {
+        atom = mirrored ? Atom{term, Relation::Geq, value + 1}
+                        : Atom{term, Relation::Leq, value - 1};
+    } else if (relation->is<IR::Leq>()) {
+        atom = Atom{term, mirrored ? Relation::Geq : Relation::Leq, value};
+    } else if (relation->is<IR::Grt>()) {
+        atom = mirrored ? Atom{term, Relation::Leq, value - 1}
+                        : Atom{term, Relation::Geq, value + 1};
+    } else if (relation->is<IR::Geq>()) {
+        atom = Atom{term, mirrored ? Relation::Leq : Relation::Geq, value};
+    }
+    if (atom.has_value() && negated) {
+        switch (atom->relation) {
+            case Relation::Equ:
+                atom->relation = Relation::Neq;
+                break;
+            case Relation::Neq:
+                atom->relation = Relation::Equ;
+                break;
+            case Relation::Leq:
+                atom = Atom{term, Relation::Geq, atom->value + 1};
+                break;
+            case Relation::Geq:
+                atom = Atom{term, Relation::Leq, atom->value - 1};
+                break;
+        }
+    }
+    return atom;
+}
+
+/// @returns the comparison of @param expr, or its negation if @param negated is true, with a
+/// constant.
+std::optional<Atom> toAtom(const IR::Expression *expr, bool negated) {
+    if (const auto *relation = expr->to<IR::Operation_Relation>()) {
+        if (auto atom = toComparison(relation, negated)) {
+            return atom;
+        }
+    }
+    // Any other boolean expression is compared with true.
+    if (expr->type->is<IR::Type_Boolean>() && !expr->is<IR::BoolLiteral>() &&
+        !Taint::hasTaint(expr)) {
+        return Atom{expr, Atom::Relation::Equ, negated ? 0 : 1};
+    }
+    return std::nullopt;
+}
+
+/// Appends the comparisons of the conjunction @param expr, or of its negation if @param
+/// negated is true, to @param atoms.
+void collectAtoms(const IR::Expression *expr, bool negated, std::vector<Atom> &atoms) {
+    if (const auto *lNot = expr->to<IR::LNot>()) {
+        collectAtoms(lNot->expr, !negated, atoms);
+        return;
+    }
+    // The negation of a disjunction is the conjunction of the negations.
+    const IR::Operation_Binary *conjunction = nullptr;
+    if (!negated) {
+        conjunction = expr->to<IR::LAnd>();
+    } else {
+        conjunction = expr->to<IR::LOr>();
+    }
+    if (conjunction != nullptr) {
+        collectAtoms(conjunction->left, negated, atoms);
+        collectAtoms(conjunction->right, negated, atoms);
+        return;
+    }
+    if (auto atom = toAtom(expr, negated)) {
+        atoms.push_back(*atom);
+    }
+}
+
+}  // namespace
+
+bool ConflictCheck::contradicts(const std::vector<const Constraint *> &pathConstraint,
+                                const Constraint *constraint) {
+    std::vector<Atom> atoms;
+    collectAtoms(constraint, false, atoms);
+    if (atoms.empty()) {
+        return false;
+    }
+    // Only the terms of the constraint are tracked, as the other constraints are satisfiable.
+    std::vector<Fact> facts;
+    auto findFact = [&facts](const IR::Expression *term) -> Fact * {
+        for (auto &fact : facts) {
+            if (fact.term == term || fact.term->equiv(*term)) {
+                return &fact;
+            }
+        }
+        return nullptr;
+    };
+    for (const auto &atom : atoms) {
+        auto *fact = findFact(atom.term);
+        if (fact == nullptr) {
+            fact = &facts.emplace_back(atom.term);
+        }
+        if (!fact->add(atom)) {
+            return true;
+        }
+    }
+    for (const auto *other : pathConstraint) {
+        if (other == constraint) {
+            continue;
+        }
+        atoms.clear();
+        collectAtoms(other, false, atoms);
+        for (const auto &atom : atoms) {
+            auto *fact = findFact(atom.term);
+            if (fact != nullptr && !fact->add(atom)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+}  // namespace P4Tools
@@ -0,0 +1,27 @@
+#ifndef BACKENDS_P4TOOLS_COMMON_LIB_CONFLICT_CHECK_H_
+#define BACKENDS_P4TOOLS_COMMON_LIB_CONFLICT_CHECK_H_
+
+#include <vector>
+
+#include "ir/ir.h"
+#include "ir/solver.h"
+
+namespace P4Tools {
+
+/// A cheap check for contradictions in path constraints, which can spare a call to the solver.
+/// The check only looks at comparisons of an expression with a constant, such as "x == 1",
+/// "x != 2" or "x < 3", in conjunctions of constraints. It keeps the range, the value and the
+/// excluded values of each compared expression. The check is sound, but far from complete:
+/// comparisons of signed or tainted expressions are ignored, and a constraint without a
+/// contradiction may still be unsatisfiable.
+class ConflictCheck {
+ public:
+    /// @returns true if @param constraint contradicts itself or the other constraints
+    /// of @param pathConstraint, which are assumed to be satisfiable together.
+    static bool contradicts(const std::vector<const Constraint *> &pathConstraint,
+                            const Constraint *constraint);
+};
+
+}  // namespace P4Tools
+
+#endif /* BACKENDS_P4TOOLS_COMMON_LIB_CONFLICT_CHECK_H_ */
@@ -284,15 +284,9 @@ std::vector<uint8_t> convertBigIntToBytes(const big_int &dataInt, int targetWidt
     boost::multiprecision::export_bits(dataInt, std::back_inserter(bytes), chunkSize);
     // If the number of bytes produced by the export is lower than the desired width pad the byte
     // array with zeroes.
-    auto diff = targetWidthBytes - bytes.size();
-    if (targetWidthBytes > bytes.size() && diff > 0UL) {
-        for (size_t i = 0; i < diff; ++i) {
-            if (padLeft) {
-                bytes.insert(bytes.begin(), 0);
-            } else {
-                bytes.push_back(0);
-            }
-        }
+    if (targetWidthBytes > bytes.size()) {
+        auto diff = targetWidthBytes - bytes.size();
+        bytes.insert(padLeft ? bytes.begin() : bytes.end(), diff, 0);
     }
     return bytes;
 }
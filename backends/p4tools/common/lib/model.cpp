@@ -1,5 +1,6 @@
 #include "backends/p4tools/common/lib/model.h"
 
+#include <optional>
 #include <ostream>
 #include <string>
 #include <utility>
@@ -10,12 +11,229 @@
 #include "ir/indexed_vector.h"
 #include "ir/irutils.h"
 #include "ir/vector.h"
+#include "lib/big_int_util.h"
 #include "lib/cstring.h"
 #include "lib/exceptions.h"
 #include "lib/log.h"
 
 namespace P4Tools {
 
+namespace {
+
+/// Folds expressions over bit vectors, integers, and booleans directly to their values in a
+/// model, without substituting the variables of the expression with new IR first. Booleans are
+/// represented as 0 and 1. Expressions which the evaluator does not support yield std::nullopt,
+/// in which case the caller falls back to substitution and constant folding.
+class ValueEvaluator {
+    const SymbolicMapping &symbolicMap;
+
+    /// @returns @param value wrapped into the range of @param type, or std::nullopt if the type
+    /// is not a bit vector, an integer, or a boolean.
+    static std::optional<big_int> wrap(const IR::Type *type, big_int value) {
+        if (type->is<IR::Type_InfInt>()) {
+            return value;
+        }
+        if (type->is<IR::Type_Boolean>()) {
+            return big_int(value != 0 ? 1 : 0);
+        }
+        const auto *bitType = type->to<IR::Type_Bits>();
+        if (bitType == nullptr) {
+            return std::nullopt;
+        }
+        auto width = bitType->width_bits();
+        value &= Util::mask(width);
+        if (bitType->isSigned && width > 0 && boost::multiprecision::bit_test(value, width - 1)) {
+            value -= big_int(1) << width;
+        }
+        return value;
+    }
+
+    /// @returns the value of the bit vector @param expr, represented as unsigned bit vector.
+    std::optional<big_int> evaluateUnsigned(const IR::Expression *expr) const {
+        if (!expr->type->is<IR::Type_Bits>()) {
+            return std::nullopt;
+        }
+        auto value = evaluate(expr);
+        if (!value.has_value()) {
+            return std::nullopt;
+        }
+        return value.value() & Util::mask(expr->type->width_bits());
+    }
+
+    std::optional<big_int> evaluateBinary(const IR::Operation_Binary *binary) const {
+        auto left = evaluate(binary->left);
+        if (!left.has_value()) {
+            return std::nullopt;
+        }
+        // Short-circuit the logical operators, the right operand does not need to be bound.
+        if (binary->is<IR::LAnd>() && left.value() == 0) {
+            return big_int(0);
+        }
+        if (binary->is<IR::LOr>() && left.value() != 0) {
+            return big_int(1);
+        }
+        // Bitwise operators work on the unsigned representation of their operands.
+        if (binary->is<IR::Concat>() || binary->is<IR::BAnd>() || binary->is<IR::BOr>() ||
+            binary->is<IR::BXor>()) {
+            auto leftBits = evaluateUnsigned(binary->left);
+            auto rightBits = evaluateUnsigned(binary->right);
+            if (!leftBits.has_value() || !rightBits.has_value()) {
+                return std::nullopt;
+            }
+            const auto &l = leftBits.value();
+            const auto &r = rightBits.value();
+            if (binary->is<IR::Concat>()) {
+                return wrap(binary->type, (l << binary->right->type->width_bits()) | r);
+            }
+            if (binary->is<IR::BAnd>()) {
+                return wrap(binary->type, l & r);
+            }
+            if (binary->is<IR::BOr>()) {
+                return wrap(binary->type, l | r);
+            }
+            return wrap(binary->type, l ^ r);
+        }
+        auto right = evaluate(binary->right);
+        if (!right.has_value()) {
+            return std::nullopt;
+        }
+        const auto &l = left.value();
+        const auto &r = right.value();
+        if (binary->is<IR::LAnd>() || binary->is<IR::LOr>()) {
+            return big_int(r != 0 ? 1 : 0);
+        }
+        if (binary->is<IR::Equ>()) {
+            return big_int(l == r ? 1 : 0);
+        }
+        if (binary->is<IR::Neq>()) {
+            return big_int(l != r ? 1 : 0);
+        }
+        if (binary->is<IR::Lss>()) {
+            return big_int(l < r ? 1 : 0);
+        }
+        if (binary->is<IR::Leq>()) {
+            return big_int(l <= r ? 1 : 0);
+        }
+        if (binary->is<IR::Grt>()) {
+            return big_int(l > r ? 1 : 0);
+        }
+        if (binary->is<IR::Geq>()) {
+            return big_int(l >= r ? 1 : 0);
+        }
+        if (binary->is<IR::Add>()) {
+            return wrap(binary->type, l + r);
+        }
+        if (binary->is<IR::Sub>()) {
+            return wrap(binary->type, l - r);
+        }
+        if (binary->is<IR::Mul>()) {
+            return wrap(binary->type, l * r);
+        }
+        // Shifts by more than the width of the type yield 0, like shifts by the width. Shifts of
+        // negative values are left to constant folding.
+        if (binary->is<IR::Shl>() || binary->is<IR::Shr>()) {
+            const auto *bitType = binary->type->to<IR::Type_Bits>();
+            if (bitType == nullptr || l < 0 || r < 0) {
+                return std::nullopt;
+            }
+            auto shift = static_cast<unsigned>(r > bitType->width_bits() ? bitType->width_bits()
+                                                                          : static_cast<int>(r));
+            if (binary->is<IR::Shl>()) {
+                return wrap(binary->type, l << shift);
+            }
+            return wrap(binary->type, l >> shift);
+        }
+        // Division, modulo, and saturating arithmetic are left to constant folding.
+        return std::nullopt;
+    }
+
+ public:
+    explicit ValueEvaluator(const SymbolicMapping &symbolicMap) : symbolicMap(symbolicMap) {}
+
+    /// @returns the value of @param expr, or std::nullopt if the expression is not supported.
+    std::optional<big_int> evaluate(const IR::Expression *expr) const {
+        if (const auto *constant = expr->to<IR::Constant>()) {
+            return wrap(expr->type, constant->value);
+        }
+        if (const auto *boolLiteral = expr->to<IR::BoolLiteral>()) {
+            return big_int(boolLiteral->value ? 1 : 0);
+        }
+        if (const auto *symbolicVar = expr->to<IR::SymbolicVariable>()) {
+            auto varIt = symbolicMap.find(symbolicVar);
+            // Unbound variables are completed or reported by the substitution.
+            if (varIt == symbolicMap.end()) {
+                return std::nullopt;
+            }
+            return evaluate(varIt->second);
+        }
+        if (expr->is<IR::TaintExpression>()) {
+            return wrap(expr->type, 0);
+        }
+        if (const auto *binary = expr->to<IR::Operation_Binary>()) {
+            return evaluateBinary(binary);
+        }
+        if (const auto *slice = expr->to<IR::Slice>()) {
+            auto value = evaluateUnsigned(slice->e0);
+            if (!value.has_value() || !slice->e1->is<IR::Constant>() ||
+                !slice->e2->is<IR::Constant>()) {
+                return std::nullopt;
+            }
+            return wrap(expr->type, value.value() >> slice->getL());
+        }
+        if (const auto *mux = expr->to<IR::Mux>()) {
+            // Only the selected operand is evaluated.
+            auto condition = evaluate(mux->e0);
+            if (!condition.has_value()) {
+                return std::nullopt;
+            }
+            return evaluate(condition.value() != 0 ? mux->e1 : mux->e2);
+        }
+        if (const auto *cast = expr->to<IR::Cast>()) {
+            auto value = evaluate(cast->expr);
+            if (!value.has_value() || cast->expr->type->is<IR::Type_InfInt>() !=
+                                          cast->destType->is<IR::Type_InfInt>()) {
+                return std::nullopt;
+            }
+            return wrap(cast->destType, value.value());
+        }
+        if (const auto *unary = expr->to<IR::Operation_Unary>()) {
+            if (unary->is<IR::Cmpl>()) {
+                auto value = evaluateUnsigned(unary->expr);
+                if (!value.has_value()) {
+                    return std::nullopt;
+                }
+                return wrap(expr->type, Util::mask(expr->type->width_bits()) ^ value.value());
+            }
+            if (!unary->is<IR::LNot>() && !unary->is<IR::Neg>()) {
+                return std::nullopt;
+            }
+            auto value = evaluate(unary->expr);
+            if (!value.has_value()) {
+                return std::nullopt;
+            }
+            if (unary->is<IR::LNot>()) {
+                return big_int(value.value() == 0 ? 1 : 0);
+            }
+            return wrap(expr->type, -value.value());
+        }
+        return std::nullopt;
+    }
+
+    /// @returns the literal of type @param type with the value @param value, or nullptr if the
+    /// type has no literal.
+    static const IR::Literal *toLiteral(const IR::Type *type, const big_int &value) {
+        if (type->is<IR::Type_Boolean>()) {
+            return IR::getBoolLiteral(value != 0);
+        }
+        if (type->is<IR::Type_Bits>() || type->is<IR::Type_InfInt>()) {
+            return IR::getConstant(type, value);
+        }
+        return nullptr;
+    }
+};
+
+}  // namespace
+
 Model::SubstVisitor::SubstVisitor(const Model &model, bool doComplete)
     : self(model), doComplete(doComplete) {}
 
@@ -82,9 +300,17 @@ const IR::BaseListExpression *Model::evaluateListExpr(const IR::BaseListExpressi
 
 const IR::Literal *Model::evaluate(const IR::Expression *expr, bool doComplete,
                                    ExpressionMap *resolvedExpressions) const {
-    const auto *substituted = expr->apply(SubstVisitor(*this, doComplete));
-    const auto *evaluated = P4::optimizeExpression(substituted);
-    const auto *literal = evaluated->checkedTo<IR::Literal>();
+    const IR::Literal *literal = nullptr;
+    // Most expressions fold directly to a value. Only build the literal of the result.
+    auto value = ValueEvaluator(symbolicMap).evaluate(expr);
+    if (value.has_value()) {
+        literal = ValueEvaluator::toLiteral(expr->type, value.value());
+    }
+    if (literal == nullptr) {
+        const auto *substituted = expr->apply(SubstVisitor(*this, doComplete));
+        const auto *evaluated = P4::optimizeExpression(substituted);
+        literal = evaluated->checkedTo<IR::Literal>();
+    }
     // Add the variable to the resolvedExpressions list, if the list is not null.
     if (resolvedExpressions != nullptr) {
         (*resolvedExpressions)[expr] = literal;
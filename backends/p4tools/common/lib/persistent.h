@@ -0,0 +1,206 @@
+#ifndef BACKENDS_P4TOOLS_COMMON_LIB_PERSISTENT_H_
+#define BACKENDS_P4TOOLS_COMMON_LIB_PERSISTENT_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "lib/exceptions.h"
+
+namespace P4Tools {
+
+/// An append-only vector whose copies share their elements. The elements are stored in chunks
+/// of @p ChunkSize, which link to the chunk before them. A copy shares all chunks, and the first
+/// append to a copy only duplicates the last chunk of the vector, if it is partially filled.
+template <typename T, size_t ChunkSize = 32>
+class PersistentVector {
+    struct Chunk {
+        std::shared_ptr<const Chunk> previous;
+        std::vector<T> items;
+    };
+
+    /// The chunk elements are appended to. It is only modified if no other vector shares it.
+    std::shared_ptr<Chunk> last;
+
+    size_t count = 0;
+
+ public:
+    /// Appends @param value to the vector.
+    void push_back(T value) {
+        if (!last || last->items.size() == ChunkSize) {
+            auto chunk = std::make_shared<Chunk>();
+            chunk->previous = std::move(last);
+            chunk->items.reserve(ChunkSize);
+            last = std::move(chunk);
+        } else if (last.use_count() > 1) {
+            last = std::make_shared<Chunk>(*last);
+            last->items.reserve(ChunkSize);
+        }
+        last->items.push_back(std::move(value));
+        count++;
+    }
+
+    [[nodiscard]] size_t size() const { return count; }
+
+    [[nodiscard]] bool empty() const { return count == 0; }
+
+    /// @returns the last element of the vector. A BUG occurs if the vector is empty.
+    [[nodiscard]] const T &back() const {
+        BUG_CHECK(!empty(), "back() of an empty vector");
+        return last->items.back();
+    }
+
+    /// @returns the elements of the vector in order.
+    [[nodiscard]] std::vector<T> toVector() const {
+        std::vector<const Chunk *> chunks;
+        for (const Chunk *chunk = last.get(); chunk != nullptr; chunk = chunk->previous.get()) {
+            chunks.push_back(chunk);
+        }
+        std::vector<T> result;
+        result.reserve(count);
+        for (auto it = chunks.rbegin(); it != chunks.rend(); ++it) {
+            result.insert(result.end(), (*it)->items.begin(), (*it)->items.end());
+        }
+        return result;
+    }
+};
+
+/// An array whose copies share their elements. The elements are stored in chunks of
+/// @p ChunkSize, and a copy only duplicates the chunks it writes to. Elements that were never
+/// set are value-initialized.
+template <typename T, size_t ChunkSize = 64>
+class PersistentArray {
+    using Chunk = std::array<T, ChunkSize>;
+
+    /// The chunks, or nullptr for chunks with no element set. A chunk is only modified if no
+    /// other array shares it.
+    std::vector<std::shared_ptr<Chunk>> chunks;
+
+ public:
+    /// @returns the element at @param index.
+    [[nodiscard]] T get(size_t index) const {
+        size_t chunk = index / ChunkSize;
+        if (chunk >= chunks.size() || !chunks[chunk]) {
+            return T();
+        }
+        return (*chunks[chunk])[index % ChunkSize];
+    }
+
+    /// Sets the element at @param index to @param value.
+    void set(size_t index, T value) {
+        size_t chunk = index / ChunkSize;
+        if (chunk >= chunks.size()) {
+            chunks.resize(chunk + 1);
+        }
+        auto &target = chunks[chunk];
+        if (!target) {
+            target = std::make_shared<Chunk>();
+        } else if (target.use_count() > 1) {
+            target = std::make_shared<Chunk>(*target);
+        }
+        (*target)[index % ChunkSize] = std::move(value);
+    }
+
+    /// @returns an upper bound of the indices of the elements that were set.
+    [[nodiscard]] size_t capacity() const { return chunks.size() * ChunkSize; }
+};
+
+/// A sorted map or set of type @p Container whose copies share most of their elements. Elements
+/// are inserted into a small container of recent changes, which is merged into a new shared
+/// container once it grows to a fraction of that container. A copy therefore only duplicates
+/// the recent changes. Elements cannot be removed.
+template <typename Container>
+class LayeredContainer {
+    template <typename C, typename = void>
+    struct IsMap : std::false_type {};
+    template <typename C>
+    struct IsMap<C, std::void_t<typename C::mapped_type>> : std::true_type {};
+
+    /// Changes are merged once there are more than this many, or than a sixteenth of the shared
+    /// elements.
+    static constexpr size_t MIN_CHANGES = 64;
+
+    /// The shared elements. Never modified once built.
+    mutable std::shared_ptr<const Container> shared = std::make_shared<const Container>();
+
+    /// The elements inserted since the last merge. Elements in here take precedence.
+    mutable Container changes;
+
+    /// @returns the key of @param value.
+    static const auto &keyOf(const typename Container::value_type &value) {
+        if constexpr (IsMap<Container>::value) {
+            return value.first;
+        } else {
+            return value;
+        }
+    }
+
+    /// Merges the recent changes into a new shared container.
+    void merge() const {
+        auto merged = std::make_shared<Container>(shared->key_comp());
+        auto less = shared->key_comp();
+        auto it = shared->begin();
+        for (const auto &change : changes) {
+            for (; it != shared->end() && less(keyOf(*it), keyOf(change)); ++it) {
+                merged->insert(merged->end(), *it);
+            }
+            if (it != shared->end() && !less(keyOf(change), keyOf(*it))) {
+                ++it;
+            }
+            merged->insert(merged->end(), change);
+        }
+        for (; it != shared->end(); ++it) {
+            merged->insert(merged->end(), *it);
+        }
+        shared = std::move(merged);
+        changes.clear();
+    }
+
+ public:
+    using key_type = typename Container::key_type;
+    using value_type = typename Container::value_type;
+
+    /// @returns the element with @param key, or nullptr if there is none.
+    [[nodiscard]] const value_type *find(const key_type &key) const {
+        auto it = changes.find(key);
+        if (it != changes.end()) {
+            return &*it;
+        }
+        auto sharedIt = shared->find(key);
+        return sharedIt != shared->end() ? &*sharedIt : nullptr;
+    }
+
+    /// Inserts @param value, replacing the value of a map element with the same key.
+    void insert(const value_type &value) {
+        if constexpr (IsMap<Container>::value) {
+            changes.insert_or_assign(value.first, value.second);
+        } else {
+            if (shared->find(value) != shared->end()) {
+                return;
+            }
+            changes.insert(value);
+        }
+        if (changes.size() > std::max(MIN_CHANGES, shared->size() / 16)) {
+            merge();
+        }
+    }
+
+    [[nodiscard]] bool empty() const { return shared->empty() && changes.empty(); }
+
+    /// @returns all elements. This merges the recent changes, and the reference is only valid
+    /// until the next insertion.
+    [[nodiscard]] const Container &get() const {
+        if (!changes.empty()) {
+            merge();
+        }
+        return *shared;
+    }
+};
+
+}  // namespace P4Tools
+
+#endif /* BACKENDS_P4TOOLS_COMMON_LIB_PERSISTENT_H_ */
@@ -1,7 +1,11 @@
 #include "backends/p4tools/common/lib/symbolic_env.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -13,23 +17,102 @@
 #include "ir/visitor.h"
 #include "lib/cstring.h"
 #include "lib/exceptions.h"
+#include "lib/hash.h"
 
 namespace P4Tools {
 
-const IR::Expression *SymbolicEnv::get(const IR::StateVariable &var) const {
-    auto it = map.find(var);
-    if (it != map.end()) {
+namespace {
+
+/// Gives every state variable a unique id. Variables are identified as in IR::StateVariable
+/// comparisons: by their member names, path names, and constant array indices.
+class StateVariableIds {
+    /// A hash of the parts of a reference that StateVariable comparisons look at.
+    static size_t hashOf(const IR::Expression *ref) {
+        if (const auto *member = ref->to<IR::Member>()) {
+            return Util::hash_combine(hashOf(member->expr),
+                                      std::hash<cstring>()(member->member.name));
+        }
+        if (const auto *path = ref->to<IR::PathExpression>()) {
+            return std::hash<cstring>()(path->path->name.name);
+        }
+        if (const auto *arrayIndex = ref->to<IR::ArrayIndex>()) {
+            const auto *index = arrayIndex->right->to<IR::Constant>();
+            BUG_CHECK(index != nullptr,
+                      "Value %1% is not a constant. Only constants are supported.",
+                      arrayIndex->right);
+            return Util::hash_combine(hashOf(arrayIndex->left),
+                                      static_cast<uint64_t>(index->value));
+        }
+        BUG("Not a valid StateVariable: %1% of type %2%", ref, ref->node_type_name());
+    }
+
+    struct Hash {
+        size_t operator()(const IR::StateVariable &var) const { return hashOf(var.ref); }
+    };
+
+    struct Equal {
+        bool operator()(const IR::StateVariable &a, const IR::StateVariable &b) const {
+            return a.compare(a.ref, b.ref) == 0;
+        }
+    };
+
+    std::unordered_map<IR::StateVariable, uint32_t, Hash, Equal> ids;
+
+    /// The variable of each id, as first interned.
+    std::deque<IR::StateVariable> variables;
+
+ public:
+    static StateVariableIds &get() {
+        static StateVariableIds instance;
+        return instance;
+    }
+
+    /// @returns the id of @param var, if it was ever interned.
+    [[nodiscard]] std::optional<uint32_t> find(const IR::StateVariable &var) const {
+        auto it = ids.find(var);
+        if (it == ids.end()) {
+            return std::nullopt;
+        }
         return it->second;
     }
+
+    /// @returns the id of @param var, giving it a new one if it has none yet.
+    uint32_t intern(const IR::StateVariable &var) {
+        auto [it, inserted] = ids.emplace(var, static_cast<uint32_t>(variables.size()));
+        if (inserted) {
+            variables.push_back(var);
+        }
+        return it->second;
+    }
+
+    [[nodiscard]] const IR::StateVariable &variable(uint32_t id) const { return variables.at(id); }
+};
+
+}  // namespace
+
+const IR::Expression *SymbolicEnv::get(const IR::StateVariable &var) const {
+    if (auto id = StateVariableIds::get().find(var)) {
+        if (const auto *value = values.get(*id)) {
+            return value;
+        }
+    }
     BUG("Unable to find var %s in the symbolic environment.", var);
 }
 
-bool SymbolicEnv::exists(const IR::StateVariable &var) const { return map.find(var) != map.end(); }
+bool SymbolicEnv::exists(const IR::StateVariable &var) const {
+    auto id = StateVariableIds::get().find(var);
+    return id && values.get(*id) != nullptr;
+}
 
 void SymbolicEnv::set(const IR::StateVariable &var, const IR::Expression *value) {
     BUG_CHECK(value->type && !value->type->is<IR::Type_Unknown>(),
               "Cannot set value with unspecified type: %1%", value);
-    map[var] = value;
+    auto id = StateVariableIds::get().intern(var);
+    if (values.get(id) == nullptr) {
+        count++;
+    }
+    values.set(id, value);
+    sorted = nullptr;
 }
 
 const IR::Expression *SymbolicEnv::subst(const IR::Expression *expr) const {
@@ -67,7 +150,24 @@ const IR::Expression *SymbolicEnv::subst(const IR::Expression *expr) const {
     return expr->apply(SubstVisitor(*this));
 }
 
-const SymbolicMapType &SymbolicEnv::getInternalMap() const { return map; }
+const SymbolicMapType &SymbolicEnv::getInternalMap() const {
+    if (sorted == nullptr) {
+        const auto &ids = StateVariableIds::get();
+        SymbolicMapType::sequence_type bindings;
+        bindings.reserve(count);
+        for (size_t id = 0; id < values.capacity(); id++) {
+            if (const auto *value = values.get(id)) {
+                bindings.emplace_back(ids.variable(id), value);
+            }
+        }
+        std::sort(bindings.begin(), bindings.end(),
+                  [](const auto &a, const auto &b) { return a.first < b.first; });
+        auto map = std::make_shared<SymbolicMapType>();
+        map->adopt_sequence(boost::container::ordered_unique_range, std::move(bindings));
+        sorted = std::move(map);
+    }
+    return *sorted;
+}
 
 bool SymbolicEnv::isSymbolicValue(const IR::Node *node) {
     // Check the obvious case first.
@@ -1,17 +1,34 @@
 #ifndef BACKENDS_P4TOOLS_COMMON_LIB_SYMBOLIC_ENV_H_
 #define BACKENDS_P4TOOLS_COMMON_LIB_SYMBOLIC_ENV_H_
 
+#include <cstddef>
+#include <memory>
+
 #include "backends/p4tools/common/lib/model.h"
+#include "backends/p4tools/common/lib/persistent.h"
 #include "ir/ir.h"
 #include "ir/node.h"
 
 namespace P4Tools {
 
 /// A symbolic environment maps variables to their symbolic value. A symbolic value is just an
-/// expression on the program's initial state.
+/// expression on the program's initial state. Copies of an environment share most of their
+/// bindings, which makes copying the execution states that hold them cheap.
+///
+/// Every state variable is given a small integer id the first time it is bound, in a table shared
+/// by all environments, and the values are stored in an array indexed by that id. A lookup thus
+/// hashes the variable once rather than comparing it with the variables along a tree path.
 class SymbolicEnv {
  private:
-    SymbolicMapType map;
+    /// The values of the variables, by id. Variables without a value in this environment map to
+    /// nullptr.
+    PersistentArray<const IR::Expression *> values;
+
+    /// The number of variables bound by this environment.
+    size_t count = 0;
+
+    /// The bindings in the order of IR::StateVariable, built by getInternalMap on demand.
+    mutable std::shared_ptr<const SymbolicMapType> sorted;
 
  public:
     // Maybe coerce from Model for concrete execution?
@@ -30,7 +47,8 @@ class SymbolicEnv {
     /// Variables that are unbound by this environment are left untouched.
     const IR::Expression *subst(const IR::Expression *expr) const;
 
-    /// @returns The immutable map that is internal to this symbolic environment.
+    /// @returns The immutable map that is internal to this symbolic environment. The reference is
+    /// only valid until the next call to @ref set.
     [[nodiscard]] const SymbolicMapType &getInternalMap() const;
 
     /// Determines whether the given node represents a symbolic value. Symbolic values may be
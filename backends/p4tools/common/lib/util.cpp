@@ -11,6 +11,7 @@
 #include <boost/multiprecision/cpp_int/add.hpp>
 #include <boost/multiprecision/detail/et_ops.hpp>
 #include <boost/multiprecision/number.hpp>
+#include <boost/random/seed_seq.hpp>
 #include <boost/random/uniform_int_distribution.hpp>
 
 #include "ir/id.h"
@@ -27,7 +28,7 @@ namespace P4Tools {
 
 std::optional<uint32_t> Utils::currentSeed = std::nullopt;
 
-boost::random::mt19937 Utils::rng(0);
+thread_local boost::random::mt19937 Utils::rng(0);
 
 std::string Utils::getTimeStamp() {
     // get current time
@@ -56,6 +57,11 @@ void Utils::setRandomSeed(int seed) {
 
 std::optional<uint32_t> Utils::getCurrentSeed() { return currentSeed; }
 
+void Utils::seedThreadRandom(uint64_t stream) {
+    boost::random::seed_seq seq{uint64_t(currentSeed.value_or(0)), stream};
+    rng.seed(seq);
+}
+
 uint64_t Utils::getRandInt(uint64_t max) {
     if (!currentSeed) {
         return 0;
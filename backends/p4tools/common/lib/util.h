@@ -48,8 +48,9 @@ class Utils {
      *  Seeds, timestamps, randomness.
      * ========================================================================================= */
  private:
-    /// The random generator of this project. It is initialized with the input seed.
-    static boost::random::mt19937 rng;
+    /// The random generator of this project. It is initialized with the input seed. Each thread
+    /// has its own, so that threads that explore separate paths draw reproducible values.
+    static thread_local boost::random::mt19937 rng;
 
     /// Stores the state of the PRNG.
     static std::optional<uint32_t> currentSeed;
@@ -67,6 +68,10 @@ class Utils {
     /// @returns currentSeed.
     static std::optional<uint32_t> getCurrentSeed();
 
+    /// Reseeds the random generator of the calling thread from the input seed and @param stream,
+    /// so that a task gets the same random values whichever thread runs it.
+    static void seedThreadRandom(uint64_t stream);
+
     /// @returns a random integer in the range [0, @param max]. Always return 0 if no seed is set.
     static uint64_t getRandInt(uint64_t max);
 
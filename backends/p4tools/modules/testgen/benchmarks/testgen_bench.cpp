@@ -0,0 +1,253 @@
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>  // NOLINT linter forbids using chrono, but we don't have alternatives
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <inja/inja.hpp>
+
+#include "backends/p4tools/common/lib/util.h"
+#include "frontends/common/options.h"
+#include "frontends/common/parser_options.h"
+#include "lib/compile_context.h"
+#include "lib/timer.h"
+
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/path_selection.h"
+#include "backends/p4tools/modules/testgen/lib/test_batch_writer.h"
+#include "backends/p4tools/modules/testgen/options.h"
+#include "backends/p4tools/modules/testgen/testgen.h"
+
+/// Measures the test generation throughput of P4Testgen. Every P4 program is run once with each
+/// path selection strategy. Each run happens in a separate process, so that the timers and the
+/// peak memory of a run are not mixed with those of other runs. Every run appends one JSON object
+/// per line to the result file:
+///   program, strategy, seed, max_tests: the configuration of the run.
+///   tests, wall_ms, tests_per_second: the number of generated tests and the elapsed time.
+///   solver_ms, solver_share: the time spent in the solver and its share of the elapsed time.
+///   peak_rss_kb: the peak resident memory of the run.
+///   coverage: the statement coverage after each test, final_coverage: the coverage of the run.
+///   timers: the total milliseconds of every timer in lib/timer.h.
+/// Failed runs are recorded with an "error" field.
+
+namespace {
+
+using P4Tools::P4Testgen::PathSelectionPolicy;
+
+const std::vector<std::pair<std::string, PathSelectionPolicy>> STRATEGIES = {
+    {"DEPTH_FIRST", PathSelectionPolicy::DepthFirst},
+    {"RANDOM_BACKTRACK", PathSelectionPolicy::RandomBacktrack},
+    {"GREEDY_STATEMENT_SEARCH", PathSelectionPolicy::GreedyStmtCoverage},
+};
+
+struct BenchOptions {
+    std::filesystem::path outDir = "testgen-bench";
+    std::filesystem::path results = "testgen-bench/results.jsonl";
+    std::string target = "bmv2";
+    std::string arch = "v1model";
+    std::string includePath;
+    int64_t maxTests = 100;
+    uint32_t seed = 1;
+    std::vector<std::filesystem::path> programs;
+};
+
+void printUsage(const char *name) {
+    std::cerr << "Usage: " << name
+              << " [--out-dir DIR] [--results FILE] [--target TARGET] [--arch ARCH]"
+                 " [--include DIR] [--max-tests N] [--seed N] PROGRAM...\n";
+}
+
+std::optional<BenchOptions> parseOptions(int argc, char **argv) {
+    BenchOptions options;
+    for (int idx = 1; idx < argc; ++idx) {
+        std::string arg = argv[idx];
+        if (arg.rfind("--", 0) != 0) {
+            options.programs.emplace_back(arg);
+            continue;
+        }
+        if (idx + 1 >= argc) {
+            return std::nullopt;
+        }
+        std::string value = argv[++idx];
+        try {
+            if (arg == "--out-dir") {
+                options.outDir = value;
+            } else if (arg == "--results") {
+                options.results = value;
+            } else if (arg == "--target") {
+                options.target = value;
+            } else if (arg == "--arch") {
+                options.arch = value;
+            } else if (arg == "--include") {
+                options.includePath = value;
+            } else if (arg == "--max-tests") {
+                options.maxTests = std::stoll(value);
+            } else if (arg == "--seed") {
+                options.seed = std::stoul(value);
+            } else {
+                return std::nullopt;
+            }
+        } catch (std::exception &) {
+            return std::nullopt;
+        }
+    }
+    if (options.programs.empty()) {
+        return std::nullopt;
+    }
+    return options;
+}
+
+/// Reads the coverage of each test from the manifest of a batched test run.
+inja::json readCoverage(const std::filesystem::path &manifestPath) {
+    inja::json coverage = inja::json::array();
+    std::ifstream manifest(manifestPath);
+    std::string line;
+    while (std::getline(manifest, line)) {
+        coverage.push_back(inja::json::parse(line)["coverage"]);
+    }
+    return coverage;
+}
+
+/// Generates the tests of one configuration and returns the measurements of the run.
+inja::json runOnce(const BenchOptions &options, const std::filesystem::path &program,
+                   const std::pair<std::string, PathSelectionPolicy> &strategy) {
+    inja::json result;
+    result["program"] = program.filename().string();
+    result["strategy"] = strategy.first;
+    result["seed"] = options.seed;
+    result["max_tests"] = options.maxTests;
+
+    AutoCompileContext autoContext(new P4CContextWithOptions<CompilerOptions>());
+    auto compilerOptions = P4CContextWithOptions<CompilerOptions>::get().options();
+    compilerOptions.target = options.target;
+    compilerOptions.arch = options.arch;
+    if (!options.includePath.empty()) {
+        compilerOptions.preprocessor_options = "-I" + options.includePath;
+    }
+    compilerOptions.file = program.string();
+
+    auto testName = program.stem().string() + "_" + strategy.first;
+    auto &testgenOptions = P4Tools::P4Testgen::TestgenOptions::get();
+    testgenOptions.testBackend = "PROTOBUF_IR";
+    testgenOptions.testBaseName = testName;
+    testgenOptions.outputDir = options.outDir / testName;
+    testgenOptions.batchOutput = true;
+    testgenOptions.seed = options.seed;
+    testgenOptions.maxTests = options.maxTests;
+    testgenOptions.pathSelectionPolicy = strategy.second;
+    testgenOptions.hasCoverageTracking = true;
+    testgenOptions.coverageOptions.coverStatements = true;
+    P4Tools::Utils::setRandomSeed(static_cast<int>(options.seed));
+
+    auto start = std::chrono::steady_clock::now();
+    auto status = P4Tools::P4Testgen::Testgen::writeTests(compilerOptions, testgenOptions);
+    auto wallMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+            .count();
+    if (status != EXIT_SUCCESS) {
+        result["error"] = "test generation failed";
+    }
+
+    auto coverage = readCoverage(P4Tools::P4Testgen::TestBatchWriter::getManifestPath(
+        testgenOptions.outputDir.value() / testName));
+    result["tests"] = coverage.size();
+    result["wall_ms"] = wallMs;
+    result["tests_per_second"] = wallMs > 0 ? coverage.size() * 1000.0 / wallMs : 0.0;
+    result["final_coverage"] = coverage.empty() ? inja::json(0.0) : coverage.back();
+    result["coverage"] = coverage;
+
+    inja::json timers = inja::json::object();
+    size_t solverMs = 0;
+    for (const auto &timer : Util::getTimers()) {
+        if (timer.timerName.empty()) {
+            continue;
+        }
+        timers[timer.timerName] = timer.milliseconds;
+        // Solver timers are nested in the timers of their callers. Only count the outermost.
+        auto leaf = timer.timerName.substr(timer.timerName.rfind('.') + 1);
+        auto parent = timer.timerName.substr(0, timer.timerName.rfind('.') + 1);
+        bool isSolverTimer = leaf == "checkSat" || leaf == "getModel";
+        bool hasSolverParent = parent.find("checkSat.") != std::string::npos ||
+                               parent.find("getModel.") != std::string::npos;
+        if (isSolverTimer && !hasSolverParent) {
+            solverMs += timer.milliseconds;
+        }
+    }
+    result["timers"] = timers;
+    result["solver_ms"] = solverMs;
+    result["solver_share"] = wallMs > 0 ? solverMs / wallMs : 0.0;
+
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    result["peak_rss_kb"] = usage.ru_maxrss;
+    return result;
+}
+
+/// Appends @param result as one line to the file @param results.
+void appendResult(const std::filesystem::path &results, const inja::json &result) {
+    std::ofstream resultFile(results, std::ios::app);
+    resultFile << result.dump() << '\n';
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    auto optionsOpt = parseOptions(argc, argv);
+    if (!optionsOpt.has_value()) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    const auto &options = optionsOpt.value();
+    std::filesystem::create_directories(options.outDir);
+    if (options.results.has_parent_path()) {
+        std::filesystem::create_directories(options.results.parent_path());
+    }
+
+    int failures = 0;
+    for (const auto &program : options.programs) {
+        for (const auto &strategy : STRATEGIES) {
+            std::cout << "Benchmarking " << program.filename().string() << " with "
+                      << strategy.first << "\n"
+                      << std::flush;
+            auto pid = fork();
+            if (pid < 0) {
+                std::cerr << "Unable to start a benchmark process.\n";
+                return EXIT_FAILURE;
+            }
+            if (pid == 0) {
+                inja::json result;
+                try {
+                    result = runOnce(options, program, strategy);
+                } catch (const std::exception &e) {
+                    result["program"] = program.filename().string();
+                    result["strategy"] = strategy.first;
+                    result["error"] = e.what();
+                }
+                appendResult(options.results, result);
+                // Skip the destructors of the global state of the compiler.
+                _exit(result.contains("error") ? EXIT_FAILURE : EXIT_SUCCESS);
+            }
+            int status = 0;
+            waitpid(pid, &status, 0);
+            if (WIFSIGNALED(status)) {
+                inja::json result;
+                result["program"] = program.filename().string();
+                result["strategy"] = strategy.first;
+                result["error"] = "terminated by signal " + std::to_string(WTERMSIG(status));
+                appendResult(options.results, result);
+            }
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+                failures++;
+            }
+        }
+    }
+    std::cout << "Results written to " << options.results.string() << "\n";
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,198 @@
+#include "backends/p4tools/modules/testgen/core/compiled_program.h"
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ir/json_generator.h"
+#include "ir/json_loader.h"
+#include "ir/visitor.h"
+#include "lib/cstring.h"
+#include "lib/error.h"
+#include "lib/source_file.h"
+
+namespace P4Tools::P4Testgen {
+
+namespace {
+
+/// The text of some P4 sources and the lines at which their mapping to the original files
+/// changes, see Util::InputSources::mapLine.
+struct SourceText {
+    cstring text = cstring::empty;
+    std::vector<unsigned> mappedLines;
+    std::vector<cstring> mappedFiles;
+    std::vector<unsigned> mappedSourceLines;
+
+    explicit SourceText(const Util::InputSources &sources) {
+        std::string contents;
+        Util::SourceFileLine previous(cstring(), 0);
+        for (unsigned line = 1; line <= sources.lineCount(); line++) {
+            auto lineText = sources.getLine(line);
+            contents.append(lineText.c_str(), lineText.size());
+            auto sourceLine = sources.getSourceLine(line);
+            // The first line keeps the mapping of a new Util::InputSources.
+            if (line > 1 && !sourceLine.fileName.isNull() &&
+                (sourceLine.fileName != previous.fileName ||
+                 sourceLine.sourceLine != previous.sourceLine + 1)) {
+                mappedLines.push_back(line);
+                mappedFiles.push_back(sourceLine.fileName);
+                mappedSourceLines.push_back(sourceLine.sourceLine);
+            }
+            previous = sourceLine;
+        }
+        text = contents;
+    }
+
+    SourceText() = default;
+
+    /// @returns sources with this text and line mapping.
+    [[nodiscard]] const Util::InputSources *toInputSources() const {
+        auto *sources = new Util::InputSources();
+        std::string_view remaining(text.c_str(), text.size());
+        size_t mapping = 0;
+        for (unsigned line = 1; !remaining.empty(); line++) {
+            if (mapping < mappedLines.size() && mappedLines[mapping] == line) {
+                // getSourceLine counts the lines after the mapped one, see InputSources.
+                sources->mapLine(mappedFiles[mapping], mappedSourceLines[mapping] + 1);
+                mapping++;
+            }
+            auto end = remaining.find('\n');
+            end = end == std::string_view::npos ? remaining.size() : end + 1;
+            sources->appendText(remaining.substr(0, end));
+            remaining.remove_prefix(end);
+        }
+        return sources;
+    }
+};
+
+/// @returns the sources of the first node of @param program with a source position.
+const Util::InputSources *findSources(const IR::P4Program &program) {
+    const Util::InputSources *sources = nullptr;
+    forAllMatching<IR::Node>(&program, [&sources](const IR::Node *node) {
+        if (sources == nullptr) {
+            sources = node->srcInfo.getSources();
+        }
+    });
+    return sources;
+}
+
+/// Lists the start and end line and column of each node, in the order of a visit. Nodes without
+/// a source position get zeros.
+class CollectPositions : public Inspector {
+    std::vector<unsigned> positions;
+
+    bool preorder(const IR::Node *node) override {
+        if (!node->srcInfo.isValid()) {
+            positions.insert(positions.end(), {0, 0, 0, 0});
+            return true;
+        }
+        auto start = node->srcInfo.getStart();
+        auto end = node->srcInfo.getEnd();
+        positions.insert(positions.end(), {start.getLineNumber(), start.getColumnNumber(),
+                                           end.getLineNumber(), end.getColumnNumber()});
+        return true;
+    }
+
+ public:
+    [[nodiscard]] const std::vector<unsigned> &getPositions() const { return positions; }
+};
+
+/// Sets the source positions listed by CollectPositions on the nodes of a program loaded from
+/// JSON, which are visited in the same order.
+class RestorePositions : public Inspector {
+    const Util::InputSources &sources;
+    const std::vector<unsigned> &positions;
+    size_t next = 0;
+
+    bool preorder(const IR::Node *node) override {
+        BUG_CHECK(next + 4 <= positions.size(), "The compiled program has too few positions.");
+        Util::SourcePosition start(positions[next], positions[next + 1]);
+        Util::SourcePosition end(positions[next + 2], positions[next + 3]);
+        next += 4;
+        if (start.isValid()) {
+            // The program was just loaded, nothing else refers to its nodes yet.
+            const_cast<IR::Node *>(node)->srcInfo = Util::SourceInfo(&sources, start, end);
+        }
+        return true;
+    }
+
+ public:
+    RestorePositions(const Util::InputSources &sources, const std::vector<unsigned> &positions)
+        : sources(sources), positions(positions) {}
+
+    [[nodiscard]] bool restoredAll() const { return next == positions.size(); }
+};
+
+}  // namespace
+
+bool writeCompiledProgram(const IR::P4Program &program, const std::filesystem::path &path) {
+    std::ofstream output(path);
+    if (!output) {
+        ::error("Unable to open %1% for writing.", path.c_str());
+        return false;
+    }
+    SourceText sourceText;
+    if (const auto *sources = findSources(program)) {
+        sourceText = SourceText(*sources);
+    }
+    CollectPositions collectPositions;
+    program.apply(collectPositions);
+
+    JSONGenerator json(output);
+    json << json.indent << "{\n";
+    json.indent++;
+    json << json.indent << "\"text\" : " << sourceText.text << ",\n";
+    json << json.indent << "\"mappedLines\" : " << sourceText.mappedLines << ",\n";
+    json << json.indent << "\"mappedFiles\" : " << sourceText.mappedFiles << ",\n";
+    json << json.indent << "\"mappedSourceLines\" : " << sourceText.mappedSourceLines << ",\n";
+    json << json.indent << "\"positions\" : " << collectPositions.getPositions() << ",\n";
+    json << json.indent << "\"program\" : " << &program << "\n";
+    json.indent--;
+    json << json.indent << "}\n";
+    output.close();
+    if (!output) {
+        ::error("Unable to write the compiled program to %1%.", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+const IR::P4Program *readCompiledProgram(const std::filesystem::path &path,
+                                         const IR::P4Program &parsedProgram) {
+    std::ifstream input(path);
+    if (!input) {
+        ::error("Unable to open the compiled program %1%.", path.c_str());
+        return nullptr;
+    }
+    JSONLoader loader(input);
+    SourceText sourceText;
+    std::vector<unsigned> positions;
+    const IR::P4Program *program = nullptr;
+    loader.load("text", sourceText.text);
+    loader.load("mappedLines", sourceText.mappedLines);
+    loader.load("mappedFiles", sourceText.mappedFiles);
+    loader.load("mappedSourceLines", sourceText.mappedSourceLines);
+    loader.load("positions", positions);
+    loader.load("program", program);
+    if (program == nullptr) {
+        ::error("%1% does not contain a compiled program.", path.c_str());
+        return nullptr;
+    }
+
+    const auto *parsedSources = findSources(parsedProgram);
+    if (parsedSources == nullptr || SourceText(*parsedSources).text != sourceText.text) {
+        ::error("The P4 sources changed since %1% was compiled. Compile the program again.",
+                path.c_str());
+        return nullptr;
+    }
+    RestorePositions restorePositions(*sourceText.toInputSources(), positions);
+    program->apply(restorePositions);
+    if (!restorePositions.restoredAll()) {
+        ::error("The source positions in %1% do not match its program.", path.c_str());
+        return nullptr;
+    }
+    return program;
+}
+
+}  // namespace P4Tools::P4Testgen
@@ -0,0 +1,25 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_COMPILED_PROGRAM_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_COMPILED_PROGRAM_H_
+
+#include <filesystem>
+
+#include "ir/ir.h"
+
+namespace P4Tools::P4Testgen {
+
+/// Writes @param program, a program after the mid end, to @param path, so that later runs can
+/// skip the front end and the mid end with --load-compiled. The file is a JSON object which
+/// holds the IR, the text of the P4 sources and the source position of every node, because the
+/// IR in JSON only keeps the start of a position and coverage compares the positions of nodes.
+/// @returns false with an error if the file cannot be written.
+bool writeCompiledProgram(const IR::P4Program &program, const std::filesystem::path &path);
+
+/// Reads a program written by writeCompiledProgram from @param path. @param parsedProgram is the
+/// program parsed from the current P4 sources, which must be the sources of the compiled
+/// program. @returns nullptr with an error if the file cannot be read or the sources changed.
+const IR::P4Program *readCompiledProgram(const std::filesystem::path &path,
+                                         const IR::P4Program &parsedProgram);
+
+}  // namespace P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_COMPILED_PROGRAM_H_ */
@@ -5,6 +5,7 @@
 #include "backends/p4tools/common/compiler/reachability.h"
 #include "midend/coverage.h"
 
+#include "backends/p4tools/modules/testgen/core/compiled_program.h"
 #include "backends/p4tools/modules/testgen/options.h"
 
 namespace P4Tools::P4Testgen {
@@ -29,14 +30,27 @@ TestgenCompilerTarget::TestgenCompilerTarget(std::string deviceName, std::string
     : CompilerTarget(std::move(deviceName), std::move(archName)) {}
 
 CompilerResultOrError TestgenCompilerTarget::runCompilerImpl(const IR::P4Program *program) const {
-    program = runFrontend(program);
-    if (program == nullptr) {
-        return std::nullopt;
-    }
+    const auto &testgenOptions = TestgenOptions::get();
+    if (testgenOptions.loadCompiled.has_value()) {
+        // The front end and the mid end already ran on these sources.
+        program = readCompiledProgram(testgenOptions.loadCompiled.value(), *program);
+        if (program == nullptr) {
+            return std::nullopt;
+        }
+    } else {
+        program = runFrontend(program);
+        if (program == nullptr) {
+            return std::nullopt;
+        }
 
-    program = runMidEnd(program);
-    if (program == nullptr) {
-        return std::nullopt;
+        program = runMidEnd(program);
+        if (program == nullptr) {
+            return std::nullopt;
+        }
+        if (testgenOptions.saveCompiled.has_value() &&
+            !writeCompiledProgram(*program, testgenOptions.saveCompiled.value())) {
+            return std::nullopt;
+        }
     }
 
     // Create DCG.
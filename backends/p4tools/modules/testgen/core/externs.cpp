@@ -1,10 +1,14 @@
 #include "backends/p4tools/modules/testgen/core/externs.h"
 
+#include <algorithm>
 #include <list>
-#include <optional>
 #include <tuple>
 #include <vector>
 
+#ifdef MULTITHREAD
+#include <mutex>
+#endif
+
 #include "ir/ir.h"
 #include "lib/exceptions.h"
 #include "lib/log.h"
@@ -31,33 +35,58 @@ bool ExternMethodImpls::exec(const IR::MethodCallExpression *call, const IR::Exp
 
     BUG_CHECK(externType, "Not an extern: %1%", receiver);
 
-    cstring qualifiedMethodName = externType->name + "." + name;
-    if (impls.count(qualifiedMethodName) == 0) {
-        return false;
+    const MethodImpl *matchingImpl = nullptr;
+    // Named arguments influence which overload is chosen. These calls are rare and not cached.
+    bool hasNamedArgs = std::any_of(args->begin(), args->end(),
+                                    [](const auto *arg) { return arg->name.name != nullptr; });
+    if (hasNamedArgs) {
+        matchingImpl = resolve(externType, name, args);
+    } else {
+        CallSignature signature{externType, name.name.c_str(), args->size()};
+#ifdef MULTITHREAD
+        std::lock_guard<std::mutex> acquire(resolvedCallsLock);
+#endif
+        auto resolvedIt = resolvedCalls.find(signature);
+        if (resolvedIt == resolvedCalls.end()) {
+            resolvedIt = resolvedCalls.emplace(signature, resolve(externType, name, args)).first;
+        }
+        matchingImpl = resolvedIt->second;
     }
 
-    const auto &submap = impls.at(qualifiedMethodName);
-    if (submap.count(args->size()) == 0) {
+    if (matchingImpl == nullptr) {
         return false;
     }
+    (*matchingImpl)(call, receiver, name, args, state, result);
+    return true;
+}
+
+const ExternMethodImpls::MethodImpl *ExternMethodImpls::resolve(
+    const IR::Type_Extern *externType, const IR::ID &name,
+    const IR::Vector<IR::Argument> *args) const {
+    cstring qualifiedMethodName = externType->name + "." + name;
+    auto methodIt = impls.find(qualifiedMethodName);
+    if (methodIt == impls.end()) {
+        return nullptr;
+    }
+
+    const auto &submap = methodIt->second;
+    auto arityIt = submap.find(args->size());
+    if (arityIt == submap.end()) {
+        return nullptr;
+    }
 
     // Find matching methods: if any arguments are named, then the parameter name must match.
-    std::optional<MethodImpl> matchingImpl;
-    for (const auto &pair : submap.at(args->size())) {
+    const MethodImpl *matchingImpl = nullptr;
+    for (const auto &pair : arityIt->second) {
         const auto &paramNames = pair.first;
         const auto &methodImpl = pair.second;
 
         if (matches(paramNames, args)) {
-            BUG_CHECK(!matchingImpl, "Ambiguous extern method call: %1%", name);
-            matchingImpl = methodImpl;
+            BUG_CHECK(matchingImpl == nullptr, "Ambiguous extern method call: %1%", name);
+            matchingImpl = &methodImpl;
         }
     }
-
-    if (!matchingImpl) {
-        return false;
-    }
-    (*matchingImpl)(call, receiver, name, args, state, result);
-    return true;
+    return matchingImpl;
 }
 
 bool ExternMethodImpls::matches(const std::vector<cstring> &paramNames,
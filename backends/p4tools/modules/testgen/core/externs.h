@@ -10,6 +10,10 @@
 #include <utility>
 #include <vector>
 
+#ifdef MULTITHREAD
+#include <mutex>
+#endif
+
 #include "ir/id.h"
 #include "ir/ir.h"
 #include "ir/vector.h"
@@ -59,6 +63,24 @@ class ExternMethodImpls {
     static bool matches(const std::vector<cstring> &paramNames,
                         const IR::Vector<IR::Argument> *args);
 
+    /// Finds the implementation of the method @param name of @param externType for the arguments
+    /// @param args. @returns nullptr if there is no matching implementation.
+    const MethodImpl *resolve(const IR::Type_Extern *externType, const IR::ID &name,
+                              const IR::Vector<IR::Argument> *args) const;
+
+    /// Identifies calls without named arguments by the extern type, the interned method name,
+    /// and the number of arguments. These determine the implementation of such a call.
+    using CallSignature = std::tuple<const IR::Type_Extern *, const char *, size_t>;
+
+    /// Caches the implementation of each call signature, so that the method name of a call is
+    /// only qualified and looked up once. Null if no implementation matches.
+    mutable std::map<CallSignature, const MethodImpl *> resolvedCalls;
+
+#ifdef MULTITHREAD
+    /// Guards @ref resolvedCalls, because paths may be explored on several threads.
+    mutable std::mutex resolvedCallsLock;
+#endif
+
  public:
     /// Represents a list of extern method implementations. The components of each element in this
     /// list are as follows:
@@ -1,8 +1,10 @@
 #include "backends/p4tools/modules/testgen/core/small_step/table_stepper.h"
 
 #include <algorithm>
+#include <map>
 #include <optional>
 #include <ostream>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -178,66 +180,130 @@ const IR::Expression *TableStepper::evalTableConstEntries() {
         }
     }
 
+    if (entryVector.size() > MAX_UNROLLED_CONST_ENTRIES) {
+        return evalIndexedConstEntries(entryVector);
+    }
+
     for (const auto *entry : entryVector) {
-        const auto *action = entry->getAction();
-        const auto *tableAction = action->checkedTo<IR::MethodCallExpression>();
-        const auto *actionType = stepper->state.getP4Action(tableAction);
-        auto &nextState = stepper->state.clone();
-        nextState.markVisited(entry);
         // Compute the table key for a constant entry
         const auto *hitCondition = TableUtils::computeEntryMatch(*table, *entry, *key);
+        // The default condition can only be triggered, if we do not hit this match.
+        // We encode this constraint in this expression.
+        addConstEntryBranch(new IR::LAnd(tableMissCondition, hitCondition), {entry}, nullptr);
+        tableMissCondition = new IR::LAnd(new IR::LNot(hitCondition), tableMissCondition);
+    }
+    return tableMissCondition;
+}
 
-        // Update all the tracking variables for tables.
-        std::vector<Continuation::Command> replacements;
-        replacements.emplace_back(new IR::MethodCallStatement(Util::SourceInfo(), tableAction));
-        nextState.set(getTableHitVar(table), IR::getBoolLiteral(true));
-        nextState.set(getTableActionVar(table), getTableActionString(tableAction));
+const IR::Expression *TableStepper::evalIndexedConstEntries(const IR::Vector<IR::Entry> &entries) {
+    const auto *key = table->getKey();
+    auto entryCount = entries.size();
+    int indexWidth = 1;
+    while ((static_cast<size_t>(1) << indexWidth) <= entryCount) {
+        indexWidth++;
+    }
+    const auto *indexType = IR::getBitType(indexWidth);
+
+    // The index of the first entry that matches. If no entry matches, the index is the number of
+    // entries. Every branch refers to this expression, so its size is linear in the entries.
+    const IR::Expression *matchIndex = IR::getConstant(indexType, entryCount);
+    for (size_t idx = entryCount; idx-- > 0;) {
+        const auto *hitCondition = TableUtils::computeEntryMatch(*table, *entries.at(idx), *key);
+        matchIndex =
+            new IR::Mux(indexType, hitCondition, IR::getConstant(indexType, idx), matchIndex);
+    }
 
-        // Some path selection strategies depend on looking ahead and collecting potential
-        // nodes. If that is the case, apply the CoverableNodesScanner visitor.
-        P4::Coverage::CoverageSet coveredNodes;
-        if (requiresLookahead(TestgenOptions::get().pathSelectionPolicy)) {
-            auto collector = CoverableNodesScanner(stepper->state);
-            collector.updateNodeCoverage(actionType, coveredNodes);
+    // Entries with the same action call lead to the same state. Only their coverage differs, so
+    // they can only share a branch if table entries are not covered.
+    bool groupByAction = !TestgenOptions::get().coverageOptions.coverTableEntries;
+    std::map<std::string, size_t> groupIndices;
+    std::vector<std::pair<const IR::Expression *, std::vector<const IR::Entry *>>> groups;
+    for (size_t idx = 0; idx < entryCount; ++idx) {
+        const auto *entry = entries.at(idx);
+        const auto *entryHit = new IR::Equ(matchIndex, IR::getConstant(indexType, idx));
+        if (groupByAction) {
+            const auto *tableAction = entry->getAction()->checkedTo<IR::MethodCallExpression>();
+            std::stringstream actionKey;
+            actionKey << tableAction->method;
+            for (const auto *arg : *tableAction->arguments) {
+                actionKey << "," << arg->expression;
+            }
+            auto [groupIt, isNew] = groupIndices.emplace(actionKey.str(), groups.size());
+            if (!isNew) {
+                auto &group = groups.at(groupIt->second);
+                group.first = new IR::LOr(group.first, entryHit);
+                group.second.push_back(entry);
+                continue;
+            }
         }
+        groups.emplace_back(entryHit, std::vector<const IR::Entry *>{entry});
+    }
+    for (const auto &group : groups) {
+        addConstEntryBranch(group.first, group.second, matchIndex);
+    }
+    return new IR::Equ(matchIndex, IR::getConstant(indexType, entryCount));
+}
 
-        // Add some tracing information.
-        std::stringstream tableStream;
-        tableStream << "Constant Table Branch: " << properties.tableName;
-        bool isFirstKey = true;
-        const auto &keyElements = key->keyElements;
+void TableStepper::addConstEntryBranch(const IR::Expression *condition,
+                                       const std::vector<const IR::Entry *> &entries,
+                                       const IR::Expression *matchIndex) {
+    const auto *key = table->getKey();
+    const auto *action = entries.front()->getAction();
+    const auto *tableAction = action->checkedTo<IR::MethodCallExpression>();
+    const auto *actionType = stepper->state.getP4Action(tableAction);
+    auto &nextState = stepper->state.clone();
+    for (const auto *entry : entries) {
+        nextState.markVisited(entry);
+    }
 
-        for (const auto *keyElement : keyElements) {
-            if (isFirstKey) {
-                tableStream << " | Key(s): ";
-            } else {
-                tableStream << ", ";
-            }
-            tableStream << keyElement->expression;
-            isFirstKey = false;
+    // Update all the tracking variables for tables.
+    std::vector<Continuation::Command> replacements;
+    replacements.emplace_back(new IR::MethodCallStatement(Util::SourceInfo(), tableAction));
+    nextState.set(getTableHitVar(table), IR::getBoolLiteral(true));
+    nextState.set(getTableActionVar(table), getTableActionString(tableAction));
+
+    // Some path selection strategies depend on looking ahead and collecting potential
+    // nodes. If that is the case, apply the CoverableNodesScanner visitor.
+    P4::Coverage::CoverageSet coveredNodes;
+    if (requiresLookahead(TestgenOptions::get().pathSelectionPolicy)) {
+        auto collector = CoverableNodesScanner(stepper->state);
+        collector.updateNodeCoverage(actionType, coveredNodes);
+    }
+
+    // Add some tracing information.
+    std::stringstream tableStream;
+    tableStream << "Constant Table Branch: " << properties.tableName;
+    bool isFirstKey = true;
+    const auto &keyElements = key->keyElements;
+
+    for (const auto *keyElement : keyElements) {
+        if (isFirstKey) {
+            tableStream << " | Key(s): ";
+        } else {
+            tableStream << ", ";
         }
-        tableStream << " | Chosen action: " << tableAction->toString();
-        const auto *args = tableAction->arguments;
-        bool isFirstArg = true;
-        for (const auto *arg : *args) {
-            if (isFirstArg) {
-                tableStream << " | Arg(s): ";
-            } else {
-                tableStream << ", ";
-            }
-            tableStream << arg->expression;
-            isFirstArg = false;
+        tableStream << keyElement->expression;
+        isFirstKey = false;
+    }
+    tableStream << " | Chosen action: " << tableAction->toString();
+    const auto *args = tableAction->arguments;
+    bool isFirstArg = true;
+    for (const auto *arg : *args) {
+        if (isFirstArg) {
+            tableStream << " | Arg(s): ";
+        } else {
+            tableStream << ", ";
         }
-        nextState.add(*new TraceEvents::Generic(tableStream.str()));
-        nextState.replaceTopBody(&replacements);
-        // Update the default condition.
-        // The default condition can only be triggered, if we do not hit this match.
-        // We encode this constraint in this expression.
-        stepper->result->emplace_back(new IR::LAnd(tableMissCondition, hitCondition),
-                                      stepper->state, nextState, coveredNodes);
-        tableMissCondition = new IR::LAnd(new IR::LNot(hitCondition), tableMissCondition);
+        tableStream << arg->expression;
+        isFirstArg = false;
     }
-    return tableMissCondition;
+    nextState.add(*new TraceEvents::Generic(tableStream.str()));
+    // The entry which was hit is only known once the test is generated.
+    if (matchIndex != nullptr) {
+        nextState.add(*new TraceEvents::Expression(matchIndex, "Matched constant entry index"));
+    }
+    nextState.replaceTopBody(&replacements);
+    stepper->result->emplace_back(condition, stepper->state, nextState, coveredNodes);
 }
 
 void TableStepper::setTableDefaultEntries(
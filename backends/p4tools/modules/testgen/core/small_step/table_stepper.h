@@ -28,6 +28,10 @@ class TableStepper {
     /// Basic table properties that are set when initializing the TableStepper.
     TableUtils::TableProperties properties;
 
+    /// Tables with more constant entries than this are encoded with a shared index of the first
+    /// matching entry instead of a separate miss condition per entry.
+    static constexpr size_t MAX_UNROLLED_CONST_ENTRIES = 32;
+
  public:
     /* =========================================================================================
      * Table Variable Getter functions
@@ -118,6 +122,19 @@ class TableStepper {
     /// executed.
     const IR::Expression *evalTableConstEntries();
 
+    /// Encodes the constant @param entries of a large table with a single expression, which
+    /// computes the index of the first matching entry. Entries with the same action call share a
+    /// branch, unless table entries are covered individually. The index chosen by a test is
+    /// recorded in its trace. @returns the miss condition of the entries.
+    const IR::Expression *evalIndexedConstEntries(const IR::Vector<IR::Entry> &entries);
+
+    /// Adds a branch, which executes the action of the constant @param entries if @param condition
+    /// holds. All entries share the same action call. If @param matchIndex is not null, it is the
+    /// index of the matched entry and is added to the trace.
+    void addConstEntryBranch(const IR::Expression *condition,
+                             const std::vector<const IR::Entry *> &entries,
+                             const IR::Expression *matchIndex);
+
     /// This helper function evaluates potential insertion from the control plane. We use variables
     /// variables to mimic an operator inserting entries. We only cover ONE entry per table for
     /// now.
@@ -1,17 +1,24 @@
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/greedy_node_cov.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <map>
 #include <optional>
+#include <variant>
 #include <vector>
 
+#include "backends/p4tools/common/compiler/reachability.h"
+#include "ir/ir.h"
 #include "ir/solver.h"
 #include "lib/error.h"
 #include "lib/timer.h"
 
 #include "backends/p4tools/modules/testgen/core/program_info.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+#include "backends/p4tools/modules/testgen/lib/continuation.h"
 #include "backends/p4tools/modules/testgen/lib/exceptions.h"
 #include "backends/p4tools/modules/testgen/lib/execution_state.h"
 #include "backends/p4tools/modules/testgen/options.h"
@@ -19,7 +26,105 @@
 namespace P4Tools::P4Testgen {
 
 GreedyNodeSelection::GreedyNodeSelection(AbstractSolver &solver, const ProgramInfo &programInfo)
-    : SymbolicExecutor(solver, programInfo) {}
+    : SymbolicExecutor(solver, programInfo) {
+    NodesCallGraph dcg("NodesCallGraph");
+    P4ProgramDCGCreator dcgCreator(&dcg);
+    programInfo.getP4Program().apply(dcgCreator);
+    for (const auto &[node, successors] : dcg) {
+        for (const auto *successor : *successors) {
+            predecessors[successor].push_back(node);
+        }
+    }
+}
+
+void GreedyNodeSelection::updateDistances() {
+    const auto &visitedNodes = getVisitedNodes();
+    if (distancesCoverage == visitedNodes.size()) {
+        return;
+    }
+    distancesCoverage = visitedNodes.size();
+    distances.clear();
+    // Search backwards from all uncovered nodes at once.
+    std::deque<const IR::Node *> work;
+    for (const auto *node : programInfo.getCoverableNodes()) {
+        if (visitedNodes.count(node) == 0U && distances.emplace(node, 0).second) {
+            work.push_back(node);
+        }
+    }
+    while (!work.empty()) {
+        const auto *node = work.front();
+        work.pop_front();
+        auto it = predecessors.find(node);
+        if (it == predecessors.end()) {
+            continue;
+        }
+        auto distance = distances.at(node) + 1;
+        for (const auto *predecessor : it->second) {
+            if (distances.emplace(predecessor, distance).second) {
+                work.push_back(predecessor);
+            }
+        }
+    }
+}
+
+uint64_t GreedyNodeSelection::getDistance(const Branch &branch) {
+    updateDistances();
+    auto distanceOf = [this](const IR::Node *node) {
+        auto it = distances.find(node);
+        return it != distances.end() ? it->second : UNREACHABLE;
+    };
+    uint64_t distance = UNREACHABLE;
+    for (const auto *node : branch.potentialNodes) {
+        distance = std::min(distance, distanceOf(node));
+    }
+    const auto &body = branch.nextState.get().getBody();
+    if (!body.empty()) {
+        const auto cmd = body.next();
+        if (const auto *const *node = std::get_if<const IR::Node *>(&cmd)) {
+            // Blocks are not part of the control-flow graph, but their first statement is.
+            const auto *next = *node;
+            while (const auto *block = next->to<IR::BlockStatement>()) {
+                if (block->components.empty()) {
+                    break;
+                }
+                next = block->components.front();
+            }
+            distance = std::min(distance, distanceOf(next));
+        }
+    }
+    return distance;
+}
+
+void GreedyNodeSelection::queueBranches(const std::vector<Branch> &branches) {
+    for (const auto &branch : branches) {
+        auto distance = getDistance(branch);
+        if (distance == UNREACHABLE) {
+            unreachableBranches.push_back(branch);
+        } else {
+            unexploredBranches.push({distance, queuedBranches++, branch});
+        }
+    }
+}
+
+SymbolicExecutor::Branch GreedyNodeSelection::popClosestBranch() {
+    while (!unexploredBranches.empty()) {
+        auto queued = unexploredBranches.top();
+        unexploredBranches.pop();
+        // Distances grow with the coverage, so a branch which is still as close as when it was
+        // queued is the closest one.
+        auto distance = getDistance(queued.branch);
+        if (distance == queued.distance) {
+            return queued.branch;
+        }
+        if (distance == UNREACHABLE) {
+            unreachableBranches.push_back(queued.branch);
+        } else {
+            queued.distance = distance;
+            unexploredBranches.push(queued);
+        }
+    }
+    return popRandomBranch(unreachableBranches);
+}
 
 std::optional<SymbolicExecutor::Branch> GreedyNodeSelection::popPotentialBranch(
     const P4::Coverage::CoverageSet &coveredNodes,
@@ -71,10 +176,29 @@ std::optional<ExecutionStateReference> GreedyNodeSelection::pickSuccessor(StepRe
             return nextState;
         }
     }
-    // If we can not cover anything new, pick a branch at random.
-    auto nextState = popRandomBranch(*successors).nextState;
+    // If we can not cover anything new, pick the branch closest to an uncovered node, or a
+    // branch at random.
+    std::optional<size_t> closest;
+    if (stepsWithoutTest < MAX_STEPS_WITHOUT_TEST) {
+        uint64_t closestDistance = UNREACHABLE;
+        for (size_t idx = 0; idx < successors->size(); ++idx) {
+            auto distance = getDistance(successors->at(idx));
+            if (distance < closestDistance) {
+                closestDistance = distance;
+                closest = idx;
+            }
+        }
+    }
+    std::optional<ExecutionStateReference> nextState;
+    if (closest.has_value()) {
+        nextState = successors->at(*closest).nextState;
+        (*successors)[*closest] = successors->back();
+        successors->pop_back();
+    } else {
+        nextState = popRandomBranch(*successors).nextState;
+    }
     // Add the remaining tests to the unexplored branches.
-    unexploredBranches.insert(unexploredBranches.end(), successors->begin(), successors->end());
+    queueBranches(*successors);
     return nextState;
 }
 
@@ -115,7 +239,8 @@ void GreedyNodeSelection::runImpl(const Callback &callBack,
         // Roll back to a previous branch and continue execution from there, but if there are no
         // more branches to explore, finish execution. Not all branches are viable, so we loop
         // until either we run out of unexplored branches or we find a viable branch.
-        if (potentialBranches.empty() && unexploredBranches.empty()) {
+        if (potentialBranches.empty() && unexploredBranches.empty() &&
+            unreachableBranches.empty()) {
             return;
         }
         // Select a new branch by iterating over all branches
@@ -127,11 +252,10 @@ void GreedyNodeSelection::runImpl(const Callback &callBack,
         }
         // We did not find a single branch that could cover new state.
         // Add all potential branches to the list of unexplored branches.
-        unexploredBranches.insert(unexploredBranches.end(), potentialBranches.begin(),
-                                  potentialBranches.end());
+        queueBranches(potentialBranches);
         potentialBranches.clear();
-        // If we did not find any new nodes, fall back to random.
-        executionState = popRandomBranch(unexploredBranches).nextState;
+        // If we did not find any new nodes, move towards the closest uncovered node.
+        executionState = popClosestBranch().nextState;
     }
 }
 
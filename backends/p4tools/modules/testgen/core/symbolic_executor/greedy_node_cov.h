@@ -1,10 +1,15 @@
 #ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_GREEDY_NODE_COV_H_
 #define BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_GREEDY_NODE_COV_H_
 
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <optional>
+#include <queue>
+#include <unordered_map>
 #include <vector>
 
+#include "ir/node.h"
 #include "ir/solver.h"
 #include "midend/coverage.h"
 
@@ -21,6 +26,12 @@ namespace P4Tools::P4Testgen {
 /// expression. If the strategy does not find a new statement, it falls back to
 /// random. Similarly, if the strategy cycles without a test for a specific threshold, it will
 /// fall back to random. This is to prevent getting caught in a parser cycle.
+///
+/// When no branch covers new nodes right away, the strategy prefers the branch which is closest
+/// to an uncovered node, by the number of edges in the control-flow graph of the program built
+/// by P4ProgramDCGCreator. The distances are computed again whenever the coverage grows, and
+/// the pending branches are kept in a priority queue by distance. Branches which can not reach
+/// an uncovered node in the graph are picked at random.
 class GreedyNodeSelection : public SymbolicExecutor {
  public:
     /// Executes the P4 program along a randomly chosen path. When the program terminates, the
@@ -49,16 +60,62 @@ class GreedyNodeSelection : public SymbolicExecutor {
     ///   - Each element's path constraints are satisfiable.
     std::vector<Branch> potentialBranches;
 
-    /// General unexplored branches.
-    // Each element on this vector represents a set of alternative choices that could have been
-    /// made along the current execution path.
+    /// The distance of a branch which can not reach an uncovered node.
+    static constexpr uint64_t UNREACHABLE = std::numeric_limits<uint64_t>::max();
+
+    /// An unexplored branch, with its distance to an uncovered node when it was queued.
+    struct QueuedBranch {
+        uint64_t distance;
+        /// The number of branches queued before this one. Among branches at the same distance,
+        /// the most recent one is explored first.
+        uint64_t order;
+        Branch branch;
+
+        bool operator<(const QueuedBranch &other) const {
+            return distance != other.distance ? distance > other.distance
+                                              : order < other.order;
+        }
+    };
+
+    /// General unexplored branches which may reach an uncovered node, closest first.
     ///
     /// Invariants:
-    ///   - Each element of this vector is non-empty.
     ///   - Each element's path constraints are satisfiable.
     ///   - There are no nodes associated with the element's execution state that are
     ///   uncovered.
-    std::vector<Branch> unexploredBranches;
+    ///   - The distance of each element is at most its current distance, as distances only grow
+    ///   with the coverage.
+    std::priority_queue<QueuedBranch> unexploredBranches;
+
+    /// General unexplored branches which can not reach an uncovered node.
+    std::vector<Branch> unreachableBranches;
+
+    /// The number of branches queued so far.
+    uint64_t queuedBranches = 0;
+
+    /// The predecessors of each node in the control-flow graph of the program.
+    std::unordered_map<const IR::Node *, std::vector<const IR::Node *>> predecessors;
+
+    /// The distance of each node in the control-flow graph to the closest uncovered node.
+    /// Nodes which can not reach an uncovered node are missing.
+    std::unordered_map<const IR::Node *, uint64_t> distances;
+
+    /// The number of visited nodes when @ref distances was computed.
+    size_t distancesCoverage = std::numeric_limits<size_t>::max();
+
+    /// Computes @ref distances again if the coverage has grown.
+    void updateDistances();
+
+    /// @returns the distance of @param branch to the closest uncovered node. This is the
+    /// distance of the next statement of the branch or of its potential nodes.
+    uint64_t getDistance(const Branch &branch);
+
+    /// Adds @param branches to the unexplored branches.
+    void queueBranches(const std::vector<Branch> &branches);
+
+    /// Pops the unexplored branch closest to an uncovered node, or a random one if none of them
+    /// can reach an uncovered node. A BUG occurs if there are no unexplored branches.
+    Branch popClosestBranch();
 
     /// Iterate over all the input branches in @param candidateBranches and try to find a branch
     /// which contains nodes that are not in @param coverednodes yet. Return the first
@@ -73,7 +130,8 @@ class GreedyNodeSelection : public SymbolicExecutor {
     /// left, return false.
     /// 2. If there are successors left, try to find a successor that covers new nodes. Set the
     /// nextState as this successors state.
-    /// 3. If no successor with new nodes was found set a random successor.
+    /// 3. If no successor with new nodes was found, set the successor closest to an uncovered
+    /// node, or a random successor if none can reach one.
     [[nodiscard]] std::optional<ExecutionStateReference> pickSuccessor(StepResult successors);
 };
 
@@ -0,0 +1,166 @@
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/parallel_dfs.h"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#ifdef MULTITHREAD
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#endif
+
+#include "backends/p4tools/common/core/z3_solver.h"
+#include "backends/p4tools/common/lib/util.h"
+#include "ir/solver.h"
+
+#include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/depth_first.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+#include "backends/p4tools/modules/testgen/lib/execution_state.h"
+#include "backends/p4tools/modules/testgen/lib/final_state.h"
+#include "backends/p4tools/modules/testgen/options.h"
+
+namespace P4Tools::P4Testgen {
+
+ParallelDepthFirstSearch::ParallelDepthFirstSearch(AbstractSolver &solver,
+                                                   const ProgramInfo &programInfo,
+                                                   unsigned workers)
+    : SymbolicExecutor(solver, programInfo), workers(std::max(workers, 1U)) {}
+
+void ParallelDepthFirstSearch::runSequentially(const Callback &callBack,
+                                               const std::vector<ExecutionStateReference> &tasks) {
+    for (size_t index = 0; index < tasks.size(); index++) {
+        Utils::seedThreadRandom(index);
+        bool terminate = false;
+        DepthFirstSearch search(solver, programInfo);
+        search.runImpl(
+            [&](const FinalState &finalState) {
+                terminate = handleTerminalState(callBack, *finalState.getExecutionState());
+                return terminate;
+            },
+            tasks[index]);
+        if (terminate) {
+            return;
+        }
+    }
+}
+
+void ParallelDepthFirstSearch::runImpl(const Callback &callBack,
+                                       ExecutionStateReference executionState) {
+    auto tasks = splitPaths(executionState, workers * TASKS_PER_WORKER);
+#ifdef MULTITHREAD
+    if (workers == 1 || tasks.size() <= 1) {
+        runSequentially(callBack, tasks);
+        return;
+    }
+
+    // The terminal states of each task, which the workers produce and the calling thread
+    // consumes in task order.
+    struct TaskResults {
+        std::deque<const ExecutionState *> states;
+        bool finished = false;
+    };
+    std::vector<TaskResults> results(tasks.size());
+    std::mutex resultsLock;
+    std::condition_variable resultsChanged;
+    bool stop = false;
+    std::atomic<size_t> next(0);
+    std::exception_ptr failure;
+
+    auto publish = [&](size_t index, const ExecutionState *state) {
+        std::unique_lock<std::mutex> acquire(resultsLock);
+        resultsChanged.wait(acquire, [&]() {
+            return stop || results[index].states.size() < MAX_PENDING_STATES;
+        });
+        if (!stop) {
+            results[index].states.push_back(state);
+        }
+        resultsChanged.notify_all();
+        return stop;
+    };
+    auto worker = [&]() {
+        // The solver is only used by this thread, as Z3 contexts cannot be shared.
+        Z3Solver workerSolver;
+        workerSolver.enableQueryCache(TestgenOptions::get().solverQueryCache);
+        workerSolver.enableAssumptionLiterals(TestgenOptions::get().solverAssumptions);
+        size_t index = 0;
+        while ((index = next++) < tasks.size()) {
+            try {
+                Utils::seedThreadRandom(index);
+                DepthFirstSearch search(workerSolver, programInfo);
+                search.runImpl(
+                    [&](const FinalState &finalState) {
+                        return publish(index, finalState.getExecutionState());
+                    },
+                    tasks[index]);
+            } catch (...) {
+                std::lock_guard<std::mutex> acquire(resultsLock);
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+                stop = true;
+                next = tasks.size();
+            }
+            std::lock_guard<std::mutex> acquire(resultsLock);
+            results[index].finished = true;
+            resultsChanged.notify_all();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < std::min<size_t>(workers, tasks.size()); ++i) {
+        threads.emplace_back(worker);
+    }
+
+    auto stopWorkers = [&]() {
+        {
+            std::lock_guard<std::mutex> acquire(resultsLock);
+            stop = true;
+        }
+        resultsChanged.notify_all();
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    };
+    // Returns the next terminal state of the task @p index, or nullptr once it is finished.
+    auto nextState = [&](size_t index) -> const ExecutionState * {
+        std::unique_lock<std::mutex> acquire(resultsLock);
+        resultsChanged.wait(acquire, [&]() {
+            return stop || results[index].finished || !results[index].states.empty();
+        });
+        if (stop || results[index].states.empty()) {
+            return nullptr;
+        }
+        const auto *state = results[index].states.front();
+        results[index].states.pop_front();
+        resultsChanged.notify_all();
+        return state;
+    };
+    try {
+        bool terminate = false;
+        for (size_t index = 0; index < tasks.size() && !terminate; index++) {
+            while (const auto *state = nextState(index)) {
+                // The model is computed again with the solver of this executor.
+                terminate = handleTerminalState(callBack, *state);
+                if (terminate) {
+                    break;
+                }
+            }
+        }
+    } catch (...) {
+        stopWorkers();
+        throw;
+    }
+    stopWorkers();
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+#else
+    runSequentially(callBack, tasks);
+#endif  // MULTITHREAD
+}
+
+}  // namespace P4Tools::P4Testgen
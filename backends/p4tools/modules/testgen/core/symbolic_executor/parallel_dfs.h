@@ -0,0 +1,54 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_PARALLEL_DFS_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_PARALLEL_DFS_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "ir/solver.h"
+
+#include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+
+namespace P4Tools::P4Testgen {
+
+/// A depth-first traversal strategy that explores the program on several threads.
+/// The executor first expands the paths of the program until it has a few tasks per thread,
+/// keeping them in the order in which a depth-first search would reach them. Each worker thread
+/// has its own solver and runs a DepthFirstSearch on the next task nobody has taken yet. The
+/// terminal states of the tasks are handed back to the calling thread, which processes them in
+/// task order with the solver of this executor. Coverage and the number of tests are therefore
+/// accounted for globally, and the generated tests do not depend on thread scheduling: the
+/// random values drawn by a task only depend on the seed and on the index of the task.
+/// Without MULTITHREAD, the tasks are explored one after the other.
+class ParallelDepthFirstSearch : public SymbolicExecutor {
+ public:
+    /// Executes the P4 program along paths explored by the worker threads. When the program
+    /// terminates, the given callback is invoked on the calling thread. If the callback returns
+    /// true, then the executor stops the workers and terminates.
+    void runImpl(const Callback &callBack, ExecutionStateReference executionState) override;
+
+    /// Constructor for this strategy, considering inheritance. @param workers is the number of
+    /// threads which explore paths.
+    ParallelDepthFirstSearch(AbstractSolver &solver, const ProgramInfo &programInfo,
+                             unsigned workers);
+
+ private:
+    /// Number of tasks created for each worker, so that the workers which finish early can take
+    /// the tasks of the others.
+    static constexpr size_t TASKS_PER_WORKER = 4;
+
+    /// Number of terminal states a worker may have waiting for the calling thread before it
+    /// pauses, which bounds the memory used by workers ahead of the current task.
+    static constexpr size_t MAX_PENDING_STATES = 256;
+
+    /// Number of threads which explore paths.
+    unsigned workers;
+
+    /// Explores the tasks one after the other on the calling thread.
+    void runSequentially(const Callback &callBack,
+                         const std::vector<ExecutionStateReference> &tasks);
+};
+
+}  // namespace P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_PARALLEL_DFS_H_ */
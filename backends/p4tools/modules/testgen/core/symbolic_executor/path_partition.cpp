@@ -0,0 +1,29 @@
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/path_partition.h"
+
+#include <ostream>
+
+#include "ir/solver.h"
+
+#include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+#include "backends/p4tools/modules/testgen/lib/execution_state.h"
+
+namespace P4Tools::P4Testgen {
+
+PathPartition::PathPartition(AbstractSolver &solver, const ProgramInfo &programInfo,
+                             size_t partitions, std::ostream &output)
+    : SymbolicExecutor(solver, programInfo), partitions(partitions), output(output) {}
+
+void PathPartition::runImpl(const Callback & /*callBack*/,
+                            ExecutionStateReference executionState) {
+    for (const auto &state : splitPaths(executionState, partitions)) {
+        const char *separator = "";
+        for (auto branch : state.get().getSelectedBranches()) {
+            output << separator << branch;
+            separator = ",";
+        }
+        output << std::endl;
+    }
+}
+
+}  // namespace P4Tools::P4Testgen
@@ -0,0 +1,40 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_PATH_PARTITION_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_PATH_PARTITION_H_
+
+#include <cstddef>
+#include <iosfwd>
+
+#include "ir/solver.h"
+
+#include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+
+namespace P4Tools::P4Testgen {
+
+/// Splits the paths of the program into partitions, which separate P4Testgen processes can
+/// explore with --branch-prefix. Each partition is described by the branches selected to reach
+/// it, and the partitions cover all the paths of the program between them. No tests are
+/// generated and the callback is never invoked.
+class PathPartition : public SymbolicExecutor {
+ public:
+    /// Writes the branch prefixes of the partitions to the output, one per line, in the format
+    /// of --branch-prefix.
+    void runImpl(const Callback &callBack, ExecutionStateReference executionState) override;
+
+    /// Constructor for this strategy, considering inheritance. Produces at least
+    /// @param partitions partitions, unless the program has fewer paths, and writes them to
+    /// @param output.
+    PathPartition(AbstractSolver &solver, const ProgramInfo &programInfo, size_t partitions,
+                  std::ostream &output);
+
+ private:
+    /// The minimum number of partitions.
+    size_t partitions;
+
+    /// The stream the branch prefixes are written to.
+    std::ostream &output;
+};
+
+}  // namespace P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_PATH_PARTITION_H_ */
@@ -11,6 +11,7 @@
 #include "lib/exceptions.h"
 
 #include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/depth_first.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
 #include "backends/p4tools/modules/testgen/options.h"
 
@@ -19,14 +20,13 @@ namespace P4Tools::P4Testgen {
 void SelectedBranches::runImpl(const Callback &callBack, ExecutionStateReference executionState) {
     try {
         while (!executionState.get().isTerminal()) {
-            StepResult successors = step(executionState);
-            // Assign branch ids to the branches. These integer branch ids are used by
-            // track-branches and selected (input) branches features. Also populates
-            // exploredBranches from the initial set of branches.
-            for (uint64_t bIdx = 0; bIdx < successors->size(); ++bIdx) {
-                auto &succ = (*successors)[bIdx];
-                succ.nextState.get().pushBranchDecision(bIdx + 1);
+            if (explorePathsBelow && selectedBranches.empty()) {
+                // The prefix is consumed, explore the paths below it.
+                DepthFirstSearch(solver, programInfo).runImpl(callBack, executionState);
+                return;
             }
+            // The step assigns branch ids to the successors of branching steps.
+            StepResult successors = step(executionState);
             if (successors->size() == 1) {
                 // Non-branching states are not recorded by selected branches.
                 executionState = (*successors)[0].nextState;
@@ -77,8 +77,13 @@ uint64_t getNumeric(const std::string &str) {
 }
 
 SelectedBranches::SelectedBranches(AbstractSolver &solver, const ProgramInfo &programInfo,
-                                   std::string selectedBranchesStr)
-    : SymbolicExecutor(solver, programInfo) {
+                                   std::string selectedBranchesStr, bool explorePathsBelow)
+    : SymbolicExecutor(solver, programInfo), explorePathsBelow(explorePathsBelow) {
+    selectBranches(std::move(selectedBranchesStr));
+}
+
+void SelectedBranches::selectBranches(std::string selectedBranchesStr) {
+    selectedBranches.clear();
     size_t n = 0;
     auto str = std::move(selectedBranchesStr);
     while ((n = str.find(',')) != std::string::npos) {
@@ -14,7 +14,8 @@
 
 namespace P4Tools::P4Testgen {
 
-/// Explores one path described by a list of branches.
+/// Explores one path described by a list of branches. Alternatively, the list is the prefix of
+/// a set of paths, which are explored depth-first once the prefix is consumed.
 class SelectedBranches : public SymbolicExecutor {
  public:
     /// Executes the P4 program along a randomly chosen path. When the program terminates, the
@@ -22,9 +23,14 @@ class SelectedBranches : public SymbolicExecutor {
     /// Otherwise, execution of the P4 program continues on a different random path.
     void runImpl(const Callback &callBack, ExecutionStateReference executionState) override;
 
-    /// Constructor for this strategy, considering inheritance
+    /// Constructor for this strategy, considering inheritance. If @param explorePathsBelow is
+    /// set, @param selectedBranchesStr is a prefix and all the paths below it are explored.
     SelectedBranches(AbstractSolver &solver, const ProgramInfo &programInfo,
-                     std::string selectedBranchesStr);
+                     std::string selectedBranchesStr, bool explorePathsBelow = false);
+
+    /// Replaces the selected branches with @param selectedBranchesStr, so that the next run
+    /// explores a different path.
+    void selectBranches(std::string selectedBranchesStr);
 
  private:
     /// Chooses a branch corresponding to a given branch identifier.
@@ -34,6 +40,9 @@ class SelectedBranches : public SymbolicExecutor {
 
     /// The list of selected branches.
     std::list<uint64_t> selectedBranches;
+
+    /// Whether to explore all the paths below the selected branches.
+    bool explorePathsBelow;
 };
 
 }  // namespace P4Tools::P4Testgen
@@ -1,14 +1,18 @@
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <iterator>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "backends/p4tools/common/lib/conflict_check.h"
+#include "backends/p4tools/common/lib/model.h"
 #include "backends/p4tools/common/lib/util.h"
 #include "ir/ir.h"
+#include "ir/irutils.h"
 #include "ir/solver.h"
 #include "lib/error.h"
 #include "lib/timer.h"
@@ -17,8 +21,11 @@
 #include "backends/p4tools/modules/testgen/core/program_info.h"
 #include "backends/p4tools/modules/testgen/core/small_step/small_step.h"
 #include "backends/p4tools/modules/testgen/lib/execution_state.h"
+#include "backends/p4tools/modules/testgen/lib/exceptions.h"
 #include "backends/p4tools/modules/testgen/lib/final_state.h"
 #include "backends/p4tools/modules/testgen/lib/logging.h"
+#include "backends/p4tools/modules/testgen/lib/packet_vars.h"
+#include "backends/p4tools/modules/testgen/options.h"
 
 namespace P4Tools::P4Testgen {
 
@@ -34,9 +41,56 @@ SymbolicExecutor::StepResult SymbolicExecutor::step(ExecutionState &state) {
         std::remove_if(successors->begin(), successors->end(),
                        [this](const Branch &b) -> bool { return !evaluateBranch(b, solver); }),
         successors->end());
+    // Record the decision at branching steps. These integer branch ids are used by the
+    // track-branches and selected (input) branches features.
+    if (successors->size() > 1) {
+        for (uint64_t bIdx = 0; bIdx < successors->size(); ++bIdx) {
+            (*successors)[bIdx].nextState.get().pushBranchDecision(bIdx + 1);
+        }
+    }
     return successors;
 }
 
+std::vector<ExecutionStateReference> SymbolicExecutor::splitPaths(
+    ExecutionStateReference executionState, size_t count) {
+    Util::ScopedTimer splitPathsTimer("path_split");
+    std::vector<ExecutionStateReference> paths{executionState};
+    // Expand the states in turns, so that the resulting states split the program evenly.
+    // Successors replace their state in place, which keeps the states in depth-first order.
+    size_t next = 0;
+    while (paths.size() < count) {
+        auto isOpen = [](const ExecutionState &state) { return !state.isTerminal(); };
+        auto it = std::find_if(paths.begin() + next, paths.end(), isOpen);
+        if (it == paths.end()) {
+            it = std::find_if(paths.begin(), paths.end(), isOpen);
+        }
+        if (it == paths.end()) {
+            break;
+        }
+        std::vector<ExecutionStateReference> successors;
+        try {
+            StepResult result = step(*it);
+            for (const auto &branch : *result) {
+                successors.push_back(branch.nextState);
+            }
+        } catch (TestgenUnimplemented &e) {
+            // If strict is enabled, bubble the exception up.
+            if (TestgenOptions::get().strict) {
+                throw;
+            }
+            // Otherwise we drop the path, as the depth-first search would.
+            ::warning("Path encountered unimplemented feature. Message: %1%\n", e.what());
+        }
+        it = paths.erase(it);
+        next = it - paths.begin() + successors.size();
+        paths.insert(it, successors.begin(), successors.end());
+        if (next >= paths.size()) {
+            next = 0;
+        }
+    }
+    return paths;
+}
+
 void SymbolicExecutor::run(const Callback &callBack) {
     runImpl(callBack, ExecutionState::create(&programInfo.getP4Program()));
 }
@@ -56,6 +110,10 @@ bool SymbolicExecutor::handleTerminalState(const Callback &callback,
         return false;
     }
 
+    if (TestgenOptions::get().minimizePacketSize) {
+        minimizeInputPacketSize(terminalState);
+    }
+
     // Get the model from the solver, complete it with respect to the
     // final symbolic environment and trace, use it to evaluate the
     // final execution state, and finally delegate to the callback.
@@ -63,6 +121,50 @@ bool SymbolicExecutor::handleTerminalState(const Callback &callback,
     return callback(finalState);
 }
 
+void SymbolicExecutor::minimizeInputPacketSize(const ExecutionState &terminalState) {
+    const auto *packetSizeVar = ExecutionState::getInputPacketSizeVar();
+    const auto *packetSize = Model(solver.getSymbolicMapping()).get(packetSizeVar, false);
+    if (packetSize == nullptr) {
+        return;
+    }
+    // Binary search between the size of the bits the program reads and the size of the current
+    // model, which is satisfiable.
+    big_int lowerBound = terminalState.getInputPacket()->type->width_bits();
+    big_int upperBound = packetSize->checkedTo<IR::Constant>()->value;
+    bool upperBoundModel = true;
+    auto checkSizeAtMost = [this, &terminalState, packetSizeVar](big_int size) {
+        auto pathConstraint = terminalState.getPathConstraint();
+        pathConstraint.push_back(new IR::Leq(
+            IR::Type::Boolean::get(), packetSizeVar,
+            IR::getConstant(&PacketVars::PACKET_SIZE_VAR_TYPE, size)));
+        return solver.checkSat(pathConstraint);
+    };
+    while (lowerBound < upperBound) {
+        big_int size = lowerBound + (upperBound - lowerBound) / 2;
+        auto solverResult = checkSizeAtMost(size);
+        if (!solverResult.has_value()) {
+            // Keep the smallest size found so far.
+            break;
+        }
+        upperBoundModel = *solverResult;
+        if (*solverResult) {
+            upperBound = size;
+        } else {
+            lowerBound = size + 1;
+        }
+    }
+    if (upperBoundModel) {
+        return;
+    }
+    // The search ended with another query, the solver has to find a model for the size again.
+    if (checkSizeAtMost(upperBound).value_or(false)) {
+        return;
+    }
+    auto solverResult = solver.checkSat(terminalState.getPathConstraint());
+    BUG_CHECK(solverResult.value_or(false),
+              "The path constraints of a terminal state are no longer satisfiable.");
+}
+
 bool SymbolicExecutor::evaluateBranch(const SymbolicExecutor::Branch &branch,
                                       AbstractSolver &solver) {
     // Do not bother invoking the solver for a trivial case.
@@ -71,8 +173,13 @@ bool SymbolicExecutor::evaluateBranch(const SymbolicExecutor::Branch &branch,
         return boolLiteral->value;
     }
 
-    // Check the consistency of the path constraints asserted so far.
-    auto solverResult = solver.checkSat(branch.nextState.get().getPathConstraint());
+    // Check the consistency of the path constraints asserted so far. Obvious contradictions
+    // with the earlier constraints do not need the solver.
+    auto pathConstraint = branch.nextState.get().getPathConstraint();
+    if (ConflictCheck::contradicts(pathConstraint, branch.constraint)) {
+        return false;
+    }
+    auto solverResult = solver.checkSat(pathConstraint);
     if (solverResult == std::nullopt) {
         ::warning("Solver timed out");
     }
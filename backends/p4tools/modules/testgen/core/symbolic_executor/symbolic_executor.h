@@ -1,6 +1,7 @@
 #ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_SYMBOLIC_EXECUTOR_H_
 #define BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_SYMBOLIC_EXECUTOR_H_
 
+#include <cstddef>
 #include <functional>
 #include <iosfwd>
 #include <vector>
@@ -79,6 +80,13 @@ class SymbolicExecutor {
     /// Take one step in the program and return list of possible branches.
     StepResult step(ExecutionState &state);
 
+    /// Expands the paths starting at @param executionState until there are at least @param count
+    /// states or all of them are terminal. Returns the states in depth-first order; the paths
+    /// below them partition the paths of the program. Each state records the decisions taken
+    /// at branching steps, which selected branches accept as a prefix.
+    std::vector<ExecutionStateReference> splitPaths(ExecutionStateReference executionState,
+                                                    size_t count);
+
     /// Take a branch and a solver as input.
     /// Compute the branch's path conditions using the solver.
     /// Return true if the solver can find a solution and does not time out.
@@ -91,6 +99,12 @@ class SymbolicExecutor {
 
  private:
     SmallStepEvaluator evaluator;
+
+    /// Searches the smallest input packet size with which the path constraints of
+    /// @param terminalState remain satisfiable, see --minimize-packet-size. The path constraints
+    /// must be satisfiable. Afterwards, the last query of the solver is satisfiable and its
+    /// model has the smallest input packet size found.
+    void minimizeInputPacketSize(const ExecutionState &terminalState);
 };
 
 }  // namespace P4Tools::P4Testgen
@@ -98,9 +98,15 @@ bool ConcolicResolver::preorder(const IR::ConcolicVariable *var) {
     // Convert the concolic member variable to a state variable.
     auto concolicReplacment = resolvedConcolicVariables.find(*var);
     if (concolicReplacment == resolvedConcolicVariables.end()) {
+        // Resolve the concolic variables this variable depends on first.
+        visit(var->arguments, "arguments");
         bool found = concolicMethodImpls.exec(concolicMethodName, var, state, evaluatedModel,
                                               &resolvedConcolicVariables);
         BUG_CHECK(found, "Unknown or unimplemented concolic method: %1%", concolicMethodName);
+        concolicReplacment = resolvedConcolicVariables.find(*var);
+    }
+    if (concolicReplacment != resolvedConcolicVariables.end()) {
+        evaluatedModel.set(var, concolicReplacment->second);
     }
     return false;
 }
@@ -54,6 +54,11 @@ class ConcolicMethodImpls {
     void add(const ImplList &implList);
 };
 
+/// Resolves the concolic variables in the visited expressions. Each variable is resolved after
+/// the concolic variables in its arguments. The value of a resolved variable is bound in the
+/// model, so that the variables which depend on it see the computed value instead of the value
+/// the solver chose for it. All resolved values are consistent after one pass and can be checked
+/// with a single call to the solver.
 class ConcolicResolver : public Inspector {
  public:
     explicit ConcolicResolver(const Model &evaluatedModel, const ExecutionState &state,
@@ -72,7 +77,8 @@ class ConcolicResolver : public Inspector {
     const ExecutionState &state;
 
     /// The evaluated model is queried to produce a (random) assignment for concolic inputs.
-    const Model &evaluatedModel;
+    /// Resolved concolic variables are bound in this copy.
+    Model evaluatedModel;
 
     /// A map of the concolic variables and the assertion associated with the variable. These
     /// assertions are used to add constraints to the solver.
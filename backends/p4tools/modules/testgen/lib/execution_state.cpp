@@ -107,12 +107,12 @@ ExecutionState &ExecutionState::clone() const { return *new ExecutionState(*this
 
 bool ExecutionState::isTerminal() const { return body.empty() && stack.empty(); }
 
-const std::vector<uint64_t> &ExecutionState::getSelectedBranches() const {
-    return selectedBranches;
+std::vector<uint64_t> ExecutionState::getSelectedBranches() const {
+    return selectedBranches.toVector();
 }
 
-const std::vector<const IR::Expression *> &ExecutionState::getPathConstraint() const {
-    return pathConstraint;
+std::vector<const IR::Expression *> ExecutionState::getPathConstraint() const {
+    return pathConstraint.toVector();
 }
 
 std::optional<const Continuation::Command> ExecutionState::getNextCmd() const {
@@ -174,10 +174,12 @@ void ExecutionState::markVisited(const IR::Node *node) {
     if (node->is<IR::P4Action>() && !coverageOptions.coverActions) {
         return;
     }
-    visitedNodes.emplace(node);
+    visitedNodes.insert(node);
 }
 
-const P4::Coverage::CoverageSet &ExecutionState::getVisited() const { return visitedNodes; }
+const P4::Coverage::CoverageSet &ExecutionState::getVisited() const {
+    return visitedNodes.get();
+}
 
 /// Compare types, considering Extracted_Varbit and bits equal if the (real/extracted) sizes are
 /// equal. This is because the packet expression can be something like 0 ++
@@ -214,8 +216,8 @@ void ExecutionState::set(const IR::StateVariable &var, const IR::Expression *val
     env.set(var, value);
 }
 
-const std::vector<std::reference_wrapper<const TraceEvent>> &ExecutionState::getTrace() const {
-    return trace;
+std::vector<std::reference_wrapper<const TraceEvent>> ExecutionState::getTrace() const {
+    return trace.toVector();
 }
 
 const Continuation::Body &ExecutionState::getBody() const { return body; }
@@ -281,7 +283,7 @@ ReachabilityEngineState *ExecutionState::getReachabilityEngineState() const {
  *  Trace events.
  * ============================================================================================= */
 
-void ExecutionState::add(const TraceEvent &event) { trace.emplace_back(event); }
+void ExecutionState::add(const TraceEvent &event) { trace.push_back(event); }
 
 void ExecutionState::popBody() { body.pop(); }
 
@@ -408,6 +410,75 @@ int ExecutionState::getPacketBufferSize() const {
     return buffer->type->width_bits();
 }
 
+namespace {
+
+/// @returns the chunks of @param expr, i.e. the operands of the concatenations which form
+/// @param expr, from the most significant one.
+std::vector<const IR::Expression *> collectChunks(const IR::Expression *expr) {
+    std::vector<const IR::Expression *> chunks;
+    std::vector<const IR::Expression *> pending = {expr};
+    while (!pending.empty()) {
+        const auto *next = pending.back();
+        pending.pop_back();
+        if (const auto *concat = next->to<IR::Concat>()) {
+            pending.push_back(concat->right);
+            pending.push_back(concat->left);
+        } else {
+            chunks.push_back(next);
+        }
+    }
+    return chunks;
+}
+
+const IR::Expression *slicePacketExpression(const IR::Expression *expr, int hi, int lo);
+
+/// @returns bits [@param hi:@param lo] of @param chunk. A slice of a slice is folded.
+const IR::Expression *sliceChunk(const IR::Expression *chunk, int hi, int lo) {
+    if (lo == 0 && hi == chunk->type->width_bits() - 1) {
+        return chunk;
+    }
+    if (const auto *slice = chunk->to<IR::Slice>()) {
+        int base = static_cast<int>(slice->getL());
+        return slicePacketExpression(slice->e0, base + hi, base + lo);
+    }
+    auto *result = new IR::Slice(chunk, hi, lo);
+    result->type = IR::getBitType(hi - lo + 1);
+    return result;
+}
+
+/// @returns bits [@param hi:@param lo] of the packet expression @param expr. The packet is a
+/// concatenation of chunks, and the result is the concatenation of the chunks in the range, of
+/// which only the first and the last one may be sliced. Slices therefore do not nest, however
+/// often a packet is sliced.
+const IR::Expression *slicePacketExpression(const IR::Expression *expr, int hi, int lo) {
+    if (lo == 0 && hi == expr->type->width_bits() - 1) {
+        return expr;
+    }
+    auto chunks = collectChunks(expr);
+    const IR::Expression *result = nullptr;
+    // The position of the least significant bit of the current chunk.
+    int chunkLo = 0;
+    for (auto it = chunks.rbegin(); it != chunks.rend() && chunkLo <= hi; ++it) {
+        int chunkHi = chunkLo + (*it)->type->width_bits() - 1;
+        if (chunkHi >= lo && chunkHi >= chunkLo) {
+            const auto *part = sliceChunk(*it, std::min(hi, chunkHi) - chunkLo,
+                                          std::max(lo, chunkLo) - chunkLo);
+            if (result == nullptr) {
+                result = part;
+            } else {
+                const auto *width =
+                    IR::getBitType(part->type->width_bits() + result->type->width_bits());
+                result = new IR::Concat(width, part, result);
+            }
+        }
+        chunkLo = chunkHi + 1;
+    }
+    BUG_CHECK(result != nullptr, "Slice [%1%:%2%] is out of the bounds of %3%.", hi, lo, expr);
+    return result;
+}
+
+}  // namespace
+
 const IR::Expression *ExecutionState::peekPacketBuffer(int amount) {
     BUG_CHECK(amount > 0, "Peeked amount \"%1%\" should be larger than 0.", amount);
 
@@ -425,9 +496,7 @@ const IR::Expression *ExecutionState::peekPacketBuffer(int amount) {
         // If the buffer was not empty, append the data we have consumed to the newly generated
         // content and reset the buffer.
         if (bufferSize > 0) {
-            auto *slice = new IR::Slice(buffer, bufferSize - 1, 0);
-            slice->type = IR::getBitType(amount);
-            newVar = new IR::Concat(amountType, slice, newVar);
+            newVar = new IR::Concat(amountType, buffer, newVar);
             resetPacketBuffer();
         }
         // We have peeked ahead of what is available. We need to add the content we have looked at
@@ -436,9 +505,7 @@ const IR::Expression *ExecutionState::peekPacketBuffer(int amount) {
         return newVar;
     }
     // The buffer is large enough and we can grab a slice
-    auto *slice = new IR::Slice(buffer, bufferSize - 1, bufferSize - amount);
-    slice->type = amountType;
-    return slice;
+    return slicePacketExpression(buffer, bufferSize - 1, bufferSize - amount);
 }
 
 const IR::Expression *ExecutionState::slicePacketBuffer(int amount) {
@@ -467,9 +534,7 @@ const IR::Expression *ExecutionState::slicePacketBuffer(int amount) {
         // If the buffer was not empty, append the data we have consumed to the newly generated
         // content and reset the buffer.
         if (bufferSize > 0) {
-            auto *slice = new IR::Slice(buffer, bufferSize - 1, 0);
-            slice->type = IR::getBitType(amount);
-            newVar = new IR::Concat(amountType, slice, newVar);
+            newVar = new IR::Concat(amountType, buffer, newVar);
             resetPacketBuffer();
         }
         // Advance the cursor for bookkeeping.
@@ -477,12 +542,10 @@ const IR::Expression *ExecutionState::slicePacketBuffer(int amount) {
         return newVar;
     }
     // The buffer is large enough and we can grab a slice
-    auto *slice = new IR::Slice(buffer, bufferSize - 1, bufferSize - amount);
-    slice->type = amountType;
+    const auto *slice = slicePacketExpression(buffer, bufferSize - 1, bufferSize - amount);
     // If the buffer is larger, update the buffer with its remainder.
     if (diff < 0) {
-        auto *remainder = new IR::Slice(buffer, bufferSize - amount - 1, 0);
-        remainder->type = IR::getBitType(bufferSize - amount);
+        const auto *remainder = slicePacketExpression(buffer, bufferSize - amount - 1, 0);
         env.set(&PacketVars::PACKET_BUFFER_LABEL, remainder);
     }
     // The amount we slice is equal to what is in the buffer. Just set the buffer to zero.
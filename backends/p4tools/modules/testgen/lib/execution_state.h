@@ -15,6 +15,7 @@
 #include "backends/p4tools/common/compiler/reachability.h"
 #include "backends/p4tools/common/core/abstract_execution_state.h"
 #include "backends/p4tools/common/lib/namespace_context.h"
+#include "backends/p4tools/common/lib/persistent.h"
 #include "backends/p4tools/common/lib/symbolic_env.h"
 #include "backends/p4tools/common/lib/trace_event.h"
 #include "ir/declaration.h"
@@ -72,11 +73,15 @@ class ExecutionState : public AbstractExecutionState {
     ~ExecutionState() override = default;
 
  private:
+    // The trace, the visited nodes, the path constraints and the branch decisions grow along a
+    // path and are shared with the states this state was cloned from, so that cloning a state
+    // does not copy them.
+
     /// The program trace for the current program point (i.e., how we got to the current state).
-    std::vector<std::reference_wrapper<const TraceEvent>> trace;
+    PersistentVector<std::reference_wrapper<const TraceEvent>> trace;
 
     /// Set of visited nodes. Used for code coverage.
-    P4::Coverage::CoverageSet visitedNodes;
+    LayeredContainer<P4::Coverage::CoverageSet> visitedNodes;
 
     /// The remaining body of the current function being executed.
     ///
@@ -120,10 +125,10 @@ class ExecutionState : public AbstractExecutionState {
 
     /// List of path constraints - expressions that must all evaluate to true to reach this
     /// execution state.
-    std::vector<const IR::Expression *> pathConstraint;
+    PersistentVector<const IR::Expression *> pathConstraint;
 
     /// List of branch decisions leading into this state.
-    std::vector<uint64_t> selectedBranches;
+    PersistentVector<uint64_t> selectedBranches;
 
     /// State that is needed to track reachability of nodes given a query.
     ReachabilityEngineState *reachabilityEngineState = nullptr;
@@ -146,10 +151,10 @@ class ExecutionState : public AbstractExecutionState {
     [[nodiscard]] bool isTerminal() const;
 
     /// @returns list of paths constraints.
-    [[nodiscard]] const std::vector<const IR::Expression *> &getPathConstraint() const;
+    [[nodiscard]] std::vector<const IR::Expression *> getPathConstraint() const;
 
     /// @returns list of branch decisions leading into this state.
-    [[nodiscard]] const std::vector<uint64_t> &getSelectedBranches() const;
+    [[nodiscard]] std::vector<uint64_t> getSelectedBranches() const;
 
     /// Adds path constraint.
     void pushPathConstraint(const IR::Expression *e);
@@ -169,7 +174,8 @@ class ExecutionState : public AbstractExecutionState {
     /// Checks whether the node has been visited in this state.
     void markVisited(const IR::Node *node);
 
-    /// @returns list of all nodes visited before reaching this state.
+    /// @returns list of all nodes visited before reaching this state. The reference is only valid
+    /// until the next call to @ref markVisited.
     [[nodiscard]] const P4::Coverage::CoverageSet &getVisited() const;
 
     /// Sets the symbolic value of the given state variable to the given value. Constant folding
@@ -177,7 +183,7 @@ class ExecutionState : public AbstractExecutionState {
     void set(const IR::StateVariable &var, const IR::Expression *value) override;
 
     /// @returns the current event trace.
-    [[nodiscard]] const std::vector<std::reference_wrapper<const TraceEvent>> &getTrace() const;
+    [[nodiscard]] std::vector<std::reference_wrapper<const TraceEvent>> getTrace() const;
 
     /// @returns the current body.
     [[nodiscard]] const Continuation::Body &getBody() const;
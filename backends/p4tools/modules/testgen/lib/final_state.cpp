@@ -1,6 +1,7 @@
 #include "backends/p4tools/modules/testgen/lib/final_state.h"
 
 #include <list>
+#include <optional>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -15,6 +16,7 @@
 #include "ir/ir.h"
 #include "ir/irutils.h"
 #include "ir/solver.h"
+#include "ir/visitor.h"
 #include "lib/error.h"
 #include "lib/null.h"
 
@@ -26,19 +28,11 @@ namespace P4Tools::P4Testgen {
 FinalState::FinalState(AbstractSolver &solver, const ExecutionState &finalState)
     : solver(solver),
       state(finalState),
-      finalModel(processModel(finalState, *new Model(solver.getSymbolicMapping()))) {
-    for (const auto &event : finalState.getTrace()) {
-        trace.emplace_back(*event.get().evaluate(finalModel, true));
-    }
-}
+      finalModel(processModel(finalState, *new Model(solver.getSymbolicMapping()))) {}
 
 FinalState::FinalState(AbstractSolver &solver, const ExecutionState &finalState,
                        const Model &finalModel)
-    : solver(solver), state(finalState), finalModel(finalModel) {
-    for (const auto &event : finalState.getTrace()) {
-        trace.emplace_back(*event.get().evaluate(finalModel, true));
-    }
-}
+    : solver(solver), state(finalState), finalModel(finalModel) {}
 
 void FinalState::calculatePayload(const ExecutionState &executionState, Model &evaluatedModel) {
     const auto &packetBitSizeVar = ExecutionState::getInputPacketSizeVar();
@@ -65,6 +59,46 @@ Model &FinalState::processModel(const ExecutionState &finalState, Model &model,
     return model;
 }
 
+namespace {
+
+/// Checks whether all symbolic variables of the visited expressions are bound in a model.
+class BoundVariableCheck : public Inspector {
+    const Model &model;
+
+    bool allBound = true;
+
+    bool preorder(const IR::SymbolicVariable *var) override {
+        if (model.get(var, false) == nullptr) {
+            allBound = false;
+        }
+        return false;
+    }
+
+ public:
+    explicit BoundVariableCheck(const Model &model) : model(model) {}
+
+    [[nodiscard]] bool isBound() const { return allBound; }
+};
+
+}  // namespace
+
+bool FinalState::satisfies(const Model &model, const std::vector<const Constraint *> &asserts) {
+    for (const auto *assert : asserts) {
+        // Unbound variables would be completed with arbitrary values, which say nothing about
+        // whether the constraints are satisfiable.
+        BoundVariableCheck boundCheck(model);
+        assert->apply(boundCheck);
+        if (!boundCheck.isBound()) {
+            return false;
+        }
+        const auto *result = model.evaluate(assert, false)->to<IR::BoolLiteral>();
+        if (result == nullptr || !result->value) {
+            return false;
+        }
+    }
+    return true;
+}
+
 std::optional<std::reference_wrapper<const FinalState>> FinalState::computeConcolicState(
     const ConcolicVariableMap &resolvedConcolicVariables) const {
     // If there are no new concolic variables, there is nothing to do.
@@ -72,6 +106,8 @@ std::optional<std::reference_wrapper<const FinalState>> FinalState::computeConco
         return *this;
     }
     std::vector<const Constraint *> asserts = state.get().getPathConstraint();
+    // The current model with the resolved concolic variables bound to their computed values.
+    auto *concolicModel = new Model(finalModel.get());
 
     for (const auto &resolvedConcolicVariable : resolvedConcolicVariables) {
         const auto &concolicVariable = resolvedConcolicVariable.first;
@@ -79,8 +115,9 @@ std::optional<std::reference_wrapper<const FinalState>> FinalState::computeConco
         const IR::Expression *pathConstraint = nullptr;
         // We need to differentiate between state variables and expressions here.
         if (std::holds_alternative<IR::ConcolicVariable>(concolicVariable)) {
-            pathConstraint = new IR::Equ(std::get<IR::ConcolicVariable>(concolicVariable).clone(),
-                                         concolicAssignment);
+            const auto *var = std::get<IR::ConcolicVariable>(concolicVariable).clone();
+            concolicModel->set(var, concolicAssignment);
+            pathConstraint = new IR::Equ(var, concolicAssignment);
         } else if (std::holds_alternative<const IR::Expression *>(concolicVariable)) {
             pathConstraint =
                 new IR::Equ(std::get<const IR::Expression *>(concolicVariable), concolicAssignment);
@@ -90,6 +127,11 @@ std::optional<std::reference_wrapper<const FinalState>> FinalState::computeConco
         pathConstraint = P4::optimizeExpression(pathConstraint);
         asserts.push_back(pathConstraint);
     }
+    // The resolver computes all concolic variables from one assignment. If the path does not
+    // constrain the computed values, that assignment is still a solution.
+    if (satisfies(*concolicModel, asserts)) {
+        return *new FinalState(solver, state, *concolicModel);
+    }
     auto solverResult = solver.get().checkSat(asserts);
     if (!solverResult) {
         ::warning("Timed out trying to solve this concolic execution path.");
@@ -114,7 +156,13 @@ AbstractSolver &FinalState::getSolver() const { return solver; }
 const ExecutionState *FinalState::getExecutionState() const { return &state.get(); }
 
 const std::vector<std::reference_wrapper<const TraceEvent>> *FinalState::getTraces() const {
-    return &trace;
+    if (!trace.has_value()) {
+        trace.emplace();
+        for (const auto &event : state.get().getTrace()) {
+            trace->emplace_back(*event.get().evaluate(finalModel, true));
+        }
+    }
+    return &trace.value();
 }
 
 const P4::Coverage::CoverageSet &FinalState::getVisited() const { return state.get().getVisited(); }
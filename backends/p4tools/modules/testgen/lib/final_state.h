@@ -28,8 +28,10 @@ class FinalState {
     /// The final model which has been augmented with environment completions.
     std::reference_wrapper<const Model> finalModel;
 
-    /// The final program trace.
-    std::vector<std::reference_wrapper<const TraceEvent>> trace;
+    /// The final program trace. Evaluating the trace events clones them with concrete values,
+    /// which is only worth it for states a test is generated for. The trace is therefore
+    /// evaluated on the first call to @ref getTraces.
+    mutable std::optional<std::vector<std::reference_wrapper<const TraceEvent>>> trace;
 
     /// If the calculated payload size (the size of the symbolic packet size variable minus the size
     /// of the input packet) is not negative, create a randomly sized payload and add the variable
@@ -42,6 +44,10 @@ class FinalState {
     static Model &processModel(const ExecutionState &finalState, Model &model,
                                bool postProcess = true);
 
+    /// @returns true if @param model binds all symbolic variables in @param asserts and satisfies
+    /// each of them. Such a model does not need to be recomputed by the solver.
+    static bool satisfies(const Model &model, const std::vector<const Constraint *> &asserts);
+
  public:
     /// This constructor invokes @ref processModel() to produce the model based on the solver
     /// and the executionState.
@@ -52,7 +58,9 @@ class FinalState {
 
     /// If there are concolic variables in the program, compute a new final state by rerunning the
     /// solver on the concolic assignments. If the concolic assignment is not satisfiable, return
-    /// std::nullopt. Otherwise, create a new final state with the new assignment. IMPORTANT: Some
+    /// std::nullopt. Otherwise, create a new final state with the new assignment. The solver is
+    /// skipped if the current model together with the concolic assignments already satisfies all
+    /// constraints, which is the common case for resolved checksums. IMPORTANT: Some
     /// variables in this final state may have been added in post, e.g., the payload size. If the
     /// concolic variables do not recompute these variables, the model will simply copy these
     /// variables over manually to the newly generated model.
@@ -68,7 +76,8 @@ class FinalState {
     /// @returns the execution state of this final state.
     [[nodiscard]] const ExecutionState *getExecutionState() const;
 
-    /// @returns the computed traces of this final state.
+    /// @returns the computed traces of this final state. The traces are evaluated in the final
+    /// model on the first call.
     [[nodiscard]] const std::vector<std::reference_wrapper<const TraceEvent>> *getTraces() const;
 
     /// @returns the list of visited nodes of this state.
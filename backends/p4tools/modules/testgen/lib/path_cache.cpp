@@ -0,0 +1,127 @@
+#include "backends/p4tools/modules/testgen/lib/path_cache.h"
+
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include <inja/inja.hpp>
+
+#include "frontends/p4/toP4/toP4.h"
+#include "ir/visitor.h"
+#include "lib/error.h"
+#include "lib/hash.h"
+
+namespace P4Tools::P4Testgen {
+
+namespace {
+
+/// Computes the structural hash of every coverable node of the program.
+class NodeHasher : public Inspector {
+    const P4::Coverage::CoverageSet &coverableNodes;
+
+    std::map<const IR::Node *, uint64_t, P4::Coverage::SourceIdCmp> &nodeHashes;
+
+    bool preorder(const IR::Node *node) override {
+        if (coverableNodes.count(node) == 0) {
+            return true;
+        }
+        // Nodes with the same source in different declarations must have different hashes.
+        std::string key;
+        for (const auto *context = getContext(); context != nullptr; context = context->parent) {
+            if (const auto *decl = context->node->to<IR::IDeclaration>()) {
+                key = std::string(decl->getName().name.c_str()) + "." + key;
+            }
+        }
+        key += P4::toP4(node);
+        nodeHashes.emplace(node, Util::hash(key.data(), key.size()));
+        return true;
+    }
+
+ public:
+    NodeHasher(const P4::Coverage::CoverageSet &coverableNodes,
+               std::map<const IR::Node *, uint64_t, P4::Coverage::SourceIdCmp> &nodeHashes)
+        : coverableNodes(coverableNodes), nodeHashes(nodeHashes) {}
+};
+
+}  // namespace
+
+PathCache::PathCache(const IR::P4Program &program,
+                     const P4::Coverage::CoverageSet &coverableNodes) {
+    program.apply(NodeHasher(coverableNodes, nodeHashes));
+    for (const auto &[node, hash] : nodeHashes) {
+        programHashes.insert(hash);
+    }
+}
+
+void PathCache::record(int64_t testId, const ExecutionState &state) {
+    PathRecord pathRecord;
+    pathRecord.testId = testId;
+    std::stringstream branches;
+    for (auto branch : state.getSelectedBranches()) {
+        if (branches.tellp() > 0) {
+            branches << ',';
+        }
+        branches << branch;
+    }
+    pathRecord.branches = branches.str();
+    for (const auto *node : state.getVisited()) {
+        auto it = nodeHashes.find(node);
+        if (it != nodeHashes.end()) {
+            pathRecord.nodeHashes.push_back(it->second);
+        }
+    }
+    records[testId] = std::move(pathRecord);
+}
+
+void PathCache::keep(const PathRecord &pathRecord) { records[pathRecord.testId] = pathRecord; }
+
+bool PathCache::isUnchanged(const PathRecord &pathRecord) const {
+    for (auto hash : pathRecord.nodeHashes) {
+        if (programHashes.count(hash) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::optional<std::vector<PathCache::PathRecord>> PathCache::read(
+    const std::filesystem::path &path) {
+    std::ifstream cacheFile(path);
+    if (!cacheFile.is_open()) {
+        return std::nullopt;
+    }
+    std::vector<PathRecord> pathRecords;
+    std::string line;
+    while (std::getline(cacheFile, line)) {
+        try {
+            auto entry = inja::json::parse(line);
+            PathRecord pathRecord;
+            pathRecord.testId = entry.at("test_id").get<int64_t>();
+            pathRecord.branches = entry.at("branches").get<std::string>();
+            pathRecord.nodeHashes = entry.at("nodes").get<std::vector<uint64_t>>();
+            pathRecords.push_back(std::move(pathRecord));
+        } catch (const std::exception &e) {
+            ::error(ErrorType::ERR_IO, "Malformed path cache %1%: %2%", path.c_str(), e.what());
+            return std::nullopt;
+        }
+    }
+    return pathRecords;
+}
+
+void PathCache::write(const std::filesystem::path &path) const {
+    std::ofstream cacheFile(path);
+    if (!cacheFile.is_open()) {
+        ::error(ErrorType::ERR_IO, "Unable to open %1% for writing.", path.c_str());
+        return;
+    }
+    for (const auto &[testId, pathRecord] : records) {
+        inja::json entry;
+        entry["test_id"] = testId;
+        entry["branches"] = pathRecord.branches;
+        entry["nodes"] = pathRecord.nodeHashes;
+        cacheFile << entry.dump() << '\n';
+    }
+}
+
+}  // namespace P4Tools::P4Testgen
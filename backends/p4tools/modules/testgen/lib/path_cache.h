@@ -0,0 +1,73 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_PATH_CACHE_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_PATH_CACHE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ir/ir.h"
+#include "midend/coverage.h"
+
+#include "backends/p4tools/modules/testgen/lib/execution_state.h"
+
+namespace P4Tools::P4Testgen {
+
+/// Remembers the explored paths of a P4Testgen run, so that a later run on an edited program only
+/// regenerates the tests whose paths cover changed code. Each path is recorded as the branch
+/// decisions which lead to its test (in the format of --input-branches) and the structural
+/// hashes of the nodes it covered. The hash of a node covers its P4 source and the names of the
+/// declarations it is nested in, but not its source position, so that unrelated edits do not
+/// invalidate it. The cache file holds one JSON object per path and line.
+class PathCache {
+ public:
+    /// A path which produced a test.
+    struct PathRecord {
+        /// The id of the test produced by the path.
+        int64_t testId = 0;
+
+        /// The branch decisions which lead to the test, separated by commas.
+        std::string branches;
+
+        /// The structural hashes of the nodes covered by the path.
+        std::vector<uint64_t> nodeHashes;
+    };
+
+    /// Computes the structural hashes of the nodes in @param coverableNodes, which are nodes of
+    /// @param program.
+    PathCache(const IR::P4Program &program, const P4::Coverage::CoverageSet &coverableNodes);
+
+    /// Records the path of @param state, which produced the test @param testId. Replaces an
+    /// earlier record of the same test.
+    void record(int64_t testId, const ExecutionState &state);
+
+    /// Copies @param pathRecord from the cache file of an earlier run.
+    void keep(const PathRecord &pathRecord);
+
+    /// @returns true if all the nodes covered by @param pathRecord are still part of the program.
+    [[nodiscard]] bool isUnchanged(const PathRecord &pathRecord) const;
+
+    /// @returns the records of the cache file at @param path, or std::nullopt if there is no
+    /// such file. Reports an error if the file is malformed.
+    static std::optional<std::vector<PathRecord>> read(const std::filesystem::path &path);
+
+    /// Writes the records to the cache file at @param path.
+    void write(const std::filesystem::path &path) const;
+
+ private:
+    /// The structural hash of each coverable node of the program.
+    std::map<const IR::Node *, uint64_t, P4::Coverage::SourceIdCmp> nodeHashes;
+
+    /// The structural hashes of all coverable nodes of the program.
+    std::set<uint64_t> programHashes;
+
+    /// The recorded paths, ordered by their test id.
+    std::map<int64_t, PathRecord> records;
+};
+
+}  // namespace P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_PATH_CACHE_H_ */
@@ -1,7 +1,9 @@
 #include "backends/p4tools/modules/testgen/lib/test_backend.h"
 
+#include <memory>
 #include <optional>
 
+#include "backends/p4tools/common/core/portfolio_solver.h"
 #include "backends/p4tools/common/core/z3_solver.h"
 #include "backends/p4tools/common/lib/format_int.h"
 #include "backends/p4tools/common/lib/model.h"
@@ -22,7 +24,10 @@
 #include "backends/p4tools/modules/testgen/lib/final_state.h"
 #include "backends/p4tools/modules/testgen/lib/logging.h"
 #include "backends/p4tools/modules/testgen/lib/packet_vars.h"
+#include "backends/p4tools/modules/testgen/lib/path_cache.h"
+#include "backends/p4tools/modules/testgen/lib/test_emitter.h"
 #include "backends/p4tools/modules/testgen/lib/test_framework.h"
+#include "backends/p4tools/modules/testgen/lib/test_minimization.h"
 #include "backends/p4tools/modules/testgen/options.h"
 
 namespace P4Tools::P4Testgen {
@@ -47,7 +52,6 @@ bool TestBackEnd::run(const FinalState &state) {
         const auto *outputPacketExpr = executionState->getPacketBuffer();
         const auto *outputPortExpr = executionState->get(getProgramInfo().getTargetOutputPortVar());
         const auto &coverableNodes = getProgramInfo().getCoverableNodes();
-        const auto *programTraces = state.getTraces();
         const auto &testgenOptions = TestgenOptions::get();
 
         // Don't increase the test count if --output-packet-only is enabled and we don't
@@ -79,9 +83,13 @@ bool TestBackEnd::run(const FinalState &state) {
         // For long-running tests periodically reset the solver state to free up memory.
         if (testCount != 0 && testCount % RESET_THRESHOLD == 0) {
             auto &solver = state.getSolver();
-            auto *z3Solver = solver.to<Z3Solver>();
-            CHECK_NULL(z3Solver);
-            z3Solver->clearMemory();
+            if (auto *portfolioSolver = solver.to<PortfolioSolver>()) {
+                portfolioSolver->clearMemory();
+            } else {
+                auto *z3Solver = solver.to<Z3Solver>();
+                CHECK_NULL(z3Solver);
+                z3Solver->clearMemory();
+            }
         }
 
         bool abort = false;
@@ -113,7 +121,7 @@ bool TestBackEnd::run(const FinalState &state) {
         outputPortExpr = executionState->get(getProgramInfo().getTargetOutputPortVar());
 
         auto testInfo = produceTestInfo(executionState, &finalModel, outputPacketExpr,
-                                        outputPortExpr, programTraces);
+                                        outputPortExpr, replacedState.getTraces());
 
         // Add a list of tracked branches to the test output, too.
         std::stringstream selectedBranches;
@@ -140,6 +148,9 @@ bool TestBackEnd::run(const FinalState &state) {
         }
 
         testCount++;
+        if (pathCache != nullptr) {
+            pathCache->record(testCount, *executionState);
+        }
         const P4::Coverage::CoverageSet &visitedNodes = symbex.getVisitedNodes();
         if (!testgenOptions.hasCoverageTracking) {
             printFeature("test_info", 4, "============ Test %1% ============", testCount);
@@ -157,19 +168,18 @@ bool TestBackEnd::run(const FinalState &state) {
             P4::Coverage::logCoverage(coverableNodes, visitedNodes, executionState->getVisited());
         }
 
-        // Output the test.
-        Util::withTimer("backend", [this, &testSpec, &selectedBranches] {
-            if (testWriter->isInFileMode()) {
-                testWriter->writeTestToFile(testSpec, selectedBranches, testCount, coverage);
-            } else {
-                auto testOpt =
-                    testWriter->produceTest(testSpec, selectedBranches, testCount, coverage);
-                if (!testOpt.has_value()) {
-                    BUG("Failed to produce test.");
+        // Output the test, or hold it back until all tests are known.
+        if (testgenOptions.minimizeTests > 0) {
+            P4::Coverage::CoverageSet coveredNodes;
+            for (const auto *node : executionState->getVisited()) {
+                if (coverableNodes.count(node) > 0) {
+                    coveredNodes.insert(node);
                 }
-                tests.push_back(testOpt.value());
             }
-        });
+            candidateTests.push_back({testSpec, selectedBranches, coveredNodes});
+        } else {
+            writeTest(testSpec, selectedBranches, testCount, coverage);
+        }
 
         printTraces("============ End Test %1% ============\n", testCount);
         P4::Coverage::printCoverageReport(coverableNodes, visitedNodes);
@@ -271,8 +281,74 @@ bool TestBackEnd::printTestInfo(const ExecutionState * /*executionState*/, const
     return false;
 }
 
+void TestBackEnd::writeTest(const TestSpec *testSpec, cstring selectedBranches, int64_t testId,
+                            float testCoverage) {
+    Util::withTimer("backend", [this, testSpec, selectedBranches, testId, testCoverage] {
+        if (testWriter->isInFileMode()) {
+            if (testEmitter == nullptr) {
+                testEmitter = std::make_shared<TestEmitter>(
+                    *testWriter, TestgenOptions::get().testEmissionWorkers);
+            }
+            testEmitter->emit(testSpec, selectedBranches, testId, testCoverage);
+        } else {
+            auto testOpt =
+                testWriter->produceTest(testSpec, selectedBranches, testId, testCoverage);
+            if (!testOpt.has_value()) {
+                BUG("Failed to produce test.");
+            }
+            tests.push_back(testOpt.value());
+        }
+    });
+}
+
+void TestBackEnd::writeMinimizedTests() {
+    const auto &coverableNodes = getProgramInfo().getCoverableNodes();
+    std::vector<P4::Coverage::CoverageSet> testCoverage;
+    testCoverage.reserve(candidateTests.size());
+    for (const auto &candidateTest : candidateTests) {
+        testCoverage.push_back(candidateTest.coveredNodes);
+    }
+    auto selected = selectCoveringTests(testCoverage, TestgenOptions::get().minimizeTests);
+    printFeature("test_info", 4, "============ Minimized %1% tests to %2% tests ============",
+                 candidateTests.size(), selected.size());
+
+    // The selected tests are numbered again, their coverage only accounts for selected tests.
+    P4::Coverage::CoverageSet visitedNodes;
+    testCount = 0;
+    for (auto idx : selected) {
+        const auto &candidateTest = candidateTests[idx];
+        visitedNodes.insert(candidateTest.coveredNodes.begin(), candidateTest.coveredNodes.end());
+        float testCoverage = coverableNodes.empty()
+                                 ? 1.0F
+                                 : static_cast<float>(visitedNodes.size()) /
+                                       static_cast<float>(coverableNodes.size());
+        writeTest(candidateTest.testSpec, candidateTest.selectedBranches, ++testCount,
+                  testCoverage);
+    }
+    candidateTests.clear();
+}
+
+void TestBackEnd::finish() {
+    if (TestgenOptions::get().minimizeTests > 0) {
+        writeMinimizedTests();
+    }
+    if (testEmitter != nullptr) {
+        testEmitter->finish();
+        testWriter->finishTests();
+    }
+}
+
 int64_t TestBackEnd::getTestCount() const { return testCount; }
 
+void TestBackEnd::setTestCount(int64_t count) { testCount = count; }
+
+void TestBackEnd::setPathCache(PathCache *cache) { pathCache = cache; }
+
+bool TestBackEnd::writesTestsToSeparateFiles() const {
+    return testWriter->isInFileMode() && !testWriter->isInBatchMode() &&
+           testWriter->writesTestsToSeparateFiles();
+}
+
 float TestBackEnd::getCoverage() const { return coverage; }
 
 const ProgramInfo &TestBackEnd::getProgramInfo() const { return programInfo; }
@@ -3,17 +3,22 @@
 
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <vector>
 
 #include "backends/p4tools/common/lib/model.h"
 #include "backends/p4tools/common/lib/trace_event.h"
 #include "ir/ir.h"
+#include "lib/cstring.h"
+#include "midend/coverage.h"
 
 #include "backends/p4tools/modules/testgen/core/program_info.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
 #include "backends/p4tools/modules/testgen/lib/execution_state.h"
 #include "backends/p4tools/modules/testgen/lib/final_state.h"
+#include "backends/p4tools/modules/testgen/lib/path_cache.h"
+#include "backends/p4tools/modules/testgen/lib/test_emitter.h"
 #include "backends/p4tools/modules/testgen/lib/test_framework.h"
 #include "backends/p4tools/modules/testgen/lib/test_spec.h"
 #include "backends/p4tools/modules/testgen/options.h"
@@ -34,6 +39,31 @@ class TestBackEnd {
     /// Configuration options for the test back end.
     std::reference_wrapper<const TestBackendConfiguration> testBackendConfiguration;
 
+    /// Writes the tests in file mode, possibly in the background. Created with the first test.
+    std::shared_ptr<TestEmitter> testEmitter;
+
+    /// Records the path of every test, if set.
+    PathCache *pathCache = nullptr;
+
+    /// A test which is held back until the tests are minimized, see --minimize-tests.
+    struct CandidateTest {
+        const TestSpec *testSpec;
+        cstring selectedBranches;
+        /// The coverable nodes covered by the test.
+        P4::Coverage::CoverageSet coveredNodes;
+    };
+
+    /// The tests produced so far, if the tests are minimized.
+    std::vector<CandidateTest> candidateTests;
+
+    /// Writes the test @param testSpec with id @param testId. @param testCoverage is the coverage
+    /// of the tests up to this one.
+    void writeTest(const TestSpec *testSpec, cstring selectedBranches, int64_t testId,
+                   float testCoverage);
+
+    /// Writes the smallest subset of @ref candidateTests which keeps their coverage.
+    void writeMinimizedTests();
+
  protected:
     /// Writes the tests out to a file.
     TestFramework *testWriter = nullptr;
@@ -116,9 +146,23 @@ class TestBackEnd {
     /// The callback that is executed by the symbolic executor.
     virtual bool run(const FinalState &state);
 
+    /// Waits until all tests produced by @ref run are written. If the tests are minimized, selects
+    /// and writes them first.
+    void finish();
+
     /// Returns test count.
     [[nodiscard]] int64_t getTestCount() const;
 
+    /// Sets the test count to @param count. The next test gets the id @param count + 1.
+    void setTestCount(int64_t count);
+
+    /// Records the path of every following test in @param cache.
+    void setPathCache(PathCache *cache);
+
+    /// @returns true if every test is written into its own file, so that a test can be replaced
+    /// by producing a test with the same id.
+    [[nodiscard]] bool writesTestsToSeparateFiles() const;
+
     /// Returns coverage achieved by all the processed tests.
     [[nodiscard]] float getCoverage() const;
 
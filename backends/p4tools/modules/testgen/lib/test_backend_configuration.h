@@ -26,6 +26,10 @@ struct TestBackendConfiguration {
 
     /// The initial seed used to generate tests. If it is not set, no seed was used.
     std::optional<unsigned int> seed;
+
+    /// Write all tests into one test file and one manifest instead of one file per test.
+    /// See TestBatchWriter.
+    bool batchOutput = false;
 };
 
 }  // namespace P4Tools::P4Testgen
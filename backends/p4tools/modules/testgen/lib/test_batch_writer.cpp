@@ -0,0 +1,68 @@
+#include "backends/p4tools/modules/testgen/lib/test_batch_writer.h"
+
+#include <filesystem>
+#include <string>
+
+#include <inja/inja.hpp>
+
+#include "lib/error.h"
+
+namespace P4Tools::P4Testgen {
+
+TestBatchWriter::TestBatchWriter(const std::filesystem::path &basePath, const inja::json &header)
+    : testsBuffer(BUFFER_SIZE), manifestBuffer(BUFFER_SIZE) {
+    // The buffers have to be installed before the files are opened.
+    testsFile.rdbuf()->pubsetbuf(testsBuffer.data(), static_cast<std::streamsize>(BUFFER_SIZE));
+    manifestFile.rdbuf()->pubsetbuf(manifestBuffer.data(),
+                                    static_cast<std::streamsize>(BUFFER_SIZE));
+    auto testsPath = getTestsPath(basePath);
+    auto manifestPath = getManifestPath(basePath);
+    testsFile.open(testsPath, std::ios::binary);
+    if (!testsFile.is_open()) {
+        ::error(ErrorType::ERR_IO, "Unable to open %1% for writing.", testsPath.c_str());
+    }
+    manifestFile.open(manifestPath, std::ios::binary);
+    if (!manifestFile.is_open()) {
+        ::error(ErrorType::ERR_IO, "Unable to open %1% for writing.", manifestPath.c_str());
+    }
+    writeLine(header);
+}
+
+std::filesystem::path TestBatchWriter::getTestsPath(std::filesystem::path basePath) {
+    return basePath.replace_extension(".tests.jsonl");
+}
+
+std::filesystem::path TestBatchWriter::getManifestPath(std::filesystem::path basePath) {
+    return basePath.replace_extension(".manifest.jsonl");
+}
+
+uint64_t TestBatchWriter::writeLine(const inja::json &record) {
+    auto line = record.dump();
+    line.push_back('\n');
+    testsFile.write(line.data(), static_cast<std::streamsize>(line.size()));
+    auto offset = testsOffset;
+    testsOffset += line.size();
+    return offset;
+}
+
+void TestBatchWriter::write(size_t testIdx, float currentCoverage, const std::string &test) {
+    inja::json record;
+    record["test_id"] = testIdx;
+    record["coverage"] = currentCoverage;
+    record["test"] = test;
+    auto offset = writeLine(record);
+
+    inja::json entry;
+    entry["test_id"] = testIdx;
+    entry["coverage"] = currentCoverage;
+    entry["offset"] = offset;
+    entry["length"] = testsOffset - offset;
+    manifestFile << entry.dump() << '\n';
+}
+
+void TestBatchWriter::flush() {
+    testsFile.flush();
+    manifestFile.flush();
+}
+
+}  // namespace P4Tools::P4Testgen
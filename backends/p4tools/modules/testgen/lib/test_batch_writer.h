@@ -0,0 +1,62 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_TEST_BATCH_WRITER_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_TEST_BATCH_WRITER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <inja/inja.hpp>
+
+namespace P4Tools::P4Testgen {
+
+/// Writes all tests into one file instead of one file per test. The test file
+/// "<base>.tests.jsonl" holds one JSON object per line: first a header, then one object per
+/// test with its "test_id", its "coverage" and the rendered "test". The manifest file
+/// "<base>.manifest.jsonl" holds one line per test with its "test_id", its "coverage" and the
+/// byte "offset" and "length" of its line in the test file, so that single tests can be
+/// replayed without parsing the whole test file. Both files are written through large buffers
+/// and are only flushed by @ref flush.
+class TestBatchWriter {
+ public:
+    /// Opens the files next to @param basePath and writes @param header as the first line of the
+    /// test file.
+    TestBatchWriter(const std::filesystem::path &basePath, const inja::json &header);
+
+    /// Appends the rendered test @param test with the id @param testIdx and the coverage
+    /// @param currentCoverage to the files.
+    void write(size_t testIdx, float currentCoverage, const std::string &test);
+
+    /// Writes the buffered tests to the files.
+    void flush();
+
+    /// @returns the path of the test file for @param basePath.
+    static std::filesystem::path getTestsPath(std::filesystem::path basePath);
+
+    /// @returns the path of the manifest file for @param basePath.
+    static std::filesystem::path getManifestPath(std::filesystem::path basePath);
+
+ private:
+    /// The size of the write buffer of each file.
+    static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+    /// Appends @param record as one line to the test file. @returns the offset of the line.
+    uint64_t writeLine(const inja::json &record);
+
+    std::vector<char> testsBuffer;
+
+    std::vector<char> manifestBuffer;
+
+    std::ofstream testsFile;
+
+    std::ofstream manifestFile;
+
+    /// The number of bytes written to the test file so far.
+    uint64_t testsOffset = 0;
+};
+
+}  // namespace P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_TEST_BATCH_WRITER_H_ */
@@ -0,0 +1,101 @@
+#include "backends/p4tools/modules/testgen/lib/test_emitter.h"
+
+#include <algorithm>
+
+#include "lib/cstring.h"
+
+#include "backends/p4tools/modules/testgen/lib/test_framework.h"
+#include "backends/p4tools/modules/testgen/lib/test_spec.h"
+
+namespace P4Tools::P4Testgen {
+
+TestEmitter::TestEmitter(TestFramework &testWriter, unsigned workers) : testWriter(testWriter) {
+#ifdef MULTITHREAD
+    // Tests which share a file are written by one thread, in order.
+    if (testWriter.isInBatchMode() || !testWriter.writesTestsToSeparateFiles()) {
+        workers = std::min(workers, 1U);
+    }
+    for (unsigned i = 0; i < workers; ++i) {
+        threads.emplace_back([this]() { work(); });
+    }
+#else
+    (void)workers;
+#endif  // MULTITHREAD
+}
+
+TestEmitter::~TestEmitter() {
+    try {
+        finish();
+    } catch (...) {
+        // A destructor must not throw.
+    }
+}
+
+void TestEmitter::emit(const TestSpec *testSpec, cstring selectedBranches, size_t testIdx,
+                       float currentCoverage) {
+#ifdef MULTITHREAD
+    if (!threads.empty()) {
+        std::unique_lock<std::mutex> acquire(jobsLock);
+        jobsChanged.wait(acquire,
+                         [this]() { return failure || jobs.size() < MAX_PENDING_TESTS; });
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+        jobs.push_back(Job{testSpec, selectedBranches, testIdx, currentCoverage});
+        jobsChanged.notify_all();
+        return;
+    }
+#endif  // MULTITHREAD
+    testWriter.get().writeTest(testSpec, selectedBranches, testIdx, currentCoverage);
+}
+
+void TestEmitter::finish() {
+#ifdef MULTITHREAD
+    {
+        std::lock_guard<std::mutex> acquire(jobsLock);
+        closed = true;
+    }
+    jobsChanged.notify_all();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+    if (failure) {
+        auto error = failure;
+        failure = nullptr;
+        std::rethrow_exception(error);
+    }
+#endif  // MULTITHREAD
+}
+
+#ifdef MULTITHREAD
+void TestEmitter::work() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> acquire(jobsLock);
+            jobsChanged.wait(acquire, [this]() { return closed || failure || !jobs.empty(); });
+            if (failure || jobs.empty()) {
+                return;
+            }
+            job = jobs.front();
+            jobs.pop_front();
+        }
+        jobsChanged.notify_all();
+        try {
+            testWriter.get().writeTest(job.testSpec, job.selectedBranches, job.testIdx,
+                                       job.currentCoverage);
+        } catch (...) {
+            std::lock_guard<std::mutex> acquire(jobsLock);
+            if (!failure) {
+                failure = std::current_exception();
+            }
+            jobs.clear();
+            jobsChanged.notify_all();
+            return;
+        }
+    }
+}
+#endif  // MULTITHREAD
+
+}  // namespace P4Tools::P4Testgen
@@ -0,0 +1,91 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_TEST_EMITTER_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_TEST_EMITTER_H_
+
+#include <cstddef>
+#include <functional>
+
+#ifdef MULTITHREAD
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+#include "lib/cstring.h"
+
+#include "backends/p4tools/modules/testgen/lib/test_framework.h"
+#include "backends/p4tools/modules/testgen/lib/test_spec.h"
+
+namespace P4Tools::P4Testgen {
+
+/// Writes tests to files on background threads, so that the exploration of paths does not wait
+/// for the rendering of test templates or for file I/O. Tests are handed to the threads through
+/// a bounded queue: once it is full, @ref emit waits for a thread to take a test. Test
+/// frameworks which write all tests into one file get at most one thread, which keeps the order
+/// of the tests. Without threads, @ref emit writes the test directly.
+class TestEmitter {
+ public:
+    /// Writes tests with @param testWriter on @param workers threads. Threads are only used in
+    /// MULTITHREAD builds.
+    TestEmitter(TestFramework &testWriter, unsigned workers);
+
+    TestEmitter(const TestEmitter &) = delete;
+
+    TestEmitter(TestEmitter &&) = delete;
+
+    TestEmitter &operator=(const TestEmitter &) = delete;
+
+    TestEmitter &operator=(TestEmitter &&) = delete;
+
+    /// Waits for the pending tests. Errors are dropped; call @ref finish to see them.
+    ~TestEmitter();
+
+    /// Writes the test @param testSpec. See TestFramework::writeTest.
+    /// Rethrows the error of a background thread, if one failed to write a test.
+    void emit(const TestSpec *testSpec, cstring selectedBranches, size_t testIdx,
+              float currentCoverage);
+
+    /// Waits until all tests are written and stops the threads. Rethrows the error of a
+    /// background thread, if one failed to write a test.
+    void finish();
+
+ private:
+    /// The test framework which writes the tests.
+    std::reference_wrapper<TestFramework> testWriter;
+
+#ifdef MULTITHREAD
+    /// The maximum number of tests which wait to be written.
+    static constexpr size_t MAX_PENDING_TESTS = 64;
+
+    /// A test which waits to be written.
+    struct Job {
+        const TestSpec *testSpec = nullptr;
+        cstring selectedBranches;
+        size_t testIdx = 0;
+        float currentCoverage = 0;
+    };
+
+    /// Writes jobs until the queue is closed and empty, or until a job fails.
+    void work();
+
+    std::vector<std::thread> threads;
+
+    std::deque<Job> jobs;
+
+    std::mutex jobsLock;
+
+    std::condition_variable jobsChanged;
+
+    /// Set by @ref finish once no more jobs are queued.
+    bool closed = false;
+
+    /// The first error of a background thread.
+    std::exception_ptr failure;
+#endif  // MULTITHREAD
+};
+
+}  // namespace P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_TEST_EMITTER_H_ */
@@ -1,6 +1,15 @@
 #include "backends/p4tools/modules/testgen/lib/test_framework.h"
 
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include <inja/inja.hpp>
+
+#include "lib/exceptions.h"
+
 #include "backends/p4tools/modules/testgen/lib/exceptions.h"
+#include "backends/p4tools/modules/testgen/lib/test_batch_writer.h"
 
 namespace P4Tools::P4Testgen {
 
@@ -11,10 +20,64 @@ const TestBackendConfiguration &TestFramework::getTestBackendConfiguration() con
     return testBackendConfiguration.get();
 }
 
+inja::Template TestFramework::parseTemplate(const std::string &templateString) const {
+    return templateEnvironment.parse(templateString);
+}
+
+void TestFramework::renderTemplate(std::ostream &output, const inja::Template &parsedTemplate,
+                                   const inja::json &data) const {
+    templateEnvironment.render_to(output, parsedTemplate, data);
+}
+
+std::string TestFramework::renderTemplate(const inja::Template &parsedTemplate,
+                                          const inja::json &data) const {
+    return templateEnvironment.render(parsedTemplate, data);
+}
+
 bool TestFramework::isInFileMode() const {
     return getTestBackendConfiguration().fileBasePath.has_value();
 }
 
+bool TestFramework::isInBatchMode() const {
+    return isInFileMode() && getTestBackendConfiguration().batchOutput;
+}
+
+bool TestFramework::writesTestsToSeparateFiles() const { return false; }
+
+std::string TestFramework::renderTest(const TestSpec * /*spec*/, cstring /*selectedBranches*/,
+                                      size_t /*testIdx*/, float /*currentCoverage*/) {
+    TESTGEN_UNIMPLEMENTED("Batched output is not implemented for this test framework.");
+}
+
+std::string TestFramework::renderPreamble() const { return {}; }
+
+void TestFramework::writeTest(const TestSpec *spec, cstring selectedBranches, size_t testIdx,
+                              float currentCoverage) {
+    if (!isInBatchMode()) {
+        writeTestToFile(spec, selectedBranches, testIdx, currentCoverage);
+        return;
+    }
+    if (batchWriter == nullptr) {
+        const auto &configuration = getTestBackendConfiguration();
+        BUG_CHECK(configuration.fileBasePath.has_value(), "Base path is not set.");
+        inja::json header;
+        header["test_name"] = configuration.testBaseName;
+        if (configuration.seed.has_value()) {
+            header["seed"] = configuration.seed.value();
+        }
+        header["preamble"] = renderPreamble();
+        batchWriter = std::make_shared<TestBatchWriter>(configuration.fileBasePath.value(), header);
+    }
+    batchWriter->write(testIdx, currentCoverage,
+                       renderTest(spec, selectedBranches, testIdx, currentCoverage));
+}
+
+void TestFramework::finishTests() {
+    if (batchWriter != nullptr) {
+        batchWriter->flush();
+    }
+}
+
 AbstractTestReferenceOrError TestFramework::produceTest(const TestSpec * /*spec*/,
                                                         cstring /*selectedBranches*/,
                                                         size_t /*testIdx*/,
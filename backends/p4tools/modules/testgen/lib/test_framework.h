@@ -6,6 +6,7 @@
 #include <functional>
 #include <iosfwd>
 #include <map>
+#include <memory>
 #include <optional>
 #include <string>
 #include <utility>
@@ -18,6 +19,7 @@
 #include "lib/cstring.h"
 
 #include "backends/p4tools/modules/testgen/lib/test_backend_configuration.h"
+#include "backends/p4tools/modules/testgen/lib/test_batch_writer.h"
 #include "backends/p4tools/modules/testgen/lib/test_object.h"
 #include "backends/p4tools/modules/testgen/lib/test_spec.h"
 
@@ -54,6 +56,13 @@ class TestFramework {
     /// Configuration options for the test back end.
     std::reference_wrapper<const TestBackendConfiguration> testBackendConfiguration;
 
+    /// Writes the tests in batched output mode. Created with the first test.
+    std::shared_ptr<TestBatchWriter> batchWriter;
+
+    /// The environment in which the templates of the test framework are parsed and rendered.
+    /// Rendering does not modify the environment, so tests may be rendered concurrently.
+    mutable inja::Environment templateEnvironment;
+
  protected:
     /// Creates a generic test framework.
     explicit TestFramework(const TestBackendConfiguration &testBackendConfiguration);
@@ -159,6 +168,18 @@ class TestFramework {
     /// Returns the configuration options for the test back end.
     [[nodiscard]] const TestBackendConfiguration &getTestBackendConfiguration() const;
 
+    /// Parses the inja template @param templateString. Test frameworks parse their templates
+    /// once, when they are created, instead of once per test.
+    [[nodiscard]] inja::Template parseTemplate(const std::string &templateString) const;
+
+    /// Renders the parsed template @param parsedTemplate with @param data into @param output.
+    void renderTemplate(std::ostream &output, const inja::Template &parsedTemplate,
+                        const inja::json &data) const;
+
+    /// @returns the parsed template @param parsedTemplate rendered with @param data.
+    [[nodiscard]] std::string renderTemplate(const inja::Template &parsedTemplate,
+                                             const inja::json &data) const;
+
  public:
     virtual ~TestFramework() = default;
 
@@ -181,8 +202,33 @@ class TestFramework {
     virtual AbstractTestReferenceOrError produceTest(const TestSpec *spec, cstring selectedBranches,
                                                      size_t testIdx, float currentCoverage);
 
+    /// Renders the test case as a string, which is written together with all other tests in
+    /// batched output mode. This method is optional to each test framework.
+    /// The parameters are the same as those of @ref writeTestToFile.
+    virtual std::string renderTest(const TestSpec *spec, cstring selectedBranches, size_t testIdx,
+                                   float currentCoverage);
+
+    /// @returns the text which precedes all test cases, such as the setup of a PTF test. It is
+    /// stored in the header of the test file in batched output mode. Empty by default.
+    [[nodiscard]] virtual std::string renderPreamble() const;
+
+    /// Writes the test case to file. In batched output mode, the test is rendered with
+    /// @ref renderTest and appended to the test file, otherwise @ref writeTestToFile is called.
+    void writeTest(const TestSpec *spec, cstring selectedBranches, size_t testIdx,
+                   float currentCoverage);
+
+    /// Writes out the tests which are still buffered in batched output mode.
+    void finishTests();
+
     /// @Returns true if the test framework is configured to write to a file.
     [[nodiscard]] bool isInFileMode() const;
+
+    /// @Returns true if the test framework writes all tests into one test file.
+    [[nodiscard]] bool isInBatchMode() const;
+
+    /// @returns true if @ref writeTestToFile writes each test into its own file and can be called
+    /// for different tests at the same time.
+    [[nodiscard]] virtual bool writesTestsToSeparateFiles() const;
 };
 
 }  // namespace P4Tools::P4Testgen
@@ -0,0 +1,57 @@
+#include "backends/p4tools/modules/testgen/lib/test_minimization.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <queue>
+#include <utility>
+
+namespace P4Tools::P4Testgen {
+
+std::vector<size_t> selectCoveringTests(const std::vector<P4::Coverage::CoverageSet> &testCoverage,
+                                        unsigned redundancy) {
+    // The number of selected tests each node still needs.
+    std::map<const IR::Node *, unsigned, P4::Coverage::SourceIdCmp> needed;
+    for (const auto &coverage : testCoverage) {
+        for (const auto *node : coverage) {
+            auto &count = needed[node];
+            count = std::min(count + 1, redundancy);
+        }
+    }
+    auto gain = [&needed](const P4::Coverage::CoverageSet &coverage) {
+        return std::count_if(coverage.begin(), coverage.end(),
+                             [&needed](const IR::Node *node) { return needed.at(node) > 0; });
+    };
+
+    // The gain of a test only decreases as tests are selected. A test whose gain is still up to
+    // date when it is at the top of the queue is thus the best one, and only the gains of the
+    // tests at the top have to be recomputed.
+    std::priority_queue<std::pair<std::ptrdiff_t, size_t>> candidates;
+    for (size_t idx = 0; idx < testCoverage.size(); idx++) {
+        candidates.emplace(gain(testCoverage[idx]), idx);
+    }
+    std::vector<size_t> selected;
+    while (!candidates.empty()) {
+        auto [candidateGain, idx] = candidates.top();
+        candidates.pop();
+        if (candidateGain == 0) {
+            break;
+        }
+        auto currentGain = gain(testCoverage[idx]);
+        if (currentGain < candidateGain) {
+            candidates.emplace(currentGain, idx);
+            continue;
+        }
+        selected.push_back(idx);
+        for (const auto *node : testCoverage[idx]) {
+            auto &count = needed.at(node);
+            if (count > 0) {
+                count--;
+            }
+        }
+    }
+    std::sort(selected.begin(), selected.end());
+    return selected;
+}
+
+}  // namespace P4Tools::P4Testgen
@@ -0,0 +1,22 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_TEST_MINIMIZATION_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_TEST_MINIMIZATION_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "midend/coverage.h"
+
+namespace P4Tools::P4Testgen {
+
+/// Selects a small subset of tests, given the nodes covered by each test in @param testCoverage,
+/// such that every node is still covered by @param redundancy of the selected tests, or by all
+/// the tests which cover it if there are fewer. This is a set multicover problem, which is
+/// solved greedily: the next selected test is the one which covers the most nodes that still
+/// need a test. The result is within a logarithmic factor of the smallest subset.
+/// @returns the indices of the selected tests in increasing order.
+std::vector<size_t> selectCoveringTests(const std::vector<P4::Coverage::CoverageSet> &testCoverage,
+                                        unsigned redundancy);
+
+}  // namespace P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_TEST_MINIMIZATION_H_ */
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cstdlib>
 #include <iterator>
+#include <limits>
 #include <map>
 #include <stdexcept>
 #include <string>
@@ -56,6 +57,62 @@ TestgenOptions::TestgenOptions()
         "Sets the maximum number of tests to be generated [default: 1]. Setting the value to 0 "
         "will generate tests until no more paths can be found.");
 
+    registerOption(
+        "--parallel-workers", "parallelWorkers",
+        [this](const char *arg) {
+            try {
+                auto workers = std::stoll(arg);
+                if (workers < 1 || workers > std::numeric_limits<unsigned>::max()) {
+                    throw std::invalid_argument("Invalid input.");
+                }
+                parallelWorkers = workers;
+            } catch (std::exception &) {
+                ::error(
+                    "Invalid input value %1% for --parallel-workers. Expected positive integer.",
+                    arg);
+                return false;
+            }
+            return true;
+        },
+        "Sets the number of threads which explore paths of the program [default: 1]. Only the "
+        "depth-first path selection policy supports more than one thread, and only in builds "
+        "with multithreading enabled. The generated tests do not depend on the number of "
+        "threads.");
+
+    registerOption(
+        "--test-emission-workers", "testEmissionWorkers",
+        [this](const char *arg) {
+            try {
+                auto workers = std::stoll(arg);
+                if (workers < 0 || workers > std::numeric_limits<unsigned>::max()) {
+                    throw std::invalid_argument("Invalid input.");
+                }
+                testEmissionWorkers = workers;
+            } catch (std::exception &) {
+                ::error(
+                    "Invalid input value %1% for --test-emission-workers. Expected non-negative "
+                    "integer.",
+                    arg);
+                return false;
+            }
+            return true;
+        },
+        "Sets the number of threads which render and write tests to files in the background "
+        "[default: 0, tests are written by the exploring thread]. Test back ends which write "
+        "all tests into one file use at most one such thread. Only builds with multithreading "
+        "enabled use threads.");
+
+    registerOption(
+        "--batch-output", nullptr,
+        [this](const char * /*arg*/) {
+            batchOutput = true;
+            return true;
+        },
+        "Write all tests into one buffered file with one JSON object per line, "
+        "<test-name>.tests.jsonl, instead of one file per test. A manifest, "
+        "<test-name>.manifest.jsonl, lists the coverage of each test and the position of its "
+        "line, so that single tests can be replayed.");
+
     registerOption(
         "--stop-metric", "stopMetric",
         [this](const char *arg) {
@@ -106,6 +163,16 @@ TestgenOptions::TestgenOptions()
         "inclusive. "
         "The default values are \"0:72000\". The maximum is set to jumbo frame size (9000 bytes).");
 
+    registerOption(
+        "--minimize-packet-size", nullptr,
+        [this](const char *) {
+            minimizePacketSize = true;
+            return true;
+        },
+        "Give each test the smallest input packet its path permits, found by a binary search on "
+        "the solver, instead of the packet size of the first model. This costs a few solver "
+        "queries per test.");
+
     registerOption(
         "--port-ranges", "portRanges",
         [this](const char *arg) {
@@ -199,10 +266,54 @@ TestgenOptions::TestgenOptions()
                     "one or the other.");
                 return false;
             }
+            if (branchPrefix.has_value()) {
+                ::error(
+                    "--input-branches and --branch-prefix are mutually exclusive. Choose one or "
+                    "the other.");
+                return false;
+            }
             return true;
         },
         "[EXPERIMENTAL] List of the selected branches which should be chosen for selection.");
 
+    registerOption(
+        "--branch-prefix", "branchPrefix",
+        [this](const char *arg) {
+            branchPrefix = arg;
+            if (!selectedBranches.empty()) {
+                ::error(
+                    "--input-branches and --branch-prefix are mutually exclusive. Choose one or "
+                    "the other.");
+                return false;
+            }
+            return true;
+        },
+        "Only explores the paths which start with the given list of selected branches, as "
+        "produced by --partition-paths. Separate P4Testgen runs can then explore the parts of "
+        "one program.");
+
+    registerOption(
+        "--partition-paths", "partitionPaths",
+        [this](const char *arg) {
+            try {
+                auto partitions = std::stoll(arg);
+                if (partitions < 1) {
+                    throw std::invalid_argument("Invalid input.");
+                }
+                partitionPaths = partitions;
+            } catch (std::exception &) {
+                ::error(
+                    "Invalid input value %1% for --partition-paths. Expected positive integer.",
+                    arg);
+                return false;
+            }
+            return true;
+        },
+        "Instead of generating tests, splits the paths of the program into at least this many "
+        "parts and writes the branch prefix of each part to [test name].prefixes, one per line. "
+        "Each prefix can be explored by a separate P4Testgen run with --branch-prefix; produce "
+        "more parts than runs, so that runs which finish early can take the remaining parts.");
+
     registerOption(
         "--track-branches", nullptr,
         [this](const char *) {
@@ -219,6 +330,39 @@ TestgenOptions::TestgenOptions()
         "[EXPERIMENTAL] Track the branches that are chosen in the symbolic executor. This can be "
         "used for deterministic replay.");
 
+    registerOption(
+        "--path-cache", "pathCache",
+        [this](const char *arg) {
+            pathCache = arg;
+            // Paths are compared by the statements they cover.
+            hasCoverageTracking = true;
+            coverageOptions.coverStatements = true;
+            return true;
+        },
+        "Records the explored paths and the nodes they cover in the given file. If the file "
+        "exists, only the tests whose paths cover changed statements or table entries are "
+        "generated again, in place of the earlier tests with the same ids. Requires a test back "
+        "end which writes each test into its own file. Implies --track-coverage STATEMENTS.");
+
+    registerOption(
+        "--save-compiled", "file",
+        [this](const char *arg) {
+            saveCompiled = arg;
+            return true;
+        },
+        "Writes the program after the mid end to the given file, for --load-compiled.");
+
+    registerOption(
+        "--load-compiled", "file",
+        [this](const char *arg) {
+            loadCompiled = arg;
+            return true;
+        },
+        "Reads the program after the mid end from a file written by --save-compiled instead of "
+        "running the front end and the mid end. The P4 program is still parsed and must not have "
+        "changed since it was compiled. The compiled program does not depend on the P4Testgen "
+        "options, but it does depend on the compiler options.");
+
     registerOption(
         "--output-packet-only", nullptr,
         [this](const char *) {
@@ -322,6 +466,26 @@ TestgenOptions::TestgenOptions()
         "If coverage tracking is enabled only generate tests which update the total number of "
         "covered nodes.");
 
+    registerOption(
+        "--minimize-tests", "redundancy",
+        [this](const char *arg) {
+            try {
+                auto redundancy = std::stoll(arg);
+                if (redundancy < 1 || redundancy > std::numeric_limits<unsigned>::max()) {
+                    throw std::invalid_argument("Invalid input.");
+                }
+                minimizeTests = redundancy;
+            } catch (std::exception &) {
+                ::error("Invalid input value %1% for --minimize-tests. Expected positive integer.",
+                        arg);
+                return false;
+            }
+            return true;
+        },
+        "Hold the generated tests back until test generation ends, then only write a small "
+        "subset in which every covered node is covered by the given number of tests, or by all "
+        "tests that cover it. The tests are numbered again. Requires --track-coverage.");
+
     registerOption(
         "--assert-min-coverage", "minCoverage",
         [this](const char *arg) {
@@ -419,6 +583,69 @@ TestgenOptions::TestgenOptions()
         },
         "Produce only tests that violate the condition defined in assert calls. This will either "
         "produce no tests or only tests that contain counter examples.");
+
+    registerOption(
+        "--solver-query-cache", nullptr,
+        [this](const char * /*arg*/) {
+            solverQueryCache = true;
+            return true;
+        },
+        "Split the constraints of each solver query into sets that do not share variables, and "
+        "answer each set from a cache of previous results or from recent models before calling "
+        "the solver. The hit rate is part of the performance report.");
+
+    registerOption(
+        "--solver-assumptions", nullptr,
+        [this](const char * /*arg*/) {
+            solverAssumptions = true;
+            return true;
+        },
+        "Assert each path constraint once, guarded by a boolean literal, and check a path by "
+        "assuming the literals of its constraints. Backtracking then does not pop constraints and "
+        "the solver keeps what it learned about other paths.");
+
+    registerOption(
+        "--solver-portfolio", "milliseconds",
+        [this](const char *arg) {
+            try {
+                auto threshold = std::stoll(arg);
+                if (threshold < 1 || threshold > std::numeric_limits<unsigned>::max()) {
+                    throw std::invalid_argument("Invalid input.");
+                }
+                solverPortfolioThreshold = threshold;
+            } catch (std::exception &) {
+                ::error(
+                    "Invalid input value %1% for --solver-portfolio. Expected positive integer.",
+                    arg);
+                return false;
+            }
+            return true;
+        },
+        "Race a second, differently configured solver on queries which the solver does not "
+        "answer within the given number of milliseconds, and take the first answer. Queries are "
+        "only raced in builds with multithreading.");
+
+    registerOption(
+        "--solver-query-timeout", "milliseconds",
+        [this](const char *arg) {
+            try {
+                auto timeout = std::stoll(arg);
+                if (timeout < 1 || timeout > std::numeric_limits<unsigned>::max()) {
+                    throw std::invalid_argument("Invalid input.");
+                }
+                solverQueryTimeout = timeout;
+            } catch (std::exception &) {
+                ::error(
+                    "Invalid input value %1% for --solver-query-timeout. Expected positive "
+                    "integer.",
+                    arg);
+                return false;
+            }
+            return true;
+        },
+        "Stop solver queries which are not answered within the given number of milliseconds, "
+        "retry them with a bit-blasting tactic pipeline and, if that does not answer either, "
+        "without a timeout. The performance report then shows the distribution of query times.");
 }
 
 bool TestgenOptions::validateOptions() const {
@@ -430,6 +657,29 @@ bool TestgenOptions::validateOptions() const {
             "--assert-min-coverage is meaningless.");
         return false;
     }
+    if (saveCompiled.has_value() && loadCompiled.has_value()) {
+        ::error(ErrorType::ERR_INVALID,
+                "--save-compiled cannot be combined with --load-compiled.");
+        return false;
+    }
+    if (minimizeTests > 0 && !hasCoverageTracking) {
+        ::error(ErrorType::ERR_INVALID,
+                "--minimize-tests selects tests by the nodes they cover and requires coverage "
+                "tracking enabled with --track-coverage.");
+        return false;
+    }
+    if (minimizeTests > 0 && pathCache.has_value()) {
+        ::error(ErrorType::ERR_INVALID,
+                "--minimize-tests cannot be combined with --path-cache, which records the tests "
+                "with their ids as they are generated.");
+        return false;
+    }
+    if (solverQueryTimeout > 0 && solverPortfolioThreshold > 0) {
+        ::error(ErrorType::ERR_INVALID,
+                "--solver-query-timeout cannot be combined with --solver-portfolio, which "
+                "interrupts the queries of its solvers itself.");
+        return false;
+    }
     return true;
 }
 
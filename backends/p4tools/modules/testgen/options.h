@@ -26,6 +26,17 @@ class TestgenOptions : public AbstractP4cToolOptions {
     /// Selects the path selection policy for test generation
     P4Testgen::PathSelectionPolicy pathSelectionPolicy = P4Testgen::PathSelectionPolicy::DepthFirst;
 
+    /// Number of threads which explore paths of the program. Only the depth-first path selection
+    /// policy explores paths in parallel. Defaults to 1.
+    unsigned parallelWorkers = 1;
+
+    /// Number of threads which render and write tests in the background. Zero writes the tests
+    /// on the thread which explores the paths.
+    unsigned testEmissionWorkers = 0;
+
+    /// Write all tests into one test file and one manifest instead of one file per test.
+    bool batchOutput = false;
+
     /// List of the supported stop metrics.
     static const std::set<cstring> SUPPORTED_STOP_METRICS;
 
@@ -48,6 +59,14 @@ class TestgenOptions : public AbstractP4cToolOptions {
     /// String of selected branches separated by comma.
     std::string selectedBranches;
 
+    /// Branches separated by comma which select the part of the program to explore. All the
+    /// paths which start with these branches are explored.
+    std::optional<std::string> branchPrefix;
+
+    /// If not 0, P4Testgen splits the paths of the program into at least this many branch
+    /// prefixes, which it writes out instead of generating tests.
+    size_t partitionPaths = 0;
+
     /// String of a pattern for resulting tests.
     std::string pattern;
 
@@ -55,6 +74,16 @@ class TestgenOptions : public AbstractP4cToolOptions {
     /// deterministic replay of an execution trace.
     bool trackBranches = false;
 
+    /// The file which records the explored paths of a run. If it exists, only the tests whose
+    /// paths cover changed parts of the program are generated again.
+    std::optional<std::filesystem::path> pathCache = std::nullopt;
+
+    /// Write the program after the mid end to this file, see --load-compiled.
+    std::optional<std::filesystem::path> saveCompiled = std::nullopt;
+
+    /// Read the program after the mid end from this file instead of compiling the P4 program.
+    std::optional<std::filesystem::path> loadCompiled = std::nullopt;
+
     /// Build a DCG for input program. This control flow graph directed cyclic graph can be used
     /// for statement reachability analysis.
     bool dcg = false;
@@ -66,6 +95,9 @@ class TestgenOptions : public AbstractP4cToolOptions {
     /// The minimum permitted packet size, in bits.
     int minPktSize = 0;
 
+    /// Search the smallest input packet size of each test with the solver.
+    bool minimizePacketSize = false;
+
     /// The list of permitted port ranges.
     /// TestGen will consider these when choosing input and output ports.
     std::vector<std::pair<int, int>> permittedPortRanges;
@@ -87,6 +119,24 @@ class TestgenOptions : public AbstractP4cToolOptions {
     /// This will either produce no tests or only tests that contain counter examples.
     bool assertionModeEnabled = false;
 
+    /// Split solver queries into independent sets of constraints and cache their results.
+    bool solverQueryCache = false;
+
+    /// Check solver queries by assuming literals which guard the path constraints.
+    bool solverAssumptions = false;
+
+    /// Race a second solver on queries which take longer than this many milliseconds. Zero
+    /// disables the portfolio.
+    unsigned solverPortfolioThreshold = 0;
+
+    /// Time out solver queries after this many milliseconds and retry them with a tactic
+    /// pipeline, then without a timeout. Zero keeps the default solver configuration.
+    unsigned solverQueryTimeout = 0;
+
+    /// Hold the tests back and only write a smallest subset in which every covered node is still
+    /// covered by this many tests. Zero writes every test.
+    unsigned minimizeTests = 0;
+
     /// Specifies general options which IR nodes to track for coverage in the targeted P4 program.
     /// Multiple options are possible. Currently supported: STATEMENTS, TABLE_ENTRIES.
     P4::Coverage::CoverageOptions coverageOptions;
@@ -1,5 +1,7 @@
 #include "backends/p4tools/modules/testgen/targets/bmv2/bmv2.h"
 
+#include <filesystem>
+#include <fstream>
 #include <optional>
 #include <string>
 #include <utility>
@@ -7,6 +9,7 @@
 #include "backends/bmv2/common/annotations.h"
 #include "backends/p4tools/common/compiler/compiler_target.h"
 #include "backends/p4tools/common/compiler/midend.h"
+#include "control-plane/p4infoApi.h"
 #include "frontends/common/options.h"
 #include "frontends/common/resolveReferences/referenceMap.h"
 #include "frontends/p4/typeChecking/typeChecker.h"
@@ -14,7 +17,9 @@
 #include "lib/cstring.h"
 #include "lib/error.h"
 #include "midend/coverage.h"
+#include "p4/v1/p4runtime.pb.h"
 
+#include "backends/p4tools/modules/testgen/core/compiled_program.h"
 #include "backends/p4tools/modules/testgen/core/compiler_target.h"
 #include "backends/p4tools/modules/testgen/options.h"
 #include "backends/p4tools/modules/testgen/targets/bmv2/map_direct_externs.h"
@@ -24,6 +29,43 @@
 
 namespace P4Tools::P4Testgen::Bmv2 {
 
+namespace {
+
+/// The P4Runtime API is generated after the front end, so a compiled program keeps it next to
+/// the program file, in binary protobuf files with these suffixes.
+std::filesystem::path p4InfoPath(std::filesystem::path path) { return path += ".p4info.bin"; }
+
+std::filesystem::path entriesPath(std::filesystem::path path) { return path += ".entries.bin"; }
+
+bool writeP4RuntimeApi(const P4::P4RuntimeAPI &p4runtimeApi, const std::filesystem::path &path) {
+    std::ofstream p4Info(p4InfoPath(path), std::ios::binary);
+    p4runtimeApi.serializeP4InfoTo(&p4Info, P4::P4RuntimeFormat::BINARY);
+    std::ofstream entries(entriesPath(path), std::ios::binary);
+    p4runtimeApi.serializeEntriesTo(&entries, P4::P4RuntimeFormat::BINARY);
+    if (!p4Info.good() || !entries.good()) {
+        ::error(ErrorType::ERR_IO, "%1%: cannot write the P4Runtime API of the program", path);
+        return false;
+    }
+    return true;
+}
+
+std::optional<P4::P4RuntimeAPI> readP4RuntimeApi(const std::filesystem::path &path) {
+    const auto *p4Info = P4::ControlPlaneAPI::readP4Info(cstring(p4InfoPath(path).string()));
+    if (p4Info == nullptr) {
+        return std::nullopt;
+    }
+    std::ifstream in(entriesPath(path), std::ios::binary);
+    auto *entries = new p4::v1::WriteRequest();
+    if (!in || !entries->ParseFromIstream(&in)) {
+        ::error(ErrorType::ERR_IO, "%1%: cannot read the table entries of the program",
+                entriesPath(path));
+        return std::nullopt;
+    }
+    return P4::P4RuntimeAPI(p4Info, entries);
+}
+
+}  // namespace
+
 BMv2V1ModelCompilerResult::BMv2V1ModelCompilerResult(TestgenCompilerResult compilerResult,
                                                      P4::P4RuntimeAPI p4runtimeApi,
                                                      DirectExternMap directExternMap,
@@ -54,21 +96,40 @@ void Bmv2V1ModelCompilerTarget::make() {
 
 CompilerResultOrError Bmv2V1ModelCompilerTarget::runCompilerImpl(
     const IR::P4Program *program) const {
-    program = runFrontend(program);
-    if (program == nullptr) {
-        return std::nullopt;
-    }
-
-    /// After the front end, get the P4Runtime API for the V1model architecture.
-    auto p4runtimeApi = P4::P4RuntimeSerializer::get()->generateP4Runtime(program, "v1model");
-
-    if (::errorCount() > 0) {
-        return std::nullopt;
-    }
-
-    program = runMidEnd(program);
-    if (program == nullptr) {
-        return std::nullopt;
+    const auto &testgenOptions = TestgenOptions::get();
+    std::optional<P4::P4RuntimeAPI> p4runtimeApi;
+    if (testgenOptions.loadCompiled.has_value()) {
+        // The front end and the mid end already ran on these sources.
+        program = readCompiledProgram(testgenOptions.loadCompiled.value(), *program);
+        if (program == nullptr) {
+            return std::nullopt;
+        }
+        p4runtimeApi = readP4RuntimeApi(testgenOptions.loadCompiled.value());
+        if (!p4runtimeApi.has_value()) {
+            return std::nullopt;
+        }
+    } else {
+        program = runFrontend(program);
+        if (program == nullptr) {
+            return std::nullopt;
+        }
+
+        /// After the front end, get the P4Runtime API for the V1model architecture.
+        p4runtimeApi = P4::P4RuntimeSerializer::get()->generateP4Runtime(program, "v1model");
+
+        if (::errorCount() > 0) {
+            return std::nullopt;
+        }
+
+        program = runMidEnd(program);
+        if (program == nullptr) {
+            return std::nullopt;
+        }
+        if (testgenOptions.saveCompiled.has_value() &&
+            (!writeCompiledProgram(*program, testgenOptions.saveCompiled.value()) ||
+             !writeP4RuntimeApi(*p4runtimeApi, testgenOptions.saveCompiled.value()))) {
+            return std::nullopt;
+        }
     }
 
     // Create DCG.
@@ -113,7 +174,7 @@ CompilerResultOrError Bmv2V1ModelCompilerTarget::runCompilerImpl(
 
     return {*new BMv2V1ModelCompilerResult{
         TestgenCompilerResult(CompilerResult(*program), coverage.getCoverableNodes(), dcg),
-        p4runtimeApi, directExternMapper.getdirectExternMap(), p4ConstraintsRestrictions}};
+        *p4runtimeApi, directExternMapper.getdirectExternMap(), p4ConstraintsRestrictions}};
 }
 
 MidEnd Bmv2V1ModelCompilerTarget::mkMidEnd(const CompilerOptions &options) const {
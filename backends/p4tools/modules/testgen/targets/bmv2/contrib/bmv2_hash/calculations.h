@@ -27,26 +27,6 @@
 namespace P4Tools::P4Testgen::Bmv2 {
 
 class BMv2Hash {
-    /* This code was adapted from:
-       http://www.barrgroup.com/Embedded-Systems/How-To/CRC-Calculation-C-Code */
-
-    template <typename T>
-    static T reflect(T data, int nBits) {
-        T reflection = static_cast<T>(0x00);
-        int bit = 0;
-
-        // Reflect the data about the center bit.
-        for (bit = 0; bit < nBits; ++bit) {
-            // If the LSB bit is set, set the reflection of it.
-            if (data & 0x01) {
-                reflection |= (static_cast<T>(1) << ((nBits - 1) - bit));
-            }
-            data = (data >> 1);
-        }
-
-        return reflection;
-    }
-
  public:
     static uint16_t crc16(const uint8_t *buf, size_t len);
 
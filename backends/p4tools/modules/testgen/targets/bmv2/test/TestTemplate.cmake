@@ -8,13 +8,18 @@
 function(check_with_bmv2 testfile testfolder p4test)
   set(__p4cbmv2path "${P4C_BINARY_DIR}")
   set(__bmv2runner "${CMAKE_BINARY_DIR}/run-bmv2-test.py")
-  # Find all the stf tests generated for this P4 file and test them with bmv2 model
+  # Find all the stf tests generated for this P4 file and test them with bmv2 model.
+  # The program is compiled once and the tests are run in parallel, each with its own switch.
   file(APPEND ${testfile} "stffiles=($(find ${testfolder} -name \"*.stf\"  | sort -n ))\n")
+  file(APPEND ${testfile} "stfargs=()\n")
   file(APPEND ${testfile} "for item in \${stffiles[@]}\n")
   file(APPEND ${testfile} "do\n")
   file(APPEND ${testfile} "\techo \"Found \${item}\"\n")
-  file(APPEND ${testfile} "\tpython3 ${__bmv2runner} . -v -b -tf \${item} -bd ${__p4cbmv2path} ${p4test}\n")
+  file(APPEND ${testfile} "\tstfargs+=(-tf \${item})\n")
   file(APPEND ${testfile} "done\n")
+  file(APPEND ${testfile} "if [ \${#stfargs[@]} -gt 0 ]; then\n")
+  file(APPEND ${testfile} "\tpython3 ${__bmv2runner} . -v -b -j ${P4TOOLS_BMV2_STF_JOBS} \${stfargs[@]} -bd ${__p4cbmv2path} ${p4test}\n")
+  file(APPEND ${testfile} "fi\n")
 endfunction(check_with_bmv2)
 
 
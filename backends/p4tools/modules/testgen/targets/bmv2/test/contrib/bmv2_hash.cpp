@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "backends/p4tools/modules/testgen/targets/bmv2/contrib/bmv2_hash/calculations.h"
+
+namespace Test {
+
+namespace {
+
+using P4Tools::P4Testgen::Bmv2::BMv2Hash;
+
+const std::vector<uint8_t> CHECK_INPUT = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+/// The check values of CRC-16/ARC, CRC-32 and CRC-16/CCITT-FALSE, which the behavioral model
+/// uses for crc16, crc32 and crcCCITT.
+TEST(BMv2HashTest, CrcCheckValues) {
+    EXPECT_EQ(BMv2Hash::crc16(CHECK_INPUT.data(), CHECK_INPUT.size()), 0xBB3D);
+    EXPECT_EQ(BMv2Hash::crc32(CHECK_INPUT.data(), CHECK_INPUT.size()), 0xCBF43926U);
+    EXPECT_EQ(BMv2Hash::crcCCITT(CHECK_INPUT.data(), CHECK_INPUT.size()), 0x29B1);
+}
+
+TEST(BMv2HashTest, CrcOfNoBytes) {
+    EXPECT_EQ(BMv2Hash::crc16(nullptr, 0), 0x0000);
+    EXPECT_EQ(BMv2Hash::crc32(nullptr, 0), 0x00000000U);
+    EXPECT_EQ(BMv2Hash::crcCCITT(nullptr, 0), 0xFFFF);
+}
+
+}  // namespace
+
+}  // namespace Test
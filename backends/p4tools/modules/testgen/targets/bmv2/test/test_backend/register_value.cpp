@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include "ir/ir.h"
+#include "ir/irutils.h"
+
+#include "backends/p4tools/modules/testgen/targets/bmv2/test_spec.h"
+
+namespace Test {
+
+namespace {
+
+using P4Tools::P4Testgen::Bmv2::Bmv2V1ModelRegisterValue;
+
+const IR::Constant *bits(big_int value) { return IR::getConstant(IR::getBitType(32), value); }
+
+const IR::Expression *symbolicIndex() {
+    return new IR::Member(IR::getBitType(32), new IR::PathExpression("h"), "index");
+}
+
+TEST(Bmv2RegisterValueTest, ConstantIndicesKeepOneWriteEach) {
+    Bmv2V1ModelRegisterValue reg(bits(0));
+    for (int i = 0; i < 100; i++) {
+        reg.writeToIndex(bits(i % 4), bits(i));
+    }
+    EXPECT_EQ(reg.unravelMap().size(), 4U);
+
+    const auto *value = reg.getValueAtIndex(bits(1))->to<IR::Constant>();
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(value->value, 97);
+    EXPECT_EQ(reg.getValueAtIndex(bits(7)), reg.getInitialValue());
+}
+
+TEST(Bmv2RegisterValueTest, SymbolicWritesShadowConstantWrites) {
+    Bmv2V1ModelRegisterValue reg(bits(0));
+    const auto *index = symbolicIndex();
+    reg.writeToIndex(bits(1), bits(10));
+    reg.writeToIndex(index, bits(20));
+    reg.writeToIndex(bits(2), bits(30));
+
+    // Only the symbolic write may change what was written to index 1.
+    const auto *mux = reg.getValueAtIndex(bits(1))->to<IR::Mux>();
+    ASSERT_NE(mux, nullptr);
+    const auto *symbolicWrite = mux->e1->to<IR::Constant>();
+    ASSERT_NE(symbolicWrite, nullptr);
+    EXPECT_EQ(symbolicWrite->value, 20);
+    const auto *written = mux->e2->to<IR::Constant>();
+    ASSERT_NE(written, nullptr);
+    EXPECT_EQ(written->value, 10);
+
+    // A symbolic read still goes through every write.
+    const auto *read = reg.getValueAtIndex(index);
+    int depth = 0;
+    while (const auto *readMux = read->to<IR::Mux>()) {
+        read = readMux->e2;
+        depth++;
+    }
+    EXPECT_EQ(depth, 3);
+    EXPECT_EQ(read, reg.getInitialValue());
+}
+
+}  // namespace
+
+}  // namespace Test
@@ -234,4 +234,26 @@ TEST_F(STFTest, Stf04) {
     }
 }
 
+/// Render an stf test without writing it and check the written commands.
+TEST_F(STFTest, Stf05) {
+    const auto *pld = IR::getConstant(IR::getBitType(48), big_int("0x222222222222"));
+    const auto *pldIgnMask = IR::getConstant(IR::getBitType(48), big_int("0xffffffffffff"));
+    const auto ingressPacket = Packet(1, pld, pldIgnMask);
+    const auto egressPacket = Packet(2, pld, pldIgnMask);
+
+    const auto fwdConfig = getForwardTableConfig();
+
+    auto testSpec = TestSpec(ingressPacket, egressPacket, {});
+    testSpec.addTestObject("tables", "SwitchIngress.forward", &fwdConfig);
+
+    TestBackendConfiguration testBackendConfiguration{"test05", 1, "test05", 5};
+    auto testWriter = STF(testBackendConfiguration);
+    auto test = testWriter.renderTest(&testSpec, "", 5, 0);
+    EXPECT_THAT(test, HasSubstr("# p4testgen seed: 5\n"));
+    EXPECT_THAT(test, HasSubstr("# Table table\nadd \"table\" \"hdr.ethernet.dst_addr\":"));
+    EXPECT_THAT(test, HasSubstr(" \"SwitchIngress.hit\"(\"port\":"));
+    EXPECT_THAT(test, HasSubstr("\npacket 1 "));
+    EXPECT_THAT(test, HasSubstr("\nexpect 2 "));
+}
+
 }  // namespace Test
@@ -25,7 +25,8 @@
 namespace P4Tools::P4Testgen::Bmv2 {
 
 Metadata::Metadata(const TestBackendConfiguration &testBackendConfiguration)
-    : Bmv2TestFramework(testBackendConfiguration) {}
+    : Bmv2TestFramework(testBackendConfiguration),
+      testCaseTemplate(parseTemplate(getTestCaseTemplate())) {}
 
 std::string Metadata::getTestCaseTemplate() {
     static std::string TEST_CASE(
@@ -89,7 +90,7 @@ void Metadata::computeTraceData(const TestSpec *testSpec, inja::json &dataJson)
 }
 
 void Metadata::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                            const std::string &testCase, float currentCoverage) {
+                            const inja::Template &testCase, float currentCoverage) {
     inja::json dataJson;
     if (selectedBranches != nullptr) {
         dataJson["selected_branches"] = selectedBranches.c_str();
@@ -131,14 +132,13 @@ void Metadata::emitTestcase(const TestSpec *testSpec, cstring selectedBranches,
     incrementedbasePath.concat("_" + std::to_string(testId));
     incrementedbasePath.replace_extension(".yml");
     metadataFile = std::ofstream(incrementedbasePath);
-    inja::render_to(metadataFile, testCase, dataJson);
+    renderTemplate(metadataFile, testCase, dataJson);
     metadataFile.flush();
 }
 
 void Metadata::writeTestToFile(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
                                float currentCoverage) {
-    std::string testCase = getTestCaseTemplate();
-    emitTestcase(testSpec, selectedBranches, testId, testCase, currentCoverage);
+    emitTestcase(testSpec, selectedBranches, testId, testCaseTemplate, currentCoverage);
 }
 
 }  // namespace P4Tools::P4Testgen::Bmv2
@@ -39,7 +39,7 @@ class Metadata : public Bmv2TestFramework {
     /// @param currentCoverage contains statistics  about the current coverage of this test and its
     /// preceding tests.
     void emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                      const std::string &testCase, float currentCoverage);
+                      const inja::Template &testCase, float currentCoverage);
 
     /// Gets the traces from @param testSpec and populates @param dataJson.
     /// Also retrieves the label and offset for each successful extract call and stores them in a
@@ -48,6 +48,9 @@ class Metadata : public Bmv2TestFramework {
 
     /// @returns the inja test case template as a string.
     static std::string getTestCaseTemplate();
+
+    /// The parsed test case template.
+    inja::Template testCaseTemplate;
 };
 
 }  // namespace P4Tools::P4Testgen::Bmv2
@@ -32,7 +32,8 @@ Protobuf::Protobuf(const TestBackendConfiguration &testBackendConfiguration,
                    P4::P4RuntimeAPI p4RuntimeApi)
     : Bmv2TestFramework(testBackendConfiguration),
       p4RuntimeApi(p4RuntimeApi),
-      p4InfoMaps(P4::ControlPlaneAPI::P4InfoMaps(*p4RuntimeApi.p4Info)) {}
+      p4InfoMaps(P4::ControlPlaneAPI::P4InfoMaps(*p4RuntimeApi.p4Info)),
+      testCaseTemplate(parseTemplate(getTestCaseTemplate())) {}
 
 inja::json Protobuf::getControlPlane(const TestSpec *testSpec) const {
     inja::json controlPlaneJson = inja::json::object();
@@ -356,17 +357,26 @@ void Protobuf::writeTestToFile(const TestSpec *testSpec, cstring selectedBranche
     incrementedbasePath.concat("_" + std::to_string(testId));
     incrementedbasePath.replace_extension(".txtpb");
     auto protobufFileStream = std::ofstream(incrementedbasePath);
-    inja::render_to(protobufFileStream, getTestCaseTemplate(), dataJson);
+    renderTemplate(protobufFileStream, testCaseTemplate, dataJson);
     protobufFileStream.flush();
 }
 
+bool Protobuf::writesTestsToSeparateFiles() const { return true; }
+
+std::string Protobuf::renderTest(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
+                                 float currentCoverage) {
+    inja::json dataJson = produceTestCase(testSpec, selectedBranches, testId, currentCoverage);
+    LOG5("Protobuf test back end: rendering testcase:" << std::setw(4) << dataJson);
+    return renderTemplate(testCaseTemplate, dataJson);
+}
+
 AbstractTestReferenceOrError Protobuf::produceTest(const TestSpec *testSpec,
                                                    cstring selectedBranches, size_t testId,
                                                    float currentCoverage) {
     inja::json dataJson = produceTestCase(testSpec, selectedBranches, testId, currentCoverage);
     LOG5("ProtobufIR test back end: generated testcase:" << std::setw(4) << dataJson);
 
-    return new ProtobufTest(inja::render(getTestCaseTemplate(), dataJson));
+    return new ProtobufTest(renderTemplate(testCaseTemplate, dataJson));
 }
 
 }  // namespace P4Tools::P4Testgen::Bmv2
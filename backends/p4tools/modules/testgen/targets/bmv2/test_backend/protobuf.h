@@ -43,6 +43,11 @@ class Protobuf : public Bmv2TestFramework {
     void writeTestToFile(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
                          float currentCoverage) override;
 
+    [[nodiscard]] bool writesTestsToSeparateFiles() const override;
+
+    std::string renderTest(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
+                           float currentCoverage) override;
+
     AbstractTestReferenceOrError produceTest(const TestSpec *testSpec, cstring selectedBranches,
                                              size_t testIdx, float currentCoverage) override;
 
@@ -82,6 +87,9 @@ class Protobuf : public Bmv2TestFramework {
     /// @returns the inja test case template as a string.
     static std::string getTestCaseTemplate();
 
+    /// The parsed test case template.
+    inja::Template testCaseTemplate;
+
     /// The Protobuf back end needs the parent table and action name to correctly identify the
     /// corresponding P4Runtme id. This is why we use a custom "getControlPlaneForTable" function
     /// here.
@@ -22,7 +22,10 @@ namespace P4Tools::P4Testgen::Bmv2 {
 
 ProtobufIr::ProtobufIr(const TestBackendConfiguration &testBackendConfiguration,
                        P4::P4RuntimeAPI p4RuntimeApi)
-    : Bmv2TestFramework(testBackendConfiguration), p4RuntimeApi(p4RuntimeApi) {}
+    : Bmv2TestFramework(testBackendConfiguration),
+      p4RuntimeApi(p4RuntimeApi),
+      p4InfoIndex(*p4RuntimeApi.p4Info),
+      testCaseTemplate(parseTemplate(getTestCaseTemplate())) {}
 
 std::optional<std::string> ProtobufIr::checkForP4RuntimeTranslationAnnotation(
     const IR::IAnnotated *node) {
@@ -322,8 +325,7 @@ void ProtobufIr::createKeyMatch(cstring fieldName, const TableMatch &fieldMatch,
 
 inja::json ProtobufIr::getControlPlaneTable(const TableConfig &tblConfig) const {
     inja::json tblJson;
-    const auto *p4RuntimeTableOpt = P4::ControlPlaneAPI::findP4RuntimeTable(
-        *p4RuntimeApi.p4Info, tblConfig.getTable()->controlPlaneName());
+    const auto *p4RuntimeTableOpt = p4InfoIndex.findTable(tblConfig.getTable()->controlPlaneName());
     BUG_CHECK(p4RuntimeTableOpt != nullptr, "Table not found in the P4Info file.");
     tblJson["table_name"] = p4RuntimeTableOpt->preamble().alias();
 
@@ -334,8 +336,8 @@ inja::json ProtobufIr::getControlPlaneTable(const TableConfig &tblConfig) const
         const auto *matches = tblRule.getMatches();
         const auto *actionCall = tblRule.getActionCall();
         const auto *actionArgs = actionCall->getArgs();
-        const auto *p4RuntimeActionOpt = P4::ControlPlaneAPI::findP4RuntimeAction(
-            *p4RuntimeApi.p4Info, actionCall->getAction()->controlPlaneName());
+        const auto *p4RuntimeActionOpt =
+            p4InfoIndex.findAction(actionCall->getAction()->controlPlaneName());
         BUG_CHECK(p4RuntimeActionOpt != nullptr, "Action not found in the P4Info file.");
         rule["action_name"] = p4RuntimeActionOpt->preamble().alias();
         auto j = getControlPlaneForTable(*matches, *actionArgs);
@@ -449,17 +451,26 @@ void ProtobufIr::writeTestToFile(const TestSpec *testSpec, cstring selectedBranc
     incrementedbasePath.concat("_" + std::to_string(testId));
     incrementedbasePath.replace_extension(".txtpb");
     auto protobufFileStream = std::ofstream(incrementedbasePath);
-    inja::render_to(protobufFileStream, getTestCaseTemplate(), dataJson);
+    renderTemplate(protobufFileStream, testCaseTemplate, dataJson);
     protobufFileStream.flush();
 }
 
+bool ProtobufIr::writesTestsToSeparateFiles() const { return true; }
+
+std::string ProtobufIr::renderTest(const TestSpec *testSpec, cstring selectedBranches,
+                                   size_t testId, float currentCoverage) {
+    inja::json dataJson = produceTestCase(testSpec, selectedBranches, testId, currentCoverage);
+    LOG5("ProtobufIR test back end: rendering testcase:" << std::setw(4) << dataJson);
+    return renderTemplate(testCaseTemplate, dataJson);
+}
+
 AbstractTestReferenceOrError ProtobufIr::produceTest(const TestSpec *testSpec,
                                                      cstring selectedBranches, size_t testId,
                                                      float currentCoverage) {
     inja::json dataJson = produceTestCase(testSpec, selectedBranches, testId, currentCoverage);
     LOG5("ProtobufIR test back end: generated testcase:" << std::setw(4) << dataJson);
 
-    return new ProtobufIrTest(inja::render(getTestCaseTemplate(), dataJson));
+    return new ProtobufIrTest(renderTemplate(testCaseTemplate, dataJson));
 }
 
 }  // namespace P4Tools::P4Testgen::Bmv2
@@ -8,6 +8,7 @@
 #include <inja/inja.hpp>
 
 #include "control-plane/p4RuntimeSerializer.h"
+#include "control-plane/p4infoApi.h"
 #include "lib/cstring.h"
 
 #include "backends/p4tools/modules/testgen/lib/test_spec.h"
@@ -44,6 +45,11 @@ class ProtobufIr : public Bmv2TestFramework {
     void writeTestToFile(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
                          float currentCoverage) override;
 
+    [[nodiscard]] bool writesTestsToSeparateFiles() const override;
+
+    std::string renderTest(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
+                           float currentCoverage) override;
+
     AbstractTestReferenceOrError produceTest(const TestSpec *testSpec, cstring selectedBranches,
                                              size_t testIdx, float currentCoverage) override;
 
@@ -52,6 +58,10 @@ class ProtobufIr : public Bmv2TestFramework {
     /// tables.
     P4::P4RuntimeAPI p4RuntimeApi;
 
+    /// Index of the P4Info of @ref p4RuntimeApi, used to look up the tables and actions of each
+    /// control plane configuration.
+    P4::ControlPlaneAPI::P4InfoIndex p4InfoIndex;
+
     [[nodiscard]] inja::json getControlPlaneTable(const TableConfig &tblConfig) const override;
 
     [[nodiscard]] inja::json getControlPlaneForTable(
@@ -72,6 +82,9 @@ class ProtobufIr : public Bmv2TestFramework {
     /// @returns the inja test case template as a string.
     static std::string getTestCaseTemplate();
 
+    /// The parsed test case template.
+    inja::Template testCaseTemplate;
+
     /// Checks whether the node has a `@p4runtime_translation` attached to it. If that is the case,
     /// returns the name of the translated type contained within the annotation.
     static std::optional<std::string> checkForP4RuntimeTranslationAnnotation(
@@ -21,7 +21,8 @@
 namespace P4Tools::P4Testgen::Bmv2 {
 
 PTF::PTF(const TestBackendConfiguration &testBackendConfiguration)
-    : Bmv2TestFramework(testBackendConfiguration) {}
+    : Bmv2TestFramework(testBackendConfiguration),
+      testCaseTemplate(parseTemplate(getTestCaseTemplate())) {}
 
 std::vector<std::pair<size_t, size_t>> PTF::getIgnoreMasks(const IR::Constant *mask) {
     std::vector<std::pair<size_t, size_t>> ignoreMasks;
@@ -63,7 +64,7 @@ inja::json PTF::getExpectedPacket(const TestSpec *testSpec) const {
     return verifyData;
 }
 
-void PTF::emitPreamble() {
+std::string PTF::renderPreamble() const {
     static const std::string PREAMBLE(
         R"""(# P4Runtime PTF test for {{test_name}}
 # p4testgen seed: {{ default(seed, "none") }}
@@ -146,6 +147,34 @@ class AbstractTest(bt.P4RuntimeTest):
                 )
             return self.direct_meter_write(meter_config, table_id, table_entry)
         return self.meter_write(meter_name, index, meter_config)
+
+    def push_table_add(self, req, table_name_and_key, action_name_and_params, priority, options=None):
+        """Adds the insertion of a table entry to the write request req, like table_add. The default entry is modified instead."""
+        table_entry = self.make_table_entry(
+            table_name_and_key, action_name_and_params, priority, options
+        )
+        update = req.updates.add()
+        update.type = bt.p4runtime_pb2.Update.INSERT
+        if table_name_and_key[1] is None:
+            update.type = bt.p4runtime_pb2.Update.MODIFY
+        update.entity.table_entry.CopyFrom(table_entry)
+
+    def push_clone_session(self, req, session_id, ports):
+        """Adds the insertion of a clone session to the write request req, like insert_pre_clone_session."""
+        update = req.updates.add()
+        update.type = bt.p4runtime_pb2.Update.INSERT
+        clone_entry = update.entity.packet_replication_engine_entry.clone_session_entry
+        clone_entry.session_id = session_id
+        for port in ports:
+            replica = clone_entry.replicas.add()
+            replica.egress_port = port
+            replica.instance = 1
+
+    def write_batch(self, req):
+        """Sends all the updates of req in a single Write RPC. Only the inserted entities are removed by the cleanup."""
+        if len(req.updates) > 0:
+            bt.testutils.log.info(f"write_batch: {len(req.updates)} updates")
+            self.write_request(req)
 )""");
 
     inja::json dataJson;
@@ -155,7 +184,11 @@ class AbstractTest(bt.P4RuntimeTest):
         dataJson["seed"] = optSeed.value();
     }
 
-    inja::render_to(ptfFileStream, PREAMBLE, dataJson);
+    return inja::render(PREAMBLE, dataJson);
+}
+
+void PTF::emitPreamble() {
+    ptfFileStream << renderPreamble();
     ptfFileStream.flush();
 }
 
@@ -176,12 +209,13 @@ class Test{{test_id}}(AbstractTest):
     '''
 
     def setupCtrlPlane(self):
-        # Simple noop that is always called as filler.
-        pass
+        # All the entries and clone sessions are installed with a single Write RPC.
+        req = self.get_new_write_request()
 ## if control_plane
 ## for table in control_plane.tables
 ## for rule in table.rules
-        self.table_add(
+        self.push_table_add(
+            req,
             ('{{table.table_name}}',
             [
 ## for r in rule.rules.single_exact_matches
@@ -214,9 +248,11 @@ class Test{{test_id}}(AbstractTest):
 ## endif
 ## if exists("clone_specs")
 ## for clone_pkt in clone_specs.clone_pkts
-        self.insert_pre_clone_session({{clone_pkt.session_id}}, [{{clone_pkt.clone_port}}])
+        self.push_clone_session(req, {{clone_pkt.session_id}}, [{{clone_pkt.clone_port}}])
 ## endfor
 ## endif
+        self.write_batch(req)
+        # Direct meters are configured through the entry of their table, which must exist first.
 ## for meter_value in meter_values
         self.meter_write_with_predefined_config("{{meter_value.name}}", {{meter_value.index}}, {{meter_value.value}}, {{meter_value.is_direct}})
 ## endfor
@@ -263,8 +299,8 @@ class Test{{test_id}}(AbstractTest):
     return TEST_CASE;
 }
 
-void PTF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                       const std::string &testCase, float currentCoverage) {
+inja::json PTF::produceTestCase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
+                                float currentCoverage) const {
     inja::json dataJson;
     if (selectedBranches != nullptr) {
         dataJson["selected_branches"] = selectedBranches.c_str();
@@ -289,7 +325,12 @@ void PTF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_
     }
     auto meterValues = testSpec->getTestObjectCategory("meter_values");
     dataJson["meter_values"] = getMeter(meterValues);
+    return dataJson;
+}
 
+void PTF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
+                       const inja::Template &testCase, float currentCoverage) {
+    inja::json dataJson = produceTestCase(testSpec, selectedBranches, testId, currentCoverage);
     LOG5("PTF backend: emitting testcase:" << std::setw(4) << dataJson);
 
     if (!preambleEmitted) {
@@ -300,14 +341,20 @@ void PTF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_
         emitPreamble();
         preambleEmitted = true;
     }
-    inja::render_to(ptfFileStream, testCase, dataJson);
+    renderTemplate(ptfFileStream, testCase, dataJson);
     ptfFileStream.flush();
 }
 
 void PTF::writeTestToFile(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
                           float currentCoverage) {
-    std::string testCase = getTestCaseTemplate();
-    emitTestcase(testSpec, selectedBranches, testId, testCase, currentCoverage);
+    emitTestcase(testSpec, selectedBranches, testId, testCaseTemplate, currentCoverage);
+}
+
+std::string PTF::renderTest(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
+                            float currentCoverage) {
+    inja::json dataJson = produceTestCase(testSpec, selectedBranches, testId, currentCoverage);
+    LOG5("PTF backend: rendering testcase:" << std::setw(4) << dataJson);
+    return renderTemplate(testCaseTemplate, dataJson);
 }
 
 }  // namespace P4Tools::P4Testgen::Bmv2
@@ -30,6 +30,12 @@ class PTF : public Bmv2TestFramework {
     void writeTestToFile(const TestSpec *spec, cstring selectedBranches, size_t testId,
                          float currentCoverage) override;
 
+    std::string renderTest(const TestSpec *spec, cstring selectedBranches, size_t testId,
+                           float currentCoverage) override;
+
+    /// @returns the test setup Python script, which precedes all test cases.
+    [[nodiscard]] std::string renderPreamble() const override;
+
  private:
     /// Has the preamble been generated already?
     bool preambleEmitted = false;
@@ -47,11 +53,19 @@ class PTF : public Bmv2TestFramework {
     /// @param currentCoverage contains statistics  about the current coverage of this test and its
     /// preceding tests.
     void emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                      const std::string &testCase, float currentCoverage);
+                      const inja::Template &testCase, float currentCoverage);
+
+    /// Generates the data of a test case for the test case template.
+    /// The parameters are the same as those of @ref emitTestcase.
+    inja::json produceTestCase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
+                               float currentCoverage) const;
 
     /// @returns the inja test case template as a string.
     static std::string getTestCaseTemplate();
 
+    /// The parsed test case template.
+    inja::Template testCaseTemplate;
+
     inja::json getExpectedPacket(const TestSpec *testSpec) const override;
 
     /// Helper function for @getVerify. Matches the mask value against the input packet value and
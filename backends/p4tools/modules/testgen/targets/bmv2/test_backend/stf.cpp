@@ -3,23 +3,21 @@
 #include <fstream>
 #include <iomanip>
 #include <optional>
+#include <ostream>
+#include <sstream>
 #include <string>
-#include <utility>
 #include <vector>
 
 #include <boost/multiprecision/cpp_int.hpp>
 #include <boost/multiprecision/detail/et_ops.hpp>
 #include <boost/multiprecision/number.hpp>
 #include <boost/multiprecision/traits/explicit_conversion.hpp>
-#include <inja/inja.hpp>
 
 #include "backends/p4tools/common/lib/format_int.h"
 #include "backends/p4tools/common/lib/util.h"
 #include "ir/ir.h"
 #include "ir/irutils.h"
 #include "lib/exceptions.h"
-#include "lib/log.h"
-#include "nlohmann/json.hpp"
 
 #include "backends/p4tools/modules/testgen/lib/exceptions.h"
 #include "backends/p4tools/modules/testgen/targets/bmv2/test_spec.h"
@@ -29,224 +27,207 @@ namespace P4Tools::P4Testgen::Bmv2 {
 STF::STF(const TestBackendConfiguration &testBackendConfiguration)
     : Bmv2TestFramework(testBackendConfiguration) {}
 
-inja::json STF::getSend(const TestSpec *testSpec) const {
-    const auto *iPacket = testSpec->getIngressPacket();
-    const auto *payload = iPacket->getEvaluatedPayload();
-    inja::json sendJson;
-    sendJson["ig_port"] = iPacket->getPort();
-    sendJson["pkt"] = formatHexExpr(payload, {false, true, false});
-    sendJson["pkt_size"] = payload->type->width_bits();
-    return sendJson;
-}
-
-inja::json STF::getExpectedPacket(const TestSpec *testSpec) const {
-    inja::json verifyData = inja::json::object();
-    if (testSpec->getEgressPacket() != std::nullopt) {
-        const auto &packet = **testSpec->getEgressPacket();
-        verifyData["eg_port"] = packet.getPort();
-        const auto *payload = packet.getEvaluatedPayload();
-        const auto *payloadMask = packet.getEvaluatedPayloadMask();
-        auto dataStr = formatHexExpr(payload, {false, true, false});
-        if (payloadMask != nullptr) {
-            // If a mask is present, construct the packet data  with wildcard `*` where there are
-            // non zero nibbles
-            auto maskStr = formatHexExpr(payloadMask, {false, true, false});
-            std::string packetData;
-            for (size_t dataPos = 0; dataPos < dataStr.size(); ++dataPos) {
-                if (maskStr.at(dataPos) != 'F') {
-                    // TODO: We are being conservative here and adding a wildcard for any 0
-                    // in the 4b nibble
-                    packetData += "*";
-                } else {
-                    packetData += dataStr[dataPos];
-                }
-            }
-            verifyData["exp_pkt"] = packetData;
+std::string STF::formatExpectedPacket(const Packet &packet) {
+    const auto *payload = packet.getEvaluatedPayload();
+    const auto *payloadMask = packet.getEvaluatedPayloadMask();
+    auto dataStr = formatHexExpr(payload, {false, true, false});
+    if (payloadMask == nullptr) {
+        return dataStr;
+    }
+    // If a mask is present, construct the packet data  with wildcard `*` where there are
+    // non zero nibbles
+    auto maskStr = formatHexExpr(payloadMask, {false, true, false});
+    std::string packetData;
+    for (size_t dataPos = 0; dataPos < dataStr.size(); ++dataPos) {
+        if (maskStr.at(dataPos) != 'F') {
+            // TODO: We are being conservative here and adding a wildcard for any 0
+            // in the 4b nibble
+            packetData += "*";
         } else {
-            verifyData["exp_pkt"] = dataStr;
+            packetData += dataStr[dataPos];
         }
     }
-    return verifyData;
+    return packetData;
 }
 
-inja::json STF::getControlPlaneForTable(const TableMatchMap &matches,
-                                        const std::vector<ActionArg> &args) const {
-    inja::json rulesJson;
-
-    rulesJson["matches"] = inja::json::array();
-    rulesJson["act_args"] = inja::json::array();
-    rulesJson["needs_priority"] = false;
-
-    // Iterate over the match fields and segregate them.
-    for (const auto &match : matches) {
-        const auto fieldName = match.first;
-        const auto &fieldMatch = match.second;
-
-        inja::json j;
-        j["field_name"] = fieldName;
-        if (const auto *elem = fieldMatch->to<Exact>()) {
-            j["value"] = formatHexExpr(elem->getEvaluatedValue());
-        } else if (const auto *elem = fieldMatch->to<Ternary>()) {
-            const auto *dataValue = elem->getEvaluatedValue();
-            const auto *maskField = elem->getEvaluatedMask();
-            BUG_CHECK(dataValue->type->width_bits() == maskField->type->width_bits(),
-                      "Data value and its mask should have the same bit width.");
-            // Using the width from mask - should be same as data
-            auto dataStr = formatBinExpr(dataValue, {false, true, false});
-            auto maskStr = formatBinExpr(maskField, {false, true, false});
-            std::string data = "0b";
-            for (size_t dataPos = 0; dataPos < dataStr.size(); ++dataPos) {
-                if (maskStr.at(dataPos) == '0') {
-                    data += "*";
-                } else {
-                    data += dataStr.at(dataPos);
-                }
-            }
-            j["value"] = data;
-            // If the rule has a ternary match we need to add the priority.
-            rulesJson["needs_priority"] = true;
-        } else if (const auto *elem = fieldMatch->to<LPM>()) {
-            const auto *dataValue = elem->getEvaluatedValue();
-            auto prefixLen = elem->getEvaluatedPrefixLength()->asInt();
-            auto fieldWidth = dataValue->type->width_bits();
-            auto maxVal = IR::getMaxBvVal(prefixLen);
-            const auto *maskField =
-                IR::getConstant(dataValue->type, maxVal << (fieldWidth - prefixLen));
-            BUG_CHECK(dataValue->type->width_bits() == maskField->type->width_bits(),
-                      "Data value and its mask should have the same bit width.");
-            // Using the width from mask - should be same as data
-            auto dataStr = formatBinExpr(dataValue, {false, true, false});
-            auto maskStr = formatBinExpr(maskField, {false, true, false});
-            std::string data = "0b";
-            for (size_t dataPos = 0; dataPos < dataStr.size(); ++dataPos) {
-                if (maskStr.at(dataPos) == '0') {
-                    data += "*";
-                } else {
-                    data += dataStr.at(dataPos);
-                }
-            }
-            j["value"] = data;
-            // If the rule has a ternary match we need to add the priority.
-            rulesJson["needs_priority"] = true;
-        } else if (const auto *elem = fieldMatch->to<Optional>()) {
-            j["value"] = formatHexExpr(elem->getEvaluatedValue()).c_str();
-            rulesJson["needs_priority"] = true;
+std::string STF::formatMaskedValue(const IR::Constant *dataValue, const IR::Constant *maskField) {
+    BUG_CHECK(dataValue->type->width_bits() == maskField->type->width_bits(),
+              "Data value and its mask should have the same bit width.");
+    // Using the width from mask - should be same as data
+    auto dataStr = formatBinExpr(dataValue, {false, true, false});
+    auto maskStr = formatBinExpr(maskField, {false, true, false});
+    std::string data = "0b";
+    for (size_t dataPos = 0; dataPos < dataStr.size(); ++dataPos) {
+        if (maskStr.at(dataPos) == '0') {
+            data += "*";
         } else {
-            TESTGEN_UNIMPLEMENTED("Unsupported table key match type \"%1%\"",
-                                  fieldMatch->getObjectName());
+            data += dataStr.at(dataPos);
         }
-        rulesJson["matches"].push_back(j);
     }
+    return data;
+}
 
-    for (const auto &actArg : args) {
-        inja::json j;
-        j["param"] = actArg.getActionParamName().c_str();
-        j["value"] = formatHexExpr(actArg.getEvaluatedValue());
-        rulesJson["act_args"].push_back(j);
+std::string STF::formatMatchValue(const TableMatch &fieldMatch, bool &needsPriority) {
+    if (const auto *elem = fieldMatch.to<Exact>()) {
+        return formatHexExpr(elem->getEvaluatedValue());
     }
-
-    return rulesJson;
+    if (const auto *elem = fieldMatch.to<Ternary>()) {
+        // If the rule has a ternary match we need to add the priority.
+        needsPriority = true;
+        return formatMaskedValue(elem->getEvaluatedValue(), elem->getEvaluatedMask());
+    }
+    if (const auto *elem = fieldMatch.to<LPM>()) {
+        const auto *dataValue = elem->getEvaluatedValue();
+        auto prefixLen = elem->getEvaluatedPrefixLength()->asInt();
+        auto fieldWidth = dataValue->type->width_bits();
+        auto maxVal = IR::getMaxBvVal(prefixLen);
+        const auto *maskField =
+            IR::getConstant(dataValue->type, maxVal << (fieldWidth - prefixLen));
+        // If the rule has a ternary match we need to add the priority.
+        needsPriority = true;
+        return formatMaskedValue(dataValue, maskField);
+    }
+    if (const auto *elem = fieldMatch.to<Optional>()) {
+        needsPriority = true;
+        return formatHexExpr(elem->getEvaluatedValue());
+    }
+    TESTGEN_UNIMPLEMENTED("Unsupported table key match type \"%1%\"", fieldMatch.getObjectName());
 }
 
-std::string STF::getTestCaseTemplate() {
-    static std::string TEST_CASE(
-        R"""(# p4testgen seed: {{ default(seed, "none") }}
-# Date generated: {{timestamp}}
-## if length(selected_branches) > 0
-    # {{selected_branches}}
-## endif
-# Current node coverage: {{coverage}}
-# Traces
-## for trace_item in trace
-# {{trace_item}}
-##endfor
-
-## if control_plane
-## for table in control_plane.tables
-# Table {{table.table_name}}
-## if existsIn(table, "default_override")
-setdefault "{{table.table_name}}" "{{table.default_override.action_name}}"({% for a in table.default_override.act_args %}"{{a.param}}":{{a.value}}{% if not loop.is_last %},{% endif %}{% endfor %})
-## else
-## for rule in table.rules
-add "{{table.table_name}}" {% if rule.rules.needs_priority %}{{rule.priority}} {% endif %}{% for r in rule.rules.matches %}"{{r.field_name}}":{{r.value}} {% endfor %}"{{rule.action_name}}"({% for a in rule.rules.act_args %}"{{a.param}}":{{a.value}}{% if not loop.is_last %},{% endif %}{% endfor %})
-## endfor
-## endif
-
-## endfor
-## endif
-
-## if exists("clone_specs")
-## for clone_spec in clone_specs.clone_pkts
-mirroring_add {{clone_spec.session_id}} {{clone_spec.clone_port}}
-packet {{send.ig_port}} {{send.pkt}}
-## if clone_spec.cloned
-## if verify
-expect {{clone_spec.clone_port}} {{verify.exp_pkt}}$
-expect {{verify.eg_port}}
-## endif
-## else
-expect {{clone_spec.clone_port}}
-## if verify
-expect {{verify.eg_port}} {{verify.exp_pkt}}$
-## endif
-## endif
-## endfor
-## else
-packet {{send.ig_port}} {{send.pkt}}
-## if verify
-expect {{verify.eg_port}} {{verify.exp_pkt}}$
-## endif
-## endif
-
-)""");
-    return TEST_CASE;
+void STF::emitActionArgs(std::ostream &output, const std::vector<ActionArg> &args) {
+    output << "(";
+    for (size_t idx = 0; idx < args.size(); ++idx) {
+        if (idx > 0) {
+            output << ",";
+        }
+        output << "\"" << args[idx].getActionParamName() << "\":"
+               << formatHexExpr(args[idx].getEvaluatedValue());
+    }
+    output << ")";
 }
 
-void STF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                       const std::string &testCase, float currentCoverage) {
-    inja::json dataJson;
-    if (selectedBranches != nullptr) {
-        dataJson["selected_branches"] = selectedBranches.c_str();
+void STF::emitTable(std::ostream &output, const TableConfig &tblConfig) {
+    auto tableName = tblConfig.getTable()->controlPlaneName();
+    output << "# Table " << tableName << "\n";
+    // If the default action is overridden, we assume there are no keys and we just set the
+    // default action of the table.
+    const auto *defaultOverrideObj = tblConfig.getProperty("overriden_default_action", false);
+    if (defaultOverrideObj != nullptr) {
+        const auto *defaultAction = defaultOverrideObj->checkedTo<ActionCall>();
+        output << "setdefault \"" << tableName << "\" \"" << defaultAction->getActionName()
+               << "\"";
+        emitActionArgs(output, *defaultAction->getArgs());
+        output << "\n";
+    } else {
+        for (const auto &tblRule : *tblConfig.getRules()) {
+            bool needsPriority = false;
+            std::stringstream matches;
+            for (const auto &match : *tblRule.getMatches()) {
+                matches << "\"" << match.first
+                        << "\":" << formatMatchValue(*match.second, needsPriority) << " ";
+            }
+            const auto *actionCall = tblRule.getActionCall();
+            output << "add \"" << tableName << "\" ";
+            if (needsPriority) {
+                output << tblRule.getPriority() << " ";
+            }
+            output << matches.str() << "\"" << actionCall->getActionName() << "\"";
+            emitActionArgs(output, *actionCall->getArgs());
+            output << "\n";
+        }
     }
+    output << "\n";
+}
+
+void STF::emitTestcase(std::ostream &output, const TestSpec *testSpec, cstring selectedBranches,
+                       float currentCoverage) const {
     auto optSeed = getTestBackendConfiguration().seed;
+    output << "# p4testgen seed: ";
     if (optSeed.has_value()) {
-        dataJson["seed"] = optSeed.value();
+        output << optSeed.value();
+    } else {
+        output << "none";
+    }
+    output << "\n";
+    output << "# Date generated: " << Utils::getTimeStamp() << "\n";
+    if (selectedBranches != nullptr && !selectedBranches.isNullOrEmpty()) {
+        output << "    # " << selectedBranches << "\n";
     }
-
-    dataJson["test_id"] = testId;
-    dataJson["trace"] = getTrace(testSpec);
-    dataJson["control_plane"] = getControlPlane(testSpec);
-    dataJson["send"] = getSend(testSpec);
-    dataJson["verify"] = getExpectedPacket(testSpec);
-    dataJson["timestamp"] = Utils::getTimeStamp();
     std::stringstream coverageStr;
     coverageStr << std::setprecision(2) << currentCoverage;
-    dataJson["coverage"] = coverageStr.str();
+    output << "# Current node coverage: " << coverageStr.str() << "\n";
+    output << "# Traces\n";
+    if (const auto *traces = testSpec->getTraces()) {
+        for (const auto &trace : *traces) {
+            output << "# " << trace << "\n";
+        }
+    }
+    output << "\n";
+
+    for (const auto &testObject : testSpec->getTestObjectCategory("tables")) {
+        emitTable(output, *testObject.second->checkedTo<TableConfig>());
+    }
+    output << "\n";
+
+    const auto *iPacket = testSpec->getIngressPacket();
+    auto send = "packet " + std::to_string(iPacket->getPort()) + " " +
+                formatHexExpr(iPacket->getEvaluatedPayload(), {false, true, false}) + "\n";
+    std::optional<const Packet *> egressPacket = testSpec->getEgressPacket();
+    std::string expectedPort;
+    std::string expectedPacket;
+    if (egressPacket.has_value()) {
+        expectedPort = std::to_string(egressPacket.value()->getPort());
+        expectedPacket = formatExpectedPacket(*egressPacket.value());
+    }
 
     // Check whether this test has a clone configuration.
     // These are special because they require additional instrumentation and produce two output
     // packets.
     auto cloneSpecs = testSpec->getTestObjectCategory("clone_specs");
-    if (!cloneSpecs.empty()) {
-        dataJson["clone_specs"] = getClone(cloneSpecs);
+    if (cloneSpecs.empty()) {
+        output << send;
+        if (egressPacket.has_value()) {
+            output << "expect " << expectedPort << " " << expectedPacket << "$\n";
+        }
     }
+    for (const auto &cloneSpecTuple : cloneSpecs) {
+        const auto *cloneSpec = cloneSpecTuple.second->checkedTo<Bmv2V1ModelCloneSpec>();
+        auto clonePort = cloneSpec->getEvaluatedClonePort()->asInt();
+        output << "mirroring_add " << cloneSpec->getEvaluatedSessionId()->asUint64() << " "
+               << clonePort << "\n";
+        output << send;
+        if (cloneSpec->isClonedPacket()) {
+            if (egressPacket.has_value()) {
+                output << "expect " << clonePort << " " << expectedPacket << "$\n";
+                output << "expect " << expectedPort << "\n";
+            }
+        } else {
+            output << "expect " << clonePort << "\n";
+            if (egressPacket.has_value()) {
+                output << "expect " << expectedPort << " " << expectedPacket << "$\n";
+            }
+        }
+    }
+    output << "\n";
+}
 
-    LOG5("STF test back end: emitting testcase:" << std::setw(4) << dataJson);
-
+void STF::writeTestToFile(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
+                          float currentCoverage) {
     auto optBasePath = getTestBackendConfiguration().fileBasePath;
     BUG_CHECK(optBasePath.has_value(), "Base path is not set.");
     auto incrementedbasePath = optBasePath.value();
     incrementedbasePath.concat("_" + std::to_string(testId));
     incrementedbasePath.replace_extension(".stf");
     auto stfFileStream = std::ofstream(incrementedbasePath);
-    inja::render_to(stfFileStream, testCase, dataJson);
+    emitTestcase(stfFileStream, testSpec, selectedBranches, currentCoverage);
     stfFileStream.flush();
 }
 
-void STF::writeTestToFile(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                          float currentCoverage) {
-    std::string testCase = getTestCaseTemplate();
-    emitTestcase(testSpec, selectedBranches, testId, testCase, currentCoverage);
+std::string STF::renderTest(const TestSpec *testSpec, cstring selectedBranches, size_t /*testId*/,
+                            float currentCoverage) {
+    std::stringstream output;
+    emitTestcase(output, testSpec, selectedBranches, currentCoverage);
+    return output.str();
 }
 
 }  // namespace P4Tools::P4Testgen::Bmv2
@@ -2,11 +2,11 @@
 #define BACKENDS_P4TOOLS_MODULES_TESTGEN_TARGETS_BMV2_TEST_BACKEND_STF_H_
 
 #include <cstddef>
+#include <ostream>
 #include <string>
 #include <vector>
 
-#include <inja/inja.hpp>
-
+#include "ir/ir.h"
 #include "lib/cstring.h"
 
 #include "backends/p4tools/modules/testgen/lib/test_spec.h"
@@ -14,7 +14,8 @@
 
 namespace P4Tools::P4Testgen::Bmv2 {
 
-/// Extracts information from the @testSpec to emit a STF test case.
+/// Extracts information from the @testSpec to emit a STF test case. STF tests are written
+/// directly, as the format is simple enough to not need a template.
 class STF : public Bmv2TestFramework {
  public:
     explicit STF(const TestBackendConfiguration &testBackendConfiguration);
@@ -23,25 +24,34 @@ class STF : public Bmv2TestFramework {
     void writeTestToFile(const TestSpec *spec, cstring selectedBranches, size_t testId,
                          float currentCoverage) override;
 
+    std::string renderTest(const TestSpec *spec, cstring selectedBranches, size_t testId,
+                           float currentCoverage) override;
+
  private:
-    /// Emits a test case.
-    /// @param testId specifies the test name.
+    /// Writes a test case directly into @param output, without building a template object.
     /// @param selectedBranches enumerates the choices the interpreter made for this path.
     /// @param currentCoverage contains statistics  about the current coverage of this test and its
     /// preceding tests.
-    void emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                      const std::string &testCase, float currentCoverage);
+    void emitTestcase(std::ostream &output, const TestSpec *testSpec, cstring selectedBranches,
+                      float currentCoverage) const;
+
+    /// Writes the entries or the default action of the table @param tblConfig.
+    static void emitTable(std::ostream &output, const TableConfig &tblConfig);
 
-    /// @returns the inja test case template as a string.
-    static std::string getTestCaseTemplate();
+    /// Writes the arguments @param args of an action call.
+    static void emitActionArgs(std::ostream &output, const std::vector<ActionArg> &args);
 
-    inja::json getExpectedPacket(const TestSpec *testSpec) const override;
+    /// @returns the value of the key match @param fieldMatch. Sets @param needsPriority if the
+    /// match requires a priority.
+    static std::string formatMatchValue(const TableMatch &fieldMatch, bool &needsPriority);
 
-    /// TODO: Fix how BMv2 parses packet strings. We should support hex and octal prefixes.
-    inja::json getSend(const TestSpec *testSpec) const override;
+    /// @returns @param dataValue in binary, with a wildcard for each bit which is not set in
+    /// @param maskField.
+    static std::string formatMaskedValue(const IR::Constant *dataValue,
+                                         const IR::Constant *maskField);
 
-    inja::json getControlPlaneForTable(const TableMatchMap &matches,
-                                       const std::vector<ActionArg> &args) const override;
+    /// @returns the payload of @param packet with a wildcard for each masked nibble.
+    static std::string formatExpectedPacket(const Packet &packet);
 };
 
 }  // namespace P4Tools::P4Testgen::Bmv2
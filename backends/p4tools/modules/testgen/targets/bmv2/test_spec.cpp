@@ -1,5 +1,8 @@
 #include "backends/p4tools/modules/testgen/targets/bmv2/test_spec.h"
 
+#include <utility>
+#include <vector>
+
 #include "backends/p4tools/common/lib/model.h"
 #include "lib/exceptions.h"
 
@@ -58,7 +61,27 @@ std::map<big_int, std::pair<int, const IR::Constant *>> IndexMap::unravelMap() c
 
 IndexMap::IndexMap(const IR::Expression *initialValue) : initialValue(initialValue) {}
 
+namespace {
+
+/// @returns whether @p index is the constant @p constant.
+bool isConstantIndex(const IR::Expression *index, const IR::Constant *constant) {
+    const auto *indexConstant = index->to<IR::Constant>();
+    return indexConstant != nullptr && indexConstant->value == constant->value;
+}
+
+}  // namespace
+
 void IndexMap::writeToIndex(const IR::Expression *index, const IR::Expression *value) {
+    if (const auto *constant = index->to<IR::Constant>()) {
+        // Every read of this index now finds the new value first, drop the shadowed writes.
+        std::vector<IndexExpression> remaining;
+        for (const auto &indexMap : indexConditions) {
+            if (!isConstantIndex(indexMap.getIndex(), constant)) {
+                remaining.push_back(indexMap);
+            }
+        }
+        indexConditions = std::move(remaining);
+    }
     indexConditions.emplace_back(index, value);
 }
 
@@ -66,9 +89,27 @@ const IR::Expression *IndexMap::getInitialValue() const { return initialValue; }
 
 const IR::Expression *IndexMap::getValueAtIndex(const IR::Expression *index) const {
     const IR::Expression *baseExpr = initialValue;
-    for (const auto &indexMap : indexConditions) {
-        const auto *storedIndex = indexMap.getIndex();
-        const auto *storedVal = indexMap.getValue();
+    auto first = indexConditions.begin();
+    const auto *constant = index->to<IR::Constant>();
+    if (constant != nullptr) {
+        for (auto it = indexConditions.rbegin(); it != indexConditions.rend(); ++it) {
+            if (isConstantIndex(it->getIndex(), constant)) {
+                baseExpr = it->getValue();
+                if (baseExpr->type->is<IR::Type_InfInt>()) {
+                    baseExpr = new IR::Cast(initialValue->type, baseExpr);
+                }
+                first = it.base();
+                break;
+            }
+        }
+    }
+    for (auto it = first; it != indexConditions.end(); ++it) {
+        const auto *storedIndex = it->getIndex();
+        const auto *storedVal = it->getValue();
+        // Two different constants never match.
+        if (constant != nullptr && storedIndex->is<IR::Constant>()) {
+            continue;
+        }
         baseExpr =
             new IR::Mux(baseExpr->type, new IR::Equ(storedIndex, index), storedVal, baseExpr);
     }
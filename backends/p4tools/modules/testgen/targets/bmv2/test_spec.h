@@ -75,14 +75,16 @@ class IndexMap : public TestObject {
  public:
     explicit IndexMap(const IR::Expression *initialValue);
 
-    /// Write @param value to @param index.
+    /// Write @param value to @param index. A write to a constant index replaces the previous
+    /// writes to the same constant index, so that only the indices touched on a path are kept.
     void writeToIndex(const IR::Expression *index, const IR::Expression *value);
 
     /// @returns the value with which this register has been initialized.
     [[nodiscard]] const IR::Expression *getInitialValue() const;
 
     /// @returns the current value of this register after writes have been performed according to a
-    /// provided index.
+    /// provided index. Reads of a constant index skip the writes to other constant indices, and
+    /// start from the last write to the same index instead of the initial value.
     [[nodiscard]] const IR::Expression *getValueAtIndex(const IR::Expression *index) const;
 
     /// @returns the evaluated register value. This means it must be a constant.
@@ -0,0 +1,172 @@
+#include "backends/p4tools/modules/testgen/targets/ebpf/backend/bundle/bundle.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "backends/p4tools/common/lib/format_int.h"
+#include "ir/ir.h"
+#include "lib/error.h"
+#include "lib/exceptions.h"
+#include "lib/log.h"
+
+#include "backends/p4tools/modules/testgen/lib/exceptions.h"
+#include "backends/p4tools/modules/testgen/lib/test_framework.h"
+#include "backends/p4tools/modules/testgen/lib/test_object.h"
+#include "backends/p4tools/modules/testgen/targets/ebpf/backend/bundle/bundle_format.h"
+
+namespace P4Tools::P4Testgen::EBPF {
+
+namespace {
+
+using BundleFormat::appendString;
+using BundleFormat::appendU32;
+using BundleFormat::MatchKind;
+
+/// @returns the big-endian bytes of @param value, zero-extended to the width of its type.
+std::string toBytes(const IR::Constant *value) {
+    auto bytes = convertBigIntToBytes(value->value, value->type->width_bits(), true);
+    return {bytes.begin(), bytes.end()};
+}
+
+/// @returns the index of the key structure member that the eBPF back end generates for @param
+/// key of @param table. Selector keys have no member.
+uint32_t getKeyIndex(const IR::P4Table *table, const IR::KeyElement *key) {
+    uint32_t index = 0;
+    for (const auto *element : table->getKey()->keyElements) {
+        if (element->matchType->path->name.name == "selector") {
+            continue;
+        }
+        if (element == key) {
+            return index;
+        }
+        index++;
+    }
+    BUG("Key %1% is not a key of table %2%.", key, table);
+}
+
+/// @returns the id the eBPF back end gives to @param action in the value type of
+/// @param table. NoAction has the reserved id 0.
+uint32_t getActionId(const IR::P4Table *table, const IR::P4Action *action) {
+    if (action->name.originalName == "NoAction") {
+        return 0;
+    }
+    uint32_t id = 1;
+    for (const auto *element : table->getActionList()->actionList) {
+        auto name = element->getName();
+        if (name.originalName == "NoAction") {
+            continue;
+        }
+        if (name.name == action->name.name) {
+            return id;
+        }
+        id++;
+    }
+    BUG("Action %1% is not an action of table %2%.", action, table);
+}
+
+void appendKey(std::string &out, uint32_t index, const TableMatch *match) {
+    appendU32(out, index);
+    if (const auto *exact = match->to<Exact>()) {
+        out.push_back(static_cast<char>(MatchKind::Exact));
+        appendU32(out, 0);
+        appendString(out, toBytes(exact->getEvaluatedValue()));
+        appendString(out, {});
+    } else if (const auto *lpm = match->to<LPM>()) {
+        out.push_back(static_cast<char>(MatchKind::Lpm));
+        appendU32(out, lpm->getEvaluatedPrefixLength()->asUnsigned());
+        appendString(out, toBytes(lpm->getEvaluatedValue()));
+        appendString(out, {});
+    } else if (const auto *ternary = match->to<Ternary>()) {
+        out.push_back(static_cast<char>(MatchKind::Ternary));
+        appendU32(out, 0);
+        appendString(out, toBytes(ternary->getEvaluatedValue()));
+        appendString(out, toBytes(ternary->getEvaluatedMask()));
+    } else {
+        TESTGEN_UNIMPLEMENTED("Unsupported table key match type \"%1%\"",
+                              match->getObjectName());
+    }
+}
+
+}  // namespace
+
+Bundle::Bundle(const TestBackendConfiguration &testBackendConfiguration)
+    : TestFramework(testBackendConfiguration) {}
+
+void Bundle::appendEntries(std::string &out, const TestSpec *testSpec) {
+    std::vector<std::string> entries;
+    for (const auto &testObject : testSpec->getTestObjectCategory("tables")) {
+        const auto *tableConfig = testObject.second->checkedTo<TableConfig>();
+        const auto *table = tableConfig->getTable();
+        auto mapName = table->externalName().replace('.', '_');
+        for (const auto &rule : *tableConfig->getRules()) {
+            std::string entry;
+            const auto *actionCall = rule.getActionCall();
+            const auto *action = actionCall->getAction();
+            appendString(entry, mapName.c_str());
+            appendU32(entry, static_cast<uint32_t>(rule.getPriority()));
+            appendU32(entry, getActionId(table, action));
+            appendString(entry, action->externalName().replace('.', '_').c_str());
+            const auto *matches = rule.getMatches();
+            appendU32(entry, static_cast<uint32_t>(matches->size()));
+            for (const auto &match : *matches) {
+                appendKey(entry, getKeyIndex(table, match.second->getKey()), match.second);
+            }
+            const auto *args = actionCall->getArgs();
+            appendU32(entry, static_cast<uint32_t>(args->size()));
+            for (const auto &arg : *args) {
+                appendString(entry, arg.getActionParam()->externalName().c_str());
+                appendString(entry, toBytes(arg.getEvaluatedValue()));
+            }
+            entries.push_back(std::move(entry));
+        }
+    }
+    appendU32(out, static_cast<uint32_t>(entries.size()));
+    for (const auto &entry : entries) {
+        out.append(entry);
+    }
+}
+
+void Bundle::writeTestToFile(const TestSpec *testSpec, cstring /*selectedBranches*/,
+                             size_t testId, float /*currentCoverage*/) {
+    if (!bundleFile.is_open()) {
+        auto optBasePath = getTestBackendConfiguration().fileBasePath;
+        BUG_CHECK(optBasePath.has_value(), "Base path is not set.");
+        auto bundlePath = optBasePath.value();
+        bundlePath.replace_extension(".bundle");
+        bundleFile.open(bundlePath, std::ios::binary | std::ios::trunc);
+        if (!bundleFile.is_open()) {
+            ::error(ErrorType::ERR_IO, "Unable to open %1% for writing.", bundlePath.c_str());
+            return;
+        }
+        std::string header(std::begin(BundleFormat::MAGIC), std::end(BundleFormat::MAGIC));
+        appendU32(header, BundleFormat::VERSION);
+        bundleFile << header;
+    }
+
+    std::string record;
+    appendU32(record, static_cast<uint32_t>(testId));
+    const auto *ingressPacket = testSpec->getIngressPacket();
+    appendU32(record, ingressPacket->getPort());
+    appendString(record, toBytes(ingressPacket->getEvaluatedPayload()));
+    auto egressPacket = testSpec->getEgressPacket();
+    record.push_back(static_cast<char>(egressPacket.has_value()));
+    if (egressPacket.has_value()) {
+        const auto &packet = **egressPacket;
+        appendU32(record, packet.getPort());
+        auto payload = toBytes(packet.getEvaluatedPayload());
+        const auto *payloadMask = packet.getEvaluatedPayloadMask();
+        auto mask = payloadMask != nullptr ? toBytes(payloadMask)
+                                           : std::string(payload.size(), '\xFF');
+        appendString(record, payload);
+        appendString(record, mask);
+    }
+    appendEntries(record, testSpec);
+
+    LOG5("Bundle test back end: emitting test " << testId << " of " << record.size() << " bytes");
+    bundleFile << record;
+    bundleFile.flush();
+}
+
+}  // namespace P4Tools::P4Testgen::EBPF
@@ -0,0 +1,43 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_TARGETS_EBPF_BACKEND_BUNDLE_BUNDLE_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_TARGETS_EBPF_BACKEND_BUNDLE_BUNDLE_H_
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+#include "lib/cstring.h"
+
+#include "backends/p4tools/modules/testgen/lib/test_framework.h"
+#include "backends/p4tools/modules/testgen/lib/test_spec.h"
+
+namespace P4Tools::P4Testgen::EBPF {
+
+/// Writes all tests into one binary bundle, "<base>.bundle", in the format described in
+/// bundle_format.h. The bundle is replayed by p4testgen-ebpf-runner, which loads the compiled
+/// program once and runs every test in the kernel with BPF_PROG_TEST_RUN, instead of setting up
+/// interfaces and capturing packets per test as STF tests do.
+class Bundle : public TestFramework {
+ public:
+    ~Bundle() override = default;
+    Bundle(const Bundle &) = delete;
+    Bundle(Bundle &&) = delete;
+    Bundle &operator=(const Bundle &) = delete;
+    Bundle &operator=(Bundle &&) = delete;
+
+    explicit Bundle(const TestBackendConfiguration &testBackendConfiguration);
+
+    /// Appends the test to the bundle.
+    void writeTestToFile(const TestSpec *spec, cstring selectedBranches, size_t testId,
+                         float currentCoverage) override;
+
+ private:
+    /// Appends the table entries of @param testSpec to @param out.
+    static void appendEntries(std::string &out, const TestSpec *testSpec);
+
+    /// The bundle. Opened, and its header written, with the first test.
+    std::ofstream bundleFile;
+};
+
+}  // namespace P4Tools::P4Testgen::EBPF
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_TARGETS_EBPF_BACKEND_BUNDLE_BUNDLE_H_ */
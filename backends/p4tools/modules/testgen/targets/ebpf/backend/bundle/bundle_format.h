@@ -0,0 +1,54 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_TARGETS_EBPF_BACKEND_BUNDLE_BUNDLE_FORMAT_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_TARGETS_EBPF_BACKEND_BUNDLE_BUNDLE_FORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// The binary format of eBPF test bundles, shared by the BUNDLE test back end and the bundle
+/// runner. This header does not depend on the rest of P4Testgen, so that the runner can be built
+/// against libbpf alone.
+///
+/// All integers are little-endian. A "string" is a u32 length followed by that many bytes.
+/// Field values, masks, and packets are big-endian byte strings, as they appear in the packet.
+///
+///   bundle  := MAGIC u32:VERSION test*
+///   test    := u32:testId u32:inputPort string:inputPacket u8:expectOutput
+///              [u32:outputPort string:outputPacket string:outputMask] u32:entryCount entry*
+///   entry   := string:mapName u32:priority u32:actionId string:actionName u32:keyCount key*
+///              u32:argCount arg*
+///   key     := u32:keyIndex u8:MatchKind u32:prefixLength string:value string:mask
+///   arg     := string:paramName string:value
+///
+/// Map, action and parameter names are the C names used by the eBPF back end, and the key
+/// index @c i refers to the member @c field<i> of the key structure, so that the runner can find
+/// the layout of keys and values in the BTF of the compiled object.
+namespace P4Tools::P4Testgen::EBPF::BundleFormat {
+
+/// The first bytes of every bundle.
+inline constexpr char MAGIC[] = {'P', '4', 'T', 'G', 'E', 'B', 'P', 'F'};
+
+/// The version of the format. Incremented on incompatible changes.
+inline constexpr uint32_t VERSION = 1;
+
+/// The name of the prefix length member of the keys of LPM tables.
+inline constexpr const char *PREFIX_FIELD_NAME = "prefixlen";
+
+enum class MatchKind : uint8_t { Exact = 0, Lpm = 1, Ternary = 2 };
+
+/// Appends @param value to @param out.
+inline void appendU32(std::string &out, uint32_t value) {
+    for (size_t byte = 0; byte < sizeof(value); byte++) {
+        out.push_back(static_cast<char>((value >> (8 * byte)) & 0xFF));
+    }
+}
+
+/// Appends @param value to @param out as a length-prefixed string.
+inline void appendString(std::string &out, const std::string &value) {
+    appendU32(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+}  // namespace P4Tools::P4Testgen::EBPF::BundleFormat
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_TARGETS_EBPF_BACKEND_BUNDLE_BUNDLE_FORMAT_H_ */
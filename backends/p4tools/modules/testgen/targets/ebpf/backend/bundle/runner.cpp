@@ -0,0 +1,510 @@
+/// p4testgen-ebpf-runner runs the tests of a bundle written by the BUNDLE test back end of the
+/// P4Testgen eBPF target against the compiled eBPF program:
+///
+///   p4testgen-ebpf-runner [-v] [--section <name>] <program.o> <tests.bundle>
+///
+/// The object is opened and loaded once. For every test, the table entries are written with one
+/// BPF_MAP_UPDATE_BATCH per map, the input packet is run through the program in the kernel with
+/// BPF_PROG_TEST_RUN, and the entries are deleted again. The layout of the keys and values of
+/// the maps is read from the BTF of the object, which the kernel target always emits.
+/// Loading programs requires root privileges (or CAP_BPF and CAP_NET_ADMIN).
+///
+/// Ternary tables, which the eBPF back end implements with tuple maps, are not supported; tests
+/// that configure them are skipped. Ports are not checked, since the programs run on a single
+/// interface. The exit code is 0 if no test failed.
+
+#include <bpf/bpf.h>
+#include <bpf/btf.h>
+#include <bpf/libbpf.h>
+#include <linux/bpf.h>
+#include <linux/pkt_cls.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "backends/p4tools/modules/testgen/targets/ebpf/backend/bundle/bundle_format.h"
+
+namespace {
+
+namespace BundleFormat = P4Tools::P4Testgen::EBPF::BundleFormat;
+using BundleFormat::MatchKind;
+
+/// The smallest packet BPF_PROG_TEST_RUN accepts for TC and XDP programs.
+constexpr size_t MIN_PACKET_SIZE = 14;
+
+/// The largest packet the program may produce.
+constexpr size_t MAX_PACKET_SIZE = 1 << 16;
+
+struct Key {
+    uint32_t index;
+    MatchKind kind;
+    uint32_t prefixLength;
+    std::string value;
+    std::string mask;
+};
+
+struct Entry {
+    std::string mapName;
+    uint32_t priority;
+    uint32_t actionId;
+    std::string actionName;
+    std::vector<Key> keys;
+    std::vector<std::pair<std::string, std::string>> args;
+};
+
+struct Test {
+    uint32_t id;
+    uint32_t inputPort;
+    std::string input;
+    bool expectOutput;
+    uint32_t outputPort = 0;
+    std::string output;
+    std::string mask;
+    std::vector<Entry> entries;
+};
+
+/// Reads the fields of a bundle. Throws std::runtime_error if the bundle is truncated.
+class Reader {
+    const std::string &data;
+    size_t offset = 0;
+
+    void require(size_t size) const {
+        if (data.size() - offset < size) {
+            throw std::runtime_error("truncated bundle");
+        }
+    }
+
+ public:
+    explicit Reader(const std::string &data) : data(data) {}
+
+    [[nodiscard]] bool atEnd() const { return offset == data.size(); }
+
+    uint8_t u8() {
+        require(1);
+        return static_cast<uint8_t>(data[offset++]);
+    }
+
+    uint32_t u32() {
+        require(sizeof(uint32_t));
+        uint32_t value = 0;
+        for (size_t byte = 0; byte < sizeof(value); byte++) {
+            value |= static_cast<uint32_t>(static_cast<uint8_t>(data[offset++])) << (8 * byte);
+        }
+        return value;
+    }
+
+    std::string string() {
+        auto size = u32();
+        require(size);
+        auto result = data.substr(offset, size);
+        offset += size;
+        return result;
+    }
+};
+
+std::vector<Test> readBundle(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("unable to open " + path);
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.compare(0, sizeof(BundleFormat::MAGIC),
+                     std::string(std::begin(BundleFormat::MAGIC), std::end(BundleFormat::MAGIC)))) {
+        throw std::runtime_error(path + " is not a test bundle");
+    }
+    Reader reader(data);
+    for (size_t byte = 0; byte < sizeof(BundleFormat::MAGIC); byte++) {
+        reader.u8();
+    }
+    if (auto version = reader.u32(); version != BundleFormat::VERSION) {
+        throw std::runtime_error("unsupported bundle version " + std::to_string(version));
+    }
+
+    std::vector<Test> tests;
+    while (!reader.atEnd()) {
+        Test test;
+        test.id = reader.u32();
+        test.inputPort = reader.u32();
+        test.input = reader.string();
+        test.expectOutput = reader.u8() != 0;
+        if (test.expectOutput) {
+            test.outputPort = reader.u32();
+            test.output = reader.string();
+            test.mask = reader.string();
+        }
+        for (auto entries = reader.u32(); entries > 0; entries--) {
+            Entry entry;
+            entry.mapName = reader.string();
+            entry.priority = reader.u32();
+            entry.actionId = reader.u32();
+            entry.actionName = reader.string();
+            for (auto keys = reader.u32(); keys > 0; keys--) {
+                Key key;
+                key.index = reader.u32();
+                key.kind = static_cast<MatchKind>(reader.u8());
+                key.prefixLength = reader.u32();
+                key.value = reader.string();
+                key.mask = reader.string();
+                entry.keys.push_back(std::move(key));
+            }
+            for (auto args = reader.u32(); args > 0; args--) {
+                auto name = reader.string();
+                entry.args.emplace_back(std::move(name), reader.string());
+            }
+            test.entries.push_back(std::move(entry));
+        }
+        tests.push_back(std::move(test));
+    }
+    return tests;
+}
+
+/// A member of a structure in BTF, at a byte offset from the start of the outermost structure.
+struct Member {
+    uint32_t typeId;
+    size_t offset;
+    size_t size;
+    bool isInteger;
+};
+
+/// @returns the member @param name of the structure or union @param typeId, or std::nullopt.
+std::optional<Member> findMember(const struct btf *btf, uint32_t typeId, const std::string &name,
+                                 size_t baseOffset = 0) {
+    const auto *type = btf__type_by_id(btf, btf__resolve_type(btf, typeId));
+    if (type == nullptr || !btf_is_composite(type)) {
+        return std::nullopt;
+    }
+    const auto *members = btf_members(type);
+    for (int index = 0; index < btf_vlen(type); index++) {
+        if (name != btf__name_by_offset(btf, members[index].name_off)) {
+            continue;
+        }
+        auto memberTypeId = btf__resolve_type(btf, members[index].type);
+        const auto *memberType = btf__type_by_id(btf, memberTypeId);
+        auto size = btf__resolve_size(btf, memberTypeId);
+        if (memberType == nullptr || size < 0) {
+            return std::nullopt;
+        }
+        return Member{static_cast<uint32_t>(memberTypeId),
+                      baseOffset + btf_member_bit_offset(type, index) / 8,
+                      static_cast<size_t>(size), btf_is_int(memberType) || btf_is_enum(memberType)};
+    }
+    return std::nullopt;
+}
+
+/// Copies the last bytes of the big-endian @param value into @param target, which has @param size
+/// bytes, in the byte order of the host if @param hostOrder is true.
+void writeValue(uint8_t *target, size_t size, const std::string &value, bool hostOrder) {
+    std::string bytes(size, '\0');
+    auto copied = std::min(size, value.size());
+    value.copy(bytes.data() + size - copied, copied, value.size() - copied);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (hostOrder) {
+        std::reverse(bytes.begin(), bytes.end());
+    }
+#endif
+    std::memcpy(target, bytes.data(), size);
+}
+
+/// Writes @param value to the member @param member of the structure @param data. Integers are in
+/// host order, unless @param bigEndian is set, and byte arrays are in network order.
+void writeMember(std::vector<uint8_t> &data, const Member &member, const std::string &value,
+                 bool bigEndian = false) {
+    if (member.offset + member.size > data.size()) {
+        throw std::runtime_error("member out of bounds");
+    }
+    writeValue(data.data() + member.offset, member.size, value, member.isInteger && !bigEndian);
+}
+
+std::string toBigEndian(uint32_t value) {
+    return {static_cast<char>(value >> 24), static_cast<char>(value >> 16),
+            static_cast<char>(value >> 8), static_cast<char>(value)};
+}
+
+/// The table entries of a test for one map, which are written and deleted in batches.
+struct MapBatch {
+    int fd = -1;
+    size_t keySize = 0;
+    size_t valueSize = 0;
+    std::vector<uint8_t> keys;
+    std::vector<uint8_t> values;
+    uint32_t count = 0;
+};
+
+class Runner {
+    struct bpf_object *object = nullptr;
+    int programFd = -1;
+    bool isXdp = false;
+    bool verbose = false;
+
+    /// Adds @param entry to the batch of its map.
+    void encodeEntry(const Entry &entry, std::map<std::string, MapBatch> &batches) const {
+        auto *map = bpf_object__find_map_by_name(object, entry.mapName.c_str());
+        if (map == nullptr) {
+            throw std::runtime_error("no map " + entry.mapName);
+        }
+        const auto *btf = bpf_object__btf(object);
+        auto keyType = bpf_map__btf_key_type_id(map);
+        auto valueType = bpf_map__btf_value_type_id(map);
+        if (btf == nullptr || keyType == 0 || valueType == 0) {
+            throw std::runtime_error("no BTF for map " + entry.mapName);
+        }
+
+        std::vector<uint8_t> key(bpf_map__key_size(map));
+        auto prefix = findMember(btf, keyType, BundleFormat::PREFIX_FIELD_NAME);
+        for (const auto &element : entry.keys) {
+            if (element.kind == MatchKind::Ternary) {
+                throw std::runtime_error("ternary tables are not supported");
+            }
+            auto fieldName = "field" + std::to_string(element.index);
+            auto field = findMember(btf, keyType, fieldName);
+            if (!field) {
+                throw std::runtime_error("no key member " + fieldName + " in " + entry.mapName);
+            }
+            bool isLpm = element.kind == MatchKind::Lpm;
+            writeMember(key, *field, element.value, isLpm);
+            if (isLpm && prefix) {
+                auto start = prefix->offset + prefix->size;
+                auto prefixLength = (field->offset - start) * 8 + element.prefixLength;
+                writeMember(key, *prefix, toBigEndian(prefixLength));
+            }
+        }
+
+        std::vector<uint8_t> value(bpf_map__value_size(map));
+        if (auto action = findMember(btf, valueType, "action")) {
+            writeMember(value, *action, toBigEndian(entry.actionId));
+        }
+        auto actions = findMember(btf, valueType, "u");
+        auto arguments = actions ? findMember(btf, actions->typeId, entry.actionName,
+                                              actions->offset)
+                                 : std::nullopt;
+        for (const auto &[name, argument] : entry.args) {
+            auto param = arguments ? findMember(btf, arguments->typeId, name, arguments->offset)
+                                   : std::nullopt;
+            if (!param) {
+                throw std::runtime_error("no parameter " + name + " of " + entry.actionName);
+            }
+            writeMember(value, *param, argument);
+        }
+
+        auto &batch = batches[entry.mapName];
+        batch.fd = bpf_map__fd(map);
+        batch.keySize = key.size();
+        batch.valueSize = value.size();
+        batch.keys.insert(batch.keys.end(), key.begin(), key.end());
+        batch.values.insert(batch.values.end(), value.begin(), value.end());
+        batch.count++;
+    }
+
+    /// Writes the entries of @param batch, one at a time if the map does not support batches.
+    static void update(MapBatch &batch) {
+        bpf_map_batch_opts options{};
+        options.sz = sizeof(options);
+        options.elem_flags = BPF_ANY;
+        auto count = batch.count;
+        if (bpf_map_update_batch(batch.fd, batch.keys.data(), batch.values.data(), &count,
+                                 &options) == 0) {
+            return;
+        }
+        for (uint32_t index = 0; index < batch.count; index++) {
+            if (bpf_map_update_elem(batch.fd, batch.keys.data() + index * batch.keySize,
+                                    batch.values.data() + index * batch.valueSize, BPF_ANY) != 0) {
+                throw std::runtime_error(std::string("map update failed: ") + strerror(errno));
+            }
+        }
+    }
+
+    /// Deletes the entries of @param batch again.
+    static void remove(MapBatch &batch) {
+        bpf_map_batch_opts options{};
+        options.sz = sizeof(options);
+        auto count = batch.count;
+        if (bpf_map_delete_batch(batch.fd, batch.keys.data(), &count, &options) == 0) {
+            return;
+        }
+        for (uint32_t index = 0; index < batch.count; index++) {
+            bpf_map_delete_elem(batch.fd, batch.keys.data() + index * batch.keySize);
+        }
+    }
+
+    /// @returns true if the program passed the packet on, given its return value.
+    [[nodiscard]] bool accepts(uint32_t result) const {
+        if (isXdp) {
+            return result != XDP_DROP && result != XDP_ABORTED;
+        }
+        return result != TC_ACT_SHOT;
+    }
+
+ public:
+    explicit Runner(bool verbose) : verbose(verbose) {}
+
+    ~Runner() { bpf_object__close(object); }
+
+    Runner(const Runner &) = delete;
+    Runner &operator=(const Runner &) = delete;
+
+    void load(const std::string &path, const std::optional<std::string> &section) {
+        object = bpf_object__open_file(path.c_str(), nullptr);
+        if (libbpf_get_error(object) != 0) {
+            object = nullptr;
+            throw std::runtime_error("unable to open " + path);
+        }
+        // Maps are pinned by name for the kernel target; tests must not share or leave them.
+        struct bpf_map *map = nullptr;
+        bpf_object__for_each_map(map, object) { bpf_map__set_pin_path(map, nullptr); }
+
+        struct bpf_program *selected = nullptr;
+        struct bpf_program *program = nullptr;
+        bpf_object__for_each_program(program, object) {
+            // The kernel target puts TC programs into a section named "prog", which libbpf does
+            // not know the type of.
+            if (bpf_program__type(program) == BPF_PROG_TYPE_UNSPEC) {
+                bpf_program__set_type(program, BPF_PROG_TYPE_SCHED_CLS);
+            }
+            if (selected == nullptr &&
+                (!section || *section == bpf_program__section_name(program))) {
+                selected = program;
+            }
+        }
+        if (selected == nullptr) {
+            throw std::runtime_error("no program to run in " + path);
+        }
+        if (bpf_object__load(object) != 0) {
+            throw std::runtime_error("unable to load " + path + ": " + strerror(errno));
+        }
+        programFd = bpf_program__fd(selected);
+        isXdp = bpf_program__type(selected) == BPF_PROG_TYPE_XDP;
+    }
+
+    /// Runs @param test. @returns std::nullopt if it passed, and the reason otherwise.
+    std::optional<std::string> run(const Test &test) {
+        std::map<std::string, MapBatch> batches;
+        for (const auto &entry : test.entries) {
+            encodeEntry(entry, batches);
+        }
+        for (auto &[name, batch] : batches) {
+            update(batch);
+        }
+
+        std::vector<uint8_t> output(MAX_PACKET_SIZE);
+        bpf_test_run_opts options{};
+        options.sz = sizeof(options);
+        options.data_in = test.input.data();
+        options.data_size_in = static_cast<uint32_t>(test.input.size());
+        options.data_out = output.data();
+        options.data_size_out = static_cast<uint32_t>(output.size());
+        options.repeat = 1;
+        auto error = bpf_prog_test_run_opts(programFd, &options);
+        for (auto &[name, batch] : batches) {
+            remove(batch);
+        }
+        if (error != 0) {
+            return std::string("BPF_PROG_TEST_RUN failed: ") + strerror(errno);
+        }
+
+        bool accepted = accepts(options.retval);
+        if (accepted != test.expectOutput) {
+            return test.expectOutput ? "packet dropped" : "packet not dropped";
+        }
+        if (!accepted) {
+            return std::nullopt;
+        }
+        if (options.data_size_out != test.output.size()) {
+            return "output of " + std::to_string(options.data_size_out) + " bytes, expected " +
+                   std::to_string(test.output.size());
+        }
+        for (size_t byte = 0; byte < test.output.size(); byte++) {
+            auto mask = static_cast<uint8_t>(test.mask[byte]);
+            if (((output[byte] ^ static_cast<uint8_t>(test.output[byte])) & mask) != 0) {
+                return "output differs at byte " + std::to_string(byte);
+            }
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] bool isVerbose() const { return verbose; }
+};
+
+int usage() {
+    std::cerr << "usage: p4testgen-ebpf-runner [-v] [--section <name>] <program.o> "
+                 "<tests.bundle>\n";
+    return 2;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    bool verbose = false;
+    std::optional<std::string> section;
+    std::vector<std::string> positional;
+    for (int index = 1; index < argc; index++) {
+        std::string arg = argv[index];
+        if (arg == "-v") {
+            verbose = true;
+        } else if (arg == "--section" && index + 1 < argc) {
+            section = argv[++index];
+        } else if (!arg.empty() && arg[0] == '-') {
+            return usage();
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() != 2) {
+        return usage();
+    }
+
+    try {
+        auto tests = readBundle(positional[1]);
+        Runner runner(verbose);
+        runner.load(positional[0], section);
+
+        size_t passed = 0;
+        size_t failed = 0;
+        size_t skipped = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto &test : tests) {
+            if (test.input.size() < MIN_PACKET_SIZE) {
+                skipped++;
+                if (runner.isVerbose()) {
+                    std::cout << "test " << test.id << ": SKIPPED (packet too short)\n";
+                }
+                continue;
+            }
+            std::optional<std::string> failure;
+            try {
+                failure = runner.run(test);
+            } catch (const std::runtime_error &error) {
+                skipped++;
+                std::cout << "test " << test.id << ": SKIPPED (" << error.what() << ")\n";
+                continue;
+            }
+            if (failure) {
+                failed++;
+                std::cout << "test " << test.id << ": FAILED (" << *failure << ")\n";
+            } else {
+                passed++;
+                if (runner.isVerbose()) {
+                    std::cout << "test " << test.id << ": PASSED\n";
+                }
+            }
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+        std::cout << passed << " passed, " << failed << " failed, " << skipped << " skipped in "
+                  << elapsed.count() << " ms\n";
+        return failed == 0 ? 0 : 1;
+    } catch (const std::runtime_error &error) {
+        std::cerr << "p4testgen-ebpf-runner: " << error.what() << "\n";
+        return 2;
+    }
+}
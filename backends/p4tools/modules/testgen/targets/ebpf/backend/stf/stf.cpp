@@ -32,7 +32,8 @@
 namespace P4Tools::P4Testgen::EBPF {
 
 STF::STF(const TestBackendConfiguration &testBackendConfiguration)
-    : TestFramework(testBackendConfiguration) {}
+    : TestFramework(testBackendConfiguration),
+      testCaseTemplate(parseTemplate(getTestCaseTemplate())) {}
 
 inja::json STF::getControlPlane(const TestSpec *testSpec) {
     inja::json controlPlaneJson = inja::json::object();
@@ -223,7 +224,7 @@ expect {{verify.eg_port}} {{verify.exp_pkt}}
 }
 
 void STF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                       const std::string &testCase, float currentCoverage) {
+                       const inja::Template &testCase, float currentCoverage) {
     inja::json dataJson;
     if (selectedBranches != nullptr) {
         dataJson["selected_branches"] = selectedBranches.c_str();
@@ -250,14 +251,13 @@ void STF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_
     incrementedbasePath.concat("_" + std::to_string(testId));
     incrementedbasePath.replace_extension(".stf");
     auto stfFileStream = std::ofstream(incrementedbasePath);
-    inja::render_to(stfFileStream, testCase, dataJson);
+    renderTemplate(stfFileStream, testCase, dataJson);
     stfFileStream.flush();
 }
 
 void STF::writeTestToFile(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
                           float currentCoverage) {
-    std::string testCase = getTestCaseTemplate();
-    emitTestcase(testSpec, selectedBranches, testId, testCase, currentCoverage);
+    emitTestcase(testSpec, selectedBranches, testId, testCaseTemplate, currentCoverage);
 }
 
 }  // namespace P4Tools::P4Testgen::EBPF
@@ -23,13 +23,14 @@
 #include "backends/p4tools/modules/testgen/lib/test_object.h"
 #include "backends/p4tools/modules/testgen/lib/test_spec.h"
 #include "backends/p4tools/modules/testgen/options.h"
+#include "backends/p4tools/modules/testgen/targets/ebpf/backend/bundle/bundle.h"
 #include "backends/p4tools/modules/testgen/targets/ebpf/backend/stf/stf.h"
 
 namespace P4Tools::P4Testgen::EBPF {
 
 const big_int EBPFTestBackend::ZERO_PKT_VAL = 0x2000000;
 const big_int EBPFTestBackend::ZERO_PKT_MAX = 0xffffffff;
-const std::vector<std::string> EBPFTestBackend::SUPPORTED_BACKENDS = {"STF"};
+const std::vector<std::string> EBPFTestBackend::SUPPORTED_BACKENDS = {"STF", "BUNDLE"};
 
 EBPFTestBackend::EBPFTestBackend(const ProgramInfo &programInfo,
                                  const TestBackendConfiguration &testBackendConfiguration,
@@ -46,6 +47,8 @@ EBPFTestBackend::EBPFTestBackend(const ProgramInfo &programInfo,
 
     if (testBackendString == "STF") {
         testWriter = new STF(testBackendConfiguration);
+    } else if (testBackendString == "BUNDLE") {
+        testWriter = new Bundle(testBackendConfiguration);
     } else {
         P4C_UNIMPLEMENTED(
             "Test back end %1% not implemented for this target. Supported back ends are %2%.",
@@ -48,7 +48,7 @@ class Metadata : public TestFramework {
     /// @param currentCoverage contains statistics  about the current coverage of this test and its
     /// preceding tests.
     void emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                      const std::string &testCase, float currentCoverage);
+                      const inja::Template &testCase, float currentCoverage);
 
     /// Gets the traces from @param testSpec and populates @param dataJson.
     /// Also retrieves the label and offset for each successful extract call and stores them in a
@@ -58,6 +58,9 @@ class Metadata : public TestFramework {
     /// @returns the inja test case template as a string.
     static std::string getTestCaseTemplate();
 
+    /// The parsed test case template.
+    inja::Template testCaseTemplate;
+
     /// Converts the input packet and port into Inja format.
     static inja::json getSend(const TestSpec *testSpec);
 
@@ -26,7 +26,8 @@
 namespace P4Tools::P4Testgen::Pna {
 
 PTF::PTF(const TestBackendConfiguration &testBackendConfiguration)
-    : TestFramework(testBackendConfiguration) {}
+    : TestFramework(testBackendConfiguration),
+      testCaseTemplate(parseTemplate(getTestCaseTemplate())) {}
 
 std::vector<std::pair<size_t, size_t>> PTF::getIgnoreMasks(const IR::Constant *mask) {
     std::vector<std::pair<size_t, size_t>> ignoreMasks;
@@ -380,7 +381,7 @@ class Test{{test_id}}(AbstractTest):
 }
 
 void PTF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                       const std::string &testCase, float currentCoverage) {
+                       const inja::Template &testCase, float currentCoverage) {
     inja::json dataJson;
     if (selectedBranches != nullptr) {
         dataJson["selected_branches"] = selectedBranches.c_str();
@@ -406,14 +407,13 @@ void PTF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_
         emitPreamble();
         preambleEmitted = true;
     }
-    inja::render_to(ptfFileStream, testCase, dataJson);
+    renderTemplate(ptfFileStream, testCase, dataJson);
     ptfFileStream.flush();
 }
 
 void PTF::writeTestToFile(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
                           float currentCoverage) {
-    std::string testCase = getTestCaseTemplate();
-    emitTestcase(testSpec, selectedBranches, testId, testCase, currentCoverage);
+    emitTestcase(testSpec, selectedBranches, testId, testCaseTemplate, currentCoverage);
 }
 
 }  // namespace P4Tools::P4Testgen::Pna
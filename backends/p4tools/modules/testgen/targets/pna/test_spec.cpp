@@ -1,5 +1,8 @@
 #include "backends/p4tools/modules/testgen/targets/pna/test_spec.h"
 
+#include <utility>
+#include <vector>
+
 #include "backends/p4tools/common/lib/model.h"
 #include "lib/exceptions.h"
 
@@ -14,7 +17,27 @@ namespace P4Tools::P4Testgen::Pna {
 PnaDpdkRegisterValue::PnaDpdkRegisterValue(const IR::Expression *initialValue)
     : initialValue(initialValue) {}
 
+namespace {
+
+/// @returns whether @p index is the constant @p constant.
+bool isConstantIndex(const IR::Expression *index, const IR::Constant *constant) {
+    const auto *indexConstant = index->to<IR::Constant>();
+    return indexConstant != nullptr && indexConstant->value == constant->value;
+}
+
+}  // namespace
+
 void PnaDpdkRegisterValue::addRegisterCondition(PnaDpdkRegisterCondition cond) {
+    if (const auto *constant = cond.index->to<IR::Constant>()) {
+        // Every read of this index now finds the new value first, drop the shadowed writes.
+        std::vector<PnaDpdkRegisterCondition> remaining;
+        for (const auto &registerCondition : registerConditions) {
+            if (!isConstantIndex(registerCondition.index, constant)) {
+                remaining.push_back(registerCondition);
+            }
+        }
+        registerConditions = std::move(remaining);
+    }
     registerConditions.push_back(cond);
 }
 
@@ -24,11 +47,27 @@ cstring PnaDpdkRegisterValue::getObjectName() const { return "PnaDpdkRegisterVal
 
 const IR::Expression *PnaDpdkRegisterValue::getCurrentValue(const IR::Expression *index) const {
     const IR::Expression *baseExpr = initialValue;
-    for (const auto &pnaDpdkregisterValue : registerConditions) {
-        const auto *storedIndex = pnaDpdkregisterValue.index;
-        const auto *storedVal = pnaDpdkregisterValue.value;
+    auto first = registerConditions.begin();
+    const auto *constant = index->to<IR::Constant>();
+    if (constant != nullptr) {
+        for (auto it = registerConditions.rbegin(); it != registerConditions.rend(); ++it) {
+            if (isConstantIndex(it->index, constant)) {
+                baseExpr = it->value;
+                if (baseExpr->type->is<IR::Type_InfInt>()) {
+                    baseExpr = new IR::Cast(initialValue->type, baseExpr);
+                }
+                first = it.base();
+                break;
+            }
+        }
+    }
+    for (auto it = first; it != registerConditions.end(); ++it) {
+        // Two different constants never match.
+        if (constant != nullptr && it->index->is<IR::Constant>()) {
+            continue;
+        }
         baseExpr =
-            new IR::Mux(baseExpr->type, new IR::Equ(storedIndex, index), storedVal, baseExpr);
+            new IR::Mux(baseExpr->type, new IR::Equ(it->index, index), it->value, baseExpr);
     }
     return baseExpr;
 }
@@ -68,14 +68,16 @@ class PnaDpdkRegisterValue : public TestObject {
 
     [[nodiscard]] cstring getObjectName() const override;
 
-    /// Each element is an API name paired with a match rule.
+    /// Records a write. A write to a constant index replaces the previous writes to the same
+    /// constant index, so that only the indices touched on a path are kept.
     void addRegisterCondition(PnaDpdkRegisterCondition cond);
 
     /// @returns the value with which this register has been initialized.
     [[nodiscard]] const IR::Expression *getInitialValue() const;
 
     /// @returns the current value of this register after writes have been performed according to a
-    /// provided index.
+    /// provided index. Reads of a constant index skip the writes to other constant indices, and
+    /// start from the last write to the same index instead of the initial value.
     const IR::Expression *getCurrentValue(const IR::Expression *index) const;
 
     /// @returns the evaluated register value. This means it must be a constant.
@@ -0,0 +1,75 @@
+#include "backends/p4tools/common/lib/conflict_check.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "backends/p4tools/common/lib/variables.h"
+#include "ir/ir.h"
+#include "ir/irutils.h"
+#include "ir/solver.h"
+
+namespace Test {
+
+namespace {
+
+using P4Tools::ConflictCheck;
+
+/// @returns whether the last constraint of @param constraints contradicts the others.
+bool lastContradicts(const std::vector<const Constraint *> &constraints) {
+    return ConflictCheck::contradicts(constraints, constraints.back());
+}
+
+TEST(ConflictCheckTest, DifferentValues) {
+    const auto *type = IR::getBitType(8);
+    const auto *x = P4Tools::ToolsVariables::getSymbolicVariable(type, "x");
+    const auto *y = P4Tools::ToolsVariables::getSymbolicVariable(type, "y");
+    const auto *isOne = new IR::Equ(x, IR::getConstant(type, 1));
+    ASSERT_TRUE(lastContradicts({isOne, new IR::Equ(x, IR::getConstant(type, 2))}));
+    ASSERT_TRUE(lastContradicts({isOne, new IR::Neq(IR::getConstant(type, 1), x)}));
+    ASSERT_TRUE(lastContradicts({isOne, new IR::LNot(isOne)}));
+    // Z3 compares bit vectors modulo their width.
+    ASSERT_FALSE(lastContradicts({isOne, new IR::Equ(x, IR::getConstant(type, 257))}));
+    ASSERT_FALSE(lastContradicts({isOne, new IR::Equ(y, IR::getConstant(type, 2))}));
+}
+
+TEST(ConflictCheckTest, Ranges) {
+    const auto *type = IR::getBitType(8);
+    const auto *x = P4Tools::ToolsVariables::getSymbolicVariable(type, "x");
+    const auto *belowThree = new IR::Lss(x, IR::getConstant(type, 3));
+    ASSERT_TRUE(lastContradicts({belowThree, new IR::Grt(x, IR::getConstant(type, 5))}));
+    ASSERT_TRUE(lastContradicts({belowThree, new IR::Leq(IR::getConstant(type, 3), x)}));
+    ASSERT_FALSE(lastContradicts({belowThree, new IR::Geq(x, IR::getConstant(type, 2))}));
+    // The range [0, 2] is covered by the excluded values.
+    ASSERT_TRUE(lastContradicts({belowThree, new IR::Neq(x, IR::getConstant(type, 0)),
+                                 new IR::Neq(x, IR::getConstant(type, 1)),
+                                 new IR::Neq(x, IR::getConstant(type, 2))}));
+}
+
+TEST(ConflictCheckTest, Conjunctions) {
+    const auto *type = IR::getBitType(8);
+    const auto *x = P4Tools::ToolsVariables::getSymbolicVariable(type, "x");
+    const auto *y = P4Tools::ToolsVariables::getSymbolicVariable(type, "y");
+    const auto *xIsOne = new IR::Equ(x, IR::getConstant(type, 1));
+    const auto *yIsOne = new IR::Equ(y, IR::getConstant(type, 1));
+    // !(x != 1 || y == 1) is x == 1 && y != 1.
+    const auto *negatedOr = new IR::LNot(new IR::LOr(new IR::Neq(x, IR::getConstant(type, 1)),
+                                                     yIsOne));
+    ASSERT_TRUE(lastContradicts({yIsOne, negatedOr}));
+    ASSERT_FALSE(lastContradicts({xIsOne, negatedOr}));
+    // A disjunction is not looked into.
+    const auto *disjunction = new IR::LOr(new IR::LNot(xIsOne), new IR::LNot(xIsOne));
+    ASSERT_FALSE(lastContradicts({xIsOne, disjunction}));
+    ASSERT_TRUE(lastContradicts({new IR::LAnd(xIsOne, new IR::LNot(xIsOne))}));
+}
+
+TEST(ConflictCheckTest, SignedComparisonsAreIgnored) {
+    const auto *type = IR::getBitType(8, true);
+    const auto *x = P4Tools::ToolsVariables::getSymbolicVariable(type, "x");
+    ASSERT_FALSE(lastContradicts({new IR::Equ(x, IR::getConstant(type, 1)),
+                                  new IR::Equ(x, IR::getConstant(type, 2))}));
+}
+
+}  // namespace
+
+}  // namespace Test
@@ -0,0 +1,75 @@
+#include "backends/p4tools/common/lib/model.h"
+
+#include <gtest/gtest.h>
+
+#include "backends/p4tools/common/lib/variables.h"
+#include "ir/ir.h"
+#include "ir/irutils.h"
+#include "ir/solver.h"
+
+namespace Test {
+
+namespace {
+
+using P4Tools::Model;
+using P4Tools::ToolsVariables::getSymbolicVariable;
+
+/// @returns the value of @param expr in @param model as a constant.
+big_int evaluateConstant(const Model &model, const IR::Expression *expr) {
+    return model.evaluate(expr, false)->checkedTo<IR::Constant>()->value;
+}
+
+/// @returns the value of @param expr in @param model as a boolean.
+bool evaluateBool(const Model &model, const IR::Expression *expr) {
+    return model.evaluate(expr, false)->checkedTo<IR::BoolLiteral>()->value;
+}
+
+TEST(ModelTest, EvaluatesBitVectorExpressions) {
+    const auto *bitType = IR::getBitType(8);
+    const auto *signedType = IR::getBitType(8, true);
+    const auto *x = getSymbolicVariable(bitType, "x");
+    const auto *y = getSymbolicVariable(bitType, "y");
+    SymbolicMapping symbolicMap;
+    symbolicMap[x] = IR::getConstant(bitType, 200);
+    symbolicMap[y] = IR::getConstant(bitType, 100);
+    Model model(symbolicMap);
+
+    // Arithmetic wraps around the width of the type.
+    ASSERT_EQ(evaluateConstant(model, new IR::Add(bitType, x, y)), 44);
+    ASSERT_EQ(evaluateConstant(model, new IR::Sub(bitType, y, x)), 156);
+    ASSERT_EQ(evaluateConstant(model, new IR::Cmpl(bitType, x)), 55);
+    ASSERT_EQ(evaluateConstant(model, new IR::Shl(bitType, x, IR::getConstant(bitType, 1))),
+              144);
+    // (8w200 ++ 8w100)[11:4] is 8w0x86.
+    const auto *concat = new IR::Concat(IR::getBitType(16), x, y);
+    ASSERT_EQ(evaluateConstant(model, new IR::Slice(concat, 11, 4)), 0x86);
+    // Casts to signed types produce negative values.
+    const auto *signedX = new IR::Cast(signedType, x);
+    ASSERT_EQ(evaluateConstant(model, signedX), -56);
+    ASSERT_TRUE(evaluateBool(model, new IR::Lss(signedX, IR::getConstant(signedType, 0))));
+    ASSERT_EQ(evaluateConstant(model, new IR::Mux(bitType, new IR::Equ(x, y), x, y)), 100);
+}
+
+TEST(ModelTest, EvaluatesOnlySelectedOperands) {
+    const auto *bitType = IR::getBitType(8);
+    const auto *x = getSymbolicVariable(bitType, "x");
+    // The model does not bind this variable.
+    const auto *unbound = getSymbolicVariable(bitType, "unbound");
+    SymbolicMapping symbolicMap;
+    symbolicMap[x] = IR::getConstant(bitType, 1);
+    Model model(symbolicMap);
+
+    const auto *isOne = new IR::Equ(x, IR::getConstant(bitType, 1));
+    ASSERT_EQ(evaluateConstant(model, new IR::Mux(bitType, isOne, x, unbound)), 1);
+    const auto *isZero = new IR::Equ(unbound, IR::getConstant(bitType, 0));
+    ASSERT_FALSE(evaluateBool(model, new IR::LAnd(new IR::LNot(isOne), isZero)));
+
+    Model::ExpressionMap resolvedExpressions;
+    const auto *sum = new IR::Add(bitType, x, x);
+    model.evaluate(sum, false, &resolvedExpressions);
+    ASSERT_EQ(resolvedExpressions.at(sum)->checkedTo<IR::Constant>()->value, 2);
+}
+
+}  // namespace
+
+}  // namespace Test
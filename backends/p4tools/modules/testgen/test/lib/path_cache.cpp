@@ -0,0 +1,50 @@
+#include "backends/p4tools/modules/testgen/lib/path_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "ir/ir.h"
+#include "midend/coverage.h"
+
+namespace Test {
+
+namespace {
+
+using P4Tools::P4Testgen::PathCache;
+
+TEST(PathCacheTest, RecordsSurviveWriteAndRead) {
+    auto cachePath = std::filesystem::temp_directory_path() / "p4testgen_path_cache_test.jsonl";
+    IR::P4Program program;
+    P4::Coverage::CoverageSet coverableNodes;
+    PathCache pathCache(program, coverableNodes);
+    pathCache.keep({2, "1,2", {}});
+    pathCache.keep({1, "", {42}});
+    pathCache.write(cachePath);
+
+    auto pathRecords = PathCache::read(cachePath);
+    ASSERT_TRUE(pathRecords.has_value());
+    ASSERT_EQ(pathRecords->size(), 2U);
+    // Records are written in the order of their test ids.
+    ASSERT_EQ(pathRecords->at(0).testId, 1);
+    ASSERT_EQ(pathRecords->at(0).branches, "");
+    ASSERT_EQ(pathRecords->at(0).nodeHashes, std::vector<uint64_t>{42});
+    ASSERT_EQ(pathRecords->at(1).testId, 2);
+    ASSERT_EQ(pathRecords->at(1).branches, "1,2");
+    // A path is unchanged only if the program still contains all the nodes it covered.
+    ASSERT_FALSE(pathCache.isUnchanged(pathRecords->at(0)));
+    ASSERT_TRUE(pathCache.isUnchanged(pathRecords->at(1)));
+    std::filesystem::remove(cachePath);
+}
+
+TEST(PathCacheTest, MissingFileHasNoRecords) {
+    auto cachePath = std::filesystem::temp_directory_path() / "p4testgen_path_cache_missing.jsonl";
+    std::filesystem::remove(cachePath);
+    ASSERT_FALSE(PathCache::read(cachePath).has_value());
+}
+
+}  // namespace
+
+}  // namespace Test
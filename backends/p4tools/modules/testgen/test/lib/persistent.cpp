@@ -0,0 +1,87 @@
+#include "backends/p4tools/common/lib/persistent.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace Test {
+
+namespace {
+
+using P4Tools::LayeredContainer;
+using P4Tools::PersistentArray;
+using P4Tools::PersistentVector;
+
+TEST(PersistentTest, VectorCopiesAreIndependent) {
+    PersistentVector<int, 4> original;
+    for (int i = 0; i < 10; i++) {
+        original.push_back(i);
+    }
+    auto copy = original;
+    copy.push_back(10);
+    original.push_back(-1);
+    original.push_back(-2);
+
+    std::vector<int> expected = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    auto copyExpected = expected;
+    copyExpected.push_back(10);
+    expected.push_back(-1);
+    expected.push_back(-2);
+    EXPECT_EQ(original.toVector(), expected);
+    EXPECT_EQ(copy.toVector(), copyExpected);
+    EXPECT_EQ(copy.size(), 11U);
+    EXPECT_EQ(original.back(), -2);
+}
+
+TEST(PersistentTest, ArrayCopiesAreIndependent) {
+    PersistentArray<int, 4> original;
+    for (int i = 0; i < 10; i++) {
+        original.set(i, i + 1);
+    }
+    auto copy = original;
+    copy.set(1, -1);
+    copy.set(20, 21);
+    original.set(9, -10);
+
+    EXPECT_EQ(original.get(1), 2);
+    EXPECT_EQ(copy.get(1), -1);
+    EXPECT_EQ(original.get(9), -10);
+    EXPECT_EQ(copy.get(9), 10);
+    EXPECT_EQ(original.get(20), 0);
+    EXPECT_EQ(copy.get(20), 21);
+    EXPECT_EQ(copy.get(16), 0);
+    EXPECT_EQ(original.capacity(), 12U);
+    EXPECT_EQ(copy.capacity(), 24U);
+}
+
+TEST(PersistentTest, LayeredMap) {
+    LayeredContainer<std::map<int, int>> original;
+    for (int i = 0; i < 200; i++) {
+        original.insert({i, i});
+    }
+    auto copy = original;
+    copy.insert({5, 50});
+    copy.insert({500, 500});
+    EXPECT_EQ(original.find(5)->second, 5);
+    EXPECT_EQ(copy.find(5)->second, 50);
+    EXPECT_EQ(original.find(500), nullptr);
+    EXPECT_EQ(copy.get().size(), 201U);
+    EXPECT_EQ(copy.get().at(5), 50);
+    EXPECT_EQ(original.get().size(), 200U);
+}
+
+TEST(PersistentTest, LayeredSet) {
+    LayeredContainer<std::set<int>> set;
+    for (int i = 0; i < 1000; i++) {
+        set.insert(i % 300);
+    }
+    EXPECT_NE(set.find(299), nullptr);
+    EXPECT_EQ(set.find(300), nullptr);
+    EXPECT_EQ(set.get().size(), 300U);
+}
+
+}  // namespace
+
+}  // namespace Test
@@ -0,0 +1,71 @@
+#include "backends/p4tools/modules/testgen/lib/test_batch_writer.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <inja/inja.hpp>
+
+namespace Test {
+
+namespace {
+
+using P4Tools::P4Testgen::TestBatchWriter;
+
+/// @returns the lines of the file at @param path.
+std::vector<std::string> readLines(const std::filesystem::path &path) {
+    std::ifstream file(path);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+TEST(TestBatchWriterTest, ManifestPointsToTests) {
+    auto basePath = std::filesystem::temp_directory_path() / "p4testgen_batch_writer_test";
+    {
+        inja::json header;
+        header["test_name"] = "batch";
+        header["preamble"] = "setup\n";
+        TestBatchWriter writer(basePath, header);
+        writer.write(1, 0.5, "first test\n");
+        writer.write(2, 1.0, "second \"test\"");
+        writer.flush();
+    }
+
+    auto testsPath = TestBatchWriter::getTestsPath(basePath);
+    auto lines = readLines(testsPath);
+    ASSERT_EQ(lines.size(), 3U);
+    auto header = inja::json::parse(lines[0]);
+    ASSERT_EQ(header["test_name"], "batch");
+    ASSERT_EQ(header["preamble"], "setup\n");
+
+    std::ifstream testsFile(testsPath, std::ios::binary);
+    std::string tests((std::istreambuf_iterator<char>(testsFile)),
+                      std::istreambuf_iterator<char>());
+    auto manifest = readLines(TestBatchWriter::getManifestPath(basePath));
+    ASSERT_EQ(manifest.size(), 2U);
+    std::vector<std::string> expectedTests = {"first test\n", "second \"test\""};
+    for (size_t idx = 0; idx < manifest.size(); ++idx) {
+        auto entry = inja::json::parse(manifest[idx]);
+        ASSERT_EQ(entry["test_id"], idx + 1);
+        // Each manifest entry locates the line of its test in the test file.
+        auto record = inja::json::parse(
+            tests.substr(entry["offset"].get<size_t>(), entry["length"].get<size_t>()));
+        ASSERT_EQ(record["test_id"], idx + 1);
+        ASSERT_EQ(record["test"], expectedTests[idx]);
+        ASSERT_EQ(record["coverage"], entry["coverage"]);
+    }
+    std::filesystem::remove(testsPath);
+    std::filesystem::remove(TestBatchWriter::getManifestPath(basePath));
+}
+
+}  // namespace
+
+}  // namespace Test
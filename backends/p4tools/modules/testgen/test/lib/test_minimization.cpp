@@ -0,0 +1,57 @@
+#include "backends/p4tools/modules/testgen/lib/test_minimization.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "ir/ir.h"
+#include "lib/source_file.h"
+#include "midend/coverage.h"
+
+namespace Test {
+
+namespace {
+
+using P4::Coverage::CoverageSet;
+using P4Tools::P4Testgen::selectCoveringTests;
+
+/// Creates @param count statements which are distinct coverable nodes.
+std::vector<const IR::Node *> makeNodes(unsigned count) {
+    auto *sources = new Util::InputSources();
+    sources->appendText(std::string(count, ';'));
+    std::vector<const IR::Node *> nodes;
+    for (unsigned offset = 0; offset < count; offset++) {
+        nodes.push_back(new IR::EmptyStatement(Util::SourceInfo(sources, offset, offset + 1)));
+    }
+    return nodes;
+}
+
+TEST(TestMinimizationTest, DropsRedundantTests) {
+    auto nodes = makeNodes(4);
+    std::vector<CoverageSet> testCoverage = {
+        {nodes[0]},
+        {nodes[0], nodes[1], nodes[2]},
+        {nodes[1]},
+        {nodes[3]},
+    };
+    ASSERT_EQ(selectCoveringTests(testCoverage, 1), (std::vector<size_t>{1, 3}));
+}
+
+TEST(TestMinimizationTest, KeepsRedundantTestsPerNode) {
+    auto nodes = makeNodes(3);
+    std::vector<CoverageSet> testCoverage = {
+        {nodes[0], nodes[1]},
+        {nodes[0]},
+        {nodes[0], nodes[1]},
+        {nodes[2]},
+        {},
+    };
+    // The last node is only covered by a single test, the test without nodes is always dropped.
+    ASSERT_EQ(selectCoveringTests(testCoverage, 2), (std::vector<size_t>{0, 2, 3}));
+    ASSERT_EQ(selectCoveringTests(testCoverage, 3), (std::vector<size_t>{0, 1, 2, 3}));
+}
+
+}  // namespace
+
+}  // namespace Test
@@ -3,6 +3,7 @@
 #include <optional>
 #include <vector>
 
+#include "backends/p4tools/common/core/portfolio_solver.h"
 #include "backends/p4tools/common/core/z3_solver.h"
 #include "backends/p4tools/common/lib/variables.h"
 #include "ir/ir-generated.h"
@@ -188,4 +189,103 @@ TEST_F(Z3SolverSatisfiabilityChecks, Bools) {
     }
 }
 
+TEST(Z3SolverQueryCache, IndependentSets) {
+    P4Tools::Z3Solver solver;
+    solver.enableQueryCache(true);
+    const auto *eightBitType = IR::getBitType(8);
+    const auto *fooVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "foo");
+    const auto *barVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "bar");
+    const auto *fooIsOne = new IR::Equ(fooVar, IR::getConstant(eightBitType, 1));
+    const auto *barIsTwo = new IR::Equ(barVar, IR::getConstant(eightBitType, 2));
+    const auto *barIsThree = new IR::Equ(barVar, IR::getConstant(eightBitType, 3));
+
+    EXPECT_EQ(solver.checkSat(ConstraintVector{fooIsOne, barIsTwo}), true);
+    const auto &statistics = solver.getQueryCacheStatistics();
+    EXPECT_EQ(statistics.constraintSets, 2U);
+    EXPECT_EQ(statistics.solverCalls, 2U);
+    // Both sets are cached, also when a constraint is repeated.
+    EXPECT_EQ(solver.checkSat(ConstraintVector{fooIsOne}), true);
+    EXPECT_EQ(solver.checkSat(ConstraintVector{barIsTwo, barIsTwo}), true);
+    EXPECT_EQ(statistics.cacheHits, 2U);
+    EXPECT_EQ(statistics.solverCalls, 2U);
+    EXPECT_EQ(solver.checkSat(ConstraintVector{fooIsOne, barIsTwo, barIsThree}), false);
+    EXPECT_EQ(statistics.cacheHits, 3U);
+    EXPECT_EQ(statistics.solverCalls, 3U);
+
+    // The model is computed on the whole query.
+    EXPECT_EQ(solver.checkSat(ConstraintVector{fooIsOne, barIsTwo}), true);
+    const auto &mapping = solver.getSymbolicMapping();
+    EXPECT_EQ(mapping.at(fooVar)->checkedTo<IR::Constant>()->asInt(), 1);
+    EXPECT_EQ(mapping.at(barVar)->checkedTo<IR::Constant>()->asInt(), 2);
+}
+
+TEST(Z3SolverTranslationCache, ModelAfterReassertion) {
+    for (bool isIncremental : {true, false}) {
+        P4Tools::Z3Solver solver(isIncremental);
+        const auto *eightBitType = IR::getBitType(8);
+        const auto *fooVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "foo");
+        const auto *barVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "bar");
+        const auto *fooIsOne = new IR::Equ(fooVar, IR::getConstant(eightBitType, 1));
+        const auto *barIsTwo = new IR::Equ(barVar, IR::getConstant(eightBitType, 2));
+
+        EXPECT_EQ(solver.checkSat(ConstraintVector{fooIsOne}), true);
+        EXPECT_EQ(solver.checkSat(ConstraintVector{barIsTwo}), true);
+        // The translation of fooIsOne is reused, although its declarations were popped.
+        EXPECT_EQ(solver.checkSat(ConstraintVector{fooIsOne}), true);
+        const auto &mapping = solver.getSymbolicMapping();
+        EXPECT_EQ(mapping.at(fooVar)->checkedTo<IR::Constant>()->asInt(), 1);
+    }
+}
+
+TEST(Z3SolverAssumptionLiterals, SwitchPaths) {
+    P4Tools::Z3Solver solver;
+    solver.enableAssumptionLiterals(true);
+    const auto *eightBitType = IR::getBitType(8);
+    const auto *fooVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "foo");
+    const auto *fooIsOne = new IR::Equ(fooVar, IR::getConstant(eightBitType, 1));
+    const auto *fooIsTwo = new IR::Equ(fooVar, IR::getConstant(eightBitType, 2));
+
+    EXPECT_EQ(solver.checkSat(ConstraintVector{fooIsOne}), true);
+    EXPECT_EQ(solver.checkSat(ConstraintVector{fooIsOne, fooIsTwo}), false);
+    EXPECT_EQ(solver.checkSat(ConstraintVector{fooIsTwo}), true);
+    // The guards of the constraints are not part of the model.
+    const auto &mapping = solver.getSymbolicMapping();
+    EXPECT_EQ(mapping.size(), 1U);
+    EXPECT_EQ(mapping.at(fooVar)->checkedTo<IR::Constant>()->asInt(), 2);
+}
+
+TEST(Z3SolverQueryStatistics, CountsChecks) {
+    P4Tools::Z3Solver solver;
+    solver.enableTimeoutEscalation(1000);
+    const auto *eightBitType = IR::getBitType(8);
+    const auto *fooVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "foo");
+    const auto *fooIsOne = new IR::Equ(fooVar, IR::getConstant(eightBitType, 1));
+    const auto *fooIsTwo = new IR::Equ(fooVar, IR::getConstant(eightBitType, 2));
+
+    EXPECT_EQ(solver.checkSat(ConstraintVector{fooIsOne}), true);
+    EXPECT_EQ(solver.checkSat(ConstraintVector{fooIsOne, fooIsTwo}), false);
+    const auto &statistics = solver.getQueryStatistics();
+    EXPECT_EQ(statistics.checks, 2U);
+    EXPECT_EQ(statistics.timeouts, 0U);
+    EXPECT_EQ(statistics.tacticAnswers, 0U);
+    uint64_t histogramChecks = 0;
+    for (auto checks : statistics.histogram) {
+        histogramChecks += checks;
+    }
+    EXPECT_EQ(histogramChecks, 2U);
+}
+
+TEST(Z3SolverPortfolio, AnswersOfEitherSolver) {
+    P4Tools::PortfolioSolver solver(1);
+    const auto *eightBitType = IR::getBitType(8);
+    const auto *fooVar = P4Tools::ToolsVariables::getSymbolicVariable(eightBitType, "foo");
+    const auto *fooIsOne = new IR::Equ(fooVar, IR::getConstant(eightBitType, 1));
+    const auto *fooIsTwo = new IR::Equ(fooVar, IR::getConstant(eightBitType, 2));
+
+    EXPECT_EQ(solver.checkSat(ConstraintVector{fooIsOne, fooIsTwo}), false);
+    EXPECT_EQ(solver.checkSat(ConstraintVector{fooIsTwo}), true);
+    const auto &mapping = solver.getSymbolicMapping();
+    EXPECT_EQ(mapping.at(fooVar)->checkedTo<IR::Constant>()->asInt(), 2);
+}
+
 }  // namespace Test
@@ -3,26 +3,35 @@
 #include <cstdlib>
 #include <exception>
 #include <filesystem>
+#include <fstream>
+#include <memory>
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "backends/p4tools/common/compiler/context.h"
+#include "backends/p4tools/common/core/portfolio_solver.h"
 #include "backends/p4tools/common/core/z3_solver.h"
+#include "backends/p4tools/common/lib/util.h"
 #include "frontends/common/parser_options.h"
 #include "ir/solver.h"
 #include "lib/cstring.h"
 #include "lib/error.h"
+#include "lib/null.h"
 
 #include "backends/p4tools/modules/testgen/core/compiler_target.h"
 #include "backends/p4tools/modules/testgen/core/program_info.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/depth_first.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/greedy_node_cov.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/parallel_dfs.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/path_partition.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/path_selection.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/random_backtrack.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/selected_branches.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
 #include "backends/p4tools/modules/testgen/core/target.h"
+#include "backends/p4tools/modules/testgen/lib/path_cache.h"
 #include "backends/p4tools/modules/testgen/lib/test_backend.h"
 #include "backends/p4tools/modules/testgen/lib/test_framework.h"
 #include "backends/p4tools/modules/testgen/options.h"
@@ -36,6 +45,13 @@ namespace {
 SymbolicExecutor *pickExecutionEngine(const TestgenOptions &testgenOptions,
                                       const ProgramInfo &programInfo, AbstractSolver &solver) {
     const auto &pathSelectionPolicy = testgenOptions.pathSelectionPolicy;
+    if (testgenOptions.parallelWorkers > 1 &&
+        (pathSelectionPolicy != PathSelectionPolicy::DepthFirst ||
+         !testgenOptions.selectedBranches.empty() || testgenOptions.branchPrefix.has_value())) {
+        ::warning(
+            "Only the depth-first path selection policy explores paths in parallel, ignoring "
+            "--parallel-workers.");
+    }
     if (pathSelectionPolicy == PathSelectionPolicy::GreedyStmtCoverage) {
         return new GreedyNodeSelection(solver, programInfo);
     }
@@ -46,9 +62,145 @@ SymbolicExecutor *pickExecutionEngine(const TestgenOptions &testgenOptions,
         std::string selectedBranchesStr = testgenOptions.selectedBranches;
         return new SelectedBranches(solver, programInfo, selectedBranchesStr);
     }
+    if (testgenOptions.branchPrefix.has_value()) {
+        return new SelectedBranches(solver, programInfo, testgenOptions.branchPrefix.value(), true);
+    }
+    if (testgenOptions.parallelWorkers > 1) {
+        return new ParallelDepthFirstSearch(solver, programInfo, testgenOptions.parallelWorkers);
+    }
     return new DepthFirstSearch(solver, programInfo);
 }
 
+/// Creates the solver selected by @param testgenOptions.
+std::unique_ptr<AbstractSolver> createSolver(const TestgenOptions &testgenOptions) {
+    auto configure = [&testgenOptions](Z3Solver &solver) {
+        solver.enableQueryCache(testgenOptions.solverQueryCache);
+        solver.enableAssumptionLiterals(testgenOptions.solverAssumptions);
+        if (testgenOptions.solverQueryTimeout > 0) {
+            solver.enableTimeoutEscalation(testgenOptions.solverQueryTimeout);
+        }
+    };
+    if (testgenOptions.solverPortfolioThreshold > 0) {
+        auto solver = std::make_unique<PortfolioSolver>(testgenOptions.solverPortfolioThreshold);
+        configure(solver->getSolver(0));
+        configure(solver->getSolver(1));
+        return solver;
+    }
+    auto solver = std::make_unique<Z3Solver>();
+    configure(*solver);
+    return solver;
+}
+
+/// Print the hit rate of the solver query cache to the performance report.
+void printQueryCacheReport(AbstractSolver &abstractSolver) {
+    auto *solver = abstractSolver.to<Z3Solver>();
+    if (auto *portfolioSolver = abstractSolver.to<PortfolioSolver>()) {
+        solver = &portfolioSolver->getSolver(0);
+    }
+    CHECK_NULL(solver);
+    const auto &statistics = solver->getQueryCacheStatistics();
+    if (statistics.constraintSets == 0) {
+        return;
+    }
+    auto hitRate = static_cast<double>(statistics.cacheHits + statistics.modelHits) /
+                   static_cast<double>(statistics.constraintSets);
+    printFeature("performance", 4, "============ Solver query cache ============");
+    printFeature("performance", 4,
+                 "%d queries, %d sets of constraints: %d cache hits, %d model hits, %d solver "
+                 "calls (%0.2f %% hit rate)",
+                 statistics.queries, statistics.constraintSets, statistics.cacheHits,
+                 statistics.modelHits, statistics.solverCalls, hitRate * 100);
+}
+
+/// Print the distribution of solver check times to the performance report.
+void printSolverReport(AbstractSolver &abstractSolver) {
+    auto *solver = abstractSolver.to<Z3Solver>();
+    if (auto *portfolioSolver = abstractSolver.to<PortfolioSolver>()) {
+        solver = &portfolioSolver->getSolver(0);
+    }
+    CHECK_NULL(solver);
+    const auto &statistics = solver->getQueryStatistics();
+    if (statistics.checks == 0) {
+        return;
+    }
+    const auto &bounds = Z3Solver::QueryStatistics::BUCKET_BOUNDS;
+    printFeature("performance", 4, "============ Solver checks ============");
+    printFeature("performance", 4, "%d checks in %0.2f ms: %d timeouts, %d answered by tactics",
+                 statistics.checks, statistics.milliseconds, statistics.timeouts,
+                 statistics.tacticAnswers);
+    for (size_t i = 0; i < statistics.histogram.size(); i++) {
+        if (i < bounds.size()) {
+            printFeature("performance", 4, "< %0.0f ms: %d checks", bounds[i],
+                         statistics.histogram[i]);
+        } else {
+            printFeature("performance", 4, ">= %0.0f ms: %d checks", bounds.back(),
+                         statistics.histogram[i]);
+        }
+    }
+}
+
+/// Write the branch prefixes of the partitions of the program to @param testPath.prefixes.
+int writePathPartition(const TestgenOptions &testgenOptions, const ProgramInfo &programInfo,
+                       std::filesystem::path testPath) {
+    testPath += ".prefixes";
+    std::ofstream output(testPath);
+    if (!output) {
+        ::error("Unable to open %1% for writing.", testPath.c_str());
+        return EXIT_FAILURE;
+    }
+    auto solver = createSolver(testgenOptions);
+    PathPartition partition(*solver, programInfo, testgenOptions.partitionPaths, output);
+    partition.run([](const FinalState & /*finalState*/) { return true; });
+    output.close();
+    if (!output) {
+        ::error("Unable to write the branch prefixes to %1%.", testPath.c_str());
+    }
+    return ::errorCount() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/// Generates the tests of @param pathRecords again whose paths cover changed nodes, in place
+/// of the earlier tests with the same ids. The records of the other paths are kept in
+/// @param pathCache. @returns std::nullopt if the test back end cannot replace single tests.
+std::optional<int> regenerateChangedTests(const ProgramInfo &programInfo,
+                                          const TestBackendConfiguration &testBackendConfiguration,
+                                          AbstractSolver &solver,
+                                          const std::vector<PathCache::PathRecord> &pathRecords,
+                                          PathCache &pathCache) {
+    SelectedBranches symbolicExecutor(solver, programInfo, "");
+    auto *testBackend =
+        TestgenTarget::getTestBackend(programInfo, testBackendConfiguration, symbolicExecutor);
+    if (!testBackend->writesTestsToSeparateFiles()) {
+        ::warning(
+            "The test back end does not write each test into its own file, generating all tests "
+            "again.");
+        return std::nullopt;
+    }
+    testBackend->setPathCache(&pathCache);
+    size_t regenerated = 0;
+    for (const auto &pathRecord : pathRecords) {
+        if (pathCache.isUnchanged(pathRecord)) {
+            pathCache.keep(pathRecord);
+            continue;
+        }
+        regenerated++;
+        testBackend->setTestCount(pathRecord.testId - 1);
+        symbolicExecutor.selectBranches(pathRecord.branches);
+        symbolicExecutor.run([testBackend](auto &&finalState) {
+            return testBackend->run(std::forward<decltype(finalState)>(finalState));
+        });
+        if (testBackend->getTestCount() != pathRecord.testId) {
+            ::warning("The path of test %1% no longer produces a test. The test is stale.",
+                      pathRecord.testId);
+        }
+    }
+    testBackend->finish();
+    printQueryCacheReport(solver);
+    printSolverReport(solver);
+    printFeature("test_info", 4, "Generated %1% of %2% tests again.", regenerated,
+                 pathRecords.size());
+    return ::errorCount() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 /// Analyse the results of the symbolic execution and generate diagnostic messages.
 int postProcess(const TestgenOptions &testgenOptions, const TestBackEnd &testBackend) {
     // Do not print this warning if assertion mode is enabled.
@@ -79,8 +231,8 @@ std::optional<AbstractTestList> generateAndCollectAbstractTests(
                                                       testgenOptions.maxTests, std::nullopt,
                                                       testgenOptions.seed};
     // Need to declare the solver here to ensure its lifetime.
-    Z3Solver solver;
-    auto *symbolicExecutor = pickExecutionEngine(testgenOptions, programInfo, solver);
+    auto solver = createSolver(testgenOptions);
+    auto *symbolicExecutor = pickExecutionEngine(testgenOptions, programInfo, *solver);
 
     // Each test back end has a different run function.
     auto *testBackend =
@@ -91,6 +243,9 @@ std::optional<AbstractTestList> generateAndCollectAbstractTests(
     symbolicExecutor->run([testBackend](auto &&finalState) {
         return testBackend->run(std::forward<decltype(finalState)>(finalState));
     });
+    testBackend->finish();
+    printQueryCacheReport(*solver);
+    printSolverReport(*solver);
     auto result = postProcess(testgenOptions, *testBackend);
     if (result != EXIT_SUCCESS) {
         return std::nullopt;
@@ -122,23 +277,56 @@ int generateAndWriteAbstractTests(const TestgenOptions &testgenOptions,
         testPath = testDir / testPath;
     }
 
+    if (testgenOptions.partitionPaths > 0) {
+        return writePathPartition(testgenOptions, programInfo, testPath);
+    }
+
     // The test name is the stem of the output base path.
     TestBackendConfiguration testBackendConfiguration{testPath.c_str(), testgenOptions.maxTests,
-                                                      testPath, testgenOptions.seed};
+                                                      testPath, testgenOptions.seed,
+                                                      testgenOptions.batchOutput};
 
     // Need to declare the solver here to ensure its lifetime.
-    Z3Solver solver;
-    auto *symbolicExecutor = pickExecutionEngine(testgenOptions, programInfo, solver);
+    auto solver = createSolver(testgenOptions);
+
+    std::optional<PathCache> pathCache;
+    if (testgenOptions.pathCache.has_value()) {
+        const auto &pathCachePath = testgenOptions.pathCache.value();
+        pathCache.emplace(programInfo.getP4Program(), programInfo.getCoverableNodes());
+        auto pathRecords = PathCache::read(pathCachePath);
+        if (::errorCount() > 0) {
+            return EXIT_FAILURE;
+        }
+        if (pathRecords.has_value()) {
+            auto result = regenerateChangedTests(programInfo, testBackendConfiguration, *solver,
+                                                 pathRecords.value(), pathCache.value());
+            if (result.has_value()) {
+                pathCache->write(pathCachePath);
+                return ::errorCount() == 0 ? result.value() : EXIT_FAILURE;
+            }
+        }
+    }
+
+    auto *symbolicExecutor = pickExecutionEngine(testgenOptions, programInfo, *solver);
 
     // Each test back end has a different run function.
     auto *testBackend =
         TestgenTarget::getTestBackend(programInfo, testBackendConfiguration, *symbolicExecutor);
+    if (pathCache.has_value()) {
+        testBackend->setPathCache(&pathCache.value());
+    }
 
     // Define how to handle the final state for each test. This is target defined.
     // We delegate execution to the symbolic executor.
     symbolicExecutor->run([testBackend](auto &&finalState) {
         return testBackend->run(std::forward<decltype(finalState)>(finalState));
     });
+    testBackend->finish();
+    printQueryCacheReport(*solver);
+    printSolverReport(*solver);
+    if (pathCache.has_value()) {
+        pathCache->write(testgenOptions.pathCache.value());
+    }
     return postProcess(testgenOptions, *testBackend);
 }
 
@@ -61,6 +61,7 @@ bool Backend::ebpfCodeGen(P4::ReferenceMap *refMapEBPF, P4::TypeMap *typeMapEBPF
     ebpfOption.xdp2tcMode = options.xdp2tcMode;
     ebpfOption.exe_name = options.exe_name;
     ebpfOption.file = options.file;
+    ebpfOption.emitCoverage = options.emitCoverage;
     PnaProgramStructure structure(refMapEBPF, typeMapEBPF);
     auto parsePnaArch = new ParsePnaArchitecture(&structure);
     auto main = toplevel->getMain();
@@ -159,12 +160,34 @@ void Backend::serialize() const {
     ebpf_program->emit(&c);
     ebpf_program->emitParser(&p);
     ebpf_program->emitHeader(&h);
-    *cstream << c.toString();
-    *pstream << p.toString();
-    *hstream << h.toString();
+    c.writeTo(*cstream);
+    p.writeTo(*pstream);
+    h.writeTo(*hstream);
     cstream->flush();
     pstream->flush();
     hstream->flush();
+
+    if (options.emitXdpFilter) {
+        cstring filterFile = progName + "_xdp_filter.c";
+        if (!options.outputFolder.isNullOrEmpty()) filterFile = options.outputFolder + filterFile;
+        auto fstream = openFile(filterFile, false);
+        if (fstream == nullptr) {
+            ::error("Unable to open File %1%", filterFile);
+            return;
+        }
+        EBPF::CodeBuilder f(new EBPF::XdpTarget(options.emitTraceMessages));
+        ebpf_program->emitXdpFilter(&f);
+        f.writeTo(*fstream);
+        fstream->flush();
+    }
+
+    if (auto coverage = ebpf_program->pipeline->coverage) {
+        cstring coverageFile = progName + ".coverage.json";
+        if (!options.outputFolder.isNullOrEmpty())
+            coverageFile = options.outputFolder + coverageFile;
+        if (!coverage->writeSourceMap(coverageFile))
+            ::error("Unable to open File %1%", coverageFile);
+    }
 }
 
 bool Backend::serializeIntrospectionJson(std::ostream &out) const {
@@ -165,6 +165,8 @@ void PNAEbpfGenerator::emitPipelineInstances(EBPF::CodeBuilder *builder) const {
 
     builder->target->emitTableDecl(builder, "hdr_md_cpumap", EBPF::TablePerCPUArray, "u32",
                                    "struct hdr_md", 2);
+    if (options.enableTableCache) EBPF::EBPFTablePSA::emitCacheGenerationInstance(builder);
+    if (pipeline->coverage != nullptr) pipeline->coverage->emitInstance(builder);
 }
 
 // =====================PNAArchTC=============================
@@ -236,6 +238,28 @@ void PNAArchTC::emitParser(EBPF::CodeBuilder *builder) const {
     builder->target->emitLicense(builder, pipeline->license);
 }
 
+void PNAArchTC::emitXdpFilter(EBPF::CodeBuilder *builder) const {
+    /**
+     * Structure of a C XDP filter program for PNA
+     * 1. Automatically generated comment
+     * 2. Includes
+     * 3. XDP program for parser.
+     * The parser runs with the pipeline name of the tc parser, the XDP section name selects
+     * the XDP return codes. Nothing is passed to tc: the per-CPU map holding the headers
+     * does not survive GRO or RPS until tc ingress, so the tc parser parses the packets again.
+     */
+    xdp->emitGeneratedComment(builder);
+    cstring headerFile = getProgramName() + "_parser.h";
+    builder->appendFormat("#include \"%s\"", headerFile);
+    builder->newline();
+    builder->newline();
+    pipeline->name = "tc-parse";
+    pipeline->sectionName = "xdp/p4tc-filter";
+    pipeline->functionName = "xdp_filter_func";
+    pipeline->emit(builder);
+    builder->target->emitLicense(builder, pipeline->license);
+}
+
 void PNAArchTC::emitHeader(EBPF::CodeBuilder *builder) const {
     xdp->emitGeneratedComment(builder);
     builder->target->emitIncludes(builder);
@@ -405,10 +429,21 @@ void TCIngressPipelinePNA::emit(EBPF::CodeBuilder *builder) {
 
         builder->blockStart();
 
+        // An XDP program has no skb->cb; the metadata written by the parser is dropped.
+        bool xdpFilter = sectionName.startsWith("xdp");
         builder->emitIndent();
-        builder->appendFormat(
-            "struct pna_global_metadata *%s = (struct pna_global_metadata *) skb->cb;",
-            compilerGlobalMetadata);
+        if (xdpFilter) {
+            builder->appendFormat("struct pna_global_metadata xdp_%s = {};",
+                                  compilerGlobalMetadata);
+            builder->newline();
+            builder->emitIndent();
+            builder->appendFormat("struct pna_global_metadata *%s = &xdp_%s;",
+                                  compilerGlobalMetadata, compilerGlobalMetadata);
+        } else {
+            builder->appendFormat(
+                "struct pna_global_metadata *%s = (struct pna_global_metadata *) skb->cb;",
+                compilerGlobalMetadata);
+        }
         builder->newline();
 
         emitHeaderInstances(builder);
@@ -434,7 +469,8 @@ void TCIngressPipelinePNA::emit(EBPF::CodeBuilder *builder) {
             actUnspecCode);
         builder->newline();
         builder->emitIndent();
-        builder->appendFormat("return TC_ACT_PIPE;");
+        builder->appendFormat("return %s;",
+                              xdpFilter ? forwardReturnCode() : cstring("TC_ACT_PIPE"));
         builder->newline();
         builder->emitIndent();
         builder->blockEnd(true);
@@ -539,8 +575,8 @@ void TCIngressPipelinePNA::emitLocalVariables(EBPF::CodeBuilder *builder) {
     builder->newline();
 
     builder->emitIndent();
-    builder->appendFormat("u32 %s = ", lengthVar.c_str());
-    emitPacketLength(builder);
+    builder->appendFormat("u32 %s = %s", lengthVar.c_str(),
+                          builder->target->dataLength(model.CPacketName.str()));
     builder->endOfStatement(true);
 
     if (shouldEmitTimestamp()) {
@@ -572,7 +608,7 @@ void EBPFPnaParser::emitRejectState(EBPF::CodeBuilder *builder) {
     builder->target->emitTraceMessage(
         builder, "Parser: Explicit transition to reject state, dropping packet..");
     builder->emitIndent();
-    builder->appendFormat("return %s", builder->target->abortReturnCode().c_str());
+    builder->appendFormat("return %s", builder->target->dropReturnCode().c_str());
     builder->endOfStatement(true);
     builder->blockEnd(true);
     builder->emitIndent();
@@ -949,6 +985,7 @@ void EBPFTablePNA::emitAction(EBPF::CodeBuilder *builder, cstring valueName,
 
         msgStr = Util::printf_format("Control: executing action %s", name);
         builder->target->emitTraceMessage(builder, msgStr.c_str());
+        if (program->coverage != nullptr) program->coverage->emitIncrement(builder, action);
         for (auto param : *(action->parameters)) {
             auto etype = EBPF::EBPFTypeFactory::instance->create(param->type);
             unsigned width = etype->as<EBPF::IHasWidth>().widthInBits();
@@ -1197,6 +1234,8 @@ const PNAEbpfGenerator *ConvertToEbpfPNA::build(const IR::ToplevelBlock *tlb) {
 const IR::Node *ConvertToEbpfPNA::preorder(IR::ToplevelBlock *tlb) {
     ebpf_program = build(tlb);
     ebpf_program->pipeline->program = tlb->getProgram();
+    if (options.emitCoverage)
+        ebpf_program->pipeline->coverage = new EBPF::CoverageCounters(tlb->getProgram());
     return tlb;
 }
 
@@ -1513,6 +1552,8 @@ void ControlBodyTranslatorPNA::processApply(const P4::ApplyMethod *method) {
 
     msgStr = Util::printf_format("Control: applying %s", method->object->getName().name);
     builder->target->emitTraceMessage(builder, msgStr.c_str());
+    if (auto coverage = control->program->coverage)
+        coverage->emitIncrement(builder, method->object->getNode());
 
     builder->emitIndent();
 
@@ -1964,132 +2005,13 @@ void DeparserHdrEmitTranslatorPNA::emitField(EBPF::CodeBuilder *builder, cstring
     builder->newline();
 }
 
-void CRCChecksumAlgorithmPNA::emitUpdateMethod(EBPF::CodeBuilder *builder, int crcWidth) {
-    // Note that this update method is optimized for our CRC16 and CRC32, custom
-    // version may require other method of update. When data_size <= 64 bits,
-    // applies host byte order for input data, otherwise network byte order is expected.
-    if (crcWidth == 16) {
-        // This function calculates CRC16 by definition, it is bit by bit. If input data has more
-        // than 64 bit, the outer loop process bytes in network byte order - data pointer is
-        // incremented. For data shorter than or equal 64 bits, bytes are processed in little endian
-        // byte order - data pointer is decremented by outer loop in this case.
-        // There is no need for lookup table.
-        cstring code =
-            "static __always_inline\n"
-            "void crc16_update(u16 * reg, const u8 * data, "
-            "u16 data_size, const u16 poly) {\n"
-            "    if (data_size <= 8)\n"
-            "        data += data_size - 1;\n"
-            "    #pragma clang loop unroll(full)\n"
-            "    for (u16 i = 0; i < data_size; i++) {\n"
-            "        bpf_trace_message(\"CRC16: data byte: %x\\n\", *data);\n"
-            "        *reg ^= *data;\n"
-            "        for (u8 bit = 0; bit < 8; bit++) {\n"
-            "            *reg = (*reg) & 1 ? ((*reg) >> 1) ^ poly : (*reg) >> 1;\n"
-            "        }\n"
-            "        if (data_size <= 8)\n"
-            "            data--;\n"
-            "        else\n"
-            "            data++;\n"
-            "    }\n"
-            "}";
-        builder->appendLine(code);
-    } else if (crcWidth == 32) {
-        // This function calculates CRC32 using two optimisations: slice-by-8 and Standard
-        // Implementation. Both algorithms have to properly handle byte order depending on data
-        // length. There are four cases which must be handled:
-        // 1. Data size below 8 bytes - calculated using Standard Implementation in little endian
-        //    byte order.
-        // 2. Data size equal to 8 bytes - calculated using slice-by-8 in little endian byte order.
-        // 3. Data size more than 8 bytes and multiply of 8 bytes - calculated using slice-by-8 in
-        //    big endian byte order.
-        // 4. Data size more than 8 bytes and not multiply of 8 bytes - calculated using slice-by-8
-        //    and Standard Implementation both in big endian byte order.
-        // Lookup table is necessary for both algorithms.
-        cstring code =
-            "static __always_inline\n"
-            "void crc32_update(u32 * reg, const u8 * data, u16 data_size, const u32 poly) {\n"
-            "    u32* current = (u32*) data;\n"
-            "    u32 index = 0;\n"
-            "    u32 lookup_key = 0;\n"
-            "    u32 lookup_value = 0;\n"
-            "    u32 lookup_value1 = 0;\n"
-            "    u32 lookup_value2 = 0;\n"
-            "    u32 lookup_value3 = 0;\n"
-            "    u32 lookup_value4 = 0;\n"
-            "    u32 lookup_value5 = 0;\n"
-            "    u32 lookup_value6 = 0;\n"
-            "    u32 lookup_value7 = 0;\n"
-            "    u32 lookup_value8 = 0;\n"
-            "    u16 tmp = 0;\n"
-            "    if (crc32_table != NULL) {\n"
-            "        for (u16 i = data_size; i >= 8; i -= 8) {\n"
-            "            /* Vars one and two will have swapped byte order if data_size == 8 */\n"
-            "            if (data_size == 8) current = (u32 *)(data + 4);\n"
-            "            bpf_trace_message(\"CRC32: data dword: %x\\n\", *current);\n"
-            "            u32 one = (data_size == 8 ? __builtin_bswap32(*current--) : *current++) ^ "
-            "*reg;\n"
-            "            bpf_trace_message(\"CRC32: data dword: %x\\n\", *current);\n"
-            "            u32 two = (data_size == 8 ? __builtin_bswap32(*current--) : *current++);\n"
-            "            lookup_key = (one & 0x000000FF);\n"
-            "            lookup_value8 = crc32_table[(u16)(1792 + (u8)lookup_key)];\n"
-            "            lookup_key = (one >> 8) & 0x000000FF;\n"
-            "            lookup_value7 = crc32_table[(u16)(1536 + (u8)lookup_key)];\n"
-            "            lookup_key = (one >> 16) & 0x000000FF;\n"
-            "            lookup_value6 = crc32_table[(u16)(1280 + (u8)lookup_key)];\n"
-            "            lookup_key = one >> 24;\n"
-            "            lookup_value5 = crc32_table[(u16)(1024 + (u8)(lookup_key))];\n"
-            "            lookup_key = (two & 0x000000FF);\n"
-            "            lookup_value4 = crc32_table[(u16)(768 + (u8)lookup_key)];\n"
-            "            lookup_key = (two >> 8) & 0x000000FF;\n"
-            "            lookup_value3 = crc32_table[(u16)(512 + (u8)lookup_key)];\n"
-            "            lookup_key = (two >> 16) & 0x000000FF;\n"
-            "            lookup_value2 = crc32_table[(u16)(256 + (u8)lookup_key)];\n"
-            "            lookup_key = two >> 24;\n"
-            "            lookup_value1 = crc32_table[(u8)(lookup_key)];\n"
-            "            *reg = lookup_value8 ^ lookup_value7 ^ lookup_value6 ^ lookup_value5 ^\n"
-            "                   lookup_value4 ^ lookup_value3 ^ lookup_value2 ^ lookup_value1;\n"
-            "            tmp += 8;\n"
-            "        }\n"
-            "        volatile int std_algo_lookup_key = 0;\n"
-            "        if (data_size < 8) {\n"
-            // Standard Implementation for little endian byte order
-            "            unsigned char *currentChar = (unsigned char *) current;\n"
-            "            currentChar += data_size - 1;\n"
-            "            for (u16 i = tmp; i < data_size; i++) {\n"
-            "                bpf_trace_message(\"CRC32: data byte: %x\\n\", *currentChar);\n"
-            "                std_algo_lookup_key = (u32)(((*reg) & 0xFF) ^ *currentChar--);\n"
-            "                if (std_algo_lookup_key >= 0) {\n"
-            "                    lookup_value = "
-            "crc32_table[(u8)(std_algo_lookup_key & 255)];\n"
-            "                }\n"
-            "                *reg = ((*reg) >> 8) ^ lookup_value;\n"
-            "            }\n"
-            "        } else {\n"
-            // Standard Implementation for big endian byte order
-            "            /* Consume data not processed by slice-by-8 algorithm above, "
-            "these data are in network byte order */\n"
-            "            unsigned char *currentChar = (unsigned char *) current;\n"
-            "            for (u16 i = tmp; i < data_size; i++) {\n"
-            "                bpf_trace_message(\"CRC32: data byte: %x\\n\", *currentChar);\n"
-            "                std_algo_lookup_key = (u32)(((*reg) & 0xFF) ^ *currentChar++);\n"
-            "                if (std_algo_lookup_key >= 0) {\n"
-            "                    lookup_value = "
-            "crc32_table[(u8)(std_algo_lookup_key & 255)];\n"
-            "                }\n"
-            "                *reg = ((*reg) >> 8) ^ lookup_value;\n"
-            "            }\n"
-            "        }\n"
-            "    }\n"
-            "}";
-        builder->appendLine(code);
-    }
-}
+const EBPF::CRCChecksumAlgorithm::LookupTables CRCChecksumAlgorithmPNA::staticLookupTables = {
+    "", "crc16_table", "crc32_table", ""};
 
 // ===========================CRC16ChecksumAlgorithmPNA===========================
 
 void CRC16ChecksumAlgorithmPNA::emitGlobals(EBPF::CodeBuilder *builder) {
-    CRCChecksumAlgorithmPNA::emitUpdateMethod(builder, 16);
+    EBPF::CRCChecksumAlgorithm::emitUpdateMethod(builder, 16, staticLookupTables);
 
     cstring code =
         "static __always_inline "
@@ -2102,7 +2024,7 @@ void CRC16ChecksumAlgorithmPNA::emitGlobals(EBPF::CodeBuilder *builder) {
 // ===========================CRC32ChecksumAlgorithmPNA===========================
 
 void CRC32ChecksumAlgorithmPNA::emitGlobals(EBPF::CodeBuilder *builder) {
-    CRCChecksumAlgorithmPNA::emitUpdateMethod(builder, 32);
+    EBPF::CRCChecksumAlgorithm::emitUpdateMethod(builder, 32, staticLookupTables);
 
     cstring code =
         "static __always_inline "
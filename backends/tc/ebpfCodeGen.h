@@ -39,6 +39,7 @@ class PNAEbpfGenerator : public EBPF::EbpfCodeGenerator {
     virtual void emitInstances(EBPF::CodeBuilder *builder) const = 0;
     virtual void emitParser(EBPF::CodeBuilder *builder) const = 0;
     virtual void emitHeader(EBPF::CodeBuilder *builder) const = 0;
+    virtual void emitXdpFilter(EBPF::CodeBuilder *builder) const = 0;
     void emitPNAIncludes(EBPF::CodeBuilder *builder) const;
     void emitPreamble(EBPF::CodeBuilder *builder) const override;
     void emitCommonPreamble(EBPF::CodeBuilder *builder) const override;
@@ -98,6 +99,9 @@ class PNAArchTC : public PNAEbpfGenerator {
     void emit(EBPF::CodeBuilder *builder) const override;
     void emitParser(EBPF::CodeBuilder *builder) const override;
     void emitHeader(EBPF::CodeBuilder *builder) const override;
+    /// Emits an XDP program running the parser ahead of tc, so that the packets the parser
+    /// rejects are dropped before an skb is allocated. The builder must use an XDP target.
+    void emitXdpFilter(EBPF::CodeBuilder *builder) const override;
     void emitInstances(EBPF::CodeBuilder *builder) const override;
 };
 
@@ -124,6 +128,9 @@ class PnaStateTranslationVisitor : public EBPF::PsaStateTranslationVisitor {
  protected:
     void compileExtractField(const IR::Expression *expr, const IR::StructField *field,
                              unsigned hdrOffsetBits, EBPF::EBPFType *type) override;
+    /// Fields are read relative to the running packet offset, one at a time.
+    bool coalesceFieldLoads() const override { return false; }
+    bool skipUnusedFields() const override { return false; }
     void compileLookahead(const IR::Expression *destination) override;
 };
 
@@ -362,7 +369,8 @@ class CRCChecksumAlgorithmPNA : public EBPF::CRCChecksumAlgorithm {
     CRCChecksumAlgorithmPNA(const EBPF::EBPFProgram *program, cstring name, int width)
         : EBPF::CRCChecksumAlgorithm(program, name, width) {}
 
-    static void emitUpdateMethod(EBPF::CodeBuilder *builder, int crcWidth);
+    /// The tables are static arrays from runtime/crc16.h and runtime/crc32.h.
+    static const LookupTables staticLookupTables;
 };
 
 class CRC16ChecksumAlgorithmPNA : public CRCChecksumAlgorithmPNA {
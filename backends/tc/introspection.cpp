@@ -56,6 +56,7 @@ void IntrospectionGenerator::collectTableInfo() {
 
 void IntrospectionGenerator::collectKeyInfo(const IR::Key *key, struct TableAttributes *tableInfo) {
     unsigned int i = 1;
+    unsigned int startBit = 0;
     for (auto k : key->keyElements) {
         auto keyField = new struct KeyFieldAttributes();
         keyField->id = i++;
@@ -90,6 +91,8 @@ void IntrospectionGenerator::collectKeyInfo(const IR::Key *key, struct TableAttr
             }
         }
         keyField->bitwidth = widthBits;
+        keyField->startBit = startBit;
+        startBit += widthBits;
         tableInfo->keyFields.push_back(keyField);
     }
 }
@@ -232,6 +235,7 @@ Util::JsonObject *IntrospectionGenerator::genKeyInfo(struct KeyFieldAttributes *
     keyJson->emplace("type", keyField->type);
     keyJson->emplace("match_type", keyField->matchType);
     keyJson->emplace("bitwidth", keyField->bitwidth);
+    keyJson->emplace("startbit", keyField->startBit);
     return keyJson;
 }
 
@@ -49,12 +49,16 @@ struct KeyFieldAttributes {
     cstring type;
     cstring matchType;
     unsigned int bitwidth;
+    /// Offset of the field in the key blob, in bits. Lets the control plane
+    /// pack the keys of many entries without walking the field list for each.
+    unsigned int startBit;
     KeyFieldAttributes() {
         id = 0;
         name = nullptr;
         type = nullptr;
         matchType = nullptr;
         bitwidth = 0;
+        startBit = 0;
     }
 };
 
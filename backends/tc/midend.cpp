@@ -48,6 +48,7 @@ const IR::ToplevelBlock *MidEnd::run(TCOptions &options, const IR::P4Program *pr
          new P4::SimplifySelectList(&refMap, &typeMap),
          new P4::MoveDeclarations(),  // more may have been introduced
          new P4::LocalCopyPropagation(&refMap, &typeMap),
+         new P4::FoldIsValid(&refMap, &typeMap),
          new PassRepeated({new P4::ConstantFolding(&refMap, &typeMap),
                            new P4::StrengthReduction(&refMap, &typeMap)}),
          new P4::RemoveSelectBooleans(&refMap, &typeMap),
@@ -55,9 +56,15 @@ const IR::ToplevelBlock *MidEnd::run(TCOptions &options, const IR::P4Program *pr
          new P4::ConstantFolding(&refMap, &typeMap),
          new P4::SimplifyControlFlow(&refMap, &typeMap),
          new P4::TableHit(&refMap, &typeMap),
+         options.maxInlinedConstEntries
+             ? new PassManager({new P4::SimplifyConstTables(&refMap, &typeMap,
+                                                            options.maxInlinedConstEntries),
+                                new P4::RemoveAllUnusedDeclarations(&refMap)})
+             : nullptr,
          new P4::RemoveLeftSlices(&refMap, &typeMap),
          new EBPF::Lower(&refMap, &typeMap),
          new P4::ParsersUnroll(true, &refMap, &typeMap),
+         new P4::AnnotateSelectSwitch(),
          evaluator,
          new P4::MidEndLast()});
     if (options.listMidendPasses) {
@@ -41,6 +41,7 @@ and limitations under the License.
 #include "midend/eliminateSerEnums.h"
 #include "midend/eliminateTuples.h"
 #include "midend/expandEmit.h"
+#include "midend/foldIsValid.h"
 #include "midend/local_copyprop.h"
 #include "midend/midEndLast.h"
 #include "midend/noMatch.h"
@@ -49,6 +50,8 @@ and limitations under the License.
 #include "midend/removeLeftSlices.h"
 #include "midend/removeMiss.h"
 #include "midend/removeSelectBooleans.h"
+#include "midend/selectSwitch.h"
+#include "midend/simplifyConstTables.h"
 #include "midend/simplifyKey.h"
 #include "midend/simplifySelectCases.h"
 #include "midend/simplifySelectList.h"
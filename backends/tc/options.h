@@ -32,6 +32,12 @@ class TCOptions : public CompilerOptions {
     bool emitTraceMessages = false;
     // XDP2TC mode for PSA-eBPF
     enum XDP2TC xdp2tcMode = XDP2TC_META;
+    // const tables with up to that many entries become conditionals
+    unsigned maxInlinedConstEntries = 0;
+    // Count the executions of parser states, tables and actions in a per-CPU map
+    bool emitCoverage = false;
+    // Write an XDP program running the parser ahead of tc
+    bool emitXdpFilter = false;
 
     TCOptions() {
         registerOption(
@@ -69,6 +75,30 @@ class TCOptions : public CompilerOptions {
             },
             "Select the mode used to pass metadata from XDP to TC "
             "(possible values: meta, head, cpumap).");
+        registerOption(
+            "--inline-const-tables", "N",
+            [this](const char *arg) {
+                maxInlinedConstEntries = std::strtoul(arg, nullptr, 0);
+                return true;
+            },
+            "Compile applications of tables with 'const entries', a 'const default_action', "
+            "exact keys and at most N entries into conditionals instead of table lookups");
+        registerOption(
+            "--emit-coverage", nullptr,
+            [this](const char *) {
+                emitCoverage = true;
+                return true;
+            },
+            "Count the executions of every parser state, table and action in a per-CPU map, "
+            "and write the mapping from counters to the P4 source to <program>.coverage.json");
+        registerOption(
+            "--emit-xdp-filter", nullptr,
+            [this](const char *) {
+                emitXdpFilter = true;
+                return true;
+            },
+            "Write <program>_xdp_filter.c, an XDP program running the parser ahead of tc, "
+            "which drops the packets the parser rejects before an skb is allocated");
     }
 };
 
@@ -36,12 +36,14 @@ limitations under the License.
 #include "midend/eliminateInvalidHeaders.h"
 #include "midend/eliminateNewtype.h"
 #include "midend/eliminateTuples.h"
+#include "midend/foldIsValid.h"
 #include "midend/local_copyprop.h"
 #include "midend/midEndLast.h"
 #include "midend/noMatch.h"
 #include "midend/removeLeftSlices.h"
 #include "midend/removeMiss.h"
 #include "midend/removeSelectBooleans.h"
+#include "midend/selectSwitch.h"
 #include "midend/simplifyKey.h"
 #include "midend/simplifySelectCases.h"
 #include "midend/simplifySelectList.h"
@@ -92,6 +94,7 @@ const IR::ToplevelBlock *MidEnd::run(EbpfOptions &options, const IR::P4Program *
              new P4::SimplifyComparisons(&refMap, &typeMap),
              new P4::CopyStructures(&refMap, &typeMap),
              new P4::LocalCopyPropagation(&refMap, &typeMap),
+             new P4::FoldIsValid(&refMap, &typeMap),
              new P4::SimplifySelectList(&refMap, &typeMap),
              new P4::MoveDeclarations(),  // more may have been introduced
              new P4::RemoveSelectBooleans(&refMap, &typeMap),
@@ -99,7 +102,7 @@ const IR::ToplevelBlock *MidEnd::run(EbpfOptions &options, const IR::P4Program *
              new P4::ConstantFolding(&refMap, &typeMap),
              new P4::SimplifyControlFlow(&refMap, &typeMap), new P4::TableHit(&refMap, &typeMap),
              new P4::RemoveLeftSlices(&refMap, &typeMap), new EBPF::Lower(&refMap, &typeMap),
-             evaluator, new P4::MidEndLast()});
+             new P4::AnnotateSelectSwitch(), evaluator, new P4::MidEndLast()});
         if (options.listMidendPasses) {
             midEnd.listPasses(*outStream, "\n");
             *outStream << std::endl;
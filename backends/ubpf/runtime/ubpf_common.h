@@ -83,4 +83,17 @@ limitations under the License.
 #define load_byte(data, b) (*(((uint8_t*)(data)) + (b)))
 #define load_half(data, b) __constant_ntohs(*(uint16_t *)((uint8_t*)(data) + (b)))
 #define load_word(data, b) __constant_ntohl(*(uint32_t *)((uint8_t*)(data) + (b)))
-#define load_dword(data, b) __constant_ntohll(*(uint64_t *)((uint8_t*)(data) + (b)))
\ No newline at end of file
+#define load_dword(data, b) __constant_ntohll(*(uint64_t *)((uint8_t*)(data) + (b)))
+
+#ifndef UBPF_BURST
+#define UBPF_BURST
+struct standard_metadata;
+
+/* Argument of entry_burst(), the entry point generated with --emit-burst. */
+struct ubpf_burst {
+    uint32_t count;
+    void **ctx;                              /* count packet contexts, as given to entry() */
+    struct standard_metadata **std_meta;     /* count standard metadata, as given to entry() */
+    uint64_t *result;                        /* count results, filled as returned by entry() */
+};
+#endif
@@ -158,6 +158,12 @@ void UBPFControlBodyTranslator::processMethod(const P4::ExternMethod *method) {
 
         if (method->method->name.name == UBPFModel::instance.registerModel.write.name) {
             pRegister->emitKeyInstance(builder, method->expr);
+            for (auto it = registerReads.begin(); it != registerReads.end();) {
+                if (it->first.first == pRegister)
+                    it = registerReads.erase(it);
+                else
+                    ++it;
+            }
         }
 
         pRegister->emitMethodInvocation(builder, method);
@@ -169,6 +175,8 @@ void UBPFControlBodyTranslator::processMethod(const P4::ExternMethod *method) {
 void UBPFControlBodyTranslator::processApply(const P4::ApplyMethod *method) {
     auto table = control->getTable(method->object->getName().name);
     BUG_CHECK(table != nullptr, "No table for %1%", method->expr);
+    // Actions of the table may write any register.
+    registerReads.clear();
 
     cstring actionVariableName;
     if (!saveAction.empty()) {
@@ -221,8 +229,11 @@ void UBPFControlBodyTranslator::processApply(const P4::ApplyMethod *method) {
 
     builder->emitIndent();
     builder->append("value = ");
-    builder->target->emitTableLookup(builder, table->defaultActionMapName,
-                                     control->program->zeroKey, valueName);
+    if (control->program->options.emitBurst)
+        builder->append(table->defaultActionValueName());
+    else
+        builder->target->emitTableLookup(builder, table->defaultActionMapName,
+                                         control->program->zeroKey, valueName);
     builder->endOfStatement(true);
     builder->blockEnd(false);
     builder->append(" else ");
@@ -307,6 +318,11 @@ bool UBPFControlBodyTranslator::preorder(const IR::MethodCallExpression *express
             visit(bim->appliedTo);
             builder->append(".ebpf_valid = false");
             return false;
+        } else if (bim->name == IR::Type_Stack::push_front ||
+                   bim->name == IR::Type_Stack::pop_front) {
+            builder->emitIndent();
+            emitStackShift(bim);
+            return false;
         }
     }
 
@@ -343,6 +359,19 @@ bool UBPFControlBodyTranslator::emitRegisterRead(const IR::AssignmentStatement *
     auto pathExpr = method->method->to<IR::Member>()->expr->to<IR::PathExpression>();
     auto registerName = pathExpr->path->name.name;
     auto pRegister = control->getRegister(registerName);
+    auto block = findContext<IR::BlockStatement>();
+    auto index = method->arguments->at(0)->expression->to<IR::Constant>();
+    if (index != nullptr) {
+        auto it = registerReads.find({pRegister, index->value});
+        if (it != registerReads.end() && it->second.first == block) {
+            // Still inside the 'if' checking the pointer returned by the first read.
+            visit(a->left);
+            builder->append(" = *");
+            builder->append(it->second.second);
+            builder->endOfStatement();
+            return false;
+        }
+    }
     pRegister->emitKeyInstance(builder, method);
 
     auto etype = UBPFTypeFactory::instance->create(pRegister->keyType);
@@ -368,6 +397,7 @@ bool UBPFControlBodyTranslator::emitRegisterRead(const IR::AssignmentStatement *
     builder->endOfStatement();
 
     registersLookups.push_back(pRegister);
+    if (index != nullptr) registerReads[{pRegister, index->value}] = {block, tmp};
 
     return false;
 }
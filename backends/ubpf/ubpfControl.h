@@ -32,6 +32,13 @@ class UBPFControlBodyTranslator : public EBPF::ControlBodyTranslator {
     P4::P4CoreLibrary &p4lib;
 
     std::vector<UBPFRegister *> registersLookups;
+    /// Pointers returned by register reads at a constant index, with the block
+    /// the read is in.  A later read of the same index in the same block uses
+    /// the pointer instead of calling the map helper again.  Entries are
+    /// dropped when the register is written or a table is applied.
+    std::map<std::pair<const UBPFRegister *, big_int>,
+             std::pair<const IR::BlockStatement *, cstring>>
+        registerReads;
 
     explicit UBPFControlBodyTranslator(const UBPFControl *control);
     void processMethod(const P4::ExternMethod *method) override;
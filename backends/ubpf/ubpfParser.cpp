@@ -18,6 +18,7 @@ limitations under the License.
 
 #include "frontends/p4/coreLibrary.h"
 #include "frontends/p4/methodInstance.h"
+#include "midend/selectSwitch.h"
 #include "ubpfHelpers.h"
 #include "ubpfModel.h"
 #include "ubpfType.h"
@@ -46,6 +47,7 @@ class UBPFStateTranslationVisitor : public EBPF::CodeGenInspector {
     void compileLookahead(const IR::Expression *destination);
 
     void compileAdvance(const IR::Expression *expr);
+    void emitSelectSwitch(const IR::SelectExpression *expression);
 
  public:
     explicit UBPFStateTranslationVisitor(const UBPFParserState *state)
@@ -148,6 +150,33 @@ bool UBPFStateTranslationVisitor::preorder(const IR::SelectCase *selectCase) {
     return false;
 }
 
+void UBPFStateTranslationVisitor::emitSelectSwitch(const IR::SelectExpression *expression) {
+    builder->emitIndent();
+    builder->appendFormat("switch (%s) ", selectValue);
+    builder->blockStart();
+    bool hasDefault = false;
+    for (auto e : expression->selectCases) {
+        builder->emitIndent();
+        if (P4::AnnotateSelectSwitch::isDefault(e->keyset)) {
+            hasDefault = true;
+            builder->append("default: ");
+        } else {
+            builder->append("case ");
+            visit(P4::AnnotateSelectSwitch::exactValue(e->keyset));
+            builder->append(": ");
+        }
+        builder->append("goto ");
+        visit(e->state);
+        builder->endOfStatement(true);
+    }
+    if (!hasDefault) {
+        builder->emitIndent();
+        builder->appendFormat("default: goto %s;", IR::ParserState::reject.c_str());
+        builder->newline();
+    }
+    builder->blockEnd(true);
+}
+
 bool UBPFStateTranslationVisitor::preorder(const IR::SelectExpression *expression) {
     BUG_CHECK(expression->select->components.size() == 1, "%1%: tuple not eliminated in select",
               expression->select);
@@ -165,6 +194,10 @@ bool UBPFStateTranslationVisitor::preorder(const IR::SelectExpression *expressio
     builder->appendFormat("%s = ", selectValue);
     visit(expression->select);
     builder->endOfStatement(true);
+    if (P4::AnnotateSelectSwitch::isSwitch(state->state)) {
+        emitSelectSwitch(expression);
+        return false;
+    }
     for (auto e : expression->selectCases) visit(e);
 
     builder->emitIndent();
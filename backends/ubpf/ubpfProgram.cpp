@@ -77,7 +77,10 @@ void UBPFProgram::emitC(UbpfCodeBuilder *builder, cstring headerFile) {
     builder->target->emitChecksumHelpers(builder);
 
     builder->emitIndent();
-    builder->target->emitMain(builder, "entry", contextVar.c_str(), stdMetadataVar.c_str());
+    if (options.emitBurst)
+        emitProcessPacket(builder);
+    else
+        builder->target->emitMain(builder, "entry", contextVar.c_str(), stdMetadataVar.c_str());
     builder->blockStart();
 
     emitPktVariable(builder);
@@ -124,6 +127,67 @@ void UBPFProgram::emitC(UbpfCodeBuilder *builder, cstring headerFile) {
     builder->appendFormat("return %s;\n", builder->target->dropReturnCode().c_str());
     builder->decreaseIndent();
     builder->blockEnd(true);
+
+    if (options.emitBurst) emitBurstEntry(builder);
+}
+
+void UBPFProgram::emitProcessPacket(UbpfCodeBuilder *builder) const {
+    builder->appendFormat(
+        "static inline __attribute__((always_inline)) "
+        "uint64_t process_packet(void *%s, struct standard_metadata *%s",
+        contextVar.c_str(), stdMetadataVar.c_str());
+    for (auto it : control->tables) {
+        auto table = it.second;
+        builder->appendFormat(", struct %s *%s", table->valueTypeName.c_str(),
+                              table->defaultActionValueName().c_str());
+    }
+    builder->append(")");
+}
+
+void UBPFProgram::emitBurstEntry(UbpfCodeBuilder *builder) const {
+    // The packets of a burst are processed by one VM entry. The default actions are looked up
+    // once for the whole burst, so they do not change while it is processed.
+    builder->newline();
+    builder->append("uint64_t entry_burst(struct ubpf_burst *burst)");
+    builder->spc();
+    builder->blockStart();
+    if (!control->tables.empty()) {
+        builder->emitIndent();
+        builder->appendFormat("uint32_t %s = 0;", zeroKey.c_str());
+        builder->newline();
+    }
+    for (auto it : control->tables) {
+        auto table = it.second;
+        builder->emitIndent();
+        builder->appendFormat("struct %s *%s = ", table->valueTypeName.c_str(),
+                              table->defaultActionValueName().c_str());
+        builder->target->emitTableLookup(builder, table->defaultActionMapName, zeroKey, "");
+        builder->endOfStatement(true);
+    }
+    builder->emitIndent();
+    builder->appendLine("uint64_t forwarded = 0;");
+    builder->emitIndent();
+    builder->append("for (uint32_t i = 0; i < burst->count; i++) ");
+    builder->blockStart();
+    builder->emitIndent();
+    builder->append("uint64_t result = process_packet(burst->ctx[i], burst->std_meta[i]");
+    for (auto it : control->tables)
+        builder->appendFormat(", %s", it.second->defaultActionValueName().c_str());
+    builder->append(")");
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendLine("burst->result[i] = result;");
+    builder->emitIndent();
+    builder->appendFormat("if (result != %s)", builder->target->dropReturnCode().c_str());
+    builder->newline();
+    builder->increaseIndent();
+    builder->emitIndent();
+    builder->appendLine("forwarded++;");
+    builder->decreaseIndent();
+    builder->blockEnd(true);
+    builder->emitIndent();
+    builder->appendLine("return forwarded;");
+    builder->blockEnd(true);
 }
 
 void UBPFProgram::emitH(EBPF::CodeBuilder *builder, cstring) {
@@ -67,6 +67,11 @@ class UBPFProgram : public EBPF::EBPFProgram {
     void emitPreamble(EBPF::CodeBuilder *builder) override;
     void emitTypes(EBPF::CodeBuilder *builder) override;
     void emitTableDefinition(EBPF::CodeBuilder *builder) const;
+    /// Signature of the per-packet function called by the burst entry point, which is given
+    /// the default action of every table.
+    void emitProcessPacket(UbpfCodeBuilder *builder) const;
+    /// Emits entry_burst(), running process_packet() on every packet of a struct ubpf_burst.
+    void emitBurstEntry(UbpfCodeBuilder *builder) const;
     void emitPktVariable(UbpfCodeBuilder *builder) const;
     void emitPacketLengthVariable(UbpfCodeBuilder *builder) const;
     void emitHeaderInstances(EBPF::CodeBuilder *builder) override;
@@ -67,6 +67,8 @@ class UBPFTable final : public UBPFTableBase {
 
     UBPFTable(const UBPFProgram *program, const IR::TableBlock *table,
               EBPF::CodeGenInspector *codeGen);
+    /// Pointer to the default action, looked up once per burst with --emit-burst.
+    cstring defaultActionValueName() const { return defaultActionMapName + "_value"; }
 
     cstring generateActionName(const IR::P4Action *action);
     void emitInstance(EBPF::CodeBuilder *pBuilder);
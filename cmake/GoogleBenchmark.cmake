@@ -0,0 +1,18 @@
+macro(p4c_obtain_googlebenchmark)
+  # Print download state while setting up Google Benchmark.
+  set(FETCHCONTENT_QUIET_PREV ${FETCHCONTENT_QUIET})
+  set(FETCHCONTENT_QUIET OFF)
+  set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "Build the tests of Google Benchmark.")
+  set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "Install Google Benchmark.")
+  set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "Build the gtest tests of Google Benchmark.")
+  # Fetch and build the Google Benchmark dependency.
+  FetchContent_Declare(
+    benchmark
+    GIT_REPOSITORY https://github.com/google/benchmark.git
+    GIT_TAG        v1.8.3
+    GIT_PROGRESS TRUE
+  )
+  FetchContent_MakeAvailable(benchmark)
+  set(FETCHCONTENT_QUIET ${FETCHCONTENT_QUIET_PREV})
+  message("Done with setting up Google Benchmark for P4C.")
+endmacro(p4c_obtain_googlebenchmark)
@@ -23,14 +23,17 @@ namespace P4 {
 
 namespace ControlPlaneAPI {
 
-/// Convert a bignum to the P4Runtime bytes representation. The value must fit
-/// within the provided @width expressed in bits. Padding will be added as
-/// necessary (as the most significant bits).
-std::optional<std::string> stringReprConstant(big_int value, int width) {
+/// Write the P4Runtime bytes representation of @value to @destination,
+/// replacing its contents, so that protobuf fields can be filled in place. The
+/// value must fit within the provided @width expressed in bits. Padding will be
+/// added as necessary (as the most significant bits). @return false if the
+/// value cannot be represented.
+bool stringReprConstant(const big_int &value, int width, std::string *destination) {
+    CHECK_NULL(destination);
     // TODO(antonin): support negative values
     if (value < 0) {
         ::error(ErrorType::ERR_UNSUPPORTED, "%1%: Negative values not supported yet", value);
-        return std::nullopt;
+        return false;
     }
     BUG_CHECK(width > 0, "Unexpected width 0");
     size_t bitsRequired = floor_log2(value) + 1;
@@ -44,13 +47,25 @@ std::optional<std::string> stringReprConstant(big_int value, int width) {
     // to the P4Runtime specification is also valid (but not the canonical
     // representation, which means no RW symmetry).
     // auto bytes = ROUNDUP(mpz_sizeinbase(value.get_mpz_t(), 2), 8);
-    auto bytes = ROUNDUP(width, 8);
-    std::vector<char> data(bytes);
-    for (auto &d : data) {
-        big_int v = (value >> (--bytes * 8)) & 0xff;
-        d = static_cast<uint8_t>(v);
+    size_t bytes = ROUNDUP(width, 8);
+    destination->assign(bytes, '\0');
+    if (bitsRequired <= 64) {
+        // Most values fit in a machine word, which avoids shifting the bignum.
+        auto v = static_cast<uint64_t>(value);
+        for (size_t i = bytes; v != 0; v >>= 8) (*destination)[--i] = static_cast<char>(v & 0xff);
+    } else {
+        auto *data = reinterpret_cast<unsigned char *>(destination->data());
+        boost::multiprecision::export_bits(value, data + bytes - ROUNDUP(bitsRequired, 8), 8);
     }
-    return std::string(data.begin(), data.end());
+    return true;
+}
+
+/// Convert a bignum to the P4Runtime bytes representation by calling the
+/// version of stringReprConstant that writes to a string.
+std::optional<std::string> stringReprConstant(big_int value, int width) {
+    std::string result;
+    if (!stringReprConstant(value, width, &result)) return std::nullopt;
+    return result;
 }
 
 /// Convert a Constant to the P4Runtime bytes representation by calling
@@ -66,6 +81,14 @@ std::optional<std::string> stringRepr(const IR::BoolLiteral *constant, int width
     return stringReprConstant(v, width);
 }
 
+bool stringRepr(const IR::Constant *constant, int width, std::string *destination) {
+    return stringReprConstant(constant->value, width, destination);
+}
+
+bool stringRepr(const IR::BoolLiteral *constant, int width, std::string *destination) {
+    return stringReprConstant(big_int(constant->value ? 1 : 0), width, destination);
+}
+
 }  // namespace ControlPlaneAPI
 
 }  // namespace P4
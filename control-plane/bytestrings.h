@@ -39,6 +39,15 @@ std::optional<std::string> stringRepr(const IR::BoolLiteral *constant, int width
 
 std::optional<std::string> stringReprConstant(big_int value, int width);
 
+/// Versions of the functions above that write the representation to
+/// @destination, typically a mutable protobuf field, and @return false if the
+/// value cannot be represented.
+bool stringRepr(const IR::Constant *constant, int width, std::string *destination);
+
+bool stringRepr(const IR::BoolLiteral *constant, int width, std::string *destination);
+
+bool stringReprConstant(const big_int &value, int width, std::string *destination);
+
 }  // namespace ControlPlaneAPI
 
 }  // namespace P4
@@ -16,7 +16,12 @@ limitations under the License.
 
 #include "flattenHeader.h"
 
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
 #include "frontends/p4/typeMap.h"
+#include "lib/hash.h"
 
 namespace P4 {
 
@@ -74,11 +79,29 @@ const IR::Annotations *FlattenHeader::mergeAnnotations() const {
 /* static */
 const IR::Type_Header *FlattenHeader::flatten(P4::TypeMap *typeMap,
                                               const IR::Type_Header *headerType) {
+    // Tables, digests and packet-io headers often share header types, which the P4Runtime and
+    // BF-Runtime generators flatten each time they meet them.
+    static std::mutex mutex;
+    static std::unordered_map<std::pair<const P4::TypeMap *, const IR::Type_Header *>,
+                              const IR::Type_Header *, Util::Hash>
+        cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto key = std::make_pair(typeMap, headerType);
+    auto it = cache.find(key);
+    // A type map that was cleared, or another one at the same address, does not know the
+    // types of the fields of the flattened header.
+    if (it != cache.end() &&
+        (it->second == headerType || it->second->fields.empty() ||
+         typeMap->contains(it->second->fields.front())))
+        return it->second;
+
     auto flattenedHeader = headerType->clone();
     flattenedHeader->fields.clear();
     FlattenHeader flattener(typeMap, flattenedHeader);
     flattener.doFlatten(headerType);
-    return flattener.needsFlattening ? flattenedHeader : headerType;
+    const IR::Type_Header *result = flattener.needsFlattening ? flattenedHeader : headerType;
+    cache[key] = result;
+    return result;
 }
 
 }  // namespace ControlPlaneAPI
@@ -46,7 +46,8 @@ class FlattenHeader {
  public:
     /// If the @headerType needs flattening, creates a clone of the IR node with
     /// a new flattened field list. Otherwise returns @headerType. This does not
-    /// modify the IR.
+    /// modify the IR. The result is computed once for each header type and
+    /// type map, as long as the type map keeps the types of the new fields.
     static const IR::Type_Header *flatten(P4::TypeMap *typeMap, const IR::Type_Header *headerType);
 };
 
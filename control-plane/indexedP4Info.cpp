@@ -0,0 +1,213 @@
+/*
+Copyright 2024-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "indexedP4Info.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "lib/cstring.h"
+#include "lib/error.h"
+#include "lib/null.h"
+#include "p4infoApi.h"
+
+namespace P4::ControlPlaneAPI::IndexedP4Info {
+
+namespace {
+
+// Offsets of the fields of the header and of an object.
+constexpr uint64_t versionOffset = 8;
+constexpr uint64_t byteOrderOffset = 12;
+constexpr uint64_t objectCountOffset = 16;
+constexpr uint64_t objectsOffsetOffset = 24;
+constexpr uint64_t namesOffsetOffset = 32;
+constexpr uint64_t stringsOffsetOffset = 40;
+constexpr uint64_t p4InfoOffsetOffset = 48;
+constexpr uint64_t p4InfoSizeOffset = 56;
+constexpr uint64_t headerSize = 64;
+constexpr uint64_t objectSize = 32;
+
+void align(std::string &buffer) { buffer.resize((buffer.size() + 7) & ~size_t(7), '\0'); }
+
+template <typename T>
+void put(std::string &buffer, uint64_t offset, T value) {
+    std::memcpy(&buffer[offset], &value, sizeof(value));
+}
+
+template <typename T>
+void append(std::string &buffer, T value) {
+    buffer.resize(buffer.size() + sizeof(value));
+    put(buffer, buffer.size() - sizeof(value), value);
+}
+
+struct Entry {
+    uint32_t id;
+    std::string kind;
+    std::string name;
+    std::string message;
+};
+
+}  // namespace
+
+bool writeTo(const p4::config::v1::P4Info &p4Info, std::ostream *destination) {
+    CHECK_NULL(destination);
+    std::vector<Entry> entries;
+    forAllP4InfoObjects(p4Info, [&](cstring kind, const p4::config::v1::Preamble &preamble,
+                                    const google::protobuf::Message &object) {
+        entries.push_back(Entry{preamble.id(), std::string(kind.c_str()), preamble.name(),
+                                object.SerializeAsString()});
+    });
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry &a, const Entry &b) { return a.id < b.id; });
+    std::vector<uint32_t> byName(entries.size());
+    for (uint32_t i = 0; i < byName.size(); i++) byName[i] = i;
+    std::sort(byName.begin(), byName.end(), [&](uint32_t a, uint32_t b) {
+        return std::tie(entries[a].name, entries[a].kind) <
+               std::tie(entries[b].name, entries[b].kind);
+    });
+
+    std::string buffer(headerSize, '\0');
+    std::memcpy(&buffer[0], magic, sizeof(magic));
+    put(buffer, versionOffset, version);
+    put(buffer, byteOrderOffset, byteOrder);
+    put(buffer, objectCountOffset, uint32_t(entries.size()));
+    put(buffer, objectsOffsetOffset, uint64_t(buffer.size()));
+    buffer.resize(buffer.size() + entries.size() * objectSize, '\0');
+    put(buffer, namesOffsetOffset, uint64_t(buffer.size()));
+    for (auto index : byName) append(buffer, index);
+    align(buffer);
+
+    // The offsets of the strings and of the messages are filled in as they are appended.
+    put(buffer, stringsOffsetOffset, uint64_t(buffer.size()));
+    auto appendString = [&](uint64_t field, std::string_view string) {
+        put(buffer, field, uint32_t(buffer.size()));
+        put(buffer, field + 4, uint32_t(string.size()));
+        buffer.append(string);
+    };
+    for (uint64_t i = 0; i < entries.size(); i++) {
+        uint64_t object = headerSize + i * objectSize;
+        put(buffer, object, entries[i].id);
+        appendString(object + 4, entries[i].kind);
+        appendString(object + 12, entries[i].name);
+    }
+    for (uint64_t i = 0; i < entries.size(); i++) {
+        align(buffer);
+        appendString(headerSize + i * objectSize + 20, entries[i].message);
+    }
+    align(buffer);
+    std::string serialized = p4Info.SerializeAsString();
+    put(buffer, p4InfoOffsetOffset, uint64_t(buffer.size()));
+    put(buffer, p4InfoSizeOffset, uint64_t(serialized.size()));
+    buffer.append(serialized);
+    if (buffer.size() > std::numeric_limits<uint32_t>::max()) {
+        ::error(ErrorType::ERR_OVERLIMIT, "The P4Info is too large for the indexed format");
+        return false;
+    }
+
+    destination->write(buffer.data(), buffer.size());
+    destination->flush();
+    return destination->good();
+}
+
+View::View(const char *data, size_t size) : data(data), size(size) {
+    if (data == nullptr || size < headerSize || std::memcmp(data, magic, sizeof(magic)) != 0 ||
+        read32(versionOffset) != version || read32(byteOrderOffset) != byteOrder)
+        return;
+    objectCount = read32(objectCountOffset);
+    objectsOffset = read64(objectsOffsetOffset);
+    namesOffset = read64(namesOffsetOffset);
+    p4InfoOffset = read64(p4InfoOffsetOffset);
+    p4InfoSize = read64(p4InfoSizeOffset);
+    isValid = bytes(objectsOffset, uint64_t(objectCount) * objectSize) &&
+              bytes(namesOffset, uint64_t(objectCount) * 4) && bytes(p4InfoOffset, p4InfoSize);
+    if (!isValid) objectCount = 0;
+}
+
+std::optional<std::string_view> View::bytes(uint64_t offset, uint64_t length) const {
+    if (offset > size || length > size - offset) return std::nullopt;
+    return std::string_view(data + offset, length);
+}
+
+uint32_t View::read32(uint64_t offset) const {
+    uint32_t value;
+    std::memcpy(&value, data + offset, sizeof(value));
+    return value;
+}
+
+uint64_t View::read64(uint64_t offset) const {
+    uint64_t value;
+    std::memcpy(&value, data + offset, sizeof(value));
+    return value;
+}
+
+std::optional<View::Object> View::object(uint32_t index) const {
+    if (index >= objectCount) return std::nullopt;
+    uint64_t offset = objectsOffset + uint64_t(index) * objectSize;
+    auto kind = bytes(read32(offset + 4), read32(offset + 8));
+    auto name = bytes(read32(offset + 12), read32(offset + 16));
+    auto message = bytes(read32(offset + 20), read32(offset + 24));
+    if (!kind || !name || !message) return std::nullopt;
+    return Object{read32(offset), *kind, *name, *message};
+}
+
+std::optional<View::Object> View::findById(uint32_t id) const {
+    uint32_t low = 0, high = objectCount;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if (read32(objectsOffset + uint64_t(middle) * objectSize) < id)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    auto result = object(low);
+    if (result && result->id == id) return result;
+    return std::nullopt;
+}
+
+std::optional<View::Object> View::findByName(std::string_view name,
+                                             std::string_view kind) const {
+    auto byName = [&](uint32_t rank) {
+        auto index = read32(namesOffset + uint64_t(rank) * 4);
+        return object(index);
+    };
+    uint32_t low = 0, high = objectCount;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        auto current = byName(middle);
+        if (!current) return std::nullopt;
+        if (std::tie(current->name, current->kind) < std::tie(name, kind))
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    for (; low < objectCount; low++) {
+        auto current = byName(low);
+        if (!current || current->name != name) break;
+        if (kind.empty() || current->kind == kind) return current;
+    }
+    return std::nullopt;
+}
+
+std::string_view View::p4Info() const {
+    if (!isValid) return {};
+    return std::string_view(data + p4InfoOffset, p4InfoSize);
+}
+
+}  // namespace P4::ControlPlaneAPI::IndexedP4Info
@@ -0,0 +1,100 @@
+/*
+Copyright 2024-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef CONTROL_PLANE_INDEXEDP4INFO_H_
+#define CONTROL_PLANE_INDEXEDP4INFO_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string_view>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include "p4/config/v1/p4info.pb.h"
+#pragma GCC diagnostic pop
+
+namespace P4::ControlPlaneAPI {
+
+/// The indexed P4Info format lets an agent map a P4Info in memory and look up its objects by
+/// id or by name without parsing it. A file holds, at offsets aligned to 8 bytes:
+///  - a header: the magic "P4INFOIX", the version, the value 0x01020304 written in the byte
+///    order of the compiler's host, the number of objects and the offsets and sizes of the
+///    other sections, as 64-bit integers;
+///  - the objects, sorted by id: id, offset and size of the kind and of the name, and offset
+///    and size of the serialized protobuf message of the object (e.g. a p4.config.v1.Table),
+///    as 32-bit integers padded to 32 bytes;
+///  - the indices of the objects, sorted by name and then by kind, as 32-bit integers;
+///  - the strings, and the serialized messages of the objects;
+///  - the whole P4Info, serialized as in the binary format.
+/// Offsets are from the start of the file. Kinds are those of forAllP4InfoObjects.
+namespace IndexedP4Info {
+
+inline constexpr char magic[8] = {'P', '4', 'I', 'N', 'F', 'O', 'I', 'X'};
+inline constexpr uint32_t version = 1;
+inline constexpr uint32_t byteOrder = 0x01020304;
+
+/// Writes @p p4Info to @p destination in the indexed format. @returns false on failure.
+bool writeTo(const p4::config::v1::P4Info &p4Info, std::ostream *destination);
+
+/// A read-only view of a P4Info in the indexed format, which does not copy the data given to
+/// its constructor; lookups are binary searches.
+class View {
+    const char *data;
+    size_t size;
+    bool isValid = false;
+    uint32_t objectCount = 0;
+    uint64_t objectsOffset = 0;
+    uint64_t namesOffset = 0;
+    uint64_t p4InfoOffset = 0;
+    uint64_t p4InfoSize = 0;
+
+    /// @returns the string of @p size bytes at @p offset, or nullopt if it is out of bounds.
+    std::optional<std::string_view> bytes(uint64_t offset, uint64_t size) const;
+    uint32_t read32(uint64_t offset) const;
+    uint64_t read64(uint64_t offset) const;
+
+ public:
+    struct Object {
+        uint32_t id;
+        std::string_view kind;
+        std::string_view name;
+        /// The serialized protobuf message of the object.
+        std::string_view message;
+    };
+
+    View(const char *data, size_t size);
+    /// @returns false if the data is not a P4Info in the indexed format of this version,
+    /// written on a host with the same byte order.
+    bool valid() const { return isValid; }
+    uint32_t objects() const { return objectCount; }
+    /// @returns the object of rank @p index in the order of ids, or nullopt if the file is
+    /// truncated.
+    std::optional<Object> object(uint32_t index) const;
+    std::optional<Object> findById(uint32_t id) const;
+    /// @returns the object named @p name, of kind @p kind if it is not empty.
+    std::optional<Object> findByName(std::string_view name, std::string_view kind = {}) const;
+    /// @returns the serialized P4Info.
+    std::string_view p4Info() const;
+};
+
+}  // namespace IndexedP4Info
+
+}  // namespace P4::ControlPlaneAPI
+
+#endif /* CONTROL_PLANE_INDEXEDP4INFO_H_ */
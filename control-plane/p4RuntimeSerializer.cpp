@@ -19,9 +19,11 @@ limitations under the License.
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 #pragma GCC diagnostic ignored "-Wpedantic"
 #include <google/protobuf/text_format.h>
+#include <google/protobuf/util/delimited_message_util.h>
 #include <google/protobuf/util/json_util.h>
 #pragma GCC diagnostic pop
 
+#include <algorithm>
 #include <iostream>
 #include <iterator>
 #include <optional>
@@ -58,7 +60,9 @@ limitations under the License.
 #include "p4RuntimeAnnotations.h"
 #include "p4RuntimeArchHandler.h"
 #include "p4RuntimeArchStandard.h"
+#include "indexedP4Info.h"
 #include "p4RuntimeSymbolTable.h"
+#include "p4infoApi.h"
 #include "typeSpecConverter.h"
 
 namespace p4v1 = ::p4::v1;
@@ -161,6 +165,41 @@ static bool writeTextTo(const Message &message, std::ostream *destination) {
     return true;
 }
 
+/// Serialize the updates of @entries to @destination as a sequence of WriteRequest messages of
+/// at most @chunkSize updates each, so that only one of them is built at a time: length-delimited
+/// messages in the binary format, and one message per line in the JSON format.
+static bool writeChunksTo(const p4v1::WriteRequest &entries, size_t chunkSize,
+                          P4RuntimeFormat format, std::ostream *destination,
+                          JsonPrintOptions options) {
+    CHECK_NULL(destination);
+    options.add_whitespace = false;
+    const auto &updates = entries.updates();
+    size_t size = updates.size();
+    p4v1::WriteRequest chunk;
+    for (size_t begin = 0; begin < size; begin += std::min(chunkSize, size - begin)) {
+        chunk.clear_updates();
+        for (size_t i = begin; i < size && i - begin < chunkSize; i++)
+            *chunk.add_updates() = updates.Get(i);
+        if (format == P4RuntimeFormat::BINARY) {
+            if (!google::protobuf::util::SerializeDelimitedToOstream(chunk, destination))
+                return false;
+            continue;
+        }
+        std::string output;
+        if (!google::protobuf::util::MessageToJsonString(chunk, &output, options).ok()) {
+            ::error(ErrorType::ERR_IO, "Failed to serialize protobuf message to JSON");
+            return false;
+        }
+        *destination << output << "\n";
+        if (!destination->good()) {
+            ::error(ErrorType::ERR_IO, "Failed to write JSON protobuf message to the output");
+            return false;
+        }
+    }
+    destination->flush();
+    return destination->good();
+}
+
 }  // namespace writers
 
 /// The information about a default action which is needed to serialize it.
@@ -518,7 +557,7 @@ class P4RuntimeAnalyzer {
     static P4RuntimeAPI analyze(const IR::P4Program *program,
                                 const IR::ToplevelBlock *evaluatedProgram, ReferenceMap *refMap,
                                 TypeMap *typeMap, P4RuntimeArchHandlerIface *archHandler,
-                                cstring arch);
+                                cstring arch, const p4configv1::P4Info *previous);
 
     void addAction(const IR::P4Action *actionDeclaration) {
         if (isHidden(actionDeclaration)) return;
@@ -1094,16 +1133,16 @@ class P4RuntimeEntriesConverter {
             auto parameter = actionDecl->parameters->parameters.at(parameterIndex++);
             int width = getTypeWidth(parameter->type, typeMap);
             auto ei = EnumInstance::resolve(arg->expression, typeMap);
+            // The values are written in place, as there is one per parameter of every entry.
             if (arg->expression->is<IR::Constant>()) {
-                auto value = stringRepr(arg->expression->to<IR::Constant>(), width);
-                protoParam->set_value(*value);
+                stringRepr(arg->expression->to<IR::Constant>(), width,
+                           protoParam->mutable_value());
             } else if (arg->expression->is<IR::BoolLiteral>()) {
-                auto value = stringRepr(arg->expression->to<IR::BoolLiteral>(), width);
-                protoParam->set_value(*value);
+                stringRepr(arg->expression->to<IR::BoolLiteral>(), width,
+                           protoParam->mutable_value());
             } else if (ei != nullptr && ei->is<SerEnumInstance>()) {
                 auto sei = ei->to<SerEnumInstance>();
-                auto value = stringRepr(sei->value->to<IR::Constant>(), width);
-                protoParam->set_value(*value);
+                stringRepr(sei->value->to<IR::Constant>(), width, protoParam->mutable_value());
             } else {
                 ::error(ErrorType::ERR_UNSUPPORTED, "%1% unsupported argument expression",
                         arg->expression);
@@ -1204,7 +1243,7 @@ class P4RuntimeEntriesConverter {
         auto protoExact = protoMatch->mutable_exact();
         auto value = convertSimpleKeyExpression(k, keyWidth, typeMap);
         if (value == std::nullopt) return;
-        protoExact->set_value(*value);
+        protoExact->set_value(std::move(*value));
     }
 
     void addLpm(p4v1::TableEntry *protoEntry, int fieldId, const IR::Expression *k, int keyWidth,
@@ -1246,7 +1285,7 @@ class P4RuntimeEntriesConverter {
         auto protoMatch = protoEntry->add_match();
         protoMatch->set_field_id(fieldId);
         auto protoLpm = protoMatch->mutable_lpm();
-        protoLpm->set_value(*valueStr);
+        protoLpm->set_value(std::move(*valueStr));
         protoLpm->set_prefix_len(prefixLen);
     }
 
@@ -1280,8 +1319,8 @@ class P4RuntimeEntriesConverter {
         auto protoMatch = protoEntry->add_match();
         protoMatch->set_field_id(fieldId);
         auto protoTernary = protoMatch->mutable_ternary();
-        protoTernary->set_value(*valueStr);
-        protoTernary->set_mask(*maskStr);
+        protoTernary->set_value(std::move(*valueStr));
+        protoTernary->set_mask(std::move(*maskStr));
     }
 
     void addRange(p4v1::TableEntry *protoEntry, int fieldId, const IR::Expression *k, int keyWidth,
@@ -1316,8 +1355,8 @@ class P4RuntimeEntriesConverter {
         auto protoMatch = protoEntry->add_match();
         protoMatch->set_field_id(fieldId);
         auto protoRange = protoMatch->mutable_range();
-        protoRange->set_low(*startStr);
-        protoRange->set_high(*endStr);
+        protoRange->set_low(std::move(*startStr));
+        protoRange->set_high(std::move(*endStr));
     }
 
     void addOptional(p4v1::TableEntry *protoEntry, int fieldId, const IR::Expression *k,
@@ -1329,7 +1368,7 @@ class P4RuntimeEntriesConverter {
         auto protoOptional = protoMatch->mutable_optional();
         auto value = convertSimpleKeyExpression(k, keyWidth, typeMap);
         if (value == std::nullopt) return;
-        protoOptional->set_value(*value);
+        protoOptional->set_value(std::move(*value));
     }
 
     cstring getKeyMatchType(const IR::KeyElement *ke, ReferenceMap *refMap) const {
@@ -1349,7 +1388,8 @@ class P4RuntimeEntriesConverter {
                                                      const IR::ToplevelBlock *evaluatedProgram,
                                                      ReferenceMap *refMap, TypeMap *typeMap,
                                                      P4RuntimeArchHandlerIface *archHandler,
-                                                     cstring arch) {
+                                                     cstring arch,
+                                                     const p4configv1::P4Info *previous) {
     using namespace ControlPlaneAPI;
 
     CHECK_NULL(archHandler);
@@ -1357,7 +1397,7 @@ class P4RuntimeEntriesConverter {
     // Perform a first pass to collect all of the control plane visible symbols in
     // the program.
     const auto *symbols = P4RuntimeSymbolTable::generateSymbols(program, evaluatedProgram, refMap,
-                                                                typeMap, archHandler);
+                                                                typeMap, archHandler, previous);
 
     archHandler->postCollect(*symbols);
 
@@ -1446,7 +1486,7 @@ P4RuntimeAPI P4RuntimeSerializer::generateP4Runtime(const IR::P4Program *program
     auto archHandler = (*archHandlerBuilderIt->second)(&refMap, &typeMap, evaluatedProgram);
 
     return P4RuntimeAnalyzer::analyze(p4RuntimeProgram, evaluatedProgram, &refMap, &typeMap,
-                                      archHandler, arch);
+                                      archHandler, arch, previousP4Info);
 }
 
 void P4RuntimeAPI::serializeP4InfoTo(std::ostream *destination, P4RuntimeFormat format) const {
@@ -1465,26 +1505,41 @@ void P4RuntimeAPI::serializeP4InfoTo(std::ostream *destination, P4RuntimeFormat
         case P4RuntimeFormat::TEXT:
             success = writers::writeTextTo(*p4Info, destination);
             break;
+        case P4RuntimeFormat::INDEXED:
+            success = IndexedP4Info::writeTo(*p4Info, destination);
+            break;
     }
     if (!success) ::error(ErrorType::ERR_IO, "Failed to serialize the P4Runtime API to the output");
 }
 
-void P4RuntimeAPI::serializeEntriesTo(std::ostream *destination, P4RuntimeFormat format) const {
+void P4RuntimeAPI::serializeEntriesTo(std::ostream *destination, P4RuntimeFormat format,
+                                      size_t chunkSize) const {
     using namespace ControlPlaneAPI;
 
     bool success = true;
-    // Write the serialization out in the requested format.
+    // Write the serialization out in the requested format. Text files are not split, as the
+    // text format has no way of delimiting messages.
     switch (format) {
         case P4RuntimeFormat::BINARY:
-            success = writers::writeTo(*entries, destination);
+            success = chunkSize > 0 ? writers::writeChunksTo(*entries, chunkSize, format,
+                                                             destination, jsonPrintOptions)
+                                    : writers::writeTo(*entries, destination);
             break;
         case P4RuntimeFormat::JSON:
-            success = writers::writeJsonTo(*entries, destination, jsonPrintOptions);
+            success = chunkSize > 0
+                          ? writers::writeChunksTo(*entries, chunkSize, format, destination,
+                                                   jsonPrintOptions)
+                          : writers::writeJsonTo(*entries, destination, jsonPrintOptions);
             break;
         case P4RuntimeFormat::TEXT_PROTOBUF:
         case P4RuntimeFormat::TEXT:
             success = writers::writeTextTo(*entries, destination);
             break;
+        case P4RuntimeFormat::INDEXED:
+            ::error(ErrorType::ERR_UNSUPPORTED,
+                    "The indexed format is only available for the P4Info, not for the P4Runtime "
+                    "static table entries");
+            return;
     }
     if (!success)
         ::error(ErrorType::ERR_IO,
@@ -1511,6 +1566,8 @@ static bool parseFileNames(cstring fileNameVector, std::vector<cstring> &files,
                 formats.push_back(P4::P4RuntimeFormat::BINARY);
             } else if (suffix == ".txtpb") {
                 formats.push_back(P4::P4RuntimeFormat::TEXT_PROTOBUF);
+            } else if (suffix == ".p4idx") {
+                formats.push_back(P4::P4RuntimeFormat::INDEXED);
             } else if (suffix == ".txt") {
                 ::warning(ErrorType::WARN_DEPRECATED,
                           ".txt format is being deprecated; use .txtpb instead");
@@ -1523,7 +1580,8 @@ static bool parseFileNames(cstring fileNameVector, std::vector<cstring> &files,
             }
         } else {
             ::error(ErrorType::ERR_UNKNOWN,
-                    "%1%: unknown file kind; known suffixes are .bin, .txt, .json, and .txtpb",
+                    "%1%: unknown file kind; known suffixes are .bin, .txt, .json, .txtpb and "
+                    ".p4idx",
                     name);
             return false;
         }
@@ -1537,11 +1595,8 @@ void P4RuntimeSerializer::serializeP4RuntimeIfRequired(const IR::P4Program *prog
     std::vector<P4::P4RuntimeFormat> formats;
 
     // only generate P4Info is required by use-provided options
-    if (options.p4RuntimeFile.isNullOrEmpty() && options.p4RuntimeFiles.isNullOrEmpty() &&
-        options.p4RuntimeEntriesFile.isNullOrEmpty() &&
-        options.p4RuntimeEntriesFiles.isNullOrEmpty()) {
-        return;
-    }
+    if (!isRequired(options)) return;
+    readPreviousP4Info(options);
     auto arch = P4RuntimeSerializer::resolveArch(options);
     if (Log::verbose())
         std::cout << "Generating P4Runtime output for architecture " << arch << std::endl;
@@ -1573,6 +1628,19 @@ void P4RuntimeSerializer::serializeP4RuntimeIfRequired(const P4RuntimeAPI &p4Run
         }
     }
 
+    if (!options.p4RuntimeDiffFile.isNullOrEmpty()) {
+        readPreviousP4Info(options);
+        if (previousP4Info == nullptr) {
+            ::error(ErrorType::ERR_INVALID,
+                    "'--p4runtime-diff' requires a previous P4Info, given with "
+                    "'--p4runtime-previous'");
+        } else if (std::ostream *out = openFile(options.p4RuntimeDiffFile, false)) {
+            ControlPlaneAPI::diffP4Info(*previousP4Info, *p4Runtime.p4Info)->serialize(*out);
+            *out << std::endl;
+            out->flush();
+        }
+    }
+
     // Do the same for the entries files
     files.clear();
     formats.clear();
@@ -1592,7 +1660,7 @@ void P4RuntimeSerializer::serializeP4RuntimeIfRequired(const P4RuntimeAPI &p4Run
                         options.p4RuntimeEntriesFile);
                 continue;
             }
-            p4Runtime.serializeEntriesTo(out, format);
+            p4Runtime.serializeEntriesTo(out, format, options.p4RuntimeEntriesChunkSize);
         }
     }
 }
@@ -1609,6 +1677,21 @@ P4RuntimeSerializer *P4RuntimeSerializer::get() {
     return &instance;
 }
 
+bool P4RuntimeSerializer::isRequired(const CompilerOptions &options) {
+    return !options.p4RuntimeFile.isNullOrEmpty() || !options.p4RuntimeFiles.isNullOrEmpty() ||
+           !options.p4RuntimeEntriesFile.isNullOrEmpty() ||
+           !options.p4RuntimeEntriesFiles.isNullOrEmpty() ||
+           !options.p4RuntimeDiffFile.isNullOrEmpty();
+}
+
+void P4RuntimeSerializer::readPreviousP4Info(const CompilerOptions &options) {
+    if (options.p4RuntimePreviousFile.isNullOrEmpty() ||
+        options.p4RuntimePreviousFile == previousP4InfoFile)
+        return;
+    previousP4InfoFile = options.p4RuntimePreviousFile;
+    previousP4Info = ControlPlaneAPI::readP4Info(previousP4InfoFile);
+}
+
 cstring P4RuntimeSerializer::resolveArch(const CompilerOptions &options) {
     if (auto arch = getenv("P4C_DEFAULT_ARCH")) {
         return cstring(arch);
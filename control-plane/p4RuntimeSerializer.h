@@ -23,6 +23,7 @@ limitations under the License.
 #include <google/protobuf/util/json_util.h>
 #pragma GCC diagnostic pop
 
+#include <cstddef>
 #include <iosfwd>
 #include <unordered_map>
 
@@ -56,7 +57,11 @@ struct P4RuntimeAPI {
     void serializeP4InfoTo(std::ostream *destination, P4RuntimeFormat format) const;
     /// Serialize the WriteRequest message containing all the table entries to
     /// the @destination stream in the requested protobuf serialization @format.
-    void serializeEntriesTo(std::ostream *destination, P4RuntimeFormat format) const;
+    /// If @chunkSize is not 0, the entries are instead written as a sequence of
+    /// WriteRequest messages of at most @chunkSize updates each, which the
+    /// switch agent can apply one at a time, in the binary and JSON formats.
+    void serializeEntriesTo(std::ostream *destination, P4RuntimeFormat format,
+                            size_t chunkSize = 0) const;
 
     /// A P4Runtime P4Info message, which encodes the control-plane API of the
     /// program. Never null.
@@ -126,6 +131,15 @@ class P4RuntimeSerializer {
     void serializeP4RuntimeIfRequired(const P4RuntimeAPI &p4Runtime,
                                       const CompilerOptions &options);
 
+    /// Reads the P4Info given with '--p4runtime-previous' in @options, if any
+    /// and if it was not read yet. P4Runtime APIs generated afterwards reuse
+    /// its ids.
+    void readPreviousP4Info(const CompilerOptions &options);
+
+    /// @return true if the command-line @options request P4Info, static
+    /// entries or P4Info diff files.
+    static bool isRequired(const CompilerOptions &options);
+
     /// @return architecture name based on provided command-line @options and
     /// environment.
     static cstring resolveArch(const CompilerOptions &options);
@@ -135,6 +149,10 @@ class P4RuntimeSerializer {
 
     std::unordered_map<cstring, const ControlPlaneAPI::P4RuntimeArchHandlerBuilderIface *>
         archHandlerBuilders{};
+
+    /// The P4Info given with '--p4runtime-previous', or nullptr.
+    const ::p4::config::v1::P4Info *previousP4Info = nullptr;
+    cstring previousP4InfoFile = nullptr;
 };
 
 /// Calls @ref P4RuntimeSerializer::generateP4Runtime on the @ref
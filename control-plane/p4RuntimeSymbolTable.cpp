@@ -15,9 +15,13 @@ limitations under the License.
 */
 #include "p4RuntimeSymbolTable.h"
 
+#include <algorithm>
+
 #include "absl/strings/str_split.h"
+#include "control-plane/p4infoApi.h"
 #include "lib/cstring.h"
 #include "lib/iterator_range.h"
+#include "lib/log.h"
 #include "p4RuntimeArchHandler.h"
 #include "typeSpecConverter.h"
 
@@ -149,8 +153,9 @@ void collectParserSymbols(P4RuntimeSymbolTable &symbols, const IR::ParserBlock *
 P4::ControlPlaneAPI::P4RuntimeSymbolTable *
 P4::ControlPlaneAPI::P4RuntimeSymbolTable::generateSymbols(
     const IR::P4Program *program, const IR::ToplevelBlock *evaluatedProgram, ReferenceMap *refMap,
-    TypeMap *typeMap, P4RuntimeArchHandlerIface *archHandler) {
-    return P4RuntimeSymbolTable::create([=](P4RuntimeSymbolTable &symbols) {
+    TypeMap *typeMap, P4RuntimeArchHandlerIface *archHandler,
+    const ::p4::config::v1::P4Info *previous) {
+    auto collect = [=](P4RuntimeSymbolTable &symbols) {
         Helpers::forAllEvaluatedBlocks(evaluatedProgram, [&](const IR::Block *block) {
             if (block->is<IR::ControlBlock>()) {
                 collectControlSymbols(symbols, archHandler, block->to<IR::ControlBlock>(), refMap,
@@ -169,7 +174,8 @@ P4::ControlPlaneAPI::P4RuntimeSymbolTable::generateSymbols(
             }
         });
         archHandler->collectExtra(&symbols);
-    });
+    };
+    return P4RuntimeSymbolTable::create(collect, previous);
 }
 
 void P4::ControlPlaneAPI::P4RuntimeSymbolTable::add(P4RuntimeSymbolType type,
@@ -239,20 +245,17 @@ void P4::ControlPlaneAPI::P4RuntimeSymbolTable::computeIdsForSymbols(P4RuntimeSy
     auto resourceType = static_cast<p4rt_id_t>(type);
 
     // Extract the names of every resource in the collection that does not
-    // already have an id assigned and associate them with an iterator that
-    // we can use to access them again later.  The names are stored in a
-    // std::map to ensure that they're sorted. This is necessary to provide
+    // already have an id assigned and associate them with the id that we
+    // update later. The names are sorted. This is necessary to provide
     // deterministic ids; see below for details.
-    std::map<cstring, SymbolTable::iterator> nameToIteratorMap;
-    for (auto it = symbolTable.begin(); it != symbolTable.end(); it++) {
-        if (it->second == INVALID_ID) {
-            nameToIteratorMap.emplace(std::make_pair(it->first, it));
-        }
+    std::vector<std::pair<cstring, p4rt_id_t *>> unassigned;
+    for (auto &[name, id] : symbolTable) {
+        if (id == INVALID_ID) unassigned.emplace_back(name, &id);
     }
+    std::sort(unassigned.begin(), unassigned.end(),
+              [](const auto &a, const auto &b) { return a.first < b.first; });
 
-    for (const auto &mapping : nameToIteratorMap) {
-        const cstring name = mapping.first;
-        const auto iterator = mapping.second;
+    for (const auto &[name, symbolId] : unassigned) {
         const uint32_t nameId = jenkinsOneAtATimeHash(name.c_str(), name.size());
 
         // Hash the name and construct an id. Because linear probing is used
@@ -270,7 +273,29 @@ void P4::ControlPlaneAPI::P4RuntimeSymbolTable::computeIdsForSymbols(P4RuntimeSy
 
         // Update the resource in place with the new id.
         assignedIds.insert(*id);
-        iterator->second = *id;
+        *symbolId = *id;
+    }
+}
+
+void P4::ControlPlaneAPI::P4RuntimeSymbolTable::reuseIds(
+    const ::p4::config::v1::P4Info &previous) {
+    // The type of an object is the 8-bit prefix of its id.
+    std::unordered_map<std::pair<p4rt_id_t, cstring>, p4rt_id_t, Util::Hash> previousIds;
+    forAllP4InfoObjects(previous, [&](cstring, const ::p4::config::v1::Preamble &preamble,
+                                      const google::protobuf::Message &) {
+        previousIds.emplace(std::make_pair(preamble.id() >> 24, cstring(preamble.name())),
+                            preamble.id());
+    });
+
+    for (auto &[type, symbolTable] : symbolTables) {
+        auto resourceType = static_cast<p4rt_id_t>(type);
+        for (auto &[name, id] : symbolTable) {
+            if (id != INVALID_ID) continue;
+            auto it = previousIds.find({resourceType, name});
+            if (it == previousIds.end() || !assignedIds.insert(it->second).second) continue;
+            LOG3("Reusing id " << it->second << " of " << name);
+            id = it->second;
+        }
     }
 }
 
@@ -291,18 +316,18 @@ uint32_t P4::ControlPlaneAPI::P4RuntimeSymbolTable::jenkinsOneAtATimeHash(const
 
 cstring P4::ControlPlaneAPI::P4SymbolSuffixSet::shortestUniqueSuffix(const cstring &symbol) const {
     BUG_CHECK(!symbol.isNullOrEmpty(), "Null or empty symbol name?");
-    const char *cSymbol = symbol.c_str();
-    std::vector<cstring> components = absl::StrSplit(cSymbol, '.');
+    std::string_view text(symbol.c_str(), symbol.size());
+    std::vector<std::string_view> components = absl::StrSplit(text, '.');
 
     // Determine how many suffix components we need to uniquely identify
     // this symbol. For example, if we have the symbols "d.a.c" and "e.b.c",
     // the suffixes "a.c" and "b.c" are enough to identify the symbols
     // uniquely, so in both cases we only need two components.
     unsigned neededComponents = 0;
-    auto *node = suffixesRoot;
+    unsigned node = 0;
     for (auto &component : Util::iterator_range(components).reverse()) {
-        auto it = node->edges.find(component);
-        BUG_CHECK(it != node->edges.end(), "Symbol is not in suffix set: %1%", symbol);
+        auto it = edges.find({node, component});
+        BUG_CHECK(it != edges.end(), "Symbol is not in suffix set: %1%", symbol);
 
         node = it->second;
         neededComponents++;
@@ -310,24 +335,17 @@ cstring P4::ControlPlaneAPI::P4SymbolSuffixSet::shortestUniqueSuffix(const cstri
         // If there's only one suffix that passes through this node, we have
         // a unique suffix right now, and we don't need the remaining
         // components.
-        if (node->instances < 2) {
+        if (instances[node] < 2) {
             break;
         }
     }
 
-    // Serialize the suffix components into the final unique suffix that
-    // we'll return.
+    // The unique suffix is the tail of the symbol that starts with the first
+    // of the needed components.
     BUG_CHECK(neededComponents <= components.size(), "Too many components?");
-    std::string uniqueSuffix;
-    std::for_each(components.end() - neededComponents, components.end(),
-                  [&](const auto &component) {
-                      if (!uniqueSuffix.empty()) {
-                          uniqueSuffix.append(".");
-                      }
-                      uniqueSuffix.append(component);
-                  });
-
-    return uniqueSuffix;
+    if (neededComponents == components.size()) return symbol;
+    const auto &first = components[components.size() - neededComponents];
+    return cstring(text.substr(first.data() - text.data()));
 }
 
 void P4::ControlPlaneAPI::P4SymbolSuffixSet::addSymbol(const cstring &symbol) {
@@ -350,8 +368,8 @@ void P4::ControlPlaneAPI::P4SymbolSuffixSet::addSymbol(const cstring &symbol) {
     }
 
     // Split the symbol name into dot-separated components.
-    const char *cSymbol = symbol.c_str();
-    std::vector<cstring> components = absl::StrSplit(cSymbol, '.');
+    std::vector<std::string_view> components =
+        absl::StrSplit(std::string_view(symbol.c_str(), symbol.size()), '.');
 
     // Insert the components into our tree of suffixes. We work
     // right-to-left through the symbol name, since we're concerned with
@@ -361,12 +379,12 @@ void P4::ControlPlaneAPI::P4SymbolSuffixSet::addSymbol(const cstring &symbol) {
     //   (root) -> "c" -> (3) -> "b" -> (2) -> "a" -> (1)
     //                       \-> "d" -> (1) -> "a" -> (1)
     // (Nodes are in parentheses, and edge labels are in quotes.)
-    auto *node = suffixesRoot;
+    unsigned node = 0;
     for (auto &component : Util::iterator_range(components).reverse()) {
-        auto [it, inserted] = node->edges.emplace(component, nullptr);
-        if (inserted) it->second = new SuffixNode;
+        auto [it, inserted] = edges.emplace(std::make_pair(node, component), instances.size());
+        if (inserted) instances.push_back(0);
         node = it->second;
-        node->instances++;
+        instances[node]++;
     }
 }
 
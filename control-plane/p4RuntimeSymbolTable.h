@@ -17,7 +17,14 @@ limitations under the License.
 #ifndef CONTROL_PLANE_P4RUNTIMESYMBOLTABLE_H_
 #define CONTROL_PLANE_P4RUNTIMESYMBOLTABLE_H_
 
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include "lib/cstring.h"
+#include "lib/hash.h"
 #include "p4RuntimeArchHandler.h"
 #include "typeSpecConverter.h"
 
@@ -67,25 +74,23 @@ struct P4SymbolSuffixSet {
  private:
     // All symbols in the set. We store these separately to make sure that no
     // symbol is added to the tree of suffixes more than once.
-    std::set<cstring> symbols;
-
-    // A node in the tree of suffixes. The tree of suffixes is a directed graph
-    // of path components, with the edges pointing from the each component to
-    // its predecessor, so that every suffix of every symbol corresponds to a
-    // path through the tree. For example, "foo.bar[1].baz" would be represented
-    // as "baz" -> "bar[1]" -> "foo".
-    struct SuffixNode {
-        // How many suffixes pass through this node? This includes suffixes that
-        // terminate at this node.
-        unsigned instances = 0;
-
-        // Outgoing edges from this node. The SuffixNode should never be null.
-        std::map<cstring, SuffixNode *> edges;
-    };
-
-    // The root of our tree of suffixes. Note that this is *not* the data
-    // structure known as a suffix tree.
-    SuffixNode *suffixesRoot = new SuffixNode;
+    std::unordered_set<cstring> symbols;
+
+    // The tree of suffixes is a directed graph of path components, with the
+    // edges pointing from the each component to its predecessor, so that
+    // every suffix of every symbol corresponds to a path through the tree. For
+    // example, "foo.bar[1].baz" would be represented as "baz" -> "bar[1]" ->
+    // "foo". Note that this is *not* the data structure known as a suffix tree.
+    //
+    // The nodes are numbered, with the root as node 0. For each node, we
+    // record how many suffixes pass through it, including suffixes that
+    // terminate at it.
+    std::vector<unsigned> instances = {0};
+
+    // The outgoing edges of all the nodes, from a node and a component to the
+    // next node. The components point into the symbols, whose storage is never
+    // freed, so that they do not have to be interned.
+    std::unordered_map<std::pair<unsigned, std::string_view>, unsigned, Util::Hash> edges;
 };
 
 /// A table which tracks the symbols which are visible to P4Runtime and their
@@ -104,16 +109,22 @@ class P4RuntimeSymbolTable : public P4RuntimeSymbolTableIface {
      * needed. To ensure that no code accidentally adds new symbols after ids
      * are assigned, create() enforces that only code that runs before id
      * assignment has access to a non-const reference to the symbol table.
+     *
+     * If a @previous P4Info is given, symbols without an '@id' keep the id
+     * they have there, if it is still available.
      */
     template <typename Func>
-    static P4RuntimeSymbolTable *create(Func function) {
+    static P4RuntimeSymbolTable *create(Func function,
+                                        const ::p4::config::v1::P4Info *previous = nullptr) {
         // Create and initialize the symbol table. At this stage, ids aren't
         // available, because computing ids requires global knowledge of all the
         // P4Runtime symbols in the program.
         auto *symbols = new P4RuntimeSymbolTable();
         function(*symbols);
 
-        // Now that the symbol table is initialized, we can compute ids.
+        // Now that the symbol table is initialized, we can compute ids. The
+        // previous ids are reused first, so that no hashed id takes them.
+        if (previous != nullptr) symbols->reuseIds(*previous);
         for (auto &table : symbols->symbolTables) {
             symbols->computeIdsForSymbols(table.first);
         }
@@ -121,10 +132,10 @@ class P4RuntimeSymbolTable : public P4RuntimeSymbolTableIface {
         return symbols;
     }
 
-    static P4RuntimeSymbolTable *generateSymbols(const IR::P4Program *program,
-                                                 const IR::ToplevelBlock *evaluatedProgram,
-                                                 ReferenceMap *refMap, TypeMap *typeMap,
-                                                 P4RuntimeArchHandlerIface *archHandler);
+    static P4RuntimeSymbolTable *generateSymbols(
+        const IR::P4Program *program, const IR::ToplevelBlock *evaluatedProgram,
+        ReferenceMap *refMap, TypeMap *typeMap, P4RuntimeArchHandlerIface *archHandler,
+        const ::p4::config::v1::P4Info *previous = nullptr);
 
     /// Add a @type symbol, extracting the name and id from @declaration.
     void add(P4RuntimeSymbolType type, const IR::IDeclaration *declaration) override;
@@ -162,6 +173,10 @@ class P4RuntimeSymbolTable : public P4RuntimeSymbolTableIface {
      */
     void computeIdsForSymbols(P4RuntimeSymbolType type);
 
+    /// Assign to each symbol that does not yet have an id the id of the object
+    /// of the same type and name in @previous, unless another symbol has it.
+    void reuseIds(const ::p4::config::v1::P4Info &previous);
+
     /**
      * Construct an id from the provided @sourceValue using the provided
      * function
@@ -194,10 +209,10 @@ class P4RuntimeSymbolTable : public P4RuntimeSymbolTableIface {
     // All the ids we've assigned so far. Used to avoid id collisions; this is
     // especially crucial since ids can be set manually via the '@id'
     // annotation.
-    std::set<p4rt_id_t> assignedIds;
+    std::unordered_set<p4rt_id_t> assignedIds;
 
     // Symbol tables, mapping symbols to P4Runtime ids.
-    using SymbolTable = std::map<cstring, p4rt_id_t>;
+    using SymbolTable = std::unordered_map<cstring, p4rt_id_t>;
     std::map<P4RuntimeSymbolType, SymbolTable> symbolTables{};
 
     // A set which contains all the symbols in the program. It's used to compute
@@ -19,8 +19,9 @@ limitations under the License.
 
 namespace P4 {
 
-/// P4Runtime serialization formats.
-enum class P4RuntimeFormat { BINARY, JSON, TEXT, TEXT_PROTOBUF };
+/// P4Runtime serialization formats. INDEXED is only available for the P4Info; see
+/// ControlPlaneAPI::IndexedP4Info.
+enum class P4RuntimeFormat { BINARY, JSON, TEXT, TEXT_PROTOBUF, INDEXED };
 
 }  // namespace P4
 
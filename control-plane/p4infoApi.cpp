@@ -1,11 +1,20 @@
 #include "control-plane/p4infoApi.h"
 
+#include <fstream>
 #include <functional>
+#include <map>
+#include <sstream>
+#include <utility>
 
+#include "control-plane/indexedP4Info.h"
 #include "control-plane/p4RuntimeArchStandard.h"
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 #pragma GCC diagnostic ignored "-Wpedantic"
+#include <google/protobuf/text_format.h>
+#include <google/protobuf/util/json_util.h>
+#include <google/protobuf/util/message_differencer.h>
+
 #include "p4/config/v1/p4info.pb.h"
 #pragma GCC diagnostic pop
 
@@ -282,4 +291,130 @@ std::optional<p4rt_id_t> getP4RuntimeId(const p4::config::v1::P4Info &p4Info,
     return std::nullopt;
 }
 
+void forAllP4InfoObjects(const p4::config::v1::P4Info &p4Info,
+                         const std::function<void(cstring kind,
+                                                  const p4::config::v1::Preamble &preamble,
+                                                  const google::protobuf::Message &object)>
+                             &function) {
+    auto forAll = [&](cstring kind, const auto &objects) {
+        for (const auto &object : objects) function(kind, object.preamble(), object);
+    };
+    forAll("tables", p4Info.tables());
+    forAll("actions", p4Info.actions());
+    forAll("action_profiles", p4Info.action_profiles());
+    forAll("counters", p4Info.counters());
+    forAll("direct_counters", p4Info.direct_counters());
+    forAll("meters", p4Info.meters());
+    forAll("direct_meters", p4Info.direct_meters());
+    forAll("controller_packet_metadata", p4Info.controller_packet_metadata());
+    forAll("value_sets", p4Info.value_sets());
+    forAll("registers", p4Info.registers());
+    forAll("digests", p4Info.digests());
+    for (const auto &p4Extern : p4Info.externs())
+        forAll(p4Extern.extern_type_name(), p4Extern.instances());
+}
+
+const p4::config::v1::P4Info *readP4Info(cstring file) {
+    std::ifstream in(file.c_str(), std::ios::binary);
+    if (!in) {
+        ::error(ErrorType::ERR_IO, "%1%: cannot open P4Info file", file);
+        return nullptr;
+    }
+    auto *p4Info = new p4::config::v1::P4Info();
+    bool success = false;
+    if (file.endsWith(".bin")) {
+        success = p4Info->ParseFromIstream(&in);
+    } else if (file.endsWith(".p4idx")) {
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        std::string contents = buffer.str();
+        IndexedP4Info::View view(contents.data(), contents.size());
+        auto serialized = view.p4Info();
+        success = view.valid() && p4Info->ParseFromArray(serialized.data(), serialized.size());
+    } else {
+        std::stringstream contents;
+        contents << in.rdbuf();
+        if (file.endsWith(".json")) {
+            success = google::protobuf::util::JsonStringToMessage(contents.str(), p4Info).ok();
+        } else if (file.endsWith(".txtpb") || file.endsWith(".txt")) {
+            success = google::protobuf::TextFormat::ParseFromString(contents.str(), p4Info);
+        } else {
+            ::error(ErrorType::ERR_UNKNOWN,
+                    "%1%: unknown P4Info file kind; known suffixes are .bin, .txt, .json, .txtpb "
+                    "and .p4idx",
+                    file);
+            return nullptr;
+        }
+    }
+    if (!success) {
+        ::error(ErrorType::ERR_INVALID, "%1%: invalid P4Info file", file);
+        return nullptr;
+    }
+    return p4Info;
+}
+
+Util::JsonObject *diffP4Info(const p4::config::v1::P4Info &previous,
+                             const p4::config::v1::P4Info &current) {
+    using Object = std::pair<const p4::config::v1::Preamble *, const google::protobuf::Message *>;
+    using Objects = std::map<std::pair<cstring, cstring>, Object>;
+    auto collect = [](const p4::config::v1::P4Info &p4Info) {
+        Objects objects;
+        forAllP4InfoObjects(p4Info, [&](cstring kind, const p4::config::v1::Preamble &preamble,
+                                        const google::protobuf::Message &object) {
+            objects.emplace(std::make_pair(kind, cstring(preamble.name())),
+                            Object(&preamble, &object));
+        });
+        return objects;
+    };
+    auto previousObjects = collect(previous);
+    auto currentObjects = collect(current);
+
+    auto describe = [](const Objects::value_type &entry) {
+        auto *json = new Util::JsonObject();
+        json->emplace("kind", entry.first.first);
+        json->emplace("name", entry.first.second);
+        json->emplace("id", entry.second.first->id());
+        return json;
+    };
+    auto *added = new Util::JsonArray();
+    auto *removed = new Util::JsonArray();
+    auto *modified = new Util::JsonArray();
+    for (const auto &entry : currentObjects) {
+        auto it = previousObjects.find(entry.first);
+        if (it == previousObjects.end())
+            added->append(describe(entry));
+        else if (!google::protobuf::util::MessageDifferencer::Equals(*it->second.second,
+                                                                     *entry.second.second))
+            modified->append(describe(entry));
+    }
+    for (const auto &entry : previousObjects)
+        if (!currentObjects.count(entry.first)) removed->append(describe(entry));
+
+    auto *diff = new Util::JsonObject();
+    diff->emplace("added", added);
+    diff->emplace("removed", removed);
+    diff->emplace("modified", modified);
+    return diff;
+}
+
+P4InfoIndex::P4InfoIndex(const p4::config::v1::P4Info &p4Info) {
+    tables.addAll(p4Info.tables());
+    for (const auto &table : p4Info.tables()) {
+        auto &fields = matchFields[&table];
+        for (const auto &field : table.match_fields()) fields.add(field.name(), field.id(), &field);
+    }
+    actions.addAll(p4Info.actions());
+    actionProfiles.addAll(p4Info.action_profiles());
+    counters.addAll(p4Info.counters());
+    directCounters.addAll(p4Info.direct_counters());
+    meters.addAll(p4Info.meters());
+    directMeters.addAll(p4Info.direct_meters());
+    controllerPacketMetadata.addAll(p4Info.controller_packet_metadata());
+    valueSets.addAll(p4Info.value_sets());
+    registers.addAll(p4Info.registers());
+    digests.addAll(p4Info.digests());
+    for (const auto &p4Extern : p4Info.externs())
+        externs.add(p4Extern.extern_type_name(), p4Extern.extern_type_id(), &p4Extern);
+}
+
 }  // namespace P4::ControlPlaneAPI
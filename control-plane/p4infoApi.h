@@ -1,11 +1,14 @@
 #ifndef CONTROL_PLANE_P4INFOAPI_H_
 #define CONTROL_PLANE_P4INFOAPI_H_
 
+#include <functional>
 #include <optional>
+#include <unordered_map>
 
 #include "control-plane/p4RuntimeArchHandler.h"
 #include "control-plane/p4RuntimeSerializer.h"
 #include "lib/cstring.h"
+#include "lib/json.h"
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -180,6 +183,132 @@ const p4::config::v1::Extern *findP4RuntimeExtern(const p4::config::v1::P4Info &
 std::optional<p4rt_id_t> getP4RuntimeId(const p4::config::v1::P4Info &p4Info,
                                         const P4RuntimeSymbolType &type, cstring controlPlaneName);
 
+/// Calls @p function on each object of @p p4Info that has a preamble, with the kind of the
+/// object, which is the name of its P4Info field (e.g. "tables"), or the extern type name for
+/// the instances of an extern.
+void forAllP4InfoObjects(const p4::config::v1::P4Info &p4Info,
+                         const std::function<void(cstring kind,
+                                                  const p4::config::v1::Preamble &preamble,
+                                                  const google::protobuf::Message &object)>
+                             &function);
+
+/// Reads a P4Info message from @p file, in the format given by its suffix: .bin, .json, .txtpb,
+/// .txt or .p4idx. @returns nullptr, after reporting an error, if the file cannot be read.
+const p4::config::v1::P4Info *readP4Info(cstring file);
+
+/// @returns a report, for a controller reconfiguring a switch from @p previous to @p current,
+/// of the objects that were added, removed or modified. Objects are matched by kind (see
+/// forAllP4InfoObjects) and by name, and each is listed with its kind, name and id.
+Util::JsonObject *diffP4Info(const p4::config::v1::P4Info &previous,
+                             const p4::config::v1::P4Info &current);
+
+/// An index of the objects of a P4Info by control plane name and by id. The find functions
+/// above scan the P4Info on each call; code that looks up many objects should build an index
+/// once instead. The index points into the P4Info it is built from, which must outlive it and
+/// must not be modified. Like the find functions, it @returns nullptr for unknown objects and
+/// the first object when several have the same name or id.
+class P4InfoIndex {
+    template <typename T>
+    class Objects {
+        std::unordered_map<cstring, const T *> byName;
+        std::unordered_map<p4rt_id_t, const T *> byId;
+
+     public:
+        void add(cstring name, p4rt_id_t id, const T *object) {
+            byName.emplace(name, object);
+            byId.emplace(id, object);
+        }
+        template <typename Range>
+        void addAll(const Range &objects) {
+            for (const auto &object : objects)
+                add(object.preamble().name(), object.preamble().id(), &object);
+        }
+        const T *find(cstring name) const {
+            auto it = byName.find(name);
+            return it == byName.end() ? nullptr : it->second;
+        }
+        const T *find(p4rt_id_t id) const {
+            auto it = byId.find(id);
+            return it == byId.end() ? nullptr : it->second;
+        }
+    };
+
+    Objects<p4::config::v1::Table> tables;
+    /// The match fields of each table.
+    std::unordered_map<const p4::config::v1::Table *, Objects<p4::config::v1::MatchField>>
+        matchFields;
+    Objects<p4::config::v1::Action> actions;
+    Objects<p4::config::v1::ActionProfile> actionProfiles;
+    Objects<p4::config::v1::Counter> counters;
+    Objects<p4::config::v1::DirectCounter> directCounters;
+    Objects<p4::config::v1::Meter> meters;
+    Objects<p4::config::v1::DirectMeter> directMeters;
+    Objects<p4::config::v1::ControllerPacketMetadata> controllerPacketMetadata;
+    Objects<p4::config::v1::ValueSet> valueSets;
+    Objects<p4::config::v1::Register> registers;
+    Objects<p4::config::v1::Digest> digests;
+    Objects<p4::config::v1::Extern> externs;
+
+ public:
+    explicit P4InfoIndex(const p4::config::v1::P4Info &p4Info);
+
+    template <typename Key>
+    const p4::config::v1::Table *findTable(Key key) const {
+        return tables.find(key);
+    }
+    /// @returns the match field of @p table, which must come from the indexed P4Info.
+    template <typename Key>
+    const p4::config::v1::MatchField *findMatchField(const p4::config::v1::Table &table,
+                                                     Key key) const {
+        auto it = matchFields.find(&table);
+        return it == matchFields.end() ? nullptr : it->second.find(key);
+    }
+    template <typename Key>
+    const p4::config::v1::Action *findAction(Key key) const {
+        return actions.find(key);
+    }
+    template <typename Key>
+    const p4::config::v1::ActionProfile *findActionProfile(Key key) const {
+        return actionProfiles.find(key);
+    }
+    template <typename Key>
+    const p4::config::v1::Counter *findCounter(Key key) const {
+        return counters.find(key);
+    }
+    template <typename Key>
+    const p4::config::v1::DirectCounter *findDirectCounter(Key key) const {
+        return directCounters.find(key);
+    }
+    template <typename Key>
+    const p4::config::v1::Meter *findMeter(Key key) const {
+        return meters.find(key);
+    }
+    template <typename Key>
+    const p4::config::v1::DirectMeter *findDirectMeter(Key key) const {
+        return directMeters.find(key);
+    }
+    template <typename Key>
+    const p4::config::v1::ControllerPacketMetadata *findControllerPacketMetadata(Key key) const {
+        return controllerPacketMetadata.find(key);
+    }
+    template <typename Key>
+    const p4::config::v1::ValueSet *findValueSet(Key key) const {
+        return valueSets.find(key);
+    }
+    template <typename Key>
+    const p4::config::v1::Register *findRegister(Key key) const {
+        return registers.find(key);
+    }
+    template <typename Key>
+    const p4::config::v1::Digest *findDigest(Key key) const {
+        return digests.find(key);
+    }
+    template <typename Key>
+    const p4::config::v1::Extern *findExtern(Key key) const {
+        return externs.find(key);
+    }
+};
+
 }  // namespace P4::ControlPlaneAPI
 
 #endif /* CONTROL_PLANE_P4INFOAPI_H_ */
@@ -17,7 +17,6 @@ limitations under the License.
 #include "typeSpecConverter.h"
 
 #include <limits>
-#include <map>
 #include <string>
 
 #include "bytestrings.h"
@@ -92,6 +91,19 @@ TypeSpecConverter::TypeSpecConverter(const P4::ReferenceMap *refMap, P4::TypeMap
     CHECK_NULL(typeMap);
 }
 
+bool TypeSpecConverter::inTypeInfo(const IR::IDeclaration *decl) const {
+    if (p4RtTypeInfo == nullptr) return true;
+    auto name = std::string(decl->controlPlaneName());
+    if (decl->is<IR::Type_Struct>()) return p4RtTypeInfo->structs().count(name) != 0;
+    if (decl->is<IR::Type_Header>()) return p4RtTypeInfo->headers().count(name) != 0;
+    if (decl->is<IR::Type_HeaderUnion>()) return p4RtTypeInfo->header_unions().count(name) != 0;
+    if (decl->is<IR::Type_SerEnum>()) return p4RtTypeInfo->serializable_enums().count(name) != 0;
+    if (decl->is<IR::Type_Enum>()) return p4RtTypeInfo->enums().count(name) != 0;
+    if (decl->is<IR::Type_Error>()) return p4RtTypeInfo->has_error();
+    if (decl->is<IR::Type_Newtype>()) return p4RtTypeInfo->new_types().count(name) != 0;
+    return false;
+}
+
 bool TypeSpecConverter::preorder(const IR::Type *type) {
     ::error(ErrorType::ERR_UNEXPECTED, "Unexpected type %1%", type);
     map.emplace(type, new P4DataTypeSpec());
@@ -158,7 +170,7 @@ bool TypeSpecConverter::preorder(const IR::Type_Name *type) {
     } else {
         BUG("Unexpected named type %1%", type);
     }
-    visit(decl->getNode());
+    if (!inTypeInfo(decl)) visit(decl->getNode());
     map.emplace(type, typeSpec);
     return false;
 }
@@ -252,7 +264,7 @@ bool TypeSpecConverter::preorder(const IR::Type_Stack *type) {
     } else {
         BUG("Unexpected declaration %1%", decl);
     }
-    visit(decl->getNode());
+    if (!inTypeInfo(decl)) visit(decl->getNode());
     map.emplace(type, typeSpec);
     return false;
 }
@@ -280,11 +292,11 @@ bool TypeSpecConverter::preorder(const IR::Type_Struct *type) {
 }
 
 bool TypeSpecConverter::preorder(const IR::Type_Header *type) {
-    auto flattenedHeaderType = FlattenHeader::flatten(typeMap, type);
     if (p4RtTypeInfo) {
         auto name = std::string(type->controlPlaneName());
         auto headers = p4RtTypeInfo->mutable_headers();
         if (headers->find(name) == headers->end()) {
+            auto flattenedHeaderType = FlattenHeader::flatten(typeMap, type);
             auto headerTypeSpec = new p4configv1::P4HeaderTypeSpec();
             for (auto f : flattenedHeaderType->fields) {
                 auto fType = f->type;
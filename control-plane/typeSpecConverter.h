@@ -17,8 +17,8 @@ limitations under the License.
 #ifndef CONTROL_PLANE_TYPESPECCONVERTER_H_
 #define CONTROL_PLANE_TYPESPECCONVERTER_H_
 
-#include <map>
 #include <string>
+#include <unordered_map>
 
 #include "ir/ir.h"
 #include "ir/visitor.h"
@@ -52,11 +52,16 @@ class TypeSpecConverter : public Inspector {
     ::p4::config::v1::P4TypeInfo *p4RtTypeInfo;
     /// after translating an Expression to P4DataTypeSpec, save the result to
     /// 'map'.
-    std::map<const IR::Type *, ::p4::config::v1::P4DataTypeSpec *> map;
+    std::unordered_map<const IR::Type *, ::p4::config::v1::P4DataTypeSpec *> map;
 
     TypeSpecConverter(const P4::ReferenceMap *refMap, P4::TypeMap *typeMap,
                       ::p4::config::v1::P4TypeInfo *p4RtTypeInfo);
 
+    /// @returns true if the named type @decl is already in p4RtTypeInfo, or if there is no
+    /// p4RtTypeInfo to update. The type info is shared by all the conversions of a P4Info, so
+    /// that the declarations used by many tables, digests and registers are only walked once.
+    bool inTypeInfo(const IR::IDeclaration *decl) const;
+
     // fallback for unsupported types, should be unreachable
     bool preorder(const IR::Type *type) override;
 
@@ -0,0 +1,193 @@
+#include "frontends/common/compileServer.h"
+
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace P4 {
+
+namespace {
+
+/// Fills @p address with @p socketPath. @returns false if the path is too long.
+bool makeAddress(const char *socketPath, sockaddr_un &address) {
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path)) {
+        std::cerr << socketPath << ": socket path is too long" << std::endl;
+        return false;
+    }
+    strncpy(address.sun_path, socketPath, sizeof(address.sun_path) - 1);
+    return true;
+}
+
+bool writeAll(int fd, const char *data, size_t size) {
+    while (size > 0) {
+        auto written = write(fd, data, size);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+std::string readAll(int fd) {
+    std::string result;
+    char buf[1 << 16];
+    while (true) {
+        auto count = read(fd, buf, sizeof(buf));
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) return result;
+        result.append(buf, count);
+    }
+}
+
+/// Requests are a sequence of NUL-terminated fields: the number of arguments, the working
+/// directory and the arguments.
+std::vector<std::string> splitFields(const std::string &request) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    for (size_t end; (end = request.find('\0', start)) != std::string::npos; start = end + 1)
+        fields.push_back(request.substr(start, end - start));
+    return fields;
+}
+
+/// Runs the compilation requested on @p connection in a child process and sends its output
+/// and its exit status back. Runs in the process forked for the connection.
+int handle(int connection, const CompileServer::Compile &compile) {
+    auto fields = splitFields(readAll(connection));
+    if (fields.size() < 2 || fields.size() != std::stoul("0" + fields[0]) + 2) {
+        std::cerr << "Ignoring a malformed compile request" << std::endl;
+        return 1;
+    }
+    std::string reply(1, '\0');
+    auto pid = fork();
+    if (pid == 0) {
+        if (chdir(fields[1].c_str()) != 0) {
+            std::cerr << fields[1] << ": " << strerror(errno) << std::endl;
+            _exit(1);
+        }
+        dup2(connection, STDOUT_FILENO);
+        dup2(connection, STDERR_FILENO);
+        std::vector<char *> argv;
+        for (size_t idx = 2; idx < fields.size(); ++idx) argv.push_back(fields[idx].data());
+        argv.push_back(nullptr);
+        int status = compile(static_cast<int>(argv.size() - 1), argv.data());
+        // Run the exit handlers of the compilation, which also flush its output.
+        exit(status);
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) < 0) {
+        reply = "Unable to run the compilation" + reply + "1";
+    } else if (WIFSIGNALED(status)) {
+        reply = "Compilation terminated by signal " + std::to_string(WTERMSIG(status)) + "\n" +
+                reply + std::to_string(128 + WTERMSIG(status));
+    } else {
+        reply += std::to_string(WEXITSTATUS(status));
+    }
+    writeAll(connection, reply.data(), reply.size());
+    return 0;
+}
+
+}  // namespace
+
+int CompileServer::main(int argc, char *const argv[], const Compile &compile) {
+    if (argc >= 3 && strcmp(argv[1], "--compile-server") == 0) {
+        if (argc > 3) {
+            std::cerr << "--compile-server takes no other arguments" << std::endl;
+            return 1;
+        }
+        return serve(argv[2], compile);
+    }
+    if (argc >= 3 && strcmp(argv[1], "--compile-via") == 0) {
+        std::vector<char *> args = {argv[0]};
+        args.insert(args.end(), argv + 3, argv + argc);
+        args.push_back(nullptr);
+        return request(argv[2], static_cast<int>(args.size() - 1), args.data());
+    }
+    return compile(argc, argv);
+}
+
+int CompileServer::serve(const char *socketPath, const Compile &compile) {
+    sockaddr_un address;
+    if (!makeAddress(socketPath, address)) return 1;
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        std::cerr << "socket: " << strerror(errno) << std::endl;
+        return 1;
+    }
+    // Replace the socket of an earlier server.
+    std::error_code ec;
+    std::filesystem::remove(socketPath, ec);
+    if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(listener, SOMAXCONN) != 0) {
+        std::cerr << socketPath << ": " << strerror(errno) << std::endl;
+        close(listener);
+        return 1;
+    }
+    // Reap the processes of finished connections.
+    signal(SIGCHLD, SIG_IGN);
+    while (true) {
+        int connection = accept(listener, nullptr, nullptr);
+        if (connection < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "accept: " << strerror(errno) << std::endl;
+            close(listener);
+            return 1;
+        }
+        auto pid = fork();
+        if (pid == 0) {
+            close(listener);
+            // The connection process waits for its compilation.
+            signal(SIGCHLD, SIG_DFL);
+            // Skip the destructors of the global state of the server.
+            _exit(handle(connection, compile));
+        }
+        if (pid < 0) std::cerr << "fork: " << strerror(errno) << std::endl;
+        close(connection);
+    }
+}
+
+int CompileServer::request(const char *socketPath, int argc, char *const argv[]) {
+    sockaddr_un address;
+    if (!makeAddress(socketPath, address)) return 1;
+    int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connection < 0 ||
+        connect(connection, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+        std::cerr << socketPath << ": " << strerror(errno) << std::endl;
+        if (connection >= 0) close(connection);
+        return 1;
+    }
+    std::error_code ec;
+    std::string request = std::to_string(argc) + '\0' +
+                          std::filesystem::current_path(ec).string() + '\0';
+    for (int idx = 0; idx < argc; ++idx) request += std::string(argv[idx]) + '\0';
+    if (!writeAll(connection, request.data(), request.size())) {
+        std::cerr << socketPath << ": " << strerror(errno) << std::endl;
+        close(connection);
+        return 1;
+    }
+    shutdown(connection, SHUT_WR);
+    auto reply = readAll(connection);
+    close(connection);
+    auto end = reply.rfind('\0');
+    if (end == std::string::npos) {
+        std::cout << reply << "The compile server did not report an exit status" << std::endl;
+        return 1;
+    }
+    std::cout << reply.substr(0, end) << std::flush;
+    return std::stoi("0" + reply.substr(end + 1));
+}
+
+}  // namespace P4
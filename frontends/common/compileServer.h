@@ -0,0 +1,42 @@
+#ifndef FRONTENDS_COMMON_COMPILESERVER_H_
+#define FRONTENDS_COMMON_COMPILESERVER_H_
+
+#include <functional>
+
+namespace P4 {
+
+/// Lets a compiler binary serve compilations over a Unix socket, so that repeated compilations,
+/// e.g. from an IDE or a CI job, do not pay the start-up cost of the binary for every program.
+///
+///   p4test --compile-server /tmp/p4test.sock &
+///   p4test --compile-via /tmp/p4test.sock --top4 FrontEndLast prog.p4
+///
+/// The server forks one process per request from its own, already initialized process, so that
+/// each compilation starts from the same state: the compile context, the error counts and all
+/// the other global state of the compiler are never shared between compilations, and a crash
+/// only ends its own request. The compilation runs in the working directory of the client. Its
+/// standard output and standard error are merged and sent to the client, followed by a NUL
+/// byte and its exit status. Requests are served concurrently.
+class CompileServer {
+ public:
+    /// The compiler, called with the arguments of a compilation. @returns its exit status.
+    using Compile = std::function<int(int argc, char *const argv[])>;
+
+    /// Runs @p compile on @p argv, unless the first argument is --compile-server <socket>,
+    /// which serves compilations with @p compile until the process is killed, or
+    /// --compile-via <socket>, which sends the remaining arguments to a server.
+    /// @returns the exit status of the binary.
+    static int main(int argc, char *const argv[], const Compile &compile);
+
+    /// Serves compilations with @p compile on @p socketPath. Only returns on errors.
+    static int serve(const char *socketPath, const Compile &compile);
+
+    /// Sends @p argv, whose first element is the name of the binary, to the server on
+    /// @p socketPath and copies the output of the compilation to the standard output.
+    /// @returns the exit status of the compilation.
+    static int request(const char *socketPath, int argc, char *const argv[]);
+};
+
+}  // namespace P4
+
+#endif /* FRONTENDS_COMMON_COMPILESERVER_H_ */
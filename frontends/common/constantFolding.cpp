@@ -16,6 +16,8 @@ limitations under the License.
 
 #include "constantFolding.h"
 
+#include <functional>
+
 #include "frontends/common/options.h"
 #include "frontends/p4/enumInstance.h"
 #include "lib/big_int_util.h"
@@ -304,35 +306,51 @@ const IR::Constant *DoConstantFolding::cast(const IR::Constant *node, unsigned b
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::Add *e) {
-    return binary(e, [](big_int a, big_int b) -> big_int { return a + b; });
+    return binary(e, [](const big_int &a, const big_int &b) {
+        return Util::evaluate(a, b, std::plus<>());
+    });
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::AddSat *e) {
-    return binary(e, [](big_int a, big_int b) -> big_int { return a + b; }, true);
+    return binary(e, [](const big_int &a, const big_int &b) {
+        return Util::evaluate(a, b, std::plus<>());
+    }, true);
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::Sub *e) {
-    return binary(e, [](big_int a, big_int b) -> big_int { return a - b; });
+    return binary(e, [](const big_int &a, const big_int &b) {
+        return Util::evaluate(a, b, std::minus<>());
+    });
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::SubSat *e) {
-    return binary(e, [](big_int a, big_int b) -> big_int { return a - b; }, true);
+    return binary(e, [](const big_int &a, const big_int &b) {
+        return Util::evaluate(a, b, std::minus<>());
+    }, true);
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::Mul *e) {
-    return binary(e, [](big_int a, big_int b) -> big_int { return a * b; });
+    return binary(e, [](const big_int &a, const big_int &b) {
+        return Util::evaluate(a, b, std::multiplies<>());
+    });
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::BXor *e) {
-    return binary(e, [](big_int a, big_int b) -> big_int { return a ^ b; });
+    return binary(e, [](const big_int &a, const big_int &b) {
+        return Util::evaluate(a, b, std::bit_xor<>());
+    });
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::BAnd *e) {
-    return binary(e, [](big_int a, big_int b) -> big_int { return a & b; });
+    return binary(e, [](const big_int &a, const big_int &b) {
+        return Util::evaluate(a, b, std::bit_and<>());
+    });
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::BOr *e) {
-    return binary(e, [](big_int a, big_int b) -> big_int { return a | b; });
+    return binary(e, [](const big_int &a, const big_int &b) {
+        return Util::evaluate(a, b, std::bit_or<>());
+    });
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::Equ *e) { return compare(e); }
@@ -340,23 +358,31 @@ const IR::Node *DoConstantFolding::postorder(IR::Equ *e) { return compare(e); }
 const IR::Node *DoConstantFolding::postorder(IR::Neq *e) { return compare(e); }
 
 const IR::Node *DoConstantFolding::postorder(IR::Lss *e) {
-    return binary(e, [](big_int a, big_int b) -> big_int { return a < b; });
+    return binary(e, [](const big_int &a, const big_int &b) {
+        return Util::evaluate(a, b, std::less<>());
+    });
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::Grt *e) {
-    return binary(e, [](big_int a, big_int b) -> big_int { return a > b; });
+    return binary(e, [](const big_int &a, const big_int &b) {
+        return Util::evaluate(a, b, std::greater<>());
+    });
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::Leq *e) {
-    return binary(e, [](big_int a, big_int b) -> big_int { return a <= b; });
+    return binary(e, [](const big_int &a, const big_int &b) {
+        return Util::evaluate(a, b, std::less_equal<>());
+    });
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::Geq *e) {
-    return binary(e, [](big_int a, big_int b) -> big_int { return a >= b; });
+    return binary(e, [](const big_int &a, const big_int &b) {
+        return Util::evaluate(a, b, std::greater_equal<>());
+    });
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::Div *e) {
-    return binary(e, [e](big_int a, big_int b) -> big_int {
+    return binary(e, [e](const big_int &a, const big_int &b) -> big_int {
         if (a < 0 || b < 0) {
             ::error(ErrorType::ERR_INVALID, "%1%: Division is not defined for negative numbers", e);
             return 0;
@@ -370,7 +396,7 @@ const IR::Node *DoConstantFolding::postorder(IR::Div *e) {
 }
 
 const IR::Node *DoConstantFolding::postorder(IR::Mod *e) {
-    return binary(e, [e](big_int a, big_int b) -> big_int {
+    return binary(e, [e](const big_int &a, const big_int &b) -> big_int {
         if (a < 0 || b < 0) {
             ::error(ErrorType::ERR_INVALID, "%1%: Modulo is not defined for negative numbers", e);
             return 0;
@@ -437,14 +463,18 @@ const IR::Node *DoConstantFolding::compare(const IR::Operation_Binary *e) {
     }
 
     if (eqTest)
-        return binary(e, [](big_int a, big_int b) -> big_int { return a == b; });
+        return binary(e, [](const big_int &a, const big_int &b) {
+            return Util::evaluate(a, b, std::equal_to<>());
+        });
     else
-        return binary(e, [](big_int a, big_int b) -> big_int { return a != b; });
+        return binary(e, [](const big_int &a, const big_int &b) {
+            return Util::evaluate(a, b, std::not_equal_to<>());
+        });
 }
 
-const IR::Node *DoConstantFolding::binary(const IR::Operation_Binary *e,
-                                          std::function<big_int(big_int, big_int)> func,
-                                          bool saturating) {
+const IR::Node *DoConstantFolding::binary(
+    const IR::Operation_Binary *e, std::function<big_int(const big_int &, const big_int &)> func,
+    bool saturating) {
     auto eleft = getConstant(e->left);
     auto eright = getConstant(e->right);
     if (eleft == nullptr || eright == nullptr) return e;
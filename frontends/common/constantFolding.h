@@ -88,7 +88,8 @@ class DoConstantFolding : public Transform {
 
     /// Statically evaluate binary operation @p e implemented by @p func.
     const IR::Node *binary(const IR::Operation_Binary *op,
-                           std::function<big_int(big_int, big_int)> func, bool saturating = false);
+                           std::function<big_int(const big_int &, const big_int &)> func,
+                           bool saturating = false);
     /// Statically evaluate comparison operation @p e.
     /// Note that this only handles the case where @p e represents `==` or `!=`.
     const IR::Node *compare(const IR::Operation_Binary *op);
@@ -0,0 +1,88 @@
+#include "frontends/common/irCache.h"
+
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+
+#include "frontends/common/parser_options.h"
+#include "ir/binary_loader.h"
+#include "ir/binary_writer.h"
+#include "ir/ir.h"
+#include "lib/error.h"
+#include "lib/hash.h"
+#include "lib/log.h"
+
+namespace P4 {
+
+namespace {
+
+std::filesystem::path entryPath(cstring dir, cstring key) {
+    return std::filesystem::path(dir.c_str()) / (key + ".p4ir").c_str();
+}
+
+}  // namespace
+
+std::string IRCache::readAll(FILE *in) {
+    std::string result;
+    char buf[1 << 16];
+    while (size_t count = fread(buf, 1, sizeof(buf), in)) result.append(buf, count);
+    return result;
+}
+
+cstring IRCache::key(const std::string &source, const ParserOptions &options) {
+    std::stringstream opts;
+    options.dumpFrontendOptions(opts);
+    std::stringstream result;
+    result << std::hex << std::setfill('0') << std::setw(16) << Util::hash(source)
+           << std::setw(16) << Util::hash(opts.str());
+    return result.str();
+}
+
+const IR::P4Program *IRCache::load(cstring dir, cstring key) {
+    auto path = entryPath(dir, key);
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        LOG2("IR cache miss for " << path);
+        return nullptr;
+    }
+    BinaryIRLoader loader(in);
+    if (!loader.valid()) {
+        LOG2("Ignoring IR cache entry " << path << " written by another compiler version");
+        return nullptr;
+    }
+    const auto *node = loader.readNode();
+    if (!node || !node->is<IR::P4Program>()) return nullptr;
+    LOG2("IR cache hit for " << path);
+    return node->to<IR::P4Program>();
+}
+
+void IRCache::store(cstring dir, cstring key, const IR::P4Program *program) {
+    auto path = entryPath(dir, key);
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    // Write to a private file and rename it, so that concurrent compilations of the
+    // same program never observe a partially written entry.
+    auto tmp = path;
+    tmp += "." + std::to_string(getpid()) + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary);
+        if (out) BinaryIRWriter(out) << program;
+        if (!out) {
+            ::warning(ErrorType::WARN_FAILED, "Could not write IR cache entry %1%", tmp.string());
+            std::filesystem::remove(tmp, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        ::warning(ErrorType::WARN_FAILED, "Could not write IR cache entry %1%: %2%", path.string(),
+                  ec.message());
+        std::filesystem::remove(tmp, ec);
+    }
+}
+
+}  // namespace P4
@@ -0,0 +1,44 @@
+#ifndef FRONTENDS_COMMON_IRCACHE_H_
+#define FRONTENDS_COMMON_IRCACHE_H_
+
+#include <cstdio>
+#include <string>
+
+#include "lib/cstring.h"
+
+namespace IR {
+class P4Program;
+}  // namespace IR
+
+class ParserOptions;
+
+namespace P4 {
+
+/// An on-disk, content-addressed cache of frontend results.  Entries are keyed by
+/// a hash of the preprocessed source and of the options that influence the
+/// frontend (ParserOptions::dumpFrontendOptions), and are stored in the binary IR
+/// format, one file per key.  Since that format is tied to the IR classes the
+/// compiler was built with, a cache directory must not be shared between builds
+/// that use different .def files with the same compiler version.
+///
+/// Only whole programs are cached.  The frontend result of an include such as
+/// core.p4 cannot be cached on its own and spliced into another program: the
+/// frontend passes type-check, rename and specialize the whole program at once,
+/// and the lexer needs the declarations of the includes to parse what follows
+/// them, so the includes are neither parsed nor checked independently.
+class IRCache {
+ public:
+    /// Reads all the remaining contents of @p in.
+    static std::string readAll(FILE *in);
+    /// @returns the key under which the frontend result for @p source is cached.
+    static cstring key(const std::string &source, const ParserOptions &options);
+    /// @returns the program cached under @p key in @p dir, or nullptr on a miss.
+    static const IR::P4Program *load(cstring dir, cstring key);
+    /// Saves @p program under @p key in @p dir, replacing any existing entry.
+    /// Failures only produce a warning, as the cache is an optimization.
+    static void store(cstring dir, cstring key, const IR::P4Program *program);
+};
+
+}  // namespace P4
+
+#endif /* FRONTENDS_COMMON_IRCACHE_H_ */
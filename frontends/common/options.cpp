@@ -16,7 +16,14 @@ limitations under the License.
 
 #include "options.h"
 
+#include <cstdlib>
+#include <iostream>
+
+#include "frontends/common/programMap.h"
 #include "frontends/p4/frontend.h"
+#include "ir/pass_manager.h"
+#include "ir/pass_profile.h"
+#include "lib/log.h"
 
 CompilerOptions::CompilerOptions() : ParserOptions() {
     registerOption(
@@ -56,6 +63,14 @@ CompilerOptions::CompilerOptions() : ParserOptions() {
             return true;
         },
         "Dump the compiler IR after the midend as JSON in the specified file.");
+    registerOption(
+        "--toBinaryIR", "file",
+        [this](const char *arg) {
+            dumpBinaryIRFile = arg;
+            return true;
+        },
+        "Dump the compiler IR after the midend in the compact binary format\n"
+        "in the specified file.");
     registerOption(
         "--ndebug", nullptr,
         [this](const char *) {
@@ -70,6 +85,75 @@ CompilerOptions::CompilerOptions() : ParserOptions() {
             return true;
         },
         "[Compiler debugging] Dump and undump the IR");
+    registerOption(
+        "--pass-profile", "file",
+        [this](const char *arg) {
+            passProfileFile = arg;
+            PassProfile::enable(passProfileFile);
+            return true;
+        },
+        "[Compiler debugging] Write the wall time, bytes allocated and IR node\n"
+        "count of every pass to the specified file (CSV if the name ends\n"
+        "in .csv, JSON otherwise).");
+    registerOption(
+        "--print-analysis-stats", nullptr,
+        [](const char *) {
+            static bool registered = false;
+            if (!registered) std::atexit([] { P4::ProgramMap::printStatistics(std::cerr); });
+            registered = true;
+            return true;
+        },
+        "[Compiler debugging] Print to stderr, at exit, how many times the\n"
+        "reference and type maps were reused because the program had not\n"
+        "changed, updated for the changed declarations, or recomputed.");
+    registerOption(
+        "--memory-report", nullptr,
+        [](const char *) {
+            PassProfile::enableMemoryReport();
+            return true;
+        },
+        "[Compiler debugging] Print to stderr, at exit, the peak heap in use,\n"
+        "the heap in use after and the bytes allocated of every pass.");
+    registerOption(
+        "--memory-limit", "MB",
+        [](const char *arg) {
+            char *end = nullptr;
+            auto megabytes = strtoull(arg, &end, 10);
+            if (end == arg || *end != '\0' || megabytes == 0) {
+                ::error(ErrorType::ERR_INVALID, "%1%: invalid memory limit", arg);
+                return false;
+            }
+            PassProfile::setMemoryLimit(megabytes << 20);
+            return true;
+        },
+        "[Compiler debugging] Stop the compilation, after printing the memory\n"
+        "report, if the heap in use after a pass stays above MB megabytes\n"
+        "once garbage is collected.  Requires libgc.");
+    registerOption(
+        "--gc-checkpoints", nullptr,
+        [](const char *) {
+            PassManager::setGcCheckpoints(true);
+            return true;
+        },
+        "[Compiler debugging] Collect garbage between the top-level passes,\n"
+        "and report the time it takes in the pass profile.");
+    registerOption(
+        "--gc-checkpoints-only", nullptr,
+        [](const char *) {
+            PassManager::setGcCheckpoints(true, true);
+            return true;
+        },
+        "[Compiler debugging] Like --gc-checkpoints, but do not collect garbage\n"
+        "while the top-level passes run; uses more memory.");
+    registerOption(
+        "--trace-events", "file",
+        [](const char *arg) {
+            Log::enableTraceEvents(arg);
+            return true;
+        },
+        "[Compiler debugging] Write one JSON object per line to the specified\n"
+        "file for every pass invocation, with its pass manager, name,\n"
+        "sequence number and wall time in nanoseconds.");
     registerOption(
         "--pp", "file",
         [this](const char *arg) {
@@ -103,7 +187,8 @@ CompilerOptions::CompilerOptions() : ParserOptions() {
         },
         "Write the P4Runtime control plane API description to the specified\n"
         "files (comma-separated list). The format is inferred from the file\n"
-        "suffix: .txt, .json, .bin");
+        "suffix: .txt, .json, .bin, or .p4idx for a binary file indexed by\n"
+        "id and by name, which agents can map in memory without parsing it");
     registerOption(
         "--p4runtime-entries-files", "files",
         [this](const char *arg) {
@@ -113,6 +198,40 @@ CompilerOptions::CompilerOptions() : ParserOptions() {
         "Write static table entries as a P4Runtime WriteRequest message\n"
         "to the specified files (comma-separated list); the file format is\n"
         "inferred from the suffix. Legal suffixes are .json, .txt and .bin");
+    registerOption(
+        "--p4runtime-previous", "file",
+        [this](const char *arg) {
+            p4RuntimePreviousFile = arg;
+            return true;
+        },
+        "Read the P4Info generated for a previous version of the program\n"
+        "from the specified file; objects that keep their name and have no\n"
+        "@id annotation keep their id. The file format is inferred from the\n"
+        "suffix. Legal suffixes are .json, .txtpb, .txt and .bin");
+    registerOption(
+        "--p4runtime-diff", "file",
+        [this](const char *arg) {
+            p4RuntimeDiffFile = arg;
+            return true;
+        },
+        "Write the P4Info objects added, removed or modified since the\n"
+        "P4Info given with '--p4runtime-previous' to the specified file,\n"
+        "as JSON.");
+    registerOption(
+        "--p4runtime-entries-chunk-size", "updates",
+        [this](const char *arg) {
+            char *end = nullptr;
+            p4RuntimeEntriesChunkSize = strtoul(arg, &end, 10);
+            if (end == arg || *end != '\0') {
+                ::error(ErrorType::ERR_INVALID, "%1%: invalid number of updates", arg);
+                return false;
+            }
+            return true;
+        },
+        "Write the static table entries as a sequence of P4Runtime WriteRequest\n"
+        "messages of at most this many updates each, so that they can be\n"
+        "applied incrementally: length-delimited messages in binary files,\n"
+        "one message per line in JSON files. Text files are not split.");
     registerOption(
         "--p4runtime-format", "{binary,json,text}",
         [this](const char *arg) {
@@ -152,6 +271,14 @@ CompilerOptions::CompilerOptions() : ParserOptions() {
             return true;
         },
         "Unrolling all parser's loops");
+    registerOption(
+        "--compress-const-entries", nullptr,
+        [this](const char *) {
+            compressConstEntries = true;
+            return true;
+        },
+        "Remove the const table entries that an earlier entry makes unreachable,\n"
+        "and merge entries with the same action whose keys differ in one bit.");
     registerOption(
         "-O", nullptr,
         [this](const char *level) {
@@ -175,6 +302,15 @@ CompilerOptions::CompilerOptions() : ParserOptions() {
 
 bool CompilerOptions::enable_intrinsic_metadata_fix() { return true; }
 
+void CompilerOptions::dumpFrontendOptions(std::ostream &out) const {
+    ParserOptions::dumpFrontendOptions(out);
+    // The target and the architecture only select the midend and the backend.
+    out << optimizationLevel << ' ' << compressConstEntries;
+    if (excludeFrontendPasses)
+        for (auto pass : passesToExcludeFrontend) out << " -" << pass;
+    out << '\n';
+}
+
 void CompilerOptions::validateOptions() const {
     if (!p4RuntimeFile.isNullOrEmpty()) {
         ::warning(ErrorType::WARN_DEPRECATED,
@@ -53,8 +53,12 @@ class CompilerOptions : public ParserOptions {
     std::vector<cstring> passesToExcludeBackend;
     // Dump a JSON representation of the IR in the file.
     cstring dumpJsonFile = nullptr;
+    // Dump the IR in the file, in the binary format read by BinaryIRLoader.
+    cstring dumpBinaryIRFile = nullptr;
     // Dump and undump the IR tree.
     bool debugJson = false;
+    // Write a per-pass time/allocation/node-count profile to the file.
+    cstring passProfileFile = nullptr;
     // if this flag is true, compile program in non-debug mode.
     bool ndebug = false;
     // Write a P4Runtime control plane API description to the specified file.
@@ -67,6 +71,13 @@ class CompilerOptions : public ParserOptions {
     // Write static table entries as a P4Runtime WriteRequest message to the
     // specified files.
     cstring p4RuntimeEntriesFiles = nullptr;
+    // Reuse the ids of the objects of this P4Info file that keep their name.
+    cstring p4RuntimePreviousFile = nullptr;
+    // Write the changes since the previous P4Info file to the specified file.
+    cstring p4RuntimeDiffFile = nullptr;
+    // If not 0, write the static table entries as a sequence of WriteRequest
+    // messages of at most this many updates each.
+    size_t p4RuntimeEntriesChunkSize = 0;
     // Choose format for P4Runtime API description.
     P4::P4RuntimeFormat p4RuntimeFormat = P4::P4RuntimeFormat::BINARY;
     // Pretty-print the program in the specified file.
@@ -77,6 +88,8 @@ class CompilerOptions : public ParserOptions {
     cstring arch = nullptr;
     // If true, unroll all parser loops inside the midend.
     bool loopsUnrolling = false;
+    // If true, remove and merge redundant const table entries in the frontend.
+    bool compressConstEntries = false;
 
     // General optimization options -- can be interpreted by backends in various ways
     int optimizationLevel = 1;
@@ -84,5 +97,6 @@ class CompilerOptions : public ParserOptions {
     bool optimizeSize = false;   // optimize favoring size
 
     virtual bool enable_intrinsic_metadata_fix();
+    void dumpFrontendOptions(std::ostream &out) const override;
 };
 #endif /* FRONTENDS_COMMON_OPTIONS_H_ */
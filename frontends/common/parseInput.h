@@ -17,10 +17,15 @@ limitations under the License.
 #ifndef FRONTENDS_COMMON_PARSEINPUT_H_
 #define FRONTENDS_COMMON_PARSEINPUT_H_
 
+#include <sstream>
+#include <string>
+
+#include "frontends/common/irCache.h"
 #include "frontends/common/options.h"
 #include "frontends/p4/fromv1.0/converters.h"
 #include "frontends/p4/frontend.h"
 #include "frontends/parsers/parserDriver.h"
+#include "ir/pass_profile.h"
 #include "lib/error.h"
 #include "lib/source_file.h"
 
@@ -59,12 +64,19 @@ static const IR::P4Program *parseV1Program(Input &stream, const char *sourceFile
  *
  * @return a P4-16 IR tree representing the contents of the given file, or null
  * on failure. If failure occurs, an error will also be reported.
+ *
+ * The preprocessor runs as a separate process whose output is parsed as it is
+ * produced, so preprocessing and parsing already overlap.  The parse itself is
+ * sequential: the lexer classifies identifiers as type names using the
+ * declarations seen so far (ProgramStructure::lookupIdentifier), so an include
+ * unit cannot be parsed before the units preceding it.
  */
 template <typename C = P4V1::Converter>
 const IR::P4Program *parseP4File(ParserOptions &options) {
     BUG_CHECK(&options == &P4CContext::get().options(),
               "Parsing using options that don't match the current "
               "compiler context");
+    PassProfile::Stage profile("Parse");
     FILE *in = nullptr;
     if (options.doNotPreprocess) {
         in = fopen(options.file, "r");
@@ -77,9 +89,25 @@ const IR::P4Program *parseP4File(ParserOptions &options) {
         if (::errorCount() > 0 || in == nullptr) return nullptr;
     }
 
-    auto result = options.isv1()
-                      ? parseV1Program<FILE *, C>(in, options.file, 1, options.getDebugHook())
-                      : P4ParserDriver::parse(in, options.file);
+    const IR::P4Program *result = nullptr;
+    if (options.irCacheDir) {
+        // The cache is keyed by the preprocessed source, so read all of it first.
+        std::string source = IRCache::readAll(in);
+        options.irCacheKey = IRCache::key(source, options);
+        options.irCacheHit = IRCache::load(options.irCacheDir, options.irCacheKey);
+        if (options.irCacheHit) {
+            result = options.irCacheHit;
+        } else {
+            std::istringstream stream(source);
+            result = options.isv1() ? parseV1Program<std::istringstream, C>(
+                                          stream, options.file, 1, options.getDebugHook())
+                                    : P4ParserDriver::parse(stream, options.file);
+        }
+    } else {
+        result = options.isv1()
+                     ? parseV1Program<FILE *, C>(in, options.file, 1, options.getDebugHook())
+                     : P4ParserDriver::parse(in, options.file);
+    }
     if (options.doNotPreprocess) {
         fclose(in);
     } else {
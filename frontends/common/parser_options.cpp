@@ -283,6 +283,15 @@ ParserOptions::ParserOptions() : Util::Options(defaultMessage) {
         "[Compiler debugging] Dump the P4 representation after\n"
         "passes whose name contains one of `passX' substrings.\n"
         "When '-v' is used this will include the compiler IR.\n");
+    registerOption(
+        "--top4-changes", nullptr,
+        [this](const char *) {
+            top4Changes = true;
+            return true;
+        },
+        "[Compiler debugging] With --top4, only dump the top-level\n"
+        "declarations changed by each pass, and nothing for passes\n"
+        "which did not change the program.\n");
     registerOption(
         "--dump", "folder",
         [this](const char *arg) {
@@ -305,6 +314,16 @@ ParserOptions::ParserOptions() : Util::Options(defaultMessage) {
         "When the optimization is enabled, compiler tries to identify the cases,\n"
         "when it can inline the subparser's states only once for multiple\n"
         "invocations of the same subparser instance.");
+    registerOption(
+        "--ir-cache", "dir",
+        [this](const char *arg) {
+            irCacheDir = arg;
+            return true;
+        },
+        "Cache the result of the frontend in the specified directory, keyed by the\n"
+        "preprocessed program and the compiler options, and reuse it when the same\n"
+        "program is compiled again with the same options.  Source positions are not\n"
+        "cached, and side outputs of the frontend (e.g. --pp) are not produced on a hit.");
     registerOption(
         "--doNotEmitIncludes", "condition",
         [this](const char *arg) {
@@ -459,6 +478,13 @@ static cstring makeFileName(cstring folder, cstring name, cstring baseSuffix) {
     return result.toString();
 }
 
+void ParserOptions::dumpFrontendOptions(std::ostream &out) const {
+    out << (irCacheScope ? irCacheScope : exe_name) << ' ' << compilerVersion << ' ' << static_cast<int>(langVersion) << ' '
+        << optimizeParserInlining;
+    for (auto a : disabledAnnotations) out << " -" << a;
+    out << '\n';
+}
+
 bool ParserOptions::isv1() const { return langVersion == ParserOptions::FrontendVersion::P4_14; }
 
 void ParserOptions::dumpPass(const char *manager, unsigned seq, const char *pass,
@@ -467,6 +493,26 @@ void ParserOptions::dumpPass(const char *manager, unsigned seq, const char *pass
     cstring name = cstring(manager) + "_" + Util::toString(seq) + "_" + pass;
     if (Log::verbose()) std::cerr << name << std::endl;
 
+    // The IR is immutable, so the declarations a pass did not change are
+    // still in the program it returns.
+    const IR::Node *dumped = node;
+    size_t unchanged = 0;
+    if (top4Changes && !top4.empty()) {
+        if (auto program = node->to<IR::P4Program>()) {
+            IR::Vector<IR::Node> changed;
+            for (auto d : program->objects) {
+                if (previousObjects.count(d))
+                    unchanged++;
+                else
+                    changed.push_back(d);
+            }
+            previousObjects.clear();
+            previousObjects.insert(program->objects.begin(), program->objects.end());
+            if (changed.empty()) return;
+            dumped = new IR::P4Program(program->srcInfo, changed);
+        }
+    }
+
     for (auto s : top4) {
         bool match = false;
         try {
@@ -497,7 +543,9 @@ void ParserOptions::dumpPass(const char *manager, unsigned seq, const char *pass
                 if (noIncludes) {
                     toP4.setnoIncludesArg(true);
                 }
-                node->apply(toP4);
+                if (unchanged != 0)
+                    *stream << "// " << unchanged << " unchanged declarations omitted" << std::endl;
+                dumped->apply(toP4);
                 delete stream;  // close the file
             }
             break;
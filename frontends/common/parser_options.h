@@ -28,6 +28,10 @@ limitations under the License.
 #include "lib/cstring.h"
 #include "lib/options.h"
 
+namespace IR {
+class P4Program;
+}  // namespace IR
+
 // Standard include paths for .p4 header files. The values are determined by
 // `configure`.
 extern const char *p4includePath;
@@ -46,6 +50,10 @@ class ParserOptions : public Util::Options {
     // used to generate dump file names
     mutable size_t dump_uid = 0;
 
+    // top-level declarations of the program seen by the previous pass,
+    // used when dumping only the changed declarations
+    mutable std::set<const IR::Node *> previousObjects;
+
  protected:
     // Function that is returned by getDebugHook.
     void dumpPass(const char *manager, unsigned seq, const char *pass, const IR::Node *node) const;
@@ -74,8 +82,22 @@ class ParserOptions : public Util::Options {
     std::vector<cstring> top4;
     // debugging dumps of programs written in this folder
     cstring dumpFolder = ".";
+    // if true only dump the top-level declarations changed by each pass
+    bool top4Changes = false;
     // If false, optimization of callee parsers (subparsers) inlining is disabled.
     bool optimizeParserInlining = false;
+    // Directory of the on-disk frontend result cache (see P4::IRCache), if any.
+    cstring irCacheDir = nullptr;
+    // Cache key of the program being compiled; set by parseP4File when irCacheDir is set.
+    cstring irCacheKey = nullptr;
+    // The program parseP4File loaded from irCacheDir; FrontEnd::run returns it unchanged.
+    const IR::P4Program *irCacheHit = nullptr;
+    // Names the frontend in the IR cache key instead of exe_name.  Compilers which run the
+    // same frontend (e.g. P4::FrontEnd without a policy) set the same name, so that they
+    // share the entries of an irCacheDir.
+    cstring irCacheScope = nullptr;
+    // Writes the options that influence the result of the frontend, for the cache key.
+    virtual void dumpFrontendOptions(std::ostream &out) const;
     // Expect that the only remaining argument is the input file.
     void setInputFile();
     // Return target specific include path.
@@ -17,6 +17,9 @@ limitations under the License.
 #ifndef FRONTENDS_COMMON_PROGRAMMAP_H_
 #define FRONTENDS_COMMON_PROGRAMMAP_H_
 
+#include <map>
+#include <ostream>
+
 #include "ir/ir.h"
 #include "lib/log.h"
 
@@ -56,11 +59,47 @@ class ProgramMap : public IHasDbPrint {
         program = node->to<IR::P4Program>();
         LOG2(mapKind << " updated to " << dbp(node));
     }
+    // The program the map was last computed for, or nullptr if it has been cleared since
+    const IR::P4Program *getProgram() const { return program == fake ? nullptr : program; }
     void clear() {
         // This ensures that a clear map is never up-to-date,
         // since the 'fake' node cannot appear in a program.
         program = fake;
     }
+
+    /// How many times the passes computing each kind of map found it up-to-date, completed
+    /// it for the declarations that changed, or recomputed it for a whole program.
+    struct Statistics {
+        unsigned reused = 0;
+        unsigned incremental = 0;
+        unsigned recomputed = 0;
+    };
+    enum class Use { Reused, Incremental, Recomputed };
+    static std::map<cstring, Statistics> &statistics() {
+        static std::map<cstring, Statistics> result;
+        return result;
+    }
+    /// Counts one use of the map for @p node, if it is a program.
+    void countUse(const IR::Node *node, Use use) const {
+        if (node == nullptr || !node->is<IR::P4Program>()) return;
+        auto &stats = statistics()[mapKind];
+        switch (use) {
+            case Use::Reused:
+                stats.reused++;
+                break;
+            case Use::Incremental:
+                stats.incremental++;
+                break;
+            case Use::Recomputed:
+                stats.recomputed++;
+                break;
+        }
+    }
+    static void printStatistics(std::ostream &out) {
+        for (const auto &[kind, stats] : statistics())
+            out << kind << ": reused " << stats.reused << ", updated incrementally "
+                << stats.incremental << ", recomputed " << stats.recomputed << std::endl;
+    }
 };
 
 }  // namespace P4
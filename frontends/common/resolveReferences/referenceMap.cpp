@@ -17,6 +17,7 @@ limitations under the License.
 #include "referenceMap.h"
 
 #include <sstream>
+#include <utility>
 
 #include "frontends/p4/reservedWords.h"
 
@@ -39,6 +40,12 @@ void ReferenceMap::clear() {
     ProgramMap::clear();
 }
 
+void ReferenceMap::clearKeepingPrevious() {
+    previousPathToDeclaration = std::move(pathToDeclaration);
+    previousThisToDeclaration = std::move(thisToDeclaration);
+    clear();
+}
+
 void ReferenceMap::setDeclaration(const IR::Path *path, const IR::IDeclaration *decl) {
     CHECK_NULL(path);
     CHECK_NULL(decl);
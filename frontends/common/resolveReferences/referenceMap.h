@@ -80,6 +80,12 @@ class ReferenceMap final : public ProgramMap, public NameGenerator, public Decla
     /// this name was used as a base for newly generated unique names.
     absl::flat_hash_map<cstring, int, Util::Hash> usedNames;
 
+    /// The two maps above as they were before clearKeepingPrevious().
+    absl::flat_hash_map<const IR::Path *, const IR::IDeclaration *, Util::Hash>
+        previousPathToDeclaration;
+    absl::flat_hash_map<const IR::This *, const IR::IDeclaration *, Util::Hash>
+        previousThisToDeclaration;
+
  public:
     ReferenceMap();
     /// Looks up declaration for @p path. If @p notNull is false, then
@@ -110,6 +116,23 @@ class ReferenceMap final : public ProgramMap, public NameGenerator, public Decla
     /// Clear the reference map
     void clear();
 
+    /// Clear the reference map, but keep the declarations paths and `This` pointers
+    /// resolved to until dropPrevious(), so that they can be looked up with
+    /// getPrevious() while the map is recomputed.
+    void clearKeepingPrevious();
+    const IR::IDeclaration *getPrevious(const IR::Path *path) const {
+        auto it = previousPathToDeclaration.find(path);
+        return it != previousPathToDeclaration.end() ? it->second : nullptr;
+    }
+    const IR::IDeclaration *getPrevious(const IR::This *pointer) const {
+        auto it = previousThisToDeclaration.find(pointer);
+        return it != previousThisToDeclaration.end() ? it->second : nullptr;
+    }
+    void dropPrevious() {
+        previousPathToDeclaration.clear();
+        previousThisToDeclaration.clear();
+    }
+
     /// @returns @true if this map is for a P4_14 program
     bool isV1() const { return isv1; }
 
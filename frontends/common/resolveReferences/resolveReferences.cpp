@@ -304,7 +304,21 @@ const IR::IDeclaration *ResolutionContext::resolvePath(const IR::Path *path, boo
     return resolveUnique(path->name, k, ctxt);
 }
 
+const IR::IDeclaration *ResolveReferences::carriedOver(const IR::IDeclaration *previous) const {
+    if (previous == nullptr) return nullptr;
+    auto it = replacements.find(previous);
+    if (it != replacements.end()) return it->second;
+    if (stale.count(previous)) return nullptr;
+    return previous;
+}
+
 const IR::IDeclaration *ResolveReferences::resolvePath(const IR::Path *path, bool isType) const {
+    if (carryOver) {
+        if (auto decl = carriedOver(refMap->getPrevious(path))) {
+            refMap->setDeclaration(path, decl);
+            return decl;
+        }
+    }
     auto decl = ResolutionContext::resolvePath(path, isType);
     if (decl == nullptr) {
         refMap->usedName(path->name.name);
@@ -364,25 +378,96 @@ void ResolveReferences::checkShadowing(const IR::INamespace *ns) const {
     }
 }
 
+bool ResolveReferences::prepareIncremental(const IR::Node *node) {
+    auto *program = node->to<IR::P4Program>();
+    auto *previous = refMap->getProgram();
+    if (checkShadow || program == nullptr || previous == nullptr ||
+        program->objects.size() != previous->objects.size())
+        return false;
+
+    std::vector<const IR::Node *> replaced;
+    for (size_t i = 0; i < program->objects.size(); ++i) {
+        auto *now = program->objects.at(i);
+        auto *before = previous->objects.at(i);
+        if (now == before) {
+            unchanged.insert(now);
+            continue;
+        }
+        // Lookups in the unchanged declarations must find the same declarations as
+        // before, including the check that they are declared before their use.
+        auto *nowDecl = now->to<IR::IDeclaration>();
+        auto *beforeDecl = before->to<IR::IDeclaration>();
+        if (nowDecl == nullptr || beforeDecl == nullptr || now->typeId() != before->typeId() ||
+            nowDecl->getName() != beforeDecl->getName() || !(now->srcInfo == before->srcInfo))
+            return false;
+        replacements.emplace(beforeDecl, nowDecl);
+        replaced.push_back(before);
+    }
+
+    struct CollectDeclarations : public Inspector {
+        absl::flat_hash_set<const IR::IDeclaration *, Util::Hash> &decls;
+        explicit CollectDeclarations(absl::flat_hash_set<const IR::IDeclaration *, Util::Hash> &d)
+            : decls(d) {}
+        bool preorder(const IR::Node *n) override {
+            if (auto *decl = n->to<IR::IDeclaration>()) decls.insert(decl);
+            return true;
+        }
+    } collect(stale);
+    for (auto *decl : replaced) decl->apply(collect);
+
+    LOG2("Resolving " << replaced.size() << " of " << program->objects.size()
+                      << " declarations again");
+    return true;
+}
+
 Visitor::profile_t ResolveReferences::init_apply(const IR::Node *node) {
     anyOrder = refMap->isV1();
+    incremental = carryOver = false;
+    unchanged.clear();
+    replacements.clear();
+    stale.clear();
     // Check shadowing even if the program map is up-to-date.
-    if (!refMap->checkMap(node) || checkShadow) refMap->clear();
+    if (!refMap->checkMap(node) || checkShadow) {
+        incremental = prepareIncremental(node);
+        if (incremental)
+            refMap->clearKeepingPrevious();
+        else
+            refMap->clear();
+        refMap->countUse(node, incremental ? ProgramMap::Use::Incremental
+                                           : ProgramMap::Use::Recomputed);
+    } else {
+        refMap->countUse(node, ProgramMap::Use::Reused);
+    }
     return Inspector::init_apply(node);
 }
 
-void ResolveReferences::end_apply(const IR::Node *node) { refMap->updateMap(node); }
+void ResolveReferences::end_apply(const IR::Node *node) {
+    refMap->updateMap(node);
+    refMap->dropPrevious();
+}
 
 // Visitor methods
 
 bool ResolveReferences::preorder(const IR::P4Program *program) {
     if (refMap->checkMap(program)) return false;
-    return true;
+    if (!incremental) return true;
+    for (auto *decl : program->objects) {
+        carryOver = unchanged.count(decl) > 0;
+        visit(decl, "objects");
+    }
+    carryOver = false;
+    return false;
 }
 
 void ResolveReferences::postorder(const IR::P4Program *) { LOG2("Reference map " << refMap); }
 
 bool ResolveReferences::preorder(const IR::This *pointer) {
+    if (carryOver) {
+        if (auto decl = carriedOver(refMap->getPrevious(pointer))) {
+            refMap->setDeclaration(pointer, decl);
+            return true;
+        }
+    }
     auto decl = findContext<IR::Declaration_Instance>();
     if (findContext<IR::Function>() == nullptr || decl == nullptr) {
         ::error(ErrorType::ERR_INVALID,
@@ -396,6 +481,12 @@ bool ResolveReferences::preorder(const IR::This *pointer) {
 bool ResolveReferences::preorder(const IR::KeyElement *ke) {
     visit(ke->annotations, "annotations");
     visit(ke->expression, "expression");
+    if (carryOver) {
+        if (auto decl = carriedOver(refMap->getPrevious(ke->matchType->path))) {
+            refMap->setDeclaration(ke->matchType->path, decl);
+            return false;
+        }
+    }
     auto decls = lookupMatchKind(ke->matchType->path->name);
     if (decls.empty()) {
         ::error(ErrorType::ERR_NOT_FOUND, "%1%: declaration not found", ke->matchType->path->name);
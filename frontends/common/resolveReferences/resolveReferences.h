@@ -18,6 +18,7 @@ limitations under the License.
 #define COMMON_RESOLVEREFERENCES_RESOLVEREFERENCES_H_
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "ir/ir.h"
 #include "lib/cstring.h"
 #include "lib/iterator_range.h"
@@ -122,6 +123,25 @@ class ResolveReferences : public Inspector, private ResolutionContext {
     /// If @true, then warn if one declaration shadows another.
     bool checkShadow;
 
+    /// When the program differs from the one @ref refMap was computed for only in
+    /// top-level declarations replaced by ones of the same kind, name and position, the
+    /// resolution of the paths in the other declarations is carried over from the
+    /// previous map instead of being looked up again.
+    bool incremental = false;
+    /// True while visiting a top-level declaration that has not been replaced.
+    bool carryOver = false;
+    absl::flat_hash_set<const IR::Node *, Util::Hash> unchanged;
+    /// Maps the replaced top-level declarations to their replacements.
+    absl::flat_hash_map<const IR::IDeclaration *, const IR::IDeclaration *, Util::Hash>
+        replacements;
+    /// All declarations within the replaced top-level declarations.
+    absl::flat_hash_set<const IR::IDeclaration *, Util::Hash> stale;
+
+    bool prepareIncremental(const IR::Node *node);
+    /// @returns the declaration @p previous stands for in the current program, or
+    /// nullptr if the reference must be looked up again.
+    const IR::IDeclaration *carriedOver(const IR::IDeclaration *previous) const;
+
  private:
     /// Resolve @p path; if @p isType is `true` then resolution will
     /// only return type nodes.
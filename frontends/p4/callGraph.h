@@ -18,6 +18,7 @@ limitations under the License.
 #define FRONTENDS_P4_CALLGRAPH_H_
 
 #include <algorithm>
+#include <set>
 #include <unordered_set>
 #include <vector>
 
@@ -334,8 +335,10 @@ class CallGraph {
     bool sort(std::vector<T> &start, std::vector<T> &out) {
         sccInfo helper;
         bool cycles = false;
+        // Nodes already in out are skipped; the ones added by strongConnect are known to helper.
+        std::set<T> done(out.begin(), out.end());
         for (auto n : start) {
-            if (std::find(out.begin(), out.end(), n) == out.end()) {
+            if (helper.unknown(n) && done.count(n) == 0) {
                 bool c = strongConnect(n, helper, out);
                 cycles = cycles || c;
             }
@@ -345,8 +348,10 @@ class CallGraph {
     bool sort(std::vector<T> &out) {
         sccInfo helper;
         bool cycles = false;
+        // Nodes already in out are skipped; the ones added by strongConnect are known to helper.
+        std::set<T> done(out.begin(), out.end());
         for (auto n : nodes) {
-            if (std::find(out.begin(), out.end(), n) == out.end()) {
+            if (helper.unknown(n) && done.count(n) == 0) {
                 bool c = strongConnect(n, helper, out);
                 cycles = cycles || c;
             }
@@ -16,6 +16,9 @@ limitations under the License.
 
 #include "def_use.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include "frontends/p4/methodInstance.h"
 #include "frontends/p4/tableApply.h"
 #include "lib/ordered_set.h"
@@ -165,8 +168,12 @@ const LocationSet *LocationSet::join(const LocationSet *other) const {
     CHECK_NULL(other);
     if (this == LocationSet::empty) return other;
     if (other == LocationSet::empty) return this;
-    auto result = new LocationSet(locations);
-    for (auto e : other->locations) result->add(e);
+    auto result = new LocationSet();
+    std::set_union(locations.begin(), locations.end(), other->locations.begin(),
+                   other->locations.end(), std::back_inserter(result->locations), lessById);
+    // Reuse an operand that already contains the other one.
+    if (result->locations.size() == locations.size()) return this;
+    if (result->locations.size() == other->locations.size()) return other;
     return result;
 }
 
@@ -229,9 +236,14 @@ const LocationSet *LocationSet::allElements() const {
 }
 
 const LocationSet *LocationSet::canonicalize() const {
+    if (canonical) return canonical;
+    bool isCanonical = std::all_of(locations.begin(), locations.end(),
+                                   [](const StorageLocation *l) { return l->is<BaseLocation>(); });
+    if (isCanonical) return canonical = this;
     LocationSet *result = new LocationSet();
     for (auto e : locations) result->addCanonical(e);
-    return result;
+    result->canonical = result;
+    return canonical = result;
 }
 
 void LocationSet::addCanonical(const StorageLocation *location) {
@@ -247,8 +259,13 @@ void LocationSet::addCanonical(const StorageLocation *location) {
 }
 
 bool LocationSet::overlaps(const LocationSet *other) const {
-    for (auto s : locations) {
-        if (other->locations.find(s) != other->locations.end()) return true;
+    auto a = locations.begin(), b = other->locations.begin();
+    while (a != locations.end() && b != other->locations.end()) {
+        if (*a == *b) return true;
+        if (lessById(*a, *b))
+            ++a;
+        else
+            ++b;
     }
     return false;
 }
@@ -288,12 +305,44 @@ bool ProgramPoints::operator==(const ProgramPoints &other) const {
     return true;
 }
 
+void Definitions::freeze() const {
+    if (definitions.empty()) return;
+    base = new Layer{base, std::move(definitions), base ? base->depth + 1 : 0};
+    definitions.clear();
+    if (base->depth >= maxLayers) base = new Layer{nullptr, flatten(), 0};
+}
+
+Definitions::DefinitionMap Definitions::flatten() const {
+    DefinitionMap result(definitions);
+    for (auto layer = base; layer != nullptr; layer = layer->parent)
+        for (auto &d : layer->definitions) result.insert(d);  // keeps newer definitions
+    for (auto it = result.begin(); it != result.end();) {
+        if (it->second == nullptr)
+            it = result.erase(it);
+        else
+            ++it;
+    }
+    return result;
+}
+
+const ProgramPoints *Definitions::lookup(const BaseLocation *location) const {
+    auto it = definitions.find(location);
+    if (it != definitions.end()) return it->second;
+    for (auto layer = base; layer != nullptr; layer = layer->parent) {
+        auto it = layer->definitions.find(location);
+        if (it != layer->definitions.end()) return it->second;
+    }
+    return nullptr;
+}
+
 Definitions *Definitions::joinDefinitions(const Definitions *other) const {
     auto result = new Definitions();
-    for (auto d : other->definitions) {
+    auto mine = flatten();
+    auto theirs = other->flatten();
+    for (auto d : theirs) {
         auto loc = d.first;
         auto defs = d.second;
-        auto current = ::get(definitions, loc);
+        auto current = ::get(mine, loc);
         if (current != nullptr) {
             auto merged = current->merge(defs);
             result->definitions.emplace(loc, merged);
@@ -301,10 +350,10 @@ Definitions *Definitions::joinDefinitions(const Definitions *other) const {
             result->definitions.emplace(loc, defs);
         }
     }
-    for (auto d : definitions) {
+    for (auto d : mine) {
         auto loc = d.first;
         auto defs = d.second;
-        auto current = ::get(other->definitions, loc);
+        auto current = ::get(theirs, loc);
         if (current == nullptr) result->definitions.emplace(loc, defs);
         // otherwise have have already done it in the loop above
     }
@@ -327,8 +376,13 @@ void Definitions::removeLocation(const StorageLocation *location) {
     loc->addCanonical(location);
     for (auto sl : *loc) {
         auto bl = sl->to<BaseLocation>();
-        auto it = definitions.find(bl);
-        if (it != definitions.end()) definitions.erase(it);
+        // Locations defined in the shared layers are masked rather than erased.
+        if (base != nullptr) {
+            definitions[bl] = nullptr;
+        } else {
+            auto it = definitions.find(bl);
+            if (it != definitions.end()) definitions.erase(it);
+        }
     }
 }
 
@@ -351,9 +405,12 @@ Definitions *Definitions::writes(ProgramPoint point, const LocationSet *location
 }
 
 bool Definitions::operator==(const Definitions &other) const {
-    if (definitions.size() != other.definitions.size()) return false;
-    for (auto d : definitions) {
-        auto od = ::get(other.definitions, d.first);
+    if (base == other.base && definitions.empty() && other.definitions.empty()) return true;
+    auto mine = flatten();
+    auto theirs = other.flatten();
+    if (mine.size() != theirs.size()) return false;
+    for (auto d : mine) {
+        auto od = ::get(theirs, d.first);
         if (od == nullptr) return false;
         if (!d.second->operator==(*od)) return false;
     }
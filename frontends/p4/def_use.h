@@ -17,6 +17,8 @@ limitations under the License.
 #ifndef FRONTENDS_P4_DEF_USE_H_
 #define FRONTENDS_P4_DEF_USE_H_
 
+#include <algorithm>
+
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
 #include "frontends/common/resolveReferences/referenceMap.h"
@@ -191,15 +193,25 @@ class StorageFactory {
 
 /// A set of locations that may be read or written by a computation.
 /// In general this is a conservative approximation of the actual location set.
+/// The locations are kept in a small vector sorted by StorageLocation::id, so
+/// small sets need no allocation, copies and joins are a single allocation at
+/// most, and overlaps() is a linear merge.
 class LocationSet : public IHasDbPrint {
-    ordered_set<const StorageLocation *> locations;
+    typedef absl::InlinedVector<const StorageLocation *, 4> Locations;
+    Locations locations;
+    /// Cached result of canonicalize(); cleared when a location is added.
+    mutable const LocationSet *canonical = nullptr;
+
+    static bool lessById(const StorageLocation *a, const StorageLocation *b) {
+        return a->id < b->id;
+    }
 
  public:
     LocationSet() = default;
-    explicit LocationSet(const ordered_set<const StorageLocation *> &other) : locations(other) {}
+    LocationSet(const LocationSet &other) : locations(other.locations) {}
     explicit LocationSet(const StorageLocation *location) {
         CHECK_NULL(location);
-        locations.emplace(location);
+        locations.push_back(location);
     }
     static const LocationSet *empty;
 
@@ -211,17 +223,17 @@ class LocationSet : public IHasDbPrint {
 
     void add(const StorageLocation *location) {
         CHECK_NULL(location);
-        locations.emplace(location);
+        auto it = std::lower_bound(locations.begin(), locations.end(), location, lessById);
+        if (it == locations.end() || *it != location) locations.insert(it, location);
+        canonical = nullptr;
     }
     const LocationSet *join(const LocationSet *other) const;
     /// @returns this location set expressed only in terms of BaseLocation;
     /// e.g., a StructLocation is expanded in all its fields.
     const LocationSet *canonicalize() const;
     void addCanonical(const StorageLocation *location);
-    ordered_set<const StorageLocation *>::const_iterator begin() const {
-        return locations.cbegin();
-    }
-    ordered_set<const StorageLocation *>::const_iterator end() const { return locations.cend(); }
+    Locations::const_iterator begin() const { return locations.cbegin(); }
+    Locations::const_iterator end() const { return locations.cend(); }
     void dbprint(std::ostream &out) const override {
         if (locations.empty()) out << "LocationSet::empty";
         for (auto l : locations) {
@@ -370,17 +382,44 @@ class ProgramPoints : public IHasDbPrint {
 };
 
 /// List of definers for each base storage (at a specific program point).
+///
+/// Most program points change the definitions of only the few locations the
+/// statement writes, so the definitions are stored sparsely: each Definitions
+/// holds only the locations written since it was derived from another one, on
+/// top of a chain of immutable layers shared with its ancestors.  Chains are
+/// flattened once they grow past maxLayers, which bounds the cost of a lookup.
 class Definitions : public IHasDbPrint {
+    typedef hvec_map<const BaseLocation *, const ProgramPoints *> DefinitionMap;
+    /// Definitions shared between Definitions objects; never modified once created.
+    struct Layer {
+        const Layer *parent;
+        /// Values override those in parent; nullptr is a removed location.
+        DefinitionMap definitions;
+        unsigned depth;
+    };
+    static constexpr unsigned maxLayers = 16;
+
+    /// Definitions shared with the Definitions this one was derived from.
+    mutable const Layer *base = nullptr;
     /// Set of program points that have written last to each location
-    /// (conservative approximation).
-    hvec_map<const BaseLocation *, const ProgramPoints *> definitions;
+    /// (conservative approximation).  Overrides 'base'; nullptr is a removed
+    /// location.
+    mutable DefinitionMap definitions;
     /// If true the current program point is actually unreachable.
     bool unreachable = false;
 
+    /// Moves 'definitions' into a new layer that copies of this can share.
+    void freeze() const;
+    /// @returns the definitions of all locations.
+    DefinitionMap flatten() const;
+    const ProgramPoints *lookup(const BaseLocation *location) const;
+
  public:
     Definitions() = default;
-    Definitions(const Definitions &other)
-        : definitions(other.definitions), unreachable(other.unreachable) {}
+    Definitions(const Definitions &other) : unreachable(other.unreachable) {
+        other.freeze();
+        base = other.base;
+    }
     Definitions *joinDefinitions(const Definitions *other) const;
     /// Point writes the specified LocationSet.
     Definitions *writes(ProgramPoint point, const LocationSet *locations) const;
@@ -396,11 +435,9 @@ class Definitions : public IHasDbPrint {
         return this;
     }
     bool isUnreachable() const { return unreachable; }
-    bool hasLocation(const BaseLocation *location) const {
-        return definitions.find(location) != definitions.end();
-    }
+    bool hasLocation(const BaseLocation *location) const { return lookup(location) != nullptr; }
     const ProgramPoints *getPoints(const BaseLocation *location) const {
-        auto r = ::get(definitions, location);
+        auto r = lookup(location);
         BUG_CHECK(r != nullptr, "no definitions found for %1%", location);
         return r;
     }
@@ -410,9 +447,10 @@ class Definitions : public IHasDbPrint {
         if (unreachable) {
             out << "  Unreachable" << Log::endl;
         }
-        if (definitions.empty()) out << "  Empty definitions";
+        auto all = flatten();
+        if (all.empty()) out << "  Empty definitions";
         bool first = true;
-        for (auto d : definitions) {
+        for (auto d : all) {
             if (!first) out << Log::endl;
             out << "  " << *d.first << "=>" << *d.second;
             first = false;
@@ -420,8 +458,8 @@ class Definitions : public IHasDbPrint {
     }
     Definitions *cloneDefinitions() const { return new Definitions(*this); }
     void removeLocation(const StorageLocation *loc);
-    bool empty() const { return definitions.empty(); }
-    size_t size() const { return definitions.size(); }
+    bool empty() const { return flatten().empty(); }
+    size_t size() const { return flatten().size(); }
 };
 
 class AllDefinitions : public IHasDbPrint {
@@ -16,7 +16,12 @@ limitations under the License.
 
 #include "entryPriorities.h"
 
+#include <algorithm>
+#include <optional>
+#include <vector>
+
 #include "coreLibrary.h"
+#include "lib/log.h"
 
 namespace P4 {
 
@@ -166,4 +171,182 @@ const IR::Node *DoEntryPriorities::preorder(IR::EntriesList *entries) {
     return entries;
 }
 
+namespace {
+
+enum class MatchKind { Exact, Lpm, Ternary };
+
+struct KeyField {
+    MatchKind kind;
+    const IR::Type *type;
+    big_int allOnes;
+};
+
+/// A key value of an entry, as a value and a mask.
+struct KeyValue {
+    big_int value;
+    big_int mask;
+    bool operator==(const KeyValue &other) const {
+        return value == other.value && mask == other.mask;
+    }
+};
+
+using EntryKey = std::vector<KeyValue>;
+
+/// @returns @p expression as a value and a mask, or nullopt if it is not constant.
+std::optional<KeyValue> keyValue(const IR::Expression *expression, const KeyField &field) {
+    if (expression->is<IR::DefaultExpression>()) return KeyValue{0, 0};
+    if (auto b = expression->to<IR::BoolLiteral>()) return KeyValue{b->value ? 1 : 0, 1};
+    if (auto c = expression->to<IR::Constant>())
+        return KeyValue{c->value & field.allOnes, field.allOnes};
+    if (auto m = expression->to<IR::Mask>()) {
+        auto value = m->left->to<IR::Constant>();
+        auto mask = m->right->to<IR::Constant>();
+        if (value && mask) {
+            big_int bits = mask->value & field.allOnes;
+            return KeyValue{value->value & bits, bits};
+        }
+    }
+    return std::nullopt;
+}
+
+/// @returns true if every packet that matches @p key also matches @p earlier.
+bool covers(const EntryKey &earlier, const EntryKey &key) {
+    for (size_t i = 0; i < key.size(); i++) {
+        if ((earlier[i].mask & key[i].mask) != earlier[i].mask) return false;
+        if (((earlier[i].value ^ key[i].value) & earlier[i].mask) != 0) return false;
+    }
+    return true;
+}
+
+/// @returns the index of the only field in which @p a and @p b differ, if the two keys can be
+/// replaced by @p a with the differing bit cleared from the value and the mask of that field.
+std::optional<size_t> mergeableField(const EntryKey &a, const EntryKey &b,
+                                     const std::vector<KeyField> &fields) {
+    std::optional<size_t> result;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i] == b[i]) continue;
+        if (result || fields[i].kind == MatchKind::Exact || a[i].mask != b[i].mask)
+            return std::nullopt;
+        big_int bit = a[i].value ^ b[i].value;
+        if ((bit & (bit - 1)) != 0 || (bit & a[i].mask) != bit) return std::nullopt;
+        // Prefixes can only lose their last bit.
+        if (fields[i].kind == MatchKind::Lpm && bit != (a[i].mask & -a[i].mask))
+            return std::nullopt;
+        result = i;
+    }
+    return result;
+}
+
+const IR::Entry *mergedEntry(const IR::Entry *entry, size_t index, const KeyValue &value,
+                             const KeyField &field) {
+    auto keys = entry->keys->clone();
+    auto original = keys->components.at(index);
+    if (value.mask == 0)
+        keys->components[index] =
+            new IR::DefaultExpression(original->srcInfo, IR::Type_Dontcare::get());
+    else
+        keys->components[index] =
+            new IR::Mask(original->srcInfo, new IR::Constant(field.type, value.value),
+                         new IR::Constant(field.type, value.mask));
+    return new IR::Entry(entry->srcInfo, entry->annotations, entry->isConst, entry->priority,
+                         keys, entry->action, entry->singleton);
+}
+
+}  // namespace
+
+const IR::Node *CompressConstEntries::postorder(IR::EntriesList *entries) {
+    auto table = findContext<IR::P4Table>();
+    CHECK_NULL(table);
+    auto ep = table->properties->getProperty(IR::TableProperties::entriesPropertyName);
+    auto key = table->getKey();
+    if (ep == nullptr || !ep->isConstant || key == nullptr || entries->size() < 2)
+        return entries;
+
+    std::vector<KeyField> fields;
+    bool ordered = false;
+    for (auto ke : key->keyElements) {
+        auto type = ke->expression->type;
+        auto bits = type->to<IR::Type_Bits>();
+        if ((bits == nullptr || bits->isSigned) && !type->is<IR::Type_Boolean>()) return entries;
+        auto name = ke->matchType->path->name.name;
+        MatchKind kind;
+        if (name == corelib.exactMatch.name) {
+            kind = MatchKind::Exact;
+        } else if (name == corelib.lpmMatch.name) {
+            kind = MatchKind::Lpm;
+        } else if (name == corelib.ternaryMatch.name) {
+            kind = MatchKind::Ternary;
+            ordered = true;
+        } else {
+            return entries;
+        }
+        fields.push_back(KeyField{kind, type, (big_int(1) << type->width_bits()) - 1});
+    }
+
+    std::vector<const IR::Entry *> result;
+    std::vector<EntryKey> keys;
+    for (auto entry : entries->entries) {
+        if (entry->keys->size() != fields.size()) return entries;
+        EntryKey entryKey;
+        for (size_t i = 0; i < fields.size(); i++) {
+            auto value = keyValue(entry->keys->components.at(i), fields[i]);
+            if (!value) return entries;
+            entryKey.push_back(*value);
+        }
+        result.push_back(entry);
+        keys.push_back(std::move(entryKey));
+    }
+
+    auto erase = [&](size_t index) {
+        result.erase(result.begin() + index);
+        keys.erase(keys.begin() + index);
+    };
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (size_t j = 1; j < result.size();) {
+            bool unreachable = false;
+            for (size_t i = 0; i < j && !unreachable; i++)
+                unreachable = ordered ? covers(keys[i], keys[j]) : keys[i] == keys[j];
+            if (!unreachable) {
+                j++;
+                continue;
+            }
+            LOG2(table->controlPlaneName() << ": removing unreachable entry " << result[j]);
+            erase(j);
+            changed = true;
+        }
+        for (size_t i = 0; i + 1 < result.size(); i++) {
+            size_t end = ordered ? i + 2 : result.size();
+            for (size_t j = i + 1; j < end; j++) {
+                if (!result[i]->annotations->annotations.empty() ||
+                    !result[j]->annotations->annotations.empty() ||
+                    !result[i]->action->equiv(*result[j]->action))
+                    continue;
+                auto field = mergeableField(keys[i], keys[j], fields);
+                if (!field) continue;
+                EntryKey merged = keys[i];
+                big_int bit = keys[i][*field].value ^ keys[j][*field].value;
+                merged[*field].mask &= ~bit;
+                merged[*field].value &= merged[*field].mask;
+                // Without an order, the merged entry must not replace an existing one.
+                if (!ordered && std::find(keys.begin(), keys.end(), merged) != keys.end())
+                    continue;
+                LOG2(table->controlPlaneName() << ": merging entries " << result[i] << " and "
+                                               << result[j]);
+                result[i] = mergedEntry(result[i], *field, merged[*field], fields[*field]);
+                keys[i] = std::move(merged);
+                erase(j);
+                changed = true;
+                break;
+            }
+        }
+    }
+    if (result.size() == entries->size()) return entries;
+    LOG1(table->controlPlaneName() << ": " << entries->size() << " const entries reduced to "
+                                   << result.size());
+    entries->entries.clear();
+    for (auto entry : result) entries->entries.push_back(entry);
+    return entries;
+}
+
 }  // namespace P4
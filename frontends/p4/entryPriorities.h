@@ -40,6 +40,23 @@ class DoEntryPriorities : public Transform {
     const IR::Node *preorder(IR::EntriesList *entries) override;
 };
 
+/// Minimizes the entries of tables with 'const' entries whose keys are constant exact, lpm and
+/// ternary values: removes the entries an earlier entry makes unreachable, and merges pairs of
+/// entries with the same action whose keys only differ in one bit of a ternary value, or in the
+/// last bit of a prefix.  The first matching entry wins in tables with a ternary key, and the
+/// longest prefix otherwise, so only adjacent entries are merged in the former, and only
+/// duplicate entries are removed in the latter.  Tables with other match kinds, or entries with
+/// annotations, are left as they are.  Must run after type inference and constant folding.
+class CompressConstEntries : public Transform {
+    P4::P4CoreLibrary &corelib;
+
+ public:
+    CompressConstEntries() : corelib(P4::P4CoreLibrary::instance()) {
+        setName("CompressConstEntries");
+    }
+    const IR::Node *postorder(IR::EntriesList *entries) override;
+};
+
 class EntryPriorities : public PassManager {
  public:
     explicit EntryPriorities(ReferenceMap *refMap) {
@@ -79,8 +79,18 @@ const IR::CompileTimeValue *Evaluator::getValue(const IR::Node *node) const {
 
 ////////////////////////////// visitor methods ////////////////////////////////////
 
+const IR::P4Program *Evaluator::cachedProgram = nullptr;
+IR::ToplevelBlock *Evaluator::cachedBlock = nullptr;
+
 bool Evaluator::preorder(const IR::P4Program *program) {
+    if (program == cachedProgram) {
+        // The IR is immutable, so the blocks of an unchanged program are the same.
+        LOG2("Reusing evaluation of " << dbp(program));
+        toplevelBlock = cachedBlock;
+        return false;
+    }
     LOG2("Evaluating " << dbp(program));
+    auto errors = ::errorCount();
     toplevelBlock = new IR::ToplevelBlock(program->srcInfo, program);
 
     pushBlock(toplevelBlock);
@@ -91,9 +101,15 @@ bool Evaluator::preorder(const IR::P4Program *program) {
         visit(d);
     }
     popBlock(toplevelBlock);
-    std::stringstream str;
-    toplevelBlock->dbprint_recursive(str);
-    LOG2(str.str());
+    if (LOGGING(2)) {
+        std::stringstream str;
+        toplevelBlock->dbprint_recursive(str);
+        LOG2(str.str());
+    }
+    if (::errorCount() == errors) {
+        cachedProgram = program;
+        cachedBlock = toplevelBlock;
+    }
     return false;
 }
 
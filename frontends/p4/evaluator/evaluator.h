@@ -34,6 +34,10 @@ class Evaluator final : public Inspector, public IHasBlock {
     const TypeMap *typeMap;
     std::vector<IR::Block *> blockStack;
     IR::ToplevelBlock *toplevelBlock;
+    /// The last program evaluated without errors, and its blocks, which are
+    /// reused when the same program is evaluated again.
+    static const IR::P4Program *cachedProgram;
+    static IR::ToplevelBlock *cachedBlock;
 
  protected:
     void pushBlock(IR::Block *block);
@@ -17,6 +17,7 @@ limitations under the License.
 #include "programStructure.h"
 
 #include <algorithm>
+#include <optional>
 #include <set>
 
 #include "converters.h"
@@ -26,6 +27,7 @@ limitations under the License.
 #include "frontends/p4/reservedWords.h"
 #include "frontends/p4/tableKeyNames.h"
 #include "frontends/parsers/parserDriver.h"
+#include "ir/pass_profile.h"
 #include "lib/big_int_util.h"
 #include "lib/bitops.h"
 #include "lib/path.h"
@@ -2156,6 +2158,7 @@ const IR::P4Control *ProgramStructure::convertControl(const IR::V1Control *contr
 
     std::vector<const IR::V1Table *> usedTables;
     tablesReferred(control, usedTables);
+    std::set<const IR::V1Table *> usedTableSet(usedTables.begin(), usedTables.end());
     for (auto t : usedTables) {
         for (auto a : t->actions) actionsInTables.push_back(a.name);
         if (!t->default_action.name.isNullOrEmpty())
@@ -2182,7 +2185,7 @@ const IR::P4Control *ProgramStructure::convertControl(const IR::V1Control *contr
                 ::error(ErrorType::ERR_NOT_FOUND, "Cannot locate table %1%", c.first->table.name);
                 return nullptr;
             }
-            if (std::find(usedTables.begin(), usedTables.end(), tbl) != usedTables.end()) {
+            if (usedTableSet.count(tbl) != 0) {
                 auto extcounter = convertDirectCounter(c.first, c.second);
                 if (extcounter != nullptr) {
                     locals.push_back(extcounter);
@@ -2212,7 +2215,7 @@ const IR::P4Control *ProgramStructure::convertControl(const IR::V1Control *contr
                 ::error(ErrorType::ERR_NOT_FOUND, "Cannot locate table %1%", m.first->table.name);
                 return nullptr;
             }
-            if (std::find(usedTables.begin(), usedTables.end(), tbl) != usedTables.end()) {
+            if (usedTableSet.count(tbl) != 0) {
                 auto meter = meters.get(m.second);
                 auto extmeter = convertDirectMeter(meter, m.second);
                 if (extmeter != nullptr) {
@@ -2589,18 +2592,28 @@ void ProgramStructure::createChecksumUpdates() {
     conversionContext->clear();
 }
 
+/// Runs one step of ProgramStructure::create, which shows up in the --pass-profile
+/// report nested under the pass calling create.
+template <typename Step>
+static void profileStep(const char *name, Step step) {
+    std::optional<PassProfile::Scope> profile;
+    if (PassProfile::enabled()) profile.emplace("ProgramStructure", name, nullptr);
+    step();
+    if (profile) profile->finish(nullptr);
+}
+
 const IR::P4Program *ProgramStructure::create(Util::SourceInfo info) {
-    createTypes();
-    createStructures();
-    createExterns();
-    createParser();
+    profileStep("createTypes", [this] { createTypes(); });
+    profileStep("createStructures", [this] { createStructures(); });
+    profileStep("createExterns", [this] { createExterns(); });
+    profileStep("createParser", [this] { createParser(); });
     if (::errorCount()) return nullptr;
-    createControls();
+    profileStep("createControls", [this] { createControls(); });
     if (::errorCount()) return nullptr;
-    createDeparser();
-    createChecksumVerifications();
-    createChecksumUpdates();
-    createMain();
+    profileStep("createDeparser", [this] { createDeparser(); });
+    profileStep("createChecksumVerifications", [this] { createChecksumVerifications(); });
+    profileStep("createChecksumUpdates", [this] { createChecksumUpdates(); });
+    profileStep("createMain", [this] { createMain(); });
     if (::errorCount()) return nullptr;
     auto program = new IR::P4Program(info, *declarations);
     return program;
@@ -2609,13 +2622,17 @@ const IR::P4Program *ProgramStructure::create(Util::SourceInfo info) {
 void ProgramStructure::tablesReferred(const IR::V1Control *control,
                                       std::vector<const IR::V1Table *> &out) {
     LOG3("Inspecting " << control->name);
-    for (auto it : tableMapping) {
-        if (it.second == control) out.push_back(it.first);
-    }
-    // sort alphabetically to have a deterministic order
-    std::sort(out.begin(), out.end(), [](const IR::V1Table *left, const IR::V1Table *right) {
-        return left->name.name < right->name.name;
-    });
+    if (controlTables.empty()) {
+        for (auto it : tableMapping) controlTables[it.second].push_back(it.first);
+        // sort alphabetically to have a deterministic order
+        for (auto &it : controlTables)
+            std::sort(it.second.begin(), it.second.end(),
+                      [](const IR::V1Table *left, const IR::V1Table *right) {
+                          return left->name.name < right->name.name;
+                      });
+    }
+    auto it = controlTables.find(control);
+    if (it != controlTables.end()) out.insert(out.end(), it->second.begin(), it->second.end());
 }
 
 void ProgramStructure::populateOutputNames() {
@@ -17,7 +17,9 @@ limitations under the License.
 #ifndef FRONTENDS_P4_FROMV1_0_PROGRAMSTRUCTURE_H_
 #define FRONTENDS_P4_FROMV1_0_PROGRAMSTRUCTURE_H_
 
+#include <map>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "frontends/p4/callGraph.h"
@@ -53,7 +55,7 @@ class ProgramStructure {
         // for newly generated unique names.
         std::unordered_map<cstring, int> *allNames;
         std::map<cstring, T> nameToObject;
-        std::map<T, cstring> objectToNewName;
+        std::unordered_map<T, cstring> objectToNewName;
 
         // Iterate in order of name, but return pair<T, newname>
         class iterator {
@@ -61,9 +63,9 @@ class ProgramStructure {
 
          private:
             typename std::map<cstring, T>::iterator it;
-            typename std::map<T, cstring> &objToName;
+            typename std::unordered_map<T, cstring> &objToName;
             iterator(typename std::map<cstring, T>::iterator it,
-                     typename std::map<T, cstring> &objToName)
+                     typename std::unordered_map<T, cstring> &objToName)
                 : it(it), objToName(objToName) {}
 
          public:
@@ -164,6 +166,8 @@ class ProgramStructure {
 
     std::map<const IR::V1Table *, const IR::V1Control *> tableMapping;
     std::map<const IR::V1Table *, const IR::Apply *> tableInvocation;
+    /// The tables of each control in tableMapping, sorted by name; built on first use.
+    std::map<const IR::V1Control *, std::vector<const IR::V1Table *>> controlTables;
     /// Some types are transformed during conversion; this maps the
     /// original P4-14 header type name to the final P4-16
     /// Type_Header.  We can't use the P4-14 type object itself as a
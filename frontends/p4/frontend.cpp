@@ -20,6 +20,7 @@ limitations under the License.
 #include <iostream>
 
 #include "../common/options.h"
+#include "frontends/common/irCache.h"
 #include "frontends/common/resolveReferences/resolveReferences.h"
 #include "frontends/p4/fromv1.0/v1model.h"
 #include "frontends/p4/typeChecking/bindVariables.h"
@@ -150,6 +151,8 @@ class SetStrictStruct : public NoVisit {
 const IR::P4Program *FrontEnd::run(const CompilerOptions &options, const IR::P4Program *program,
                                    std::ostream *outStream) {
     if (program == nullptr && options.listFrontendPasses == 0) return nullptr;
+    // A program loaded from the IR cache has already been through the frontend.
+    if (program != nullptr && program == options.irCacheHit) return program;
 
     bool isv1 = options.isv1();
     ReferenceMap refMap;
@@ -211,6 +214,7 @@ const IR::P4Program *FrontEnd::run(const CompilerOptions &options, const IR::P4P
             new Reassociation(),
             new UselessCasts(&refMap, &typeMap),
         }),
+        options.compressConstEntries ? new CompressConstEntries() : nullptr,
         new SimplifyControlFlow(&refMap, &typeMap),
         new SwitchAddDefault,
         new FrontEndDump(),  // used for testing the program at this point
@@ -282,6 +286,8 @@ const IR::P4Program *FrontEnd::run(const CompilerOptions &options, const IR::P4P
     passes.setStopOnError(true);
     passes.addDebugHooks(hooks, true);
     const IR::P4Program *result = program->apply(passes);
+    if (result && options.irCacheKey && ::errorCount() == 0)
+        IRCache::store(options.irCacheDir, options.irCacheKey, result);
     return result;
 }
 
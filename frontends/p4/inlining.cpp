@@ -326,6 +326,15 @@ const T *PerInstanceSubstitutions::rename(ReferenceMap *refMap, const IR::Node *
     return result;
 }
 
+template <class T>
+const T *PerInstanceSubstitutions::renameOnce(ReferenceMap *refMap, const IR::Node *node) {
+    if (auto result = renamed) {
+        renamed = nullptr;
+        return result->to<T>();
+    }
+    return rename<T>(refMap, node);
+}
+
 void InlineList::analyze() {
     P4::CallGraph<const IR::IContainer *> cg("Call-graph");
 
@@ -360,6 +369,24 @@ void InlineList::analyze() {
         }
     }
 
+    // Callers at the same depth in the call graph do not depend on each other,
+    // so keep them together: next() can then inline all of them in one traversal
+    // of the program instead of one traversal per caller.
+    std::map<const IR::IContainer *, unsigned> depth;
+    for (auto c : order) {
+        std::set<const IR::IContainer *> callees;
+        cg.getCallees(c, callees);
+        unsigned d = 0;
+        for (auto callee : callees) {
+            auto it = depth.find(callee);
+            if (it != depth.end()) d = std::max(d, it->second + 1);
+        }
+        depth[c] = d;
+    }
+    std::stable_sort(toInline.begin(), toInline.end(), [&depth](CallInfo *a, CallInfo *b) {
+        return depth[a->caller] < depth[b->caller];
+    });
+
     std::reverse(toInline.begin(), toInline.end());
 }
 
@@ -587,6 +614,7 @@ void GeneralInliner::inline_subst(P4Block *caller,
                substitutions, including the callee parameters). */
             auto clone = substs->rename<P4Block>(refMap, callee);
             for (auto i : clone->*blockLocals) locals.push_back(i);
+            substs->renamed = clone;
         }
     }
     caller->*blockLocals = locals;
@@ -627,7 +655,8 @@ const IR::Node *GeneralInliner::preorder(IR::MethodCallStatement *statement) {
     auto callee = called->to<IR::P4Control>();
     IR::IndexedVector<IR::StatOrDecl> body;
     // clone the substitution: it may be reused for multiple invocations
-    auto substs = new PerInstanceSubstitutions(*workToDo->substitutions[decl]);
+    auto instSubsts = workToDo->substitutions[decl];
+    auto substs = new PerInstanceSubstitutions(*instSubsts);
 
     auto mi = MethodInstance::resolve(statement->methodCall, refMap, typeMap);
     for (auto param : *mi->substitution.getParametersInArgumentOrder()) {
@@ -660,7 +689,7 @@ const IR::Node *GeneralInliner::preorder(IR::MethodCallStatement *statement) {
     }
 
     // inline actual body
-    callee = substs->rename<IR::P4Control>(refMap, callee);
+    callee = instSubsts->renameOnce<IR::P4Control>(refMap, callee);
     body.append(callee->body->components);
 
     // Copy values of out and inout parameters
@@ -790,7 +819,8 @@ const IR::Node *GeneralInliner::preorder(IR::ParserState *state) {
         auto called = workToDo->declToCallee[decl];
         auto callee = called->to<IR::P4Parser>();
         // clone the substitution: it may be reused for multiple invocations
-        auto substs = new PerInstanceSubstitutions(*workToDo->substitutions[decl]);
+        auto instSubsts = workToDo->substitutions[decl];
+        auto substs = new PerInstanceSubstitutions(*instSubsts);
 
         auto mi = MethodInstance::resolve(call->methodCall, refMap, typeMap);
         // Evaluate in and inout parameters in order.
@@ -848,7 +878,7 @@ const IR::Node *GeneralInliner::preorder(IR::ParserState *state) {
             }
         }
 
-        callee = substs->rename<IR::P4Parser>(refMap, callee);
+        callee = instSubsts->renameOnce<IR::P4Parser>(refMap, callee);
 
         cstring nextState = refMap->newName(state->name);
         std::map<cstring, cstring> renameMap;
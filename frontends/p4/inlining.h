@@ -24,6 +24,7 @@ limitations under the License.
 #include "frontends/p4/typeChecking/typeChecker.h"
 #include "frontends/p4/unusedDeclarations.h"
 #include "ir/ir.h"
+#include "lib/hash.h"
 #include "lib/ordered_map.h"
 
 // These are various data structures needed by the parser/parser and control/control inliners.
@@ -89,11 +90,19 @@ struct PerInstanceSubstitutions {
     ParameterSubstitution paramSubst;
     TypeVariableSubstitution tvs;
     SymRenameMap renameMap;
+    /// The callee already renamed with these substitutions when the instance was
+    /// analyzed; handed out once by renameOnce.  Not copied.
+    const IR::Node *renamed = nullptr;
     PerInstanceSubstitutions() = default;
     PerInstanceSubstitutions(const PerInstanceSubstitutions &other)
         : paramSubst(other.paramSubst), tvs(other.tvs), renameMap(other.renameMap) {}
     template <class T>
     const T *rename(ReferenceMap *refMap, const IR::Node *node);
+    /// Like rename, but the first invocation of an instance reuses the renamed
+    /// callee, so an instance invoked once is only traversed once.  Later
+    /// invocations get a fresh copy, so no nodes are shared between call sites.
+    template <class T>
+    const T *renameOnce(ReferenceMap *refMap, const IR::Node *node);
 };
 
 /// Summarizes all inline operations to be performed.
@@ -138,10 +147,8 @@ struct InlineSummary : public IHasDbPrint {
          */
         struct key_hash {
             std::size_t operator()(const InlinedInvocationInfo &k) const {
-                std::ostringstream oss;
-                std::get<0>(k)->dbprint(oss);
-                std::get<1>(k)->dbprint(oss);
-                return std::hash<std::string>{}(oss.str());
+                return Util::hash_combine(std::get<0>(k)->equivHash(),
+                                          std::get<1>(k)->equivHash());
             }
         };
 
@@ -114,6 +114,7 @@ namespace P4 {
 class ParseAnnotations : public Modifier {
  public:
     using Modifier::postorder;
+    using Modifier::preorder;
 
     /// A handler returns true when the body of the given annotation is parsed
     /// successfully.
@@ -143,6 +144,8 @@ class ParseAnnotations : public Modifier {
         }
     }
 
+    /// Expressions carry no annotations.
+    bool preorder(IR::Expression *) override { return false; }
     void postorder(IR::Annotation *annotation) final;
 
     static HandlerMap standardHandlers();
@@ -22,15 +22,119 @@ limitations under the License.
 
 namespace P4 {
 
+namespace {
+
+/// When invoked on an expression computes all expressions that are
+/// modified while evaluating the expression.  This is a list of
+/// left-values.  Also, a table application expression is
+/// assumed to modify everything.
+class GetWrittenExpressions : public Inspector {
+    ReferenceMap *refMap;
+    TypeMap *typeMap;
+
+ public:
+    // If this expression is in the set, it means that the expression
+    // may modify everything in the program.  This is an
+    // over-approximation used when the expression is a table
+    // invocation --- for this case it's too complicated to compute
+    // precisely the side effects without an inter-procedural
+    // analysis.
+    static const IR::Expression *everything;
+    std::set<const IR::Expression *> written;
+
+    GetWrittenExpressions(ReferenceMap *refMap, TypeMap *typeMap)
+        : refMap(refMap), typeMap(typeMap) {
+        CHECK_NULL(refMap);
+        CHECK_NULL(typeMap);
+        setName("GetWrittenExpressions");
+    }
+    void postorder(const IR::MethodCallExpression *expression) override {
+        auto mi = MethodInstance::resolve(expression, refMap, typeMap);
+        if (auto a = mi->to<ApplyMethod>()) {
+            if (a->isTableApply()) {
+                written.emplace(everything);
+                return;
+            }
+        }
+        for (auto p : *mi->substitution.getParametersInArgumentOrder()) {
+            if (!p->hasOut()) continue;
+            // The only modified expressions much be left-values
+            // that are substituted to out or inout parameters.
+            auto arg = mi->substitution.lookup(p);
+            LOG3("Expression is modified " << arg->expression);
+            written.emplace(arg->expression);
+        }
+    }
+};
+
+// Some expression that cannot occur in the program.
+const IR::Expression *GetWrittenExpressions::everything = new IR::Constant(0);
+
+}  // namespace
+
 cstring DoSimplifyExpressions::createTemporary(const IR::Type *type) {
-    type = type->getP4Type();
-    BUG_CHECK(type && !type->is<IR::Type_Dontcare>(), "Can't create don't-care temps");
+    for (auto it = freeTemporaries.begin(); it != freeTemporaries.end(); ++it) {
+        if (!typeMap->equivalent(it->first, type, true)) continue;
+        auto tmp = it->second;
+        liveTemporaries.push_back(*it);
+        freeTemporaries.erase(it);
+        LOG3("Reusing temporary " << tmp);
+        return tmp;
+    }
+    auto p4type = type->getP4Type();
+    BUG_CHECK(p4type && !p4type->is<IR::Type_Dontcare>(), "Can't create don't-care temps");
     auto tmp = refMap->newName("tmp");
-    auto decl = new IR::Declaration_Variable(IR::ID(tmp, nullptr), type);
+    auto decl = new IR::Declaration_Variable(IR::ID(tmp, nullptr), p4type);
     toInsert.push_back(decl);
+    liveTemporaries.emplace_back(type, tmp);
     return tmp;
 }
 
+/// Called when the statements using the live temporaries have been emitted: the values
+/// of these temporaries are dead, so the following statements can reuse them.
+void DoSimplifyExpressions::releaseTemporaries() {
+    freeTemporaries.insert(freeTemporaries.end(), liveTemporaries.begin(),
+                           liveTemporaries.end());
+    liveTemporaries.clear();
+}
+
+/// Returns all left-values that may be modified while evaluating expression.
+std::set<const IR::Expression *> DoSimplifyExpressions::writtenBy(
+    const IR::Expression *expression) {
+    if (!SideEffects::check(expression, this, refMap, typeMap)) return {};
+    GetWrittenExpressions gwe(refMap, typeMap);
+    gwe.setCalledBy(this);
+    expression->apply(gwe);
+    return gwe.written;
+}
+
+/// Returns true if the value of expression must be saved in a temporary before evaluating
+/// an expression which writes the left-values in written.  Both are original expressions.
+bool DoSimplifyExpressions::mustSave(const IR::Expression *expression,
+                                     const std::set<const IR::Expression *> &written) {
+    if (written.empty() || typeMap->isCompileTimeConstant(expression)) return false;
+    if (written.count(GetWrittenExpressions::everything)) return true;
+    // The simplified expression may read locations which we cannot name here.
+    if (SideEffects::check(expression, this, refMap, typeMap)) return true;
+    for (auto e : written)
+        if (mayAlias(expression, e)) return true;
+    return false;
+}
+
+/// For each member of a list or struct expression, evaluated in order, returns true if it
+/// must be saved in a temporary because the following members may modify it.
+std::vector<bool> DoSimplifyExpressions::membersToSave(
+    const IR::Vector<IR::Expression> &members) {
+    std::vector<bool> result(members.size());
+    std::set<const IR::Expression *> written;  // by the members after i
+    for (size_t i = members.size(); i-- > 0;) {
+        result[i] = mustSave(members[i], written);
+        auto w = writtenBy(members[i]);
+        written.insert(w.begin(), w.end());
+    }
+    return result;
+}
+
 /** Add ```@varName = @expression``` to the vector of statements.
  *
  * @return A copy of the l-value expression created for varName.
@@ -160,14 +264,23 @@ const IR::Node *DoSimplifyExpressions::preorder(IR::StructExpression *expression
         }
     }
     if (!foundEffect) return expression;
-    // allocate temporaries for all members in order.
+    // allocate temporaries for the members which may be modified by the evaluation
+    // of the following members.
     // this will handle cases like a = (S) { b, f(b) }, where f can mutate b.
+    IR::Vector<IR::Expression> values;
+    for (auto v : expression->components) values.push_back(v->expression);
+    auto save = membersToSave(values);
     IR::IndexedVector<IR::NamedExpression> vec;
     LOG3("Dismantling " << dbp(expression));
-    for (auto &v : expression->components) {
+    for (size_t i = 0; i < expression->components.size(); i++) {
+        auto v = expression->components.at(i);
         auto t = typeMap->getType(v->expression, true);
-        auto tmp = createTemporary(t);
         visit(v);
+        if (!save.at(i)) {
+            vec.push_back(v);
+            continue;
+        }
+        auto tmp = createTemporary(t);
         auto path = addAssignment(expression->srcInfo, tmp, v->expression);
         typeMap->setType(path, t);
         // We cannot directly mutate v, because of https://github.com/p4lang/p4c/issues/43
@@ -188,13 +301,17 @@ const IR::Node *DoSimplifyExpressions::preorder(IR::ListExpression *expression)
         }
     }
     if (!foundEffect) return expression;
-    // allocate temporaries for all members in order.
+    // allocate temporaries for the members which may be modified by the evaluation
+    // of the following members.
     // this will handle cases like a = { b, f(b) }, where f can mutate b.
+    auto save = membersToSave(expression->components);
     LOG3("Dismantling " << dbp(expression));
-    for (auto &v : expression->components) {
+    for (size_t i = 0; i < expression->components.size(); i++) {
+        auto &v = expression->components[i];
         auto t = typeMap->getType(v, true);
-        auto tmp = createTemporary(t);
         visit(v);
+        if (!save.at(i)) continue;
+        auto tmp = createTemporary(t);
         auto path = addAssignment(expression->srcInfo, tmp, v);
         v = path;
         typeMap->setType(path, t);
@@ -208,8 +325,8 @@ const IR::Node *DoSimplifyExpressions::preorder(IR::Operation_Binary *expression
     auto original = getOriginal<IR::Operation_Binary>();
     auto type = typeMap->getType(original, true);
     if (SideEffects::check(original, this, refMap, typeMap)) {
-        if (SideEffects::check(original->right, this, refMap, typeMap)) {
-            // We are a bit conservative here. We handle this case:
+        if (mustSave(original->left, writtenBy(original->right))) {
+            // We handle this case:
             // T f(inout T val) { ... }
             // val + f(val);
             // We must save val before the evaluation of f
@@ -225,10 +342,13 @@ const IR::Node *DoSimplifyExpressions::preorder(IR::Operation_Binary *expression
         CHECK_NULL(expression->left);
         visit(expression->right);
         typeMap->setType(expression, type);
+        prune();
+        if (getParent<IR::AssignmentStatement>() != nullptr)
+            // The assignment is emitted right after the statements evaluating the operands.
+            return expression;
         auto tmp = createTemporary(type);
         auto path = addAssignment(expression->srcInfo, tmp, expression);
         typeMap->setType(path, type);
-        prune();
         return path;
     }
     typeMap->setType(expression, type);
@@ -333,56 +453,6 @@ bool DoSimplifyExpressions::containsHeaderType(const IR::Type *type) {
     return false;
 }
 
-namespace {
-
-/// When invoked on an expression computes all expressions that are
-/// modified while evaluating the expression.  This is a list of
-/// left-values.  Also, a table application expression is
-/// assumed to modify everything.
-class GetWrittenExpressions : public Inspector {
-    ReferenceMap *refMap;
-    TypeMap *typeMap;
-
- public:
-    // If this expression is in the set, it means that the expression
-    // may modify everything in the program.  This is an
-    // over-approximation used when the expression is a table
-    // invocation --- for this case it's too complicated to compute
-    // precisely the side effects without an inter-procedural
-    // analysis.
-    static const IR::Expression *everything;
-    std::set<const IR::Expression *> written;
-
-    GetWrittenExpressions(ReferenceMap *refMap, TypeMap *typeMap)
-        : refMap(refMap), typeMap(typeMap) {
-        CHECK_NULL(refMap);
-        CHECK_NULL(typeMap);
-        setName("GetWrittenExpressions");
-    }
-    void postorder(const IR::MethodCallExpression *expression) override {
-        auto mi = MethodInstance::resolve(expression, refMap, typeMap);
-        if (auto a = mi->to<ApplyMethod>()) {
-            if (a->isTableApply()) {
-                written.emplace(everything);
-                return;
-            }
-        }
-        for (auto p : *mi->substitution.getParametersInArgumentOrder()) {
-            if (!p->hasOut()) continue;
-            // The only modified expressions much be left-values
-            // that are substituted to out or inout parameters.
-            auto arg = mi->substitution.lookup(p);
-            LOG3("Expression is modified " << arg->expression);
-            written.emplace(arg->expression);
-        }
-    }
-};
-
-// Some expression that cannot occur in the program.
-const IR::Expression *GetWrittenExpressions::everything = new IR::Constant(0);
-
-}  // namespace
-
 const IR::Node *DoSimplifyExpressions::preorder(IR::MethodCallExpression *mce) {
     // BUG_CHECK(!isWrite(), "%1%: method on left hand side?", mce);
     // isWrite is too conservative, so this check may fail for something like f().isValid()
@@ -574,7 +644,14 @@ const IR::Node *DoSimplifyExpressions::preorder(IR::MethodCallExpression *mce) {
     return rv;
 }
 
+const IR::Node *DoSimplifyExpressions::preorder(IR::P4Action *action) {
+    // The temporaries of the enclosing control are declared after the action.
+    freeTemporaries.clear();
+    return action;
+}
+
 const IR::Node *DoSimplifyExpressions::postorder(IR::Function *function) {
+    freeTemporaries.clear();
     if (toInsert.empty()) return function;
     auto body = new IR::BlockStatement(function->body->srcInfo);
     for (auto a : toInsert) body->push_back(a);
@@ -585,6 +662,7 @@ const IR::Node *DoSimplifyExpressions::postorder(IR::Function *function) {
 }
 
 const IR::Node *DoSimplifyExpressions::postorder(IR::P4Parser *parser) {
+    freeTemporaries.clear();
     if (toInsert.empty()) return parser;
     parser->parserLocals.append(toInsert);
     toInsert.clear();
@@ -592,6 +670,7 @@ const IR::Node *DoSimplifyExpressions::postorder(IR::P4Parser *parser) {
 }
 
 const IR::Node *DoSimplifyExpressions::postorder(IR::P4Control *control) {
+    freeTemporaries.clear();
     if (toInsert.empty()) return control;
     control->controlLocals.append(toInsert);
     toInsert.clear();
@@ -599,6 +678,7 @@ const IR::Node *DoSimplifyExpressions::postorder(IR::P4Control *control) {
 }
 
 const IR::Node *DoSimplifyExpressions::postorder(IR::P4Action *action) {
+    freeTemporaries.clear();
     if (toInsert.empty()) return action;
     auto body = new IR::BlockStatement(action->body->srcInfo);
     for (auto a : toInsert) body->push_back(a);
@@ -609,6 +689,7 @@ const IR::Node *DoSimplifyExpressions::postorder(IR::P4Action *action) {
 }
 
 const IR::Node *DoSimplifyExpressions::postorder(IR::ParserState *state) {
+    releaseTemporaries();
     if (state->selectExpression == nullptr) return state;
     state->components.append(statements);
     statements.clear();
@@ -616,6 +697,7 @@ const IR::Node *DoSimplifyExpressions::postorder(IR::ParserState *state) {
 }
 
 const IR::Node *DoSimplifyExpressions::postorder(IR::AssignmentStatement *statement) {
+    releaseTemporaries();
     if (statements.empty()) return statement;
     statements.push_back(statement);
     auto block = new IR::BlockStatement(statements);
@@ -624,6 +706,7 @@ const IR::Node *DoSimplifyExpressions::postorder(IR::AssignmentStatement *statem
 }
 
 const IR::Node *DoSimplifyExpressions::postorder(IR::MethodCallStatement *statement) {
+    releaseTemporaries();
     if (statements.empty()) {
         BUG_CHECK(statement->methodCall, "NULL methodCall?");
         return statement;
@@ -640,6 +723,7 @@ const IR::Node *DoSimplifyExpressions::postorder(IR::MethodCallStatement *statem
 }
 
 const IR::Node *DoSimplifyExpressions::postorder(IR::ReturnStatement *statement) {
+    releaseTemporaries();
     if (statements.empty()) return statement;
     statements.push_back(statement);
     auto block = new IR::BlockStatement(statements);
@@ -650,6 +734,7 @@ const IR::Node *DoSimplifyExpressions::postorder(IR::ReturnStatement *statement)
 const IR::Node *DoSimplifyExpressions::preorder(IR::IfStatement *statement) {
     IR::Statement *rv = statement;
     visit(statement->condition, "condition");
+    releaseTemporaries();
     if (!statements.empty()) {
         statements.push_back(statement);
         rv = new IR::BlockStatement(statements);
@@ -664,6 +749,7 @@ const IR::Node *DoSimplifyExpressions::preorder(IR::IfStatement *statement) {
 const IR::Node *DoSimplifyExpressions::preorder(IR::SwitchStatement *statement) {
     IR::Statement *rv = statement;
     visit(statement->expression, "expression");
+    releaseTemporaries();
     if (!statements.empty()) {
         statements.push_back(statement);
         rv = new IR::BlockStatement(statements);
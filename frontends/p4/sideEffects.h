@@ -189,8 +189,17 @@ class DoSimplifyExpressions : public Transform, P4WriteContext {
     /// Set of temporaries introduced for method call results during
     /// this pass.
     std::set<const IR::Expression *> temporaries;
+    /// Temporaries, with their types, used by the statement being simplified.
+    std::vector<std::pair<const IR::Type *, cstring>> liveTemporaries;
+    /// Temporaries declared in the current scope which only hold dead values.
+    std::vector<std::pair<const IR::Type *, cstring>> freeTemporaries;
 
     cstring createTemporary(const IR::Type *type);
+    void releaseTemporaries();
+    std::set<const IR::Expression *> writtenBy(const IR::Expression *expression);
+    bool mustSave(const IR::Expression *expression,
+                  const std::set<const IR::Expression *> &written);
+    std::vector<bool> membersToSave(const IR::Vector<IR::Expression> &members);
     const IR::Expression *addAssignment(Util::SourceInfo srcInfo, cstring varName,
                                         const IR::Expression *expression);
     bool mayAlias(const IR::Expression *left, const IR::Expression *right) const;
@@ -236,6 +245,7 @@ class DoSimplifyExpressions : public Transform, P4WriteContext {
     const IR::Node *postorder(IR::P4Parser *parser) override;
     const IR::Node *postorder(IR::Function *function) override;
     const IR::Node *postorder(IR::P4Control *control) override;
+    const IR::Node *preorder(IR::P4Action *action) override;
     const IR::Node *postorder(IR::P4Action *action) override;
     const IR::Node *postorder(IR::ParserState *state) override;
     const IR::Node *postorder(IR::AssignmentStatement *statement) override;
@@ -16,6 +16,8 @@ limitations under the License.
 
 #include "specializeGenericTypes.h"
 
+#include <sstream>
+
 #include "frontends/p4/typeChecking/typeSubstitutionVisitor.h"
 
 namespace P4 {
@@ -34,6 +36,17 @@ bool TypeSpecializationMap::same(const TypeSpecialization *spec,
     return true;
 }
 
+cstring TypeSpecializationMap::key(const IR::Type_Specialized *t) const {
+    std::stringstream result;
+    result << t->baseType->toString();
+    for (auto a : *t->arguments) {
+        auto type = typeMap->getType(a);
+        if (type == nullptr) return nullptr;
+        result << "," << type->toString();
+    }
+    return result.str();
+}
+
 void TypeSpecializationMap::add(const IR::Type_Specialized *t, const IR::Type_StructLike *decl,
                                 const IR::Node *insertion) {
     auto it = map.find(t);
@@ -41,10 +54,12 @@ void TypeSpecializationMap::add(const IR::Type_Specialized *t, const IR::Type_St
 
     // First check if we have another specialization with the same
     // type arguments, in that case reuse it
-    for (auto it : map) {
-        if (same(it.second, t)) {
-            map.emplace(t, it.second);
-            LOG3("Found to specialize: " << t << " as previous " << it.second->name);
+    auto &candidates = byKey[key(t)];
+    for (auto spec : candidates) {
+        if (same(spec, t)) {
+            map.emplace(t, spec);
+            byDeclaration[spec->declaration->name.name].push_back(t);
+            LOG3("Found to specialize: " << t << " as previous " << spec->name);
             return;
         }
     }
@@ -56,9 +71,20 @@ void TypeSpecializationMap::add(const IR::Type_Specialized *t, const IR::Type_St
     for (auto a : *t->arguments) argTypes->push_back(typeMap->getType(a, true));
     TypeSpecialization *s = new TypeSpecialization(name, t, decl, insertion, argTypes);
     map.emplace(t, s);
+    candidates.push_back(s);
+    byDeclaration[decl->name.name].push_back(t);
 }
 
 TypeSpecialization *TypeSpecializationMap::get(const IR::Type_Specialized *type) const {
+    if (auto spec = ::get(map, type)) return spec;
+    if (auto k = key(type)) {
+        auto it = byKey.find(k);
+        if (it == byKey.end()) return nullptr;
+        for (auto spec : it->second) {
+            if (same(spec, type)) return spec;
+        }
+        return nullptr;
+    }
     for (auto it : map) {
         if (same(it.second, type)) return it.second;
     }
@@ -123,22 +149,24 @@ void FindTypeSpecializations::postorder(const IR::Type_Specialized *type) {
 ///////////////////////////////////////////////////////////////////////////////////////
 
 const IR::Node *CreateSpecializedTypes::postorder(IR::Type_Declaration *type) {
-    for (auto it : specMap->map) {
-        if (it.second->declaration->name == type->name) {
-            auto specialized = it.first;
-            auto genDecl = type->to<IR::IMayBeGenericType>();
-            TypeVariableSubstitution ts;
-            ts.setBindings(type, genDecl->getTypeParameters(), specialized->arguments);
-            TypeSubstitutionVisitor tsv(specMap->typeMap, &ts);
-            tsv.setCalledBy(this);
-            auto renamed = type->apply(tsv)->to<IR::Type_StructLike>()->clone();
-            cstring name = it.second->name;
-            auto empty = new IR::TypeParameters();
-            renamed->name = name;
-            renamed->typeParameters = empty;
-            it.second->replacement = postorder(renamed)->to<IR::Type_StructLike>();
-            LOG3("CST Specializing " << dbp(type) << " with " << ts << " as " << dbp(renamed));
-        }
+    auto keys = specMap->byDeclaration.find(type->name.name);
+    if (keys == specMap->byDeclaration.end()) return insert(type);
+    for (auto specialized : keys->second) {
+        auto spec = specMap->map.at(specialized);
+        // Specializations inserted by a previous iteration need not be built again.
+        if (specMap->inserted.count(spec)) continue;
+        auto genDecl = type->to<IR::IMayBeGenericType>();
+        TypeVariableSubstitution ts;
+        ts.setBindings(type, genDecl->getTypeParameters(), specialized->arguments);
+        TypeSubstitutionVisitor tsv(specMap->typeMap, &ts);
+        tsv.setCalledBy(this);
+        auto renamed = type->apply(tsv)->to<IR::Type_StructLike>()->clone();
+        cstring name = spec->name;
+        auto empty = new IR::TypeParameters();
+        renamed->name = name;
+        renamed->typeParameters = empty;
+        spec->replacement = postorder(renamed)->to<IR::Type_StructLike>();
+        LOG3("CST Specializing " << dbp(type) << " with " << ts << " as " << dbp(renamed));
     }
     return insert(type);
 }
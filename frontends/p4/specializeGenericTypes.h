@@ -17,6 +17,9 @@ limitations under the License.
 #ifndef FRONTENDS_P4_SPECIALIZEGENERICTYPES_H_
 #define FRONTENDS_P4_SPECIALIZEGENERICTYPES_H_
 
+#include <unordered_map>
+#include <vector>
+
 #include "frontends/common/resolveReferences/referenceMap.h"
 #include "frontends/p4/typeChecking/typeChecker.h"
 #include "ir/ir.h"
@@ -66,11 +69,20 @@ struct TypeSpecializationMap : public IHasDbPrint {
     // Keep track of the values in the above map which are already
     // inserted in the program.
     std::set<TypeSpecialization *> inserted;
+    /// The distinct values of the above map, indexed by key(), so that equal
+    /// instantiations are found without comparing with every specialization.
+    std::unordered_map<cstring, std::vector<TypeSpecialization *>> byKey;
+    /// The keys of the above map, indexed by the name of the specialized declaration.
+    std::unordered_map<cstring, std::vector<const IR::Type_Specialized *>> byDeclaration;
 
     void add(const IR::Type_Specialized *t, const IR::Type_StructLike *decl,
              const IR::Node *insertion);
     TypeSpecialization *get(const IR::Type_Specialized *t) const;
     bool same(const TypeSpecialization *left, const IR::Type_Specialized *right) const;
+    /// A string identifying the base type and canonical type arguments of @p t,
+    /// equal for instantiations which are the same(), or nullptr if the type of
+    /// an argument is unknown.
+    cstring key(const IR::Type_Specialized *t) const;
     void dbprint(std::ostream &out) const override {
         for (auto it : map) {
             out << dbp(it.first) << " => " << it.second << std::endl;
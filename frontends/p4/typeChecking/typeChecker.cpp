@@ -154,8 +154,10 @@ Visitor::profile_t TypeInference::init_apply(const IR::Node *node) {
     if (node->is<IR::P4Program>()) {
         LOG3("Reference map for type checker:" << std::endl << refMap);
         LOG2("TypeInference for " << dbp(node));
+        typeMap->startInference();
     }
     initialNode = node;
+    initialErrorCount = ::errorCount();
     refMap->validateMap(node);
     return Transform::init_apply(node);
 }
@@ -165,12 +167,21 @@ void TypeInference::end_apply(const IR::Node *node) {
               "At this point in the compilation typechecking should not infer new types anymore, "
               "but it did.");
     typeMap->updateMap(node);
+    if (::errorCount() > initialErrorCount) typeMap->distrustInference();
     if (node->is<IR::P4Program>()) LOG3("Typemap: " << std::endl << typeMap);
     Transform::end_apply(node);
 }
 
 const IR::Node *TypeInference::apply_visitor(const IR::Node *orig, const char *name) {
+    // IR nodes are immutable, so a node typed by an earlier inference run
+    // still has the subtree that was checked then: only the subtrees that
+    // were replaced since need to be inferred again.
+    if (typeMap->inferredBefore(orig)) {
+        LOG3("TI Skipping " << dbp(orig) << ", inferred before");
+        return orig;
+    }
     const auto *transformed = Transform::apply_visitor(orig, name);
+    typeMap->markInferred(orig);
     BUG_CHECK(!readOnly || orig == transformed,
               "At this point in the compilation typechecking should not infer new types anymore, "
               "but it did: node %1% changed to %2%",
@@ -585,7 +596,10 @@ const IR::Node *TypeInference::preorder(IR::P4Program *program) {
     currentActionList = nullptr;
     if (typeMap->checkMap(getOriginal()) && readOnly) {
         LOG2("No need to typecheck");
+        typeMap->countUse(getOriginal(), ProgramMap::Use::Reused);
         prune();
+    } else {
+        typeMap->countUse(getOriginal(), ProgramMap::Use::Recomputed);
     }
     return program;
 }
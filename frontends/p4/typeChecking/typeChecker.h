@@ -86,6 +86,7 @@ class TypeInference : public Transform {
     // Output: type map
     TypeMap *typeMap;
     const IR::Node *initialNode;
+    unsigned initialErrorCount = 0;
 
  public:
     // @param readOnly If true it will assert that it behaves like
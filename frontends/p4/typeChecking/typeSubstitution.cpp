@@ -21,6 +21,34 @@ limitations under the License.
 #include "typeSubstitutionVisitor.h"
 
 namespace P4 {
+
+namespace {
+/// Collects the type variables occurring in a type.
+class CollectTypeVariables : public Inspector {
+    bool preorder(const IR::Type_Var *tv) override {
+        variables.push_back(tv);
+        return true;
+    }
+    bool preorder(const IR::Type_InfInt *tv) override {
+        variables.push_back(tv);
+        return true;
+    }
+    bool preorder(const IR::Type_Any *tv) override {
+        variables.push_back(tv);
+        return true;
+    }
+
+ public:
+    std::vector<const IR::ITypeVar *> variables;
+};
+}  // namespace
+
+void TypeVariableSubstitution::addUses(const IR::ITypeVar *var, const IR::Type *type) {
+    CollectTypeVariables collect;
+    type->apply(collect);
+    for (auto v : collect.variables) users[v].insert(var);
+}
+
 cstring TypeVariableSubstitution::compose(const IR::ITypeVar *var, const IR::Type *substitution) {
     LOG3("Adding " << var << "->" << dbp(substitution) << "=" << substitution
                    << " to substitution");
@@ -59,17 +87,24 @@ cstring TypeVariableSubstitution::compose(const IR::ITypeVar *var, const IR::Typ
 
     TypeVariableSubstitutionVisitor visitor(tvs);
     bool cycle = false;  // set if we detect X -> V and V -> X substitutions.
-    for (auto &bound : binding) {
-        const IR::Type *type = bound.second;
+    auto candidates = users.find(var);
+    // Copied, since refining the bindings adds uses.
+    auto dependent = candidates != users.end() ? candidates->second
+                                               : ordered_set<const IR::ITypeVar *>();
+    for (auto user : dependent) {
+        auto bound = binding.find(user);
+        if (bound == binding.end()) continue;
+        const IR::Type *type = bound->second;
         const IR::Node *newType = type->apply(visitor);
         if (newType == nullptr) return "Could not replace '%1%' with '%2%'";
         if (newType == type) continue;
 
-        if (bound.first->asType() == newType) {
+        if (bound->first->asType() == newType) {
             cycle = true;
         } else {
-            LOG3("Refining substitution for " << bound.first->getNode() << " to " << newType);
-            bound.second = newType->to<IR::Type>();
+            LOG3("Refining substitution for " << bound->first->getNode() << " to " << newType);
+            bound->second = newType->to<IR::Type>();
+            addUses(bound->first, bound->second);
         }
     }
 
@@ -93,6 +128,7 @@ void TypeVariableSubstitution::simpleCompose(const TypeVariableSubstitution *oth
             BUG("Changing binding for %1% from %2% to %3%", v.first, it->second, subst);
         LOG3("Setting substitution for " << v.first->getNode() << " to " << subst);
         binding[v.first] = subst;
+        addUses(v.first, subst);
     }
     debugValidate();
 }
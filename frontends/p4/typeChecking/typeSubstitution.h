@@ -22,6 +22,7 @@ limitations under the License.
 
 #include "ir/ir.h"
 #include "lib/exceptions.h"
+#include "lib/ordered_set.h"
 
 namespace P4 {
 
@@ -71,6 +72,12 @@ class TypeSubstitution : public IHasDbPrint {
 };
 
 class TypeVariableSubstitution final : public TypeSubstitution<const IR::ITypeVar *> {
+    /// For each type variable, the variables whose bound type may contain it;
+    /// compose() only needs to refine their bindings.  Entries may be stale.
+    std::map<const IR::ITypeVar *, ordered_set<const IR::ITypeVar *>> users;
+    /// Records that the binding of @p var is @p type.
+    void addUses(const IR::ITypeVar *var, const IR::Type *type);
+
  public:
     TypeVariableSubstitution() = default;
     TypeVariableSubstitution(const TypeVariableSubstitution &other) = default;
@@ -86,9 +93,14 @@ class TypeVariableSubstitution final : public TypeSubstitution<const IR::ITypeVa
     void debugValidate();
     bool setBinding(const IR::ITypeVar *id, const IR::Type *type) override {
         auto result = TypeSubstitution::setBinding(id, type);
+        if (result) addUses(id, type);
         debugValidate();
         return result;
     }
+    void clear() {
+        TypeSubstitution::clear();
+        users.clear();
+    }
 };
 
 }  // namespace P4
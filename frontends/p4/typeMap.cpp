@@ -46,7 +46,8 @@ bool TypeMap::typeIsEmpty(const IR::Type *type) const {
 
 void TypeMap::dbprint(std::ostream &out) const {
     out << "TypeMap for " << dbp(program) << std::endl;
-    for (auto it : typeMap) out << "\t" << dbp(it.first) << "->" << dbp(it.second) << std::endl;
+    for (auto it : typeMap)
+        out << "\t" << dbp(it.first) << "->" << dbp(it.second.type) << std::endl;
     out << "Left values" << std::endl;
     for (auto it : leftValues) out << "\t" << dbp(it) << std::endl;
     out << "Constants" << std::endl;
@@ -99,9 +100,9 @@ void TypeMap::checkPrecondition(const IR::Node *element, const IR::Type *type) c
 
 void TypeMap::setType(const IR::Node *element, const IR::Type *type) {
     checkPrecondition(element, type);
-    auto [it, inserted] = typeMap.emplace(element, type);
+    auto [it, inserted] = typeMap.emplace(element, TypeEntry{type, 0});
     if (!inserted) {
-        const IR::Type *existingType = it->second;
+        const IR::Type *existingType = it->second.type;
         if (!implicitlyConvertibleTo(type, existingType))
             BUG("Changing type of %1% in type map from %2% to %3%", dbp(element), dbp(existingType),
                 dbp(type));
@@ -112,7 +113,8 @@ void TypeMap::setType(const IR::Node *element, const IR::Type *type) {
 
 const IR::Type *TypeMap::getType(const IR::Node *element, bool notNull) const {
     CHECK_NULL(element);
-    const auto *result = get(typeMap, element);
+    auto it = typeMap.find(element);
+    const IR::Type *result = it != typeMap.end() ? it->second.type : nullptr;
     LOG4("Looking up type for " << dbp(element) << " => " << dbp(result));
     if (notNull && result == nullptr)
         BUG_CHECK(errorCount() > 0, "Could not find type for %1%", dbp(element));
@@ -332,24 +334,54 @@ bool TypeMap::implicitlyConvertibleTo(const IR::Type *from, const IR::Type *to)
 }
 
 // Used for tuples, stacks and lists only
+size_t TypeMap::structuralHash(const IR::Type *type, unsigned depth) {
+    if (type == nullptr) return 0;
+    // Only look at what equivalent() compares structurally; everything else
+    // is hashed by its node type alone, which is always safe.  Nesting is
+    // bounded, deeper types simply collide.
+    size_t result = Util::Hash{}(type->node_type_name());
+    if (depth > 3) return result;
+    if (auto tb = type->to<IR::Type_Bits>()) {
+        return Util::Hash{}(result, tb->width_bits(), tb->isSigned);
+    } else if (auto tt = type->to<IR::Type_Type>()) {
+        return Util::hash_combine(result, structuralHash(tt->type, depth + 1));
+    } else if (auto ts = type->to<IR::Type_Stack>()) {
+        result = Util::hash_combine(result, structuralHash(ts->elementType, depth + 1));
+        if (ts->sizeKnown()) result = Util::hash_combine(result, ts->getSize());
+        return result;
+    } else if (auto tl = type->to<IR::Type_P4List>()) {
+        return Util::hash_combine(result, structuralHash(tl->elementType, depth + 1));
+    } else if (auto tt = type->to<IR::Type_BaseList>()) {
+        result = Util::hash_combine(result, tt->components.size());
+        for (auto c : tt->components)
+            result = Util::hash_combine(result, structuralHash(c, depth + 1));
+        return result;
+    } else if (auto ts = type->to<IR::Type_StructLike>()) {
+        // struct names are not hashed: Type_UnknownStruct matches any name
+        result = Util::hash_combine(result, ts->fields.size());
+        for (auto f : ts->fields) {
+            result = Util::Hash{}(result, f->name.name);
+            result = Util::hash_combine(result, structuralHash(f->type, depth + 1));
+        }
+        return result;
+    } else if (auto te = type->to<IR::Type_Enum>()) {
+        return Util::Hash{}(result, te->name.name);
+    } else if (auto te = type->to<IR::Type_SerEnum>()) {
+        return Util::Hash{}(result, te->name.name);
+    }
+    return result;
+}
+
 const IR::Type *TypeMap::getCanonical(const IR::Type *type) {
-    // Currently a linear search; hopefully this won't be too expensive in practice
-    std::vector<const IR::Type *> *searchIn;
-    if (type->is<IR::Type_Stack>())
-        searchIn = &canonicalStacks;
-    else if (type->is<IR::Type_Tuple>())
-        searchIn = &canonicalTuples;
-    else if (type->is<IR::Type_List>())
-        searchIn = &canonicalLists;
-    else if (type->is<IR::Type_P4List>())
-        searchIn = &canonicalP4lists;
-    else
+    if (!type->is<IR::Type_Stack>() && !type->is<IR::Type_Tuple>() &&
+        !type->is<IR::Type_List>() && !type->is<IR::Type_P4List>())
         BUG("%1%: unexpected type", type);
 
-    for (auto t : *searchIn) {
+    auto &candidates = canonicalTypes[structuralHash(type)];
+    for (auto t : candidates) {
         if (equivalent(type, t, true)) return t;
     }
-    searchIn->push_back(type);
+    candidates.push_back(type);
     return type;
 }
 
@@ -41,13 +41,22 @@ Objects that have a type in the map:
 class TypeMap final : public ProgramMap {
     // We want to have the same canonical type for two
     // different tuples, lists, stacks, or p4lists with the same signature.
-    std::vector<const IR::Type *> canonicalTuples;
-    std::vector<const IR::Type *> canonicalStacks;
-    std::vector<const IR::Type *> canonicalP4lists;
-    std::vector<const IR::Type *> canonicalLists;
+    // Canonical types are bucketed by a structural hash that is consistent
+    // with equivalent(), so only a few candidates are ever compared.
+    absl::flat_hash_map<size_t, std::vector<const IR::Type *>> canonicalTypes;
 
-    // Map each node to its canonical type
-    absl::flat_hash_map<const IR::Node *, const IR::Type *, Util::Hash> typeMap;
+    // Map each node to its canonical type, together with the last type
+    // inference run that visited its whole subtree (0 if none did, e.g.
+    // because the type was set by some other pass).
+    struct TypeEntry {
+        const IR::Type *type;
+        unsigned generation;
+    };
+    absl::flat_hash_map<const IR::Node *, TypeEntry, Util::Hash> typeMap;
+    // Number of type inference runs over whole programs so far; entries
+    // recorded in runs before 'trustedGeneration' are not reused.
+    unsigned generation = 0;
+    unsigned trustedGeneration = 1;
     // All left-values in the program.
     absl::flat_hash_set<const IR::Expression *, Util::Hash> leftValues;
     // All compile-time constants.  A compile-time constant
@@ -60,6 +69,8 @@ class TypeMap final : public ProgramMap {
 
     // checks some preconditions before setting the type
     void checkPrecondition(const IR::Node *element, const IR::Type *type) const;
+    // Hash of the structure of a type; equivalent types have equal hashes.
+    static size_t structuralHash(const IR::Type *type, unsigned depth = 0);
 
  public:
     TypeMap() : ProgramMap("TypeMap"), strictStruct(false) {}
@@ -70,6 +81,25 @@ class TypeMap final : public ProgramMap {
     void setStrictStruct(bool value) { strictStruct = value; }
     bool contains(const IR::Node *element) { return typeMap.count(element) != 0; }
     void setType(const IR::Node *element, const IR::Type *type);
+    /// Starts a new type inference run over a whole program.
+    void startInference() { ++generation; }
+    /// Records that the current inference run has visited the whole subtree
+    /// of @p element.  Has no effect on nodes without a type.
+    void markInferred(const IR::Node *element) {
+        auto it = typeMap.find(element);
+        if (it != typeMap.end()) it->second.generation = generation;
+    }
+    /// Called when an inference run reported errors: the types recorded so far
+    /// may be incomplete and must not be reused by later runs.
+    void distrustInference() { trustedGeneration = generation + 1; }
+    /// True if @p element, and therefore its whole (immutable) subtree, was
+    /// type checked by an earlier, successful inference run.  Such subtrees
+    /// have not been replaced since and need not be inferred again.
+    bool inferredBefore(const IR::Node *element) const {
+        auto it = typeMap.find(element);
+        return it != typeMap.end() && it->second.generation >= trustedGeneration &&
+               it->second.generation < generation;
+    }
     const IR::Type *getType(const IR::Node *element, bool notNull = false) const;
     // unwraps a TypeType into its contents
     const IR::Type *getTypeType(const IR::Node *element, bool notNull) const;
@@ -21,6 +21,100 @@ limitations under the License.
 
 namespace P4 {
 
+Visitor::profile_t FindLiveDeclarations::init_apply(const IR::Node *node) {
+    live->clear();
+    uses.clear();
+    roots.clear();
+    removable.clear();
+    return Inspector::init_apply(node);
+}
+
+/// Mirrors the decisions of RemoveUnusedDeclarations: returns true if @node is
+/// a declaration that RemoveUnusedDeclarations removes when it is unused.
+bool FindLiveDeclarations::isRemovable(const IR::Node *node, const IR::Node *parent) {
+    auto it = removable.find(node);
+    if (it != removable.end()) return it->second;
+    bool result = false;
+    if (node->is<IR::P4Control>() || node->is<IR::P4Parser>() || node->is<IR::P4Table>() ||
+        node->is<IR::Type_Enum>() || node->is<IR::Type_SerEnum>()) {
+        result = true;
+    } else if (auto state = node->to<IR::ParserState>()) {
+        result = state->name != IR::ParserState::accept &&
+                 state->name != IR::ParserState::reject && state->name != IR::ParserState::start;
+    } else if (node->is<IR::Type_Error>() || node->is<IR::Declaration_MatchKind>() ||
+               node->is<IR::Type_StructLike>() || node->is<IR::Type_Extern>() ||
+               node->is<IR::Parameter>() || node->is<IR::NamedExpression>() ||
+               node->is<IR::Type_Var>() || node->is<IR::Method>()) {
+        result = false;
+    } else if (node->is<IR::Declaration>() || node->is<IR::Type_Declaration>()) {
+        auto name = node->to<IR::IDeclaration>()->getName().name;
+        bool topLevel = parent != nullptr && parent->is<IR::P4Program>();
+        // Internal identifiers and the top-level verify are never removed.
+        result = !(name == IR::ParserState::verify && topLevel) && !name.startsWith("__");
+        if (auto var = node->to<IR::Declaration_Variable>()) {
+            result = result && (var->initializer == nullptr ||
+                                !SideEffects::check(var->initializer, this, nullptr, nullptr));
+        } else if (auto inst = node->to<IR::Declaration_Instance>()) {
+            auto type = inst->type;
+            if (auto st = type->to<IR::Type_Specialized>()) type = st->baseType;
+            if (auto tn = type->to<IR::Type_Name>())
+                type = refMap->getDeclaration(tn->path, true)->to<IR::Type>();
+            result = result && !(name == IR::P4Program::main && topLevel) &&
+                     !type->is<IR::Type_Extern>();
+        }
+    }
+    removable.emplace(node, result);
+    return result;
+}
+
+/// RemoveUnusedDeclarations does not look for declarations inside these nodes.
+static bool prunesChildren(const IR::Node *node) {
+    return node->is<IR::P4Table>() || node->is<IR::Declaration_Variable>() ||
+           node->is<IR::Declaration_Instance>() || node->is<IR::Type_Enum>() ||
+           node->is<IR::Type_SerEnum>() || node->is<IR::Type_Error>() ||
+           node->is<IR::Declaration_MatchKind>() || node->is<IR::Type_StructLike>() ||
+           node->is<IR::Type_Extern>() || node->is<IR::Type_Method>() || node->is<IR::Type_Var>();
+}
+
+/// Returns the innermost removable declaration containing the current node,
+/// or nullptr if there is none.
+const IR::IDeclaration *FindLiveDeclarations::owner() {
+    std::vector<const Visitor::Context *> enclosing;
+    for (auto ctxt = getContext(); ctxt != nullptr; ctxt = ctxt->parent) enclosing.push_back(ctxt);
+    const IR::IDeclaration *result = nullptr;
+    for (auto it = enclosing.rbegin(); it != enclosing.rend(); ++it) {
+        auto node = (*it)->node;
+        if (isRemovable(node, (*it)->parent ? (*it)->parent->node : nullptr))
+            result = node->to<IR::IDeclaration>();
+        if (prunesChildren(node)) break;
+    }
+    return result;
+}
+
+void FindLiveDeclarations::postorder(const IR::Path *path) {
+    auto decl = refMap->getDeclaration(path);
+    if (decl == nullptr) return;
+    if (auto o = owner())
+        uses[o].push_back(decl);
+    else
+        roots.push_back(decl);
+}
+
+void FindLiveDeclarations::end_apply() {
+    std::vector<const IR::IDeclaration *> worklist;
+    for (auto decl : roots)
+        if (live->insert(decl).second) worklist.push_back(decl);
+    while (!worklist.empty()) {
+        auto decl = worklist.back();
+        worklist.pop_back();
+        auto it = uses.find(decl);
+        if (it == uses.end()) continue;
+        for (auto used : it->second)
+            if (live->insert(used).second) worklist.push_back(used);
+    }
+    LOG2(live->size() << " live declarations");
+}
+
 Visitor::profile_t RemoveUnusedDeclarations::init_apply(const IR::Node *node) {
     LOG4("Reference map " << refMap);
     return Transform::init_apply(node);
@@ -35,7 +129,7 @@ bool RemoveUnusedDeclarations::giveWarning(const IR::Node *node) {
 
 const IR::Node *RemoveUnusedDeclarations::preorder(IR::Type_Enum *type) {
     prune();  // never remove individual enum members
-    if (!refMap->isUsed(getOriginal<IR::Type_Enum>())) {
+    if (!isUsed(getOriginal<IR::Type_Enum>())) {
         LOG3("Removing " << type);
         return nullptr;
     }
@@ -44,7 +138,7 @@ const IR::Node *RemoveUnusedDeclarations::preorder(IR::Type_Enum *type) {
 
 const IR::Node *RemoveUnusedDeclarations::preorder(IR::Type_SerEnum *type) {
     prune();  // never remove individual enum members
-    if (!refMap->isUsed(getOriginal<IR::Type_SerEnum>())) {
+    if (!isUsed(getOriginal<IR::Type_SerEnum>())) {
         LOG3("Removing " << type);
         return nullptr;
     }
@@ -53,7 +147,7 @@ const IR::Node *RemoveUnusedDeclarations::preorder(IR::Type_SerEnum *type) {
 
 const IR::Node *RemoveUnusedDeclarations::preorder(IR::P4Control *cont) {
     auto orig = getOriginal<IR::P4Control>();
-    if (!refMap->isUsed(orig)) {
+    if (!isUsed(orig)) {
         if (giveWarning(orig))
             warn(ErrorType::WARN_UNUSED, "Control %2% is not used; removing", cont,
                  cont->externalName());
@@ -70,7 +164,7 @@ const IR::Node *RemoveUnusedDeclarations::preorder(IR::P4Control *cont) {
 
 const IR::Node *RemoveUnusedDeclarations::preorder(IR::P4Parser *parser) {
     auto orig = getOriginal<IR::P4Parser>();
-    if (!refMap->isUsed(orig)) {
+    if (!isUsed(orig)) {
         if (giveWarning(orig))
             warn(ErrorType::WARN_UNUSED, "Parser %2% is not used; removing", parser,
                  parser->externalName());
@@ -86,7 +180,7 @@ const IR::Node *RemoveUnusedDeclarations::preorder(IR::P4Parser *parser) {
 }
 
 const IR::Node *RemoveUnusedDeclarations::preorder(IR::P4Table *table) {
-    if (!refMap->isUsed(getOriginal<IR::IDeclaration>())) {
+    if (!isUsed(getOriginal<IR::IDeclaration>())) {
         if (giveWarning(getOriginal()))
             warn(ErrorType::WARN_UNUSED, "Table %1% is not used; removing", table);
         LOG3("Removing " << table);
@@ -110,7 +204,7 @@ const IR::Node *RemoveUnusedDeclarations::process(const IR::IDeclaration *decl)
     if (decl->getName().name.startsWith("__"))
         // Internal identifiers, e.g., __v1model_version
         return decl->getNode();
-    if (refMap->isUsed(getOriginal<IR::IDeclaration>())) return decl->getNode();
+    if (isUsed(getOriginal<IR::IDeclaration>())) return decl->getNode();
     LOG3("Removing " << getOriginal());
     prune();  // no need to go deeper
     return nullptr;
@@ -126,7 +220,7 @@ const IR::Node *RemoveUnusedDeclarations::preorder(IR::Parameter *param) {
 }
 
 const IR::Node *RemoveUnusedDeclarations::warnIfUnused(const IR::Node *node) {
-    if (!refMap->isUsed(getOriginal<IR::IDeclaration>()))
+    if (!isUsed(getOriginal<IR::IDeclaration>()))
         if (giveWarning(getOriginal())) warn(ErrorType::WARN_UNUSED, "'%1%' is unused", node);
     return node;
 }
@@ -134,7 +228,7 @@ const IR::Node *RemoveUnusedDeclarations::warnIfUnused(const IR::Node *node) {
 const IR::Node *RemoveUnusedDeclarations::preorder(IR::Declaration_Instance *decl) {
     // Don't delete instances; they may have consequences on the control-plane API
     if (decl->getName().name == IR::P4Program::main && getParent<IR::P4Program>()) return decl;
-    if (!refMap->isUsed(getOriginal<IR::Declaration_Instance>())) {
+    if (!isUsed(getOriginal<IR::Declaration_Instance>())) {
         if (giveWarning(getOriginal())) warn(ErrorType::WARN_UNUSED, "%1%: unused instance", decl);
         // We won't delete extern instances; these may be useful even if not references.
         auto type = decl->type;
@@ -155,7 +249,7 @@ const IR::Node *RemoveUnusedDeclarations::preorder(IR::ParserState *state) {
         state->name == IR::ParserState::start)
         return state;
 
-    if (refMap->isUsed(getOriginal<IR::ParserState>())) return state;
+    if (isUsed(getOriginal<IR::ParserState>())) return state;
     LOG3("Removing " << state);
     prune();
     return nullptr;
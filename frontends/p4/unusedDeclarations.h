@@ -23,6 +23,45 @@ limitations under the License.
 
 namespace P4 {
 
+/** @brief Computes the declarations that are transitively used.
+ *
+ * A declaration is live if it is referenced from code outside all the
+ * declarations that RemoveUnusedDeclarations could remove, or from a
+ * live declaration.  So, unlike ReferenceMap::isUsed, a chain or a
+ * cycle of declarations which are only referenced by each other is not
+ * live, and can be removed by a single run of RemoveUnusedDeclarations.
+ *
+ * @pre Requires an up-to-date ReferenceMap.
+ */
+class FindLiveDeclarations : public Inspector {
+    const ReferenceMap *refMap;
+    std::set<const IR::IDeclaration *> *live;
+    /// For each removable declaration, the declarations referenced in its
+    /// body outside nested removable declarations.
+    std::map<const IR::IDeclaration *, std::vector<const IR::IDeclaration *>> uses;
+    /// Declarations referenced outside all removable declarations.
+    std::vector<const IR::IDeclaration *> roots;
+    /// Memoizes isRemovable.
+    std::map<const IR::Node *, bool> removable;
+
+    bool isRemovable(const IR::Node *node, const IR::Node *parent);
+    const IR::IDeclaration *owner();
+
+ public:
+    FindLiveDeclarations(const ReferenceMap *refMap, std::set<const IR::IDeclaration *> *live)
+        : refMap(refMap), live(live) {
+        CHECK_NULL(refMap);
+        CHECK_NULL(live);
+        // A shared subtree must be attributed to each of its owners.
+        visitDagOnce = false;
+        setName("FindLiveDeclarations");
+    }
+
+    Visitor::profile_t init_apply(const IR::Node *root) override;
+    void postorder(const IR::Path *path) override;
+    void end_apply() override;
+};
+
 /** @brief Removes unused declarations.
  *
  * The following kinds of nodes are not removed even if they are unreferenced:
@@ -43,10 +82,14 @@ namespace P4 {
  * compilation warning is emitted when a new node is added to @warned,
  * preventing duplicate warnings per node.
  *
+ * If @live is non-null, a declaration is unused if it is not in @live,
+ * as computed by FindLiveDeclarations, instead of not being referenced.
+ *
  * @pre Requires an up-to-date ReferenceMap.
  */
 class RemoveUnusedDeclarations : public Transform {
     const ReferenceMap *refMap;
+    const std::set<const IR::IDeclaration *> *live;
 
     /** If not null, logs the following unused elements in @warn:
      *  - unused IR::P4Table nodes
@@ -62,6 +105,9 @@ class RemoveUnusedDeclarations : public Transform {
      * @return true if @node is added to @warned.
      */
     bool giveWarning(const IR::Node *node);
+    bool isUsed(const IR::IDeclaration *decl) const {
+        return live ? live->count(decl) != 0 : refMap->isUsed(decl);
+    }
     const IR::Node *process(const IR::IDeclaration *decl);
     const IR::Node *warnIfUnused(const IR::Node *node);
 
@@ -69,8 +115,9 @@ class RemoveUnusedDeclarations : public Transform {
     // Prevent direct instantiations of this class.
     friend class RemoveAllUnusedDeclarations;
     explicit RemoveUnusedDeclarations(const ReferenceMap *refMap,
-                                      std::set<const IR::Node *> *warned = nullptr)
-        : refMap(refMap), warned(warned) {
+                                      std::set<const IR::Node *> *warned = nullptr,
+                                      const std::set<const IR::IDeclaration *> *live = nullptr)
+        : refMap(refMap), live(live), warned(warned) {
         CHECK_NULL(refMap);
         setName("RemoveUnusedDeclarations");
     }
@@ -130,6 +177,10 @@ class RemoveUnusedDeclarations : public Transform {
 };
 
 /** @brief Iterates RemoveUnusedDeclarations until convergence.
+ *
+ * Each iteration removes all the declarations that FindLiveDeclarations
+ * finds dead, so chains of dead declarations are removed at once; the
+ * last iteration only checks that nothing is left to remove.
  *
  * If @warn is true, emit compiler warnings if an unused instance of an
  * IR::P4Table or IR::Declaration_Instance is removed.
@@ -145,9 +196,12 @@ class RemoveAllUnusedDeclarations : public PassManager {
         std::set<const IR::Node *> *warned = nullptr;
         if (warn) warned = new std::set<const IR::Node *>();
 
+        auto live = new std::set<const IR::IDeclaration *>();
+
         refMap->clear();
         passes.emplace_back(new PassRepeated{new ResolveReferences(refMap),
-                                             new RemoveUnusedDeclarations(refMap, warned)});
+                                             new FindLiveDeclarations(refMap, live),
+                                             new RemoveUnusedDeclarations(refMap, warned, live)});
         setName("RemoveAllUnusedDeclarations");
         setStopOnError(true);
     }
@@ -9,7 +9,7 @@ using Parser = P4::P4Parser;
 #undef  YY_DECL
 #define YY_DECL Parser::symbol_type P4::P4Lexer::yylex(P4::P4ParserDriver& driver)
 
-#define YY_USER_ACTION driver.onReadToken(yytext);
+#define YY_USER_ACTION driver.onReadToken(std::string_view(yytext, yyleng));
 #define YY_USER_INIT driver.saveState = NORMAL
 #define yyterminate() return Parser::make_END(driver.yylloc);
 
@@ -9,6 +9,7 @@
 #include <boost/format.hpp>
 
 #include "frontends/common/constantFolding.h"
+#include "frontends/common/constantParsing.h"
 #include "frontends/common/options.h"
 #include "frontends/parsers/p4/p4AnnotationLexer.hpp"
 #include "frontends/parsers/p4/p4lexer.hpp"
@@ -69,11 +70,10 @@ AbstractParserDriver::AbstractParserDriver() : sources(new Util::InputSources) {
 
 AbstractParserDriver::~AbstractParserDriver() {}
 
-void AbstractParserDriver::onReadToken(const char *text) {
-    auto posBeforeToken = sources->getCurrentPosition();
+void AbstractParserDriver::onReadToken(std::string_view text) {
+    auto offsetBeforeToken = sources->getCurrentOffset();
     sources->appendText(text);
-    auto posAfterToken = sources->getCurrentPosition();
-    yylloc = Util::SourceInfo(sources, posBeforeToken, posAfterToken);
+    yylloc = Util::SourceInfo(sources, offsetBeforeToken, sources->getCurrentOffset());
 }
 
 void AbstractParserDriver::onReadLineNumber(const char *text) {
@@ -161,6 +161,27 @@ const T *P4ParserDriver::parse(P4AnnotationLexer::Type type, const Util::SourceI
     return nodes->front()->to<T>();
 }
 
+/// Returns the only token of @p body if it has type @p type, or nullptr.  The
+/// bodies of the most common annotations, such as @name and @id, are a single
+/// literal, whose value is built without running the parser.
+static const IR::AnnotationToken *singleToken(const IR::Vector<IR::AnnotationToken> &body,
+                                              P4Parser::token_type type) {
+    if (body.size() != 1 || body.front()->token_type != type) return nullptr;
+    return body.front();
+}
+
+static const IR::Constant *singleConstant(const IR::Vector<IR::AnnotationToken> &body) {
+    auto token = singleToken(body, P4Parser::token_type::TOK_INTEGER);
+    if (token == nullptr || token->constInfo == nullptr) return nullptr;
+    return ::parseConstant(token->srcInfo, *token->constInfo, 0);
+}
+
+static const IR::StringLiteral *singleStringLiteral(const IR::Vector<IR::AnnotationToken> &body) {
+    auto token = singleToken(body, P4Parser::token_type::TOK_STRING_LITERAL);
+    if (token == nullptr) return nullptr;
+    return new IR::StringLiteral(token->srcInfo, token->text);
+}
+
 /* static */ const IR::Vector<IR::Expression> *P4ParserDriver::parseExpressionList(
     const Util::SourceInfo &srcInfo, const IR::Vector<IR::AnnotationToken> &body) {
     P4ParserDriver driver;
@@ -203,12 +224,15 @@ const T *P4ParserDriver::parse(P4AnnotationLexer::Type type, const Util::SourceI
 
 /* static */ const IR::Constant *P4ParserDriver::parseConstant(
     const Util::SourceInfo &srcInfo, const IR::Vector<IR::AnnotationToken> &body) {
+    if (auto constant = singleConstant(body)) return constant;
     P4ParserDriver driver;
     return driver.parse<IR::Constant>(P4AnnotationLexer::INTEGER, srcInfo, body);
 }
 
 /* static */ const IR::Expression *P4ParserDriver::parseConstantOrStringLiteral(
     const Util::SourceInfo &srcInfo, const IR::Vector<IR::AnnotationToken> &body) {
+    if (auto constant = singleConstant(body)) return constant;
+    if (auto literal = singleStringLiteral(body)) return literal;
     P4ParserDriver driver;
     return driver.parse<IR::Expression>(P4AnnotationLexer::INTEGER_OR_STRING_LITERAL, srcInfo,
                                         body);
@@ -216,6 +240,7 @@ const T *P4ParserDriver::parse(P4AnnotationLexer::Type type, const Util::SourceI
 
 /* static */ const IR::StringLiteral *P4ParserDriver::parseStringLiteral(
     const Util::SourceInfo &srcInfo, const IR::Vector<IR::AnnotationToken> &body) {
+    if (auto literal = singleStringLiteral(body)) return literal;
     P4ParserDriver driver;
     return driver.parse<IR::StringLiteral>(P4AnnotationLexer::STRING_LITERAL, srcInfo, body);
 }
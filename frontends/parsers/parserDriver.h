@@ -20,6 +20,7 @@ limitations under the License.
 #include <cstdio>
 #include <iostream>
 #include <string>
+#include <string_view>
 
 #include "frontends/p4/symbol_table.h"
 #include "frontends/parsers/p4/abstractP4Lexer.hpp"
@@ -54,7 +55,7 @@ class AbstractParserDriver {
     void onReadComment(const char *text, bool lineComment);
 
     /// Notify that the lexer read a token. @text is the matched source text.
-    void onReadToken(const char *text);
+    void onReadToken(std::string_view text);
 
     /// Notify that the lexer read a line number from a #line directive.
     void onReadLineNumber(const char *text);
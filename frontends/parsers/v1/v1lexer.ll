@@ -9,7 +9,7 @@ using Parser = V1::V1Parser;
 #undef  YY_DECL
 #define YY_DECL Parser::symbol_type V1::V1Lexer::yylex(V1::V1ParserDriver& driver)
 
-#define YY_USER_ACTION driver.onReadToken(yytext);
+#define YY_USER_ACTION driver.onReadToken(std::string_view(yytext, yyleng));
 #define YY_USER_INIT driver.saveState = NORMAL
 #define yyterminate() return Parser::make_END(driver.yylloc);
 
@@ -0,0 +1,152 @@
+#include <cstring>
+#include <iterator>
+
+#include "frontends/common/constantParsing.h"
+#include "ir/binary_loader.h"
+#include "ir/binary_writer.h"
+#include "lib/exceptions.h"
+
+BinaryIRWriter::BinaryIRWriter(std::ostream &out) : out(out) {
+    writeBytes(IR::Binary::magic, sizeof(IR::Binary::magic));
+    writeUnsigned(IR::Binary::version);
+}
+
+void BinaryIRWriter::writeUnsigned(uint64_t v) {
+    while (v >= 0x80) {
+        out.put(static_cast<char>((v & 0x7f) | 0x80));
+        v >>= 7;
+    }
+    out.put(static_cast<char>(v));
+}
+
+void BinaryIRWriter::writeBytes(const void *data, size_t size) {
+    out.write(static_cast<const char *>(data), size);
+}
+
+void BinaryIRWriter::generateBigInt(const big_int &v) {
+    if (v >= 0 && v < 0x80) {
+        // The common case: a sign byte of 0 followed by a one byte magnitude.
+        out.put(0);
+        writeUnsigned(1);
+        out.put(static_cast<char>(v));
+        return;
+    }
+    std::vector<uint8_t> bytes;
+    boost::multiprecision::export_bits(boost::multiprecision::abs(v), std::back_inserter(bytes),
+                                       8);
+    out.put(v < 0 ? 1 : 0);
+    writeUnsigned(bytes.size());
+    writeBytes(bytes.data(), bytes.size());
+}
+
+void BinaryIRWriter::generate(cstring v) {
+    // 0 is the null string, 1 introduces a new string, and n > 1 refers to string n - 2.
+    if (v.isNull()) {
+        writeUnsigned(0);
+        return;
+    }
+    auto [it, fresh] = stringIndex.emplace(v, stringIndex.size());
+    if (!fresh) {
+        writeUnsigned(it->second + 2);
+        return;
+    }
+    writeUnsigned(1);
+    writeUnsigned(v.size());
+    writeBytes(v.c_str(), v.size());
+}
+
+void BinaryIRWriter::generate(const IR::Node &v) {
+    auto [it, fresh] = nodeIndex.emplace(&v, nodeIndex.size());
+    if (!fresh) {
+        writeUnsigned(it->second + 2);
+        return;
+    }
+    writeUnsigned(1);
+    generate(v.node_type_name());
+    v.toBinary(*this);
+}
+
+void BinaryIRWriter::generate(const UnparsedConstant *v) {
+    generate(v != nullptr);
+    if (!v) return;
+    generate(v->text);
+    generate(v->skip);
+    generate(v->base);
+    generate(v->hasWidth);
+}
+
+BinaryIRLoader::BinaryIRLoader(std::istream &in)
+    : buffer(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()) {
+    pos = reinterpret_cast<const uint8_t *>(buffer.data());
+    end = pos + buffer.size();
+    checkHeader();
+}
+
+BinaryIRLoader::BinaryIRLoader(const void *data, size_t size)
+    : pos(static_cast<const uint8_t *>(data)), end(pos + size) {
+    checkHeader();
+}
+
+void BinaryIRLoader::checkHeader() {
+    if (size_t(end - pos) < sizeof(IR::Binary::magic) + 1 ||
+        memcmp(pos, IR::Binary::magic, sizeof(IR::Binary::magic)) != 0)
+        return;
+    pos += sizeof(IR::Binary::magic);
+    headerOk = readUnsigned() == IR::Binary::version;
+}
+
+uint64_t BinaryIRLoader::readUnsigned() {
+    uint64_t v = 0;
+    for (unsigned shift = 0;; shift += 7) {
+        BUG_CHECK(pos < end && shift < 64, "truncated binary IR");
+        uint8_t b = *pos++;
+        v |= uint64_t(b & 0x7f) << shift;
+        if (!(b & 0x80)) return v;
+    }
+}
+
+void BinaryIRLoader::readBytes(void *data, size_t size) {
+    BUG_CHECK(size_t(end - pos) >= size, "truncated binary IR");
+    memcpy(data, pos, size);
+    pos += size;
+}
+
+big_int BinaryIRLoader::readBigInt() {
+    bool negative = false;
+    unpack(negative);
+    auto size = readUnsigned();
+    BUG_CHECK(size_t(end - pos) >= size, "truncated binary IR");
+    big_int v;
+    boost::multiprecision::import_bits(v, pos, pos + size, 8);
+    pos += size;
+    return negative ? big_int(-v) : v;
+}
+
+cstring BinaryIRLoader::readString() {
+    auto tag = readUnsigned();
+    if (tag == 0) return cstring();
+    if (tag >= 2) {
+        BUG_CHECK(tag - 2 < strings.size(), "bad string reference in binary IR");
+        return strings[tag - 2];
+    }
+    auto size = readUnsigned();
+    BUG_CHECK(size_t(end - pos) >= size, "truncated binary IR");
+    cstring s(std::string(reinterpret_cast<const char *>(pos), size));
+    pos += size;
+    strings.push_back(s);
+    return s;
+}
+
+void BinaryIRLoader::unpack(UnparsedConstant *&v) {
+    bool present = false;
+    unpack(present);
+    if (!present) {
+        v = nullptr;
+        return;
+    }
+    v = new UnparsedConstant;
+    unpack(v->text);
+    unpack(v->skip);
+    unpack(v->base);
+    unpack(v->hasWidth);
+}
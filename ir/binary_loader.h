@@ -0,0 +1,274 @@
+#ifndef IR_BINARY_LOADER_H_
+#define IR_BINARY_LOADER_H_
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ir/binary_writer.h"
+#include "ir/ir.h"
+#include "lib/big_int_util.h"
+#include "lib/bitvec.h"
+#include "lib/cstring.h"
+#include "lib/ltbitmatrix.h"
+#include "lib/map.h"
+#include "lib/match.h"
+#include "lib/ordered_map.h"
+#include "lib/ordered_set.h"
+#include "lib/safe_vector.h"
+
+/// Reads IR written by BinaryIRWriter.  The loader works on a contiguous buffer, which
+/// can either be read from a stream or supplied by the caller (e.g. an mmap'ed file,
+/// which must then outlive the loader).  Use valid() to check the file header before
+/// loading; malformed contents past the header are reported as compiler bugs, as such
+/// files can only come from a mismatched or corrupted cache.
+class BinaryIRLoader {
+    template <typename T>
+    class has_fromBinary {
+        typedef char small;
+        typedef struct {
+            char c[2];
+        } big;
+
+        template <typename C>
+        static small test(decltype(&C::fromBinary));
+        template <typename C>
+        static big test(...);
+
+     public:
+        static const bool value = sizeof(test<T>(0)) == sizeof(char);
+    };
+
+    std::string buffer;  // owns the data when it was read from a stream
+    const uint8_t *pos = nullptr;
+    const uint8_t *end = nullptr;
+    bool headerOk = false;
+    std::vector<cstring> strings;
+    std::vector<const IR::Node *> nodes;
+
+    void checkHeader();
+    /// Constructs a node of the named type, which must be a T.  Template nodes such as
+    /// IR::Vector<T> are not in the factory table and are built from the static type.
+    template <typename T>
+    const IR::Node *construct(cstring type) {
+        if (auto fn = get(IR::binary_unpacker_table, type)) return fn(*this);
+        if constexpr (has_fromBinary<T>::value) {
+            if constexpr (std::is_same<decltype(T::fromBinary(std::declval<BinaryIRLoader &>())),
+                                       T *>::value)
+                return T::fromBinary(*this);
+        }
+        BUG("%1%: unknown IR node type in binary IR", type);
+    }
+
+    template <typename C>
+    void unpackSequence(C &c) {
+        typename C::value_type temp;
+        for (auto n = readUnsigned(); n > 0; --n) {
+            unpack(temp);
+            c.insert(c.end(), temp);
+        }
+    }
+    template <typename C>
+    void unpackMap(C &c) {
+        std::pair<typename C::key_type, typename C::mapped_type> temp;
+        for (auto n = readUnsigned(); n > 0; --n) {
+            unpack(temp.first);
+            unpack(temp.second);
+            c.insert(temp);
+        }
+    }
+
+    template <typename T>
+    void unpack(safe_vector<T> &v) {
+        unpackSequence(v);
+    }
+    template <typename T>
+    void unpack(std::vector<T> &v) {
+        unpackSequence(v);
+    }
+    template <typename T>
+    void unpack(std::set<T> &v) {
+        unpackSequence(v);
+    }
+    template <typename T>
+    void unpack(ordered_set<T> &v) {
+        unpackSequence(v);
+    }
+    template <typename K, typename V, typename C, typename A>
+    void unpack(std::map<K, V, C, A> &v) {
+        unpackMap(v);
+    }
+    template <typename K, typename V, typename C, typename A>
+    void unpack(std::multimap<K, V, C, A> &v) {
+        unpackMap(v);
+    }
+    template <typename K, typename V, typename C, typename A>
+    void unpack(ordered_map<K, V, C, A> &v) {
+        unpackMap(v);
+    }
+
+    template <typename T, typename U>
+    void unpack(std::pair<T, U> &v) {
+        unpack(v.first);
+        unpack(v.second);
+    }
+
+    template <typename T>
+    void unpack(std::optional<T> &v) {
+        bool isValid = false;
+        unpack(isValid);
+        if (!isValid) {
+            v = std::nullopt;
+            return;
+        }
+        T value;
+        unpack(value);
+        v = std::move(value);
+    }
+
+    void unpack(bool &v) {
+        uint8_t b;
+        readBytes(&b, 1);
+        v = b != 0;
+    }
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type unpack(
+        T &v) {
+        v = static_cast<T>(readSigned());
+    }
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type
+    unpack(T &v) {
+        v = static_cast<T>(readUnsigned());
+    }
+    void unpack(double &v) { readBytes(&v, sizeof(v)); }
+    void unpack(big_int &v) { v = readBigInt(); }
+    void unpack(cstring &v) { v = readString(); }
+    void unpack(IR::ID &v) {
+        v.name = readString();
+        v.originalName = readString();
+    }
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value>::type unpack(T &v) {
+        v = static_cast<T>(readSigned());
+    }
+    void unpack(LTBitMatrix &m) {
+        if (auto s = readString()) s.c_str() >> m;
+    }
+    void unpack(bitvec &v) {
+        if (auto s = readString()) s.c_str() >> v;
+    }
+    void unpack(match_t &v) {
+        v.word0 = readBigInt();
+        v.word1 = readBigInt();
+    }
+    void unpack(UnparsedConstant *&v);
+
+    template <typename T>
+    typename std::enable_if<has_fromBinary<T>::value && !std::is_base_of<IR::INode, T>::value>::type
+    unpack(T *&v) {
+        bool present = false;
+        unpack(present);
+        v = present ? T::fromBinary(*this) : nullptr;
+    }
+    template <typename T>
+    typename std::enable_if<has_fromBinary<T>::value && !std::is_base_of<IR::INode, T>::value>::type
+    unpack(T &v) {
+        if constexpr (std::is_pointer<decltype(T::fromBinary(*this))>::value)
+            v = *T::fromBinary(*this);
+        else
+            v = T::fromBinary(*this);
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_base_of<IR::INode, T>::value>::type unpack(const T *&v) {
+        v = readNode<T>();
+    }
+    template <typename T>
+    typename std::enable_if<std::is_base_of<IR::INode, T>::value>::type unpack(T &v) {
+        auto *node = readNode<T>();
+        BUG_CHECK(node, "null %1% in binary IR", T::static_type_name());
+        v = *node;
+    }
+
+    template <typename T, size_t N>
+    void unpack(T (&v)[N]) {
+        for (auto &e : v) unpack(e);
+    }
+
+ public:
+    explicit BinaryIRLoader(std::istream &in);
+    BinaryIRLoader(const void *data, size_t size);
+
+    /// False if the data does not start with a binary IR header of the current version.
+    bool valid() const { return headerOk; }
+
+    uint64_t readUnsigned();
+    int64_t readSigned() {
+        auto v = readUnsigned();
+        return int64_t(v >> 1) ^ -int64_t(v & 1);
+    }
+    void readBytes(void *data, size_t size);
+    big_int readBigInt();
+    cstring readString();
+
+    /// Reads a node reference written by BinaryIRWriter::generate(const IR::Node &).
+    template <typename T = IR::Node>
+    const T *readNode() {
+        auto tag = readUnsigned();
+        if (tag == 0) return nullptr;
+        if (tag >= 2) {
+            BUG_CHECK(tag - 2 < nodes.size() && nodes[tag - 2], "bad node reference in binary IR");
+            return nodes[tag - 2]->template checkedTo<T>();
+        }
+        cstring type = readString();
+        size_t index = nodes.size();
+        nodes.push_back(nullptr);
+        nodes[index] = construct<T>(type);
+        return nodes[index]->template checkedTo<T>();
+    }
+
+    template <typename T>
+    BinaryIRLoader &operator>>(T &v) {
+        unpack(v);
+        return *this;
+    }
+};
+
+template <class T>
+IR::Vector<T>::Vector(BinaryIRLoader &bin) : VectorBase(bin) {
+    bin >> vec.mut();
+}
+template <class T>
+IR::Vector<T> *IR::Vector<T>::fromBinary(BinaryIRLoader &bin) {
+    return new Vector<T>(bin);
+}
+template <class T>
+IR::IndexedVector<T>::IndexedVector(BinaryIRLoader &bin) : Vector<T>(bin) {
+    // The declarations map is derived from the elements, so it is not saved.
+    for (auto el : *this) insertInMap(el);
+}
+template <class T>
+IR::IndexedVector<T> *IR::IndexedVector<T>::fromBinary(BinaryIRLoader &bin) {
+    return new IndexedVector<T>(bin);
+}
+template <class T, template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
+          class COMP /*= std::less<cstring>*/,
+          class ALLOC /*= std::allocator<std::pair<cstring, const T*>>*/>
+IR::NameMap<T, MAP, COMP, ALLOC>::NameMap(BinaryIRLoader &bin) : Node(bin) {
+    bin >> symbols;
+}
+template <class T, template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
+          class COMP /*= std::less<cstring>*/,
+          class ALLOC /*= std::allocator<std::pair<cstring, const T*>>*/>
+IR::NameMap<T, MAP, COMP, ALLOC> *IR::NameMap<T, MAP, COMP, ALLOC>::fromBinary(
+    BinaryIRLoader &bin) {
+    return new IR::NameMap<T, MAP, COMP, ALLOC>(bin);
+}
+
+#endif /* IR_BINARY_LOADER_H_ */
@@ -0,0 +1,206 @@
+#ifndef IR_BINARY_WRITER_H_
+#define IR_BINARY_WRITER_H_
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#include "ir/id.h"
+#include "ir/node.h"
+#include "lib/big_int_util.h"
+#include "lib/bitvec.h"
+#include "lib/cstring.h"
+#include "lib/ltbitmatrix.h"
+#include "lib/match.h"
+#include "lib/ordered_map.h"
+#include "lib/ordered_set.h"
+#include "lib/safe_vector.h"
+
+struct UnparsedConstant;
+
+namespace IR::Binary {
+
+/// Every binary IR file starts with these bytes followed by the format version.
+constexpr char magic[4] = {'P', '4', 'I', 'R'};
+/// Bump whenever the encoding changes; the IR classes themselves are not versioned, so
+/// a file can only be read by a compiler built from the same .def files.
+constexpr uint32_t version = 1;
+
+}  // namespace IR::Binary
+
+/// Compact binary counterpart of JSONGenerator.  The per-class toBinary methods are
+/// produced by the ir-generator, and write the fields in declaration order, the same
+/// order in which the generated BinaryIRLoader constructors read them back.
+///
+/// Integers are LEB128 varints (zigzag for signed types), strings are written once
+/// and then referred to by index, and an IR node reachable along several paths is
+/// written once and then referred to by index, so DAGs are preserved exactly.
+/// Source positions are not saved.
+class BinaryIRWriter {
+    template <typename T>
+    class has_toBinary {
+        typedef char small;
+        typedef struct {
+            char c[2];
+        } big;
+
+        template <typename C>
+        static small test(decltype(&C::toBinary));
+        template <typename C>
+        static big test(...);
+
+     public:
+        static const bool value = sizeof(test<T>(0)) == sizeof(char);
+    };
+
+    std::ostream &out;
+    std::unordered_map<const IR::Node *, uint64_t> nodeIndex;
+    std::unordered_map<cstring, uint64_t> stringIndex;
+
+    template <typename C>
+    void generateSequence(const C &c) {
+        writeUnsigned(c.size());
+        for (auto &e : c) generate(e);
+    }
+
+ public:
+    explicit BinaryIRWriter(std::ostream &out);
+
+    void writeUnsigned(uint64_t v);
+    void writeSigned(int64_t v) { writeUnsigned((uint64_t(v) << 1) ^ uint64_t(v >> 63)); }
+    void writeBytes(const void *data, size_t size);
+
+    template <typename T>
+    void generate(const safe_vector<T> &v) {
+        generateSequence(v);
+    }
+    template <typename T>
+    void generate(const std::vector<T> &v) {
+        generateSequence(v);
+    }
+    template <typename T>
+    void generate(const std::set<T> &v) {
+        generateSequence(v);
+    }
+    template <typename T>
+    void generate(const ordered_set<T> &v) {
+        generateSequence(v);
+    }
+    template <typename K, typename V, typename C, typename A>
+    void generate(const std::map<K, V, C, A> &v) {
+        generateSequence(v);
+    }
+    template <typename K, typename V, typename C, typename A>
+    void generate(const std::multimap<K, V, C, A> &v) {
+        generateSequence(v);
+    }
+    template <typename K, typename V, typename C, typename A>
+    void generate(const ordered_map<K, V, C, A> &v) {
+        generateSequence(v);
+    }
+
+    template <typename T, typename U>
+    void generate(const std::pair<T, U> &v) {
+        generate(v.first);
+        generate(v.second);
+    }
+
+    template <typename T>
+    void generate(const std::optional<T> &v) {
+        generate(v.has_value());
+        if (v) generate(*v);
+    }
+
+    void generate(bool v) { out.put(v ? 1 : 0); }
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+    generate(T v) {
+        writeSigned(v);
+    }
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type
+    generate(T v) {
+        writeUnsigned(v);
+    }
+    void generate(double v) { writeBytes(&v, sizeof(v)); }
+    template <typename T>
+    typename std::enable_if<std::is_same<T, big_int>::value>::type generate(const T &v) {
+        generateBigInt(v);
+    }
+    void generateBigInt(const big_int &v);
+
+    void generate(cstring v);
+    void generate(const IR::ID &v) {
+        generate(v.name);
+        generate(v.originalName);
+    }
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value>::type generate(T v) {
+        writeSigned(static_cast<int64_t>(v));
+    }
+    template <typename T>
+    typename std::enable_if<std::is_same<T, LTBitMatrix>::value>::type generate(const T &v) {
+        std::stringstream tmp;
+        tmp << v;
+        generate(cstring(tmp.str()));
+    }
+    void generate(const bitvec &v) {
+        std::stringstream tmp;
+        tmp << v;
+        generate(cstring(tmp.str()));
+    }
+    void generate(const match_t &v) {
+        generateBigInt(v.word0);
+        generateBigInt(v.word1);
+    }
+    void generate(const UnparsedConstant *v);
+
+    template <typename T>
+    typename std::enable_if<has_toBinary<T>::value && !std::is_base_of<IR::INode, T>::value>::type
+    generate(const T &v) {
+        v.toBinary(*this);
+    }
+    template <typename T>
+    typename std::enable_if<std::is_base_of<IR::INode, T>::value &&
+                            !std::is_base_of<IR::Node, T>::value>::type
+    generate(const T &v) {
+        generate(*v.getNode());
+    }
+
+    /// Writes 0 for a null node, an index for a node already written, or 1 followed by the
+    /// node type name and fields for a node seen for the first time.
+    void generate(const IR::Node &v);
+
+    template <typename T>
+    typename std::enable_if<std::is_pointer<T>::value &&
+                            has_toBinary<typename std::remove_pointer<T>::type>::value>::type
+    generate(T v) {
+        using Pointee = typename std::remove_cv<typename std::remove_pointer<T>::type>::type;
+        if constexpr (std::is_base_of<IR::INode, Pointee>::value) {
+            if (v)
+                generate(*v);
+            else
+                writeUnsigned(0);
+        } else {
+            generate(v != nullptr);
+            if (v) generate(*v);
+        }
+    }
+
+    template <typename T, size_t N>
+    void generate(const T (&v)[N]) {
+        for (auto &e : v) generate(e);
+    }
+
+    template <typename T>
+    BinaryIRWriter &operator<<(const T &v) {
+        generate(v);
+        return *this;
+    }
+};
+
+#endif /* IR_BINARY_WRITER_H_ */
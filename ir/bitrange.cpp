@@ -14,6 +14,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include "ir/binary_loader.h"
+#include "ir/binary_writer.h"
 #include "ir/json_generator.h"
 #include "ir/json_loader.h"
 
@@ -27,4 +29,12 @@ std::pair<int, int> rangeFromJSON(JSONLoader &json) {
     return endpoints;
 }
 
+void rangeToBinary(BinaryIRWriter &bin, int lo, int hi) { bin << lo << hi; }
+
+std::pair<int, int> rangeFromBinary(BinaryIRLoader &bin) {
+    std::pair<int, int> endpoints;
+    bin >> endpoints;
+    return endpoints;
+}
+
 }  // namespace BitRange
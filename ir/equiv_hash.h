@@ -0,0 +1,74 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef IR_EQUIV_HASH_H_
+#define IR_EQUIV_HASH_H_
+
+#include <string>
+#include <type_traits>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "ir/id.h"
+#include "ir/node.h"
+#include "lib/big_int_util.h"
+#include "lib/cstring.h"
+#include "lib/hash.h"
+
+namespace IR {
+
+class Expression;
+
+/// Hash of a non-Node field, as used by the generated computeEquivHash methods.  'equiv'
+/// compares such fields with ==, so equal values must hash the same.  Values of types
+/// not handled here contribute nothing, which is always consistent with 'equiv'.
+template <class T>
+size_t equivHashValue(const T &v) {
+    if constexpr (std::is_enum_v<T>)
+        return Util::Hash{}(static_cast<std::underlying_type_t<T>>(v));
+    else if constexpr (std::is_arithmetic_v<T> || std::is_pointer_v<T>)
+        return Util::Hash{}(v);
+    else
+        return 0;
+}
+inline size_t equivHashValue(cstring v) { return Util::Hash{}(v); }
+inline size_t equivHashValue(const std::string &v) { return Util::Hash{}(v); }
+inline size_t equivHashValue(const ID &v) { return Util::Hash{}(v.name); }
+inline size_t equivHashValue(const big_int &v) { return boost::multiprecision::hash_value(v); }
+
+/// Hash and equality functors that compare nodes by structure (equiv) rather than by
+/// identity.  Null pointers are allowed.
+struct EquivHash {
+    size_t operator()(const Node *n) const { return n ? n->equivHash() : 0; }
+};
+struct EquivEqual {
+    bool operator()(const Node *a, const Node *b) const { return equiv(a, b); }
+};
+
+/// Sets and maps keyed by the structure of the nodes, so that a lookup finds any node
+/// equiv to the one searched for.  Iteration order is unspecified.
+template <class T>
+using EquivSet = absl::flat_hash_set<const T *, EquivHash, EquivEqual>;
+template <class K, class V>
+using EquivMap = absl::flat_hash_map<const K *, V, EquivHash, EquivEqual>;
+
+using ExprSet = EquivSet<Expression>;
+template <class V>
+using ExprMap = EquivMap<Expression, V>;
+
+}  // namespace IR
+
+#endif /* IR_EQUIV_HASH_H_ */
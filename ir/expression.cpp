@@ -78,6 +78,17 @@ void IR::Constant::handleOverflow(bool noWarning) {
     }
 
     int width = tb->size;
+    if (width > 0 && width < 64 && Util::fitsInt64(value)) {
+        // Fast path for the common case of a narrow value that already fits.
+        auto v = static_cast<int64_t>(value);
+        if (tb->isSigned) {
+            int64_t max = (int64_t(1) << (width - 1)) - 1;
+            if (v >= -max - 1 && v <= max) return;
+        } else if (v >= 0 && v < (int64_t(1) << width)) {
+            return;
+        }
+    }
+
     big_int one = 1;
     big_int mask = Util::mask(width);
 
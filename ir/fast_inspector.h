@@ -0,0 +1,93 @@
+#ifndef IR_FAST_INSPECTOR_H_
+#define IR_FAST_INSPECTOR_H_
+
+#include <type_traits>
+
+#include "ir/ir.h"
+#include "ir/visitor.h"
+
+namespace IR {
+
+/// A read-only traversal for hot analyses, with handlers resolved at compile time.
+///
+/// `Derived` declares public `bool preorder(const IR::T *)` and `void postorder(const IR::T *)`
+/// handlers for the node classes it is interested in, like an Inspector.  If it declares any
+/// preorder (or postorder) handler, it must bring the catch-all one of FastInspector into
+/// scope with a using declaration:
+///
+///     class CountConstants : public IR::FastInspector<CountConstants> {
+///      public:
+///         using IR::FastInspector<CountConstants>::preorder;
+///         unsigned count = 0;
+///         bool preorder(const IR::Constant *) { ++count; return true; }
+///     };
+///     CountConstants counter;
+///     counter.apply(program);
+///
+/// Each node is dispatched by a switch on its typeId over IRNODE_ALL_CONCRETE_SUBCLASSES, so
+/// the handler for the exact class is picked by overload resolution and can be inlined,
+/// instead of going through the chain of virtual preorder/postorder calls of an Inspector.
+/// The children are visited through the nodes' own visit_children, in the same order and
+/// with the same special cases as for an Inspector.
+///
+/// There is none of the other Inspector machinery: nodes reachable along several paths are
+/// visited once per path (like an Inspector with visitDagOnce = false), there is no visitor
+/// Context, and there are no revisit hooks, flow analysis or parallel visits.
+template <class Derived>
+class FastInspector {
+    /// Feeds the children found by visit_children back to the FastInspector.
+    class ChildVisitor : public Visitor {
+        FastInspector &self;
+
+     public:
+        explicit ChildVisitor(FastInspector &self) : self(self) {}
+        const Node *apply_visitor(const Node *n, const char * = nullptr) override {
+            if (n) self.dispatch(n);
+            return n;
+        }
+    };
+    ChildVisitor children{*this};
+
+    Derived &derived() { return static_cast<Derived &>(*this); }
+
+    template <class T>
+    void visitAs(const T *n) {
+        if (!derived().preorder(n)) return;
+        // The dynamic type of n is T, so the children can be visited without a virtual call.
+        if constexpr (std::is_same_v<T, Node>)
+            n->visit_children(children);
+        else
+            n->T::visit_children(children);
+        derived().postorder(n);
+    }
+
+    void dispatch(const Node *n) {
+        switch (n->typeId()) {
+#define DISPATCH_CASE(CLASS, ...)         \
+    case RTTI::TypeInfo<IR::CLASS>::id(): \
+        return visitAs(static_cast<const IR::CLASS *>(n));
+            IRNODE_ALL_CONCRETE_SUBCLASSES(DISPATCH_CASE)
+#undef DISPATCH_CASE
+            default:
+                visitAs(n);
+        }
+    }
+
+ public:
+    FastInspector() = default;
+    FastInspector(const FastInspector &) = delete;
+    FastInspector &operator=(const FastInspector &) = delete;
+
+    /// Visits the tree rooted at @p root.
+    void apply(const Node *root) {
+        if (root) dispatch(root);
+    }
+
+    /// Catch-all handlers for the nodes Derived does not handle.
+    bool preorder(const Node *) { return true; }  // return 'false' to prune
+    void postorder(const Node *) {}
+};
+
+}  // namespace IR
+
+#endif /* IR_FAST_INSPECTOR_H_ */
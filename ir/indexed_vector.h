@@ -19,6 +19,7 @@ limitations under the License.
 
 #include "ir/declaration.h"
 #include "ir/vector.h"
+#include "lib/copy_on_write.h"
 #include "lib/enumerator.h"
 #include "lib/error.h"
 #include "lib/map.h"
@@ -27,6 +28,7 @@ limitations under the License.
 #include "lib/safe_vector.h"
 
 class JSONLoader;
+class BinaryIRLoader;
 
 namespace IR {
 
@@ -36,7 +38,8 @@ namespace IR {
  */
 template <class T>
 class IndexedVector : public Vector<T> {
-    ordered_map<cstring, const IDeclaration *> declarations;
+    // Shared between copies like the elements themselves.
+    copy_on_write<ordered_map<cstring, const IDeclaration *>> declarations;
     bool invalid = false;  // set when an error occurs; then we don't
                            // expect the validity check to succeed.
 
@@ -44,13 +47,13 @@ class IndexedVector : public Vector<T> {
         if (a == nullptr || !a->template is<IDeclaration>()) return;
         auto decl = a->template to<IDeclaration>();
         auto name = decl->getName().name;
-        auto previous = declarations.find(name);
-        if (previous != declarations.end()) {
+        auto previous = declarations->find(name);
+        if (previous != declarations->end()) {
             invalid = true;
             ::error(ErrorType::ERR_DUPLICATE, "%1%: Duplicates declaration %2%", a,
                     previous->second);
         } else {
-            declarations[name] = decl;
+            declarations.mut()[name] = decl;
         }
     }
     void removeFromMap(const T *a) {
@@ -58,9 +61,8 @@ class IndexedVector : public Vector<T> {
         auto decl = a->template to<IDeclaration>();
         if (decl == nullptr) return;
         cstring name = decl->getName().name;
-        auto it = declarations.find(name);
-        if (it == declarations.end()) BUG("%1% does not exist", a);
-        declarations.erase(it);
+        if (declarations->count(name) == 0) BUG("%1% does not exist", a);
+        declarations.mut().erase(name);
     }
 
  public:
@@ -81,10 +83,11 @@ class IndexedVector : public Vector<T> {
     }
     explicit IndexedVector(const Vector<T> &a) { insert(Vector<T>::end(), a.begin(), a.end()); }
     explicit IndexedVector(JSONLoader &json);
+    explicit IndexedVector(BinaryIRLoader &bin);
 
     void clear() {
         IR::Vector<T>::clear();
-        declarations.clear();
+        declarations = {};
     }
     // TODO: Although this is not a const_iterator, it should NOT
     // be used to modify the vector directly.  I don't know
@@ -92,19 +95,19 @@ class IndexedVector : public Vector<T> {
     typedef typename Vector<T>::iterator iterator;
 
     const IDeclaration *getDeclaration(cstring name) const {
-        auto it = declarations.find(name);
-        if (it == declarations.end()) return nullptr;
+        auto it = declarations->find(name);
+        if (it == declarations->end()) return nullptr;
         return it->second;
     }
     template <class U>
     const U *getDeclaration(cstring name) const {
-        auto it = declarations.find(name);
-        if (it == declarations.end()) return nullptr;
+        auto it = declarations->find(name);
+        if (it == declarations->end()) return nullptr;
         return it->second->template to<U>();
     }
     Util::Enumerator<const IDeclaration *> *getDeclarations() const {
         return Util::Enumerator<const IDeclaration *>::createEnumerator(
-            Values(declarations).begin(), Values(declarations).end());
+            Values(*declarations).begin(), Values(*declarations).end());
     }
     iterator erase(iterator i) {
         removeFromMap(*i);
@@ -139,6 +142,7 @@ class IndexedVector : public Vector<T> {
         push_back(el);
     }
     bool removeByName(cstring name) {
+        if (declarations->count(name) == 0) return false;
         for (auto it = begin(); it != end(); ++it) {
             auto decl = (*it)->template to<IDeclaration>();
             if (decl != nullptr && decl->getName() == name) {
@@ -201,13 +205,14 @@ class IndexedVector : public Vector<T> {
 
     void toJSON(JSONGenerator &json) const override;
     static IndexedVector<T> *fromJSON(JSONLoader &json);
+    static IndexedVector<T> *fromBinary(BinaryIRLoader &bin);
     void validate() const override {
         if (invalid) return;  // don't crash the compiler because an error happened
         for (auto el : *this) {
             auto decl = el->template to<IR::IDeclaration>();
             if (!decl) continue;
-            auto it = declarations.find(decl->getName());
-            BUG_CHECK(it != declarations.end() && it->second->getNode() == el->getNode(),
+            auto it = declarations->find(decl->getName());
+            BUG_CHECK(it != declarations->end() && it->second->getNode() == el->getNode(),
                       "invalid element %1%", el);
         }
     }
@@ -17,6 +17,9 @@ limitations under the License.
 #ifndef IR_IR_INLINE_H_
 #define IR_IR_INLINE_H_
 
+#include <utility>
+
+#include "ir/binary_writer.h"
 #include "ir/id.h"
 #include "ir/indexed_vector.h"
 #include "ir/json_generator.h"
@@ -77,8 +80,21 @@ IRNODE_ALL_TEMPLATES(DEFINE_APPLY_FUNCTIONS, inline)
 
 template <class T>
 void IR::Vector<T>::visit_children(Visitor &v) {
-    for (auto i = vec.begin(); i != vec.end();) {
-        const IR::Node *n = v.apply_visitor(*i);
+    // The elements may still be shared with the node this one was cloned from, so
+    // visit them through const access until the first one changes, and only then
+    // take a private copy to edit.
+    size_t unchanged = 0;
+    const IR::Node *n = nullptr;
+    for (; unchanged < vec->size(); ++unchanged) {
+        const T *el = (*vec)[unchanged];
+        n = v.apply_visitor(el);
+        if (n != el || !n) break;
+    }
+    if (unchanged == vec->size()) return;
+    bool visited = true;
+    for (auto i = begin() + unchanged; i != end();) {
+        if (!visited) n = v.apply_visitor(*i);
+        visited = false;
         if (!n && *i) {
             i = erase(i);
             continue;
@@ -90,8 +106,8 @@ void IR::Vector<T>::visit_children(Visitor &v) {
         }
         if (auto l = n->to<Vector<T>>()) {
             i = erase(i);
-            i = insert(i, l->vec.begin(), l->vec.end());
-            i += l->vec.size();
+            i = insert(i, l->vec->begin(), l->vec->end());
+            i += l->vec->size();
             continue;
         }
         if (const auto *v = n->to<VectorBase>()) {
@@ -121,7 +137,7 @@ void IR::Vector<T>::visit_children(Visitor &v) {
 }
 template <class T>
 void IR::Vector<T>::visit_children(Visitor &v) const {
-    for (auto &a : vec) v.visit(a);
+    for (auto &a : *vec) v.visit(a);
 }
 template <class T>
 void IR::Vector<T>::parallel_visit_children(Visitor &v) {
@@ -137,7 +153,7 @@ void IR::Vector<T>::toJSON(JSONGenerator &json) const {
     const char *sep = "";
     Node::toJSON(json);
     json << "," << std::endl << json.indent++ << "\"vec\" : [";
-    for (auto &k : vec) {
+    for (auto &k : *vec) {
         json << sep << std::endl << json.indent << k;
         sep = ",";
     }
@@ -147,13 +163,30 @@ void IR::Vector<T>::toJSON(JSONGenerator &json) const {
     }
     json << "]";
 }
+template <class T>
+void IR::Vector<T>::toBinary(BinaryIRWriter &bin) const {
+    Node::toBinary(bin);
+    bin << *vec;
+}
 
 std::ostream &operator<<(std::ostream &out, const IR::Vector<IR::Expression> &v);
 
 template <class T>
 void IR::IndexedVector<T>::visit_children(Visitor &v) {
-    for (auto i = begin(); i != end();) {
-        auto n = v.apply_visitor(*i);
+    // As in Vector<T>::visit_children, only take a private copy of the elements
+    // once one of them changes.
+    size_t unchanged = 0;
+    const IR::Node *n = nullptr;
+    for (; unchanged < Vector<T>::size(); ++unchanged) {
+        const T *el = std::as_const(*this)[unchanged];
+        n = v.apply_visitor(el);
+        if (n != el || !n) break;
+    }
+    if (unchanged == Vector<T>::size()) return;
+    bool visited = true;
+    for (auto i = begin() + unchanged; i != end();) {
+        if (!visited) n = v.apply_visitor(*i);
+        visited = false;
         if (!n && *i) {
             i = erase(i);
             continue;
@@ -186,7 +219,7 @@ void IR::IndexedVector<T>::toJSON(JSONGenerator &json) const {
     const char *sep = "";
     Vector<T>::toJSON(json);
     json << "," << std::endl << json.indent++ << "\"declarations\" : {";
-    for (const auto &k : declarations) {
+    for (const auto &k : *declarations) {
         json << sep << std::endl << json.indent << k.first << " : " << k.second;
         sep = ",";
     }
@@ -287,6 +320,13 @@ void IR::NameMap<T, MAP, COMP, ALLOC>::toJSON(JSONGenerator &json) const {
     }
     json << "}";
 }
+template <class T, template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
+          class COMP /*= std::less<cstring>*/,
+          class ALLOC /*= std::allocator<std::pair<cstring, const T*>>*/>
+void IR::NameMap<T, MAP, COMP, ALLOC>::toBinary(BinaryIRWriter &bin) const {
+    Node::toBinary(bin);
+    bin << symbols;
+}
 
 template <class KEY, class VALUE,
           template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
@@ -45,6 +45,7 @@ const Constant *getConstant(const Type *type, big_int v, const Util::SourceInfo
 
     auto *&result = CONSTANTS[{tb->width_bits(), type->typeId(), tb->isSigned, v}];
     if (result == nullptr) {
+        NodeArena::Bypass heap;
         result = new Constant(srcInfo, tb, v);
     }
 
@@ -67,6 +68,7 @@ const BoolLiteral *getBoolLiteral(bool value, const Util::SourceInfo &srcInfo) {
 
     auto *&result = LITERALS[value];
     if (result == nullptr) {
+        NodeArena::Bypass heap;
         result = new BoolLiteral(srcInfo, Type::Boolean::get(), value);
     }
     return result;
@@ -24,9 +24,11 @@ limitations under the License.
 #include "lib/enumerator.h"
 #include "lib/error.h"
 #include "lib/exceptions.h"
+#include "lib/hash.h"
 #include "lib/map.h"
 
 class JSONLoader;
+class BinaryIRLoader;
 
 namespace IR {
 
@@ -53,6 +55,7 @@ class NameMap : public Node {
     NameMap(const NameMap &) = default;
     NameMap(NameMap &&) = default;
     explicit NameMap(JSONLoader &);
+    explicit NameMap(BinaryIRLoader &);
     NameMap &operator=(const NameMap &) = default;
     NameMap &operator=(NameMap &&) = default;
     typedef typename map_t::value_type value_type;
@@ -142,12 +145,21 @@ class NameMap : public Node {
             if (el.first != it->first || !el.second->equiv(*(it++)->second)) return false;
         return true;
     }
+    size_t computeEquivHash() const override {
+        size_t h = Node::computeEquivHash();
+        for (auto &el : *this)
+            h = Util::hash_combine(h, Util::hash_combine(Util::Hash{}(el.first),
+                                                         el.second->equivHash()));
+        return h;
+    }
     cstring node_type_name() const override { return "NameMap<" + T::static_type_name() + ">"; }
     static cstring static_type_name() { return "NameMap<" + T::static_type_name() + ">"; }
     void visit_children(Visitor &v) override;
     void visit_children(Visitor &v) const override;
     void toJSON(JSONGenerator &json) const override;
     static NameMap<T, MAP, COMP, ALLOC> *fromJSON(JSONLoader &json);
+    void toBinary(BinaryIRWriter &bin) const override;
+    static NameMap<T, MAP, COMP, ALLOC> *fromBinary(BinaryIRLoader &bin);
 
     Util::Enumerator<const T *> *valueEnumerator() const {
         return Util::Enumerator<const T *>::createEnumerator(Values(symbols).begin(),
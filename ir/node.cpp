@@ -23,10 +23,14 @@ limitations under the License.
 // use in combination with "raise" below
 // #include <csignal>
 
+#include "ir/binary_loader.h"
+#include "ir/binary_writer.h"
 #include "ir/declaration.h"
 #include "ir/ir.h"
 #include "ir/json_generator.h"
 #include "ir/json_loader.h"
+#include "lib/arena.h"
+#include "lib/hash.h"
 #include "lib/indent.h"
 #include "lib/json.h"
 #include "lib/log.h"
@@ -45,7 +49,59 @@ void IR::Node::traceCreation() const {
     LOG5("Created node " << id);
 }
 
+namespace {
+thread_local IR::NodeArena *currentArena = nullptr;
+}  // namespace
+
+IR::NodeArena::NodeArena() : arena(new Util::Arena), prev(currentArena) { currentArena = this; }
+
+IR::NodeArena::~NodeArena() {
+    BUG_CHECK(currentArena == this, "NodeArena scopes destroyed out of order");
+    currentArena = prev;
+    delete arena;
+}
+
+Util::Arena *IR::NodeArena::current() {
+#if HAVE_LIBGC
+    return nullptr;
+#else
+    return currentArena ? currentArena->arena : nullptr;
+#endif /* HAVE_LIBGC */
+}
+
+IR::NodeArena::Bypass::Bypass() : saved(currentArena) { currentArena = nullptr; }
+
+IR::NodeArena::Bypass::~Bypass() { currentArena = saved; }
+
+#if !HAVE_LIBGC
+// Every node is preceded by a header recording the arena it was carved from
+// (nullptr for the regular heap), so operator delete knows what to do.
+namespace {
+constexpr std::size_t nodeHeaderSize = alignof(std::max_align_t);
+static_assert(nodeHeaderSize >= sizeof(Util::Arena *), "node header too small");
+}  // namespace
+
+void *IR::Node::operator new(std::size_t size) {
+    Util::Arena *arena = NodeArena::current();
+    void *mem = arena ? arena->allocate(size + nodeHeaderSize)
+                      : ::operator new(size + nodeHeaderSize);
+    *static_cast<Util::Arena **>(mem) = arena;
+    return static_cast<char *>(mem) + nodeHeaderSize;
+}
+
+void IR::Node::operator delete(void *p) {
+    if (p == nullptr) return;
+    void *mem = static_cast<char *>(p) - nodeHeaderSize;
+    // arena memory is only released with the arena itself
+    if (*static_cast<Util::Arena **>(mem) == nullptr) ::operator delete(mem);
+}
+#endif /* !HAVE_LIBGC */
+
+#ifdef MULTITHREAD
+std::atomic<int> IR::Node::currentId{0};
+#else
 int IR::Node::currentId = 0;
+#endif  // MULTITHREAD
 
 void IR::Node::toJSON(JSONGenerator &json) const {
     json << json.indent << "\"Node_ID\" : " << id << "," << std::endl
@@ -61,6 +117,28 @@ IR::Node::Node(JSONLoader &json) : id(-1) {
     clone_id = id;
 }
 
+void IR::Node::toBinary(BinaryIRWriter &bin) const { bin << id; }
+
+size_t IR::Node::equivHash() const {
+    if (equivHash_ == 0) {
+        size_t h = computeEquivHash();
+        // 0 marks a hash that has not been computed yet
+        equivHash_ = h ? h : 1;
+    }
+    return equivHash_;
+}
+
+size_t IR::Node::computeEquivHash() const { return Util::Hash{}(typeId()); }
+
+IR::Node::Node(BinaryIRLoader &bin) : id(-1) {
+    bin >> id;
+    if (id < 0)
+        id = currentId++;
+    else if (id >= currentId)
+        currentId = id + 1;
+    clone_id = id;
+}
+
 // Abbreviated debug print
 cstring IR::dbp(const IR::INode *node) {
     std::stringstream str;
@@ -112,18 +190,18 @@ Util::JsonObject *IR::Node::sourceInfoJsonObj() const {
     unsigned lineNumber, columnNumber;
     cstring fName = prepareSourceInfoForJSON(si, &lineNumber, &columnNumber);
     if (fName == nullptr) {
-        if (si.line == -1) {
-            // -1 is default value for objects when SourceInfo
-            // was not read from jsonFile using "--fromJSON" flag
+        const auto *detached = si.detached();
+        if (detached == nullptr) {
+            // SourceInfo was not read from jsonFile using "--fromJSON" flag
             return nullptr;
         } else {
             // Added source_info for jsonObject when "--fromJSON" flag is used
             // which parameters are saved in srcInfo fileds(filename, line, column and srcBrief)
             auto json1 = new Util::JsonObject();
-            json1->emplace("filename", srcInfo.filename);
-            json1->emplace("line", srcInfo.line);
-            json1->emplace("column", srcInfo.column);
-            json1->emplace("source_fragment", srcInfo.srcBrief);
+            json1->emplace("filename", detached->filename);
+            json1->emplace("line", detached->line);
+            json1->emplace("column", detached->column);
+            json1->emplace("source_fragment", detached->srcBrief);
             return json1;
         }
     } else {
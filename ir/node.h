@@ -17,8 +17,13 @@ limitations under the License.
 #ifndef IR_NODE_H_
 #define IR_NODE_H_
 
+#include <cstddef>
 #include <iosfwd>
+#ifdef MULTITHREAD
+#include <atomic>
+#endif  // MULTITHREAD
 
+#include "config.h"
 #include "ir-tree-macros.h"
 #include "ir/gen-tree-macro.h"
 #include "lib/castable.h"
@@ -33,8 +38,11 @@ class Modifier;
 class Transform;
 class JSONGenerator;
 class JSONLoader;
+class BinaryIRWriter;
+class BinaryIRLoader;
 
 namespace Util {
+class Arena;
 class JsonObject;
 }  // namespace Util
 
@@ -58,6 +66,34 @@ struct has_static_type_name<T, std::void_t<decltype(T::static_type_name())>> : s
 template <class T>
 inline constexpr bool has_static_type_name_v = has_static_type_name<T>::value;
 
+/// While a NodeArena is alive, IR nodes are allocated from a bump-pointer
+/// arena owned by it, and all of that memory is released at once when it is
+/// destroyed.  This is only effective when built without libgc
+/// (-DENABLE_GC=OFF), where nodes would otherwise be leaked one by one; with
+/// the garbage collector it does nothing.  No node created while the arena is
+/// active may be used after it is destroyed -- nodes interned in global caches
+/// (Type_Bits::get, getConstant, ...) allocate under a NodeArena::Bypass.
+class NodeArena {
+    Util::Arena *arena;
+    NodeArena *prev;
+
+ public:
+    NodeArena();
+    NodeArena(const NodeArena &) = delete;
+    ~NodeArena();
+    /// Innermost live arena of this thread, or nullptr.
+    static Util::Arena *current();
+    /// Allocate nodes from the regular heap for the lifetime of this object.
+    class Bypass {
+        NodeArena *saved;
+
+     public:
+        Bypass();
+        Bypass(const Bypass &) = delete;
+        ~Bypass();
+    };
+};
+
 // node interface
 class INode : public Util::IHasSourceInfo, public IHasDbPrint, public ICastable {
  public:
@@ -65,6 +101,7 @@ class INode : public Util::IHasSourceInfo, public IHasDbPrint, public ICastable
     virtual const Node *getNode() const = 0;
     virtual Node *getNode() = 0;
     virtual void toJSON(JSONGenerator &) const = 0;
+    virtual void toBinary(BinaryIRWriter &) const = 0;
     virtual cstring node_type_name() const = 0;
     virtual void validate() const {}
     virtual const Annotation *getAnnotation(cstring) const { return nullptr; }
@@ -106,7 +143,12 @@ class Node : public virtual INode {
     Node &operator=(Node &&) = default;
 
  protected:
+#ifdef MULTITHREAD
+    // nodes may be created concurrently by passes run over several declarations
+    static std::atomic<int> currentId;
+#else
     static int currentId;
+#endif  // MULTITHREAD
     void traceVisit(const char *visitor) const;
     virtual void visit_children(Visitor &) {}
     virtual void visit_children(Visitor &) const {}
@@ -116,6 +158,7 @@ class Node : public virtual INode {
     friend class ::Transform;
     cstring prepareSourceInfoForJSON(Util::SourceInfo &si, unsigned *lineNumber,
                                      unsigned *columnNumber) const;
+    mutable size_t equivHash_ = 0;  // cached equivHash(); 0 until computed
 
  public:
     Util::SourceInfo srcInfo;
@@ -130,6 +173,10 @@ class Node : public virtual INode {
         traceCreation();
     }
     virtual ~Node() {}
+#if !HAVE_LIBGC
+    static void *operator new(std::size_t size);
+    static void operator delete(void *p);
+#endif /* !HAVE_LIBGC */
     const Node *apply(Visitor &v, const Visitor_Context *ctxt = nullptr) const;
     const Node *apply(Visitor &&v, const Visitor_Context *ctxt = nullptr) const {
         return apply(v, ctxt);
@@ -144,9 +191,11 @@ class Node : public virtual INode {
     static cstring static_type_name() { return "Node"; }
     virtual int num_children() { return 0; }
     explicit Node(JSONLoader &json);
+    explicit Node(BinaryIRLoader &bin);
     cstring toString() const override { return node_type_name(); }
     void toJSON(JSONGenerator &json) const override;
     void sourceInfoToJSON(JSONGenerator &json) const;
+    void toBinary(BinaryIRWriter &bin) const override;
     Util::JsonObject *sourceInfoJsonObj() const;
     /* operator== does a 'shallow' comparison, comparing two Node subclass objects for equality,
      * and comparing pointers in the Node directly for equality */
@@ -154,6 +203,12 @@ class Node : public virtual INode {
     /* 'equiv' does a deep-equals comparison, comparing all non-pointer fields and recursing
      * though all Node subclass pointers to compare them with 'equiv' as well. */
     virtual bool equiv(const Node &a) const { return this->typeId() == a.typeId(); }
+    /* 'equivHash' is a structural hash consistent with 'equiv': nodes that are equiv hash
+     * the same.  It is computed on first use and cached in the node, so it must not be
+     * asked for while the node or anything it points to is still being modified.  Clones
+     * start with no cached hash.  'computeEquivHash' is generated for every IR class. */
+    size_t equivHash() const;
+    virtual size_t computeEquivHash() const;
 #define DEFINE_OPEQ_FUNC(CLASS, BASE) \
     virtual bool operator==(const CLASS &) const { return false; }
     IRNODE_ALL_SUBCLASSES(DEFINE_OPEQ_FUNC)
@@ -19,6 +19,7 @@ limitations under the License.
 
 #include "ir/node.h"
 #include "lib/cstring.h"
+#include "lib/hash.h"
 
 namespace IR {
 
@@ -85,6 +86,13 @@ class NodeMap : public Node {
             if (el.first != it->first || !el.second->equiv(*(it++)->second)) return false;
         return true;
     }
+    size_t computeEquivHash() const override {
+        size_t h = Node::computeEquivHash();
+        for (auto &el : *this)
+            h = Util::hash_combine(h, Util::hash_combine(Util::Hash{}(el.first),
+                                                         el.second->equivHash()));
+        return h;
+    }
     cstring node_type_name() const override {
         return "NodeMap<" + KEY::static_type_name() + "," + VALUE::static_type_name() + ">";
     }
@@ -16,15 +16,27 @@ limitations under the License.
 
 #include "pass_manager.h"
 
+#include <atomic>
+#include <chrono>  // NOLINT linter forbids using chrono, but we don't have alternatives
 #include <cstddef>
 #include <memory>
+#include <optional>
+#include <set>
 #include <ostream>
 #include <stdexcept>
 #include <string>
 #include <utility>
+#ifdef MULTITHREAD
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <thread>
+#endif  // MULTITHREAD
 
 #include "ir/dump.h"
+#include "ir/ir.h"
 #include "ir/node.h"
+#include "ir/pass_profile.h"
 #include "ir/visitor.h"
 #include "lib/error.h"
 #include "lib/gc.h"
@@ -32,6 +44,20 @@ limitations under the License.
 #include "lib/log.h"
 #include "lib/n4.h"
 
+bool PassManager::gc_checkpoints = false;
+bool PassManager::gc_disable_in_passes = false;
+
+namespace {
+
+/// Suppresses the collections triggered by heap growth while in scope.
+struct GcDisabled {
+    GcDisabled() { gc_disable(); }
+    GcDisabled(const GcDisabled &) = delete;
+    ~GcDisabled() { gc_enable(); }
+};
+
+}  // namespace
+
 void PassManager::removePasses(const std::vector<cstring> &exclude) {
     for (auto it : exclude) {
         bool excluded = false;
@@ -60,11 +86,22 @@ void PassManager::listPasses(std::ostream &out, cstring sep) const {
 const IR::Node *PassManager::apply_visitor(const IR::Node *program, const char *) {
     safe_vector<std::pair<safe_vector<Visitor *>::iterator, const IR::Node *>> backup;
     static indent_t log_indent(-1);
+    // Nesting of running PassManagers, shared with those run by worker threads.
+    static std::atomic<unsigned> depth = 0;
     struct indent_nesting {
         indent_t &indent;
-        explicit indent_nesting(indent_t &i) : indent(i) { ++indent; }
-        ~indent_nesting() { --indent; }
-    } nest_log_indent(log_indent);
+        std::atomic<unsigned> &depth;
+        indent_nesting(indent_t &i, std::atomic<unsigned> &d) : indent(i), depth(d) {
+            ++indent;
+            ++depth;
+        }
+        ~indent_nesting() {
+            --indent;
+            --depth;
+        }
+    } nest_log_indent(log_indent, depth);
+    // Only the outermost PassManager collects between its passes.
+    bool checkpoint = gc_checkpoints && depth == 1;
 
     early_exit_flag = false;
     unsigned initial_error_count = ::errorCount();
@@ -79,7 +116,27 @@ const IR::Node *PassManager::apply_visitor(const IR::Node *program, const char *
         try {
             try {
                 LOG1(log_indent << name() << " invoking " << v->name());
-                auto after = program->apply(**it);
+                std::optional<PassProfile::Scope> profile;
+                if (PassProfile::enabled()) profile.emplace(name(), v->name(), program);
+                auto start = std::chrono::steady_clock::now();
+                std::optional<GcDisabled> noGc;
+                if (checkpoint && gc_disable_in_passes) noGc.emplace();
+                auto after = parallel_jobs > 0 && v->per_declaration_safe()
+                                 ? apply_per_declaration(*v, program)
+                                 : program->apply(**it);
+                noGc.reset();
+                uint64_t gcNanoseconds = checkpoint ? gc_collect() : 0;
+                gcNanoseconds += PassProfile::checkMemoryLimit(v->name());
+                if (profile) profile->finish(after, gcNanoseconds);
+                if (Log::traceEventsEnabled()) {
+                    auto duration = std::chrono::steady_clock::now() - start;
+                    Log::TraceEvent("pass")
+                        .field("manager", name())
+                        .field("pass", v->name())
+                        .field("seq", static_cast<int64_t>(seqNo))
+                        .field("ns", static_cast<int64_t>(
+                                        std::chrono::nanoseconds(duration).count()));
+                }
                 if (LOGGING(3)) {
                     size_t maxmem, mem = gc_mem_inuse(&maxmem);  // triggers gc
                     LOG3(log_indent << "heap after " << v->name() << ": in use " << n4(mem)
@@ -118,6 +175,65 @@ const IR::Node *PassManager::apply_visitor(const IR::Node *program, const char *
     return program;
 }
 
+const IR::Node *PassManager::apply_per_declaration(Visitor &v, const IR::Node *program) {
+    auto *prog = program->to<IR::P4Program>();
+    if (prog == nullptr || prog->objects.size() < 2) return program->apply(v);
+
+    size_t count = prog->objects.size();
+    std::vector<const IR::Node *> results(count);
+    // Each declaration is visited by its own clone of the visitor, with the
+    // program as parent context, so findContext<IR::P4Program>() keeps working.
+    auto visitOne = [&](size_t index) {
+        Visitor_Context ctxt = {nullptr, prog, prog, "objects", static_cast<int>(index), 1};
+        std::unique_ptr<Visitor> clone(v.clone());
+        clone->setCalledBy(this);
+        results[index] = prog->objects.at(index)->apply(*clone, &ctxt);
+    };
+
+#ifdef MULTITHREAD
+    unsigned jobs = std::min<size_t>(parallel_jobs, count);
+    if (jobs > 1) {
+        // Workers grab the next unvisited declaration until all are done, so
+        // a few expensive controls do not serialize the rest behind them.
+        std::atomic<size_t> next(0);
+        std::exception_ptr failure;
+        std::mutex failureLock;
+        auto worker = [&]() {
+            size_t index;
+            while ((index = next++) < count) {
+                try {
+                    visitOne(index);
+                } catch (...) {
+                    std::lock_guard<std::mutex> acquire(failureLock);
+                    if (!failure) failure = std::current_exception();
+                    next = count;
+                }
+            }
+        };
+        std::vector<std::thread> threads;
+        for (unsigned i = 1; i < jobs; ++i) threads.emplace_back(worker);
+        worker();
+        for (auto &t : threads) t.join();
+        if (failure) std::rethrow_exception(failure);
+    } else {
+        for (size_t i = 0; i < count; ++i) visitOne(i);
+    }
+#else
+    for (size_t i = 0; i < count; ++i) visitOne(i);
+#endif  // MULTITHREAD
+
+    // Merge the rewritten declarations back into a single program.
+    bool changed = false;
+    IR::Vector<IR::Node> objects;
+    for (size_t i = 0; i < count; ++i) {
+        const IR::Node *result = results[i];
+        if (result != prog->objects.at(i)) changed = true;
+        objects.pushBackOrAppend(result);
+    }
+    if (!changed) return program;
+    return new IR::P4Program(prog->srcInfo, objects);
+}
+
 bool PassManager::backtrack(trigger &trig) {
     for (Visitor *v : passes)
         if (auto *bt = dynamic_cast<Backtrack *>(v))
@@ -143,18 +259,69 @@ void PassManager::runDebugHooks(const char *visitorName, const IR::Node *program
     for (auto h : debugHooks) h(name(), seqNo, visitorName, program);
 }
 
+bool PassRepeated::canUseWorklist(const IR::Node *program) const {
+    if (!worklist || !program->is<IR::P4Program>()) return false;
+    for (auto *v : passes)
+        if (!v->per_declaration_safe()) return false;
+    return true;
+}
+
+/// Runs the passes over each of the @changed top-level declarations of @program in
+/// turn, wrapped in a program of its own, and splices the results back in place of it.
+const IR::Node *PassRepeated::applyToDeclarations(const IR::Node *program,
+                                                  const std::vector<const IR::Node *> &changed,
+                                                  const char *name) {
+    auto *prog = program->to<IR::P4Program>();
+    std::set<const IR::Node *> todo(changed.begin(), changed.end());
+    bool modified = false;
+    IR::Vector<IR::Node> objects;
+    for (auto *decl : prog->objects) {
+        if (!todo.count(decl)) {
+            objects.push_back(decl);
+            continue;
+        }
+        running = true;
+        auto *result = PassManager::apply_visitor(
+            new IR::P4Program(prog->srcInfo, IR::Vector<IR::Node>({decl})), name);
+        if (result == nullptr) return nullptr;
+        auto *single = result->to<IR::P4Program>();
+        BUG_CHECK(single, "%1%: expected a P4Program", result);
+        if (single->objects.size() != 1 || single->objects.at(0) != decl) modified = true;
+        objects.append(single->objects);
+    }
+    if (!modified) return program;
+    return new IR::P4Program(prog->srcInfo, objects);
+}
+
 const IR::Node *PassRepeated::apply_visitor(const IR::Node *program, const char *name) {
     bool done = false;
     unsigned iterations = 0;
     unsigned initial_error_count = ::errorCount();
+    bool useWorklist = canUseWorklist(program);
+    std::vector<const IR::Node *> changed;  // declarations to revisit, with useWorklist
     while (!done) {
         LOG5("PassRepeated state is:\n" << dumpToString(program));
         running = true;
-        auto newprogram = PassManager::apply_visitor(program, name);
+        auto newprogram = iterations > 0 && useWorklist
+                              ? applyToDeclarations(program, changed, name)
+                              : PassManager::apply_visitor(program, name);
         if (program == newprogram || newprogram == nullptr) done = true;
         if (stop_on_error && ::errorCount() > initial_error_count) return program;
         iterations++;
         if (repeats != 0 && iterations > repeats) done = true;
+        if (!done && useWorklist) {
+            if (auto *newprog = newprogram->to<IR::P4Program>()) {
+                std::set<const IR::Node *> old(program->to<IR::P4Program>()->objects.begin(),
+                                               program->to<IR::P4Program>()->objects.end());
+                changed.clear();
+                for (auto *decl : newprog->objects)
+                    if (!old.count(decl)) changed.push_back(decl);
+                LOG2(this->name() << " revisiting " << changed.size() << " of "
+                            << newprog->objects.size() << " declarations");
+            } else {
+                useWorklist = false;
+            }
+        }
         program = newprogram;
     }
     return program;
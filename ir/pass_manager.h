@@ -44,7 +44,13 @@ class PassManager : virtual public Visitor, virtual public Backtrack {
     bool stop_on_error = true;
     bool running = false;
     unsigned seqNo = 0;
+    // number of worker threads used to fan a per-declaration safe pass out over
+    // the top-level declarations of a P4Program; 0 disables the fan-out
+    unsigned parallel_jobs = 0;
+    static bool gc_checkpoints;
+    static bool gc_disable_in_passes;
     void runDebugHooks(const char *visitorName, const IR::Node *node);
+    const IR::Node *apply_per_declaration(Visitor &v, const IR::Node *program);
     profile_t init_apply(const IR::Node *root) override {
         running = true;
         return Visitor::init_apply(root);
@@ -102,6 +108,25 @@ class PassManager : virtual public Visitor, virtual public Backtrack {
     bool backtrack(trigger &trig) override;
     bool never_backtracks() override;
     void setStopOnError(bool stop) { stop_on_error = stop; }
+    /// Opt in to collecting garbage after each pass of the outermost PassManager,
+    /// where the stack is shallow and the IR of the previous pass is usually
+    /// dead.  If @p disableInPasses, the collections triggered by heap growth
+    /// are also suppressed while those passes run, trading memory for time.
+    /// The collection time is reported in the pass profile.
+    static void setGcCheckpoints(bool enable, bool disableInPasses = false) {
+        gc_checkpoints = enable;
+        gc_disable_in_passes = enable && disableInPasses;
+    }
+    /// Opt in to applying passes that are Visitor::per_declaration_safe() separately
+    /// to each top-level declaration, using up to @jobs threads.  Threads are only
+    /// used when built with MULTITHREAD; otherwise the declarations are visited in turn.
+    void setParallelJobs(unsigned jobs, bool recursive = false) {
+        parallel_jobs = jobs;
+        if (recursive)
+            for (auto pass : passes)
+                if (auto child = dynamic_cast<PassManager *>(pass))
+                    child->setParallelJobs(jobs, recursive);
+    }
     void addDebugHook(DebugHook h, bool recursive = false) {
         debugHooks.push_back(h);
         if (recursive)
@@ -139,7 +164,13 @@ class OnBacktrack : virtual public Visitor, virtual public Backtrack {
 
 // Repeat a pass until convergence (or up to a fixed number of repeats)
 class PassRepeated : virtual public PassManager {
-    unsigned repeats;  // 0 = until convergence
+    unsigned repeats;       // 0 = until convergence
+    bool worklist = false;  // only revisit declarations changed by the previous sweep
+    bool canUseWorklist(const IR::Node *program) const;
+    const IR::Node *applyToDeclarations(const IR::Node *program,
+                                        const std::vector<const IR::Node *> &changed,
+                                        const char *name);
+
  public:
     PassRepeated() : repeats(0) {}
     explicit PassRepeated(const std::initializer_list<VisitorRef> &init, unsigned repeats = 0)
@@ -151,6 +182,14 @@ class PassRepeated : virtual public PassManager {
         this->repeats = repeats;
         return this;
     }
+    /// After the first sweep over the whole program, only rerun the passes over the
+    /// top-level declarations that the previous sweep changed, each on its own.  This is
+    /// only done when the program is a P4Program and every pass is per_declaration_safe();
+    /// otherwise each iteration still sweeps the whole program.
+    PassRepeated *setWorklist(bool enable = true) {
+        worklist = enable;
+        return this;
+    }
     PassRepeated *clone() const override { return new PassRepeated(*this); }
 };
 
@@ -0,0 +1,213 @@
+#include "ir/pass_profile.h"
+
+#include <cstdlib>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <unordered_map>
+
+#include "ir/ir.h"
+#include "ir/visitor.h"
+#include "lib/cstring.h"
+#include "lib/exceptions.h"
+#include "lib/gc.h"
+#include "lib/n4.h"
+#include "lib/nullstream.h"
+
+bool PassProfile::profiling = false;
+cstring PassProfile::reportFile = nullptr;
+bool PassProfile::memoryReport = false;
+size_t PassProfile::memoryLimit = 0;
+
+namespace {
+
+struct ProfileState {
+    std::vector<PassProfile::Entry> entries;
+    std::unordered_map<std::string, size_t> index;
+    /// Entries of the passes currently running, innermost last.
+    std::vector<size_t> open;
+    /// Counting nodes is a full traversal; the result of one pass is usually
+    /// the input of the next, so remember the last tree counted.
+    const IR::Node *lastRoot = nullptr;
+    size_t lastCount = 0;
+
+    static ProfileState &get() {
+        static ProfileState state;
+        return state;
+    }
+};
+
+class CountNodes : public Inspector {
+ public:
+    size_t count = 0;
+    bool preorder(const IR::Node *) override {
+        ++count;
+        return true;
+    }
+};
+
+size_t countNodes(const IR::Node *root) {
+    if (root == nullptr) return 0;
+    auto &state = ProfileState::get();
+    if (root != state.lastRoot) {
+        CountNodes counter;
+        root->apply(counter);
+        state.lastRoot = root;
+        state.lastCount = counter.count;
+    }
+    return state.lastCount;
+}
+
+}  // namespace
+
+PassProfile::Scope::Scope(const char *manager, const char *pass, const IR::Node *root) {
+    auto &state = ProfileState::get();
+    std::string path;
+    unsigned depth = 0;
+    if (state.open.empty()) {
+        path = manager;
+    } else {
+        const auto &parent = state.entries.at(state.open.back());
+        path = parent.path;
+        depth = parent.depth + 1;
+    }
+    path += ".";
+    path += pass;
+
+    auto [it, inserted] = state.index.emplace(path, state.entries.size());
+    if (inserted) {
+        state.entries.emplace_back();
+        state.entries.back().path = path;
+        state.entries.back().depth = depth;
+    }
+    index = it->second;
+    state.open.push_back(index);
+    nodesBefore = countNodes(root);
+    startBytes = gc_bytes_allocated();
+    startCollections = gc_collections();
+    outerHeapPeak = gc_heap_peak();
+    gc_restart_heap_peak();
+    start = Clock::now();
+}
+
+void PassProfile::Scope::finish(const IR::Node *result, uint64_t gcNanoseconds) {
+    auto elapsed = Clock::now() - start;
+    size_t bytes = gc_bytes_allocated() - startBytes;
+    size_t collections = gc_collections() - startCollections;
+    size_t heapPeak = gc_heap_peak();
+    // The peak of this pass is part of the peak of the enclosing one.
+    gc_restart_heap_peak(std::max(outerHeapPeak, heapPeak));
+    finished = true;
+
+    auto &state = ProfileState::get();
+    auto &entry = state.entries.at(index);
+    if (entry.invocations++ == 0) entry.nodesBefore = nodesBefore;
+    entry.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    entry.bytesAllocated += bytes;
+    entry.collections += collections;
+    entry.gcNanoseconds += gcNanoseconds;
+    entry.heapPeak = std::max(entry.heapPeak, heapPeak);
+    entry.heapAfter = gc_heap_inuse();
+    entry.nodesAfter = countNodes(result);
+    state.open.pop_back();
+}
+
+PassProfile::Scope::~Scope() {
+    // The pass was interrupted (e.g., by a backtrack trigger); leave it
+    // out of the report.
+    if (!finished) {
+        ProfileState::get().open.pop_back();
+        gc_restart_heap_peak(std::max(outerHeapPeak, gc_heap_peak()));
+    }
+}
+
+void PassProfile::start() {
+    if (!profiling) std::atexit(PassProfile::writeReport);
+    profiling = true;
+}
+
+void PassProfile::enable(cstring file) {
+    start();
+    reportFile = file;
+}
+
+void PassProfile::enableMemoryReport() {
+    start();
+    memoryReport = true;
+}
+
+void PassProfile::setMemoryLimit(size_t bytes) {
+    // The report shows which passes used the memory.
+    start();
+    memoryLimit = bytes;
+}
+
+uint64_t PassProfile::checkMemoryLimit(const char *pass) {
+    if (memoryLimit == 0 || gc_heap_inuse() <= memoryLimit) return 0;
+    // Part of the heap may be garbage; only fail on what is still live.
+    uint64_t gcNanoseconds = gc_collect();
+    size_t inuse = gc_heap_inuse();
+    if (inuse <= memoryLimit) return gcNanoseconds;
+    writeMemoryReport(std::cerr);
+    FATAL_ERROR("%1% bytes of heap in use after %2%, above the memory limit of %3% bytes", inuse,
+                pass, memoryLimit);
+}
+
+const std::vector<PassProfile::Entry> &PassProfile::entries() {
+    return ProfileState::get().entries;
+}
+
+void PassProfile::writeJson(std::ostream &out) {
+    out << "[" << std::endl;
+    bool first = true;
+    for (const auto &entry : entries()) {
+        if (!first) out << "," << std::endl;
+        first = false;
+        out << "  {\"pass\": \"" << cstring(entry.path).escapeJson() << "\""
+            << ", \"depth\": " << entry.depth << ", \"invocations\": " << entry.invocations
+            << ", \"wall_ms\": " << std::fixed << std::setprecision(3)
+            << entry.nanoseconds / 1000000.0 << ", \"bytes_allocated\": " << entry.bytesAllocated
+            << ", \"nodes_before\": " << entry.nodesBefore
+            << ", \"nodes_after\": " << entry.nodesAfter
+            << ", \"collections\": " << entry.collections << ", \"gc_ms\": " << std::fixed
+            << std::setprecision(3) << entry.gcNanoseconds / 1000000.0
+            << ", \"heap_peak\": " << entry.heapPeak << ", \"heap_after\": " << entry.heapAfter
+            << "}";
+    }
+    out << std::endl << "]" << std::endl;
+}
+
+void PassProfile::writeCsv(std::ostream &out) {
+    out << "pass,depth,invocations,wall_ms,bytes_allocated,nodes_before,nodes_after,collections,"
+           "gc_ms,heap_peak,heap_after"
+        << std::endl;
+    for (const auto &entry : entries()) {
+        out << "\"" << entry.path << "\"," << entry.depth << "," << entry.invocations << "," << std::fixed
+            << std::setprecision(3) << entry.nanoseconds / 1000000.0 << ","
+            << entry.bytesAllocated << "," << entry.nodesBefore << "," << entry.nodesAfter << ","
+            << entry.collections << "," << entry.gcNanoseconds / 1000000.0 << ","
+            << entry.heapPeak << "," << entry.heapAfter << std::endl;
+    }
+}
+
+void PassProfile::writeMemoryReport(std::ostream &out) {
+    out << "Heap in use per pass (peak / after / allocated):" << std::endl;
+    for (const auto &entry : entries()) {
+        out << std::string(2 * (entry.depth + 1), ' ') << entry.path << ": " << n4(entry.heapPeak)
+            << "B / " << n4(entry.heapAfter) << "B / " << n4(entry.bytesAllocated) << "B"
+            << std::endl;
+    }
+}
+
+void PassProfile::writeReport() {
+    if (memoryReport) writeMemoryReport(std::cerr);
+    if (reportFile == nullptr) return;
+    auto *out = openFile(reportFile, false);
+    if (out == nullptr) return;
+    if (reportFile.endsWith(".csv"))
+        writeCsv(*out);
+    else
+        writeJson(*out);
+    delete out;
+}
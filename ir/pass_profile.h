@@ -0,0 +1,112 @@
+#ifndef IR_PASS_PROFILE_H_
+#define IR_PASS_PROFILE_H_
+
+#include <chrono>  // NOLINT linter forbids using chrono, but we don't have alternatives
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "lib/cstring.h"
+
+namespace IR {
+class Node;
+}  // namespace IR
+
+/// Per-pass profile of a compilation: wall time, bytes allocated, heap in use
+/// and IR node count before/after, for every pass run under a PassManager and
+/// every Stage of a backend.  Profiling is off by default and is enabled with
+/// the `--pass-profile` and `--memory-report` compiler options; the reports
+/// are written when the process exits.
+class PassProfile {
+ public:
+    /// One row of the report.  All invocations of the same pass at the same
+    /// nesting path (e.g. "FrontEnd.TypeInference") are aggregated, so passes
+    /// run under PassRepeated show up once, with an invocation count.
+    struct Entry {
+        std::string path;
+        unsigned depth = 0;
+        unsigned invocations = 0;
+        uint64_t nanoseconds = 0;
+        /// Only available when compiled with libgc; 0 otherwise.
+        size_t bytesAllocated = 0;
+        /// Node count before the first and after the last invocation.
+        size_t nodesBefore = 0;
+        size_t nodesAfter = 0;
+        /// Collections run during the pass, and time spent in the collection
+        /// checkpoint after it (see PassManager::setGcCheckpoints), which is
+        /// part of nanoseconds.  Only available when compiled with libgc.
+        size_t collections = 0;
+        uint64_t gcNanoseconds = 0;
+        /// Highest heap in use during any invocation, and heap in use after the
+        /// last one, garbage included.  Only available when compiled with libgc.
+        size_t heapPeak = 0;
+        size_t heapAfter = 0;
+    };
+
+    /// Profiles one invocation of a pass, from construction until finish().
+    class Scope {
+        using Clock = std::chrono::steady_clock;
+        size_t index;
+        Clock::time_point start;
+        size_t startBytes;
+        size_t startCollections;
+        /// Heap peak of the enclosing pass before this one started.
+        size_t outerHeapPeak;
+        size_t nodesBefore;
+        bool finished = false;
+
+     public:
+        Scope(const char *manager, const char *pass, const IR::Node *root);
+        Scope(const Scope &) = delete;
+        ~Scope();
+        /// @gcNanoseconds is the time spent collecting garbage at the end of the pass.
+        void finish(const IR::Node *result, uint64_t gcNanoseconds = 0);
+    };
+
+    /// Profiles a step of a backend that is not a pass, e.g. parsing or
+    /// writing the output, as an entry named @name, until destroyed.
+    class Stage {
+        std::optional<Scope> scope;
+
+     public:
+        explicit Stage(const char *name) {
+            if (enabled()) scope.emplace("P4C", name, nullptr);
+        }
+        ~Stage() {
+            if (scope) scope->finish(nullptr);
+        }
+    };
+
+    static bool enabled() { return profiling; }
+    /// Start profiling; the report is written to @file at exit, unless it is
+    /// null.  A file name ending in ".csv" selects CSV output, anything else JSON.
+    static void enable(cstring file);
+    /// Start profiling, and print the heap used by every pass to stderr at exit.
+    static void enableMemoryReport();
+    /// Abort the compilation, after printing the memory report, when the heap
+    /// in use after a pass stays above @bytes once garbage is collected.
+    static void setMemoryLimit(size_t bytes);
+    /// Enforce the memory limit after @pass; @returns the nanoseconds spent
+    /// collecting garbage to get under it.
+    static uint64_t checkMemoryLimit(const char *pass);
+    static const std::vector<Entry> &entries();
+    static void writeJson(std::ostream &out);
+    static void writeCsv(std::ostream &out);
+    /// Print the heap peak, the heap after and the bytes allocated of every
+    /// entry, as an indented table.
+    static void writeMemoryReport(std::ostream &out);
+    /// Write the reports that were enabled.
+    static void writeReport();
+
+ private:
+    static bool profiling;
+    static cstring reportFile;
+    static bool memoryReport;
+    static size_t memoryLimit;
+    static void start();
+};
+
+#endif /* IR_PASS_PROFILE_H_ */
@@ -80,7 +80,10 @@ const Type_Bits *Type_Bits::get(int width, bool isSigned) {
     static std::map<bit_type_key, const IR::Type_Bits *> *type_map = nullptr;
     if (type_map == nullptr) type_map = new std::map<bit_type_key, const IR::Type_Bits *>();
     auto &result = (*type_map)[std::make_pair(width, isSigned)];
-    if (!result) result = new Type_Bits(width, isSigned);
+    if (!result) {
+        NodeArena::Bypass heap;
+        result = new Type_Bits(width, isSigned);
+    }
     if (width > P4CContext::getConfig().maximumWidthSupported())
         ::error(ErrorType::ERR_UNSUPPORTED, "%1%: Compiler only supports widths up to %2%", result,
                 P4CContext::getConfig().maximumWidthSupported());
@@ -89,19 +92,28 @@ const Type_Bits *Type_Bits::get(int width, bool isSigned) {
 
 const Type::Unknown *Type::Unknown::get() {
     static const Type::Unknown *singleton = nullptr;
-    if (!singleton) singleton = (new Type::Unknown());
+    if (!singleton) {
+        NodeArena::Bypass heap;
+        singleton = (new Type::Unknown());
+    }
     return singleton;
 }
 
 const Type::Boolean *Type::Boolean::get() {
     static const Type::Boolean *singleton = nullptr;
-    if (!singleton) singleton = (new Type::Boolean());
+    if (!singleton) {
+        NodeArena::Bypass heap;
+        singleton = (new Type::Boolean());
+    }
     return singleton;
 }
 
 const Type_String *Type_String::get() {
     static const Type_String *singleton = nullptr;
-    if (!singleton) singleton = (new Type_String());
+    if (!singleton) {
+        NodeArena::Bypass heap;
+        singleton = (new Type_String());
+    }
     return singleton;
 }
 
@@ -134,25 +146,37 @@ const Type::Varbits *Type::Varbits::get() { return new Type::Varbits(0); }
 
 const Type_Dontcare *Type_Dontcare::get() {
     static const Type_Dontcare *singleton;
-    if (!singleton) singleton = (new Type_Dontcare());
+    if (!singleton) {
+        NodeArena::Bypass heap;
+        singleton = (new Type_Dontcare());
+    }
     return singleton;
 }
 
 const Type_State *Type_State::get() {
     static const Type_State *singleton;
-    if (!singleton) singleton = (new Type_State());
+    if (!singleton) {
+        NodeArena::Bypass heap;
+        singleton = (new Type_State());
+    }
     return singleton;
 }
 
 const Type_Void *Type_Void::get() {
     static const Type_Void *singleton;
-    if (!singleton) singleton = (new Type_Void());
+    if (!singleton) {
+        NodeArena::Bypass heap;
+        singleton = (new Type_Void());
+    }
     return singleton;
 }
 
 const Type_MatchKind *Type_MatchKind::get() {
     static const Type_MatchKind *singleton;
-    if (!singleton) singleton = (new Type_MatchKind());
+    if (!singleton) {
+        NodeArena::Bypass heap;
+        singleton = (new Type_MatchKind());
+    }
     return singleton;
 }
 
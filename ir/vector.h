@@ -18,11 +18,14 @@ limitations under the License.
 #define IR_VECTOR_H_
 
 #include "ir/node.h"
+#include "lib/copy_on_write.h"
 #include "lib/enumerator.h"
+#include "lib/hash.h"
 #include "lib/null.h"
 #include "lib/safe_vector.h"
 
 class JSONLoader;
+class BinaryIRLoader;
 
 namespace IR {
 
@@ -46,6 +49,7 @@ class VectorBase : public Node {
 
  protected:
     explicit VectorBase(JSONLoader &json) : Node(json) {}
+    explicit VectorBase(BinaryIRLoader &bin) : Node(bin) {}
 
     DECLARE_TYPEINFO_WITH_TYPEID(VectorBase, NodeKind::VectorBase, Node);
 };
@@ -54,7 +58,9 @@ class VectorBase : public Node {
 // User-level code should use regular std::vector
 template <class T>
 class Vector : public VectorBase {
-    safe_vector<const T *> vec;
+    // Transform clones every node it visits, so the elements are shared between
+    // copies and only copied when a copy is actually modified.
+    copy_on_write<safe_vector<const T *>> vec;
 
  public:
     typedef const T *value_type;
@@ -62,45 +68,48 @@ class Vector : public VectorBase {
     Vector(const Vector &) = default;
     Vector(Vector &&) = default;
     explicit Vector(JSONLoader &json);
+    explicit Vector(BinaryIRLoader &bin);
     Vector &operator=(const Vector &) = default;
     Vector &operator=(Vector &&) = default;
-    explicit Vector(const T *a) { vec.emplace_back(std::move(a)); }
-    explicit Vector(const safe_vector<const T *> &a) { vec.insert(vec.end(), a.begin(), a.end()); }
-    Vector(const std::initializer_list<const T *> &a) : vec(a) {}
+    explicit Vector(const T *a) { vec.mut().emplace_back(std::move(a)); }
+    explicit Vector(const safe_vector<const T *> &a) : vec(safe_vector<const T *>(a)) {}
+    Vector(const std::initializer_list<const T *> &a) : vec(safe_vector<const T *>(a)) {}
     static Vector<T> *fromJSON(JSONLoader &json);
+    static Vector<T> *fromBinary(BinaryIRLoader &bin);
     typedef typename safe_vector<const T *>::iterator iterator;
     typedef typename safe_vector<const T *>::const_iterator const_iterator;
-    iterator begin() { return vec.begin(); }
-    const_iterator begin() const { return vec.begin(); }
+    iterator begin() { return vec.mut().begin(); }
+    const_iterator begin() const { return vec->begin(); }
     VectorBase::iterator VectorBase_begin() const override {
         /* DANGER -- works as long as IR::Node is the first ultimate base class of T */
-        return reinterpret_cast<VectorBase::iterator>(&vec[0]);
+        return reinterpret_cast<VectorBase::iterator>(vec->data());
     }
-    iterator end() { return vec.end(); }
-    const_iterator end() const { return vec.end(); }
+    iterator end() { return vec.mut().end(); }
+    const_iterator end() const { return vec->end(); }
     VectorBase::iterator VectorBase_end() const override {
         /* DANGER -- works as long as IR::Node is the first ultimate base class of T */
-        return reinterpret_cast<VectorBase::iterator>(&vec[0] + vec.size());
-    }
-    std::reverse_iterator<iterator> rbegin() { return vec.rbegin(); }
-    std::reverse_iterator<const_iterator> rbegin() const { return vec.rbegin(); }
-    std::reverse_iterator<iterator> rend() { return vec.rend(); }
-    std::reverse_iterator<const_iterator> rend() const { return vec.rend(); }
-    size_t size() const override { return vec.size(); }
-    void resize(size_t sz) { vec.resize(sz); }
-    bool empty() const override { return vec.empty(); }
-    const T *const &front() const { return vec.front(); }
-    const T *&front() { return vec.front(); }
-    void clear() { vec.clear(); }
-    iterator erase(iterator i) { return vec.erase(i); }
-    iterator erase(iterator s, iterator e) { return vec.erase(s, e); }
+        return reinterpret_cast<VectorBase::iterator>(vec->data() + vec->size());
+    }
+    std::reverse_iterator<iterator> rbegin() { return vec.mut().rbegin(); }
+    std::reverse_iterator<const_iterator> rbegin() const { return vec->rbegin(); }
+    std::reverse_iterator<iterator> rend() { return vec.mut().rend(); }
+    std::reverse_iterator<const_iterator> rend() const { return vec->rend(); }
+    size_t size() const override { return vec->size(); }
+    void resize(size_t sz) { vec.mut().resize(sz); }
+    bool empty() const override { return vec->empty(); }
+    const T *const &front() const { return vec->front(); }
+    const T *&front() { return vec.mut().front(); }
+    void clear() { vec = {}; }
+    iterator erase(iterator i) { return vec.mut().erase(i); }
+    iterator erase(iterator s, iterator e) { return vec.mut().erase(s, e); }
     template <typename ForwardIter>
     iterator insert(iterator i, ForwardIter b, ForwardIter e) {
         /* FIXME -- gcc prior to 4.9 is broken and the insert routine returns void
          * FIXME -- rather than an iterator.  So we recalculate it from an index */
-        int index = i - vec.begin();
-        vec.insert(i, b, e);
-        return vec.begin() + index;
+        auto &elements = vec.mut();
+        int index = i - elements.begin();
+        elements.insert(i, b, e);
+        return elements.begin() + index;
     }
 
     template <typename Container>
@@ -131,43 +140,47 @@ class Vector : public VectorBase {
     iterator insert(iterator i, const T *v) {
         /* FIXME -- gcc prior to 4.9 is broken and the insert routine returns void
          * FIXME -- rather than an iterator.  So we recalculate it from an index */
-        int index = i - vec.begin();
-        vec.insert(i, v);
-        return vec.begin() + index;
+        auto &elements = vec.mut();
+        int index = i - elements.begin();
+        elements.insert(i, v);
+        return elements.begin() + index;
     }
     iterator insert(iterator i, size_t n, const T *v) {
         /* FIXME -- gcc prior to 4.9 is broken and the insert routine returns void
          * FIXME -- rather than an iterator.  So we recalculate it from an index */
-        int index = i - vec.begin();
-        vec.insert(i, n, v);
-        return vec.begin() + index;
+        auto &elements = vec.mut();
+        int index = i - elements.begin();
+        elements.insert(i, n, v);
+        return elements.begin() + index;
     }
 
-    const T *const &operator[](size_t idx) const { return vec[idx]; }
-    const T *&operator[](size_t idx) { return vec[idx]; }
-    const T *const &at(size_t idx) const { return vec.at(idx); }
-    const T *&at(size_t idx) { return vec.at(idx); }
+    const T *const &operator[](size_t idx) const { return (*vec)[idx]; }
+    const T *&operator[](size_t idx) { return vec.mut()[idx]; }
+    const T *const &at(size_t idx) const { return vec->at(idx); }
+    const T *&at(size_t idx) { return vec.mut().at(idx); }
     template <class... Args>
     void emplace_back(Args &&...args) {
-        vec.emplace_back(new T(std::forward<Args>(args)...));
+        vec.mut().emplace_back(new T(std::forward<Args>(args)...));
     }
-    void push_back(T *a) { vec.push_back(a); }
-    void push_back(const T *a) { vec.push_back(a); }
-    void pop_back() { vec.pop_back(); }
-    const T *const &back() const { return vec.back(); }
-    const T *&back() { return vec.back(); }
+    void push_back(T *a) { vec.mut().push_back(a); }
+    void push_back(const T *a) { vec.mut().push_back(a); }
+    void pop_back() { vec.mut().pop_back(); }
+    const T *const &back() const { return vec->back(); }
+    const T *&back() { return vec.mut().back(); }
     template <class U>
     void push_back(U &a) {
-        vec.push_back(a);
+        vec.mut().push_back(a);
     }
     void check_null() const {
-        for (auto e : vec) CHECK_NULL(e);
+        for (auto e : *vec) CHECK_NULL(e);
     }
 
     IRNODE_SUBCLASS(Vector)
     IRNODE_DECLARE_APPLY_OVERLOAD(Vector)
     bool operator==(const Node &a) const override { return a == *this; }
-    bool operator==(const Vector &a) const override { return vec == a.vec; }
+    bool operator==(const Vector &a) const override {
+        return vec.shares(a.vec) || *vec == *a.vec;
+    }
     /* DANGER -- if you get an error on the above line
      *       operator== ... marked ‘override’, but does not override
      * that mean you're trying to create an instantiation of IR::Vector that
@@ -192,6 +205,11 @@ class Vector : public VectorBase {
             if (!el->equiv(**it++)) return false;
         return true;
     }
+    size_t computeEquivHash() const override {
+        size_t h = Node::computeEquivHash();
+        for (auto *el : *this) h = Util::hash_combine(h, el->equivHash());
+        return h;
+    }
     cstring node_type_name() const override { return "Vector<" + T::static_type_name() + ">"; }
     static cstring static_type_name() { return "Vector<" + T::static_type_name() + ">"; }
     void visit_children(Visitor &v) override;
@@ -199,8 +217,9 @@ class Vector : public VectorBase {
     virtual void parallel_visit_children(Visitor &v);
     virtual void parallel_visit_children(Visitor &v) const;
     void toJSON(JSONGenerator &json) const override;
+    void toBinary(BinaryIRWriter &bin) const override;
     Util::Enumerator<const T *> *getEnumerator() const {
-        return Util::Enumerator<const T *>::createEnumerator(vec);
+        return Util::Enumerator<const T *>::createEnumerator(*vec);
     }
     template <typename S>
     Util::Enumerator<const S *> *only() const {
@@ -19,6 +19,16 @@ limitations under the License.
 #include <stdlib.h>
 #include <time.h>
 
+#include <cstdint>
+#include <vector>
+#ifdef MULTITHREAD
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#endif  // MULTITHREAD
+
 #include "absl/container/flat_hash_map.h"
 #include "ir/ir-generated.h"
 #include "lib/hash.h"
@@ -39,6 +49,139 @@ limitations under the License.
 
 enum class VisitStatus : unsigned { New, Revisit, Busy, Done };
 
+/** @class NodeStateTable
+ *  @brief Per-node state of a single visitor application, indexed by IR::Node::id.
+ *
+ *  Node ids are allocated sequentially, so the common lookup is a single indexed
+ *  load into a page of slots.  Ids are not strictly unique (copy-assignment and the
+ *  IR loaders can duplicate them), so each slot records its node, and a node whose
+ *  slot is taken by another one lives in a small hash map instead.
+ *
+ *  Pages are recycled through a per-thread pool and invalidated by bumping a
+ *  generation number rather than by clearing them, so the trackers of the many
+ *  visitor applications in a compilation do not allocate in the steady state.
+ */
+template <class Info>
+class NodeStateTable {
+    struct Slot {
+        const IR::Node *node;
+        uint32_t generation;
+        Info info;
+    };
+    static constexpr unsigned pageBits = 10;
+    static constexpr size_t pageSize = size_t(1) << pageBits;
+    struct Page {
+        Slot slots[pageSize];
+    };
+    struct Pool {
+        std::vector<Page *> pages;
+        std::vector<std::vector<Page *>> directories;
+        uint32_t generation = 0;
+        ~Pool() {
+            for (auto *page : pages) delete page;
+        }
+    };
+    static Pool &pool() {
+        static thread_local Pool pool;
+        return pool;
+    }
+
+    uint32_t generation;
+    std::vector<Page *> directory;  // indexed by id >> pageBits, null for untouched pages
+    std::vector<size_t> used;       // indices of the non-null entries of directory
+    absl::flat_hash_map<const IR::Node *, Info, Util::Hash> overflow;
+
+    Slot *slot(const IR::Node *n, bool create) {
+        if (n->id < 0) return nullptr;
+        size_t index = size_t(n->id) >> pageBits;
+        if (index >= directory.size()) {
+            if (!create) return nullptr;
+            directory.resize(index + 1);
+        }
+        Page *&page = directory[index];
+        if (!page) {
+            if (!create) return nullptr;
+            auto &free = pool().pages;
+            if (free.empty()) {
+                page = new Page();  // zero generation: all slots are empty
+            } else {
+                page = free.back();
+                free.pop_back();
+            }
+            used.push_back(index);
+        }
+        return &page->slots[n->id & (pageSize - 1)];
+    }
+
+ public:
+    NodeStateTable() {
+        auto &p = pool();
+        if (++p.generation == 0) {
+            // Wrapped around; stale slots could now look current, so clear them.
+            for (auto *page : p.pages)
+                for (auto &s : page->slots) s.generation = 0;
+            p.generation = 1;
+        }
+        generation = p.generation;
+        if (!p.directories.empty()) {
+            directory = std::move(p.directories.back());
+            p.directories.pop_back();
+        }
+    }
+    ~NodeStateTable() {
+        auto &p = pool();
+        for (auto index : used) {
+            p.pages.push_back(directory[index]);
+            directory[index] = nullptr;
+        }
+        p.directories.push_back(std::move(directory));
+    }
+    NodeStateTable(const NodeStateTable &) = delete;
+    NodeStateTable &operator=(const NodeStateTable &) = delete;
+
+    Info *find(const IR::Node *n) {
+        if (Slot *s = slot(n, false); s && s->generation == generation && s->node == n)
+            return &s->info;
+        if (overflow.empty()) return nullptr;
+        auto it = overflow.find(n);
+        return it == overflow.end() ? nullptr : &it->second;
+    }
+    const Info *find(const IR::Node *n) const { return const_cast<NodeStateTable *>(this)->find(n); }
+
+    /// Like std::map::emplace: @returns the state of @n and whether it was inserted.
+    std::pair<Info *, bool> emplace(const IR::Node *n, const Info &info) {
+        if (!overflow.empty()) {
+            auto it = overflow.find(n);
+            if (it != overflow.end()) return {&it->second, false};
+        }
+        if (Slot *s = slot(n, true)) {
+            if (s->generation != generation) {
+                *s = Slot{n, generation, info};
+                return {&s->info, true};
+            }
+            if (s->node == n) return {&s->info, false};
+        }
+        auto [it, inserted] = overflow.emplace(n, info);
+        return {&it->second, inserted};
+    }
+
+    /// Forgets the state of every node for which @p pred returns true.
+    template <class Pred>
+    void erase_if(Pred pred) {
+        for (auto index : used)
+            for (auto &s : directory[index]->slots)
+                if (s.generation == generation && pred(s.info)) s.generation = 0;
+        for (auto it = overflow.begin(); it != overflow.end();) {
+            if (pred(it->second))
+                // `overflow` is abseil map, therefore erase does not return iterator, use
+                // post-increment
+                overflow.erase(it++);
+            else
+                ++it;
+        }
+    }
+};
+
 /** @class Visitor::ChangeTracker
  *  @brief Assists visitors in traversing the IR.
 
@@ -55,13 +198,9 @@ class Visitor::ChangeTracker {
         bool visitOnce;
         const IR::Node *result;
     };
-    using visited_t = absl::flat_hash_map<const IR::Node *, visit_info_t, Util::Hash>;
-    visited_t visited;
+    NodeStateTable<visit_info_t> visited;
 
  public:
-    ChangeTracker()
-        : visited(16) {}  // Pre-allocate 16 slots as usually these maps are small, but we do create
-                          // lots of them. This saves quite some time for rehashes
 
     /** Begin tracking @n during a visiting pass.  Use `finish(@n)` to mark @n as
      * visited once the pass completes.
@@ -73,11 +212,11 @@ class Visitor::ChangeTracker {
      */
     [[nodiscard]] VisitStatus try_start(const IR::Node *n, bool defaultVisitOnce) {
         // Initialization
-        auto [it, inserted] = visited.emplace(n, visit_info_t{true, defaultVisitOnce, n});
+        auto [info, inserted] = visited.emplace(n, visit_info_t{true, defaultVisitOnce, n});
 
         if (!inserted) {  // We already seen this node, determine its status
-            if (it->second.visit_in_progress) return VisitStatus::Busy;
-            if (it->second.visitOnce) return VisitStatus::Done;
+            if (info->visit_in_progress) return VisitStatus::Busy;
+            if (info->visitOnce) return VisitStatus::Done;
             return VisitStatus::Revisit;
         }
 
@@ -98,10 +237,9 @@ class Visitor::ChangeTracker {
      * previously been invoked.
      */
     bool finish(const IR::Node *orig, const IR::Node *final) {
-        auto it = visited.find(orig);
-        if (it == visited.end()) BUG("visitor state tracker corrupted");
+        visit_info_t *orig_visit_info = visited.find(orig);
+        if (!orig_visit_info) BUG("visitor state tracker corrupted");
 
-        visit_info_t *orig_visit_info = &(it->second);
         orig_visit_info->visit_in_progress = false;
         if (!final) {
             orig_visit_info->result = final;
@@ -110,7 +248,7 @@ class Visitor::ChangeTracker {
             orig_visit_info->result = final;
             visited.emplace(final, visit_info_t{false, orig_visit_info->visitOnce, final});
             return true;
-        } else if (visited.count(final)) {
+        } else if (visited.find(final)) {
             // coalescing with some previously visited node, so we don't want to undo
             // the coalesce
             orig_visit_info->result = final;
@@ -125,22 +263,15 @@ class Visitor::ChangeTracker {
 
     /** Return a visitOnce flag for node @n */
     [[nodiscard]] bool shouldVisitOnce(const IR::Node *n) const {
-        auto it = visited.find(n);
-        if (it == visited.end()) BUG("visitor state tracker corrupted");
-        return it->second.visitOnce;
+        auto *info = visited.find(n);
+        if (!info) BUG("visitor state tracker corrupted");
+        return info->visitOnce;
     }
 
     /** Forget nodes that have already been visited, allowing them to be visited
      * again. */
     void revisit_visited() {
-        for (auto it = visited.begin(); it != visited.end();) {
-            if (!it->second.visit_in_progress)
-                // `visited` is abseil map, therefore erase does not return iterator, use
-                // post-increment
-                visited.erase(it++);
-            else
-                ++it;
-        }
+        visited.erase_if([](const visit_info_t &info) { return !info.visit_in_progress; });
     }
 
     /** Determine whether @n is currently being visited and the visitor has not finished
@@ -149,8 +280,8 @@ class Visitor::ChangeTracker {
      * @return true if @n is being visited and has not finished
      */
     [[nodiscard]] bool busy(const IR::Node *n) const {
-        auto it = visited.find(n);
-        return it != visited.end() && it->second.visit_in_progress;
+        auto *info = visited.find(n);
+        return info && info->visit_in_progress;
     }
 
     /** Determine whether @n has been visited and the visitor has finished
@@ -161,8 +292,8 @@ class Visitor::ChangeTracker {
      * @return true if @n has been visited and the visitor is finished and visitOnce is true
      */
     [[nodiscard]] bool done(const IR::Node *n) const {
-        auto it = visited.find(n);
-        return it != visited.end() && !it->second.visit_in_progress && it->second.visitOnce;
+        auto *info = visited.find(n);
+        return info && !info->visit_in_progress && info->visitOnce;
     }
 
     /** Produce the result of visiting @n.
@@ -172,9 +303,9 @@ class Visitor::ChangeTracker {
      * if `start(@n)` has not been invoked.
      */
     const IR::Node *result(const IR::Node *n) const {
-        auto it = visited.find(n);
-        if (it == visited.end()) return n;
-        return it->second.result;
+        auto *info = visited.find(n);
+        if (!info) return n;
+        return info->result;
     }
 
     /** Produce the final result of visiting @n.
@@ -183,21 +314,21 @@ class Visitor::ChangeTracker {
      * been invoked.
      */
     const IR::Node *finalResult(const IR::Node *n) const {
-        auto it = visited.find(n);
-        bool done = it != visited.end() && !it->second.visit_in_progress && it->second.visitOnce;
-        return done ? it->second.result : nullptr;
+        auto *info = visited.find(n);
+        bool done = info && !info->visit_in_progress && info->visitOnce;
+        return done ? info->result : nullptr;
     }
 
     void visitOnce(const IR::Node *n) {
-        auto it = visited.find(n);
-        if (it == visited.end()) BUG("visitor state tracker corrupted");
-        it->second.visitOnce = true;
+        auto *info = visited.find(n);
+        if (!info) BUG("visitor state tracker corrupted");
+        info->visitOnce = true;
     }
 
     void visitAgain(const IR::Node *n) {
-        auto it = visited.find(n);
-        if (it == visited.end()) BUG("visitor state tracker corrupted");
-        it->second.visitOnce = false;
+        auto *info = visited.find(n);
+        if (!info) BUG("visitor state tracker corrupted");
+        info->visitOnce = false;
     }
 };
 
@@ -213,25 +344,14 @@ class Visitor::Tracker {
     struct info_t {
         bool done, visitOnce;
     };
-    using visited_t = absl::flat_hash_map<const IR::Node *, info_t, Util::Hash>;
-    visited_t visited;
+    NodeStateTable<info_t> visited;
 
  public:
-    Tracker()
-        : visited(16) {}  // Pre-allocate 16 slots as usually these maps are small, but we do create
-                          // lots of them. This saves quite some time for rehashes
 
     /** Forget nodes that have already been visited, allowing them to be visited
      * again. */
     void revisit_visited() {
-        for (auto it = visited.begin(); it != visited.end();) {
-            if (it->second.done)
-                // `visited` is abseil map, therefore erase does not return iterator, use
-                // post-increment
-                visited.erase(it++);
-            else
-                ++it;
-        }
+        visited.erase_if([](const info_t &info) { return info.done; });
     }
 
     /** Begin tracking @n during a visiting pass.  Use `finish(@n)` to mark @n as
@@ -245,11 +365,11 @@ class Visitor::Tracker {
      */
     [[nodiscard]] VisitStatus try_start(const IR::Node *n, bool defaultVisitOnce) {
         // Initialization
-        auto [it, inserted] = visited.emplace(n, info_t{false, defaultVisitOnce});
+        auto [info, inserted] = visited.emplace(n, info_t{false, defaultVisitOnce});
 
         if (!inserted) {  // We already seen this node, determine its status
-            if (!it->second.done) return VisitStatus::Busy;
-            if (it->second.visitOnce) return VisitStatus::Done;
+            if (!info->done) return VisitStatus::Busy;
+            if (info->visitOnce) return VisitStatus::Done;
             return VisitStatus::Revisit;
         }
 
@@ -268,10 +388,10 @@ class Visitor::Tracker {
      * previously been invoked.
      */
     void finish(const IR::Node *n) {
-        auto it = visited.find(n);
-        if (it == visited.end()) BUG("visitor state tracker corrupted");
+        auto *info = visited.find(n);
+        if (!info) BUG("visitor state tracker corrupted");
 
-        it->second.done = true;
+        info->done = true;
     }
 
     /** Determine whether @n is currently being visited and the visitor has not finished
@@ -280,8 +400,8 @@ class Visitor::Tracker {
      * @return true if @n is being visited and has not finished
      */
     [[nodiscard]] bool busy(const IR::Node *n) const {
-        auto it = visited.find(n);
-        return it != visited.end() && !it->second.done;
+        auto *info = visited.find(n);
+        return info && !info->done;
     }
 
     /** Determine whether @n has been visited and the visitor has finished
@@ -292,27 +412,27 @@ class Visitor::Tracker {
      * @return true if @n has been visited and the visitor is finished and visitOnce is true
      */
     [[nodiscard]] bool done(const IR::Node *n) const {
-        auto it = visited.find(n);
-        return it != visited.end() && it->second.done && it->second.visitOnce;
+        auto *info = visited.find(n);
+        return info && info->done && info->visitOnce;
     }
 
     /** Return a visitOnce flag for node @n */
     bool shouldVisitOnce(const IR::Node *n) const {
-        auto it = visited.find(n);
-        if (it == visited.end()) BUG("visitor state tracker corrupted");
-        return it->second.visitOnce;
+        auto *info = visited.find(n);
+        if (!info) BUG("visitor state tracker corrupted");
+        return info->visitOnce;
     }
 
     void visitOnce(const IR::Node *n) {
-        auto it = visited.find(n);
-        if (it == visited.end()) BUG("visitor state tracker corrupted");
-        it->second.visitOnce = true;
+        auto *info = visited.find(n);
+        if (!info) BUG("visitor state tracker corrupted");
+        info->visitOnce = true;
     }
 
     void visitAgain(const IR::Node *n) {
-        auto it = visited.find(n);
-        if (it == visited.end()) BUG("visitor state tracker corrupted");
-        it->second.visitOnce = false;
+        auto *info = visited.find(n);
+        if (!info) BUG("visitor state tracker corrupted");
+        info->visitOnce = false;
     }
 };
 
@@ -408,6 +528,10 @@ void Inspector::visitAgain() const { visited->visitAgain(getOriginal()); }
 void Modifier::visitAgain() const { visited->visitAgain(getOriginal()); }
 void Transform::visitAgain() const { visited->visitAgain(getOriginal()); }
 
+void Inspector::split_visited() { visited = std::make_shared<Tracker>(); }
+void Modifier::split_visited() { visited = std::make_shared<ChangeTracker>(); }
+void Transform::split_visited() { visited = std::make_shared<ChangeTracker>(); }
+
 void Visitor::print_context() const {
     std::ostream &out = std::cout;
     out << "Context:" << std::endl;
@@ -740,6 +864,66 @@ bool Transform::check_clone(const Visitor *v) {
     return Visitor::check_clone(v);
 }
 
+#ifdef MULTITHREAD
+// Set while a thread visits a branch of a parallel split, so that nested splits are
+// visited by that thread rather than spawning more.
+static thread_local bool inParallelFlow = false;
+#endif  // MULTITHREAD
+
+void SplitFlowVisit_base::run_visit() {
+    auto *ctxt = v.getChildContext();
+    start_index = ctxt ? ctxt->child_index : 0;
+    paused = false;
+    unsigned jobs = visitors.size() > 1 ? v.parallel_flow_jobs() : 0;
+    if (jobs > 1)
+        run_parallel_visit(jobs);
+    else
+        while (!finished()) do_visit();
+    for (auto *cl : visitors) {
+        if (cl && cl != &v) v.flow_merge(*cl);
+    }
+}
+
+void SplitFlowVisit_base::run_parallel_visit(unsigned jobs) {
+#ifdef MULTITHREAD
+    if (inParallelFlow) {
+        while (!finished()) do_visit();
+        return;
+    }
+    // The first branch is visited by the visitor itself, and keeps its record of
+    // visited nodes; the other clones each get their own.
+    for (size_t i = 1; i < visitors.size(); ++i) visitors[i]->split_visited();
+    std::atomic<size_t> next(visit_next);
+    size_t count = visitors.size();
+    std::exception_ptr failure;
+    std::mutex failureLock;
+    auto worker = [&]() {
+        inParallelFlow = true;
+        size_t index;
+        while ((index = next++) < count) {
+            try {
+                visit_branch(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> acquire(failureLock);
+                if (!failure) failure = std::current_exception();
+                next = count;
+            }
+        }
+        inParallelFlow = false;
+    };
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < std::min<size_t>(jobs, count - visit_next); ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (auto &t : threads) t.join();
+    visit_next = count;
+    if (failure) std::rethrow_exception(failure);
+#else
+    (void)jobs;
+    while (!finished()) do_visit();
+#endif  // MULTITHREAD
+}
+
 ControlFlowVisitor &ControlFlowVisitor::flow_clone() {
     auto *rv = clone();
     BUG_CHECK(rv->check_clone(this), "Clone failed to copy visitor type");
@@ -213,6 +213,19 @@ class Visitor {
     virtual bool check_global(cstring) { return false; }
     virtual void clear_globals() {}
     virtual bool has_flow_joins() const { return false; }
+    // A visitor that is per-declaration safe only looks at (and rewrites) the
+    // top-level declaration it is applied to, and keeps no state that must
+    // survive from one declaration to the next.  PassManager may then apply
+    // independent clones of it to each declaration of a P4Program, possibly
+    // concurrently (see PassManager::setParallelJobs).
+    virtual bool per_declaration_safe() const { return false; }
+    // Number of threads the branches of a SplitFlowVisit may be visited with
+    // concurrently (see ControlFlowVisitor::setParallelFlowJobs); 0 or 1 if they
+    // must be visited in turn.
+    virtual unsigned parallel_flow_jobs() const { return 0; }
+    // Gives this flow clone its own record of visited nodes, so that it can visit
+    // a branch concurrently with the other clones of the same split.
+    virtual void split_visited() {}
 
     static cstring demangle(const char *);
     virtual const char *name() const {
@@ -391,6 +404,7 @@ class Modifier : public virtual Visitor {
     bool visit_in_progress(const IR::Node *) const;
     void visitOnce() const override;
     void visitAgain() const override;
+    void split_visited() override;
 };
 
 class Inspector : public virtual Visitor {
@@ -415,6 +429,35 @@ class Inspector : public virtual Visitor {
     bool visit_in_progress(const IR::Node *n) const;
     void visitOnce() const override;
     void visitAgain() const override;
+    void split_visited() override;
+};
+
+/// An Inspector that computes a single Result for the subtree it is applied to
+/// and remembers it by node identity, so asking again about the same node is a
+/// lookup rather than a traversal.  This is sound because IR nodes are immutable:
+/// a Transform that changes anything below a node produces a new node, which
+/// simply misses in the cache.  The result may only depend on the subtree and on
+/// state fixed at construction (e.g. the ReferenceMap and TypeMap); call
+/// clearMemo() if that state changes.  Subclasses reset their per-traversal state
+/// in init_apply and report the outcome through memoResult().  Clones share the cache.
+template <class Result>
+class MemoizingInspector : public Inspector {
+    std::shared_ptr<std::unordered_map<const IR::Node *, Result>> memo =
+        std::make_shared<std::unordered_map<const IR::Node *, Result>>();
+
+ protected:
+    /// The result of the traversal that just finished.
+    virtual Result memoResult() const = 0;
+
+ public:
+    const Result &memoized(const IR::Node *node) {
+        auto it = memo->find(node);
+        if (it != memo->end()) return it->second;
+        node->apply(*this);
+        return memo->emplace(node, memoResult()).first->second;
+    }
+    void clearMemo() { memo->clear(); }
+    size_t memoSize() const { return memo->size(); }
 };
 
 class Transform : public virtual Visitor {
@@ -441,6 +484,7 @@ class Transform : public virtual Visitor {
     bool visit_in_progress(const IR::Node *) const;
     void visitOnce() const override;
     void visitAgain() const override;
+    void split_visited() override;
     // can only be called usefully from a 'preorder' function (directly or indirectly)
     void prune() { prune_flag = true; }
 
@@ -518,12 +562,31 @@ class ControlFlowVisitor : public virtual Visitor {
      * edge are never join points.
      */
     virtual bool filter_join_point(const IR::Node *) { return false; }
+    /** Visitors may override this to return 'true' if their flow clones share no
+     * mutable state except through flow_merge/flow_copy, report no diagnostics, and
+     * tolerate a node shared by two branches being visited by each of them.  Such
+     * visitors can visit branches concurrently (see setParallelFlowJobs).
+     */
+    virtual bool parallel_flows_safe() const { return false; }
     ControlFlowVisitor &flow_clone() override;
     void flow_merge(Visitor &) override = 0;
     virtual void flow_copy(ControlFlowVisitor &) = 0;
     ControlFlowVisitor() : globals(*new std::map<cstring, ControlFlowVisitor &>) {}
 
+ private:
+    unsigned flow_jobs = 0;
+
  public:
+    /// Visit the branches of each SplitFlowVisit (if/else arms, switch cases, parser
+    /// select cases) as tasks on up to @p jobs threads, if the visitor is
+    /// parallel_flows_safe and does not use join points.  The clones are still merged
+    /// in branch order, so the result does not depend on scheduling.  Splits nested in
+    /// a branch are visited by that branch's thread.  Only effective when built with
+    /// MULTITHREAD.
+    void setParallelFlowJobs(unsigned jobs) { flow_jobs = jobs; }
+    unsigned parallel_flow_jobs() const override {
+        return parallel_flows_safe() && !has_flow_joins() ? flow_jobs : 0;
+    }
     void flow_merge_global_to(cstring key) override {
         if (globals.count(key))
             globals.at(key).flow_merge(*this);
@@ -567,17 +630,30 @@ class ControlFlowVisitor : public virtual Visitor {
 class SplitFlowVisit_base {
  protected:
     Visitor &v;
-    SplitFlowVisit_base *prev;
+    SplitFlowVisit_base *prev = nullptr;
     std::vector<Visitor *> visitors;
     int visit_next = 0, start_index = 0;
     bool paused = false;
+    bool linked;
     friend ControlFlowVisitor;
 
-    explicit SplitFlowVisit_base(Visitor &v) : v(v) {
-        prev = v.split_link;
-        v.split_link = this;
+    /// Visits branch @p idx with its visitor.
+    virtual void visit_branch(int idx) = 0;
+    /// Visits all the branches as tasks on up to @p jobs threads.
+    void run_parallel_visit(unsigned jobs);
+
+    // The chain is only walked by join_flows, so visitors without join points do not
+    // record their splits in it; this also keeps concurrently visited branches from
+    // updating the shared chain.
+    explicit SplitFlowVisit_base(Visitor &v) : v(v), linked(v.has_flow_joins()) {
+        if (linked) {
+            prev = v.split_link;
+            v.split_link = this;
+        }
+    }
+    ~SplitFlowVisit_base() {
+        if (linked) v.split_link = prev;
     }
-    ~SplitFlowVisit_base() { v.split_link = prev; }
     void *operator new(size_t);  // declared and not defined, as this class can
     // only be instantiated on the stack.  Trying to allocate one on the heap will
     // cause a linker error.
@@ -587,16 +663,13 @@ class SplitFlowVisit_base {
     virtual bool ready() { return !finished() && !paused; }
     void pause() { paused = true; }
     void unpause() { paused = false; }
-    virtual void do_visit() = 0;
-    virtual void run_visit() {
-        auto *ctxt = v.getChildContext();
-        start_index = ctxt ? ctxt->child_index : 0;
-        paused = false;
-        while (!finished()) do_visit();
-        for (auto *cl : visitors) {
-            if (cl && cl != &v) v.flow_merge(*cl);
+    void do_visit() {
+        if (!finished()) {
+            BUG_CHECK(!paused, "trying to visit paused split_flow_visitor");
+            visit_branch(visit_next++);
         }
     }
+    virtual void run_visit();
     virtual void dbprint(std::ostream &) const = 0;
     friend void dump(const SplitFlowVisit_base *);
 };
@@ -631,15 +704,11 @@ class SplitFlowVisit : public SplitFlowVisit_base {
     explicit SplitFlowVisit(Visitor &v, Args &&...args) : SplitFlowVisit(v) {
         addNode(std::forward<Args>(args)...);
     }
-    void do_visit() override {
-        if (!finished()) {
-            BUG_CHECK(!paused, "trying to visit paused split_flow_visitor");
-            int idx = visit_next++;
-            if (nodes.empty())
-                visitors.at(idx)->visit(*const_nodes.at(idx), nullptr, start_index + idx);
-            else
-                visitors.at(idx)->visit(*nodes.at(idx), nullptr, start_index + idx);
-        }
+    void visit_branch(int idx) override {
+        if (nodes.empty())
+            visitors.at(idx)->visit(*const_nodes.at(idx), nullptr, start_index + idx);
+        else
+            visitors.at(idx)->visit(*nodes.at(idx), nullptr, start_index + idx);
     }
     void dbprint(std::ostream &out) const override {
         out << "SplitFlowVisit processed " << visit_next << " of " << visitors.size();
@@ -665,19 +734,22 @@ class SplitFlowVisitVector : public SplitFlowVisit_base {
         : SplitFlowVisit_base(v), const_vec(&vec) {
         init_visit(vec.size());
     }
-    void do_visit() override {
-        if (!finished()) {
-            BUG_CHECK(!paused, "trying to visit paused split_flow_visitor");
-            int idx = visit_next++;
-            if (vec)
-                result[idx] = visitors.at(idx)->apply_visitor(vec->at(idx));
-            else
-                visitors.at(idx)->visit(const_vec->at(idx), nullptr, start_index + idx);
-        }
+    void visit_branch(int idx) override {
+        if (vec)
+            // const access, so that branches running concurrently never detach
+            // the (possibly shared) elements
+            result[idx] = visitors.at(idx)->apply_visitor(std::as_const(*vec).at(idx));
+        else
+            visitors.at(idx)->visit(const_vec->at(idx), nullptr, start_index + idx);
     }
     void run_visit() override {
         SplitFlowVisit_base::run_visit();
         if (vec) {
+            size_t unchanged = 0;
+            while (unchanged < result.size() && result[unchanged] &&
+                   result[unchanged] == std::as_const(*vec)[unchanged])
+                ++unchanged;
+            if (unchanged == result.size()) return;  // leave shared elements alone
             int idx = 0;
             for (auto i = vec->begin(); i != vec->end(); ++idx) {
                 if (!result[idx] && *i) {
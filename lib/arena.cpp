@@ -0,0 +1,49 @@
+#include "lib/arena.h"
+
+#include <cstdlib>
+#include <new>
+
+#include "lib/exceptions.h"
+
+namespace Util {
+
+void *Arena::allocateSlow(size_t size, size_t align) {
+    BUG_CHECK(align != 0 && (align & (align - 1)) == 0, "arena alignment %1% not a power of 2",
+              align);
+    // Oversized requests get a chunk of their own, so they do not waste the
+    // remainder of the current chunk.
+    size_t needed = sizeof(Chunk) + size + align;
+    size_t chunkBytes = needed > chunkSize ? needed : chunkSize;
+    auto *chunk = static_cast<Chunk *>(std::malloc(chunkBytes));
+    if (chunk == nullptr) throw std::bad_alloc();
+    chunk->size = chunkBytes;
+    char *base = reinterpret_cast<char *>(chunk + 1);
+    char *limit = reinterpret_cast<char *>(chunk) + chunkBytes;
+    auto p = reinterpret_cast<size_t>(base);
+    char *rv = base + ((align - (p & (align - 1))) & (align - 1));
+
+    if (needed > chunkSize && ptr != nullptr) {
+        // Keep bumping in the current chunk; link the big one behind it.
+        chunk->next = chunks->next;
+        chunks->next = chunk;
+    } else {
+        chunk->next = chunks;
+        chunks = chunk;
+        end = limit;
+        ptr = rv + size;
+    }
+    allocated += size;
+    return rv;
+}
+
+void Arena::reset() {
+    while (chunks != nullptr) {
+        Chunk *next = chunks->next;
+        std::free(chunks);
+        chunks = next;
+    }
+    ptr = end = nullptr;
+    allocated = 0;
+}
+
+}  // namespace Util
@@ -0,0 +1,55 @@
+#ifndef LIB_ARENA_H_
+#define LIB_ARENA_H_
+
+#include <cstddef>
+
+namespace Util {
+
+/// A bump-pointer allocator. Memory is carved sequentially out of large
+/// chunks and is only ever returned all at once, when the arena is
+/// destroyed or reset. Allocation is a pointer increment in the common case.
+/// Destructors of objects placed in the arena are not run.
+class Arena {
+    struct Chunk {
+        Chunk *next;
+        size_t size;
+    };
+    Chunk *chunks = nullptr;
+    char *ptr = nullptr;
+    char *end = nullptr;
+    size_t chunkSize;
+    size_t allocated = 0;
+
+    void *allocateSlow(size_t size, size_t align);
+
+ public:
+    static constexpr size_t defaultChunkSize = 1 << 20;
+
+    explicit Arena(size_t chunkSize = defaultChunkSize) : chunkSize(chunkSize) {}
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+    ~Arena() { reset(); }
+
+    /// @p align must be a power of two.
+    void *allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        auto p = reinterpret_cast<size_t>(ptr);
+        size_t padding = (align - (p & (align - 1))) & (align - 1);
+        if (ptr != nullptr && padding + size <= static_cast<size_t>(end - ptr)) {
+            char *rv = ptr + padding;
+            ptr = rv + size;
+            allocated += size;
+            return rv;
+        }
+        return allocateSlow(size, align);
+    }
+
+    /// Release all memory allocated from the arena.
+    void reset();
+
+    /// Total number of bytes handed out since construction or the last reset.
+    size_t bytesAllocated() const { return allocated; }
+};
+
+}  // namespace Util
+
+#endif /* LIB_ARENA_H_ */
@@ -17,6 +17,8 @@ limitations under the License.
 #ifndef LIB_BIG_INT_UTIL_H_
 #define LIB_BIG_INT_UTIL_H_
 
+#include <cstdint>
+
 #include <boost/multiprecision/cpp_int.hpp>
 
 #include "config.h"
@@ -45,6 +47,27 @@ big_int shift_right(const big_int &v, unsigned bits);
 big_int maskFromSlice(unsigned m, unsigned l);
 big_int mask(unsigned bits);
 
+/// True if @p v is in the range (-2^63, 2^63).  Only inspects the representation,
+/// so it is much cheaper than comparing with big_int bounds.
+inline bool fitsInt64(const big_int &v) {
+    const auto &backend = v.backend();
+    return backend.size() == 1 && backend.limbs()[0] <= uint64_t(INT64_MAX);
+}
+
+/// Applies @p op, a generic callable such as `[](auto a, auto b) { return a + b; }`, to
+/// @p a and @p b.  When both values fit in 64 bits @p op is evaluated on __int128, which
+/// cannot overflow for the arithmetic, bitwise and relational operators on such values;
+/// otherwise it is evaluated on big_int.  Both give the same result.
+template <class Op>
+big_int evaluate(const big_int &a, const big_int &b, Op op) {
+#ifdef __SIZEOF_INT128__
+    if (fitsInt64(a) && fitsInt64(b))
+        return big_int(op(static_cast<__int128>(static_cast<int64_t>(a)),
+                          static_cast<__int128>(static_cast<int64_t>(b))));
+#endif
+    return big_int(op(a, b));
+}
+
 inline unsigned scan0_positive(const boost::multiprecision::cpp_int &val, unsigned pos) {
     while (boost::multiprecision::bit_test(val, pos)) ++pos;
     return pos;
@@ -69,6 +92,7 @@ inline unsigned scan1(const boost::multiprecision::cpp_int &val, unsigned pos) {
 
 static inline unsigned bitcount(big_int v) {
     if (v < 0) return ~0U;
+    if (Util::fitsInt64(v)) return __builtin_popcountll(static_cast<uint64_t>(v));
     unsigned rv = 0;
     while (v != 0) {
         v &= v - 1;
@@ -82,13 +106,9 @@ static inline int ffs(big_int v) {
     return boost::multiprecision::lsb(v);
 }
 
-static inline int floor_log2(big_int v) {
-    int rv = -1;
-    while (v > 0) {
-        rv++;
-        v /= 2;
-    }
-    return rv;
+static inline int floor_log2(const big_int &v) {
+    if (v <= 0) return -1;
+    return boost::multiprecision::msb(v);
 }
 
 static inline int ceil_log2(big_int v) { return v ? floor_log2(v - 1) + 1 : -1; }
@@ -62,6 +62,8 @@ class bitranges {
 
 class JSONGenerator;
 class JSONLoader;
+class BinaryIRWriter;
+class BinaryIRLoader;
 
 namespace BitRange {
 
@@ -210,6 +212,10 @@ struct MinToMax {};
 void rangeToJSON(JSONGenerator &json, int lo, int hi);
 std::pair<int, int> rangeFromJSON(JSONLoader &json);
 
+/// Binary IR serialization/deserialization helpers.
+void rangeToBinary(BinaryIRWriter &bin, int lo, int hi);
+std::pair<int, int> rangeFromBinary(BinaryIRLoader &bin);
+
 }  // namespace BitRange
 
 /// Units in which a range can be specified.
@@ -460,11 +466,15 @@ struct HalfOpenRange {
         BUG("Unexpected unit");
     }
 
-    /// JSON serialization/deserialization.
+    /// JSON and binary IR serialization/deserialization.
     void toJSON(JSONGenerator &json) const { BitRange::rangeToJSON(json, lo, hi); }
     static HalfOpenRange fromJSON(JSONLoader &json) {
         return HalfOpenRange(BitRange::rangeFromJSON(json));
     }
+    void toBinary(BinaryIRWriter &bin) const { BitRange::rangeToBinary(bin, lo, hi); }
+    static HalfOpenRange fromBinary(BinaryIRLoader &bin) {
+        return HalfOpenRange(BitRange::rangeFromBinary(bin));
+    }
 
     /// Total ordering, first by lo, then by hi.
     bool operator<(const HalfOpenRange &other) const {
@@ -655,11 +665,15 @@ struct ClosedRange {
         BUG("Unexpected unit");
     }
 
-    /// JSON serialization/deserialization.
+    /// JSON and binary IR serialization/deserialization.
     void toJSON(JSONGenerator &json) const { BitRange::rangeToJSON(json, lo, hi); }
     static ClosedRange fromJSON(JSONLoader &json) {
         return ClosedRange(BitRange::rangeFromJSON(json));
     }
+    void toBinary(BinaryIRWriter &bin) const { BitRange::rangeToBinary(bin, lo, hi); }
+    static ClosedRange fromBinary(BinaryIRLoader &bin) {
+        return ClosedRange(BitRange::rangeFromBinary(bin));
+    }
 
     /// @see HalfOpenRange::operator<.
     bool operator<(const ClosedRange &other) const {
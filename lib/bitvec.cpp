@@ -147,14 +147,15 @@ bitvec bitvec::getslice(size_t idx, size_t sz) const {
 }
 
 int bitvec::ffs(unsigned start) const {
-    uintptr_t val = ~static_cast<uintptr_t>(0);
-    unsigned idx = start / bits_per_unit;
-    val <<= (start % bits_per_unit);
-    while (idx < size && !(val &= word(idx))) {
-        ++idx;
-        val = ~static_cast<uintptr_t>(0);
-    }
+    size_t idx = start / bits_per_unit;
     if (idx >= size) return -1;
+    uintptr_t val = word(idx) & (~static_cast<uintptr_t>(0) << (start % bits_per_unit));
+    if (!val) {
+        if (size <= 1) return -1;
+        idx = bv::skip_zero_words(ptr, idx + 1, size);
+        if (idx >= size) return -1;
+        val = ptr[idx];
+    }
     unsigned rv = idx * bits_per_unit;
     rv += bv::count_trailing_zeroes(val);
     return rv;
@@ -23,6 +23,7 @@ limitations under the License.
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
 #include <iostream>
 #include <type_traits>
 #include <utility>
@@ -114,6 +115,56 @@ int popcount(I x) {
     return rv;
 #endif
 }
+
+/* Kernels for the multi-word paths of bitvec.  They are written as straight loops
+ * with no early exits or data-dependent branches, so that compilers vectorize them
+ * for whatever SIMD the target has (SSE2/AVX2, NEON).  The update kernels return
+ * whether any word of `dst` changed. */
+static inline bool and_words(uintptr_t *dst, const uintptr_t *src, size_t n) {
+    uintptr_t changed = 0;
+    for (size_t i = 0; i < n; i++) {
+        uintptr_t v = dst[i] & src[i];
+        changed |= v ^ dst[i];
+        dst[i] = v;
+    }
+    return changed != 0;
+}
+static inline bool or_words(uintptr_t *dst, const uintptr_t *src, size_t n) {
+    uintptr_t changed = 0;
+    for (size_t i = 0; i < n; i++) {
+        uintptr_t v = dst[i] | src[i];
+        changed |= v ^ dst[i];
+        dst[i] = v;
+    }
+    return changed != 0;
+}
+static inline bool andnot_words(uintptr_t *dst, const uintptr_t *src, size_t n) {
+    uintptr_t changed = 0;
+    for (size_t i = 0; i < n; i++) {
+        uintptr_t v = dst[i] & ~src[i];
+        changed |= v ^ dst[i];
+        dst[i] = v;
+    }
+    return changed != 0;
+}
+static inline bool any_words(const uintptr_t *src, size_t n) {
+    uintptr_t any = 0;
+    for (size_t i = 0; i < n; i++) any |= src[i];
+    return any != 0;
+}
+static inline int popcount_words(const uintptr_t *src, size_t n) {
+    int rv = 0;
+    for (size_t i = 0; i < n; i++) rv += popcount(src[i]);
+    return rv;
+}
+/* Index of the first non-zero word in src[i..n), or n.  Zero words are skipped four
+ * at a time, which is the common case in sparse def-use and liveness vectors. */
+static inline size_t skip_zero_words(const uintptr_t *src, size_t i, size_t n) {
+    for (; i + 4 <= n; i += 4)
+        if (src[i] | src[i + 1] | src[i + 2] | src[i + 3]) break;
+    while (i < n && !src[i]) ++i;
+    return i;
+}
 }  // namespace bv
 
 class bitvec {
@@ -419,32 +470,19 @@ class bitvec {
     nonconst_bitref max() & { return --nonconst_bitref(*this, size * bits_per_unit); }
     nonconst_bitref begin() & { return min(); }
     nonconst_bitref end() & { return nonconst_bitref(*this, -1); }
-    bool empty() const {
-        for (size_t i = 0; i < size; i++)
-            if (word(i) != 0) return false;
-        return true;
-    }
+    bool empty() const { return size > 1 ? !bv::any_words(ptr, size) : data == 0; }
     explicit operator bool() const { return !empty(); }
     bool operator&=(const bitvec &a) {
         bool rv = false;
         if (size > 1) {
             if (a.size > 1) {
-                for (size_t i = 0; i < size && i < a.size; i++) {
-                    rv |= ((ptr[i] & a.ptr[i]) != ptr[i]);
-                    ptr[i] &= a.ptr[i];
-                }
+                rv = bv::and_words(ptr, a.ptr, std::min(size, a.size));
             } else {
                 rv |= ((*ptr & a.data) != *ptr);
                 *ptr &= a.data;
             }
             if (size > a.size) {
-                if (!rv) {
-                    for (size_t i = a.size; i < size; i++)
-                        if (ptr[i]) {
-                            rv = true;
-                            break;
-                        }
-                }
+                rv |= bv::any_words(ptr + a.size, size - a.size);
                 memset(ptr + a.size, 0, (size - a.size) * sizeof(*ptr));
             }
         } else if (a.size > 1) {
@@ -472,10 +510,7 @@ class bitvec {
         if (size < a.size) expand(a.size);
         if (size > 1) {
             if (a.size > 1) {
-                for (size_t i = 0; i < a.size; i++) {
-                    rv |= ((ptr[i] | a.ptr[i]) != ptr[i]);
-                    ptr[i] |= a.ptr[i];
-                }
+                rv = bv::or_words(ptr, a.ptr, a.size);
             } else {
                 rv |= ((*ptr | a.data) != *ptr);
                 *ptr |= a.data;
@@ -537,10 +572,7 @@ class bitvec {
         bool rv = false;
         if (size > 1) {
             if (a.size > 1) {
-                for (size_t i = 0; i < size && i < a.size; i++) {
-                    rv |= ((ptr[i] & ~a.ptr[i]) != ptr[i]);
-                    ptr[i] &= ~a.ptr[i];
-                }
+                rv = bv::andnot_words(ptr, a.ptr, std::min(size, a.size));
             } else {
                 rv |= ((*ptr & ~a.data) != *ptr);
                 *ptr &= ~a.data;
@@ -602,11 +634,7 @@ class bitvec {
     }
     void rotate_right(size_t start_bit, size_t rotation_idx, size_t end_bit);
     bitvec rotate_right_copy(size_t start_bit, size_t rotation_idx, size_t end_bit) const;
-    int popcount() const {
-        int rv = 0;
-        for (size_t i = 0; i < size; i++) rv += bv::popcount(word(i));
-        return rv;
-    }
+    int popcount() const { return size > 1 ? bv::popcount_words(ptr, size) : bv::popcount(data); }
     bool is_contiguous() const;
 
  private:
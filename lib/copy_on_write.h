@@ -0,0 +1,59 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LIB_COPY_ON_WRITE_H_
+#define LIB_COPY_ON_WRITE_H_
+
+#include <memory>
+
+/// Holds a value of type C that is shared between copies of the holder, and is
+/// only copied when one of them is about to be modified through mut().  Const
+/// access never copies.  A default-constructed holder allocates nothing until it
+/// is first modified.
+///
+/// References and iterators obtained from mut() must not be used after the
+/// holder has been copied, as they then point into storage shared with the copy.
+template <class C>
+class copy_on_write {
+    std::shared_ptr<C> ptr;
+
+    static const C &empty() {
+        static const C value;
+        return value;
+    }
+
+ public:
+    copy_on_write() = default;
+    explicit copy_on_write(C &&value) : ptr(std::make_shared<C>(std::move(value))) {}
+
+    const C &operator*() const { return ptr ? *ptr : empty(); }
+    const C *operator->() const { return &**this; }
+
+    /// @returns the value for modification, first making a private copy of it if
+    /// it is currently shared with another holder.
+    C &mut() {
+        if (!ptr)
+            ptr = std::make_shared<C>();
+        else if (ptr.use_count() > 1)
+            ptr = std::make_shared<C>(*ptr);
+        return *ptr;
+    }
+
+    /// True if both holders currently share the same value.
+    bool shares(const copy_on_write &other) const { return ptr && ptr == other.ptr; }
+};
+
+#endif /* LIB_COPY_ON_WRITE_H_ */
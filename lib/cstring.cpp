@@ -20,6 +20,7 @@ limitations under the License.
 #include <cctype>
 #include <iomanip>
 #include <ios>
+#include <mutex>
 #include <string>
 #include <unordered_set>
 
@@ -41,9 +42,11 @@ inline table_entry_flags operator|(table_entry_flags l, table_entry_flags r) {
     return static_cast<table_entry_flags>(static_cast<int>(l) | static_cast<int>(r));
 }
 
-// cache entry, ordered by string length
+// cache entry, carries its precomputed hash so that the string is only
+// hashed once per lookup, both for shard selection and for bucket selection
 class table_entry {
     std::size_t m_length = 0;
+    std::size_t m_hash = 0;
     table_entry_flags m_flags = table_entry_flags::none;
 
     union {
@@ -53,8 +56,8 @@ class table_entry {
 
  public:
     // entry ctor, makes copy of passed string
-    table_entry(const char *string, std::size_t length, table_entry_flags flags)
-        : m_length(length) {
+    table_entry(const char *string, std::size_t length, std::size_t hash, table_entry_flags flags)
+        : m_length(length), m_hash(hash) {
         if ((flags & table_entry_flags::no_need_copy) == table_entry_flags::no_need_copy) {
             // No need to copy object, it's view of string, string literal or string allocated
             // on heap and wrapped with cstring.
@@ -89,7 +92,8 @@ class table_entry {
     // table_entry moveable only
     table_entry(const table_entry &) = delete;
 
-    table_entry(table_entry &&other) : m_length(other.m_length), m_flags(other.m_flags) {
+    table_entry(table_entry &&other)
+        : m_length(other.m_length), m_hash(other.m_hash), m_flags(other.m_flags) {
         // this object for internal usage only, length will never be accessed
         // if object was moved, so do not zero other.m_length here
 
@@ -113,6 +117,8 @@ class table_entry {
 
     std::size_t length() const { return m_length; }
 
+    std::size_t hash() const { return m_hash; }
+
     const char *string() const {
         if (is_inplace()) {
             return m_inplace_string;
@@ -122,7 +128,8 @@ class table_entry {
     }
 
     bool operator==(const table_entry &other) const {
-        return length() == other.length() && std::memcmp(string(), other.string(), length()) == 0;
+        return hash() == other.hash() && length() == other.length() &&
+               std::memcmp(string(), other.string(), length()) == 0;
     }
 
  private:
@@ -135,36 +142,71 @@ class table_entry {
 namespace std {
 template <>
 struct hash<table_entry> {
-    std::size_t operator()(const table_entry &entry) const {
-        return Util::hash(entry.string(), entry.length());
-    }
+    std::size_t operator()(const table_entry &entry) const { return entry.hash(); }
 };
 }  // namespace std
 
 namespace {
-std::unordered_set<table_entry> &cache() {
-    static std::unordered_set<table_entry> g_cache;
+// The intern table is split into independently locked shards, so that
+// threads interning unrelated strings rarely contend on the same mutex.
+// The shard is selected from the high bits of the string hash, while the
+// std::unordered_set inside the shard uses the (mixed) low bits.
+constexpr std::size_t cache_shard_bits = 6;
+constexpr std::size_t cache_shard_count = std::size_t(1) << cache_shard_bits;
+
+struct cache_shard {
+    std::mutex lock;
+    std::unordered_set<table_entry> entries;
+};
+
+cache_shard *cache() {
+    static cache_shard g_cache[cache_shard_count];
 
     return g_cache;
 }
 
+cache_shard &shard_for(std::size_t hash) {
+    return cache()[hash >> (sizeof(std::size_t) * 8 - cache_shard_bits)];
+}
+
 const char *save_to_cache(const char *string, std::size_t length, table_entry_flags flags) {
+    std::size_t hash = Util::hash(string, length);
+    cache_shard &shard = shard_for(hash);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
     if ((flags & table_entry_flags::no_need_copy) == table_entry_flags::no_need_copy) {
-        return cache().emplace(string, length, flags).first->string();
+        return shard.entries.emplace(string, length, hash, flags).first->string();
     }
 
     // temporary table_entry, used for searching only. no need to copy string
-    auto found = cache().find(table_entry(string, length, table_entry_flags::no_need_copy));
+    auto found =
+        shard.entries.find(table_entry(string, length, hash, table_entry_flags::no_need_copy));
 
-    if (found == cache().end()) {
-        return cache().emplace(string, length, flags).first->string();
+    if (found == shard.entries.end()) {
+        return shard.entries.emplace(string, length, hash, flags).first->string();
     }
 
     return found->string();
 }
 
+const char *find_in_cache(const char *string, std::size_t length) {
+    std::size_t hash = Util::hash(string, length);
+    cache_shard &shard = shard_for(hash);
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    auto found =
+        shard.entries.find(table_entry(string, length, hash, table_entry_flags::no_need_copy));
+    return found == shard.entries.end() ? nullptr : found->string();
+}
+
 }  // namespace
 
+cstring cstring::get_cached(std::string_view string) {
+    cstring result;
+    result.str = find_in_cache(string.data(), string.size());
+    return result;
+}
+
 void cstring::construct_from_shared(const char *string, std::size_t length) {
     str = save_to_cache(string, length, table_entry_flags::none);
 }
@@ -180,8 +222,13 @@ void cstring::construct_from_literal(const char *string, std::size_t length) {
 
 size_t cstring::cache_size(size_t &count) {
     size_t rv = 0;
-    count = cache().size();
-    for (auto &s : cache()) rv += sizeof(s) + s.length();
+    count = 0;
+    for (std::size_t i = 0; i < cache_shard_count; ++i) {
+        cache_shard &shard = cache()[i];
+        std::lock_guard<std::mutex> guard(shard.lock);
+        count += shard.entries.size();
+        for (auto &s : shard.entries) rv += sizeof(s) + s.length();
+    }
     return rv;
 }
 
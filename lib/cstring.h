@@ -22,6 +22,7 @@ limitations under the License.
 #include <functional>
 #include <sstream>
 #include <string>
+#include <string_view>
 
 #include "hash.h"
 
@@ -51,8 +52,9 @@ limitations under the License.
  *     std::string.
  *   - Interned strings can never be freed, so they'll stick around for the
  *     lifetime of the program.
- *   - The string interning cstring performs is currently not threadsafe, so you
- *     can't safely use cstrings off the main thread.
+ *   - Interning goes through a sharded, lock-striped table. It is safe to
+ *     create cstrings from several threads concurrently, but each conversion
+ *     pays for a (usually uncontended) mutex acquisition.
  *
  * Given these tradeoffs, the general rule of thumb to follow is that you should
  * try to convert strings to cstrings early and keep them in that form. That
@@ -263,11 +265,18 @@ class cstring {
         }
         return cstring(ss.str());
     }
+    /// @return a name which is not in @p inuse, a set or map of cstrings: @p base itself, or
+    /// @p base followed by @p sep and a number. Counting starts at @p counter, which is advanced
+    /// past the number of the returned name. Rejected candidates are not interned.
     template <class T>
     static cstring make_unique(const T &inuse, cstring base, char sep = '.');
     template <class T>
     static cstring make_unique(const T &inuse, cstring base, int &counter, char sep = '.');
 
+    /// @return the interned cstring equal to @p string, or a null cstring if no such cstring was
+    /// ever created. Unlike the constructors, this never adds @p string to the cache.
+    static cstring get_cached(std::string_view string);
+
     /// @return the total size in bytes of all interned strings. @count is set
     /// to the total number of interned strings.
     static size_t cache_size(size_t &count);
@@ -348,13 +357,18 @@ template <class T>
 cstring cstring::make_unique(const T &inuse, cstring base, int &counter, char sep) {
     if (!inuse.count(base)) return base;
 
-    char suffix[12];
-    cstring rv = base;
-    do {
-        snprintf(suffix, sizeof(suffix) / sizeof(suffix[0]), "%c%d", sep, counter++);
-        rv = base + suffix;
-    } while (inuse.count(rv));
-    return rv;
+    // A candidate which was never interned cannot be in use, so candidates are only interned
+    // once they are chosen.
+    std::string candidate(base.c_str(), base.size());
+    candidate += sep;
+    size_t prefixLength = candidate.size();
+    while (true) {
+        candidate.resize(prefixLength);
+        candidate += std::to_string(counter++);
+        cstring existing = get_cached(candidate);
+        if (existing.isNull()) return cstring(candidate);
+        if (!inuse.count(existing)) return existing;
+    }
 }
 
 template <class T>
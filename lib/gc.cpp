@@ -24,6 +24,9 @@ limitations under the License.
 #include <execinfo.h>
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT linter forbids using chrono, but we don't have alternatives
 #include <cstddef>
 #include <cstring>
 #include <new>
@@ -279,8 +282,15 @@ extern "C" int GC_print_stats;
 #endif /* HAVE_GC_PRINT_STATS */
 
 static int gc_logging_level;
+// Updated by the collector, with the world stopped, and by gc_restart_heap_peak().
+static std::atomic<size_t> heap_peak;
 
 static void gc_callback() {
+    // Called with the allocation lock held, so only the unsafe statistics can be read.
+    GC_prof_stats_s stats;
+    GC_get_prof_stats_unsafe(&stats, sizeof(stats));
+    size_t inuse = stats.heapsize_full - stats.free_bytes_full;
+    if (inuse > heap_peak) heap_peak = inuse;
     if (gc_logging_level >= 1) {
         std::clog << "****** GC called ****** (heap size " << n4(GC_get_heap_size()) << ")";
         size_t count, size = cstring::cache_size(count);
@@ -321,3 +331,68 @@ size_t gc_mem_inuse(size_t *max) {
     return 0;
 #endif
 }
+
+size_t gc_heap_inuse() {
+#if HAVE_LIBGC
+    GC_word heapsize, heapfree;
+    GC_get_heap_usage_safe(&heapsize, &heapfree, 0, 0, 0);
+    return heapsize - heapfree;
+#else
+    return 0;
+#endif
+}
+
+size_t gc_heap_peak() {
+#if HAVE_LIBGC
+    return std::max(heap_peak.load(), gc_heap_inuse());
+#else
+    return 0;
+#endif
+}
+
+void gc_restart_heap_peak(size_t from) {
+#if HAVE_LIBGC
+    heap_peak = std::max(from, gc_heap_inuse());
+#else
+    (void)from;
+#endif
+}
+
+size_t gc_bytes_allocated() {
+#if HAVE_LIBGC
+    return GC_get_total_bytes();
+#else
+    return 0;
+#endif
+}
+
+size_t gc_collections() {
+#if HAVE_LIBGC
+    return GC_get_gc_no();
+#else
+    return 0;
+#endif
+}
+
+uint64_t gc_collect() {
+#if HAVE_LIBGC
+    auto start = std::chrono::steady_clock::now();
+    GC_gcollect();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+#else
+    return 0;
+#endif
+}
+
+void gc_disable() {
+#if HAVE_LIBGC
+    GC_disable();
+#endif
+}
+
+void gc_enable() {
+#if HAVE_LIBGC
+    GC_enable();
+#endif
+}
@@ -18,9 +18,23 @@ limitations under the License.
 #define LIB_GC_H_
 
 #include <cstddef>
+#include <cstdint>
 
 void setup_gc_logging();
 size_t gc_mem_inuse(size_t *max = 0);  // trigger GC, return inuse after
+size_t gc_bytes_allocated();           // total bytes allocated so far (0 without libgc)
+size_t gc_collections();               // number of collections so far (0 without libgc)
+uint64_t gc_collect();                 // trigger GC, return the nanoseconds it took
+/// Bytes in use in the heap, including the garbage not collected yet (0 without libgc).
+size_t gc_heap_inuse();
+/// Most bytes in use seen since the last gc_restart_heap_peak(): now, or just before one
+/// of the collections, which are only seen after setup_gc_logging() (0 without libgc).
+size_t gc_heap_peak();
+/// Restart the tracking of gc_heap_peak() from the larger of @p from and gc_heap_inuse().
+void gc_restart_heap_peak(size_t from = 0);
+/// Disable and re-enable the collections triggered by heap growth; calls nest.
+void gc_disable();
+void gc_enable();
 
 #define ALLOC_TRACE_DEPTH 5
 struct alloc_trace_cb_t {
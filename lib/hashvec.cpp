@@ -16,6 +16,13 @@ limitations under the License.
 
 #include "hashvec.h"
 
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 #include "exceptions.h"
 
 /* FIXME -- there are almost certainly problems when the hashtable size
@@ -47,6 +54,35 @@ void hash_vector_base::sethash_s3(hash_vector_base *ht, size_t i, uint32_t v) {
     ht->hash.s3[i] = v;
 }
 
+/* Returns a mask with bit i set if byte i of the 16 at ctrl is byte. */
+static inline uint32_t match_group(const uint8_t *ctrl, uint8_t byte) {
+#if defined(__SSE2__)
+    __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(byte))));
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    static const uint8_t bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t match = vandq_u8(vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(byte)), vld1q_u8(bits));
+    return vaddv_u8(vget_low_u8(match)) | (vaddv_u8(vget_high_u8(match)) << 8);
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < 16; i++) mask |= static_cast<uint32_t>(ctrl[i] == byte) << i;
+    return mask;
+#endif
+}
+
+/* The slot index is derived from the low-order bits of the hash, so the tag
+ * takes the high-order bits of the hash multiplied by a large odd constant,
+ * which depend on all of them. */
+uint8_t hash_vector_base::hashtag(size_t hash) {
+    return (static_cast<uint64_t>(hash) * UINT64_C(0x9E3779B97F4A7C15)) >> 57;
+}
+
+void hash_vector_base::setslot(size_t slot, uint32_t idx, uint8_t tag) {
+    info->sethash(this, slot, idx);
+    ctrl[slot] = idx ? tag : ctrl_empty;
+    if (slot < 15) ctrl[hashsize + slot] = ctrl[slot];
+}
+
 static size_t mod_f(size_t x) { return x % 0xf; }
 static size_t mod_1f(size_t x) { return x % 0x1f; }
 static size_t mod_3f(size_t x) { return x % 0x3f; }
@@ -130,6 +166,8 @@ void hash_vector_base::allochash() {
             memset(hash.s3, 0, hashsize * info->hashelsize);
             break;
     }
+    ctrl = new uint8_t[hashsize + 15];
+    memset(ctrl, ctrl_empty, hashsize + 15);
 }
 
 void hash_vector_base::freehash() {
@@ -147,6 +185,8 @@ void hash_vector_base::freehash() {
             break;
     }
     hash.s1 = nullptr;
+    delete[] ctrl;
+    ctrl = nullptr;
 }
 
 hash_vector_base::hash_vector_base(bool ismap, bool ismulti, size_t capacity) {
@@ -202,6 +242,7 @@ hash_vector_base::hash_vector_base(const hash_vector_base &a)
       erased(a.erased) {
     allochash();
     memcpy(hash.s1, a.hash.s1, hashsize * info->hashelsize);
+    memcpy(ctrl, a.ctrl, hashsize + 15);
 }
 
 hash_vector_base::hash_vector_base(hash_vector_base &&a)
@@ -213,6 +254,8 @@ hash_vector_base::hash_vector_base(hash_vector_base &&a)
       erased(a.erased) {
     hash.s1 = a.hash.s1;
     a.hash.s1 = nullptr;
+    ctrl = a.ctrl;
+    a.ctrl = nullptr;
 }
 
 hash_vector_base &hash_vector_base::operator=(const hash_vector_base &a) {
@@ -226,6 +269,7 @@ hash_vector_base &hash_vector_base::operator=(const hash_vector_base &a) {
         erased = a.erased;
         allochash();
         memcpy(hash.s1, a.hash.s1, hashsize * info->hashelsize);
+        memcpy(ctrl, a.ctrl, hashsize + 15);
     }
     return *this;
 }
@@ -241,6 +285,8 @@ hash_vector_base &hash_vector_base::operator=(hash_vector_base &&a) {
         erased = a.erased;
         hash.s1 = a.hash.s1;
         a.hash.s1 = nullptr;
+        ctrl = a.ctrl;
+        a.ctrl = nullptr;
     }
     return *this;
 }
@@ -256,36 +302,62 @@ void hash_vector_base::clear() {
     allochash();
 }
 
-size_t hash_vector_base::find(const void *key, lookup_cache *cache) const {
-    size_t hash = mod_hashsize[log_hashsize](hashfn(key));
-    size_t idx, collisions = 0;
-    while ((idx = info->gethash(this, hash)) && (erased[idx - 1] || !cmpfn(key, idx - 1))) {
-        if (++collisions >= hashsize) {
-            idx = 0;
-            break;
+/* Visits the slots from slot on, in order, until an empty slot, a slot with
+ * the key or every slot, as linear probing would; but the slots are compared
+ * 16 at a time with the tag of the key, and the key is only compared with the
+ * entries of the slots whose tag matches.  Returns the index of the entry
+ * plus one, or 0 if not found. */
+size_t hash_vector_base::probe(const void *key, size_t slot, size_t collisions,
+                               lookup_cache *cache) const {
+    auto wrap = [this](size_t s) {
+        while (s >= hashsize) s -= hashsize;
+        return s;
+    };
+    /* the distance from slot of the last slot to visit */
+    size_t last = collisions < hashsize ? hashsize - 1 - collisions : 0;
+    for (size_t base = 0;; base += 16) {
+        const uint8_t *group = ctrl + slot;
+        uint32_t empty = match_group(group, ctrl_empty);
+        uint32_t match = match_group(group, cache->tag);
+        /* the slots after the first empty one are not part of this probe */
+        if (empty) match &= (empty & -empty) - 1;
+        for (; match; match &= match - 1) {
+            size_t i = __builtin_ctz(match);
+            if (base + i > last) break;
+            size_t at = wrap(slot + i);
+            size_t idx = info->gethash(this, at);
+            if (!erased[idx - 1] && cmpfn(key, idx - 1)) {
+                cache->slot = at;
+                cache->collisions = collisions + base + i;
+                return idx;
+            }
+        }
+        size_t i = empty ? __builtin_ctz(empty) : 16;
+        if (base + i > last) {
+            cache->slot = wrap(slot + last - base);
+            cache->collisions = collisions + last + 1;
+            return 0;
+        }
+        if (empty) {
+            cache->slot = wrap(slot + i);
+            cache->collisions = collisions + base + i;
+            return 0;
         }
-        if (++hash == hashsize) hash = 0;
+        slot = wrap(slot + 16);
     }
-    cache->slot = hash;
-    cache->collisions = collisions;
-    return idx;
+}
+
+size_t hash_vector_base::find(const void *key, lookup_cache *cache) const {
+    size_t hash = hashfn(key);
+    cache->tag = hashtag(hash);
+    return probe(key, mod_hashsize[log_hashsize](hash), 0, cache);
 }
 
 size_t hash_vector_base::find_next(const void *key, lookup_cache *cache) const {
-    size_t hash = cache->slot;
-    size_t idx, collisions = cache->collisions;
-    if (!(idx = info->gethash(this, hash))) return idx;
-    if (++hash == hashsize) hash = 0;
-    while ((idx = info->gethash(this, hash)) && (erased[idx - 1] || !cmpfn(key, idx - 1))) {
-        if (++collisions >= hashsize) {
-            idx = 0;
-            break;
-        }
-        if (++hash == hashsize) hash = 0;
-    }
-    cache->slot = hash;
-    cache->collisions = collisions;
-    return idx;
+    size_t slot = cache->slot;
+    if (!info->gethash(this, slot)) return 0;
+    if (++slot == hashsize) slot = 0;
+    return probe(key, slot, cache->collisions, cache);
 }
 
 void *hash_vector_base::lookup(const void *key, lookup_cache *cache) {
@@ -306,6 +378,7 @@ void hash_vector_base::redo_hash() {
     size_t i, j;
     lookup_cache cache;
     memset(hash.s1, 0, hashsize * info->hashelsize);
+    memset(ctrl, ctrl_empty, hashsize + 15);
     collisions = 0;
     size_t limit = this->limit();
     auto erased = this->erased;
@@ -324,7 +397,7 @@ void hash_vector_base::redo_hash() {
         if (j != i) {
             moveentry(j, i);
         }
-        info->sethash(this, cache.slot, ++j);
+        setslot(cache.slot, ++j, cache.tag);
         collisions += cache.collisions;
     }
     resizedata(j);
@@ -339,7 +412,8 @@ size_t hash_vector_base::hv_insert(const void *key, lookup_cache *cache) {
         if (find(key, &local) && info->ismulti)
             while (find_next(key, &local)) {
             }
-        BUG_CHECK(local.slot == cache->slot && local.collisions == cache->collisions,
+        BUG_CHECK(local.slot == cache->slot && local.collisions == cache->collisions &&
+                      local.tag == cache->tag,
                   "invalid cache in hash_vector_base::hv_insert");
 #endif
     } else {
@@ -399,7 +473,7 @@ size_t hash_vector_base::hv_insert(const void *key, lookup_cache *cache) {
                 while (find_next(key, cache)) {
                 }
         }
-        info->sethash(this, cache->slot, limit() + 1);
+        setslot(cache->slot, limit() + 1, cache->tag);
         inuse++;
         return -1;
     } else if (erased[idx - 1]) {
@@ -427,7 +501,7 @@ size_t hash_vector_base::remove(const void *key, lookup_cache *cache) {
         if (!erased[idx - 1]) inuse--;
         if (idx == limit()) {
             resizedata(idx - 1);
-            info->sethash(this, cache->slot, 0);
+            setslot(cache->slot, 0, 0);
             collisions -= cache->collisions;
         } else {
             erased[idx - 1] = 1;
@@ -39,6 +39,15 @@ class hash_vector_base {
     static void sethash_s1(hash_vector_base *, size_t, uint32_t);
     static void sethash_s2(hash_vector_base *, size_t, uint32_t);
     static void sethash_s3(hash_vector_base *, size_t, uint32_t);
+    /* One control byte per slot of the hash array, so that probes compare
+     * 16 slots at a time with the hash of the key before comparing keys:
+     * ctrl_empty if the slot is empty, and 7 bits of the hash of the key
+     * otherwise.  The first 15 bytes are repeated after the last, so that
+     * every group of 16 can be loaded at once. */
+    uint8_t *ctrl;
+    static constexpr uint8_t ctrl_empty = 0x80;
+    static uint8_t hashtag(size_t hash);
+    void setslot(size_t slot, uint32_t idx, uint8_t tag);
     void allochash();
     void freehash();
 
@@ -49,6 +58,7 @@ class hash_vector_base {
     struct lookup_cache {
         size_t slot;
         size_t collisions;
+        uint8_t tag;
         uint32_t getidx(const hash_vector_base *);
         const void *getkey(const hash_vector_base *);
         void *getval(hash_vector_base *);
@@ -76,6 +86,7 @@ class hash_vector_base {
     virtual void moveentry(size_t, size_t) = 0;
 
     void clear();
+    size_t probe(const void *key, size_t slot, size_t collisions, lookup_cache *cache) const;
     size_t find(const void *key, lookup_cache *cache) const;
     size_t find_next(const void *key, lookup_cache *cache) const;
     void *lookup(const void *key, lookup_cache *cache = nullptr);
@@ -18,6 +18,7 @@ limitations under the License.
 #define LIB_HVEC_MAP_H_
 
 #include <initializer_list>
+#include <stdexcept>
 #include <tuple>
 #include <vector>
 
@@ -146,14 +147,14 @@ class hvec_map : hash_vector_base {
     bool empty() const { return inuse == 0; }
     size_t size() const { return inuse; }
     size_t max_size() const { return UINT32_MAX; }
-    bool operator==(const hvec_map &a) {
+    bool operator==(const hvec_map &a) const {
         if (inuse != a.inuse) return false;
         auto it = begin();
         for (auto &el : a)
             if (el != *it++) return false;
         return true;
     }
-    bool operator!=(const hvec_map &a) { return !(*this == a); }
+    bool operator!=(const hvec_map &a) const { return !(*this == a); }
     void clear() {
         hash_vector_base::clear();
         data.clear();
@@ -175,6 +176,17 @@ class hvec_map : hash_vector_base {
         return idx > 0;
     }
 
+    VAL &at(const KEY &k) {
+        auto it = find(k);
+        if (it == end()) throw std::out_of_range("hvec_map::at");
+        return it->second;
+    }
+    const VAL &at(const KEY &k) const {
+        auto it = find(k);
+        if (it == end()) throw std::out_of_range("hvec_map::at");
+        return it->second;
+    }
+
     // FIXME -- how to do this without duplicating the code for lvalue/rvalue?
     VAL &operator[](const KEY &k) {
         size_t idx = hv_insert(&k);
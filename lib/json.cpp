@@ -32,13 +32,20 @@ cstring IJson::toString() const {
 
 void IJson::dump() const { std::cout << toString(); }
 
+void IJson::serialize(std::ostream &out, bool minimal) const {
+    JsonWriter writer(out, minimal);
+    serialize(writer);
+}
+
 JsonValue *JsonValue::null = new JsonValue();
 
 JsonValue::JsonValue(long long v) : tag(Kind::Number), value(v) {}
 
 JsonValue::JsonValue(unsigned long long v) : tag(Kind::Number), value(v) {}
 
-void JsonValue::serialize(std::ostream &out) const {
+void JsonValue::serialize(JsonWriter &writer) const { writer.value(*this); }
+
+void JsonValue::write(std::ostream &out) const {
     switch (tag) {
         case Kind::String:
             out << "\"" << str << "\"";
@@ -92,28 +99,17 @@ bool JsonValue::operator==(const JsonValue &other) const {
     }
 }
 
-void JsonArray::serialize(std::ostream &out) const {
-    bool isSmall = true;
+bool JsonArray::isSmall() const {
     for (auto v : *this) {
-        if (!v->is<JsonValue>()) isSmall = false;
+        if (v != nullptr && !v->is<JsonValue>()) return false;
     }
-    out << "[";
-    if (!isSmall) out << IndentCtl::indent;
-    bool first = true;
-    for (auto v : *this) {
-        if (!first) {
-            out << ",";
-            if (isSmall) out << " ";
-        }
-        if (!isSmall) out << IndentCtl::endl;
-        if (v == nullptr)
-            out << "null";
-        else
-            v->serialize(out);
-        first = false;
-    }
-    if (!isSmall) out << IndentCtl::unindent << IndentCtl::endl;
-    out << "]";
+    return true;
+}
+
+void JsonArray::serialize(JsonWriter &writer) const {
+    writer.beginArray(isSmall());
+    for (auto v : *this) writer.value(v);
+    writer.endArray();
 }
 
 bool JsonValue::getBool() const {
@@ -142,20 +138,10 @@ JsonArray *JsonArray::append(IJson *value) {
     return this;
 }
 
-void JsonObject::serialize(std::ostream &out) const {
-    out << "{" << IndentCtl::indent;
-    bool first = true;
-    for (auto &it : *this) {
-        if (!first) out << ",";
-        first = false;
-        out << IndentCtl::endl;
-        out << "\"" << it.first << "\"" << " : ";
-        if (it.second == nullptr)
-            out << "null";
-        else
-            it.second->serialize(out);
-    }
-    out << IndentCtl::unindent << IndentCtl::endl << "}";
+void JsonObject::serialize(JsonWriter &writer) const {
+    writer.beginObject();
+    for (auto &it : *this) writer.key(it.first).value(it.second);
+    writer.endObject();
 }
 
 JsonObject *JsonObject::emplace(cstring label, IJson *value) {
@@ -167,7 +153,7 @@ JsonObject *JsonObject::emplace(cstring label, IJson *value) {
                                        "for a label which already exists ") +
                                label.c_str() + " " + s.c_str());
     }
-    ordered_map<cstring, IJson *>::emplace(label, value);
+    hvec_map<cstring, IJson *>::emplace(label, value);
     return this;
 }
 
@@ -178,4 +164,92 @@ JsonObject *JsonObject::emplace_non_null(cstring label, IJson *value) {
     return this;
 }
 
+void JsonWriter::startValue() {
+    if (stack.empty()) return;
+    auto &top = stack.back();
+    if (top.isObject) {
+        if (!haveKey) throw std::logic_error("Json object member written without a key");
+        haveKey = false;
+        return;
+    }
+    if (minimal) {
+        if (!top.empty) out.put(',');
+    } else if (top.compact) {
+        if (!top.empty) out << ", ";
+    } else {
+        if (top.empty)
+            out << IndentCtl::indent;
+        else
+            out << ",";
+        out << IndentCtl::endl;
+    }
+    top.empty = false;
+}
+
+JsonWriter &JsonWriter::beginObject() {
+    startValue();
+    if (minimal)
+        out.put('{');
+    else
+        out << "{" << IndentCtl::indent;
+    stack.push_back({true, false});
+    return *this;
+}
+
+JsonWriter &JsonWriter::endObject() {
+    if (stack.empty() || !stack.back().isObject || haveKey)
+        throw std::logic_error("Unbalanced json object");
+    stack.pop_back();
+    if (minimal)
+        out.put('}');
+    else
+        out << IndentCtl::unindent << IndentCtl::endl << "}";
+    return *this;
+}
+
+JsonWriter &JsonWriter::beginArray(bool compact) {
+    startValue();
+    out.put('[');
+    stack.push_back({false, compact});
+    return *this;
+}
+
+JsonWriter &JsonWriter::endArray() {
+    if (stack.empty() || stack.back().isObject) throw std::logic_error("Unbalanced json array");
+    auto top = stack.back();
+    stack.pop_back();
+    if (!minimal && !top.compact && !top.empty) out << IndentCtl::unindent << IndentCtl::endl;
+    out.put(']');
+    return *this;
+}
+
+JsonWriter &JsonWriter::key(cstring label) {
+    if (stack.empty() || !stack.back().isObject || haveKey)
+        throw std::logic_error("Json key written outside of an object");
+    auto &top = stack.back();
+    if (!top.empty) out.put(',');
+    top.empty = false;
+    if (minimal) {
+        out.put('"');
+        out.write(label.c_str(), label.size());
+        out.write("\":", 2);
+    } else {
+        out << IndentCtl::endl << "\"" << label << "\"" << " : ";
+    }
+    haveKey = true;
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const JsonValue &v) {
+    startValue();
+    v.write(out);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const IJson *v) {
+    if (v == nullptr) return value(*JsonValue::null);
+    v->serialize(*this);
+    return *this;
+}
+
 }  // namespace Util
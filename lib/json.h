@@ -17,6 +17,7 @@ limitations under the License.
 #ifndef LIB_JSON_H_
 #define LIB_JSON_H_
 
+#include <cstddef>
 #include <iostream>
 #include <stdexcept>
 #include <type_traits>
@@ -28,8 +29,8 @@ limitations under the License.
 #include "lib/big_int_util.h"
 #include "lib/castable.h"
 #include "lib/cstring.h"
+#include "lib/hvec_map.h"
 #include "lib/map.h"
-#include "lib/ordered_map.h"
 
 namespace Test {
 class TestJson;
@@ -37,10 +38,14 @@ class TestJson;
 
 namespace Util {
 
+class JsonWriter;
+
 class IJson : public ICastable {
  public:
     virtual ~IJson() {}
-    virtual void serialize(std::ostream &out) const = 0;
+    /// With @p minimal, the output has no whitespace.
+    void serialize(std::ostream &out, bool minimal = false) const;
+    virtual void serialize(JsonWriter &writer) const = 0;
     cstring toString() const;
     void dump() const;
 
@@ -68,7 +73,10 @@ class JsonValue final : public IJson {
     JsonValue(cstring s) : tag(Kind::String), str(s) {}             // NOLINT
     JsonValue(const std::string &s) : tag(Kind::String), str(s) {}  // NOLINT
     JsonValue(const char *s) : tag(Kind::String), str(s) {}         // NOLINT
-    void serialize(std::ostream &out) const override;
+    using IJson::serialize;
+    void serialize(JsonWriter &writer) const override;
+    /// Writes the bare value, with no surrounding layout.
+    void write(std::ostream &out) const;
 
     bool operator==(const big_int &v) const;
     // is_integral is true for bool
@@ -112,7 +120,10 @@ class JsonArray final : public IJson, public std::vector<IJson *> {
     friend class Test::TestJson;
 
  public:
-    void serialize(std::ostream &out) const override;
+    using IJson::serialize;
+    void serialize(JsonWriter &writer) const override;
+    /// True if all elements are scalars, in which case the array is kept on one line.
+    bool isSmall() const;
     JsonArray *clone() const { return new JsonArray(*this); }
     JsonArray *append(IJson *value);
     JsonArray *append(big_int v) {
@@ -155,12 +166,13 @@ class JsonArray final : public IJson, public std::vector<IJson *> {
     DECLARE_TYPEINFO(JsonArray, IJson);
 };
 
-class JsonObject final : public IJson, public ordered_map<cstring, IJson *> {
+class JsonObject final : public IJson, public hvec_map<cstring, IJson *> {
     friend class Test::TestJson;
 
  public:
     JsonObject() = default;
-    void serialize(std::ostream &out) const override;
+    using IJson::serialize;
+    void serialize(JsonWriter &writer) const override;
     JsonObject *emplace(cstring label, IJson *value);
     JsonObject *emplace_non_null(cstring label, IJson *value);
     JsonObject *emplace(cstring label, big_int v) {
@@ -193,6 +205,57 @@ class JsonObject final : public IJson, public ordered_map<cstring, IJson *> {
     DECLARE_TYPEINFO(JsonObject, IJson);
 };
 
+/// Writes JSON text straight to a stream, in the same layout IJson::serialize
+/// produces, without materializing a document first.  Containers are opened and
+/// closed explicitly and every value written directly inside an object must be
+/// preceded by a key.  Already built IJson subtrees can be spliced in with value(),
+/// so a producer can stream the bulk of its output and keep only small pieces as
+/// IJson trees.  A minimal writer emits no whitespace at all, which makes large
+/// documents much smaller and faster to write and parse.  Misuse (e.g. a value
+/// without a key) throws std::logic_error.
+class JsonWriter {
+    struct Frame {
+        bool isObject;
+        bool compact;
+        bool empty = true;
+    };
+    std::ostream &out;
+    bool minimal;
+    std::vector<Frame> stack;
+    bool haveKey = false;
+
+    /// Emits whatever separates the next value from the previous one.
+    void startValue();
+
+ public:
+    explicit JsonWriter(std::ostream &out, bool minimal = false) : out(out), minimal(minimal) {}
+
+    JsonWriter &beginObject();
+    JsonWriter &endObject();
+    /// A compact array is written on a single line; use it for arrays of scalars.
+    JsonWriter &beginArray(bool compact = false);
+    JsonWriter &endArray();
+    JsonWriter &key(cstring label);
+
+    JsonWriter &value(const JsonValue &v);
+    /// Splices in an already built subtree; nullptr is written as null.
+    JsonWriter &value(const IJson *v);
+    JsonWriter &value(std::nullptr_t) { return value(*JsonValue::null); }
+    template <typename T, typename std::enable_if<!std::is_pointer<T>::value ||
+                                                      std::is_same<T, const char *>::value,
+                                                  int>::type = 0>
+    JsonWriter &value(T v) {
+        return value(JsonValue(v));
+    }
+    template <typename T>
+    JsonWriter &field(cstring label, T v) {
+        return key(label).value(v);
+    }
+
+    /// Nesting depth of the containers still open.
+    size_t depth() const { return stack.size(); }
+};
+
 }  // namespace Util
 
 #endif /* LIB_JSON_H_ */
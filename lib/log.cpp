@@ -22,6 +22,8 @@ limitations under the License.
 #define NOGC_ARGS
 #endif /* HAVE_LIBGC */
 
+#include <atomic>
+#include <cstdio>
 #include <cstring>
 #include <fstream>  // IWYU pragma: keep
 #include <iomanip>
@@ -42,6 +44,9 @@ namespace Detail {
 
 int verbosity = 0;
 int maximumLogLevel = 0;
+// Starts at 1, so that unfilled call site caches are never valid.
+std::atomic<uint32_t> cacheGeneration{1};
+std::ostream *traceEvents = nullptr;
 bool enableLoggingGlobally = true;
 bool enableLoggingInContext = false;
 
@@ -297,13 +302,92 @@ void invalidateCaches(int possibleNewMaxLogLevel) {
     mostRecentInfo = nullptr;
     logLevelCache.clear();
     maximumLogLevel = std::max(maximumLogLevel, possibleNewMaxLogLevel);
+    cacheGeneration++;
     for (auto fn : invalidateCallbacks) fn();
 }
 
 void addInvalidateCallback(void (*fn)(void)) { invalidateCallbacks.push_back(fn); }
 
+#ifdef MULTITHREAD
+static std::mutex traceEventsLock;
+#endif  // MULTITHREAD
+
+// Appends @value to @out as a JSON string.
+static void appendJsonString(std::string &out, std::string_view value) {
+    out += '"';
+    for (char c : value) {
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
 }  // namespace Detail
 
+void enableTraceEvents(const char *file) {
+#ifdef MULTITHREAD
+    std::lock_guard<std::mutex> acquire(Detail::traceEventsLock);
+#endif  // MULTITHREAD
+    // The stream lives until the program exits, like the log files.
+    static std::unique_ptr<std::ofstream> traceFile;
+    traceFile.reset(new std::ofstream(file));
+    if (!*traceFile) {
+        std::cerr << "Unable to open trace event file '" << file << "'" << std::endl;
+        Detail::traceEvents = nullptr;
+        return;
+    }
+    Detail::traceEvents = traceFile.get();
+}
+
+TraceEvent::TraceEvent(const char *name) {
+    line = "{\"event\":";
+    Detail::appendJsonString(line, name);
+}
+
+TraceEvent &TraceEvent::field(const char *key, std::string_view value) {
+    line += ',';
+    Detail::appendJsonString(line, key);
+    line += ':';
+    Detail::appendJsonString(line, value);
+    return *this;
+}
+
+TraceEvent &TraceEvent::field(const char *key, int64_t value) {
+    line += ',';
+    Detail::appendJsonString(line, key);
+    line += ':';
+    line += std::to_string(value);
+    return *this;
+}
+
+TraceEvent::~TraceEvent() {
+    line += "}\n";
+#ifdef MULTITHREAD
+    std::lock_guard<std::mutex> acquire(Detail::traceEventsLock);
+#endif  // MULTITHREAD
+    if (Detail::traceEvents != nullptr) Detail::traceEvents->write(line.data(), line.size());
+}
+
 void addDebugSpec(const char *spec) {
 #ifdef CLOCK_MONOTONIC
     if (!Detail::initTime) {
@@ -17,10 +17,14 @@ limitations under the License.
 #ifndef LIB_LOG_H_
 #define LIB_LOG_H_
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <set>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "config.h"
@@ -38,6 +42,9 @@ extern int verbosity;
 // A cache of the maximum log level requested for any file.
 extern int maximumLogLevel;
 
+// The output of structured trace events, if they are enabled.
+extern std::ostream *traceEvents;
+
 // Used to restrict logging to a specific IR context.
 extern bool enableLoggingGlobally;
 extern bool enableLoggingInContext;  // if enableLoggingGlobally is true, this is ignored.
@@ -46,6 +53,25 @@ extern bool enableLoggingInContext;  // if enableLoggingGlobally is true, this i
 int fileLogLevel(const char *file);
 std::ostream &fileLogOutput(const char *file);
 
+// Incremented whenever the log levels change, which invalidates all CallSiteLevel caches.
+extern std::atomic<uint32_t> cacheGeneration;
+
+// Caches the log level of the file of one call site of the logging macros, so that enabled
+// logging does not look up the level of the file on every call. The cache holds the generation
+// it was filled in and the level, and is refreshed once the generation changes.
+struct CallSiteLevel {
+    std::atomic<uint64_t> cached{0};
+
+    int get(const char *file) {
+        uint64_t generation = cacheGeneration.load(std::memory_order_relaxed);
+        uint64_t value = cached.load(std::memory_order_relaxed);
+        if ((value >> 32) == generation) return static_cast<int32_t>(value);
+        int level = fileLogLevel(file);
+        cached.store(generation << 32 | static_cast<uint32_t>(level), std::memory_order_relaxed);
+        return level;
+    }
+};
+
 // A utility class used to prepend file and log level information to logging output.
 // also controls indent control and locking for multithreaded use
 class OutputLogPrefix {
@@ -98,6 +124,26 @@ inline bool enableLogging() {
 }
 void increaseVerbosity();
 
+// Writes structured trace events, one JSON object per line, to @file. Events are much cheaper to
+// produce and to analyze than the text of the logging macros.
+void enableTraceEvents(const char *file);
+inline bool traceEventsEnabled() { return Detail::traceEvents != nullptr; }
+
+// One structured trace event, which is written when it is destroyed. Only construct events if
+// traceEventsEnabled() returns true, for example
+//   Log::TraceEvent("pass").field("name", name).field("ns", duration);
+class TraceEvent {
+    std::string line;
+
+ public:
+    explicit TraceEvent(const char *name);
+    TraceEvent(const TraceEvent &) = delete;
+    TraceEvent &operator=(const TraceEvent &) = delete;
+    ~TraceEvent();
+    TraceEvent &field(const char *key, std::string_view value);
+    TraceEvent &field(const char *key, int64_t value);
+};
+
 }  // namespace Log
 
 #ifndef MAX_LOGGING_LEVEL
@@ -106,9 +152,16 @@ void increaseVerbosity();
 #endif
 
 // NOLINTBEGIN(bugprone-macro-parentheses)
-#define LOGGING(N)                                                            \
-    ((N) <= MAX_LOGGING_LEVEL && ::Log::fileLogLevelIsAtLeast(__FILE__, N) && \
-     ::Log::enableLogging())
+// The log level of the literal file name @FILE, cached at the call site.
+#define LOG_CALL_SITE_LEVEL(FILE)                     \
+    ([]() -> ::Log::Detail::CallSiteLevel & {         \
+        static ::Log::Detail::CallSiteLevel site;     \
+        return site;                                  \
+    }()                                               \
+         .get(FILE))
+#define LOGGING(N)                                                        \
+    ((N) <= MAX_LOGGING_LEVEL && ::Log::Detail::maximumLogLevel >= (N) && \
+     LOG_CALL_SITE_LEVEL(__FILE__) >= (N) && ::Log::enableLogging())
 #define LOGN(N, X)                                                        \
     (LOGGING(N) ? ::Log::Detail::fileLogOutput(__FILE__)                  \
                       << ::Log::Detail::OutputLogPrefix(__FILE__, N) << X \
@@ -136,6 +189,7 @@ void increaseVerbosity();
 #define LOG8_UNINDENT LOGN_UNINDENT(8)
 #define LOG9_UNINDENT LOGN_UNINDENT(9)
 
+// TAG is not always a literal, so its level is not cached at the call site.
 #define LOG_FEATURE(TAG, N, X)                                             \
     ((N) <= MAX_LOGGING_LEVEL && ::Log::fileLogLevelIsAtLeast(TAG, N)      \
          ? ::Log::Detail::fileLogOutput(TAG)                               \
@@ -19,21 +19,50 @@ limitations under the License.
 
 #include <ctype.h>
 
-#include <sstream>
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
 
 #include "lib/cstring.h"
 #include "lib/exceptions.h"
 #include "lib/stringify.h"
 
 namespace Util {
+/// Accumulates generated source code. The code is kept in a list of segments which are allocated
+/// once with a fixed capacity, so that appending never copies the code emitted so far. Large
+/// outputs should be written with @ref writeTo, which streams the segments without building one
+/// string of the whole code.
 class SourceCodeBuilder {
+    /// The capacity of a segment. Larger strings get a segment of their own size.
+    static constexpr size_t SEGMENT_SIZE = 64 * 1024;
+
     int indentLevel;  // current indent level
     unsigned indentAmount;
 
-    std::stringstream buffer;
-    const std::string nl = "\n";
+    /// The code in order. Only the last segment is appended to.
+    std::vector<std::string> segments;
     bool endsInSpace;
 
+    /// Appends @p size characters at @p str, without updating endsInSpace.
+    void write(const char *str, size_t size) {
+        if (segments.empty() || segments.back().size() + size > segments.back().capacity()) {
+            segments.emplace_back();
+            segments.back().reserve(std::max(size, SEGMENT_SIZE));
+        }
+        segments.back().append(str, size);
+    }
+
+    /// Appends @p size characters at @p str.
+    void appendChars(const char *str, size_t size) {
+        if (size == 0) return;
+        endsInSpace = ::isspace(str[size - 1]);
+        write(str, size);
+    }
+
  public:
     SourceCodeBuilder() : indentLevel(0), indentAmount(4), endsInSpace(false) {}
 
@@ -43,11 +72,11 @@ class SourceCodeBuilder {
         if (indentLevel < 0) BUG("Negative indent");
     }
     void newline() {
-        buffer << nl;
+        write("\n", 1);
         endsInSpace = true;
     }
     void spc() {
-        if (!endsInSpace) buffer << " ";
+        if (!endsInSpace) write(" ", 1);
         endsInSpace = true;
     }
 
@@ -56,30 +85,37 @@ class SourceCodeBuilder {
         append(str);
         newline();
     }
-    void append(const std::string &str) {
-        if (str.empty()) return;
-        endsInSpace = ::isspace(str.at(str.size() - 1));
-        buffer << str;
-    }
-    void append(char c) {
-        endsInSpace = ::isspace(c);
-        buffer << c;
-    }
+    void append(const std::string &str) { appendChars(str.data(), str.size()); }
+    void append(char c) { appendChars(&c, 1); }
     void append(const char *str) {
         if (str == nullptr) BUG("Null argument to append");
-        if (strlen(str) == 0) return;
-        endsInSpace = ::isspace(str[strlen(str) - 1]);
-        buffer << str;
+        appendChars(str, strlen(str));
     }
+    /// Formats into a local buffer and appends the result, without interning a cstring.
     void appendFormat(const char *format, ...) {
+        char buf[256];
         va_list ap;
+        va_list apCopy;
         va_start(ap, format);
-        cstring str = Util::vprintf_format(format, ap);
+        va_copy(apCopy, ap);
+        int size = vsnprintf(buf, sizeof(buf), format, ap);
         va_end(ap);
+        if (size < 0) {
+            va_end(apCopy);
+            BUG("Error in vsnprintf");
+        }
+        if (static_cast<size_t>(size) < sizeof(buf)) {
+            va_end(apCopy);
+            appendChars(buf, size);
+            return;
+        }
+        std::string str(size, '\0');
+        vsnprintf(str.data(), size + 1, format, apCopy);
+        va_end(apCopy);
         append(str);
     }
-    void append(unsigned u) { appendFormat("%d", u); }
-    void append(int u) { appendFormat("%d", u); }
+    void append(unsigned u) { append(std::to_string(u)); }
+    void append(int u) { append(std::to_string(u)); }
 
     void endOfStatement(bool addNl = false) {
         append(";");
@@ -93,7 +129,12 @@ class SourceCodeBuilder {
     }
 
     void emitIndent() {
-        buffer << std::string(indentLevel, ' ');
+        static const std::string spaces(256, ' ');
+        for (size_t left = indentLevel; left > 0;) {
+            size_t count = std::min(left, spaces.size());
+            write(spaces.data(), count);
+            left -= count;
+        }
         if (indentLevel > 0) endsInSpace = true;
     }
 
@@ -104,7 +145,23 @@ class SourceCodeBuilder {
         if (nl) newline();
     }
 
-    std::string toString() const { return buffer.str(); }
+    /// @returns the number of characters of the code.
+    size_t size() const {
+        size_t result = 0;
+        for (const auto &segment : segments) result += segment.size();
+        return result;
+    }
+    std::string toString() const {
+        std::string result;
+        result.reserve(size());
+        for (const auto &segment : segments) result += segment;
+        return result;
+    }
+    /// Writes the code to @p out.
+    void writeTo(std::ostream &out) const {
+        for (const auto &segment : segments)
+            out.write(segment.data(), static_cast<std::streamsize>(segment.size()));
+    }
     void commentStart() { append("/* "); }
     void commentEnd() { append(" */"); }
     bool lastIsSpace() const { return endsInSpace; }
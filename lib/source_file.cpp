@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <sstream>
+#include <stdexcept>
 
 #include "exceptions.h"
 #include "lib/log.h"
@@ -39,24 +40,49 @@ cstring SourcePosition::toString() const {
 
 //////////////////////////////////////////////////////////////////////////////////////////
 
+SourceInfo::SourceInfo(const InputSources *sources, SourcePosition point) : sources(sources) {
+    if (!point.isValid()) return;
+    BUG_CHECK(sources != nullptr, "Invalid InputSources in SourceInfo");
+    startOffset = endOffset = sources->getOffset(point);
+}
+
 SourceInfo::SourceInfo(const InputSources *sources, SourcePosition start, SourcePosition end)
-    : sources(sources), start(start), end(end) {
+    : sources(sources) {
     BUG_CHECK(sources != nullptr, "Invalid InputSources in SourceInfo");
     if (!start.isValid() || !end.isValid())
         BUG("Invalid source position in SourceInfo %1%-%2%", start.toString(), end.toString());
     if (start > end)
         BUG("SourceInfo position start %1% after end %2%", start.toString(), end.toString());
+    startOffset = sources->getOffset(start);
+    endOffset = sources->getOffset(end);
+}
+
+SourceInfo::SourceInfo(const InputSources *sources, unsigned startOffset, unsigned endOffset)
+    : sources(sources), startOffset(startOffset), endOffset(endOffset) {
+    BUG_CHECK(sources != nullptr, "Invalid InputSources in SourceInfo");
+    BUG_CHECK(startOffset <= endOffset && endOffset <= sources->getCurrentOffset(),
+              "Invalid SourceInfo offsets %1%-%2%", startOffset, endOffset);
+}
+
+SourcePosition SourceInfo::getStart() const {
+    if (!isValid()) return SourcePosition();
+    return sources->getPosition(startOffset);
+}
+
+SourcePosition SourceInfo::getEnd() const {
+    if (!isValid()) return SourcePosition();
+    return sources->getPosition(endOffset);
 }
 
 cstring SourceInfo::toDebugString() const {
-    return Util::printf_format("(%s)-(%s)", start.toString(), end.toString());
+    return Util::printf_format("(%s)-(%s)", getStart().toString(), getEnd().toString());
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
 
 InputSources::InputSources() : sealed(false) {
     mapLine(nullptr, 1);  // the first line read will be line 1 of stdin
-    contents.push_back("");
+    lineStarts.push_back(0);
 }
 
 void InputSources::addComment(SourceInfo srcInfo, bool singleLine, cstring body) {
@@ -75,8 +101,8 @@ void InputSources::seal() {
 }
 
 unsigned InputSources::lineCount() const {
-    int size = contents.size();
-    if (contents.back().empty()) {
+    int size = lineStarts.size();
+    if (lineStarts.back() == contents.size()) {
         // do not count the last line if it is empty.
         size -= 1;
         if (size < 0) BUG("Negative line count");
@@ -92,46 +118,24 @@ void InputSources::appendToLastLine(std::string_view text) {
         char c = text[i];
         if (c == '\n') BUG("Text contains newlines");
     }
-    contents.back() += toString(text);
+    contents += text;
 }
 
 // Append a newline and start a new line
 void InputSources::appendNewline(std::string_view newline) {
     if (sealed) BUG("Appending to sealed InputSources");
-    contents.back() += toString(newline);
-    contents.push_back("");  // start a new line
+    contents += newline;
+    lineStarts.push_back(contents.size());  // start a new line
 }
 
-void InputSources::appendText(const char *text) {
-    if (text == nullptr) BUG("Null text being appended");
-    std::string_view ref(text);
-
-    while (ref.size() > 0) {
-        auto nlPos = ref.find_first_of("\r\n");
-        if (nlPos == std::string_view::npos) {
-            appendToLastLine(ref);
-            break;
-        }
-
-        size_t toCut = nlPos;
-        if (toCut != 0) {
-            std::string_view nonnl(ref.data(), toCut);
-            appendToLastLine(nonnl);
-            ref.remove_prefix(toCut);
-        } else {
-            if (ref[0] == '\n') {
-                appendNewline("\n");
-                ref.remove_prefix(1);
-            } else if (ref.size() > 2 && ref[0] == '\r' && ref[1] == '\n') {
-                appendNewline("\r\n");
-                ref.remove_prefix(2);
-            } else {
-                // Just \r
-                appendToLastLine(ref.substr(0, 1));
-                ref.remove_prefix(1);
-            }
-        }
-    }
+void InputSources::appendText(std::string_view text) {
+    if (sealed) BUG("Appending to sealed InputSources");
+    BUG_CHECK(contents.size() + text.size() < ~0U, "Input program too large");
+    // Lines end after each \n; a \r before it (or on its own) is part of the line.
+    size_t offset = contents.size();
+    contents += text;
+    while ((offset = contents.find('\n', offset)) != std::string::npos)
+        lineStarts.push_back(++offset);
 }
 
 cstring InputSources::getLine(unsigned lineNumber) const {
@@ -141,7 +145,10 @@ cstring InputSources::getLine(unsigned lineNumber) const {
         // don't throw: this code may be called by exceptions
         // reporting on elements that have no source position
     }
-    return contents.at(lineNumber - 1);
+    if (lineNumber > lineStarts.size()) throw std::out_of_range("InputSources::getLine");
+    unsigned start = lineStarts[lineNumber - 1];
+    unsigned end = lineNumber < lineStarts.size() ? lineStarts[lineNumber] : contents.size();
+    return cstring(std::string_view(contents).substr(start, end - start));
 }
 
 void InputSources::mapLine(cstring file, unsigned originalSourceLineNo) {
@@ -171,11 +178,23 @@ SourceFileLine InputSources::getSourceLine(unsigned line) const {
     return SourceFileLine(it->second.fileName, realLine);
 }
 
-unsigned InputSources::getCurrentLineNumber() const { return contents.size(); }
+unsigned InputSources::getCurrentLineNumber() const { return lineStarts.size(); }
+
+SourcePosition InputSources::getPosition(unsigned offset) const {
+    auto next = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset);
+    unsigned line = next - lineStarts.begin();
+    return SourcePosition(line, offset - lineStarts[line - 1]);
+}
+
+unsigned InputSources::getOffset(const SourcePosition &position) const {
+    unsigned line = position.getLineNumber();
+    if (line == 0 || line > lineStarts.size()) return contents.size();
+    return std::min<size_t>(lineStarts[line - 1] + position.getColumnNumber(), contents.size());
+}
 
 SourcePosition InputSources::getCurrentPosition() const {
     unsigned line = getCurrentLineNumber();
-    unsigned column = contents.back().size();
+    unsigned column = contents.size() - lineStarts.back();
     return SourcePosition(line, column);
 }
 
@@ -255,7 +274,7 @@ cstring InputSources::getBriefSourceFragment(const SourceInfo &position) const {
 
 cstring InputSources::toDebugString() const {
     std::stringstream builder;
-    for (auto line : contents) builder << line;
+    builder << contents;
     builder << "---------------" << std::endl;
     for (auto lf : line_file_map) builder << lf.first << ": " << lf.second.toString() << std::endl;
     return cstring(builder.str());
@@ -275,11 +294,12 @@ cstring SourceInfo::toBriefSourceFragment() const {
 
 cstring SourceInfo::toPositionString() const {
     if (!isValid()) return "";
-    SourceFileLine position = sources->getSourceLine(start.getLineNumber());
+    SourceFileLine position = sources->getSourceLine(getStart().getLineNumber());
     return position.toString();
 }
 
 cstring SourceInfo::toSourcePositionData(unsigned *outLineNumber, unsigned *outColumnNumber) const {
+    auto start = getStart();
     SourceFileLine position = sources->getSourceLine(start.getLineNumber());
     if (outLineNumber != nullptr) {
         *outLineNumber = position.sourceLine;
@@ -291,16 +311,16 @@ cstring SourceInfo::toSourcePositionData(unsigned *outLineNumber, unsigned *outC
 }
 
 SourceFileLine SourceInfo::toPosition() const {
-    return sources->getSourceLine(start.getLineNumber());
+    return sources->getSourceLine(getStart().getLineNumber());
 }
 
 cstring SourceInfo::getSourceFile() const {
-    auto sourceLine = sources->getSourceLine(start.getLineNumber());
+    auto sourceLine = sources->getSourceLine(getStart().getLineNumber());
     return sourceLine.fileName;
 }
 
 cstring SourceInfo::getLineNum() const {
-    SourceFileLine sourceLine = sources->getSourceLine(start.getLineNumber());
+    SourceFileLine sourceLine = sources->getSourceLine(getStart().getLineNumber());
     return toString(sourceLine.sourceLine);
 }
 
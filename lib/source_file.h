@@ -21,7 +21,10 @@ limitations under the License.
 #ifndef LIB_SOURCE_FILE_H_
 #define LIB_SOURCE_FILE_H_
 
+#include <algorithm>
 #include <map>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "cstring.h"
@@ -125,24 +128,26 @@ SourceInfo can also be "invalid"
 */
 class SourceInfo final {
  public:
-    cstring filename = "";
-    int line = -1;
-    int column = -1;
-    cstring srcBrief = "";
-    SourceInfo(cstring filename, int line, int column, cstring srcBrief) {
-        this->filename = filename;
-        this->line = line;
-        this->column = column;
-        this->srcBrief = srcBrief;
-    }
+    /// Position information restored from a JSON dump (--fromJSON), for which
+    /// the original InputSources are no longer available.
+    struct Detached {
+        cstring filename;
+        int line;
+        int column;
+        cstring srcBrief;
+    };
+    SourceInfo(cstring filename, int line, int column, cstring srcBrief)
+        : detachedInfo(new Detached{filename, line, column, srcBrief}) {}
     /// Creates an "invalid" SourceInfo
     SourceInfo() = default;
 
     /// Creates a SourceInfo for a 'point' in the source, or invalid
-    SourceInfo(const InputSources *sources, SourcePosition point)
-        : sources(sources), start(point), end(point) {}
+    SourceInfo(const InputSources *sources, SourcePosition point);
 
     SourceInfo(const InputSources *sources, SourcePosition start, SourcePosition end);
+    /// Creates a SourceInfo for the text between two offsets in @p sources,
+    /// as returned by InputSources::getCurrentOffset().
+    SourceInfo(const InputSources *sources, unsigned startOffset, unsigned endOffset);
 
     SourceInfo(const SourceInfo &other) = default;
     SourceInfo &operator=(const SourceInfo &other) = default;
@@ -154,21 +159,24 @@ class SourceInfo final {
     SourceInfo operator+(const SourceInfo &rhs) const {
         if (!this->isValid()) return rhs;
         if (!rhs.isValid()) return *this;
-        SourcePosition s = start.min(rhs.start);
-        SourcePosition e = end.max(rhs.end);
-        return SourceInfo(sources, s, e);
+        SourceInfo result(*this);
+        result.startOffset = std::min(startOffset, rhs.startOffset);
+        result.endOffset = std::max(endOffset, rhs.endOffset);
+        return result;
     }
     SourceInfo &operator+=(const SourceInfo &rhs) {
         if (!isValid()) {
             *this = rhs;
         } else if (rhs.isValid()) {
-            start = start.min(rhs.start);
-            end = end.max(rhs.end);
+            startOffset = std::min(startOffset, rhs.startOffset);
+            endOffset = std::max(endOffset, rhs.endOffset);
         }
         return *this;
     }
 
-    bool operator==(const SourceInfo &rhs) const { return start == rhs.start && end == rhs.end; }
+    bool operator==(const SourceInfo &rhs) const {
+        return startOffset == rhs.startOffset && endOffset == rhs.endOffset;
+    }
 
     cstring toDebugString() const;
 
@@ -180,15 +188,22 @@ class SourceInfo final {
     cstring toSourcePositionData(unsigned *outLineNumber, unsigned *outColumnNumber) const;
     SourceFileLine toPosition() const;
 
-    bool isValid() const { return this->start.isValid(); }
+    bool isValid() const { return startOffset != invalidOffset; }
     explicit operator bool() const { return isValid(); }
 
     cstring getSourceFile() const;
     cstring getLineNum() const;
 
-    const SourcePosition &getStart() const { return this->start; }
+    /// The line and column of the start and end; these are computed on each call.
+    SourcePosition getStart() const;
+    SourcePosition getEnd() const;
 
-    const SourcePosition &getEnd() const { return this->end; }
+    /// The sources this SourceInfo refers to, or nullptr if it is invalid.
+    const InputSources *getSources() const { return sources; }
+
+    /// The position restored from JSON, or nullptr if this SourceInfo was not
+    /// read with --fromJSON.
+    const Detached *detached() const { return detachedInfo; }
 
     /**
        True if this comes 'before' this source position.
@@ -198,16 +213,21 @@ class SourceInfo final {
     bool operator<(const SourceInfo &rhs) const {
         if (!rhs.isValid()) return false;
         if (!isValid()) return true;
-        return this->start < rhs.start;
+        return this->startOffset < rhs.startOffset;
     }
     inline bool operator>(const SourceInfo &rhs) const { return rhs.operator<(*this); }
     inline bool operator<=(const SourceInfo &rhs) const { return !this->operator>(rhs); }
     inline bool operator>=(const SourceInfo &rhs) const { return !this->operator<(rhs); }
 
  private:
+    static constexpr unsigned invalidOffset = ~0U;
+
     const InputSources *sources = nullptr;
-    SourcePosition start = SourcePosition();
-    SourcePosition end = SourcePosition();
+    /// Offsets of the first character and of the position after the last one in
+    /// the text of sources; line and column numbers are only computed on demand.
+    unsigned startOffset = invalidOffset;
+    unsigned endOffset = invalidOffset;
+    const Detached *detachedInfo = nullptr;
 };
 
 class IHasSourceInfo {
@@ -275,12 +295,20 @@ class InputSources final {
     unsigned lineCount() const;
     SourcePosition getCurrentPosition() const;
     unsigned getCurrentLineNumber() const;
+    /// Offset of the end of the text appended so far.
+    unsigned getCurrentOffset() const { return contents.size(); }
+
+    /// The line and column of the character at @p offset; a binary search over the
+    /// line starts.
+    SourcePosition getPosition(unsigned offset) const;
+    /// The offset of @p position, clamped to the end of the text.
+    unsigned getOffset(const SourcePosition &position) const;
 
     /// Prevents further changes; currently not used.
     void seal();
 
-    /// Append this text; it is either a newline or a text with no newlines.
-    void appendText(const char *text);
+    /// Append this text, which may span several lines.
+    void appendText(std::string_view text);
 
     /**
         Map the next line in the file to the line with number 'originalSourceLine'
@@ -310,8 +338,11 @@ class InputSources final {
 
     std::map<unsigned, SourceFileLine> line_file_map;
 
-    /// Each line also stores the end-of-line character(s)
-    std::vector<std::string> contents;
+    /// The whole text read so far, including end-of-line characters.  Lines are
+    /// only materialized when asked for (getLine), e.g. to print a diagnostic.
+    std::string contents;
+    /// Offset in contents where each line starts; lineStarts[0] is line 1.
+    std::vector<unsigned> lineStarts;
     /// The commends found in the file.
     std::vector<Comment *> comments;
 };
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <chrono>  // NOLINT linter forbids using chrono, but we don't have alternatives
 #include <memory>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 
@@ -98,7 +99,18 @@ struct ScopedTimerCtx {
 };
 #pragma GCC diagnostic pop
 
-ScopedTimer::ScopedTimer(const char *name) : ctx(new ScopedTimerCtx(name)) {}
+/// @returns true on the thread which used a timer first. The counters are not thread-safe, so
+/// timers on other threads, such as solver threads, measure nothing.
+static bool onTimerThread() {
+    static const std::thread::id TIMER_THREAD = std::this_thread::get_id();
+    return std::this_thread::get_id() == TIMER_THREAD;
+}
+
+ScopedTimer::ScopedTimer(const char *name) {
+    if (onTimerThread()) {
+        ctx = std::make_unique<ScopedTimerCtx>(name);
+    }
+}
 
 ScopedTimer::~ScopedTimer() = default;
 
@@ -0,0 +1,563 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "egraphSimplify.h"
+
+#include <climits>
+#include <tuple>
+
+#include "lib/big_int_util.h"
+
+namespace P4 {
+
+using Op = EGraph::Op;
+
+/// The name of the IR node implementing @p op, as passed to ExpressionCostModel.
+static cstring opName(Op op) {
+    switch (op) {
+        case Op::Leaf:
+            return "Leaf";
+        case Op::Constant:
+            return "Constant";
+        case Op::Add:
+            return "Add";
+        case Op::Sub:
+            return "Sub";
+        case Op::Mul:
+            return "Mul";
+        case Op::BAnd:
+            return "BAnd";
+        case Op::BOr:
+            return "BOr";
+        case Op::BXor:
+            return "BXor";
+        case Op::Neg:
+            return "Neg";
+        case Op::Cmpl:
+            return "Cmpl";
+        case Op::Shl:
+            return "Shl";
+        case Op::Shr:
+            return "Shr";
+        case Op::Slice:
+            return "Slice";
+        case Op::Concat:
+            return "Concat";
+    }
+    BUG("unexpected operation");
+}
+
+static bool isCommutative(Op op) {
+    return op == Op::Add || op == Op::Mul || op == Op::BAnd || op == Op::BOr || op == Op::BXor;
+}
+
+static const IR::Type_Bits *unsignedBits(const IR::Expression *expression) {
+    auto type = expression->type ? expression->type->to<IR::Type_Bits>() : nullptr;
+    return type != nullptr && !type->isSigned ? type : nullptr;
+}
+
+/// The operation of @p expression and its operands, if the EGraph represents
+/// it other than as a leaf.
+static std::optional<Op> operationOf(const IR::Expression *expression,
+                                     std::vector<const IR::Expression *> *operands = nullptr) {
+    if (!unsignedBits(expression)) return std::nullopt;
+    std::vector<const IR::Expression *> ops;
+    std::optional<Op> op;
+    if (expression->is<IR::Constant>()) {
+        op = Op::Constant;
+    } else if (auto binary = expression->to<IR::Operation_Binary>()) {
+        ops = {binary->left, binary->right};
+        if (expression->is<IR::Add>()) {
+            op = Op::Add;
+        } else if (expression->is<IR::Sub>()) {
+            op = Op::Sub;
+        } else if (expression->is<IR::Mul>()) {
+            op = Op::Mul;
+        } else if (expression->is<IR::BAnd>()) {
+            op = Op::BAnd;
+        } else if (expression->is<IR::BOr>()) {
+            op = Op::BOr;
+        } else if (expression->is<IR::BXor>()) {
+            op = Op::BXor;
+        } else if (expression->is<IR::Concat>()) {
+            if (unsignedBits(binary->left) && unsignedBits(binary->right)) op = Op::Concat;
+        } else if (expression->is<IR::Shl>() || expression->is<IR::Shr>()) {
+            ops = {binary->left};
+            if (binary->right->is<IR::Constant>())
+                op = expression->is<IR::Shl>() ? Op::Shl : Op::Shr;
+        }
+    } else if (auto unary = expression->to<IR::Operation_Unary>()) {
+        ops = {unary->expr};
+        if (expression->is<IR::Neg>())
+            op = Op::Neg;
+        else if (expression->is<IR::Cmpl>())
+            op = Op::Cmpl;
+    } else if (auto slice = expression->to<IR::Slice>()) {
+        ops = {slice->e0};
+        if (unsignedBits(slice->e0) && slice->e1->is<IR::Constant>() &&
+            slice->e2->is<IR::Constant>())
+            op = Op::Slice;
+    }
+    if (op && operands) *operands = ops;
+    return op;
+}
+
+unsigned ExpressionCostModel::cost(cstring node_type, unsigned) const {
+    if (node_type == "Constant") return 0;
+    if (node_type == "Mul") return 4;
+    return 1;
+}
+
+bool EGraph::ENode::operator<(const ENode &other) const {
+    return std::tie(op, width, value, hi, operands, leafText) <
+           std::tie(other.op, other.width, other.value, other.hi, other.operands, other.leafText);
+}
+
+EGraph::ClassId EGraph::find(ClassId id) const {
+    while (parent.at(id) != id) id = parent.at(id);
+    return id;
+}
+
+EGraph::ENode EGraph::canonical(ENode node) {
+    for (auto &operand : node.operands) operand = find(operand);
+    return node;
+}
+
+std::optional<big_int> EGraph::fold(const ENode &node) const {
+    if (node.op == Op::Constant) return node.value;
+    if (node.op == Op::Leaf) return std::nullopt;
+    std::vector<big_int> values;
+    for (auto operand : node.operands) {
+        auto value = constants.at(find(operand));
+        if (!value) return std::nullopt;
+        values.push_back(*value);
+    }
+    big_int mask = Util::mask(node.width);
+    big_int modulus = mask + 1;
+    switch (node.op) {
+        case Op::Add:
+            return (values[0] + values[1]) & mask;
+        case Op::Sub:
+            return (values[0] + modulus - values[1]) & mask;
+        case Op::Mul:
+            return (values[0] * values[1]) & mask;
+        case Op::BAnd:
+            return values[0] & values[1];
+        case Op::BOr:
+            return values[0] | values[1];
+        case Op::BXor:
+            return values[0] ^ values[1];
+        case Op::Neg:
+            return (modulus - values[0]) & mask;
+        case Op::Cmpl:
+            return mask ^ values[0];
+        case Op::Shl:
+            if (node.value >= node.width) return big_int(0);
+            return Util::shift_left(values[0], static_cast<unsigned>(node.value)) & mask;
+        case Op::Shr:
+            if (node.value >= node.width) return big_int(0);
+            return Util::shift_right(values[0], static_cast<unsigned>(node.value));
+        case Op::Slice:
+            return Util::shift_right(values[0], static_cast<unsigned>(node.value)) & mask;
+        case Op::Concat:
+            return Util::shift_left(values[0], width(node.operands[1])) | values[1];
+        default:
+            BUG("unexpected operation");
+    }
+}
+
+EGraph::ClassId EGraph::add(ENode node) {
+    node = canonical(node);
+    if (node.op == Op::Constant) node.value &= Util::mask(node.width);
+    auto it = hashcons.find(node);
+    if (it != hashcons.end()) return find(it->second);
+    ClassId id = parent.size();
+    parent.push_back(id);
+    classes.push_back({node});
+    constants.push_back(fold(node));
+    hashcons.emplace(node, id);
+    nodeCount++;
+    if (node.op != Op::Constant && constants.back()) {
+        merge(id, constant(*constants.back(), node.width));
+        return find(id);
+    }
+    return id;
+}
+
+EGraph::ClassId EGraph::constant(big_int value, unsigned width) {
+    return add(ENode{Op::Constant, width, {}, value});
+}
+
+EGraph::ClassId EGraph::unary(Op op, ClassId operand, unsigned width, big_int value,
+                              unsigned hi) {
+    return add(ENode{op, width, {operand}, value, hi});
+}
+
+EGraph::ClassId EGraph::binary(Op op, ClassId left, ClassId right, unsigned width) {
+    return add(ENode{op, width, {left, right}});
+}
+
+std::optional<EGraph::ClassId> EGraph::add(const IR::Expression *expression) {
+    auto type = unsignedBits(expression);
+    if (type == nullptr) return std::nullopt;
+    unsigned width = type->width_bits();
+    std::vector<const IR::Expression *> operands;
+    auto op = operationOf(expression, &operands);
+    if (!op) return add(ENode{Op::Leaf, width, {}, 0, 0, expression, expression->toString()});
+    ENode node{*op, width};
+    for (auto operand : operands) node.operands.push_back(*add(operand));
+    if (auto constant = expression->to<IR::Constant>()) {
+        node.value = constant->value;
+    } else if (auto shift = expression->to<IR::Operation_Binary>()) {
+        if (*op == Op::Shl || *op == Op::Shr) node.value = shift->right->to<IR::Constant>()->value;
+    } else if (auto slice = expression->to<IR::Slice>()) {
+        node.value = slice->getL();
+        node.hi = slice->getH();
+    }
+    return add(node);
+}
+
+bool EGraph::merge(ClassId a, ClassId b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return false;
+    parent[b] = a;
+    auto &nodes = classes[a];
+    nodes.insert(nodes.end(), classes[b].begin(), classes[b].end());
+    classes[b].clear();
+    if (!constants[a]) constants[a] = constants[b];
+    return true;
+}
+
+void EGraph::rebuild() {
+    // Restore the invariant that equal nodes are in the same class: merging
+    // the operands of two nodes makes them equal.
+    for (bool changed = true; changed;) {
+        changed = false;
+        std::map<ENode, ClassId> fresh;
+        std::vector<std::pair<ClassId, ClassId>> congruent;
+        nodeCount = 0;
+        for (ClassId id = 0; id < classes.size(); id++) {
+            if (find(id) != id) continue;
+            std::vector<ENode> nodes;
+            for (const auto &node : classes[id]) {
+                auto key = canonical(node);
+                auto [it, inserted] = fresh.emplace(key, id);
+                if (inserted)
+                    nodes.push_back(key);
+                else if (it->second != id)
+                    congruent.emplace_back(it->second, id);
+            }
+            nodeCount += nodes.size();
+            classes[id] = std::move(nodes);
+        }
+        hashcons = std::move(fresh);
+        for (auto [a, b] : congruent) changed |= merge(a, b);
+    }
+}
+
+bool EGraph::rewriteSlice(ClassId id, const ENode &node) {
+    unsigned hi = node.hi;
+    unsigned lo = static_cast<unsigned>(node.value);
+    unsigned width = node.width;
+    ClassId x = node.operands[0];
+    if (lo == 0 && hi + 1 == this->width(x)) return merge(id, x);
+    bool changed = false;
+    auto slice = [&](ClassId e, unsigned h, unsigned l) {
+        return unary(Op::Slice, e, h - l + 1, l, h);
+    };
+    // Copied, since adding nodes may reallocate the classes.
+    auto nodes = classes.at(find(x));
+    for (const auto &n : nodes) {
+        switch (n.op) {
+            case Op::Slice: {
+                unsigned l2 = static_cast<unsigned>(n.value);
+                changed |= merge(id, slice(n.operands[0], hi + l2, lo + l2));
+                break;
+            }
+            case Op::Concat: {
+                unsigned low = this->width(n.operands[1]);
+                if (hi < low)
+                    changed |= merge(id, slice(n.operands[1], hi, lo));
+                else if (lo >= low)
+                    changed |= merge(id, slice(n.operands[0], hi - low, lo - low));
+                break;
+            }
+            case Op::Shl: {
+                unsigned amount = static_cast<unsigned>(n.value);
+                if (lo >= amount)
+                    changed |= merge(id, slice(n.operands[0], hi - amount, lo - amount));
+                else if (hi < amount)
+                    changed |= merge(id, constant(0, width));
+                break;
+            }
+            case Op::Shr: {
+                unsigned amount = static_cast<unsigned>(n.value);
+                if (hi + amount < n.width)
+                    changed |= merge(id, slice(n.operands[0], hi + amount, lo + amount));
+                else if (lo + amount >= n.width)
+                    changed |= merge(id, constant(0, width));
+                break;
+            }
+            case Op::BAnd:
+            case Op::BOr:
+            case Op::BXor:
+                changed |= merge(id, binary(n.op, slice(n.operands[0], hi, lo),
+                                            slice(n.operands[1], hi, lo), width));
+                break;
+            case Op::Add:
+            case Op::Sub:
+            case Op::Mul:
+                // The low bits of the result only depend on the low bits of the operands.
+                if (lo == 0)
+                    changed |= merge(id, binary(n.op, slice(n.operands[0], hi, 0),
+                                                slice(n.operands[1], hi, 0), width));
+                break;
+            case Op::Neg:
+                if (lo == 0)
+                    changed |= merge(id, unary(Op::Neg, slice(n.operands[0], hi, 0), width));
+                break;
+            case Op::Cmpl:
+                changed |= merge(id, unary(Op::Cmpl, slice(n.operands[0], hi, lo), width));
+                break;
+            default:
+                break;
+        }
+    }
+    return changed;
+}
+
+bool EGraph::rewrite(ClassId id, const ENode &node) {
+    if (node.op == Op::Leaf || node.op == Op::Constant) return false;
+    if (node.op == Op::Slice) return rewriteSlice(id, node);
+    unsigned width = node.width;
+    big_int mask = Util::mask(width);
+    ClassId left = node.operands[0];
+    auto isConstant = [&](ClassId e, big_int value) {
+        auto c = constants.at(find(e));
+        return c && *c == value;
+    };
+    auto operandNodes = [&](ClassId e) { return classes.at(find(e)); };
+    bool changed = false;
+
+    if (node.op == Op::Neg || node.op == Op::Cmpl) {
+        for (const auto &n : operandNodes(left))
+            if (n.op == node.op) changed |= merge(id, n.operands[0]);
+        return changed;
+    }
+    if (node.op == Op::Shl || node.op == Op::Shr) {
+        if (node.value == 0) return merge(id, left);
+        if (node.value >= width) return merge(id, constant(0, width));
+        for (const auto &n : operandNodes(left))
+            if (n.op == node.op)
+                changed |= merge(id, unary(node.op, n.operands[0], width, node.value + n.value));
+        return changed;
+    }
+
+    ClassId right = node.operands[1];
+    if (node.op == Op::Concat) {
+        // Concatenating adjacent slices of a value is a slice.
+        for (const auto &l : operandNodes(left)) {
+            if (l.op != Op::Slice) continue;
+            for (const auto &r : operandNodes(right)) {
+                if (r.op != Op::Slice || find(r.operands[0]) != find(l.operands[0]) ||
+                    l.value != r.hi + 1)
+                    continue;
+                changed |= merge(id, unary(Op::Slice, l.operands[0], width, r.value, l.hi));
+            }
+        }
+        return changed;
+    }
+    if (node.op == Op::Sub) {
+        if (isConstant(right, 0)) return merge(id, left);
+        if (find(left) == find(right)) return merge(id, constant(0, width));
+        if (isConstant(left, 0)) changed |= merge(id, unary(Op::Neg, right, width));
+        changed |= merge(id, binary(Op::Add, left, unary(Op::Neg, right, width), width));
+        return changed;
+    }
+
+    // Commutative operations, with the constant operands on the right.
+    changed |= merge(id, binary(node.op, right, left, width));
+    for (const auto &n : operandNodes(left)) {
+        if (n.op != node.op) continue;
+        // (a op b) op right == a op (b op right)
+        changed |= merge(id, binary(node.op, n.operands[0],
+                                    binary(node.op, n.operands[1], right, width), width));
+    }
+    switch (node.op) {
+        case Op::Add:
+            if (isConstant(right, 0)) changed |= merge(id, left);
+            for (const auto &n : operandNodes(right)) {
+                if (n.op != Op::Neg) continue;
+                if (find(n.operands[0]) == find(left))
+                    changed |= merge(id, constant(0, width));
+                else
+                    changed |= merge(id, binary(Op::Sub, left, n.operands[0], width));
+            }
+            break;
+        case Op::Mul:
+            if (auto c = constants.at(find(right))) {
+                if (*c == 0)
+                    changed |= merge(id, constant(0, width));
+                else if (*c == 1)
+                    changed |= merge(id, left);
+                else if (bitcount(*c) == 1)
+                    changed |= merge(id, unary(Op::Shl, left, width, floor_log2(*c)));
+            }
+            break;
+        case Op::BAnd:
+            if (isConstant(right, 0))
+                changed |= merge(id, constant(0, width));
+            else if (isConstant(right, mask) || find(left) == find(right))
+                changed |= merge(id, left);
+            break;
+        case Op::BOr:
+            if (isConstant(right, mask))
+                changed |= merge(id, constant(mask, width));
+            else if (isConstant(right, 0) || find(left) == find(right))
+                changed |= merge(id, left);
+            break;
+        case Op::BXor:
+            if (isConstant(right, 0))
+                changed |= merge(id, left);
+            else if (find(left) == find(right))
+                changed |= merge(id, constant(0, width));
+            else if (isConstant(right, mask))
+                changed |= merge(id, unary(Op::Cmpl, left, width));
+            break;
+        default:
+            BUG_CHECK(isCommutative(node.op), "unexpected operation");
+    }
+    return changed;
+}
+
+void EGraph::saturate(unsigned iterations) {
+    for (unsigned i = 0; i < iterations && nodeCount < maxNodes; i++) {
+        std::vector<std::pair<ClassId, ENode>> matches;
+        for (ClassId id = 0; id < classes.size(); id++)
+            for (const auto &node : classes[id]) matches.emplace_back(id, node);
+        bool changed = false;
+        for (const auto &[id, node] : matches) {
+            if (nodeCount >= maxNodes) break;
+            changed |= rewrite(find(id), canonical(node));
+        }
+        rebuild();
+        if (!changed) break;
+    }
+}
+
+unsigned EGraph::cost(const IR::Expression *expression, const ExpressionCostModel &model) {
+    std::vector<const IR::Expression *> operands;
+    auto op = operationOf(expression, &operands);
+    if (!op) return 0;
+    unsigned result = model.cost(opName(*op), unsignedBits(expression)->width_bits());
+    for (auto operand : operands) result += cost(operand, model);
+    return result;
+}
+
+const IR::Expression *EGraph::build(ClassId id, const std::vector<const ENode *> &best) const {
+    const ENode *node = best.at(find(id));
+    CHECK_NULL(node);
+    if (node->op == Op::Leaf) return node->leaf;
+    auto type = IR::Type_Bits::get(node->width);
+    if (node->op == Op::Constant) return new IR::Constant(type, node->value);
+    std::vector<const IR::Expression *> e;
+    for (auto operand : node->operands) e.push_back(build(operand, best));
+    switch (node->op) {
+        case Op::Add:
+            return new IR::Add(type, e[0], e[1]);
+        case Op::Sub:
+            return new IR::Sub(type, e[0], e[1]);
+        case Op::Mul:
+            return new IR::Mul(type, e[0], e[1]);
+        case Op::BAnd:
+            return new IR::BAnd(type, e[0], e[1]);
+        case Op::BOr:
+            return new IR::BOr(type, e[0], e[1]);
+        case Op::BXor:
+            return new IR::BXor(type, e[0], e[1]);
+        case Op::Concat:
+            return new IR::Concat(type, e[0], e[1]);
+        case Op::Neg:
+            return new IR::Neg(type, e[0]);
+        case Op::Cmpl:
+            return new IR::Cmpl(type, e[0]);
+        case Op::Shl:
+            return new IR::Shl(type, e[0], new IR::Constant(node->value));
+        case Op::Shr:
+            return new IR::Shr(type, e[0], new IR::Constant(node->value));
+        case Op::Slice:
+            return new IR::Slice(e[0], node->hi, static_cast<unsigned>(node->value));
+        default:
+            BUG("unexpected operation");
+    }
+}
+
+std::pair<const IR::Expression *, unsigned> EGraph::extract(
+    ClassId id, const ExpressionCostModel &model) const {
+    // Iterate to a fixpoint, since the classes may be cyclic.
+    std::vector<unsigned> cost(classes.size(), UINT_MAX);
+    std::vector<const ENode *> best(classes.size(), nullptr);
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (ClassId c = 0; c < classes.size(); c++) {
+            for (const auto &node : classes[c]) {
+                unsigned total = node.op == Op::Leaf ? 0 : model.cost(opName(node.op), node.width);
+                for (auto operand : node.operands) {
+                    unsigned operandCost = cost[find(operand)];
+                    total = operandCost == UINT_MAX ? UINT_MAX : total + operandCost;
+                    if (total == UINT_MAX) break;
+                }
+                if (total < cost[c]) {
+                    cost[c] = total;
+                    best[c] = &node;
+                    changed = true;
+                }
+            }
+        }
+    }
+    return {build(id, best), cost.at(find(id))};
+}
+
+const IR::Node *DoEGraphSimplify::preorder(IR::KeyElement *key) {
+    // Rewriting a key expression would change the key of the table.
+    prune();
+    return key;
+}
+
+const IR::Node *DoEGraphSimplify::postorder(IR::Expression *expression) {
+    if (expression->is<IR::Constant>() || !operationOf(expression) || isWrite()) return expression;
+    // Simplify the largest tree the EGraph represents at once, from its root.
+    auto ctxt = getContext();
+    if (ctxt != nullptr) {
+        if (auto parent = ctxt->node->to<IR::Expression>())
+            if (operationOf(parent)) return expression;
+    }
+    bool hasCall = false;
+    forAllMatching<IR::MethodCallExpression>(expression, [&](const auto *) { hasCall = true; });
+    if (hasCall) return expression;
+
+    EGraph graph;
+    auto id = graph.add(expression);
+    if (!id) return expression;
+    graph.saturate();
+    auto [result, cost] = graph.extract(*id, *model);
+    if (cost >= EGraph::cost(expression, *model)) return expression;
+    LOG3("Simplified " << expression << " to " << result);
+    return result;
+}
+
+}  // namespace P4
@@ -0,0 +1,166 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef MIDEND_EGRAPHSIMPLIFY_H_
+#define MIDEND_EGRAPHSIMPLIFY_H_
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "ir/ir.h"
+
+namespace P4 {
+
+/// Cost of the operations of unsigned bit-vector expressions, used by EGraph to
+/// choose among equivalent forms.  Targets can override it to match their
+/// instruction costs.
+class ExpressionCostModel {
+ public:
+    virtual ~ExpressionCostModel() = default;
+    /// Cost of an operation of @p node_type (e.g. "Add", "Slice", "Constant")
+    /// producing a @p width bit value, once its operands are available.
+    /// Leaves, i.e. the operands that are not simplified, cost nothing.
+    virtual unsigned cost(cstring node_type, unsigned width) const;
+};
+
+/**
+ * An e-graph of unsigned bit-vector expressions: a set of equivalence classes
+ * of expression nodes, whose operands are classes rather than expressions, so
+ * that all the forms of an expression found by rewriting are represented at
+ * once.  The rewrites cover constant folding, the algebraic identities of
+ * StrengthReduction, reassociation and commutation, and the identities of
+ * shifts, slices and concatenations; saturate() applies them until nothing new
+ * is found or the limits are reached, and extract() builds the cheapest
+ * expression of a class.
+ *
+ * Operands that are not unsigned bit-vector operations, or whose shifts are not
+ * by constants, are leaves, identified by their text.  Leaves must not have side
+ * effects, since rewriting may duplicate or drop them.
+ */
+class EGraph {
+ public:
+    using ClassId = unsigned;
+    enum class Op {
+        Leaf, Constant, Add, Sub, Mul, BAnd, BOr, BXor, Neg, Cmpl, Shl, Shr, Slice, Concat
+    };
+
+    struct ENode {
+        Op op;
+        unsigned width;
+        std::vector<ClassId> operands;
+        /// The value of a constant; the amount of a shift; the low bit of a slice.
+        big_int value = 0;
+        /// The high bit of a slice.
+        unsigned hi = 0;
+        /// The expression of a leaf.
+        const IR::Expression *leaf = nullptr;
+        std::string leafText;
+
+        bool operator<(const ENode &other) const;
+    };
+
+ private:
+    std::vector<ClassId> parent;
+    std::vector<std::vector<ENode>> classes;
+    std::vector<std::optional<big_int>> constants;
+    std::map<ENode, ClassId> hashcons;
+    size_t nodeCount = 0;
+    size_t maxNodes;
+
+    ENode canonical(ENode node);
+    bool merge(ClassId a, ClassId b);
+    void rebuild();
+    unsigned width(ClassId id) const { return classes.at(find(id)).front().width; }
+    std::optional<big_int> fold(const ENode &node) const;
+    bool rewrite(ClassId id, const ENode &node);
+    bool rewriteSlice(ClassId id, const ENode &node);
+    ClassId constant(big_int value, unsigned width);
+    ClassId unary(Op op, ClassId operand, unsigned width, big_int value = 0, unsigned hi = 0);
+    ClassId binary(Op op, ClassId left, ClassId right, unsigned width);
+    const IR::Expression *build(ClassId id, const std::vector<const ENode *> &best) const;
+
+ public:
+    explicit EGraph(size_t maxNodes = 2000) : maxNodes(maxNodes) {}
+
+    ClassId find(ClassId id) const;
+    /// Adds @p node, returning the class it is in.  Constant nodes are reduced
+    /// modulo 2^width.
+    ClassId add(ENode node);
+    /// Adds an expression, or returns std::nullopt if it is not an unsigned
+    /// bit-vector expression.  Subexpressions that cannot be represented are leaves.
+    std::optional<ClassId> add(const IR::Expression *expression);
+    /// Returns true if @p a and @p b are known to be equal.
+    bool equal(ClassId a, ClassId b) const { return find(a) == find(b); }
+    /// The value of a class, if it is known to be a constant.
+    std::optional<big_int> constantOf(ClassId id) const { return constants.at(find(id)); }
+    size_t size() const { return nodeCount; }
+    /// The cost of @p expression as it is written, counted as extract() does.
+    static unsigned cost(const IR::Expression *expression, const ExpressionCostModel &model);
+
+    /// Applies the rewrites at most @p iterations times, or until there is
+    /// nothing new or the graph reaches its size limit.
+    void saturate(unsigned iterations = 8);
+    /// Returns the cheapest expression of a class, and its cost.
+    std::pair<const IR::Expression *, unsigned> extract(ClassId id,
+                                                        const ExpressionCostModel &model) const;
+};
+
+/**
+ * Simplifies the unsigned bit-vector expressions of the program with an
+ * EGraph, replacing each by its cheapest equivalent form when that is cheaper
+ * than the expression itself.  It finds in one pass the simplifications that
+ * need ConstantFolding, StrengthReduction and reassociation to be run
+ * alternately, and some that they miss, such as slices of shifted or
+ * concatenated values.
+ *
+ * Expressions containing method calls, expressions being written, and the
+ * table keys are left alone.
+ *
+ * @pre Requires expression types be stored inline in the expression
+ * (obtained by running TypeChecking(updateProgram = true)).
+ */
+class DoEGraphSimplify : public Transform, P4WriteContext {
+    const ExpressionCostModel *model;
+
+ public:
+    explicit DoEGraphSimplify(const ExpressionCostModel *model) : model(model) {
+        CHECK_NULL(model);
+        setName("DoEGraphSimplify");
+    }
+
+    const IR::Node *postorder(IR::Expression *expression) override;
+    const IR::Node *preorder(IR::KeyElement *key) override;
+};
+
+class EGraphSimplify : public PassManager {
+ public:
+    EGraphSimplify(ReferenceMap *refMap, TypeMap *typeMap,
+                   const ExpressionCostModel *model = new ExpressionCostModel(),
+                   TypeChecking *typeChecking = nullptr) {
+        if (!typeChecking) typeChecking = new TypeChecking(refMap, typeMap, true);
+        passes.push_back(typeChecking);
+        passes.push_back(new DoEGraphSimplify(model));
+        setName("EGraphSimplify");
+    }
+};
+
+}  // namespace P4
+
+#endif /* MIDEND_EGRAPHSIMPLIFY_H_ */
@@ -0,0 +1,294 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "eliminateCommonSubexpressions.h"
+
+#include <algorithm>
+
+#include "frontends/p4/methodInstance.h"
+#include "ir/equiv_hash.h"
+#include "ir/write_context.h"
+
+namespace P4 {
+
+namespace {
+
+/// @returns the name of the storage denoted by an l-value such as 'hdr.h.f'.
+/// A whole stack shares one name.  Empty if the expression does not denote
+/// storage.
+cstring location(const IR::Expression *expression) {
+    if (auto path = expression->to<IR::PathExpression>()) return path->path->name.name;
+    if (auto member = expression->to<IR::Member>()) {
+        // Elements of stacks, and the headers of a union, are not told apart.
+        auto baseType = member->expr->type;
+        if (member->expr->is<IR::ArrayIndex>() ||
+            (baseType && (baseType->is<IR::Type_Stack>() || baseType->is<IR::Type_HeaderUnion>())))
+            return location(member->expr);
+        auto base = location(member->expr);
+        if (!base.isNullOrEmpty()) return base + "." + member->member.name;
+    } else if (auto array = expression->to<IR::ArrayIndex>()) {
+        return location(array->left);
+    } else if (auto slice = expression->to<IR::Slice>()) {
+        return location(slice->e0);
+    }
+    return cstring();
+}
+
+/// True if the storage named 'a' and 'b' may overlap.
+bool overlaps(cstring a, cstring b) {
+    return a == b || a.startsWith(b + ".") || b.startsWith(a + ".");
+}
+
+/// Collects the names of the storage an expression reads or writes.
+class Locations : public Inspector {
+    std::set<cstring> &result;
+
+    void visitIndexes(const IR::Expression *expression) {
+        while (true) {
+            if (auto member = expression->to<IR::Member>()) {
+                expression = member->expr;
+            } else if (auto array = expression->to<IR::ArrayIndex>()) {
+                visit(array->right);
+                expression = array->left;
+            } else {
+                return;
+            }
+        }
+    }
+    bool preorder(const IR::Expression *expression) override {
+        if (!expression->is<IR::PathExpression>() && !expression->is<IR::Member>() &&
+            !expression->is<IR::ArrayIndex>())
+            return true;
+        auto loc = location(expression);
+        if (loc.isNullOrEmpty()) return true;
+        result.emplace(loc);
+        visitIndexes(expression);
+        return false;
+    }
+
+ public:
+    explicit Locations(std::set<cstring> &result) : result(result) { visitDagOnce = false; }
+};
+
+/// A value computed in a sequence of statements.
+struct Value {
+    const IR::Expression *expression;  // first occurrence
+    size_t first;                      // index of the statement computing it first
+    unsigned uses = 1;
+    std::set<cstring> reads;  // storage the value depends on
+    cstring temp;             // set if the value is kept in a temporary
+
+    Value(const IR::Expression *expression, size_t first) : expression(expression), first(first) {
+        expression->apply(Locations(reads));
+    }
+};
+
+}  // namespace
+
+/// Numbers the values computed by a sequence of statements, in execution order.
+class DoEliminateCommonSubexpressions::Scan : public Inspector {
+    DoEliminateCommonSubexpressions &self;
+    /// Values that can still be reused: none of the variables they read has
+    /// been written since they were computed.
+    IR::ExprMap<Value *> available;
+
+ public:
+    std::vector<Value *> values;  // in the order they are first computed
+    /// Values read by each statement.
+    std::vector<IR::ExprMap<Value *>> usedAt;
+
+    explicit Scan(DoEliminateCommonSubexpressions &self) : self(self) { visitDagOnce = false; }
+
+    bool preorder(const IR::Expression *expression) override {
+        if (!self.isCandidate(expression)) return true;
+        auto &uses = usedAt.back();
+        auto it = available.find(expression);
+        if (it != available.end()) {
+            it->second->uses++;
+            uses.emplace(expression, it->second);
+            return false;
+        }
+        auto value = new Value(expression, usedAt.size() - 1);
+        available.emplace(expression, value);
+        values.push_back(value);
+        uses.emplace(expression, value);
+        return true;
+    }
+
+    void startStatement() { usedAt.emplace_back(); }
+    void reads(const IR::Expression *expression) { expression->apply(*this); }
+    void writes(const IR::Expression *expression) {
+        std::set<cstring> written;
+        expression->apply(Locations(written));
+        for (auto it = available.begin(); it != available.end();) {
+            const auto &deps = it->second->reads;
+            bool killed = std::any_of(deps.begin(), deps.end(), [&](cstring r) {
+                return std::any_of(written.begin(), written.end(),
+                                   [&](cstring w) { return overlaps(r, w); });
+            });
+            if (killed)
+                available.erase(it++);
+            else
+                ++it;
+        }
+    }
+    void writesAll() { available.clear(); }
+};
+
+/// Replaces the values kept in temporaries by reads of the temporaries.
+class DoEliminateCommonSubexpressions::Replace : public Transform, P4WriteContext {
+    const IR::ExprMap<Value *> &uses;
+    /// Not replaced itself: the expression that computes the temporary.
+    const IR::Expression *keep;
+
+ public:
+    explicit Replace(const IR::ExprMap<Value *> &uses, const IR::Expression *keep = nullptr)
+        : uses(uses), keep(keep) {
+        visitDagOnce = false;
+    }
+    const IR::Node *preorder(IR::Expression *expression) override {
+        auto orig = getOriginal<IR::Expression>();
+        if (orig == keep || isWrite()) return expression;
+        auto it = uses.find(orig);
+        if (it == uses.end() || it->second->temp.isNullOrEmpty()) return expression;
+        prune();
+        return new IR::PathExpression(expression->srcInfo, new IR::Path(it->second->temp));
+    }
+};
+
+bool DoEliminateCommonSubexpressions::isCandidate(const IR::Expression *expression) {
+    if (expression->is<IR::Member>() || expression->is<IR::ArrayIndex>()) return false;
+    if (auto mce = expression->to<IR::MethodCallExpression>()) {
+        auto mi = MethodInstance::resolve(mce, refMap, typeMap);
+        auto bm = mi->to<BuiltInMethod>();
+        if (bm == nullptr || bm->name != IR::Type_Header::isValid) return false;
+    } else if (!expression->is<IR::Operation_Unary>() && !expression->is<IR::Operation_Binary>() &&
+               !expression->is<IR::Operation_Ternary>()) {
+        return false;
+    }
+    auto type = typeMap->getType(expression);
+    if (type == nullptr || !(type->is<IR::Type_Bits>() || type->is<IR::Type_Boolean>()))
+        return false;
+    return !sideEffects.memoized(expression);
+}
+
+IR::IndexedVector<IR::StatOrDecl> DoEliminateCommonSubexpressions::eliminate(
+    const IR::IndexedVector<IR::StatOrDecl> &components) {
+    if (!findContext<IR::P4Control>() && !findContext<IR::P4Parser>()) return components;
+
+    Scan scan(*this);
+    scan.setCalledBy(this);
+    for (auto component : components) {
+        scan.startStatement();
+        if (auto assign = component->to<IR::AssignmentStatement>()) {
+            scan.reads(assign->right);
+            scan.writes(assign->left);
+        } else if (auto mcs = component->to<IR::MethodCallStatement>()) {
+            auto mi = MethodInstance::resolve(mcs, refMap, typeMap);
+            std::vector<const IR::Expression *> written;
+            for (auto param : *mi->substitution.getParametersInArgumentOrder()) {
+                auto arg = mi->substitution.lookup(param);
+                if (param->direction == IR::Direction::In ||
+                    param->direction == IR::Direction::None)
+                    scan.reads(arg->expression);
+                else
+                    written.push_back(arg->expression);
+            }
+            if (auto bm = mi->to<BuiltInMethod>()) {
+                scan.writes(bm->appliedTo);
+            } else if (mi->is<ExternMethod>() || mi->is<ExternFunction>()) {
+                for (auto w : written) scan.writes(w);
+            } else {
+                // Actions, tables and functions may write anything in scope.
+                scan.writesAll();
+            }
+        } else if (auto ifs = component->to<IR::IfStatement>()) {
+            scan.reads(ifs->condition);
+            scan.writesAll();
+        } else {
+            scan.writesAll();
+        }
+    }
+
+    // Values computed for the first time by each statement, innermost first,
+    // so that a temporary can be used to compute the ones enclosing it.
+    std::vector<std::vector<const Value *>> computedAt(components.size());
+    for (auto it = scan.values.rbegin(); it != scan.values.rend(); ++it) {
+        auto value = *it;
+        if (value->uses < 2) continue;
+        auto type = typeMap->getType(value->expression, true);
+        value->temp = refMap->newName("tmp");
+        toInsert.push_back(new IR::Declaration_Variable(value->temp, type->getP4Type()));
+        computedAt[value->first].push_back(value);
+        LOG3("Computing " << dbp(value->expression) << " used " << value->uses << " times in "
+                          << value->temp);
+    }
+    if (std::all_of(computedAt.begin(), computedAt.end(),
+                    [](const std::vector<const Value *> &c) { return c.empty(); }))
+        return components;
+
+    IR::IndexedVector<IR::StatOrDecl> result;
+    for (size_t i = 0; i < components.size(); i++) {
+        const auto &uses = scan.usedAt[i];
+        for (auto value : computedAt[i]) {
+            Replace replace(uses, value->expression);
+            replace.setCalledBy(this);
+            auto expression = value->expression->apply(replace)->to<IR::Expression>();
+            result.push_back(new IR::AssignmentStatement(
+                value->expression->srcInfo, new IR::PathExpression(value->temp), expression));
+        }
+        auto component = components.at(i);
+        Replace replace(uses);
+        replace.setCalledBy(this);
+        if (auto ifs = component->to<IR::IfStatement>()) {
+            auto condition = ifs->condition->apply(replace)->to<IR::Expression>();
+            if (condition != ifs->condition) {
+                auto clone = ifs->clone();
+                clone->condition = condition;
+                component = clone;
+            }
+        } else if (component->is<IR::AssignmentStatement>() ||
+                   component->is<IR::MethodCallStatement>()) {
+            component = component->apply(replace)->to<IR::StatOrDecl>();
+        }
+        result.push_back(component);
+    }
+    return result;
+}
+
+const IR::Node *DoEliminateCommonSubexpressions::postorder(IR::BlockStatement *block) {
+    block->components = eliminate(block->components);
+    return block;
+}
+
+const IR::Node *DoEliminateCommonSubexpressions::postorder(IR::ParserState *state) {
+    state->components = eliminate(state->components);
+    return state;
+}
+
+const IR::Node *DoEliminateCommonSubexpressions::postorder(IR::P4Control *control) {
+    for (auto decl : toInsert) control->controlLocals.push_back(decl);
+    toInsert.clear();
+    return control;
+}
+
+const IR::Node *DoEliminateCommonSubexpressions::postorder(IR::P4Parser *parser) {
+    for (auto decl : toInsert) parser->parserLocals.push_back(decl);
+    toInsert.clear();
+    return parser;
+}
+
+}  // namespace P4
@@ -0,0 +1,89 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef MIDEND_ELIMINATECOMMONSUBEXPRESSIONS_H_
+#define MIDEND_ELIMINATECOMMONSUBEXPRESSIONS_H_
+
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "has_side_effects.h"
+#include "ir/ir.h"
+
+namespace P4 {
+
+/**
+Computes repeated pure expressions once.  Within each sequence of statements
+(a block statement or a parser state) an expression that is evaluated more
+than once, with none of the variables it reads written in between, is
+assigned to a new temporary before its first use, and all uses read the
+temporary instead:
+
+  h.a = h.b ++ h.c;                  tmp = h.b ++ h.c;
+  if (h.b ++ h.c == 0) ...     =>    h.a = tmp;
+                                     if (tmp == 0) ...
+
+Expressions are identified by their structure (IR::ExprMap).  The candidates
+are operations, slices, casts, conditional expressions and isValid() calls of
+type bit<...>, int<...> or bool, without side effects.  Statements other than
+assignments and method calls end the sequence, as do method calls that may
+write arbitrary state (actions, tables, functions).  The temporaries are
+declared in the enclosing control or parser; statements outside a control or
+parser are left unchanged.
+
+@pre Requires that all declaration names be globally unique (UniqueNames),
+since writes are tracked by variable name.
+*/
+class DoEliminateCommonSubexpressions final : public Transform {
+    ReferenceMap *refMap;
+    TypeMap *typeMap;
+    ::hasSideEffects sideEffects;
+    std::vector<const IR::Declaration *> toInsert;
+
+    class Scan;
+    class Replace;
+
+    bool isCandidate(const IR::Expression *expression);
+    IR::IndexedVector<IR::StatOrDecl> eliminate(
+        const IR::IndexedVector<IR::StatOrDecl> &components);
+
+ public:
+    DoEliminateCommonSubexpressions(ReferenceMap *refMap, TypeMap *typeMap)
+        : refMap(refMap), typeMap(typeMap), sideEffects(refMap, typeMap) {
+        setName("DoEliminateCommonSubexpressions");
+        CHECK_NULL(refMap);
+        CHECK_NULL(typeMap);
+    }
+    const IR::Node *postorder(IR::BlockStatement *block) override;
+    const IR::Node *postorder(IR::ParserState *state) override;
+    const IR::Node *postorder(IR::P4Control *control) override;
+    const IR::Node *postorder(IR::P4Parser *parser) override;
+};
+
+class EliminateCommonSubexpressions final : public PassManager {
+ public:
+    EliminateCommonSubexpressions(ReferenceMap *refMap, TypeMap *typeMap,
+                                  TypeChecking *typeChecking = nullptr) {
+        if (!typeChecking) typeChecking = new TypeChecking(refMap, typeMap, true);
+        passes.push_back(typeChecking);
+        passes.push_back(new DoEliminateCommonSubexpressions(refMap, typeMap));
+        passes.push_back(new ClearTypeMap(typeMap));
+        setName("EliminateCommonSubexpressions");
+    }
+};
+
+}  // namespace P4
+
+#endif /* MIDEND_ELIMINATECOMMONSUBEXPRESSIONS_H_ */
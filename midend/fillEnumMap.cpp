@@ -21,7 +21,8 @@ limitations under the License.
 namespace P4 {
 
 const IR::Node *FillEnumMap::preorder(IR::Type_Enum *type) {
-    if (strstr(type->srcInfo.filename, "v1model") == nullptr) {
+    const auto *detached = type->srcInfo.detached();
+    if (detached == nullptr || strstr(detached->filename, "v1model") == nullptr) {
         unsigned long long count = type->members.size();
         unsigned long long width = policy->enumSize(count);
         auto r = new EnumRepresentation(type->srcInfo, width);
@@ -0,0 +1,156 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "flattenAggregates.h"
+
+namespace P4 {
+
+const IR::Node *ReplaceFlattenedAggregates::preorder(IR::P4Program *program) {
+    if (headers->empty() && structs->empty()) {
+        // nothing to do
+        prune();
+    }
+    return program;
+}
+
+void ReplaceFlattenedAggregates::findParametersToReplace(const IR::ParameterList *parameters,
+                                                         const IR::Node *parent) {
+    for (auto p : parameters->parameters) {
+        auto pt = typeMap->getType(p, true);
+        auto repl = structs->getReplacement(pt);
+        if (repl != nullptr) {
+            toReplace.emplace(p, repl);
+            LOG3("Replacing parameter " << dbp(p) << " of " << dbp(parent));
+        }
+    }
+}
+
+const IR::Node *ReplaceFlattenedAggregates::preorder(IR::P4Parser *parser) {
+    findParametersToReplace(parser->getApplyParameters(), parser);
+    return parser;
+}
+
+const IR::Node *ReplaceFlattenedAggregates::preorder(IR::P4Control *control) {
+    findParametersToReplace(control->getApplyParameters(), control);
+    return control;
+}
+
+const IR::Node *ReplaceFlattenedAggregates::postorder(IR::Type_Header *type) {
+    auto canon = typeMap->getTypeType(getOriginal(), true);
+    auto name = canon->to<IR::Type_Header>()->name;
+    auto repl = headers->getReplacement(name);
+    if (repl != nullptr) {
+        LOG3("Replace " << type << " with " << repl->replacementType);
+        BUG_CHECK(repl->replacementType->is<IR::Type_Header>(), "%1% not a header", type);
+        return repl->replacementType;
+    }
+    return type;
+}
+
+const IR::Node *ReplaceFlattenedAggregates::postorder(IR::Type_Struct *type) {
+    auto canon = typeMap->getTypeType(getOriginal(), true);
+    auto repl = structs->getReplacement(canon);
+    if (repl != nullptr) return repl->replacementType;
+    return type;
+}
+
+const IR::Node *ReplaceFlattenedAggregates::postorder(IR::Member *expression) {
+    // Walk the original expression, whose subexpressions have types, up to the closest
+    // header or to the root of the path.
+    const IR::Expression *e = getOriginal<IR::Member>();
+    cstring prefix = "";
+    unsigned depth = 0;
+    while (auto mem = e->to<IR::Member>()) {
+        e = mem->expr;
+        prefix = cstring(".") + mem->member + prefix;
+        depth++;
+        auto type = typeMap->getType(e, true);
+        if (auto header = type->to<IR::Type_Header>())
+            return replaceHeaderField(expression, header, prefix, depth);
+    }
+    return replaceStructField(expression, e, prefix);
+}
+
+const IR::Node *ReplaceFlattenedAggregates::replaceHeaderField(IR::Member *expression,
+                                                               const IR::Type_Header *header,
+                                                               cstring prefix, unsigned depth) {
+    auto repl = headers->getReplacement(header->name);
+    if (repl == nullptr) return expression;
+    // The members between the header and this one are never rewritten, so the header
+    // expression, as rewritten by the struct replacement, is depth levels down.
+    const IR::Expression *root = expression;
+    for (unsigned i = 0; i < depth; i++) root = root->to<IR::Member>()->expr;
+    // At this point we know that root is an expression of the form
+    // param.field1.etc.hdr, where hdr needs to be replaced.
+    auto newFieldName = ::get(repl->fieldNameRemap, prefix);
+    const IR::Expression *result;
+    if (newFieldName.isNullOrEmpty()) {
+        auto type = typeMap->getType(getOriginal(), true);
+        // This could be, for example, a method like setValid.
+        if (!type->is<IR::Type_Struct>()) return expression;
+        if (getParent<IR::Member>() != nullptr)
+            // We only want to process the outermost Member
+            return expression;
+        if (isWrite()) {
+            ::error(ErrorType::ERR_UNSUPPORTED,
+                    "%1%: writing to a structure nested in a header is not supported", expression);
+            return expression;
+        }
+        result = repl->explode(root, prefix);
+    } else {
+        result = new IR::Member(root, newFieldName);
+    }
+    LOG3("Replacing " << expression << " with " << result);
+    return result;
+}
+
+const IR::Node *ReplaceFlattenedAggregates::replaceStructField(IR::Member *expression,
+                                                               const IR::Expression *root,
+                                                               cstring prefix) {
+    auto pe = root->to<IR::PathExpression>();
+    if (pe == nullptr) return expression;
+    // At this point we know that pe is an expression of the form
+    // param.field1.etc.fieldN, where param has a type that needs to be replaced.
+    auto decl = structs->refMap->getDeclaration(pe->path, true);
+    auto param = decl->to<IR::Parameter>();
+    if (param == nullptr) return expression;
+    auto repl = ::get(toReplace, param);
+    if (repl == nullptr) return expression;
+    auto newFieldName = ::get(repl->fieldNameRemap, prefix);
+    const IR::Expression *result;
+    if (newFieldName.isNullOrEmpty()) {
+        auto type = typeMap->getType(getOriginal(), true);
+        // This could be, for example, a method like setValid.
+        if (!type->is<IR::Type_Struct>()) return expression;
+        if (getParent<IR::Member>() != nullptr)
+            // We only want to process the outermost Member
+            return expression;
+        if (isWrite()) {
+            ::error(ErrorType::ERR_UNSUPPORTED,
+                    "%1%: writing to a structure is not supported on this target", expression);
+            return expression;
+        }
+        // Prefix is a reference to a field of the original struct whose type is actually a
+        // struct itself.  We need to replace the field with a struct initializer expression.
+        result = repl->explode(pe, prefix);
+    } else {
+        result = new IR::Member(pe, newFieldName);
+    }
+    LOG3("Replacing " << expression << " with " << result);
+    return result;
+}
+
+}  // namespace P4
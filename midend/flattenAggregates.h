@@ -0,0 +1,89 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef MIDEND_FLATTENAGGREGATES_H_
+#define MIDEND_FLATTENAGGREGATES_H_
+
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "ir/ir.h"
+#include "midend/flattenHeaders.h"
+#include "midend/flattenInterfaceStructs.h"
+
+namespace P4 {
+
+/**
+ * Applies the replacements found by FindHeaderTypesToReplace and FindTypesToReplace in a
+ * single traversal.  The result is the same as running ReplaceHeaders, retypechecking and
+ * running ReplaceStructs: structs nested in headers are flattened into the headers, and the
+ * nested structs used as type arguments of packages are flattened into their parameters.
+ *
+ * Every decision is taken on the original expressions, which are the ones the type map
+ * knows about.  A Member that reaches into a header is only rewritten by the header
+ * replacement; the part of its path up to the header has already been rewritten by the
+ * struct replacement when its inner Member was visited.
+ */
+class ReplaceFlattenedAggregates : public Transform, P4WriteContext {
+    TypeMap *typeMap;
+    FindHeaderTypesToReplace *headers;
+    NestedStructMap *structs;
+    std::map<const IR::Parameter *, StructTypeReplacement<IR::Type_Struct> *> toReplace;
+
+    void findParametersToReplace(const IR::ParameterList *parameters, const IR::Node *parent);
+    const IR::Node *replaceHeaderField(IR::Member *expression, const IR::Type_Header *header,
+                                       cstring prefix, unsigned depth);
+    const IR::Node *replaceStructField(IR::Member *expression, const IR::Expression *root,
+                                       cstring prefix);
+
+ public:
+    ReplaceFlattenedAggregates(TypeMap *typeMap, FindHeaderTypesToReplace *headers,
+                               NestedStructMap *structs)
+        : typeMap(typeMap), headers(headers), structs(structs) {
+        CHECK_NULL(typeMap);
+        CHECK_NULL(headers);
+        CHECK_NULL(structs);
+        setName("ReplaceFlattenedAggregates");
+    }
+
+    const IR::Node *preorder(IR::P4Program *program) override;
+    const IR::Node *preorder(IR::P4Parser *parser) override;
+    const IR::Node *preorder(IR::P4Control *control) override;
+    const IR::Node *postorder(IR::Member *expression) override;
+    const IR::Node *postorder(IR::Type_Header *type) override;
+    const IR::Node *postorder(IR::Type_Struct *type) override;
+};
+
+/**
+ * Does the work of FlattenHeaders followed by FlattenInterfaceStructs with a single
+ * typechecking and a single rewrite of the program, instead of two of each.
+ */
+class FlattenAggregates final : public PassManager {
+ public:
+    FlattenAggregates(ReferenceMap *refMap, TypeMap *typeMap,
+                      AnnotationSelectionPolicy *policy = nullptr) {
+        auto headers = new FindHeaderTypesToReplace(typeMap, policy);
+        auto structs = new NestedStructMap(refMap, typeMap);
+        passes.push_back(new TypeChecking(refMap, typeMap));
+        passes.push_back(headers);
+        passes.push_back(new FindTypesToReplace(structs));
+        passes.push_back(new ReplaceFlattenedAggregates(typeMap, headers, structs));
+        passes.push_back(new ClearTypeMap(typeMap));
+        setName("FlattenAggregates");
+    }
+};
+
+}  // namespace P4
+
+#endif /* MIDEND_FLATTENAGGREGATES_H_ */
@@ -0,0 +1,231 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "foldIsValid.h"
+
+#include <optional>
+
+#include "frontends/p4/coreLibrary.h"
+#include "frontends/p4/methodInstance.h"
+
+namespace P4 {
+
+/// Keeps in @p known only the facts that also hold in @p other.
+static void intersect(std::map<cstring, bool> &known, const std::map<cstring, bool> &other) {
+    for (auto it = known.begin(); it != known.end();) {
+        auto merge = ::getref(other, it->first);
+        if (merge == nullptr || *merge != it->second)
+            it = known.erase(it);
+        else
+            ++it;
+    }
+}
+
+void DoFoldIsValid::flow_merge(Visitor &a_) {
+    auto &a = dynamic_cast<DoFoldIsValid &>(a_);
+    intersect(known, a.known);
+}
+
+void DoFoldIsValid::flow_copy(ControlFlowVisitor &a_) {
+    auto &a = dynamic_cast<DoFoldIsValid &>(a_);
+    known = a.known;
+}
+
+cstring DoFoldIsValid::headerKey(const IR::Expression *expression) {
+    if (expression->type == nullptr || !expression->type->is<IR::Type_Header>()) return nullptr;
+    for (auto e = expression; !e->is<IR::PathExpression>();) {
+        if (auto member = e->to<IR::Member>()) {
+            // Setting a member of a union invalidates the others; next and last
+            // denote different elements as the stack is extracted.
+            auto type = member->expr->type;
+            if (type == nullptr || type->is<IR::Type_HeaderUnion>() || type->is<IR::Type_Stack>())
+                return nullptr;
+            e = member->expr;
+        } else if (auto index = e->to<IR::ArrayIndex>()) {
+            if (!index->right->is<IR::Constant>()) return nullptr;
+            e = index->left;
+        } else {
+            return nullptr;
+        }
+    }
+    return expression->toString();
+}
+
+void DoFoldIsValid::forget(const IR::Expression *lvalue) {
+    // Find the expression covering every location that may be written: an
+    // element of a stack with a run-time index, next or last may be any element.
+    auto prefix = lvalue;
+    for (auto e = lvalue;;) {
+        if (auto member = e->to<IR::Member>()) {
+            if (member->expr->type != nullptr && member->expr->type->is<IR::Type_Stack>())
+                prefix = member->expr;
+            e = member->expr;
+        } else if (auto index = e->to<IR::ArrayIndex>()) {
+            if (!index->right->is<IR::Constant>()) prefix = index->left;
+            e = index->left;
+        } else if (auto slice = e->to<IR::Slice>()) {
+            prefix = e = slice->e0;
+        } else {
+            break;
+        }
+    }
+    auto name = prefix->toString();
+    for (auto it = known.begin(); it != known.end();) {
+        if (it->first.startsWith(name) && strchr(".[", it->first.get(name.size()))) {
+            LOG3("Validity of " << it->first << " unknown after writing " << lvalue);
+            it = known.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void DoFoldIsValid::assume(const IR::Expression *condition, bool value) {
+    if (auto lnot = condition->to<IR::LNot>()) {
+        assume(lnot->expr, !value);
+    } else if (auto land = condition->to<IR::LAnd>()) {
+        if (!value) return;
+        assume(land->left, true);
+        assume(land->right, true);
+    } else if (auto lor = condition->to<IR::LOr>()) {
+        if (value) return;
+        assume(lor->left, false);
+        assume(lor->right, false);
+    } else if (auto mce = condition->to<IR::MethodCallExpression>()) {
+        auto member = mce->method->to<IR::Member>();
+        if (member == nullptr || member->member != IR::Type_Header::isValid) return;
+        if (auto key = headerKey(member->expr)) known[key] = value;
+    }
+}
+
+const IR::Node *DoFoldIsValid::preorder(IR::ParserState *state) {
+    known.clear();
+    return state;
+}
+
+const IR::Node *DoFoldIsValid::preorder(IR::P4Control *control) {
+    // The actions are not run where they are declared.
+    known.clear();
+    visit(control->controlLocals, "controlLocals");
+    known.clear();
+    visit(control->body, "body");
+    prune();
+    return control;
+}
+
+const IR::Node *DoFoldIsValid::preorder(IR::P4Action *action) {
+    known.clear();
+    return action;
+}
+
+const IR::Node *DoFoldIsValid::preorder(IR::Function *function) {
+    known.clear();
+    return function;
+}
+
+const IR::Node *DoFoldIsValid::preorder(IR::P4Table *table) {
+    // Folding key expressions would change the key of the table.
+    prune();
+    return table;
+}
+
+const IR::Node *DoFoldIsValid::preorder(IR::IfStatement *statement) {
+    visit(statement->condition, "condition");
+    auto before = known;
+    assume(statement->condition, true);
+    visit(statement->ifTrue, "ifTrue");
+    auto afterTrue = known;
+    known = before;
+    assume(statement->condition, false);
+    if (statement->ifFalse != nullptr) visit(statement->ifFalse, "ifFalse");
+    intersect(known, afterTrue);
+    prune();
+    return statement;
+}
+
+const IR::Node *DoFoldIsValid::postorder(IR::AssignmentStatement *statement) {
+    auto key = headerKey(statement->left);
+    std::optional<bool> valid;
+    if (key) {
+        auto right = statement->right;
+        if (right->is<IR::StructExpression>() || right->is<IR::ListExpression>()) {
+            // Assigning a list or struct expression to a header makes it valid.
+            valid = true;
+        } else if (right->is<IR::InvalidHeader>()) {
+            valid = false;
+        } else if (auto rkey = headerKey(right)) {
+            if (auto v = ::getref(known, rkey)) valid = *v;
+        }
+    }
+    forget(statement->left);
+    if (valid) known[key] = *valid;
+    return statement;
+}
+
+const IR::Node *DoFoldIsValid::postorder(IR::MethodCallExpression *expression) {
+    if (auto member = expression->method->to<IR::Member>()) {
+        auto type = member->expr->type;
+        if (type != nullptr && type->is<IR::Type_Header>()) {
+            auto key = headerKey(member->expr);
+            if (member->member == IR::Type_Header::isValid) {
+                auto valid = key ? ::getref(known, key) : nullptr;
+                if (valid == nullptr) return expression;
+                LOG2("Validity of " << key << " is known: " << *valid);
+                return new IR::BoolLiteral(expression->srcInfo, *valid);
+            }
+            if (member->member == IR::Type_Header::setValid ||
+                member->member == IR::Type_Header::setInvalid) {
+                if (key)
+                    known[key] = member->member == IR::Type_Header::setValid;
+                else
+                    forget(member->expr);
+                return expression;
+            }
+        }
+        if (type != nullptr && type->is<IR::Type_Stack>() &&
+            (member->member == IR::Type_Stack::push_front ||
+             member->member == IR::Type_Stack::pop_front)) {
+            forget(member->expr);
+            return expression;
+        }
+    }
+
+    auto mi = MethodInstance::resolve(getOriginal<IR::MethodCallExpression>(), refMap, typeMap);
+    if (mi->is<BuiltInMethod>()) return expression;
+    if (auto em = mi->to<ExternMethod>()) {
+        auto &corelib = P4CoreLibrary::instance();
+        if (em->originalExternType->name == corelib.packetIn.name &&
+            em->method->name == corelib.packetIn.extract.name) {
+            // If the extraction fails the parser is left, so the header is valid afterwards.
+            if (auto key = headerKey(expression->arguments->at(0)->expression)) {
+                known[key] = true;
+                return expression;
+            }
+        }
+    }
+    if (!mi->is<ExternMethod>() && !mi->is<ExternFunction>() && !mi->is<FunctionCall>()) {
+        // Actions and applies may change the validity of any header in scope.
+        known.clear();
+        return expression;
+    }
+    for (auto param : *mi->substitution.getParametersInArgumentOrder()) {
+        if (param->direction == IR::Direction::Out || param->direction == IR::Direction::InOut)
+            forget(mi->substitution.lookup(param)->expression);
+    }
+    return expression;
+}
+
+}  // namespace P4
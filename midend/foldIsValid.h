@@ -0,0 +1,96 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef MIDEND_FOLDISVALID_H_
+#define MIDEND_FOLDISVALID_H_
+
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "ir/ir.h"
+
+namespace P4 {
+
+/**
+ * Replaces calls to isValid() on headers whose validity is known at the call
+ * by the corresponding boolean constant.
+ *
+ * The validity of headers is tracked along the control flow of parser states,
+ * control bodies, actions and functions: it becomes known after setValid(),
+ * setInvalid(), packet extraction, the assignment of a header whose validity
+ * is known, and in the branches of an if statement testing isValid().  At join
+ * points only the facts holding on every incoming path are kept.  Calls that
+ * may change the validity of a header (actions, table and block applies, and
+ * out or inout arguments) forget what was known about it.  The analysis does
+ * not cross parser state boundaries and does not look into table keys.
+ *
+ * Headers are identified by their reference expression, e.g. `hdr.ipv4`;
+ * header union members and header stack elements accessed with a run-time
+ * index, `next` or `last` are not tracked.
+ *
+ * @pre Requires expression types be stored inline in the expression
+ * (obtained by running TypeChecking(updateProgram = true)).
+ * ConstantFolding and SimplifyControlFlow should run afterwards to remove
+ * the branches that become dead.
+ */
+class DoFoldIsValid : public ControlFlowVisitor, Transform {
+    ReferenceMap *refMap;
+    TypeMap *typeMap;
+    /// Headers whose validity is known, by reference expression.
+    std::map<cstring, bool> known;
+
+    DoFoldIsValid *clone() const override { return new DoFoldIsValid(*this); }
+    void flow_merge(Visitor &) override;
+    void flow_copy(ControlFlowVisitor &) override;
+    DoFoldIsValid(const DoFoldIsValid &) = default;
+
+    /// Returns the key of a tracked header expression, or nullptr.
+    static cstring headerKey(const IR::Expression *expression);
+    /// Forgets what is known about the headers that may be written through @p lvalue.
+    void forget(const IR::Expression *lvalue);
+    /// Records what @p condition evaluating to @p value tells about header validity.
+    void assume(const IR::Expression *condition, bool value);
+
+ public:
+    DoFoldIsValid(ReferenceMap *refMap, TypeMap *typeMap) : refMap(refMap), typeMap(typeMap) {
+        CHECK_NULL(refMap);
+        CHECK_NULL(typeMap);
+        visitDagOnce = false;
+        setName("DoFoldIsValid");
+    }
+
+    const IR::Node *preorder(IR::ParserState *state) override;
+    const IR::Node *preorder(IR::P4Control *control) override;
+    const IR::Node *preorder(IR::P4Action *action) override;
+    const IR::Node *preorder(IR::Function *function) override;
+    const IR::Node *preorder(IR::P4Table *table) override;
+    const IR::Node *preorder(IR::IfStatement *statement) override;
+    const IR::Node *postorder(IR::AssignmentStatement *statement) override;
+    const IR::Node *postorder(IR::MethodCallExpression *expression) override;
+};
+
+class FoldIsValid : public PassManager {
+ public:
+    FoldIsValid(ReferenceMap *refMap, TypeMap *typeMap, TypeChecking *typeChecking = nullptr) {
+        if (!typeChecking) typeChecking = new TypeChecking(refMap, typeMap, true);
+        passes.push_back(typeChecking);
+        passes.push_back(new DoFoldIsValid(refMap, typeMap));
+        setName("FoldIsValid");
+    }
+};
+
+}  // namespace P4
+
+#endif /* MIDEND_FOLDISVALID_H_ */
@@ -23,7 +23,7 @@ limitations under the License.
 
 /* Should this be a method on IR::Expression?  Maybe after the refMap/typeMap go away */
 
-class hasSideEffects : public Inspector {
+class hasSideEffects : public MemoizingInspector<bool> {
     P4::ReferenceMap *refMap = nullptr;
     P4::TypeMap *typeMap = nullptr;
 
@@ -58,6 +58,12 @@ class hasSideEffects : public Inspector {
     }
     bool preorder(const IR::Expression *) override { return !result; }
 
+    profile_t init_apply(const IR::Node *root) override {
+        result = false;
+        return MemoizingInspector<bool>::init_apply(root);
+    }
+    bool memoResult() const override { return result; }
+
  public:
     explicit hasSideEffects(const IR::Expression *e) { e->apply(*this); }
     hasSideEffects(P4::ReferenceMap *rm, P4::TypeMap *tm) : refMap(rm), typeMap(tm) {}
@@ -53,6 +53,66 @@ const IR::Node *HSIndexTransform::postorder(IR::ArrayIndex *curArrayIndex) {
     return curArrayIndex;
 }
 
+const IR::PathExpression *HSIndexLoader::newTemporary(cstring prefix, const IR::Type *type,
+                                                      const Util::SourceInfo &srcInfo) {
+    auto name = refMap->newName(prefix);
+    auto *decl = new IR::Declaration_Variable(name, type);
+    locals->push_back(decl);
+    typeMap->setType(decl, type);
+    return new IR::PathExpression(srcInfo, type, new IR::Path(name));
+}
+
+const IR::Node *HSIndexLoader::postorder(IR::ArrayIndex *arrayIndex) {
+    if (arrayIndex->right->is<IR::Constant>()) return arrayIndex;
+    const auto *typeStack = arrayIndex->left->type->to<IR::Type_Stack>();
+    if (typeStack == nullptr) return arrayIndex;
+    const auto *indexType = arrayIndex->right->type;
+    const IR::Expression *index = arrayIndex->right;
+    if (!index->is<IR::PathExpression>()) {
+        // Evaluate the index once.
+        const auto *variable = newTemporary("hsiVar", typeMap->getTypeType(indexType, true),
+                                            arrayIndex->srcInfo);
+        copies.push_back(new IR::AssignmentStatement(arrayIndex->srcInfo, variable, index));
+        index = variable;
+    }
+    const auto *element = newTemporary("hsElem", arrayIndex->type, arrayIndex->srcInfo);
+    IR::IfStatement *result = nullptr;
+    IR::IfStatement *last = nullptr;
+    for (size_t i = 0; i < typeStack->getSize(); i++) {
+        auto *read = new IR::ArrayIndex(arrayIndex->srcInfo, arrayIndex->type, arrayIndex->left,
+                                        new IR::Constant(indexType, i));
+        auto *copy = new IR::IfStatement(new IR::Equ(index, new IR::Constant(indexType, i)),
+                                         new IR::AssignmentStatement(element, read), nullptr);
+        if (result == nullptr)
+            result = copy;
+        else
+            last->ifFalse = copy;
+        last = copy;
+    }
+    // An out of bound read leaves the temporary undefined.
+    if (result != nullptr) copies.push_back(result);
+    return element;
+}
+
+bool HSIndexLoader::canCopy(const IR::Expression *expression) {
+    bool result = true;
+    forAllMatching<IR::MethodCallExpression>(expression, [&](const IR::MethodCallExpression *mce) {
+        const auto *member = mce->method->to<IR::Member>();
+        if (member == nullptr || member->member != IR::Type_Header::isValid) result = false;
+    });
+    return result;
+}
+
+const IR::Expression *HSIndexContretizer::loadElements(
+    const IR::Expression *expression, IR::IndexedVector<IR::StatOrDecl> &statements) {
+    if (!copyReads || locals == nullptr || !HSIndexLoader::canCopy(expression)) return nullptr;
+    HSIndexLoader loader(refMap, typeMap, locals);
+    const auto *result = expression->apply(loader)->to<IR::Expression>();
+    if (loader.copies.empty()) return nullptr;
+    statements.append(loader.copies);
+    return result;
+}
+
 IR::Node *HSIndexContretizer::eliminateArrayIndexes(HSIndexFinder &aiFinder,
                                                     IR::Statement *statement,
                                                     const IR::Expression *expr) {
@@ -123,6 +183,12 @@ IR::Node *HSIndexContretizer::eliminateArrayIndexes(HSIndexFinder &aiFinder,
 }
 
 IR::Node *HSIndexContretizer::preorder(IR::AssignmentStatement *assignmentStatement) {
+    IR::IndexedVector<IR::StatOrDecl> statements;
+    if (const auto *right = loadElements(assignmentStatement->right, statements)) {
+        assignmentStatement->right = right;
+        statements.push_back(assignmentStatement);
+        return new IR::BlockStatement(assignmentStatement->srcInfo, statements);
+    }
     HSIndexFinder aiFinder(locals, refMap, typeMap, generatedVariables);
     assignmentStatement->left->apply(aiFinder);
     if (aiFinder.arrayIndex == nullptr) {
@@ -164,7 +230,8 @@ IR::Node *HSIndexContretizer::preorder(IR::P4Control *control) {
     auto *newControl = controlKeySimplified->clone();
     IR::IndexedVector<IR::Declaration> newControlLocals;
     GeneratedVariablesMap blockGeneratedVariables;
-    HSIndexContretizer hsSimplifier(refMap, typeMap, &newControlLocals, &blockGeneratedVariables);
+    HSIndexContretizer hsSimplifier(refMap, typeMap, &newControlLocals, &blockGeneratedVariables,
+                                    copyReads);
     newControl->body = newControl->body->apply(hsSimplifier)->to<IR::BlockStatement>();
     for (const auto *declaration : controlKeySimplified->controlLocals) {
         if (declaration->is<IR::P4Action>()) {
@@ -188,7 +255,7 @@ IR::Node *HSIndexContretizer::preorder(IR::BlockStatement *blockStatement) {
     if (aiFinder.arrayIndex == nullptr) {
         return blockStatement;
     }
-    HSIndexContretizer hsSimplifier(refMap, typeMap, locals, generatedVariables);
+    HSIndexContretizer hsSimplifier(refMap, typeMap, locals, generatedVariables, copyReads);
     auto *newBlock = blockStatement->clone();
     IR::IndexedVector<IR::StatOrDecl> newComponents;
     for (auto &component : blockStatement->components) {
@@ -206,6 +273,12 @@ IR::Node *HSIndexContretizer::preorder(IR::BlockStatement *blockStatement) {
 }
 
 IR::Node *HSIndexContretizer::preorder(IR::IfStatement *ifStatement) {
+    IR::IndexedVector<IR::StatOrDecl> statements;
+    if (const auto *condition = loadElements(ifStatement->condition, statements)) {
+        ifStatement->condition = condition;
+        statements.push_back(ifStatement);
+        return new IR::BlockStatement(ifStatement->srcInfo, statements);
+    }
     HSIndexFinder aiFinder(locals, refMap, typeMap, generatedVariables);
     ifStatement->condition->apply(aiFinder);
     return eliminateArrayIndexes(aiFinder, ifStatement, nullptr);
@@ -220,6 +293,12 @@ IR::Node *HSIndexContretizer::preorder(IR::MethodCallStatement *methodCallStatem
 }
 
 IR::Node *HSIndexContretizer::preorder(IR::SwitchStatement *switchStatement) {
+    IR::IndexedVector<IR::StatOrDecl> statements;
+    if (const auto *expression = loadElements(switchStatement->expression, statements)) {
+        switchStatement->expression = expression;
+        statements.push_back(switchStatement);
+        return new IR::BlockStatement(switchStatement->srcInfo, statements);
+    }
     HSIndexFinder aiFinder(locals, refMap, typeMap, generatedVariables);
     switchStatement->expression->apply(aiFinder);
     return eliminateArrayIndexes(aiFinder, switchStatement, nullptr);
@@ -49,6 +49,35 @@ class HSIndexTransform : public Transform {
     const IR::Node *postorder(IR::ArrayIndex *curArrayIndex) override;
 };
 
+/// This class replaces the header stack elements read with non-concrete indexes by
+/// temporaries, and produces the statements copying the elements into them, so that
+/// the statement reading them is not duplicated for each element.
+/// The expression hdr.h[hdr.i.index].a is translated into hsElem0.a, preceded by
+/// if (hdr.i.index == 0) { hsElem0 = hdr.h[0]; }
+/// else if (hdr.i.index == 1) { hsElem0 = hdr.h[1]; }
+class HSIndexLoader : public Transform {
+    ReferenceMap *refMap;
+    TypeMap *typeMap;
+    IR::IndexedVector<IR::Declaration> *locals;
+
+    const IR::PathExpression *newTemporary(cstring prefix, const IR::Type *type,
+                                          const Util::SourceInfo &srcInfo);
+
+ public:
+    /// Statements to execute before the transformed expression.
+    IR::IndexedVector<IR::StatOrDecl> copies;
+
+    HSIndexLoader(ReferenceMap *refMap, TypeMap *typeMap,
+                  IR::IndexedVector<IR::Declaration> *locals)
+        : refMap(refMap), typeMap(typeMap), locals(locals) {
+        CHECK_NULL(locals);
+    }
+    const IR::Node *postorder(IR::ArrayIndex *arrayIndex) override;
+    /// True if the header stack elements of @p expression are only read, so that
+    /// they can be copied before evaluating it.
+    static bool canCopy(const IR::Expression *expression);
+};
+
 /// This class eliminates all non-concrete indexes of the header stacks in the controls.
 /// It generates new variables for all expressions in the header stacks indexes and
 /// checks their values for substitution of concrete values.
@@ -64,17 +93,27 @@ class HSIndexTransform : public Transform {
 /// hdivr0 = hdr.i;
 /// if (hdivr0 == 0) { hdr.h[0] = 1;}
 /// else if (hdivr0 == 1){hdr.h[1] = 1;}
+/// Each statement is duplicated for each element, so nested non-concrete indexes
+/// multiply the size of the code.  With copyReads the elements read by
+/// assignments, if conditions and switch expressions are first copied by
+/// HSIndexLoader, so that the code grows linearly with the sizes of the stacks.
 class HSIndexContretizer : public Transform {
     ReferenceMap *refMap;
     TypeMap *typeMap;
     IR::IndexedVector<IR::Declaration> *locals;
     GeneratedVariablesMap *generatedVariables;
+    bool copyReads;
 
  public:
     HSIndexContretizer(ReferenceMap *refMap, TypeMap *typeMap,
                        IR::IndexedVector<IR::Declaration> *locals = nullptr,
-                       GeneratedVariablesMap *generatedVariables = nullptr)
-        : refMap(refMap), typeMap(typeMap), locals(locals), generatedVariables(generatedVariables) {
+                       GeneratedVariablesMap *generatedVariables = nullptr,
+                       bool copyReads = false)
+        : refMap(refMap),
+          typeMap(typeMap),
+          locals(locals),
+          generatedVariables(generatedVariables),
+          copyReads(copyReads) {
         if (generatedVariables == nullptr) {
             generatedVariables = new GeneratedVariablesMap();
         }
@@ -90,14 +129,21 @@ class HSIndexContretizer : public Transform {
  protected:
     IR::Node *eliminateArrayIndexes(HSIndexFinder &aiFinder, IR::Statement *statement,
                                     const IR::Expression *expr);
+    /// Returns @p expression reading copies of the header stack elements with
+    /// non-concrete indexes, appending the copies to @p statements, or nullptr if
+    /// nothing is copied.
+    const IR::Expression *loadElements(const IR::Expression *expression,
+                                       IR::IndexedVector<IR::StatOrDecl> &statements);
 };
 
 class HSIndexSimplifier : public PassManager {
  public:
-    HSIndexSimplifier(ReferenceMap *refMap, TypeMap *typeMap) {
+    /// With @p copyReads the header stack elements read are copied into temporaries
+    /// instead of duplicating the statements reading them; see HSIndexContretizer.
+    HSIndexSimplifier(ReferenceMap *refMap, TypeMap *typeMap, bool copyReads = false) {
         // remove block statements
         passes.push_back(new TypeChecking(refMap, typeMap, true));
-        passes.push_back(new HSIndexContretizer(refMap, typeMap));
+        passes.push_back(new HSIndexContretizer(refMap, typeMap, nullptr, nullptr, copyReads));
         setName("HSIndexSimplifier");
     }
 };
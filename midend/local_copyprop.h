@@ -52,6 +52,9 @@ if legal to do so.
 class DoLocalCopyPropagation : public ControlFlowVisitor, Transform, P4WriteContext {
     ReferenceMap *refMap;
     TypeMap *typeMap;
+    /// Shared by all flow clones; the same initializers and conditions are
+    /// queried repeatedly as values are propagated.
+    ::hasSideEffects sideEffects;
     bool working = false;
     struct VarInfo {
         bool local = false;
@@ -91,7 +94,7 @@ class DoLocalCopyPropagation : public ControlFlowVisitor, Transform, P4WriteCont
     void forOverlapAvail(cstring, std::function<void(cstring, VarInfo *)>);
     void dropValuesUsing(cstring);
     bool hasSideEffects(const IR::Expression *e) {
-        return bool(::hasSideEffects(refMap, typeMap, e));
+        return sideEffects.memoized(e);
     }
     bool isHeaderUnionIsValid(const IR::Expression *e);
 
@@ -131,6 +134,7 @@ class DoLocalCopyPropagation : public ControlFlowVisitor, Transform, P4WriteCont
                            bool eut)
         : refMap(refMap),
           typeMap(typeMap),
+          sideEffects(refMap, typeMap),
           tables(*new std::map<cstring, TableInfo>),
           actions(*new std::map<cstring, FuncInfo>),
           methods(*new std::map<cstring, FuncInfo>),
@@ -0,0 +1,155 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "mergeParserStates.h"
+
+namespace P4 {
+
+namespace {
+
+/// True if the only annotation of @p state, if any, is @name.
+bool onlyNameAnnotation(const IR::ParserState *state) {
+    auto &annotations = state->annotations->annotations;
+    return annotations.empty() || (annotations.size() == 1 && state->getAnnotation("name"));
+}
+
+bool sameComponents(const IR::ParserState *a, const IR::ParserState *b) {
+    if (a->components.size() != b->components.size()) return false;
+    for (size_t i = 0; i < a->components.size(); i++)
+        if (!a->components.at(i)->equiv(*b->components.at(i))) return false;
+    return true;
+}
+
+bool sameTransition(const IR::ParserState *a, const IR::ParserState *b) {
+    if (a->selectExpression == nullptr || b->selectExpression == nullptr)
+        return a->selectExpression == b->selectExpression;
+    return a->selectExpression->equiv(*b->selectExpression);
+}
+
+const IR::PathExpression *retarget(const IR::PathExpression *target,
+                                   const std::map<cstring, cstring> &replace) {
+    auto it = replace.find(target->path->name.name);
+    if (it == replace.end()) return target;
+    auto path = new IR::Path(IR::ID(target->path->srcInfo, it->second));
+    return new IR::PathExpression(target->srcInfo, target->type, path);
+}
+
+/// Returns @p select with the transitions to the keys of @p replace going to
+/// the corresponding values instead.
+const IR::Expression *retarget(const IR::Expression *select,
+                               const std::map<cstring, cstring> &replace) {
+    if (select == nullptr) return nullptr;
+    if (auto target = select->to<IR::PathExpression>()) return retarget(target, replace);
+    auto expression = select->checkedTo<IR::SelectExpression>();
+    IR::Vector<IR::SelectCase> cases;
+    bool changed = false;
+    for (auto selectCase : expression->selectCases) {
+        auto state = retarget(selectCase->state, replace);
+        if (state != selectCase->state) {
+            selectCase = new IR::SelectCase(selectCase->srcInfo, selectCase->keyset, state);
+            changed = true;
+        }
+        cases.push_back(selectCase);
+    }
+    if (!changed) return select;
+    auto result = expression->clone();
+    result->selectCases = std::move(cases);
+    return result;
+}
+
+}  // namespace
+
+const IR::Node *DoMergeEquivalentParserStates::preorder(IR::P4Parser *parser) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        std::map<cstring, cstring> replace;
+        // Candidate representatives, by number of components.
+        std::map<size_t, std::vector<const IR::ParserState *>> kept;
+        for (auto state : parser->states) {
+            if (state->isBuiltin() || state->name == IR::ParserState::start) continue;
+            if (!onlyNameAnnotation(state)) continue;
+            auto &candidates = kept[state->components.size()];
+            const IR::ParserState *equivalent = nullptr;
+            for (auto candidate : candidates) {
+                if (sameComponents(candidate, state) && sameTransition(candidate, state)) {
+                    equivalent = candidate;
+                    break;
+                }
+            }
+            if (equivalent) {
+                LOG2("Merging parser state " << state->name << " into " << equivalent->name);
+                replace.emplace(state->name.name, equivalent->name.name);
+            } else {
+                candidates.push_back(state);
+            }
+        }
+        if (replace.empty()) break;
+
+        IR::IndexedVector<IR::ParserState> states;
+        for (auto state : parser->states) {
+            if (replace.count(state->name.name)) continue;
+            auto select = retarget(state->selectExpression, replace);
+            if (select != state->selectExpression) {
+                auto copy = state->clone();
+                copy->selectExpression = select;
+                state = copy;
+            }
+            states.push_back(state);
+        }
+        parser->states = std::move(states);
+        changed = true;
+    }
+    prune();
+    return parser;
+}
+
+const IR::Node *DoInlineParserStates::preorder(IR::P4Parser *parser) {
+    std::map<cstring, const IR::ParserState *> byName;
+    for (auto state : parser->states) byName.emplace(state->name.name, state);
+
+    IR::IndexedVector<IR::ParserState> states;
+    for (auto state : parser->states) {
+        const IR::ParserState *next = nullptr;
+        auto select = state->selectExpression;
+        if (auto target = select ? select->to<IR::PathExpression>() : nullptr) {
+            auto it = byName.find(target->path->name.name);
+            if (it != byName.end()) next = it->second;
+        }
+        if (next == nullptr || next == state || next->isBuiltin() ||
+            next->name == IR::ParserState::start || !next->annotations->annotations.empty() ||
+            next->components.size() > maxStatements) {
+            states.push_back(state);
+            continue;
+        }
+        bool hasDeclarations = false;
+        for (auto component : next->components) hasDeclarations |= component->is<IR::Declaration>();
+        if (hasDeclarations) {
+            states.push_back(state);
+            continue;
+        }
+        LOG2("Inlining parser state " << next->name << " into " << state->name);
+        auto copy = state->clone();
+        copy->components.append(next->components);
+        copy->selectExpression = next->selectExpression;
+        states.push_back(copy);
+    }
+    parser->states = std::move(states);
+    prune();
+    return parser;
+}
+
+}  // namespace P4
@@ -0,0 +1,85 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef MIDEND_MERGEPARSERSTATES_H_
+#define MIDEND_MERGEPARSERSTATES_H_
+
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/simplifyParsers.h"
+#include "ir/ir.h"
+
+namespace P4 {
+
+/**
+ * Merges the parser states that have the same statements and the same
+ * transitions: the transitions to the later ones go to the first.  This is
+ * repeated, since merging the successors of two states can make them equal.
+ * The start state, and states with annotations other than @name, are kept.
+ *
+ * The merged states become unreachable and are removed by SimplifyParsers.
+ */
+class DoMergeEquivalentParserStates : public Transform {
+ public:
+    DoMergeEquivalentParserStates() { setName("DoMergeEquivalentParserStates"); }
+    const IR::Node *preorder(IR::P4Parser *parser) override;
+    const IR::Node *preorder(IR::P4Control *control) override {
+        prune();
+        return control;
+    }
+};
+
+/**
+ * Copies the statements and the transition of a small state into each state
+ * whose only transition goes to it, so that fewer transitions are taken per
+ * packet.  States with annotations or declarations are not copied, and each
+ * state absorbs at most one successor per run, which bounds code growth.
+ *
+ * SimplifyParsers then removes the states no longer reachable.
+ */
+class DoInlineParserStates : public Transform {
+    /// Largest number of statements of a state being copied.
+    size_t maxStatements;
+
+ public:
+    explicit DoInlineParserStates(size_t maxStatements) : maxStatements(maxStatements) {
+        setName("DoInlineParserStates");
+    }
+    const IR::Node *preorder(IR::P4Parser *parser) override;
+    const IR::Node *preorder(IR::P4Control *control) override {
+        prune();
+        return control;
+    }
+};
+
+/**
+ * Reduces the number of states of parsers, and the number of transitions taken,
+ * after passes such as RemoveParserIfs and ParsersUnroll that create many small
+ * states.  Chains of states are collapsed by SimplifyParsers.
+ */
+class MergeParserStates : public PassManager {
+ public:
+    explicit MergeParserStates(ReferenceMap *refMap, size_t maxInlinedStatements = 4) {
+        passes.push_back(new DoMergeEquivalentParserStates());
+        if (maxInlinedStatements > 0)
+            passes.push_back(new DoInlineParserStates(maxInlinedStatements));
+        passes.push_back(new SimplifyParsers(refMap));
+        setName("MergeParserStates");
+    }
+};
+
+}  // namespace P4
+
+#endif /* MIDEND_MERGEPARSERSTATES_H_ */
@@ -1,5 +1,7 @@
 #include "parserUnroll.h"
 
+#include <unordered_set>
+
 #include "interpreter.h"
 #include "ir/ir.h"
 #include "lib/hash.h"
@@ -61,33 +63,17 @@ struct VisitedKey {
         indexes = stateInfo->statesIndexes;
     }
 
-    /// Checks of two states to be less. If @a name < @a e.name then it returns @a true.
-    /// if @a name > @a e.name then it returns false.
-    /// If @a name is equal @a e.name then it checks the values of the headers stack indexes.
-    /// For both map of header stacks' indexes it creates map of pairs of values for each
-    /// header stack index.
-    /// If some indexes are missing then it cosiders them as -1.
-    /// Next, it continues checking each pair in a intermidiate map with the same approach
-    /// as for @a name and @a e.name.
-    bool operator<(const VisitedKey &e) const {
-        if (name < e.name) return true;
-        if (name > e.name) return false;
-        std::unordered_map<StackVariable, std::pair<size_t, size_t>, StackVariableHash> mp;
-        for (auto &i1 : indexes) {
-            mp.emplace(i1.first, std::make_pair(i1.second, -1));
-        }
-        for (auto &i2 : e.indexes) {
-            auto ref = mp.find(i2.first);
-            if (ref == mp.end())
-                mp.emplace(i2.first, std::make_pair(-1, i2.second));
-            else
-                ref->second.second = i2.second;
-        }
-        for (auto j : mp) {
-            if (j.second.first < j.second.second) return true;
-            if (j.second.first > j.second.second) return false;
-        }
-        return false;
+    /// Two keys are equal when they name the same state with the same header stack indexes.
+    bool operator==(const VisitedKey &e) const { return name == e.name && indexes == e.indexes; }
+};
+
+/// Hash for @a VisitedKey, independent of the order in which the indexes are stored.
+struct VisitedKeyHash {
+    size_t operator()(const VisitedKey &key) const {
+        size_t hash = 0;
+        for (auto &i : key.indexes)
+            hash += Util::hash_combine(StackVariableHash{}(i.first), Util::Hash{}(i.second));
+        return Util::hash_combine(Util::Hash{}(key.name), hash);
     }
 };
 
@@ -132,7 +118,7 @@ namespace ParserStructureImpl {
 /// Visited map of pairs :
 /// 1) name of the parser state and values of the header stack indexes.
 /// 2) value of index which is used for generation of the new names of the parsers' states.
-using StatesVisitedMap = std::map<VisitedKey, size_t>;
+using StatesVisitedMap = std::unordered_map<VisitedKey, size_t, VisitedKeyHash>;
 
 // Makes transformation of the statements of a parser state.
 // It updates indexes of a header stack and generates correct name of the next transition.
@@ -360,6 +346,7 @@ class ParserSymbolicInterpreter {
     SymbolicValueFactory *factory;
     ParserInfo *synthesizedParser;  // output produced
     bool unroll;
+    unsigned budget;  // maximum number of states to visit, 0 if unbounded
     StatesVisitedMap visitedStates;
     bool &wasError;
 
@@ -765,12 +752,13 @@ class ParserSymbolicInterpreter {
     bool hasOutOfboundState;
     /// constructor
     ParserSymbolicInterpreter(ParserStructure *structure, ReferenceMap *refMap, TypeMap *typeMap,
-                              bool unroll, bool &wasError)
+                              bool unroll, unsigned budget, bool &wasError)
         : structure(structure),
           refMap(refMap),
           typeMap(typeMap),
           synthesizedParser(nullptr),
           unroll(unroll),
+          budget(budget),
           wasError(wasError) {
         CHECK_NULL(structure);
         CHECK_NULL(refMap);
@@ -808,12 +796,20 @@ class ParserSymbolicInterpreter {
         startInfo->scenarioStates.insert(structure->start->name.name);
         std::vector<ParserStateInfo *> toRun;  // worklist
         toRun.push_back(startInfo);
-        std::set<VisitedKey> visited;
+        std::unordered_set<VisitedKey, VisitedKeyHash> visited;
         std::unordered_set<cstring> newStates;
+        unsigned evaluated = 0;
         while (!toRun.empty()) {
             auto stateInfo = toRun.back();
             toRun.pop_back();
             LOG1("Symbolic evaluation of " << stateChain(stateInfo));
+            if (budget != 0 && ++evaluated > budget) {
+                ::warning(ErrorType::WARN_UNSUPPORTED,
+                          "%1%: parser loops not unrolled, their evaluation exceeds %2% states",
+                          parser, budget);
+                wasError = true;
+                break;
+            }
             // checking visited state, loop state, and the reachable states with needed header stack
             // operators.
             if (visited.count(VisitedKey(stateInfo)) &&
@@ -867,8 +863,10 @@ class ParserSymbolicInterpreter {
 
 }  // namespace ParserStructureImpl
 
-bool ParserStructure::analyze(ReferenceMap *refMap, TypeMap *typeMap, bool unroll, bool &wasError) {
-    ParserStructureImpl::ParserSymbolicInterpreter psi(this, refMap, typeMap, unroll, wasError);
+bool ParserStructure::analyze(ReferenceMap *refMap, TypeMap *typeMap, bool unroll,
+                              unsigned budget, bool &wasError) {
+    ParserStructureImpl::ParserSymbolicInterpreter psi(this, refMap, typeMap, unroll, budget,
+                                                       wasError);
     result = psi.run();
     return psi.hasOutOfboundState;
 }
@@ -32,6 +32,10 @@ namespace P4 {
 /// Name of out of bound state
 const char outOfBoundsStateName[] = "stateOutOfBound";
 
+/// Default bound on the number of states the symbolic evaluation of a single parser
+/// may visit before ParsersUnroll gives up and leaves the parser loops in place.
+const unsigned defaultParserUnrollBudget = 10000;
+
 //////////////////////////////////////////////
 // The following are for a single parser
 
@@ -161,7 +165,11 @@ class ParserStructure {
         callGraph->calls(caller, callee);
     }
 
-    bool analyze(ReferenceMap *refMap, TypeMap *typeMap, bool unroll, bool &wasError);
+    /// Symbolically evaluates the parser, visiting at most @p budget states (0 for no
+    /// limit).  Sets @p wasError, so that the parser is left unchanged, if the budget is
+    /// exhausted.  @returns true if an out of bounds state is needed.
+    bool analyze(ReferenceMap *refMap, TypeMap *typeMap, bool unroll, unsigned budget,
+                 bool &wasError);
     /// check reachability for usage of header stack
     bool reachableHSUsage(IR::ID id, const ParserStateInfo *state) const;
 
@@ -206,15 +214,16 @@ class ParserRewriter : public PassManager {
  public:
     bool hasOutOfboundState;
     bool wasError;
-    ParserRewriter(ReferenceMap *refMap, TypeMap *typeMap, bool unroll) {
+    ParserRewriter(ReferenceMap *refMap, TypeMap *typeMap, bool unroll,
+                   unsigned budget = defaultParserUnrollBudget) {
         CHECK_NULL(refMap);
         CHECK_NULL(typeMap);
         wasError = false;
         setName("ParserRewriter");
         addPasses({
             new AnalyzeParser(refMap, &current),
-            [this, refMap, typeMap, unroll](void) {
-                hasOutOfboundState = current.analyze(refMap, typeMap, unroll, wasError);
+            [this, refMap, typeMap, unroll, budget](void) {
+                hasOutOfboundState = current.analyze(refMap, typeMap, unroll, budget, wasError);
             },
         });
     }
@@ -227,10 +236,12 @@ class RewriteAllParsers : public Transform {
     ReferenceMap *refMap;
     TypeMap *typeMap;
     bool unroll;
+    unsigned budget;
 
  public:
-    RewriteAllParsers(ReferenceMap *refMap, TypeMap *typeMap, bool unroll)
-        : refMap(refMap), typeMap(typeMap), unroll(unroll) {
+    RewriteAllParsers(ReferenceMap *refMap, TypeMap *typeMap, bool unroll,
+                      unsigned budget = defaultParserUnrollBudget)
+        : refMap(refMap), typeMap(typeMap), unroll(unroll), budget(budget) {
         CHECK_NULL(refMap);
         CHECK_NULL(typeMap);
         setName("RewriteAllParsers");
@@ -239,7 +250,7 @@ class RewriteAllParsers : public Transform {
     // start generation of a code
     const IR::Node *postorder(IR::P4Parser *parser) override {
         // making rewriting
-        auto rewriter = new ParserRewriter(refMap, typeMap, unroll);
+        auto rewriter = new ParserRewriter(refMap, typeMap, unroll, budget);
         rewriter->setCalledBy(this);
         parser->apply(*rewriter);
         if (rewriter->wasError) {
@@ -295,13 +306,16 @@ class RewriteAllParsers : public Transform {
     }
 };
 
+/// Unrolls the loops of parsers over header stacks.  A parser whose symbolic evaluation
+/// visits more than @p budget states (0 for no limit) is left as it is, with a warning.
 class ParsersUnroll : public PassManager {
  public:
-    ParsersUnroll(bool unroll, ReferenceMap *refMap, TypeMap *typeMap) {
+    ParsersUnroll(bool unroll, ReferenceMap *refMap, TypeMap *typeMap,
+                  unsigned budget = defaultParserUnrollBudget) {
         // remove block statements
         passes.push_back(new SimplifyControlFlow(refMap, typeMap));
         passes.push_back(new TypeChecking(refMap, typeMap));
-        passes.push_back(new RewriteAllParsers(refMap, typeMap, unroll));
+        passes.push_back(new RewriteAllParsers(refMap, typeMap, unroll, budget));
         setName("ParsersUnroll");
     }
 };
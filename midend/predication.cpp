@@ -15,6 +15,8 @@ limitations under the License.
 */
 #include "predication.h"
 
+#include <algorithm>
+
 #include "frontends/p4/cloner.h"
 namespace P4 {
 
@@ -280,10 +282,57 @@ const IR::Node *Predication::preorder(IR::ArrayIndex *arrInd) {
     return arrInd;
 }
 
+unsigned PredicationCostModel::cost(const IR::Expression *expression) const {
+    unsigned operations = 0;
+    forAllMatching<IR::Operation>(expression, [&](const IR::Operation *op) {
+        if (!op->is<IR::Member>()) operations++;
+    });
+    return operations * operationCost;
+}
+
+unsigned PredicationCostModel::branchingCost(const IR::Statement *statement) const {
+    if (auto block = statement->to<IR::BlockStatement>()) {
+        unsigned result = 0;
+        for (auto c : block->components)
+            if (auto s = c->to<IR::Statement>()) result += branchingCost(s);
+        return result;
+    }
+    if (auto ifs = statement->to<IR::IfStatement>()) {
+        unsigned result = branchingCost(ifs->ifTrue);
+        if (ifs->ifFalse) result = std::max(result, branchingCost(ifs->ifFalse));
+        return cost(ifs->condition) + branchCost + result;
+    }
+    if (auto assign = statement->to<IR::AssignmentStatement>())
+        return assignmentCost + cost(assign->right);
+    return 0;
+}
+
+unsigned PredicationCostModel::predicatedCost(const IR::Statement *statement) const {
+    if (auto block = statement->to<IR::BlockStatement>()) {
+        unsigned result = 0;
+        for (auto c : block->components)
+            if (auto s = c->to<IR::Statement>()) result += predicatedCost(s);
+        return result;
+    }
+    if (auto ifs = statement->to<IR::IfStatement>()) {
+        unsigned result = cost(ifs->condition) + predicatedCost(ifs->ifTrue);
+        if (ifs->ifFalse) result += predicatedCost(ifs->ifFalse);
+        return result;
+    }
+    if (auto assign = statement->to<IR::AssignmentStatement>())
+        return assignmentCost + cost(assign->right) + muxCost;
+    return 0;
+}
+
 const IR::Node *Predication::preorder(IR::IfStatement *statement) {
     if (findContext<IR::P4Action>() == nullptr) {
         return statement;
     }
+    if (costModel && ifNestingLevel == 0 && !costModel->shouldPredicate(statement)) {
+        LOG1("Not predicating " << dbp(statement) << ": branching is cheaper");
+        prune();
+        return statement;
+    }
     ++ifNestingLevel;
     LOG1("Preorder of IfStatement, level: " << ifNestingLevel);
     LOG2(*statement);
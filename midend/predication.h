@@ -22,11 +22,35 @@ limitations under the License.
 
 namespace P4 {
 
+/// Per-target costs used by Predication to decide whether an 'if' statement
+/// in an action is cheaper with or without branches.  Costs are in arbitrary
+/// units, e.g. instructions.
+struct PredicationCostModel {
+    unsigned operationCost = 1;   ///< Evaluating one operator.
+    unsigned assignmentCost = 1;  ///< One assignment.
+    unsigned muxCost = 1;         ///< The '?:' predication adds to each assignment.
+    unsigned branchCost = 4;      ///< One conditional branch.
+
+    /// Cost of evaluating @p expression.
+    unsigned cost(const IR::Expression *expression) const;
+    /// Cost of the longest path through @p statement when executed with branches.
+    unsigned branchingCost(const IR::Statement *statement) const;
+    /// Cost of @p statement when all its branches are predicated.
+    unsigned predicatedCost(const IR::Statement *statement) const;
+    /// True if predicating @p statement is not more expensive than branching.
+    bool shouldPredicate(const IR::IfStatement *statement) const {
+        return predicatedCost(statement) <= branchingCost(statement);
+    }
+};
+
 /**
 This pass operates on action bodies.  It converts 'if' statements to
 '?:' expressions, if possible.  Otherwise this pass will signal an
 error.  This pass should be used only on architectures that do not
-support conditionals in actions.
+support conditionals in actions, unless a cost model is supplied: then
+the target is assumed to support conditionals, and an 'if' statement is
+only converted when PredicationCostModel::shouldPredicate says the
+predicated form is not more expensive.
 For this to work all statements must be assignments or other ifs.
 if (e)
    a = f(b);
@@ -82,6 +106,8 @@ class Predication final : public Transform {
 
     // Used to dynamically generate names for variables in parts of code
     NameGenerator *generator;
+    // If not null, only if statements that are cheaper predicated are converted
+    const PredicationCostModel *costModel;
     // Used to remove empty statements and empty block statements that appear in the code
     EmptyStatementRemover remover;
     bool inside_action;
@@ -121,8 +147,12 @@ class Predication final : public Transform {
     }
 
  public:
-    explicit Predication(NameGenerator *gen)
-        : generator(gen), inside_action(false), ifNestingLevel(0), depNestingLevel(0) {
+    explicit Predication(NameGenerator *gen, const PredicationCostModel *costModel = nullptr)
+        : generator(gen),
+          costModel(costModel),
+          inside_action(false),
+          ifNestingLevel(0),
+          depNestingLevel(0) {
         setName("Predication");
     }
     const IR::Expression *clone(const IR::Expression *expression);
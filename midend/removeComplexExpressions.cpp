@@ -44,13 +44,30 @@ class ComplexExpression : public Inspector {
 
 }  // namespace
 
-const IR::PathExpression *RemoveComplexExpressions::createTemporary(
-    const IR::Expression *expression) {
-    auto type = typeMap->getType(expression, true);
+cstring RemoveComplexExpressions::temporaryName(const IR::Type *type) {
+    bool shared = reuseTemporaries && findContext<IR::P4Action>() == nullptr;
+    cstring key = type->toString();
+    size_t index = 0;
+    if (shared) {
+        index = temporariesInUse[key]++;
+        auto &pool = temporaries[key];
+        if (index < pool.size()) {
+            LOG3("Reusing temporary " << pool[index]);
+            return pool[index];
+        }
+    }
     auto name = refMap->newName("tmp");
     auto decl = new IR::Declaration_Variable(IR::ID(name), type->getP4Type());
     newDecls.push_back(decl);
     typeMap->setType(decl, type);
+    if (shared) temporaries[key].push_back(name);
+    return name;
+}
+
+const IR::PathExpression *RemoveComplexExpressions::createTemporary(
+    const IR::Expression *expression) {
+    auto type = typeMap->getType(expression, true);
+    auto name = temporaryName(type);
     auto assign =
         new IR::AssignmentStatement(expression->srcInfo, new IR::PathExpression(name), expression);
     assignments.push_back(assign);
@@ -145,6 +162,7 @@ const IR::Node *RemoveComplexExpressions::preorder(IR::P4Control *control) {
         return control;
     }
     newDecls.clear();
+    temporaries.clear();
     return control;
 }
 
@@ -163,6 +181,7 @@ const IR::Node *RemoveComplexExpressions::simpleStatement(IR::Statement *stateme
     auto block = new IR::BlockStatement(assignments);
     block->push_back(statement);
     assignments.clear();
+    temporariesInUse.clear();
     return block;
 }
 
@@ -41,18 +41,33 @@ class RemoveComplexExpressionsPolicy {
 Lift complex expressions from a select or as arguments to external functions
 into temporaries.
 Convert a statement like lookahead<T>() into tmp = lookahead<T>();
+
+The temporaries are only read by the statement they are assigned for, so
+with reuseTemporaries the statements of a parser or of a control apply
+block share the temporaries of each type, which keeps the number of
+variables down.  Temporaries in actions are never shared, since actions
+run in the middle of the statements which apply tables.
 */
 class RemoveComplexExpressions : public Transform {
+    /// Temporaries which can be shared, by type.
+    std::map<cstring, std::vector<cstring>> temporaries;
+    /// Number of the temporaries of each type used by the pending assignments.
+    std::map<cstring, size_t> temporariesInUse;
+
+    cstring temporaryName(const IR::Type *type);
+
  public:
     P4::ReferenceMap *refMap;
     P4::TypeMap *typeMap;
     RemoveComplexExpressionsPolicy *policy;
+    bool reuseTemporaries;
     IR::IndexedVector<IR::Declaration> newDecls;
     IR::IndexedVector<IR::StatOrDecl> assignments;
 
     RemoveComplexExpressions(P4::ReferenceMap *refMap, P4::TypeMap *typeMap,
-                             RemoveComplexExpressionsPolicy *policy = nullptr)
-        : refMap(refMap), typeMap(typeMap), policy(policy) {
+                             RemoveComplexExpressionsPolicy *policy = nullptr,
+                             bool reuseTemporaries = false)
+        : refMap(refMap), typeMap(typeMap), policy(policy), reuseTemporaries(reuseTemporaries) {
         CHECK_NULL(refMap);
         CHECK_NULL(typeMap);
         setName("RemoveComplexExpressions");
@@ -71,15 +86,19 @@ class RemoveComplexExpressions : public Transform {
     const IR::Node *postorder(IR::SelectExpression *expression) override;
     const IR::Node *preorder(IR::ParserState *state) override {
         assignments.clear();
+        temporariesInUse.clear();
         return state;
     }
     const IR::Node *postorder(IR::ParserState *state) override {
         state->components.append(assignments);
+        assignments.clear();
+        temporariesInUse.clear();
         return state;
     }
     const IR::Node *postorder(IR::MethodCallExpression *expression) override;
     const IR::Node *preorder(IR::P4Parser *parser) override {
         newDecls.clear();
+        temporaries.clear();
         return parser;
     }
     const IR::Node *postorder(IR::P4Parser *parser) override {
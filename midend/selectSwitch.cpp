@@ -0,0 +1,76 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "selectSwitch.h"
+
+#include <set>
+
+#include "lib/big_int_util.h"
+
+namespace P4 {
+
+const cstring AnnotateSelectSwitch::annotation = "select_switch";
+
+/// Returns the mask of a Mask label, or nullptr if it is not a constant.
+static const IR::Constant *maskOf(const IR::Expression *keyset) {
+    auto mask = keyset->to<IR::Mask>();
+    if (mask == nullptr || !mask->left->is<IR::Constant>()) return nullptr;
+    return mask->right->to<IR::Constant>();
+}
+
+const IR::Constant *AnnotateSelectSwitch::exactValue(const IR::Expression *keyset) {
+    if (auto constant = keyset->to<IR::Constant>()) return constant;
+    if (auto mask = maskOf(keyset)) {
+        auto type = mask->type->to<IR::Type_Bits>();
+        if (type != nullptr && mask->value == Util::mask(type->width_bits()))
+            return keyset->to<IR::Mask>()->left->to<IR::Constant>();
+    }
+    return nullptr;
+}
+
+bool AnnotateSelectSwitch::isDefault(const IR::Expression *keyset) {
+    if (keyset->is<IR::DefaultExpression>()) return true;
+    auto mask = maskOf(keyset);
+    return mask != nullptr && mask->value == 0;
+}
+
+const IR::Node *AnnotateSelectSwitch::postorder(IR::ParserState *state) {
+    auto select = state->selectExpression->to<IR::SelectExpression>();
+    if (select == nullptr || select->select->components.size() != 1) return state;
+    std::set<big_int> values;
+    size_t index = 0;
+    for (auto c : select->selectCases) {
+        index++;
+        if (isDefault(c->keyset)) {
+            // Any following label is unreachable; leave it to the general lowering.
+            if (index != select->selectCases.size()) return state;
+            continue;
+        }
+        auto value = exactValue(c->keyset);
+        if (value == nullptr) return state;
+        auto type = value->type->to<IR::Type_Bits>();
+        if (type == nullptr || type->isSigned || type->width_bits() > 64) return state;
+        // A switch cannot have the same label twice.
+        if (!values.emplace(value->value).second) return state;
+    }
+    if (values.size() < minCases) return state;
+    LOG2("Select of " << state->name << " with " << values.size() << " labels is a switch");
+    auto annot = new IR::Annotation(annotation, IR::Vector<IR::Expression>());
+    state->annotations = state->annotations->add(annot);
+    return state;
+}
+
+}  // namespace P4
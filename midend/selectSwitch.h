@@ -0,0 +1,64 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef MIDEND_SELECTSWITCH_H_
+#define MIDEND_SELECTSWITCH_H_
+
+#include "ir/ir.h"
+
+namespace P4 {
+
+/**
+ * Marks with the @select_switch annotation the parser states whose select
+ * expression can be lowered to a switch statement.  Such a select has a
+ * single unsigned argument of at most 64 bits, and its labels are distinct
+ * exact values, optionally followed by a default label.
+ *
+ * Back ends generating C emit a switch statement for annotated states
+ * instead of a chain of comparisons; the C compiler then lowers it to a
+ * jump table if the values are dense and to a balanced decision tree
+ * otherwise.  Only selects with at least @minCases exact labels are
+ * annotated, since short chains are cheaper as they are.
+ *
+ * @pre Should run after SingleArgumentSelect.  An exact label is a
+ * constant, or a mask with all bits set; a default label is a default
+ * expression or a mask with no bits set.
+ */
+class AnnotateSelectSwitch : public Transform {
+    unsigned minCases;
+
+ public:
+    static const cstring annotation;
+
+    explicit AnnotateSelectSwitch(unsigned minCases = 4) : minCases(minCases) {
+        setName("AnnotateSelectSwitch");
+    }
+
+    /// Returns the constant matched by an exact select label, or nullptr.
+    static const IR::Constant *exactValue(const IR::Expression *keyset);
+    /// Returns true if the select label matches all values.
+    static bool isDefault(const IR::Expression *keyset);
+    /// Returns true if the select expression of @state can be emitted as a switch.
+    static bool isSwitch(const IR::ParserState *state) {
+        return state->getAnnotation(annotation) != nullptr;
+    }
+
+    const IR::Node *postorder(IR::ParserState *state) override;
+};
+
+}  // namespace P4
+
+#endif /* MIDEND_SELECTSWITCH_H_ */
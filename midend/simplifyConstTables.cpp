@@ -0,0 +1,186 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "simplifyConstTables.h"
+
+#include "frontends/p4/coreLibrary.h"
+#include "frontends/p4/methodInstance.h"
+#include "frontends/p4/tableApply.h"
+
+namespace P4 {
+
+namespace {
+
+/// @returns the name of the action invoked by an entry, default action or action list element.
+cstring actionName(const IR::Expression *expression) {
+    if (auto mce = expression->to<IR::MethodCallExpression>()) expression = mce->method;
+    if (auto path = expression->to<IR::PathExpression>()) return path->path->name.name;
+    return cstring();
+}
+
+}  // namespace
+
+const IR::Node *DoSimplifyConstTables::preorder(IR::P4Control *control) {
+    for (auto decl : control->controlLocals) {
+        auto table = decl->to<IR::P4Table>();
+        if (table == nullptr) continue;
+        auto entries = table->properties->getProperty(IR::TableProperties::entriesPropertyName);
+        auto defaultAction =
+            table->properties->getProperty(IR::TableProperties::defaultActionPropertyName);
+        if (entries == nullptr || !entries->isConstant || defaultAction == nullptr ||
+            !defaultAction->isConstant)
+            continue;
+
+        std::set<cstring> actions;
+        bool known = true;
+        auto addAction = [&](const IR::Expression *expression) {
+            auto name = actionName(expression);
+            if (name.isNullOrEmpty())
+                known = false;
+            else
+                actions.emplace(name);
+        };
+        for (auto entry : table->getEntries()->entries) addAction(entry->getAction());
+        addAction(table->getDefaultAction());
+        if (!known) continue;
+        LOG2(table->name << " can only invoke " << actions.size() << " actions");
+        reachable.emplace(table, std::move(actions));
+    }
+    return control;
+}
+
+const IR::Node *DoSimplifyConstTables::postorder(IR::P4Table *table) {
+    auto it = reachable.find(getOriginal<IR::P4Table>());
+    if (it == reachable.end()) return table;
+    auto actionList = table->getActionList();
+    if (actionList == nullptr) return table;
+
+    IR::IndexedVector<IR::ActionListElement> actions;
+    for (auto ale : actionList->actionList) {
+        if (it->second.count(ale->getName().name))
+            actions.push_back(ale);
+        else
+            LOG3("Removing unreachable action " << ale << " from " << table->name);
+    }
+    if (actions.size() == actionList->size()) return table;
+
+    IR::IndexedVector<IR::Property> properties;
+    for (auto prop : table->properties->properties) {
+        if (prop->name == IR::TableProperties::actionsPropertyName) {
+            auto clone = prop->clone();
+            clone->value = new IR::ActionList(actionList->srcInfo, std::move(actions));
+            prop = clone;
+        }
+        properties.push_back(prop);
+    }
+    table->properties = new IR::TableProperties(table->properties->srcInfo, std::move(properties));
+    return table;
+}
+
+const IR::Node *DoSimplifyConstTables::postorder(IR::SwitchStatement *statement) {
+    auto orig = getOriginal<IR::SwitchStatement>();
+    auto table = TableApplySolver::isActionRun(orig->expression, refMap, typeMap);
+    if (table == nullptr) return statement;
+    auto it = reachable.find(table);
+    if (it == reachable.end()) return statement;
+
+    IR::Vector<IR::SwitchCase> cases;
+    for (auto sc : statement->cases) {
+        auto name = actionName(sc->label);
+        if (sc->label->is<IR::DefaultExpression>() || name.isNullOrEmpty() ||
+            it->second.count(name)) {
+            cases.push_back(sc);
+            continue;
+        }
+        LOG3("Removing unreachable case " << sc->label << " of " << table->name);
+        // A preceding label may fall through to the body of the removed case.
+        if (sc->statement != nullptr && !cases.empty() && cases.back()->statement == nullptr) {
+            auto last = cases.back()->clone();
+            last->statement = sc->statement;
+            cases.back() = last;
+        }
+    }
+    if (cases.size() == statement->cases.size()) return statement;
+    // Trailing labels without a body have nothing left to fall through to.
+    while (!cases.empty() && cases.back()->statement == nullptr &&
+           !cases.back()->label->is<IR::DefaultExpression>())
+        cases.pop_back();
+    statement->cases = std::move(cases);
+    return statement;
+}
+
+const IR::Statement *DoSimplifyConstTables::inlineTable(const IR::P4Table *table,
+                                                        const Util::SourceInfo &srcInfo) {
+    static const std::set<cstring> supported = {
+        IR::TableProperties::keyPropertyName, IR::TableProperties::actionsPropertyName,
+        IR::TableProperties::entriesPropertyName, IR::TableProperties::defaultActionPropertyName,
+        IR::TableProperties::sizePropertyName};
+    for (auto prop : table->properties->properties)
+        if (!supported.count(prop->name.name)) return nullptr;
+
+    auto entries = table->getEntries();
+    auto key = table->getKey();
+    if (entries->size() == 0 || entries->size() > maxEntries || key == nullptr) return nullptr;
+    for (auto ale : table->getActionList()->actionList) {
+        if (auto mce = ale->expression->to<IR::MethodCallExpression>())
+            if (!mce->arguments->empty()) return nullptr;
+    }
+    for (auto ke : key->keyElements)
+        if (ke->matchType->path->name != P4CoreLibrary::instance().exactMatch.name)
+            return nullptr;
+
+    auto call = [&](const IR::Expression *action) -> const IR::Statement * {
+        auto mce = action->to<IR::MethodCallExpression>();
+        if (mce == nullptr) mce = new IR::MethodCallExpression(action);
+        IR::IndexedVector<IR::StatOrDecl> body;
+        body.push_back(new IR::MethodCallStatement(srcInfo, mce));
+        return new IR::BlockStatement(srcInfo, std::move(body));
+    };
+    // Built from the last entry backwards, so that the first matching entry wins.
+    auto result = call(table->getDefaultAction());
+    for (auto it = entries->entries.rbegin(); it != entries->entries.rend(); ++it) {
+        auto entry = *it;
+        auto values = entry->getKeys()->components;
+        if (values.size() != key->keyElements.size()) return nullptr;
+        const IR::Expression *condition = nullptr;
+        for (size_t i = 0; i < values.size(); i++) {
+            auto value = values.at(i);
+            if (value->is<IR::DefaultExpression>()) continue;
+            if (!value->is<IR::Literal>()) return nullptr;
+            auto ke = key->keyElements.at(i);
+            const IR::Expression *match = new IR::Equ(value->srcInfo, ke->expression, value);
+            condition = condition ? new IR::LAnd(condition, match) : match;
+        }
+        auto hit = call(entry->getAction());
+        result = condition ? new IR::IfStatement(srcInfo, condition, hit, result) : hit;
+    }
+    return result;
+}
+
+const IR::Node *DoSimplifyConstTables::postorder(IR::MethodCallStatement *statement) {
+    auto mi = MethodInstance::resolve(getOriginal<IR::MethodCallStatement>(), refMap, typeMap);
+    auto am = mi->to<ApplyMethod>();
+    if (am == nullptr || !am->isTableApply()) return statement;
+    auto table = am->object->to<IR::P4Table>();
+    if (reachable.find(table) == reachable.end()) return statement;
+    if (auto result = inlineTable(table, statement->srcInfo)) {
+        LOG2("Replacing " << dbp(statement) << " with a conditional");
+        return result;
+    }
+    return statement;
+}
+
+}  // namespace P4
@@ -0,0 +1,85 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef MIDEND_SIMPLIFYCONSTTABLES_H_
+#define MIDEND_SIMPLIFYCONSTTABLES_H_
+
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "frontends/p4/typeMap.h"
+#include "ir/ir.h"
+
+namespace P4 {
+
+/**
+ * Simplifies tables whose contents the control plane cannot change: tables
+ * with 'const entries' and a 'const default_action'.
+ *
+ * - Actions that neither an entry nor the default action invokes are removed
+ *   from the table's action list, together with the cases that handle them in
+ *   'switch (t.apply().action_run)' statements.
+ *
+ * - A statement 't.apply();' of such a table with at most @maxEntries entries
+ *   (1 by default), exact match keys and no other properties (e.g. no direct
+ *   counters) is replaced by a chain of conditionals tried in entry order
+ *
+ *     if (key1 == value1_1 && ...) { entry1_action(args); }
+ *     else if (key1 == value2_1 && ...) { entry2_action(args); }
+ *     else { default_action(args); }
+ *
+ *   Other applications of the table are left unchanged.
+ *
+ * @pre The actions in the action lists take no arguments from the list itself.
+ * Tables with action list arguments are not converted into conditionals.
+ */
+class DoSimplifyConstTables : public Transform {
+    ReferenceMap *refMap;
+    TypeMap *typeMap;
+    /// For each constant table (original node), the names of the actions it can invoke.
+    std::map<const IR::P4Table *, std::set<cstring>> reachable;
+    /// Tables with more entries are not replaced by conditionals.
+    size_t maxEntries;
+
+    const IR::Statement *inlineTable(const IR::P4Table *table, const Util::SourceInfo &srcInfo);
+
+ public:
+    DoSimplifyConstTables(ReferenceMap *refMap, TypeMap *typeMap, size_t maxEntries = 1)
+        : refMap(refMap), typeMap(typeMap), maxEntries(maxEntries) {
+        CHECK_NULL(refMap);
+        CHECK_NULL(typeMap);
+        setName("DoSimplifyConstTables");
+    }
+    const IR::Node *preorder(IR::P4Control *control) override;
+    const IR::Node *postorder(IR::P4Table *table) override;
+    const IR::Node *postorder(IR::SwitchStatement *statement) override;
+    const IR::Node *postorder(IR::MethodCallStatement *statement) override;
+};
+
+class SimplifyConstTables : public PassManager {
+ public:
+    SimplifyConstTables(ReferenceMap *refMap, TypeMap *typeMap, size_t maxEntries = 1,
+                        TypeChecking *typeChecking = nullptr) {
+        if (!typeChecking) typeChecking = new TypeChecking(refMap, typeMap);
+        passes.push_back(typeChecking);
+        passes.push_back(new DoSimplifyConstTables(refMap, typeMap, maxEntries));
+        passes.push_back(new ClearTypeMap(typeMap));
+        setName("SimplifyConstTables");
+    }
+};
+
+}  // namespace P4
+
+#endif /* MIDEND_SIMPLIFYCONSTTABLES_H_ */
@@ -0,0 +1,190 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "specializeConstActions.h"
+
+#include <algorithm>
+
+namespace P4 {
+
+namespace {
+
+/// Replaces the parameters of an action by constant arguments.
+class SubstituteParameters : public Transform {
+    const ReferenceMap *refMap;
+    const std::map<const IR::IDeclaration *, const IR::Expression *> &values;
+
+ public:
+    SubstituteParameters(const ReferenceMap *refMap,
+                         const std::map<const IR::IDeclaration *, const IR::Expression *> &values)
+        : refMap(refMap), values(values) {
+        setName("SubstituteParameters");
+    }
+    const IR::Node *postorder(IR::PathExpression *expression) override {
+        auto decl = refMap->getDeclaration(getOriginal<IR::PathExpression>()->path);
+        auto it = values.find(decl);
+        if (it == values.end()) return expression;
+        return it->second;
+    }
+};
+
+}  // namespace
+
+const IR::P4Action *DoSpecializeConstActions::invokedAction(
+    const IR::Expression *expression) const {
+    if (auto mce = expression->to<IR::MethodCallExpression>()) expression = mce->method;
+    auto path = expression->to<IR::PathExpression>();
+    if (path == nullptr) return nullptr;
+    auto decl = refMap->getDeclaration(path->path);
+    return decl ? decl->to<IR::P4Action>() : nullptr;
+}
+
+bool DoSpecializeConstActions::sameArguments(const IR::Vector<IR::Argument> *left,
+                                             const IR::Vector<IR::Argument> *right) {
+    if (left->size() != right->size()) return false;
+    for (size_t i = 0; i < left->size(); i++)
+        if (!left->at(i)->expression->equiv(*right->at(i)->expression)) return false;
+    return true;
+}
+
+const IR::P4Action *DoSpecializeConstActions::specialize(
+    const IR::P4Action *action, const IR::Vector<IR::Argument> *arguments, size_t index) {
+    std::map<const IR::IDeclaration *, const IR::Expression *> values;
+    auto params = action->parameters->parameters;
+    for (size_t i = 0; i < params.size(); i++)
+        values.emplace(params.at(i), arguments->at(i)->expression);
+    SubstituteParameters substitute(refMap, values);
+    substitute.setCalledBy(this);
+    auto body = action->body->apply(substitute)->to<IR::BlockStatement>();
+
+    auto name = refMap->newName(action->name.name);
+    auto externalName = action->externalName() + "_" + cstring(std::to_string(index));
+    auto annotations = action->annotations->addOrReplace(IR::Annotation::nameAnnotation,
+                                                         new IR::StringLiteral(externalName));
+    LOG2("Specializing " << action->name << arguments << " as " << name);
+    return new IR::P4Action(action->srcInfo, name, annotations, new IR::ParameterList(), body);
+}
+
+const IR::Node *DoSpecializeConstActions::preorder(IR::P4Control *control) {
+    variants.clear();
+    std::map<const IR::P4Action *, std::vector<const IR::Vector<IR::Argument> *>> argumentSets;
+    std::set<const IR::P4Action *> excluded;
+    for (auto decl : control->controlLocals) {
+        auto table = decl->to<IR::P4Table>();
+        if (table == nullptr) continue;
+        auto entries = table->properties->getProperty(IR::TableProperties::entriesPropertyName);
+        if (entries == nullptr || !entries->isConstant) continue;
+        for (auto entry : table->getEntries()->entries) {
+            auto action = invokedAction(entry->getAction());
+            if (action == nullptr) continue;
+            auto mce = entry->getAction()->to<IR::MethodCallExpression>();
+            auto ale = table->getActionList()->getDeclaration(action->name.name);
+            bool specializable =
+                mce != nullptr && !mce->arguments->empty() && ale != nullptr &&
+                !ale->expression->is<IR::MethodCallExpression>() &&
+                mce->arguments->size() == action->parameters->size() &&
+                std::all_of(mce->arguments->begin(), mce->arguments->end(),
+                            [](const IR::Argument *arg) {
+                                return arg->expression->is<IR::Literal>();
+                            });
+            if (!specializable) {
+                excluded.emplace(action);
+                continue;
+            }
+            auto &sets = argumentSets[action];
+            if (std::none_of(sets.begin(), sets.end(), [&](const IR::Vector<IR::Argument> *s) {
+                    return sameArguments(s, mce->arguments);
+                }))
+                sets.push_back(mce->arguments);
+        }
+    }
+
+    IR::IndexedVector<IR::Declaration> locals;
+    for (auto decl : control->controlLocals) {
+        locals.push_back(decl);
+        auto action = decl->to<IR::P4Action>();
+        if (action == nullptr || excluded.count(action)) continue;
+        auto it = argumentSets.find(action);
+        if (it == argumentSets.end()) continue;
+        if (it->second.size() > maxVariants) {
+            LOG2("Not specializing " << action->name << ": " << it->second.size()
+                                     << " argument lists");
+            continue;
+        }
+        auto &actionVariants = variants[action];
+        for (auto arguments : it->second) {
+            auto variant = specialize(action, arguments, actionVariants.size());
+            actionVariants.push_back({arguments, variant});
+            locals.push_back(variant);
+        }
+    }
+    if (!variants.empty()) control->controlLocals = std::move(locals);
+    return control;
+}
+
+const IR::Node *DoSpecializeConstActions::postorder(IR::P4Table *table) {
+    if (variants.empty()) return table;
+    auto entries = table->properties->getProperty(IR::TableProperties::entriesPropertyName);
+    if (entries == nullptr || !entries->isConstant) return table;
+
+    IR::Vector<IR::Entry> newEntries;
+    std::vector<const IR::P4Action *> used;
+    for (auto entry : table->getEntries()->entries) {
+        auto it = variants.find(invokedAction(entry->getAction()));
+        if (it != variants.end()) {
+            auto arguments = entry->getAction()->to<IR::MethodCallExpression>()->arguments;
+            for (const auto &variant : it->second) {
+                if (!sameArguments(variant.arguments, arguments)) continue;
+                auto clone = entry->clone();
+                clone->action = new IR::MethodCallExpression(
+                    entry->action->srcInfo, new IR::PathExpression(variant.action->name));
+                entry = clone;
+                if (std::find(used.begin(), used.end(), variant.action) == used.end())
+                    used.push_back(variant.action);
+                break;
+            }
+        }
+        newEntries.push_back(entry);
+    }
+    if (used.empty()) return table;
+
+    auto actionList = table->getActionList()->clone();
+    for (auto action : used)
+        actionList->push_back(
+            new IR::ActionListElement(new IR::PathExpression(action->name)));
+    IR::IndexedVector<IR::Property> properties;
+    for (auto prop : table->properties->properties) {
+        if (prop->name == IR::TableProperties::actionsPropertyName) {
+            auto clone = prop->clone();
+            clone->value = actionList;
+            prop = clone;
+        } else if (prop->name == IR::TableProperties::entriesPropertyName) {
+            auto clone = prop->clone();
+            clone->value = new IR::EntriesList(entries->value->srcInfo, std::move(newEntries));
+            prop = clone;
+        }
+        properties.push_back(prop);
+    }
+    table->properties = new IR::TableProperties(table->properties->srcInfo, std::move(properties));
+    return table;
+}
+
+const IR::Node *DoSpecializeConstActions::postorder(IR::P4Control *control) {
+    variants.clear();
+    return control;
+}
+
+}  // namespace P4
@@ -0,0 +1,100 @@
+/*
+Copyright 2013-present Barefoot Networks, Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef MIDEND_SPECIALIZECONSTACTIONS_H_
+#define MIDEND_SPECIALIZECONSTACTIONS_H_
+
+#include "frontends/common/constantFolding.h"
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "frontends/p4/typeMap.h"
+#include "ir/ir.h"
+
+namespace P4 {
+
+/**
+ * Specializes the actions invoked by 'const entries' for the constant
+ * arguments the entries supply.  For each distinct list of arguments an
+ * action receives from the constant entries of the tables in a control, a
+ * copy of the action without parameters is created, with the arguments
+ * substituted into its body, and the entries invoke the copy instead:
+ *
+ *   action set(bit<9> port) { sm.egress_spec = port; }
+ *   table t {
+ *       actions = { set; }
+ *       const entries = { 1 : set(2); 3 : set(2); }
+ *   }
+ *
+ * becomes
+ *
+ *   action set(bit<9> port) { sm.egress_spec = port; }
+ *   @name("ingress.set_0") action set_0() { sm.egress_spec = 9w2; }
+ *   table t {
+ *       actions = { set; set_0; }
+ *       const entries = { 1 : set_0(); 3 : set_0(); }
+ *   }
+ *
+ * The original action is kept, since the default action, other tables and
+ * direct calls may still use it.  Actions that would need more than
+ * 'maxVariants' copies, actions with arguments that are not literals, and
+ * actions whose action list element supplies arguments are not specialized.
+ */
+class DoSpecializeConstActions : public Transform {
+    ReferenceMap *refMap;
+    unsigned maxVariants;
+
+    struct Variant {
+        const IR::Vector<IR::Argument> *arguments;
+        const IR::P4Action *action;
+    };
+    /// Variants of each specialized action (original node) of the current control.
+    std::map<const IR::P4Action *, std::vector<Variant>> variants;
+
+    const IR::P4Action *invokedAction(const IR::Expression *expression) const;
+    static bool sameArguments(const IR::Vector<IR::Argument> *left,
+                              const IR::Vector<IR::Argument> *right);
+    const IR::P4Action *specialize(const IR::P4Action *action,
+                                   const IR::Vector<IR::Argument> *arguments, size_t index);
+
+ public:
+    DoSpecializeConstActions(ReferenceMap *refMap, unsigned maxVariants)
+        : refMap(refMap), maxVariants(maxVariants) {
+        CHECK_NULL(refMap);
+        setName("DoSpecializeConstActions");
+    }
+    const IR::Node *preorder(IR::P4Control *control) override;
+    const IR::Node *postorder(IR::P4Control *control) override;
+    const IR::Node *postorder(IR::P4Table *table) override;
+};
+
+/// Specializes the actions of constant entries, then folds the constants in
+/// the new action bodies.
+class SpecializeConstActions : public PassManager {
+ public:
+    SpecializeConstActions(ReferenceMap *refMap, TypeMap *typeMap, unsigned maxVariants = 4,
+                           TypeChecking *typeChecking = nullptr) {
+        if (!typeChecking) typeChecking = new TypeChecking(refMap, typeMap);
+        passes.push_back(typeChecking);
+        passes.push_back(new DoSpecializeConstActions(refMap, maxVariants));
+        passes.push_back(new ClearTypeMap(typeMap));
+        passes.push_back(new ConstantFolding(refMap, typeMap));
+        setName("SpecializeConstActions");
+    }
+};
+
+}  // namespace P4
+
+#endif /* MIDEND_SPECIALIZECONSTACTIONS_H_ */
@@ -0,0 +1,52 @@
+#include "lib/arena.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace Test {
+
+TEST(Arena, allocateAligned) {
+    Util::Arena arena(256);
+    for (int i = 1; i < 100; ++i) {
+        void *p = arena.allocate(i, 8);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 8, 0u);
+        memset(p, i, i);
+    }
+    void *p = arena.allocate(3, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 64, 0u);
+}
+
+TEST(Arena, distinctAllocations) {
+    Util::Arena arena(128);
+    auto *a = static_cast<char *>(arena.allocate(16));
+    auto *b = static_cast<char *>(arena.allocate(16));
+    EXPECT_TRUE(a + 16 <= b || b + 16 <= a);
+    memset(a, 'a', 16);
+    memset(b, 'b', 16);
+    EXPECT_EQ(a[15], 'a');
+    EXPECT_EQ(b[0], 'b');
+}
+
+TEST(Arena, oversizedAllocation) {
+    Util::Arena arena(128);
+    auto *small = static_cast<char *>(arena.allocate(8));
+    auto *big = static_cast<char *>(arena.allocate(4096));
+    memset(big, 0, 4096);
+    // the current chunk is still used for small allocations
+    auto *next = static_cast<char *>(arena.allocate(8));
+    EXPECT_EQ(next, small + 16);
+    EXPECT_EQ(arena.bytesAllocated(), 8u + 4096u + 8u);
+}
+
+TEST(Arena, reset) {
+    Util::Arena arena;
+    arena.allocate(100);
+    EXPECT_EQ(arena.bytesAllocated(), 100u);
+    arena.reset();
+    EXPECT_EQ(arena.bytesAllocated(), 0u);
+    EXPECT_NE(arena.allocate(10), nullptr);
+}
+
+}  // namespace Test
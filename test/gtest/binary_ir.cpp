@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "ir/binary_loader.h"
+#include "ir/binary_writer.h"
+#include "ir/ir.h"
+
+namespace Test {
+
+TEST(IR, BinaryIRRoundTrip) {
+    const auto *c = new IR::Constant(IR::Type_Bits::get(48), big_int("0x123456789abc"));
+    const IR::Expression *sum = new IR::Add(c, new IR::Sub(c, new IR::Constant(-5)));
+    IR::Vector<IR::Node> objects;
+    objects.push_back(new IR::Declaration_Constant(IR::ID("x"), c->type, sum));
+    const auto *program = new IR::P4Program(objects);
+
+    std::stringstream ss;
+    BinaryIRWriter(ss) << program;
+
+    BinaryIRLoader loader(ss);
+    ASSERT_TRUE(loader.valid());
+    const auto *loaded = loader.readNode<IR::P4Program>();
+    ASSERT_TRUE(loaded);
+    EXPECT_TRUE(loaded->equiv(*program));
+    ASSERT_EQ(loaded->objects.size(), 1u);
+
+    // A node reachable along two paths is loaded once and still shared.
+    const auto *decl = loaded->objects.at(0)->to<IR::Declaration_Constant>();
+    ASSERT_TRUE(decl);
+    const auto *add = decl->initializer->to<IR::Add>();
+    ASSERT_TRUE(add);
+    EXPECT_EQ(add->left, add->right->to<IR::Sub>()->left);
+    EXPECT_EQ(add->left->to<IR::Constant>()->value, c->value);
+}
+
+TEST(IR, BinaryIRIndexedVector) {
+    auto *decls = new IR::IndexedVector<IR::Declaration_Constant>();
+    for (const char *name : {"a", "b"})
+        decls->push_back(new IR::Declaration_Constant(IR::ID(name), IR::Type_Bits::get(8),
+                                                      new IR::Constant(1)));
+
+    std::stringstream ss;
+    BinaryIRWriter(ss) << decls;
+
+    BinaryIRLoader loader(ss);
+    ASSERT_TRUE(loader.valid());
+    const auto *loaded = loader.readNode<IR::IndexedVector<IR::Declaration_Constant>>();
+    ASSERT_TRUE(loaded);
+    EXPECT_EQ(loaded->size(), 2u);
+    EXPECT_NE(loaded->getDeclaration("b"), nullptr);
+}
+
+TEST(IR, BinaryIRRejectsOtherData) {
+    std::stringstream ss("{ \"Node_ID\" : 1 }");
+    BinaryIRLoader loader(ss);
+    EXPECT_FALSE(loader.valid());
+}
+
+}  // namespace Test
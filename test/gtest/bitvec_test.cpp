@@ -19,6 +19,9 @@ limitations under the License.
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+
 namespace Test {
 
 TEST(Bitvec, Shift) {
@@ -141,4 +144,54 @@ TEST(Bitvec, io) {
     EXPECT_EQ(a, b);
 }
 
+TEST(Bitvec, multiword) {
+    bitvec a(0, 40), b(700, 10);
+    EXPECT_EQ(a.popcount(), 40);
+    EXPECT_TRUE(a |= b);
+    EXPECT_FALSE(a |= b);
+    EXPECT_EQ(a.popcount(), 50);
+    EXPECT_EQ(a.ffs(40), 700);
+    EXPECT_EQ(a.ffs(710), -1);
+
+    bitvec c(a);
+    EXPECT_FALSE(c &= a);
+    EXPECT_TRUE(c &= bitvec(0, 40));
+    EXPECT_EQ(c, bitvec(0, 40));
+    // Words beyond the other operand are cleared, and count as a change.
+    bitvec d(a);
+    EXPECT_TRUE(d &= bitvec(0, 64));
+    EXPECT_EQ(d, bitvec(0, 40));
+
+    EXPECT_TRUE(a -= b);
+    EXPECT_FALSE(a -= b);
+    EXPECT_EQ(a, bitvec(0, 40));
+    a -= bitvec(0, 40);
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(a.ffs(), -1);
+}
+
+// Microbenchmark of the multi-word operations used by def-use and liveness;
+// run with --gtest_also_run_disabled_tests.
+TEST(Bitvec, DISABLED_multiword_benchmark) {
+    constexpr int width = 4096, iterations = 20000;
+    bitvec a, b;
+    for (int i = 0; i < width; i += 7) a.setbit(i);
+    for (int i = 3; i < width; i += 13) b.setbit(i);
+    int bits = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        bitvec t(a);
+        t |= b;
+        t &= a;
+        t -= b;
+        bits += t.popcount();
+        for (int bit = t.ffs(); bit >= 0; bit = t.ffs(bit + 1)) ++bits;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << iterations << " iterations over " << width << " bits: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()
+              << " usec" << std::endl;
+    EXPECT_GT(bits, 0);
+}
+
 }  // namespace Test
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <optional>
+
+#include "absl/strings/substitute.h"
+#include "frontends/common/parseInput.h"
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/toP4/toP4.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "frontends/p4/typeMap.h"
+#include "helpers.h"
+#include "ir/ir.h"
+#include "lib/sourceCodeBuilder.h"
+#include "midend/eliminateCommonSubexpressions.h"
+
+using namespace P4;
+
+namespace Test {
+
+namespace {
+
+std::optional<FrontendTestCase> createCseTestCase(const std::string &ingressSource) {
+    std::string source = P4_SOURCE(P4Headers::V1MODEL, R"(
+header H
+{
+   bit<32> f1;
+   bit<32> f2;
+   bit<32> f3;
+}
+
+struct Headers { H h; }
+struct Metadata { }
+
+parser parse(packet_in packet, out Headers headers, inout Metadata meta,
+         inout standard_metadata_t sm) {
+    state start {
+        packet.extract(headers.h);
+        transition accept;
+    }
+}
+
+control verifyChecksum(inout Headers headers, inout Metadata meta) { apply { } }
+control ingress(inout Headers headers, inout Metadata meta,
+                inout standard_metadata_t sm) {
+    apply {
+$0
+    }
+}
+
+control egress(inout Headers headers, inout Metadata meta,
+                inout standard_metadata_t sm) { apply { } }
+
+control computeChecksum(inout Headers headers, inout Metadata meta) { apply { } }
+
+control deparse(packet_out packet, in Headers headers) {
+    apply { packet.emit(headers.h); }
+}
+
+V1Switch(parse(), verifyChecksum(), ingress(), egress(),
+    computeChecksum(), deparse()) main;
+    )");
+
+    return FrontendTestCase::create(absl::Substitute(source, ingressSource),
+                                    CompilerOptions::FrontendVersion::P4_16);
+}
+
+std::string eliminate(const FrontendTestCase &test) {
+    ReferenceMap refMap;
+    TypeMap typeMap;
+    Util::SourceCodeBuilder builder;
+    ToP4 dump(builder, false);
+    PassManager passes = {new EliminateCommonSubexpressions(&refMap, &typeMap), &dump};
+    test.program->apply(passes);
+    return builder.toString();
+}
+
+}  // namespace
+
+class EliminateCommonSubexpressionsTest : public P4CTest {};
+
+TEST_F(EliminateCommonSubexpressionsTest, Repeated) {
+    auto test = createCseTestCase(P4_SOURCE(R"(
+        headers.h.f1 = headers.h.f2 + headers.h.f3;
+        headers.h.f3 = (headers.h.f2 + headers.h.f3) | 32w1;
+    )"));
+    ASSERT_TRUE(test);
+
+    std::string program = eliminate(*test);
+    EXPECT_NE(program.find("tmp = headers.h.f2 + headers.h.f3;"), std::string::npos) << program;
+    EXPECT_NE(program.find("headers.h.f1 = tmp;"), std::string::npos) << program;
+    EXPECT_NE(program.find("headers.h.f3 = tmp | 32w1;"), std::string::npos) << program;
+}
+
+TEST_F(EliminateCommonSubexpressionsTest, KilledByWrite) {
+    auto test = createCseTestCase(P4_SOURCE(R"(
+        headers.h.f1 = headers.h.f2 + headers.h.f3;
+        headers.h.f3 = 32w0;
+        headers.h.f2 = headers.h.f2 + headers.h.f3;
+    )"));
+    ASSERT_TRUE(test);
+
+    std::string program = eliminate(*test);
+    EXPECT_EQ(program.find("tmp"), std::string::npos) << program;
+}
+
+TEST_F(EliminateCommonSubexpressionsTest, IsValid) {
+    auto test = createCseTestCase(P4_SOURCE(R"(
+        headers.h.f1 = (bit<32>)(bit<1>)headers.h.isValid();
+        if (headers.h.isValid()) {
+            headers.h.f2 = 32w0;
+        }
+    )"));
+    ASSERT_TRUE(test);
+
+    std::string program = eliminate(*test);
+    EXPECT_NE(program.find("tmp = headers.h.isValid();"), std::string::npos) << program;
+    EXPECT_NE(program.find("if (tmp)"), std::string::npos) << program;
+}
+
+}  // namespace Test
@@ -0,0 +1,333 @@
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <vector>
+
+#include "absl/strings/substitute.h"
+#include "frontends/common/parseInput.h"
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/entryPriorities.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "frontends/p4/typeMap.h"
+#include "helpers.h"
+#include "ir/ir.h"
+#include "midend/simplifyConstTables.h"
+#include "midend/specializeConstActions.h"
+
+using namespace P4;
+
+namespace Test {
+
+namespace {
+
+std::optional<FrontendTestCase> createConstTablesTestCase(const std::string &ingressSource) {
+    std::string source = P4_SOURCE(P4Headers::V1MODEL, R"(
+header H
+{
+   bit<32> f1;
+   bit<32> f2;
+   bit<32> f3;
+}
+
+struct Headers { H h; }
+struct Metadata { }
+
+parser parse(packet_in packet, out Headers headers, inout Metadata meta,
+         inout standard_metadata_t sm) {
+    state start {
+        packet.extract(headers.h);
+        transition accept;
+    }
+}
+
+control verifyChecksum(inout Headers headers, inout Metadata meta) { apply { } }
+control ingress(inout Headers headers, inout Metadata meta,
+                inout standard_metadata_t sm) {
+    action a1() { headers.h.f1 = 1; }
+    action a2() { headers.h.f1 = 2; }
+    action a3() { headers.h.f1 = 3; }
+$0
+}
+
+control egress(inout Headers headers, inout Metadata meta,
+                inout standard_metadata_t sm) { apply { } }
+
+control computeChecksum(inout Headers headers, inout Metadata meta) { apply { } }
+
+control deparse(packet_out packet, in Headers headers) {
+    apply { packet.emit(headers.h); }
+}
+
+V1Switch(parse(), verifyChecksum(), ingress(), egress(),
+    computeChecksum(), deparse()) main;
+    )");
+
+    return FrontendTestCase::create(absl::Substitute(source, ingressSource),
+                                    CompilerOptions::FrontendVersion::P4_16);
+}
+
+class CountNodes : public Inspector {
+    bool preorder(const IR::IfStatement *) override {
+        ifs++;
+        return true;
+    }
+    bool preorder(const IR::SwitchCase *) override {
+        cases++;
+        return true;
+    }
+    bool preorder(const IR::ActionList *list) override {
+        actions += list->size();
+        return true;
+    }
+
+ public:
+    int ifs = 0;
+    int cases = 0;
+    size_t actions = 0;
+};
+
+CountNodes simplify(const FrontendTestCase &test, size_t maxEntries = 1) {
+    ReferenceMap refMap;
+    TypeMap typeMap;
+    CountNodes count;
+    PassManager passes = {new SimplifyConstTables(&refMap, &typeMap, maxEntries), &count};
+    test.program->apply(passes);
+    return count;
+}
+
+/// Counts the actions, and the arguments passed by constant entries.
+class CountActions : public Inspector {
+    bool preorder(const IR::P4Action *) override {
+        actions++;
+        return true;
+    }
+    bool preorder(const IR::Entry *entry) override {
+        if (auto mce = entry->action->to<IR::MethodCallExpression>())
+            arguments += mce->arguments->size();
+        return false;
+    }
+
+ public:
+    int actions = 0;
+    size_t arguments = 0;
+};
+
+CountActions specialize(const FrontendTestCase &test) {
+    ReferenceMap refMap;
+    TypeMap typeMap;
+    CountActions count;
+    PassManager passes = {new SpecializeConstActions(&refMap, &typeMap, 2), &count};
+    test.program->apply(passes);
+    return count;
+}
+
+/// @returns the const entries of the tables after CompressConstEntries.
+std::vector<const IR::Entry *> compress(const FrontendTestCase &test) {
+    std::vector<const IR::Entry *> entries;
+    auto program = test.program->apply(CompressConstEntries());
+    forAllMatching<IR::Entry>(program, [&](const IR::Entry *entry) { entries.push_back(entry); });
+    return entries;
+}
+
+}  // namespace
+
+class SimplifyConstTablesTest : public P4CTest {};
+
+TEST_F(SimplifyConstTablesTest, SingleEntry) {
+    auto test = createConstTablesTestCase(P4_SOURCE(R"(
+    table t {
+        key = { headers.h.f2 : exact; }
+        actions = { a1; a2; a3; }
+        const entries = { 32w1 : a1(); }
+        const default_action = a2();
+    }
+    apply { t.apply(); }
+    )"));
+    ASSERT_TRUE(test);
+
+    auto count = simplify(*test);
+    EXPECT_EQ(1, count.ifs);
+    EXPECT_EQ(2u, count.actions);
+}
+
+TEST_F(SimplifyConstTablesTest, SeveralEntries) {
+    auto test = createConstTablesTestCase(P4_SOURCE(R"(
+    table t {
+        key = { headers.h.f2 : exact; }
+        actions = { a1; a2; a3; }
+        const entries = {
+            32w1 : a1();
+            32w2 : a3();
+            32w3 : a1();
+        }
+        const default_action = a2();
+    }
+    apply { t.apply(); }
+    )"));
+    ASSERT_TRUE(test);
+
+    EXPECT_EQ(0, simplify(*test, 2).ifs);
+    EXPECT_EQ(3, simplify(*test, 3).ifs);
+}
+
+TEST_F(SimplifyConstTablesTest, UnreachableCase) {
+    auto test = createConstTablesTestCase(P4_SOURCE(R"(
+    table t {
+        key = { headers.h.f2 : exact; }
+        actions = { a1; a2; a3; }
+        const entries = {
+            32w1 : a1();
+            32w2 : a1();
+        }
+        const default_action = a2();
+    }
+    apply {
+        switch (t.apply().action_run) {
+            a1: { headers.h.f3 = 1; }
+            a3: { headers.h.f3 = 3; }
+        }
+    }
+    )"));
+    ASSERT_TRUE(test);
+
+    auto count = simplify(*test);
+    EXPECT_EQ(0, count.ifs);
+    EXPECT_EQ(1, count.cases);
+    EXPECT_EQ(2u, count.actions);
+}
+
+TEST_F(SimplifyConstTablesTest, MutableTable) {
+    auto test = createConstTablesTestCase(P4_SOURCE(R"(
+    table t {
+        key = { headers.h.f2 : exact; }
+        actions = { a1; a2; a3; }
+        const entries = { 32w1 : a1(); }
+        default_action = a2();
+    }
+    apply { t.apply(); }
+    )"));
+    ASSERT_TRUE(test);
+
+    auto count = simplify(*test);
+    EXPECT_EQ(0, count.ifs);
+    EXPECT_EQ(3u, count.actions);
+}
+
+class SpecializeConstActionsTest : public P4CTest {};
+
+TEST_F(SpecializeConstActionsTest, DistinctArguments) {
+    auto test = createConstTablesTestCase(P4_SOURCE(R"(
+    action set(bit<32> v) { headers.h.f1 = v + 1; }
+    table t {
+        key = { headers.h.f2 : exact; }
+        actions = { set; a1; }
+        const entries = {
+            32w1 : set(32w10);
+            32w2 : set(32w20);
+            32w3 : set(32w10);
+        }
+        default_action = a1();
+    }
+    apply { t.apply(); }
+    )"));
+    ASSERT_TRUE(test);
+
+    auto count = specialize(*test);
+    // a1, a2, a3, set and one copy of set for each of the two argument lists.
+    EXPECT_EQ(6, count.actions);
+    EXPECT_EQ(0u, count.arguments);
+}
+
+TEST_F(SpecializeConstActionsTest, TooManyVariants) {
+    auto test = createConstTablesTestCase(P4_SOURCE(R"(
+    action set(bit<32> v) { headers.h.f1 = v; }
+    table t {
+        key = { headers.h.f2 : exact; }
+        actions = { set; }
+        const entries = {
+            32w1 : set(32w10);
+            32w2 : set(32w20);
+            32w3 : set(32w30);
+        }
+        default_action = set(32w0);
+    }
+    apply { t.apply(); }
+    )"));
+    ASSERT_TRUE(test);
+
+    auto count = specialize(*test);
+    EXPECT_EQ(4, count.actions);
+    EXPECT_EQ(3u, count.arguments);
+}
+
+class CompressConstEntriesTest : public P4CTest {};
+
+TEST_F(CompressConstEntriesTest, Ternary) {
+    auto test = createConstTablesTestCase(P4_SOURCE(R"(
+    table t {
+        key = { headers.h.f2 : ternary; }
+        actions = { a1; a2; a3; }
+        const entries = {
+            32w0x10 &&& 32w0xf0 : a1();
+            32w0x30 &&& 32w0xf0 : a1();
+            32w0x31 &&& 32w0xff : a2();
+            _ : a3();
+        }
+    }
+    apply { t.apply(); }
+    )"));
+    ASSERT_TRUE(test);
+
+    // The third entry is shadowed by the second, which is merged with the first.
+    auto entries = compress(*test);
+    ASSERT_EQ(2u, entries.size());
+    const auto *mask = entries[0]->keys->components.at(0)->to<IR::Mask>();
+    ASSERT_TRUE(mask != nullptr);
+    EXPECT_EQ(0x10, mask->left->to<IR::Constant>()->asInt());
+    EXPECT_EQ(0xd0, mask->right->to<IR::Constant>()->asInt());
+    EXPECT_TRUE(entries[1]->keys->components.at(0)->is<IR::DefaultExpression>());
+}
+
+TEST_F(CompressConstEntriesTest, Lpm) {
+    auto test = createConstTablesTestCase(P4_SOURCE(R"(
+    table t {
+        key = { headers.h.f2 : lpm; }
+        actions = { a1; a2; a3; }
+        const entries = {
+            32w0x0a000000 &&& 32w0xff000000 : a1();
+            32w0x0b000000 &&& 32w0xff000000 : a1();
+            32w0x0c000000 &&& 32w0xff000000 : a1();
+            32w0x0c000000 &&& 32w0xfe000000 : a2();
+            32w0x0d000000 &&& 32w0xff000000 : a1();
+        }
+    }
+    apply { t.apply(); }
+    )"));
+    ASSERT_TRUE(test);
+
+    // Merging the last prefix with its sibling would replace the entry with action a2.
+    auto entries = compress(*test);
+    ASSERT_EQ(4u, entries.size());
+    const auto *mask = entries[0]->keys->components.at(0)->to<IR::Mask>();
+    ASSERT_TRUE(mask != nullptr);
+    EXPECT_EQ(0xfe000000, mask->right->to<IR::Constant>()->asUint64());
+}
+
+TEST_F(CompressConstEntriesTest, MutableEntries) {
+    auto test = createConstTablesTestCase(P4_SOURCE(R"(
+    table t {
+        key = { headers.h.f2 : ternary; }
+        actions = { a1; a2; a3; }
+        entries = {
+            32w0x10 &&& 32w0xf0 : a1();
+            32w0x30 &&& 32w0xf0 : a1();
+        }
+    }
+    apply { t.apply(); }
+    )"));
+    ASSERT_TRUE(test);
+
+    EXPECT_EQ(2u, compress(*test).size());
+}
+
+}  // namespace Test
@@ -7,6 +7,7 @@
 #include "helpers.h"
 #include "ir/ir.h"
 #include "ir/pass_manager.h"
+#include "lib/big_int_util.h"
 #include "lib/log.h"
 
 using namespace P4;
@@ -133,4 +134,27 @@ TEST_F(P4CConstantFoldingValidation, filter) {
     EXPECT_TRUE(ts_2->size->is<IR::Constant>());
 }
 
+// Folding must give the same results whether or not the operands fit in a machine word.
+TEST_F(P4CFrontend, wide_arithmetic) {
+    auto fold = [](const IR::Expression *expression) -> big_int {
+        DoConstantFolding cf(nullptr, nullptr);
+        auto result = expression->apply(cf)->to<IR::Constant>();
+        EXPECT_TRUE(result);
+        return result ? result->value : big_int(-1);
+    };
+    auto u64 = IR::Type_Bits::get(64);
+    auto u128 = IR::Type_Bits::get(128);
+    auto s32 = IR::Type_Bits::get(32, true);
+    big_int max64 = Util::mask(64);
+
+    EXPECT_EQ(fold(new IR::Add(u64, new IR::Constant(u64, max64), new IR::Constant(u64, 1))), 0);
+    EXPECT_EQ(fold(new IR::Mul(u128, new IR::Constant(u128, max64), new IR::Constant(u128, max64))),
+              max64 * max64);
+    EXPECT_EQ(fold(new IR::Sub(s32, new IR::Constant(s32, INT32_MIN), new IR::Constant(s32, 1))),
+              INT32_MAX);
+    EXPECT_EQ(fold(new IR::BAnd(u128, new IR::Constant(u128, max64 << 8),
+                                new IR::Constant(u128, 0xffff))),
+              0xff00);
+}
+
 }  // namespace Test
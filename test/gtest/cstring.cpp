@@ -18,6 +18,11 @@ limitations under the License.
 
 #include <gtest/gtest.h>
 
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
 namespace Test {
 
 TEST(cstring, construct) {
@@ -142,4 +147,43 @@ TEST(cstring, literalSuffix) {
     EXPECT_TRUE((std::is_same_v<cstring, decltype(""_cs)>));
 }
 
+TEST(cstring, concurrentInterning) {
+    constexpr int threadCount = 8;
+    constexpr int stringCount = 2000;
+    std::vector<std::vector<const char *>> results(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([t, &results]() {
+            for (int i = 0; i < stringCount; ++i) {
+                cstring c = "concurrent_" + std::to_string(i);
+                results[t].push_back(c.c_str());
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+
+    // Every thread must have observed the same interned pointer for each string.
+    for (int i = 0; i < stringCount; ++i) {
+        cstring expected = "concurrent_" + std::to_string(i);
+        for (int t = 0; t < threadCount; ++t) EXPECT_EQ(results[t][i], expected.c_str());
+    }
+}
+
+TEST(cstring, makeUnique) {
+    std::set<cstring> inuse = {"make_unique_base", "make_unique_base_0", "make_unique_base_2"};
+    int counter = 0;
+    cstring first = cstring::make_unique(inuse, "make_unique_base", counter, '_');
+    EXPECT_EQ(first, "make_unique_base_1");
+    EXPECT_EQ(counter, 2);
+    inuse.insert(first);
+    EXPECT_EQ(cstring::make_unique(inuse, "make_unique_base", counter, '_'), "make_unique_base_3");
+    EXPECT_EQ(cstring::make_unique(inuse, "make_unique_free"), "make_unique_free");
+}
+
+TEST(cstring, getCached) {
+    EXPECT_TRUE(cstring::get_cached("get_cached_never_interned").isNull());
+    cstring interned = "get_cached_interned";
+    EXPECT_EQ(cstring::get_cached("get_cached_interned").c_str(), interned.c_str());
+}
+
 }  // namespace Test
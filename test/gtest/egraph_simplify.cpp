@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include "ir/ir.h"
+#include "midend/egraphSimplify.h"
+
+using namespace P4;
+
+namespace Test {
+
+namespace {
+
+const IR::Expression *var(const char *name, int width) {
+    return new IR::PathExpression(IR::Type_Bits::get(width), new IR::Path(name));
+}
+
+const IR::Constant *constant(int value, int width) {
+    return new IR::Constant(IR::Type_Bits::get(width), value);
+}
+
+/// Returns the simplest form of @p expression, and its cost.
+std::pair<const IR::Expression *, unsigned> simplify(const IR::Expression *expression) {
+    EGraph graph;
+    auto id = graph.add(expression);
+    EXPECT_TRUE(id.has_value());
+    graph.saturate();
+    return graph.extract(*id, ExpressionCostModel());
+}
+
+}  // namespace
+
+TEST(EGraph, Reassociation) {
+    auto t = IR::Type_Bits::get(16);
+    auto x = var("x", 16);
+    auto e = new IR::Add(t, new IR::Add(t, constant(1, 16), x), constant(2, 16));
+    auto [result, cost] = simplify(e);
+    EXPECT_EQ(1u, cost);
+    EXPECT_EQ(2u, EGraph::cost(e, ExpressionCostModel()));
+    auto add = result->to<IR::Add>();
+    ASSERT_NE(nullptr, add);
+    // Either operand order is as cheap.
+    auto value = add->right->to<IR::Constant>();
+    if (value == nullptr) value = add->left->to<IR::Constant>();
+    ASSERT_NE(nullptr, value);
+    EXPECT_EQ(3, value->asInt());
+}
+
+TEST(EGraph, Identities) {
+    auto t = IR::Type_Bits::get(8);
+    auto x = var("x", 8);
+    auto y = var("y", 8);
+    auto [result, cost] = simplify(new IR::BOr(t, new IR::BXor(t, x, x), y));
+    EXPECT_EQ(0u, cost);
+    EXPECT_EQ(y, result);
+
+    EGraph graph;
+    auto difference = graph.add(new IR::Sub(t, new IR::Add(t, x, y), y));
+    graph.saturate();
+    auto [reduced, reducedCost] = graph.extract(*difference, ExpressionCostModel());
+    EXPECT_EQ(x, reduced);
+    EXPECT_EQ(0u, reducedCost);
+}
+
+TEST(EGraph, Constants) {
+    auto t = IR::Type_Bits::get(8);
+    EGraph graph;
+    auto id = graph.add(new IR::Sub(t, constant(1, 8), constant(2, 8)));
+    ASSERT_TRUE(id.has_value());
+    ASSERT_TRUE(graph.constantOf(*id).has_value());
+    EXPECT_EQ(255, *graph.constantOf(*id));
+}
+
+TEST(EGraph, Slices) {
+    auto x = var("x", 16);
+    auto y = var("y", 8);
+    auto t16 = IR::Type_Bits::get(16);
+
+    auto [low, lowCost] =
+        simplify(new IR::Slice(new IR::Concat(IR::Type_Bits::get(24), x, y), 7, 0));
+    EXPECT_EQ(y, low);
+    EXPECT_EQ(0u, lowCost);
+
+    auto [shifted, shiftedCost] =
+        simplify(new IR::Slice(new IR::Shl(t16, x, new IR::Constant(8)), 15, 8));
+    EXPECT_EQ(1u, shiftedCost);
+    auto slice = shifted->to<IR::Slice>();
+    ASSERT_NE(nullptr, slice);
+    EXPECT_EQ(x, slice->e0);
+    EXPECT_EQ(7u, slice->getH());
+    EXPECT_EQ(0u, slice->getL());
+
+    auto [whole, wholeCost] =
+        simplify(new IR::Concat(t16, new IR::Slice(x, 15, 8), new IR::Slice(x, 7, 0)));
+    EXPECT_EQ(x, whole);
+    EXPECT_EQ(0u, wholeCost);
+}
+
+TEST(EGraph, StrengthReduction) {
+    auto t = IR::Type_Bits::get(32);
+    auto x = var("x", 32);
+    auto e = new IR::Mul(t, x, constant(8, 32));
+    auto [result, cost] = simplify(e);
+    EXPECT_EQ(1u, cost);
+    auto shl = result->to<IR::Shl>();
+    ASSERT_NE(nullptr, shl);
+    EXPECT_EQ(x, shl->left);
+    EXPECT_EQ(3, shl->right->to<IR::Constant>()->asInt());
+}
+
+TEST(EGraph, SignedIsNotRepresented) {
+    auto t = IR::Type_Bits::get(8, true);
+    auto x = new IR::PathExpression(t, new IR::Path("x"));
+    EGraph graph;
+    EXPECT_FALSE(graph.add(new IR::Add(t, x, new IR::Constant(t, 0))).has_value());
+}
+
+}  // namespace Test
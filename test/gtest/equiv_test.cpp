@@ -16,6 +16,7 @@ limitations under the License.
 
 #include <gtest/gtest.h>
 
+#include "ir/equiv_hash.h"
 #include "ir/ir.h"
 #include "ir/visitor.h"
 #include "lib/exceptions.h"
@@ -71,3 +72,39 @@ TEST(IR, Equiv) {
     pr2->add("listb", list1);
     EXPECT_FALSE(pr1->equiv(*pr2));
 }
+
+TEST(IR, EquivHash) {
+    auto *t = IR::Type::Bits::get(16);
+    auto *a1 = new IR::Constant(t, 10);
+    auto *a2 = new IR::Constant(t, 10);
+    auto *c = new IR::Constant(t, 20);
+    auto *d1m = new IR::Member(new IR::PathExpression("d"), "m");
+    auto *d2m = new IR::Member(new IR::PathExpression("d"), "m");
+    auto *call1 = new IR::MethodCallExpression(d1m, {a1, d1m});
+    auto *call2 = new IR::MethodCallExpression(d2m, {a2, d2m});
+    auto *call3 = new IR::MethodCallExpression(d1m, {c, d1m});
+
+    EXPECT_EQ(a1->equivHash(), a2->equivHash());
+    EXPECT_EQ(d1m->equivHash(), d2m->equivHash());
+    EXPECT_EQ(call1->equivHash(), call2->equivHash());
+    EXPECT_NE(a1->equivHash(), c->equivHash());
+    EXPECT_NE(call1->equivHash(), call3->equivHash());
+
+    // A modified clone does not keep the hash cached in the original.
+    auto *a3 = a1->clone();
+    a3->value = 20;
+    EXPECT_EQ(a3->equivHash(), c->equivHash());
+
+    IR::ExprSet set;
+    EXPECT_TRUE(set.insert(call1).second);
+    EXPECT_FALSE(set.insert(call2).second);
+    EXPECT_TRUE(set.insert(call3).second);
+    EXPECT_EQ(set.size(), 2u);
+    EXPECT_EQ(set.count(new IR::MethodCallExpression(d2m, {a2, d1m})), 1u);
+
+    IR::ExprMap<int> map;
+    map[a1] = 1;
+    map[c] = 2;
+    EXPECT_EQ(map.at(a2), 1);
+    EXPECT_EQ(map.at(a3), 2);
+}
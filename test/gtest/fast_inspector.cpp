@@ -0,0 +1,100 @@
+#include "ir/fast_inspector.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "ir/ir.h"
+#include "ir/visitor.h"
+
+namespace Test {
+
+namespace {
+
+const IR::Expression *sampleExpression() {
+    auto *t = IR::Type::Bits::get(16);
+    auto *x = new IR::PathExpression("x");
+    auto *call = new IR::MethodCallExpression(new IR::Member(x, "f"), {new IR::Constant(t, 1), x});
+    return new IR::Add(new IR::Mul(new IR::Constant(t, 2), x), call);
+}
+
+/// Records every node in preorder and postorder.
+class FastTrace : public IR::FastInspector<FastTrace> {
+ public:
+    using IR::FastInspector<FastTrace>::preorder;
+    using IR::FastInspector<FastTrace>::postorder;
+    std::vector<std::string> events;
+    bool preorder(const IR::Node *n) {
+        events.push_back(std::string("pre ") + n->node_type_name().c_str());
+        return true;
+    }
+    void postorder(const IR::Node *n) {
+        events.push_back(std::string("post ") + n->node_type_name().c_str());
+    }
+};
+
+class InspectorTrace : public Inspector {
+ public:
+    std::vector<std::string> events;
+    InspectorTrace() { visitDagOnce = false; }
+    bool preorder(const IR::Node *n) override {
+        events.push_back(std::string("pre ") + n->node_type_name().c_str());
+        return true;
+    }
+    void postorder(const IR::Node *n) override {
+        events.push_back(std::string("post ") + n->node_type_name().c_str());
+    }
+};
+
+/// Counts some node classes and prunes the subtrees of multiplications.
+class CountNodes : public IR::FastInspector<CountNodes> {
+ public:
+    using IR::FastInspector<CountNodes>::preorder;
+    unsigned constants = 0;
+    unsigned operations = 0;
+    unsigned vectors = 0;
+    unsigned others = 0;
+    bool preorder(const IR::Constant *) {
+        ++constants;
+        return true;
+    }
+    bool preorder(const IR::Operation_Binary *) {
+        ++operations;
+        return true;
+    }
+    bool preorder(const IR::Mul *) { return false; }
+    bool preorder(const IR::Vector<IR::Argument> *) {
+        ++vectors;
+        return true;
+    }
+    bool preorder(const IR::Node *) {
+        ++others;
+        return true;
+    }
+};
+
+}  // namespace
+
+TEST(FastInspector, visitsLikeInspector) {
+    const auto *expression = sampleExpression();
+    FastTrace fast;
+    fast.apply(expression);
+    InspectorTrace inspector;
+    expression->apply(inspector);
+    EXPECT_FALSE(fast.events.empty());
+    EXPECT_EQ(fast.events, inspector.events);
+}
+
+TEST(FastInspector, picksMostSpecificHandler) {
+    CountNodes count;
+    count.apply(sampleExpression());
+    // The Add is an Operation_Binary, the Mul prunes its constant, the call has one constant
+    // argument in a Vector<Argument>.
+    EXPECT_EQ(count.operations, 1u);
+    EXPECT_EQ(count.constants, 1u);
+    EXPECT_EQ(count.vectors, 1u);
+    EXPECT_GT(count.others, 0u);
+}
+
+}  // namespace Test
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <optional>
+
+#include "absl/strings/substitute.h"
+#include "frontends/common/parseInput.h"
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "frontends/p4/typeMap.h"
+#include "helpers.h"
+#include "ir/ir.h"
+#include "midend/foldIsValid.h"
+
+using namespace P4;
+
+namespace Test {
+
+namespace {
+
+std::optional<FrontendTestCase> createFoldIsValidTestCase(const std::string &applySource) {
+    std::string source = P4_SOURCE(P4Headers::V1MODEL, R"(
+header H
+{
+   bit<32> f1;
+   bit<32> f2;
+}
+
+struct Headers { H h; H g; }
+struct Metadata { }
+
+parser parse(packet_in packet, out Headers headers, inout Metadata meta,
+         inout standard_metadata_t sm) {
+    state start {
+        packet.extract(headers.h);
+        transition select(headers.h.isValid()) {
+            true: accept;
+            false: reject;
+        }
+    }
+}
+
+control verifyChecksum(inout Headers headers, inout Metadata meta) { apply { } }
+control ingress(inout Headers headers, inout Metadata meta,
+                inout standard_metadata_t sm) {
+    action a() { headers.h.setInvalid(); }
+    table t {
+        actions = { a; }
+        default_action = a();
+    }
+    apply {
+$0
+    }
+}
+
+control egress(inout Headers headers, inout Metadata meta,
+                inout standard_metadata_t sm) { apply { } }
+
+control computeChecksum(inout Headers headers, inout Metadata meta) { apply { } }
+
+control deparse(packet_out packet, in Headers headers) {
+    apply { packet.emit(headers.h); }
+}
+
+V1Switch(parse(), verifyChecksum(), ingress(), egress(),
+    computeChecksum(), deparse()) main;
+    )");
+
+    return FrontendTestCase::create(absl::Substitute(source, applySource),
+                                    CompilerOptions::FrontendVersion::P4_16);
+}
+
+class CountIsValid : public Inspector {
+    bool preorder(const IR::Member *member) override {
+        if (member->member == IR::Type_Header::isValid) calls++;
+        return true;
+    }
+
+ public:
+    int calls = 0;
+};
+
+/// Returns the number of isValid() calls left in the program after folding.
+int fold(const FrontendTestCase &test) {
+    ReferenceMap refMap;
+    TypeMap typeMap;
+    CountIsValid count;
+    PassManager passes = {new FoldIsValid(&refMap, &typeMap), &count};
+    test.program->apply(passes);
+    return count.calls;
+}
+
+}  // namespace
+
+class FoldIsValidTest : public P4CTest {};
+
+TEST_F(FoldIsValidTest, UnknownValidity) {
+    auto test = createFoldIsValidTestCase(P4_SOURCE(R"(
+        if (headers.h.isValid()) { headers.h.f1 = 1; }
+    )"));
+    ASSERT_TRUE(test);
+    // The call in the parser is folded: the header was just extracted.
+    EXPECT_EQ(1, fold(*test));
+}
+
+TEST_F(FoldIsValidTest, SetValid) {
+    auto test = createFoldIsValidTestCase(P4_SOURCE(R"(
+        headers.h.setValid();
+        headers.g.setInvalid();
+        if (headers.h.isValid() && !headers.g.isValid()) { headers.h.f1 = 1; }
+    )"));
+    ASSERT_TRUE(test);
+    EXPECT_EQ(0, fold(*test));
+}
+
+TEST_F(FoldIsValidTest, Branches) {
+    auto test = createFoldIsValidTestCase(P4_SOURCE(R"(
+        if (headers.h.isValid()) {
+            if (headers.h.isValid()) { headers.h.f1 = 1; }
+        } else {
+            headers.h.setValid();
+        }
+        if (headers.h.isValid()) { headers.h.f2 = 2; }
+        if (headers.g.isValid()) { headers.g.setInvalid(); }
+        if (headers.g.isValid()) { headers.g.f2 = 2; }
+    )"));
+    ASSERT_TRUE(test);
+    // Only the first test of each header remains.
+    EXPECT_EQ(2, fold(*test));
+}
+
+TEST_F(FoldIsValidTest, AppliesForget) {
+    auto test = createFoldIsValidTestCase(P4_SOURCE(R"(
+        headers.h.setValid();
+        headers.g = headers.h;
+        t.apply();
+        if (headers.h.isValid()) { headers.h.f1 = 1; }
+        if (headers.g.isValid()) { headers.g.f1 = 1; }
+    )"));
+    ASSERT_TRUE(test);
+    // The action of t may have invalidated both headers.
+    EXPECT_EQ(2, fold(*test));
+}
+
+}  // namespace Test
@@ -201,4 +201,65 @@ TEST_F(P4CFrontendMoveInitializers, P4ControlSrcInfo) {
     }
 }
 
+struct P4CFrontendResolveReferences : P4CFrontend {
+    P4CFrontendResolveReferences() { addPasses({new P4::ResolveReferences(&refMap)}); }
+
+    P4::ReferenceMap refMap;
+};
+
+TEST_F(P4CFrontendResolveReferences, Incremental) {
+    std::string program = P4_SOURCE(R"(
+        const bit<8> K = 1;
+        bit<8> g(in bit<8> x) { return x + K; }
+        bit<8> f(in bit<8> y) { return g(y); }
+    )");
+    const auto *prog = parseAndProcess(program);
+    ASSERT_TRUE(prog);
+
+    // Replaces g only; the map for f is carried over, with 'g' redirected.
+    struct AddToSub : public Transform {
+        const IR::Node *postorder(IR::Add *a) override {
+            return new IR::Sub(a->srcInfo, a->left, a->right);
+        }
+    };
+    const auto *changed = prog->apply(AddToSub())->to<IR::P4Program>();
+    ASSERT_TRUE(changed);
+    ASSERT_NE(changed, prog);
+    EXPECT_EQ(changed->objects.back(), prog->to<IR::P4Program>()->objects.back());
+
+    changed->apply(P4::ResolveReferences(&refMap));
+    P4::ReferenceMap fresh;
+    changed->apply(P4::ResolveReferences(&fresh));
+
+    struct ComparePaths : public Inspector {
+        const P4::ReferenceMap &incremental, &fresh;
+        unsigned count = 0;
+        ComparePaths(const P4::ReferenceMap &incremental, const P4::ReferenceMap &fresh)
+            : incremental(incremental), fresh(fresh) {}
+        void postorder(const IR::Path *path) override {
+            EXPECT_EQ(incremental.getDeclaration(path), fresh.getDeclaration(path)) << path;
+            ++count;
+        }
+    } compare(refMap, fresh);
+    changed->apply(compare);
+    EXPECT_GT(compare.count, 0u);
+}
+
+TEST_F(P4CFrontendResolveReferences, Statistics) {
+    std::string program = P4_SOURCE(R"(
+        const bit<8> K = 1;
+    )");
+    const auto *prog = parseAndProcess(program);
+    ASSERT_TRUE(prog);
+
+    auto before = P4::ProgramMap::statistics()["ReferenceMap"];
+    // The program has not changed, so the map is reused.
+    prog->apply(P4::ResolveReferences(&refMap));
+    P4::ReferenceMap fresh;
+    prog->apply(P4::ResolveReferences(&fresh));
+    auto after = P4::ProgramMap::statistics()["ReferenceMap"];
+    EXPECT_EQ(after.reused, before.reused + 1);
+    EXPECT_EQ(after.recomputed, before.recomputed + 1);
+}
+
 }  // namespace Test
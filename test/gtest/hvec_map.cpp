@@ -18,6 +18,9 @@ limitations under the License.
 
 #include <gtest/gtest.h>
 
+#include <map>
+#include <random>
+
 namespace Test {
 
 TEST(hvec_map, map_equal) {
@@ -177,4 +180,40 @@ TEST(hvec_map, string_map) {
     }
 }
 
+TEST(hvec_map, random_insert_erase) {
+    // Enough entries to grow the hash array, and the size of its indexes, several times;
+    // some keys are multiples of a hash array size, and collide.
+    hvec_map<unsigned, unsigned> hm;
+    std::map<unsigned, unsigned> sm;
+    // When each key present was last inserted.
+    std::map<unsigned, unsigned> inserted;
+    std::mt19937 random(1);
+    for (unsigned i = 0; i < 100000; i++) {
+        unsigned key = (random() % 4 == 0) ? (random() % 64) * 1023 : random() % 70000;
+        if (random() % 3 == 0) {
+            EXPECT_EQ(hm.erase(key), sm.erase(key));
+            inserted.erase(key);
+        } else {
+            inserted.emplace(key, i);
+            hm[key] = i;
+            sm[key] = i;
+        }
+    }
+    ASSERT_EQ(hm.size(), sm.size());
+    for (auto &[key, value] : sm) {
+        auto it = hm.find(key);
+        ASSERT_TRUE(it != hm.end());
+        EXPECT_EQ(it->second, value);
+    }
+    // Iteration is in insertion order.
+    size_t count = 0;
+    unsigned previous = 0;
+    for (auto &entry : hm) {
+        unsigned at = inserted.at(entry.first);
+        if (count++) EXPECT_LT(previous, at);
+        previous = at;
+    }
+    EXPECT_EQ(count, sm.size());
+}
+
 }  // namespace Test
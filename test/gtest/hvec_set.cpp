@@ -0,0 +1,168 @@
+/*
+Copyright 2023-present Intel
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lib/hvec_set.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "lib/hvec_map.h"
+#include "lib/ordered_map.h"
+#include "lib/ordered_set.h"
+
+namespace Test {
+
+TEST(hvec_set, set_equal) {
+    hvec_set<unsigned> a;
+    hvec_set<unsigned> b;
+
+    EXPECT_TRUE(a == b);
+
+    a.insert(1);
+    a.insert(2);
+    a.insert(3);
+    a.insert(4);
+
+    b.insert(1);
+    b.insert(2);
+    b.insert(3);
+    b.insert(4);
+
+    EXPECT_TRUE(a == b);
+
+    a.erase(2);
+    b.erase(2);
+
+    EXPECT_TRUE(a == b);
+
+    a.clear();
+    b.clear();
+
+    EXPECT_TRUE(a == b);
+}
+
+TEST(hvec_set, set_not_equal) {
+    hvec_set<unsigned> a;
+    hvec_set<unsigned> b;
+
+    a.insert(1);
+    a.insert(2);
+    a.insert(3);
+
+    b.insert(3);
+    b.insert(2);
+    b.insert(1);
+
+    EXPECT_TRUE(a != b);
+
+    b.clear();
+    b.insert(1);
+    b.insert(2);
+
+    EXPECT_TRUE(a != b);
+}
+
+TEST(hvec_set, insertion_order) {
+    hvec_set<std::string> s;
+    ordered_set<std::string> os;
+
+    for (int i = 100; i > 0; --i) {
+        EXPECT_TRUE(s.insert(std::to_string(i)).second);
+        os.insert(std::to_string(i));
+    }
+    EXPECT_FALSE(s.insert("50").second);
+    EXPECT_EQ(s.size(), 100);
+    EXPECT_TRUE(std::equal(s.begin(), s.end(), os.begin(), os.end()));
+
+    for (int i = 1; i <= 100; i += 3) {
+        EXPECT_EQ(s.erase(std::to_string(i)), 1);
+        os.erase(std::to_string(i));
+    }
+    EXPECT_EQ(s.erase("1"), 0);
+    EXPECT_EQ(s.count("1"), 0);
+    EXPECT_EQ(s.count("2"), 1);
+    EXPECT_TRUE(std::equal(s.begin(), s.end(), os.begin(), os.end()));
+
+    // Reinserting an erased element puts it last, as in ordered_set.
+    s.insert("1");
+    os.insert("1");
+    EXPECT_EQ(*std::prev(s.end()), "1");
+    EXPECT_TRUE(std::equal(s.begin(), s.end(), os.begin(), os.end()));
+
+    auto it = s.find("99");
+    ASSERT_TRUE(it != s.end());
+    it = s.erase(it);
+    EXPECT_EQ(*it, "98");
+    EXPECT_TRUE(s.find("99") == s.end());
+
+    hvec_set<std::string> copy(s);
+    EXPECT_TRUE(copy == s);
+    copy = s;
+    EXPECT_TRUE(copy == s);
+}
+
+namespace {
+
+template <class Map>
+size_t fillMap(const std::vector<std::string> &keys) {
+    Map m;
+    for (auto &k : keys) m[k] = k.size();
+    size_t sum = 0;
+    for (int pass = 0; pass < 10; ++pass)
+        for (auto &el : m) sum += el.second;
+    for (auto &k : keys) sum += m.count(k);
+    return sum;
+}
+
+template <class Set>
+size_t fillSet(const std::vector<std::string> &keys) {
+    Set s;
+    for (auto &k : keys) s.insert(k);
+    size_t sum = 0;
+    for (int pass = 0; pass < 10; ++pass)
+        for (auto &el : s) sum += el.size();
+    for (auto &k : keys) sum += s.count(k);
+    return sum;
+}
+
+template <class F>
+void time(const char *what, F f) {
+    auto start = std::chrono::steady_clock::now();
+    size_t result = f();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << what << ": "
+              << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()
+              << " usec" << std::endl;
+    EXPECT_GT(result, 0);
+}
+
+}  // namespace
+
+TEST(hvec_set, DISABLED_benchmark) {
+    std::vector<std::string> keys;
+    for (int i = 0; i < 200000; ++i) keys.push_back("key" + std::to_string(i * 7919 % 200000));
+    time("ordered_map", [&] { return fillMap<ordered_map<std::string, size_t>>(keys); });
+    time("hvec_map", [&] { return fillMap<hvec_map<std::string, size_t>>(keys); });
+    time("ordered_set", [&] { return fillSet<ordered_set<std::string>>(keys); });
+    time("hvec_set", [&] { return fillSet<hvec_set<std::string>>(keys); });
+}
+
+}  // namespace Test
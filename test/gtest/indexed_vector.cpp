@@ -74,6 +74,28 @@ TEST(IndexedVector, move_ctor) {
     EXPECT_EQ(vec3.back()->name.name, "foo");
 }
 
+TEST(IndexedVector, copies_are_independent) {
+    TestVector vec{testItem("foo"), testItem("bar")};
+    const TestVector &original = vec;
+    TestVector copy(vec);
+    EXPECT_TRUE(copy == vec);
+
+    copy.removeByName("foo");
+    copy.push_back(testItem("baz"));
+    EXPECT_EQ(copy.size(), 2u);
+    EXPECT_EQ(copy[0]->name.name, "bar");
+    EXPECT_EQ(copy.getDeclaration("foo"), nullptr);
+    EXPECT_NE(copy.getDeclaration("baz"), nullptr);
+
+    EXPECT_EQ(original.size(), 2u);
+    EXPECT_EQ(original[0]->name.name, "foo");
+    EXPECT_EQ(original[1]->name.name, "bar");
+    EXPECT_NE(original.getDeclaration("foo"), nullptr);
+    EXPECT_EQ(original.getDeclaration("baz"), nullptr);
+    original.validate();
+    copy.validate();
+}
+
 TEST(IndexedVector, ilist_ctor) {
     TestVector vec{testItem("foo"), testItem("bar")};
     EXPECT_EQ(vec.size(), 2u);
@@ -72,4 +72,44 @@ TEST(Util, Json) {
               obj->toString());
 }
 
+TEST(Util, JsonWriter) {
+    auto arr = (new JsonArray())->append(5)->append("5");
+    auto obj = new JsonObject();
+    obj->emplace("x", "x");
+    obj->emplace("y", arr);
+    obj->emplace("z", new JsonArray());
+    obj->emplace("w", new JsonObject());
+
+    std::stringstream streamed;
+    JsonWriter writer(streamed);
+    writer.beginObject();
+    writer.field("x", "x");
+    writer.key("y").beginArray(true).value(5).value("5").endArray();
+    writer.key("z").beginArray().endArray();
+    writer.key("w").value(new JsonObject());
+    writer.endObject();
+    EXPECT_EQ(writer.depth(), 0u);
+    EXPECT_EQ(obj->toString(), streamed.str());
+
+    std::stringstream nested;
+    JsonWriter(nested).beginArray().value(obj).value(nullptr).endArray();
+    EXPECT_EQ((new JsonArray({obj, nullptr}))->toString(), nested.str());
+
+    std::stringstream bad;
+    JsonWriter misuse(bad);
+    misuse.beginObject();
+    EXPECT_THROW(misuse.value(1), std::logic_error);
+    EXPECT_THROW(misuse.endArray(), std::logic_error);
+}
+
+TEST(Util, JsonMinimal) {
+    auto obj = new JsonObject();
+    obj->emplace("x", "x");
+    obj->emplace("y", (new JsonArray())->append(5)->append("5"));
+    obj->emplace("z", (new JsonArray())->append(new JsonObject())->append(new JsonArray()));
+    std::stringstream out;
+    obj->serialize(out, true);
+    EXPECT_EQ("{\"x\":\"x\",\"y\":[5,\"5\"],\"z\":[{},[]]}", out.str());
+}
+
 }  // namespace Util
@@ -16,11 +16,14 @@ limitations under the License.
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/util/delimited_message_util.h>
 #include <google/protobuf/util/message_differencer.h>
 #include <gtest/gtest.h>
 
 #include <iterator>
 #include <optional>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -30,6 +33,9 @@ limitations under the License.
 #include "p4/config/v1/p4info.pb.h"
 #pragma GCC diagnostic pop
 
+#include "control-plane/bytestrings.h"
+#include "control-plane/flattenHeader.h"
+#include "control-plane/indexedP4Info.h"
 #include "control-plane/p4RuntimeSerializer.h"
 #include "control-plane/p4infoApi.h"
 #include "control-plane/typeSpecConverter.h"
@@ -52,6 +58,7 @@ namespace {
 
 using P4Ids = p4configv1::P4Ids;
 
+using P4::ControlPlaneAPI::P4InfoIndex;
 using P4::ControlPlaneAPI::findP4RuntimeAction;
 using P4::ControlPlaneAPI::findP4RuntimeControllerPacketMetadata;
 using P4::ControlPlaneAPI::findP4RuntimeCounter;
@@ -511,6 +518,71 @@ TEST_F(P4Runtime, IdAssignmentCounters) {
     }
 }
 
+TEST_F(P4Runtime, P4InfoIndex) {
+    auto test = createP4RuntimeTestCase(P4_SOURCE(P4Headers::V1MODEL, R"(
+        header Header { bit<32> hfA; bit<16> hfB; }
+        struct Headers { Header h; }
+        struct Metadata { }
+        parser parse(packet_in p, out Headers h, inout Metadata m,
+                     inout standard_metadata_t sm) {
+            state start { transition accept; } }
+        control verifyChecksum(inout Headers h, inout Metadata m) { apply { } }
+        control egress(inout Headers h, inout Metadata m,
+                        inout standard_metadata_t sm) { apply { } }
+        control computeChecksum(inout Headers h, inout Metadata m) { apply { } }
+        control deparse(packet_out p, in Headers h) { apply { } }
+
+        control ingress(inout Headers h, inout Metadata m,
+                        inout standard_metadata_t sm) {
+            action noop() { }
+            action drop() { mark_to_drop(sm); }
+
+            @name(".myCounter")
+            counter<bit<10>>(32w1024, CounterType.packets) myCounter;
+
+            @name(".myTable")
+            table myTable {
+                key = { h.h.hfA : exact; h.h.hfB : ternary; }
+                actions = { noop; drop; }
+                default_action = noop;
+            }
+
+            apply {
+                myTable.apply();
+                myCounter.count(128);
+            }
+        }
+
+        V1Switch(parse(), verifyChecksum(), ingress(), egress(),
+                 computeChecksum(), deparse()) main;
+    )"));
+
+    ASSERT_TRUE(test);
+    EXPECT_EQ(0U, ::diagnosticCount());
+
+    // The index finds the same objects as the linear lookups, by name and by id.
+    P4InfoIndex index(*test->p4Info);
+    const auto *myTable = findP4RuntimeTable(*test->p4Info, "myTable");
+    ASSERT_TRUE(myTable != nullptr);
+    EXPECT_EQ(myTable, index.findTable("myTable"));
+    EXPECT_EQ(myTable, index.findTable(myTable->preamble().id()));
+    EXPECT_TRUE(index.findTable("myMissingTable") == nullptr);
+    for (const auto &field : myTable->match_fields()) {
+        EXPECT_EQ(&field, index.findMatchField(*myTable, field.name()));
+        EXPECT_EQ(&field, index.findMatchField(*myTable, field.id()));
+    }
+    EXPECT_TRUE(index.findMatchField(*myTable, "h.h.hfC") == nullptr);
+    for (const auto &action : test->p4Info->actions()) {
+        EXPECT_EQ(&action, index.findAction(action.preamble().name()));
+        EXPECT_EQ(&action, index.findAction(action.preamble().id()));
+    }
+    const auto *myCounter = findP4RuntimeCounter(*test->p4Info, "myCounter");
+    ASSERT_TRUE(myCounter != nullptr);
+    EXPECT_EQ(myCounter, index.findCounter("myCounter"));
+    EXPECT_EQ(myCounter, index.findCounter(myCounter->preamble().id()));
+    EXPECT_TRUE(index.findCounter(myTable->preamble().id()) == nullptr);
+}
+
 namespace {
 
 /// A helper for the match fields tests; represents metadata about a match field
@@ -1114,6 +1186,34 @@ TEST_F(P4Runtime, StaticTableEntries) {
         checkEntry(updates.Get(4), "\x01", "\x01");
         checkEntry(updates.Get(5), std::string("\x00", 1), std::string("\x00", 1));
     }
+
+    {
+        // In chunks of 4 updates, the entries are written as two delimited messages.
+        std::stringstream out;
+        test->serializeEntriesTo(&out, P4::P4RuntimeFormat::BINARY, 4);
+        google::protobuf::io::IstreamInputStream input(&out);
+        std::vector<p4v1::WriteRequest> chunks(1);
+        bool cleanEof = false;
+        while (google::protobuf::util::ParseDelimitedFromZeroCopyStream(&chunks.back(), &input,
+                                                                         &cleanEof))
+            chunks.emplace_back();
+        EXPECT_TRUE(cleanEof);
+        ASSERT_EQ(3U, chunks.size());
+        ASSERT_EQ(4, chunks[0].updates_size());
+        ASSERT_EQ(2, chunks[1].updates_size());
+        EXPECT_TRUE(MessageDifferencer::Equals(updates.Get(0), chunks[0].updates(0)));
+        EXPECT_TRUE(MessageDifferencer::Equals(updates.Get(5), chunks[1].updates(1)));
+    }
+
+    {
+        // In JSON, each chunk is written on its own line.
+        std::stringstream out;
+        test->serializeEntriesTo(&out, P4::P4RuntimeFormat::JSON, 4);
+        std::string line;
+        unsigned lines = 0;
+        while (std::getline(out, line)) lines++;
+        EXPECT_EQ(2U, lines);
+    }
 }
 
 TEST_F(P4Runtime, IsConstTable) {
@@ -1810,6 +1910,60 @@ TEST_F(P4RuntimeDataTypeSpec, HeaderWithFlattening) {
     EXPECT_EQ(8, memberBitstringTypeSpec.bit().bitwidth());
 }
 
+TEST_F(P4RuntimeDataTypeSpec, FlattenedHeaderCache) {
+    using P4::ControlPlaneAPI::FlattenHeader;
+    std::string program = P4_SOURCE(R"(
+        struct s_t { bit<8> f1; bit<8> f2; }
+        header my_header { bit<8> f; s_t s; }
+        extern my_extern_t<T> { my_extern_t(bit<32> v); }
+        my_extern_t<my_header>(32w1024) my_extern;
+    )");
+    const auto *pgm = getProgram(program);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    const auto *name = findExternTypeParameterName<IR::Type_Name>(pgm, "my_extern_t");
+    ASSERT_TRUE(name != nullptr);
+    const auto *type = typeMap.getTypeType(name, true)->to<IR::Type_Header>();
+    ASSERT_TRUE(type != nullptr);
+    const auto *flattened = FlattenHeader::flatten(&typeMap, type);
+    EXPECT_EQ(3u, flattened->fields.size());
+    EXPECT_TRUE(typeMap.contains(flattened->fields.front()));
+    EXPECT_EQ(flattened, FlattenHeader::flatten(&typeMap, type));
+}
+
+TEST_F(P4RuntimeDataTypeSpec, SharedTypeInfo) {
+    std::string program = P4_SOURCE(R"(
+        header my_header { bit<8> f; }
+        struct my_struct { my_header h1; my_header h2; }
+        extern my_extern_t<T> { my_extern_t(bit<32> v); }
+        my_extern_t<my_struct>(32w1024) my_extern_1;
+        my_extern_t<my_struct>(32w1024) my_extern_2;
+    )");
+    const auto *pgm = getProgram(program);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    // The second conversion finds the struct in the type info and does not walk it again.
+    std::vector<const IR::Type_Name *> types;
+    forAllMatching<IR::Type_Specialized>(pgm, [&](const IR::Type_Specialized *ts) {
+        if (ts->baseType->toString() == "my_extern_t")
+            types.push_back(ts->arguments->at(0)->to<IR::Type_Name>());
+    });
+    ASSERT_EQ(2u, types.size());
+    for (const auto *type : types) {
+        ASSERT_TRUE(type != nullptr);
+        const auto *typeSpec =
+            P4::ControlPlaneAPI::TypeSpecConverter::convert(&refMap, &typeMap, type, &typeInfo);
+        ASSERT_TRUE(typeSpec->has_struct_());
+        EXPECT_EQ("my_struct", typeSpec->struct_().name());
+    }
+    EXPECT_EQ(1, typeInfo.structs_size());
+    EXPECT_EQ(1, typeInfo.headers_size());
+    auto it = typeInfo.structs().find("my_struct");
+    ASSERT_TRUE(it != typeInfo.structs().end());
+    ASSERT_EQ(2, it->second.members_size());
+    EXPECT_EQ("my_header", it->second.members(1).type_spec().header().name());
+}
+
 TEST_F(P4RuntimeDataTypeSpec, HeaderUnion) {
     std::string program = P4_SOURCE(R"(
         header my_header_1 { bit<8> f; }
@@ -2116,4 +2270,123 @@ TEST_F(P4RuntimeDataTypeSpec, NewTypeValidTranslationAnnotations) {
     }
 }
 
+TEST_F(P4Runtime, PreviousP4Info) {
+    using P4::ControlPlaneAPI::diffP4Info;
+    using P4::ControlPlaneAPI::P4RuntimeSymbolTable;
+    using P4::ControlPlaneAPI::P4RuntimeSymbolType;
+
+    p4configv1::P4Info previous;
+    auto *kept = previous.add_tables();
+    kept->mutable_preamble()->set_id(0x02000005);
+    kept->mutable_preamble()->set_name("ingress.kept");
+    auto *removed = previous.add_tables();
+    removed->mutable_preamble()->set_id(0x02000006);
+    removed->mutable_preamble()->set_name("ingress.removed");
+    auto *taken = previous.add_actions();
+    taken->mutable_preamble()->set_id(0x01000007);
+    taken->mutable_preamble()->set_name("ingress.taken");
+
+    // Symbols keep their previous id, unless an @id annotation claims it.
+    const auto *symbols = P4RuntimeSymbolTable::create(
+        [](P4RuntimeSymbolTable &symbols) {
+            symbols.add(P4RuntimeSymbolType::P4RT_TABLE(), "ingress.kept");
+            symbols.add(P4RuntimeSymbolType::P4RT_TABLE(), "ingress.added");
+            symbols.add(P4RuntimeSymbolType::P4RT_ACTION(), "ingress.taken");
+            symbols.add(P4RuntimeSymbolType::P4RT_ACTION(), "ingress.annotated", 0x01000007);
+        },
+        &previous);
+    EXPECT_EQ(0x02000005U, symbols->getId(P4RuntimeSymbolType::P4RT_TABLE(), "ingress.kept"));
+    EXPECT_NE(0x01000007U, symbols->getId(P4RuntimeSymbolType::P4RT_ACTION(), "ingress.taken"));
+    EXPECT_EQ(0x01000007U,
+              symbols->getId(P4RuntimeSymbolType::P4RT_ACTION(), "ingress.annotated"));
+
+    p4configv1::P4Info current;
+    *current.add_tables() = *kept;
+    current.mutable_tables(0)->set_size(1024);
+    auto *added = current.add_tables();
+    added->mutable_preamble()->set_id(0x02000008);
+    added->mutable_preamble()->set_name("ingress.added");
+    *current.add_actions() = *taken;
+
+    // Objects are identified by kind and name; the actions did not change.
+    const auto *diff = diffP4Info(previous, current);
+    auto names = [&](cstring field) {
+        std::vector<std::string> result;
+        for (const auto *entry : *diff->get(field)->to<Util::JsonArray>())
+            result.push_back(entry->to<Util::JsonObject>()->get("name")->toString());
+        return result;
+    };
+    EXPECT_EQ(std::vector<std::string>{"\"ingress.added\""}, names("added"));
+    EXPECT_EQ(std::vector<std::string>{"\"ingress.removed\""}, names("removed"));
+    EXPECT_EQ(std::vector<std::string>{"\"ingress.kept\""}, names("modified"));
+}
+
+TEST(P4RuntimeIndexedP4Info, Lookups) {
+    namespace IndexedP4Info = P4::ControlPlaneAPI::IndexedP4Info;
+
+    p4configv1::P4Info p4Info;
+    auto *table = p4Info.add_tables();
+    table->mutable_preamble()->set_id(0x02000002);
+    table->mutable_preamble()->set_name("ingress.t");
+    table->set_size(1024);
+    auto *action = p4Info.add_actions();
+    action->mutable_preamble()->set_id(0x01000001);
+    action->mutable_preamble()->set_name("ingress.t");
+    auto *counter = p4Info.add_counters();
+    counter->mutable_preamble()->set_id(0x12000003);
+    counter->mutable_preamble()->set_name("ingress.c");
+
+    std::stringstream out;
+    ASSERT_TRUE(IndexedP4Info::writeTo(p4Info, &out));
+    std::string data = out.str();
+    IndexedP4Info::View view(data.data(), data.size());
+    ASSERT_TRUE(view.valid());
+    EXPECT_EQ(3U, view.objects());
+
+    auto byId = view.findById(0x02000002);
+    ASSERT_TRUE(byId.has_value());
+    EXPECT_EQ("tables", byId->kind);
+    EXPECT_EQ("ingress.t", byId->name);
+    p4configv1::Table parsed;
+    ASSERT_TRUE(parsed.ParseFromArray(byId->message.data(), byId->message.size()));
+    EXPECT_EQ(1024, parsed.size());
+    EXPECT_FALSE(view.findById(0x02000004).has_value());
+
+    auto byName = view.findByName("ingress.t", "actions");
+    ASSERT_TRUE(byName.has_value());
+    EXPECT_EQ(0x01000001U, byName->id);
+    ASSERT_TRUE(view.findByName("ingress.c").has_value());
+    EXPECT_EQ(0x12000003U, view.findByName("ingress.c")->id);
+    EXPECT_FALSE(view.findByName("ingress.c", "tables").has_value());
+    EXPECT_FALSE(view.findByName("ingress").has_value());
+
+    p4configv1::P4Info full;
+    auto serialized = view.p4Info();
+    ASSERT_TRUE(full.ParseFromArray(serialized.data(), serialized.size()));
+    EXPECT_TRUE(google::protobuf::util::MessageDifferencer::Equals(p4Info, full));
+
+    // Truncated files are rejected.
+    EXPECT_FALSE(IndexedP4Info::View(data.data(), data.size() - 1).valid());
+}
+
+TEST(P4RuntimeBytestrings, PaddedToWidth) {
+    using P4::ControlPlaneAPI::stringReprConstant;
+    std::string bytes = "previous contents";
+    ASSERT_TRUE(stringReprConstant(big_int(0), 9, &bytes));
+    EXPECT_EQ(std::string("\x00\x00", 2), bytes);
+    ASSERT_TRUE(stringReprConstant(big_int(0x1ff), 9, &bytes));
+    EXPECT_EQ(std::string("\x01\xff", 2), bytes);
+    ASSERT_TRUE(stringReprConstant(big_int(0x0102030405060708ULL), 72, &bytes));
+    EXPECT_EQ(std::string("\x00\x01\x02\x03\x04\x05\x06\x07\x08", 9), bytes);
+
+    // Values wider than 64 bits.
+    big_int wide = (big_int(1) << 100) | 0xab;
+    ASSERT_TRUE(stringReprConstant(wide, 128, &bytes));
+    std::string expected(16, '\0');
+    expected[3] = '\x10';
+    expected[15] = '\xab';
+    EXPECT_EQ(expected, bytes);
+    EXPECT_EQ(expected, *stringReprConstant(wide, 128));
+}
+
 }  // namespace Test
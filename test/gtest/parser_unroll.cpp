@@ -6,6 +6,7 @@
 #include "frontends/common/parseInput.h"
 #include "ir/ir.h"
 #include "lib/log.h"
+#include "midend/parserUnroll.h"
 #include "test/gtest/env.h"
 #include "test/gtest/helpers.h"
 #include "test/gtest/midend_pass.h"
@@ -99,6 +100,28 @@ TEST_F(P4CParserUnroll, test1) {
     ASSERT_EQ(parsers.first->states.size(), parsers.second->states.size() - 3 - 1);
 }
 
+TEST_F(P4CParserUnroll, budgetExhausted) {
+    AutoCompileContext autoP4TestContext(new P4TestContext);
+    auto &options = P4TestContext::get().options();
+    const char *argv = "./gtestp4c";
+    options.process(1, (char *const *)&argv);
+    const IR::P4Program *program = load_model("parser-unroll-test1.p4", options);
+    ASSERT_TRUE(program);
+    program = P4::FrontEnd().run(options, program);
+    ASSERT_TRUE(program);
+
+    // Too small a budget leaves the parser loop in place.
+    P4::ReferenceMap refMap;
+    P4::TypeMap typeMap;
+    RedirectStderr errors;
+    const auto *res = program->apply(P4::ParsersUnroll(true, &refMap, &typeMap, 2));
+    errors.reset();
+    ASSERT_TRUE(res);
+    EXPECT_TRUE(errors.contains("parser loops not unrolled"));
+    EXPECT_EQ(getParser(program)->states.size(),
+              getParser(res->to<IR::P4Program>())->states.size());
+}
+
 TEST_F(P4CParserUnroll, test2) {
     auto parsers = loadExample("parser-unroll-test2.p4");
     ASSERT_TRUE(parsers.first);
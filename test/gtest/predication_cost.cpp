@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <optional>
+
+#include "absl/strings/substitute.h"
+#include "frontends/common/parseInput.h"
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "frontends/p4/typeMap.h"
+#include "helpers.h"
+#include "ir/ir.h"
+#include "midend/predication.h"
+
+using namespace P4;
+
+namespace Test {
+
+namespace {
+
+std::optional<FrontendTestCase> createPredicationTestCase(const std::string &actionSource) {
+    std::string source = P4_SOURCE(P4Headers::V1MODEL, R"(
+header H
+{
+   bit<32> f1;
+   bit<32> f2;
+   bit<32> f3;
+}
+
+struct Headers { H h; }
+struct Metadata { }
+
+parser parse(packet_in packet, out Headers headers, inout Metadata meta,
+         inout standard_metadata_t sm) {
+    state start {
+        packet.extract(headers.h);
+        transition accept;
+    }
+}
+
+control verifyChecksum(inout Headers headers, inout Metadata meta) { apply { } }
+control ingress(inout Headers headers, inout Metadata meta,
+                inout standard_metadata_t sm) {
+$0
+    table t {
+        actions = { a; }
+        default_action = a();
+    }
+    apply { t.apply(); }
+}
+
+control egress(inout Headers headers, inout Metadata meta,
+                inout standard_metadata_t sm) { apply { } }
+
+control computeChecksum(inout Headers headers, inout Metadata meta) { apply { } }
+
+control deparse(packet_out packet, in Headers headers) {
+    apply { packet.emit(headers.h); }
+}
+
+V1Switch(parse(), verifyChecksum(), ingress(), egress(),
+    computeChecksum(), deparse()) main;
+    )");
+
+    return FrontendTestCase::create(absl::Substitute(source, actionSource),
+                                    CompilerOptions::FrontendVersion::P4_16);
+}
+
+class CountIfs : public Inspector {
+    bool preorder(const IR::IfStatement *) override {
+        ifs++;
+        return true;
+    }
+
+ public:
+    int ifs = 0;
+};
+
+int predicate(const FrontendTestCase &test, const PredicationCostModel *costModel) {
+    ReferenceMap refMap;
+    CountIfs count;
+    PassManager passes = {new Predication(&refMap, costModel), &count};
+    test.program->apply(passes);
+    return count.ifs;
+}
+
+}  // namespace
+
+class PredicationCostTest : public P4CTest {};
+
+TEST_F(PredicationCostTest, CheapBranches) {
+    auto test = createPredicationTestCase(P4_SOURCE(R"(
+    action a() {
+        if (headers.h.f2 == 1) {
+            headers.h.f1 = 1;
+        } else {
+            headers.h.f1 = 2;
+        }
+    }
+    )"));
+    ASSERT_TRUE(test);
+
+    PredicationCostModel costModel;
+    EXPECT_EQ(0, predicate(*test, &costModel));
+}
+
+TEST_F(PredicationCostTest, ExpensiveBranch) {
+    auto test = createPredicationTestCase(P4_SOURCE(R"(
+    action a() {
+        if (headers.h.f2 == 1) {
+            headers.h.f1 = headers.h.f2 + headers.h.f3;
+            headers.h.f2 = headers.h.f1 + headers.h.f3;
+            headers.h.f3 = headers.h.f1 + headers.h.f2;
+            headers.h.f1 = headers.h.f2 + headers.h.f3;
+            headers.h.f2 = headers.h.f1 + headers.h.f3;
+            headers.h.f3 = headers.h.f1 + headers.h.f2;
+        }
+    }
+    )"));
+    ASSERT_TRUE(test);
+
+    PredicationCostModel costModel;
+    EXPECT_EQ(1, predicate(*test, &costModel));
+    // Without a cost model every conditional is predicated.
+    EXPECT_EQ(0, predicate(*test, nullptr));
+}
+
+}  // namespace Test
@@ -0,0 +1,40 @@
+#include "lib/sourceCodeBuilder.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+namespace Test {
+
+TEST(SourceCodeBuilder, IndentsBlocks) {
+    Util::SourceCodeBuilder builder;
+    builder.append("void f()");
+    builder.spc();
+    builder.blockStart();
+    builder.emitIndent();
+    builder.appendFormat("return %d", 42);
+    builder.endOfStatement(true);
+    builder.blockEnd(true);
+    EXPECT_EQ(builder.toString(), "void f() {\n    return 42;\n}\n");
+    EXPECT_TRUE(builder.lastIsSpace());
+}
+
+TEST(SourceCodeBuilder, LargeOutput) {
+    Util::SourceCodeBuilder builder;
+    std::string expected;
+    // Spans several segments and formats a string which does not fit the format buffer.
+    std::string line(1000, 'x');
+    for (int i = 0; i < 200; ++i) {
+        builder.appendFormat("%s%d", line.c_str(), i);
+        builder.newline();
+        expected += line + std::to_string(i) + "\n";
+    }
+    EXPECT_EQ(builder.size(), expected.size());
+    EXPECT_EQ(builder.toString(), expected);
+    std::stringstream out;
+    builder.writeTo(out);
+    EXPECT_EQ(out.str(), expected);
+}
+
+}  // namespace Test
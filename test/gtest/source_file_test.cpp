@@ -78,8 +78,32 @@ TEST(UtilSourceFile, InputSources) {
     EXPECT_EQ(5u, original.sourceLine);
 }
 
+TEST(UtilSourceFile, InputSourcesAppendText) {
+    Util::InputSources sources;
+    sources.appendText("header h {\r\n    bit<8> f;\n");
+    sources.appendText("}");
+    sources.appendText("\n\r\n");
+    sources.appendText("x\ry");
+
+    EXPECT_EQ(5u, sources.lineCount());
+    EXPECT_EQ("header h {\r\n", sources.getLine(1));
+    EXPECT_EQ("    bit<8> f;\n", sources.getLine(2));
+    EXPECT_EQ("}\n", sources.getLine(3));
+    EXPECT_EQ("\r\n", sources.getLine(4));
+    EXPECT_EQ("x\ry", sources.getLine(5));
+
+    SourcePosition position = sources.getCurrentPosition();
+    EXPECT_EQ(5u, position.getLineNumber());
+    EXPECT_EQ(3u, position.getColumnNumber());
+    EXPECT_EQ(2u, sources.getSourceLine(2).sourceLine);
+
+    SourceInfo token(&sources, 16u, 22u);
+    EXPECT_EQ("(2:4)-(2:10)", token.toDebugString());
+}
+
 TEST(UtilSourceFile, SourceInfo) {
     Util::InputSources sources;
+    sources.appendText("First line\nSecond line\n");
 
     SourcePosition t1_s(1, 1);
     SourcePosition t1_e(1, 5);
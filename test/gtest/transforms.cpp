@@ -16,9 +16,12 @@ limitations under the License.
 
 #include <gtest/gtest.h>
 
+#include <set>
+
 #include "helpers.h"
 #include "ir/ir.h"
 #include "ir/irutils.h"
+#include "ir/pass_manager.h"
 #include "ir/visitor.h"
 #include "lib/source_file.h"
 
@@ -81,4 +84,152 @@ TEST_F(P4C_IR, InlineBlock) {
     EXPECT_TRUE(ifs->ifFalse->is<IR::BlockStatement>());
 }
 
+TEST_F(P4C_IR, PerDeclarationPass) {
+    struct DoubleConstants : public Transform {
+        bool per_declaration_safe() const override { return true; }
+        const IR::Node *postorder(IR::Constant *c) override {
+            EXPECT_NE(findContext<IR::P4Program>(), nullptr);
+            return new IR::Constant(c->type, c->value * 2);
+        }
+        DoubleConstants *clone() const override { return new DoubleConstants(*this); }
+    };
+
+    IR::Vector<IR::Node> objects;
+    for (int i = 0; i < 8; ++i)
+        objects.push_back(new IR::Declaration_Constant(
+            IR::ID("c" + std::to_string(i)), IR::Type_Bits::get(8), new IR::Constant(i)));
+    const auto *program = new IR::P4Program(objects);
+
+    PassManager passes({new DoubleConstants});
+    passes.setParallelJobs(4);
+    const auto *result = program->apply(passes)->to<IR::P4Program>();
+    ASSERT_TRUE(result);
+    ASSERT_EQ(result->objects.size(), 8u);
+    for (int i = 0; i < 8; ++i) {
+        const auto *decl = result->objects.at(i)->to<IR::Declaration_Constant>();
+        ASSERT_TRUE(decl);
+        EXPECT_EQ(decl->initializer->to<IR::Constant>()->asInt(), 2 * i);
+    }
+}
+
+TEST_F(P4C_IR, PassRepeatedWorklist) {
+    struct CountDown : public Transform {
+        int *visits;
+        explicit CountDown(int *visits) : visits(visits) {}
+        bool per_declaration_safe() const override { return true; }
+        const IR::Node *preorder(IR::Declaration_Constant *d) override {
+            ++*visits;
+            return d;
+        }
+        const IR::Node *postorder(IR::Constant *c) override {
+            if (c->value == 0) return c;
+            return new IR::Constant(c->type, c->value - 1);
+        }
+        CountDown *clone() const override { return new CountDown(*this); }
+    };
+
+    IR::Vector<IR::Node> objects;
+    for (int i = 0; i < 4; ++i)
+        objects.push_back(new IR::Declaration_Constant(
+            IR::ID("c" + std::to_string(i)), IR::Type_Bits::get(8), new IR::Constant(i)));
+    const auto *program = new IR::P4Program(objects);
+
+    int sweepVisits = 0, worklistVisits = 0;
+    const auto *swept = program->apply(PassRepeated({new CountDown(&sweepVisits)}));
+    const auto *result =
+        program->apply(*PassRepeated({new CountDown(&worklistVisits)}).setWorklist());
+    // Four full sweeps, against 4 + 3 + 2 + 1 declarations revisited.
+    EXPECT_EQ(sweepVisits, 16);
+    EXPECT_EQ(worklistVisits, 10);
+    ASSERT_TRUE(result->is<IR::P4Program>());
+    EXPECT_TRUE(result->equiv(*swept));
+    for (auto *decl : result->to<IR::P4Program>()->objects)
+        EXPECT_EQ(decl->to<IR::Declaration_Constant>()->initializer->to<IR::Constant>()->asInt(),
+                  0);
+}
+
+TEST_F(P4C_IR, MemoizingInspector) {
+    struct CountConstants : public MemoizingInspector<int> {
+        int count = 0, traversals = 0;
+        profile_t init_apply(const IR::Node *root) override {
+            count = 0;
+            ++traversals;
+            return MemoizingInspector<int>::init_apply(root);
+        }
+        void postorder(const IR::Constant *) override { ++count; }
+        int memoResult() const override { return count; }
+    };
+
+    const auto *one = new IR::Constant(1);
+    const IR::Expression *sum = new IR::Add(one, new IR::Add(one, new IR::Constant(2)));
+    CountConstants counter;
+    EXPECT_EQ(counter.memoized(sum), 3);
+    EXPECT_EQ(counter.memoized(sum), 3);
+    EXPECT_EQ(counter.traversals, 1);
+
+    // A rewritten tree is a different node and is counted afresh.
+    const auto *other = new IR::Add(sum, one);
+    EXPECT_EQ(counter.memoized(other), 4);
+    EXPECT_EQ(counter.traversals, 2);
+    EXPECT_EQ(counter.memoSize(), 2u);
+}
+
+TEST_F(P4C_IR, VisitorTracksNodesSharingAnId) {
+    struct CountConstants : public Inspector {
+        int count = 0;
+        void postorder(const IR::Constant *) override { ++count; }
+    };
+
+    // Node ids are only mostly unique (e.g. after copy-assignment); the visitor's
+    // state tracking must still tell such nodes apart, and visit shared ones once.
+    auto *a = new IR::Constant(1);
+    auto *b = new IR::Constant(2);
+    b->id = a->id;
+    const IR::Expression *sum = new IR::Add(new IR::Add(a, b), a);
+    CountConstants counter;
+    sum->apply(counter);
+    EXPECT_EQ(counter.count, 2);
+
+    // A second application starts from a clean state.
+    counter.count = 0;
+    sum->apply(counter);
+    EXPECT_EQ(counter.count, 2);
+}
+
+TEST_F(P4C_IR, ParallelFlowVisit) {
+    struct CollectAssigned : public ControlFlowVisitor, public Inspector {
+        std::set<cstring> assigned;
+        bool parallel_flows_safe() const override { return true; }
+        CollectAssigned *clone() const override { return new CollectAssigned(*this); }
+        void flow_merge(Visitor &other) override {
+            auto &o = dynamic_cast<CollectAssigned &>(other);
+            assigned.insert(o.assigned.begin(), o.assigned.end());
+        }
+        void flow_copy(ControlFlowVisitor &other) override {
+            assigned = dynamic_cast<CollectAssigned &>(other).assigned;
+        }
+        bool preorder(const IR::AssignmentStatement *a) override {
+            assigned.insert(a->left->to<IR::PathExpression>()->path->name);
+            return false;
+        }
+    };
+
+    auto assign = [](const char *name) {
+        return new IR::AssignmentStatement(new IR::PathExpression(IR::ID(name)),
+                                           new IR::Constant(1));
+    };
+    const IR::Statement *inner = new IR::IfStatement(new IR::BoolLiteral(true), assign("b"),
+                                                     assign("c"));
+    const IR::Statement *outer =
+        new IR::IfStatement(new IR::BoolLiteral(false), inner, assign("d"));
+
+    CollectAssigned sequential;
+    outer->apply(sequential);
+    CollectAssigned parallel;
+    parallel.setParallelFlowJobs(4);
+    outer->apply(parallel);
+    EXPECT_EQ(parallel.assigned, sequential.assigned);
+    EXPECT_EQ(parallel.assigned.size(), 3u);
+}
+
 }  // namespace Test
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+
+#include "frontends/common/parseInput.h"
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/common/resolveReferences/resolveReferences.h"
+#include "frontends/p4/toP4/toP4.h"
+#include "frontends/p4/unusedDeclarations.h"
+#include "helpers.h"
+#include "ir/ir.h"
+
+using namespace P4;
+
+namespace Test {
+
+namespace {
+
+std::string deadChainSource() {
+    return P4_SOURCE(R"(
+bit<8> f1(in bit<8> x) { return x; }
+bit<8> f2(in bit<8> x) { return f1(x); }
+bit<8> f3(in bit<8> x) { return f2(x); }
+bit<8> g(in bit<8> x) { return x; }
+control C(inout bit<8> x) {
+    action dead() { x = f3(x); }
+    table t { actions = { dead; } }
+    apply { x = g(x); }
+}
+control Ctype(inout bit<8> x);
+package Top(Ctype c);
+Top(C()) main;
+)");
+}
+
+}  // namespace
+
+class UnusedDeclarationsTest : public P4CTest {};
+
+TEST_F(UnusedDeclarationsTest, LivenessIsTransitive) {
+    auto pgm = P4::parseP4String(deadChainSource(), CompilerOptions::FrontendVersion::P4_16);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    ReferenceMap refMap;
+    std::set<const IR::IDeclaration *> live;
+    PassManager passes({new ResolveReferences(&refMap), new FindLiveDeclarations(&refMap, &live)});
+    pgm = pgm->apply(passes);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    auto f1 = pgm->getDeclsByName("f1")->single();
+    auto g = pgm->getDeclsByName("g")->single();
+    auto control = pgm->getDeclsByName("C")->single()->to<IR::P4Control>();
+    ASSERT_TRUE(control != nullptr);
+    // f1 is referenced, but only from dead code.
+    EXPECT_TRUE(refMap.isUsed(f1));
+    EXPECT_EQ(live.count(f1), 0u);
+    EXPECT_EQ(live.count(pgm->getDeclsByName("f3")->single()), 0u);
+    EXPECT_EQ(live.count(control->getDeclByName("t")), 0u);
+    EXPECT_EQ(live.count(control->getDeclByName("dead")), 0u);
+    EXPECT_EQ(live.count(g), 1u);
+    EXPECT_EQ(live.count(control), 1u);
+}
+
+TEST_F(UnusedDeclarationsTest, RemovesDeadChain) {
+    auto pgm = P4::parseP4String(deadChainSource(), CompilerOptions::FrontendVersion::P4_16);
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    ReferenceMap refMap;
+    pgm = pgm->apply(RemoveAllUnusedDeclarations(&refMap));
+    ASSERT_TRUE(pgm != nullptr && ::errorCount() == 0);
+
+    auto program = P4::toP4(pgm);
+    for (auto name : {"f1", "f2", "f3", "dead", "table t"})
+        EXPECT_EQ(program.find(name), std::string::npos) << name << " in " << program;
+    EXPECT_NE(program.find("g("), std::string::npos) << program;
+}
+
+}  // namespace Test
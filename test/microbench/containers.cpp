@@ -0,0 +1,170 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ir/ir.h"
+#include "lib/bitvec.h"
+#include "lib/cstring.h"
+#include "lib/hash.h"
+#include "lib/hvec_map.h"
+#include "lib/ordered_map.h"
+#include "lib/ordered_set.h"
+
+namespace Bench {
+
+namespace {
+
+/// The same keys on every run, so that results can be compared between builds.
+std::vector<unsigned> keys(size_t count) {
+    std::mt19937 random(42);
+    std::vector<unsigned> result(count);
+    for (auto &key : result) key = random();
+    return result;
+}
+
+std::vector<std::string> names(size_t count) {
+    std::vector<std::string> result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; i++) result.push_back("hdr.field_" + std::to_string(i));
+    return result;
+}
+
+}  // namespace
+
+template <class Map>
+void BM_MapInsert(benchmark::State &state) {
+    auto input = keys(state.range(0));
+    for (auto _ : state) {
+        Map map;
+        for (auto key : input) map[key] = key;
+        benchmark::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK_TEMPLATE(BM_MapInsert, hvec_map<unsigned, unsigned>)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_MapInsert, ordered_map<unsigned, unsigned>)->Range(64, 64 << 10);
+
+template <class Map>
+void BM_MapFind(benchmark::State &state) {
+    auto input = keys(state.range(0));
+    Map map;
+    for (auto key : input) map[key] = key;
+    for (auto _ : state) {
+        size_t found = 0;
+        for (auto key : input) found += map.count(key);
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK_TEMPLATE(BM_MapFind, hvec_map<unsigned, unsigned>)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_MapFind, ordered_map<unsigned, unsigned>)->Range(64, 64 << 10);
+
+template <class Map>
+void BM_MapIterate(benchmark::State &state) {
+    auto input = keys(state.range(0));
+    Map map;
+    for (auto key : input) map[key] = key;
+    for (auto _ : state) {
+        unsigned sum = 0;
+        for (auto &entry : map) sum += entry.second;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK_TEMPLATE(BM_MapIterate, hvec_map<unsigned, unsigned>)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_MapIterate, ordered_map<unsigned, unsigned>)->Range(64, 64 << 10);
+
+void BM_OrderedSetInsertErase(benchmark::State &state) {
+    auto input = keys(state.range(0));
+    for (auto _ : state) {
+        ordered_set<unsigned> set;
+        for (auto key : input) set.insert(key);
+        for (size_t i = 0; i < input.size(); i += 2) set.erase(input[i]);
+        benchmark::DoNotOptimize(set);
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_OrderedSetInsertErase)->Range(64, 64 << 10);
+
+void BM_BitvecSetAndCount(benchmark::State &state) {
+    auto input = keys(state.range(0));
+    for (auto _ : state) {
+        bitvec bits;
+        for (auto key : input) bits.setbit(key % 4096);
+        benchmark::DoNotOptimize(bits.popcount());
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_BitvecSetAndCount)->Range(64, 64 << 10);
+
+void BM_BitvecOperators(benchmark::State &state) {
+    bitvec a, b;
+    for (auto key : keys(512)) a.setbit(key % state.range(0));
+    for (auto key : keys(1024)) b.setbit(key % state.range(0));
+    for (auto _ : state) {
+        bitvec c = a & b;
+        c |= a;
+        c ^= b;
+        benchmark::DoNotOptimize(c.ffs());
+    }
+}
+BENCHMARK(BM_BitvecOperators)->Range(64, 64 << 10);
+
+void BM_CstringIntern(benchmark::State &state) {
+    auto input = names(state.range(0));
+    for (auto _ : state) {
+        for (const auto &name : input) benchmark::DoNotOptimize(cstring(name).c_str());
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_CstringIntern)->Range(64, 16 << 10);
+
+void BM_CstringCompare(benchmark::State &state) {
+    auto input = names(state.range(0));
+    std::vector<cstring> interned(input.begin(), input.end());
+    for (auto _ : state) {
+        size_t equal = 0;
+        for (size_t i = 1; i < interned.size(); i++) equal += interned[i] == interned[i - 1];
+        benchmark::DoNotOptimize(equal);
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_CstringCompare)->Range(64, 16 << 10);
+
+void BM_Hash(benchmark::State &state) {
+    std::string data(state.range(0), 'x');
+    for (auto _ : state) benchmark::DoNotOptimize(Util::hash(data.data(), data.size()));
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_Hash)->Range(8, 8 << 10);
+
+void BM_HashCombine(benchmark::State &state) {
+    auto input = keys(state.range(0));
+    for (auto _ : state) {
+        uint64_t hash = 0;
+        for (auto key : input) hash = Util::hash_combine(hash, key);
+        benchmark::DoNotOptimize(hash);
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_HashCombine)->Range(64, 64 << 10);
+
+void BM_IndexedVectorPushAndLookup(benchmark::State &state) {
+    std::vector<cstring> input;
+    for (size_t i = 0; i < static_cast<size_t>(state.range(0)); i++)
+        input.push_back(cstring("v" + std::to_string(i)));
+    for (auto _ : state) {
+        IR::IndexedVector<IR::Declaration_Variable> vector;
+        for (auto name : input)
+            vector.push_back(new IR::Declaration_Variable(name, IR::Type_Bits::get(8)));
+        size_t found = 0;
+        for (auto name : input) found += vector.getDeclaration(name) != nullptr;
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_IndexedVectorPushAndLookup)->Range(16, 4 << 10);
+
+}  // namespace Bench
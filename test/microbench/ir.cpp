@@ -0,0 +1,120 @@
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <string>
+
+#include "ir/ir.h"
+#include "ir/json_generator.h"
+#include "ir/json_loader.h"
+#include "ir/visitor.h"
+
+namespace Bench {
+
+namespace {
+
+/// A block of @p count statements, each an assignment or an if statement,
+/// over a few variables; about 10 nodes per statement.
+const IR::BlockStatement *synthesize(size_t count) {
+    auto type = IR::Type_Bits::get(32);
+    auto var = [type](size_t i) {
+        return new IR::PathExpression(type, new IR::Path("v" + std::to_string(i % 16)));
+    };
+    IR::IndexedVector<IR::StatOrDecl> components;
+    for (size_t i = 0; i < count; i++) {
+        auto value = new IR::BAnd(type, new IR::Add(type, var(i), new IR::Constant(type, i)),
+                                  var(i + 1));
+        auto assign = new IR::AssignmentStatement(var(i), value);
+        if (i % 4 == 3) {
+            auto condition = new IR::Equ(IR::Type_Boolean::get(), var(i + 2),
+                                         new IR::Constant(type, i % 7));
+            components.push_back(new IR::IfStatement(condition, assign, nullptr));
+        } else {
+            components.push_back(assign);
+        }
+    }
+    return new IR::BlockStatement(std::move(components));
+}
+
+class CountNodes : public Inspector {
+ public:
+    size_t count = 0;
+    bool preorder(const IR::Node *) override {
+        ++count;
+        return true;
+    }
+};
+
+/// Changes nothing, but every node is cloned on the way down.
+class Identity : public Transform {};
+
+/// Rewrites every constant, so that every statement is rebuilt.
+class RewriteConstants : public Transform {
+ public:
+    const IR::Node *postorder(IR::Constant *constant) override {
+        return new IR::Constant(constant->type, constant->value + 1);
+    }
+};
+
+}  // namespace
+
+void BM_InspectorApply(benchmark::State &state) {
+    auto block = synthesize(state.range(0));
+    size_t nodes = 0;
+    for (auto _ : state) {
+        CountNodes count;
+        block->apply(count);
+        nodes = count.count;
+    }
+    state.SetItemsProcessed(state.iterations() * nodes);
+}
+BENCHMARK(BM_InspectorApply)->Range(64, 16 << 10);
+
+void BM_TransformIdentity(benchmark::State &state) {
+    auto block = synthesize(state.range(0));
+    for (auto _ : state) {
+        Identity identity;
+        benchmark::DoNotOptimize(block->apply(identity));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TransformIdentity)->Range(64, 16 << 10);
+
+void BM_TransformRewrite(benchmark::State &state) {
+    auto block = synthesize(state.range(0));
+    for (auto _ : state) {
+        RewriteConstants rewrite;
+        benchmark::DoNotOptimize(block->apply(rewrite));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TransformRewrite)->Range(64, 16 << 10);
+
+void BM_JsonGenerate(benchmark::State &state) {
+    auto block = synthesize(state.range(0));
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::stringstream out;
+        JSONGenerator(out) << block;
+        bytes = out.str().size();
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_JsonGenerate)->Range(64, 4 << 10);
+
+void BM_JsonRoundTrip(benchmark::State &state) {
+    auto block = synthesize(state.range(0));
+    std::stringstream generated;
+    JSONGenerator(generated) << block;
+    auto json = generated.str();
+    for (auto _ : state) {
+        std::stringstream in(json);
+        JSONLoader loader(in);
+        const IR::Node *loaded = nullptr;
+        loader >> loaded;
+        benchmark::DoNotOptimize(loaded);
+    }
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_JsonRoundTrip)->Range(64, 4 << 10);
+
+}  // namespace Bench
@@ -0,0 +1,15 @@
+#include <benchmark/benchmark.h>
+
+#include "lib/compile_context.h"
+#include "lib/gc.h"
+
+int main(int argc, char **argv) {
+    setup_gc_logging();
+    AutoCompileContext context(new BaseCompileContext);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
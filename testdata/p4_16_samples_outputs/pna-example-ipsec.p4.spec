@@ -69,10 +69,6 @@ struct metadata_t {
 	bit<8> MainControlT_tmp_0
 	bit<32> ipsec_port_inbound
 	bit<32> ipsec_port_outbound
-	bit<32> ipsec_port_inbound_0
-	bit<32> ipsec_port_outbound_0
-	bit<32> ipsec_port_inbound_1
-	bit<32> ipsec_port_outbound_1
 }
 metadata instanceof metadata_t
 
@@ -223,11 +219,11 @@ apply {
 	MAINPARSERIMPL_PARSE_ESP :	extract h.esp
 	MAINPARSERIMPL_ACCEPT :	jmpneq LABEL_FALSE_0 m.pna_main_input_metadata_direction 0x0
 	mov m.MainControlT_status 0x0
-	regrd m.ipsec_port_inbound_0 ipsec_port_in_inbound 0x0
-	regrd m.ipsec_port_outbound_0 ipsec_port_in_outbound 0x0
+	regrd m.ipsec_port_inbound ipsec_port_in_inbound 0x0
+	regrd m.ipsec_port_outbound ipsec_port_in_outbound 0x0
 	mov m.MainControlT_tmp 0x0
-	jmpeq LABEL_TRUE_2 m.pna_main_input_metadata_input_port m.ipsec_port_inbound_0
-	jmpeq LABEL_TRUE_2 m.pna_main_input_metadata_input_port m.ipsec_port_outbound_0
+	jmpeq LABEL_TRUE_2 m.pna_main_input_metadata_input_port m.ipsec_port_inbound
+	jmpeq LABEL_TRUE_2 m.pna_main_input_metadata_input_port m.ipsec_port_outbound
 	jmp LABEL_END_2
 	LABEL_TRUE_2 :	mov m.MainControlT_tmp 0x1
 	LABEL_END_2 :	jmpneq LABEL_FALSE_1 m.MainControlT_tmp 0x1
@@ -254,11 +250,11 @@ apply {
 	LABEL_FALSE_3 :	drop
 	jmp LABEL_END_1
 	LABEL_FALSE_0 :	mov m.MainControlT_status_0 0x0
-	regrd m.ipsec_port_inbound_1 ipsec_port_in_inbound 0x0
-	regrd m.ipsec_port_outbound_1 ipsec_port_in_outbound 0x0
+	regrd m.ipsec_port_inbound ipsec_port_in_inbound 0x0
+	regrd m.ipsec_port_outbound ipsec_port_in_outbound 0x0
 	mov m.MainControlT_tmp_0 0x0
-	jmpeq LABEL_TRUE_8 m.pna_main_input_metadata_input_port m.ipsec_port_inbound_1
-	jmpeq LABEL_TRUE_8 m.pna_main_input_metadata_input_port m.ipsec_port_outbound_1
+	jmpeq LABEL_TRUE_8 m.pna_main_input_metadata_input_port m.ipsec_port_inbound
+	jmpeq LABEL_TRUE_8 m.pna_main_input_metadata_input_port m.ipsec_port_outbound
 	jmp LABEL_END_8
 	LABEL_TRUE_8 :	mov m.MainControlT_tmp_0 0x1
 	LABEL_END_8 :	jmpneq LABEL_FALSE_6 m.MainControlT_tmp_0 0x1
@@ -63,10 +63,7 @@ void crc16_update(u16 * reg, const u8 * data, u16 data_size, const u16 poly) {
     #pragma clang loop unroll(full)
     for (u16 i = 0; i < data_size; i++) {
         bpf_trace_message("CRC16: data byte: %x\n", *data);
-        *reg ^= *data;
-        for (u8 bit = 0; bit < 8; bit++) {
-            *reg = (*reg) & 1 ? ((*reg) >> 1) ^ poly : (*reg) >> 1;
-        }
+        *reg = ((*reg) >> 8) ^ crc16_table[(u8)((*reg) ^ *data)];
         if (data_size <= 8)
             data--;
         else
@@ -79,7 +76,6 @@ static __always_inline u16 crc16_finalize(u16 reg) {
 static __always_inline
 void crc32_update(u32 * reg, const u8 * data, u16 data_size, const u32 poly) {
     u32* current = (u32*) data;
-    u32 index = 0;
     u32 lookup_key = 0;
     u32 lookup_value = 0;
     u32 lookup_value1 = 0;
@@ -91,7 +87,7 @@ void crc32_update(u32 * reg, const u8 * data, u16 data_size, const u32 poly) {
     u32 lookup_value7 = 0;
     u32 lookup_value8 = 0;
     u16 tmp = 0;
-    if (crc32_table != NULL) {
+    {
         for (u16 i = data_size; i >= 8; i -= 8) {
             /* Vars one and two will have swapped byte order if data_size == 8 */
             if (data_size == 8) current = (u32 *)(data + 4);
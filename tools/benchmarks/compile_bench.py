@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""Measures how the compilers scale with the size of the program.
+
+Each compiler compiles the programs made by p4_generator.py at increasing
+scales.  The wall time and peak RSS of every run, and the per-pass profile
+written with --pass-profile, are appended as one JSON line per run to the
+results file.  Compilers growing faster than linearly with the scale are
+reported at the end, with the passes responsible for most of the growth.
+Growth is measured against the number of lines of the program, since some
+parameters multiply each other (e.g. tables and action size).
+"""
+
+import argparse
+import csv
+import json
+import math
+import os
+import subprocess
+import sys
+import threading
+import time
+from pathlib import Path
+from typing import Dict, List, Optional
+
+from p4_generator import Parameters, generate
+
+# The architecture of the programs given to each compiler, and the option naming
+# its output file, if it writes one.
+COMPILERS = {
+    "p4test": ("v1model", None),
+    "p4c-bm2-ss": ("v1model", "-o"),
+    "p4c-dpdk": ("pna", "-o"),
+    "p4c-ebpf": ("ebpf", "-o"),
+}
+OUTPUT_SUFFIX = {"p4c-bm2-ss": ".json", "p4c-dpdk": ".spec", "p4c-ebpf": ".c"}
+
+
+def read_profile(path: Path) -> List[Dict]:
+    """Returns the rows of a --pass-profile CSV file."""
+    if not path.exists():
+        return []
+    with open(path, encoding="utf-8") as profile:
+        rows = []
+        for row in csv.DictReader(profile):
+            rows.append(
+                {
+                    "pass": row["pass"],
+                    "depth": int(row["depth"]),
+                    "invocations": int(row["invocations"]),
+                    "wall_ms": float(row["wall_ms"]),
+                    "bytes_allocated": int(row["bytes_allocated"]),
+                }
+            )
+        return rows
+
+
+def run(compiler: Path, arch_output: Optional[str], program: Path, out_dir: Path,
+        includes: List[str], timeout: int) -> Dict:
+    """Compiles `program` in a child process; returns its wall time, peak RSS and profile."""
+    profile = out_dir / (program.stem + "." + compiler.name + ".profile.csv")
+    command = [str(compiler)]
+    for include in includes:
+        command += ["-I", include]
+    if arch_output:
+        output = out_dir / (program.stem + OUTPUT_SUFFIX.get(compiler.name, ".out"))
+        command += [arch_output, str(output)]
+    command += ["--pass-profile", str(profile), str(program)]
+
+    errors = out_dir / (program.stem + "." + compiler.name + ".stderr")
+    start = time.monotonic()
+    with open(errors, "wb") as stderr:
+        child = subprocess.Popen(command, stdout=subprocess.DEVNULL, stderr=stderr)
+        # wait4, rather than Popen.wait, gives the resource usage of this child alone.
+        timer = threading.Timer(timeout, child.kill)
+        timer.start()
+        _, status, usage = os.wait4(child.pid, 0)
+        timer.cancel()
+    wall = time.monotonic() - start
+    returncode = os.waitstatus_to_exitcode(status)
+    child.returncode = returncode
+    return {
+        "returncode": returncode,
+        "wall_s": round(wall, 3),
+        # ru_maxrss is in kilobytes on Linux.
+        "peak_rss_kb": usage.ru_maxrss,
+        "errors": errors.read_text(errors="replace")[-2000:] if returncode else "",
+        "passes": read_profile(profile),
+    }
+
+
+def growth_exponent(points: List[tuple]) -> Optional[float]:
+    """The slope of log(value) against log(size) between the first and last points."""
+    points = [(s, v) for s, v in points if v > 0]
+    if len(points) < 2 or points[0][0] == points[-1][0]:
+        return None
+    (s0, v0), (s1, v1) = points[0], points[-1]
+    return math.log(v1 / v0) / math.log(s1 / s0)
+
+
+def report(results: List[Dict], threshold: float) -> int:
+    """Prints the compilers and passes that grow faster than linearly; returns their count."""
+    superlinear = 0
+    for compiler in sorted({r["compiler"] for r in results}):
+        runs = sorted((r for r in results if r["compiler"] == compiler and r["returncode"] == 0),
+                      key=lambda r: r["program_lines"])
+        exponent = growth_exponent([(r["program_lines"], r["wall_s"]) for r in runs])
+        if exponent is None:
+            continue
+        print(f"{compiler}: time grows as lines^{exponent:.2f}")
+        if exponent <= threshold:
+            continue
+        superlinear += 1
+        first, last = runs[0]["passes"], runs[-1]["passes"]
+        before = {p["pass"]: p["wall_ms"] for p in first}
+        growth = []
+        for p in last:
+            if p["pass"] in before:
+                pass_exponent = growth_exponent([(runs[0]["program_lines"], before[p["pass"]]),
+                                                 (runs[-1]["program_lines"], p["wall_ms"])])
+                if pass_exponent is not None and pass_exponent > threshold:
+                    growth.append((p["wall_ms"], pass_exponent, p["pass"]))
+        for wall_ms, pass_exponent, name in sorted(growth, reverse=True)[:10]:
+            print(f"    {name}: {wall_ms:.1f} ms, lines^{pass_exponent:.2f}")
+    return superlinear
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--bin-dir", default=".", help="The directory of the compilers.")
+    parser.add_argument("--out-dir", default="compile-bench",
+                        help="The directory of the programs, outputs and results.")
+    parser.add_argument("--results", help="The results file; <out-dir>/results.jsonl by default.")
+    parser.add_argument("--compilers", default=",".join(COMPILERS),
+                        help="Comma-separated compilers to run; missing ones are skipped.")
+    parser.add_argument("--scales", default="1,2,4,8",
+                        help="Comma-separated factors applied to the base parameters.")
+    parser.add_argument("--vary", default="",
+                        help="Scale only this parameter (e.g. tables); all of them by default.")
+    parser.add_argument("-I", "--include", action="append", default=[],
+                        help="Directories with the architecture include files.")
+    parser.add_argument("--timeout", type=int, default=1800, help="Seconds per compilation.")
+    parser.add_argument("--threshold", type=float, default=1.3,
+                        help="Growth exponent above which a compiler or pass is reported.")
+    defaults = Parameters()
+    for name in vars(defaults):
+        parser.add_argument("--" + name.replace("_", "-"), type=int,
+                            default=getattr(defaults, name),
+                            help=f"The base {name.replace('_', ' ')}.")
+    args = parser.parse_args()
+
+    base = Parameters(**{name: getattr(args, name) for name in vars(defaults)})
+    if args.vary and args.vary not in vars(base):
+        parser.error(f"Unknown parameter {args.vary}")
+    out_dir = Path(args.out_dir)
+    out_dir.mkdir(parents=True, exist_ok=True)
+    results_path = Path(args.results) if args.results else out_dir / "results.jsonl"
+    scales = [int(s) for s in args.scales.split(",")]
+
+    results = []
+    for name in args.compilers.split(","):
+        if name not in COMPILERS:
+            parser.error(f"Unknown compiler {name}")
+        compiler = Path(args.bin_dir) / name
+        if not os.access(compiler, os.X_OK):
+            print(f"Skipping {name}: {compiler} not found", file=sys.stderr)
+            continue
+        arch, output_option = COMPILERS[name]
+        for scale in scales:
+            params = base.scaled(scale, args.vary)
+            program = out_dir / f"{params.name()}_{arch}.p4"
+            if not program.exists():
+                program.write_text(generate(params, arch), encoding="utf-8")
+            result = run(compiler, output_option, program, out_dir, args.include, args.timeout)
+            lines = program.read_text(encoding="utf-8").count("\n")
+            result.update({"compiler": name, "arch": arch, "scale": scale,
+                           "parameters": vars(params), "program": str(program),
+                           "program_lines": lines})
+            results.append(result)
+            with open(results_path, "a", encoding="utf-8") as out:
+                out.write(json.dumps(result) + "\n")
+            status = "ok" if result["returncode"] == 0 else f"failed ({result['returncode']})"
+            print(f"{name} {params.name()}: {result['wall_s']} s, "
+                  f"{result['peak_rss_kb']} KiB, {status}")
+
+    if report(results, args.threshold):
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
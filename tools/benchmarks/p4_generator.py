@@ -0,0 +1,265 @@
+#!/usr/bin/env python3
+"""Synthesizes P4-16 programs of a given size, for compile-time benchmarks.
+
+The programs are made of the same pieces whatever their size: a chain of
+headers, a parser whose states extract them and branch further ahead, and a
+pipeline of exact-match tables with their actions and constant entries.  Each
+piece grows with one parameter, so that the cost of each can be measured.
+"""
+
+import argparse
+import sys
+from dataclasses import dataclass, fields
+from typing import List
+
+# The architectures the programs can be written for, and the compilers using them.
+ARCHITECTURES = ("v1model", "pna", "ebpf")
+
+
+@dataclass
+class Parameters:
+    """The size of a generated program."""
+
+    tables: int = 8
+    headers: int = 4
+    parser_depth: int = 4
+    action_size: int = 4
+    const_entries: int = 4
+
+    def scaled(self, factor: int, only: str = "") -> "Parameters":
+        """Returns these parameters multiplied by factor: all of them, or only `only`."""
+        values = {}
+        for field in fields(self):
+            value = getattr(self, field.name)
+            values[field.name] = value * factor if not only or field.name == only else value
+        return Parameters(**values)
+
+    def name(self) -> str:
+        return (
+            f"t{self.tables}_h{self.headers}_p{self.parser_depth}"
+            f"_a{self.action_size}_e{self.const_entries}"
+        )
+
+
+class Generator:
+    """Writes the program of one architecture; the architecture wrappers are the
+    only parts that differ."""
+
+    def __init__(self, params: Parameters, arch: str) -> None:
+        if arch not in ARCHITECTURES:
+            raise ValueError(f"Unknown architecture {arch}")
+        self.params = params
+        self.arch = arch
+        self.lines: List[str] = []
+
+    def emit(self, line: str = "", indent: int = 0) -> None:
+        self.lines.append("    " * indent + line if line else "")
+
+    def header(self, index: int) -> str:
+        return f"hdr.h{index % max(self.params.headers, 1)}"
+
+    def declarations(self) -> None:
+        for i in range(self.params.headers):
+            self.emit(f"header h{i}_t {{")
+            self.emit("bit<8> kind;", 1)
+            self.emit("bit<16> f0;", 1)
+            self.emit("bit<32> f1;", 1)
+            self.emit("}")
+        self.emit()
+        self.emit("struct headers_t {")
+        for i in range(self.params.headers):
+            self.emit(f"h{i}_t h{i};", 1)
+        self.emit("}")
+        self.emit()
+        self.emit("struct metadata_t {")
+        self.emit("bit<32> scratch;", 1)
+        self.emit("}")
+        self.emit()
+
+    def parser_states(self, packet: str) -> None:
+        depth = self.params.parser_depth
+        if self.params.headers == 0 or depth == 0:
+            self.emit("state start {", 1)
+            self.emit("transition accept;", 2)
+            self.emit("}", 1)
+            return
+        for k in range(depth):
+            name = "start" if k == 0 else f"parse_{k}"
+            self.emit(f"state {name} {{", 1)
+            self.emit(f"{packet}.extract({self.header(k)});", 2)
+            successors = [s for s in (k + 1, k + 2) if s < depth]
+            if not successors:
+                self.emit("transition accept;", 2)
+            else:
+                self.emit(f"transition select({self.header(k)}.kind) {{", 2)
+                for s in successors:
+                    self.emit(f"{s}: parse_{s};", 3)
+                self.emit("default: accept;", 3)
+                self.emit("}", 2)
+            self.emit("}", 1)
+
+    def tables(self) -> None:
+        p = self.params
+        for t in range(p.tables):
+            self.emit(f"action set_{t}(bit<32> value) {{", 1)
+            for s in range(p.action_size):
+                target = self.header(t + s)
+                self.emit(f"{target}.f1 = {target}.f1 + value + {s + 1};", 2)
+            self.emit("}", 1)
+            self.emit(f"action mark_{t}() {{", 1)
+            self.emit(f"{self.header(t)}.f0 = {t % 65536};", 2)
+            self.emit("}", 1)
+            self.emit(f"table table_{t} {{", 1)
+            self.emit(f"key = {{ {self.header(t)}.f1 : exact; }}", 2)
+            self.emit(f"actions = {{ set_{t}; mark_{t}; NoAction; }}", 2)
+            if p.const_entries:
+                self.emit("const entries = {", 2)
+                for e in range(p.const_entries):
+                    if e % 2:
+                        self.emit(f"{e} : mark_{t}();", 3)
+                    else:
+                        self.emit(f"{e} : set_{t}({e + t});", 3)
+                self.emit("}", 2)
+            self.emit(f"size = {max(p.const_entries, 1) * 2};", 2)
+            self.emit("default_action = NoAction();", 2)
+            self.emit("}", 1)
+
+    def apply_tables(self, indent: int) -> None:
+        for t in range(self.params.tables):
+            if self.params.headers:
+                self.emit(f"if ({self.header(t)}.isValid()) {{ table_{t}.apply(); }}", indent)
+            else:
+                self.emit(f"table_{t}.apply();", indent)
+
+    def emit_all(self, packet: str, indent: int) -> None:
+        for i in range(self.params.headers):
+            self.emit(f"{packet}.emit(hdr.h{i});", indent)
+
+    def v1model(self) -> None:
+        self.emit("#include <core.p4>")
+        self.emit("#include <v1model.p4>")
+        self.emit()
+        self.declarations()
+        self.emit("parser ParserImpl(packet_in packet, out headers_t hdr, inout metadata_t meta,")
+        self.emit("                  inout standard_metadata_t standard_metadata) {")
+        self.parser_states("packet")
+        self.emit("}")
+        self.emit()
+        self.emit("control VerifyChecksumImpl(inout headers_t hdr, inout metadata_t meta) {")
+        self.emit("apply { }", 1)
+        self.emit("}")
+        self.emit()
+        self.emit("control IngressImpl(inout headers_t hdr, inout metadata_t meta,")
+        self.emit("                    inout standard_metadata_t standard_metadata) {")
+        self.tables()
+        self.emit("apply {", 1)
+        self.apply_tables(2)
+        self.emit("}", 1)
+        self.emit("}")
+        self.emit()
+        self.emit("control EgressImpl(inout headers_t hdr, inout metadata_t meta,")
+        self.emit("                   inout standard_metadata_t standard_metadata) {")
+        self.emit("apply { }", 1)
+        self.emit("}")
+        self.emit()
+        self.emit("control ComputeChecksumImpl(inout headers_t hdr, inout metadata_t meta) {")
+        self.emit("apply { }", 1)
+        self.emit("}")
+        self.emit()
+        self.emit("control DeparserImpl(packet_out packet, in headers_t hdr) {")
+        self.emit("apply {", 1)
+        self.emit_all("packet", 2)
+        self.emit("}", 1)
+        self.emit("}")
+        self.emit()
+        self.emit("V1Switch(ParserImpl(), VerifyChecksumImpl(), IngressImpl(), EgressImpl(),")
+        self.emit("         ComputeChecksumImpl(), DeparserImpl()) main;")
+
+    def pna(self) -> None:
+        self.emit("#include <core.p4>")
+        self.emit("#include <pna.p4>")
+        self.emit()
+        self.declarations()
+        self.emit("control PreControlImpl(in headers_t hdr, inout metadata_t meta,")
+        self.emit("                       in pna_pre_input_metadata_t istd,")
+        self.emit("                       inout pna_pre_output_metadata_t ostd) {")
+        self.emit("apply { }", 1)
+        self.emit("}")
+        self.emit()
+        self.emit("parser MainParserImpl(packet_in pkt, out headers_t hdr, inout metadata_t meta,")
+        self.emit("                      in pna_main_parser_input_metadata_t istd) {")
+        self.parser_states("pkt")
+        self.emit("}")
+        self.emit()
+        self.emit("control MainControlImpl(inout headers_t hdr, inout metadata_t meta,")
+        self.emit("                        in pna_main_input_metadata_t istd,")
+        self.emit("                        inout pna_main_output_metadata_t ostd) {")
+        self.tables()
+        self.emit("apply {", 1)
+        self.apply_tables(2)
+        self.emit("send_to_port((PortId_t)0);", 2)
+        self.emit("}", 1)
+        self.emit("}")
+        self.emit()
+        self.emit("control MainDeparserImpl(packet_out pkt, in headers_t hdr, in metadata_t meta,")
+        self.emit("                         in pna_main_output_metadata_t ostd) {")
+        self.emit("apply {", 1)
+        self.emit_all("pkt", 2)
+        self.emit("}", 1)
+        self.emit("}")
+        self.emit()
+        self.emit("PNA_NIC(MainParserImpl(), PreControlImpl(), MainControlImpl(),")
+        self.emit("        MainDeparserImpl()) main;")
+
+    def ebpf(self) -> None:
+        self.emit("#include <core.p4>")
+        self.emit("#include <ebpf_model.p4>")
+        self.emit()
+        self.declarations()
+        self.emit("parser prs(packet_in packet, out headers_t hdr) {")
+        self.parser_states("packet")
+        self.emit("}")
+        self.emit()
+        self.emit("control pipe(inout headers_t hdr, out bool pass) {")
+        self.tables()
+        self.emit("apply {", 1)
+        self.emit("pass = true;", 2)
+        self.apply_tables(2)
+        self.emit("}", 1)
+        self.emit("}")
+        self.emit()
+        self.emit("ebpfFilter(prs(), pipe()) main;")
+
+    def generate(self) -> str:
+        self.lines = [f"// Generated by p4_generator.py: {self.params.name()} ({self.arch})", ""]
+        getattr(self, self.arch)()
+        return "\n".join(self.lines) + "\n"
+
+
+def generate(params: Parameters, arch: str) -> str:
+    """Returns the text of the program of size `params` for `arch`."""
+    return Generator(params, arch).generate()
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__)
+    defaults = Parameters()
+    for field in fields(Parameters):
+        option = "--" + field.name.replace("_", "-")
+        parser.add_argument(option, type=int, default=getattr(defaults, field.name))
+    parser.add_argument("--arch", choices=ARCHITECTURES, default="v1model")
+    parser.add_argument("-o", "--output", help="The output file; standard output by default.")
+    args = parser.parse_args()
+
+    params = Parameters(**{field.name: getattr(args, field.name) for field in fields(Parameters)})
+    program = generate(params, args.arch)
+    if args.output:
+        with open(args.output, "w", encoding="utf-8") as output:
+            output.write(program)
+    else:
+        sys.stdout.write(program)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -17,6 +17,8 @@ p4c - P4 Compiler Driver
 """
 
 import argparse
+import concurrent.futures
+import copy
 import glob
 import os
 import re
@@ -99,6 +101,47 @@ def add_developer_options(parser):
     )
 
 
+def find_backend(cfg, target, arch):
+    for backend in cfg.target:
+        regex = backend._backend.replace("*", "[a-zA-Z0-9*]*")
+        pattern = re.compile(regex)
+        if pattern.match(target + "-" + arch):
+            return backend
+    return None
+
+
+def run_backends(opts, requested, backends):
+    """Compiles the program for each of the backends, with the (target, arch)
+    pairs in requested.  The first backend runs the frontend and stores its
+    result in an IR cache, which the others, run in parallel, load instead of
+    running the frontend again.  Each backend writes its outputs in its own
+    subdirectory of the output directory.  Returns the first non-zero exit
+    code, or 0."""
+    ir_cache = os.path.join(opts.output_directory, "ir-cache")
+    if not opts.dry_run:
+        os.makedirs(ir_cache, exist_ok=True)
+    for backend, (target, arch) in zip(backends, requested):
+        backend_opts = copy.copy(opts)
+        backend_opts.target = target
+        backend_opts.arch = arch
+        backend_opts.output_directory = os.path.join(
+            opts.output_directory, "{}-{}".format(target, arch)
+        )
+        backend_opts.compiler_options = opts.compiler_options + [
+            "--ir-cache '{}'".format(ir_cache)
+        ]
+        backend.process_command_line_options(backend_opts)
+
+    rc = backends[0].run()
+    if rc != 0 or len(backends) == 1:
+        return rc
+    # With -### only the commands are printed; keep them in order.
+    workers = 1 if opts.dry_run else len(backends) - 1
+    with concurrent.futures.ThreadPoolExecutor(max_workers=workers) as pool:
+        rcs = list(pool.map(lambda backend: backend.run(), backends[1:]))
+    return next((rc for rc in rcs if rc != 0), 0)
+
+
 def s_and_were_or_just_was(parameter):
     """a utility function for grammatical correctness [and DRY, i.e. Don`t Repeat Yourself]"""
     return "s were" if parameter != 1 else " was"
@@ -210,6 +253,20 @@ def main():
         action="store",
         default=p4c_default_arch,
     )
+    parser.add_argument(
+        "--targets",
+        dest="targets",
+        metavar="<target>-<arch>,...",
+        help=(
+            "Compile for several targets at once, e.g. bmv2-psa,dpdk-psa,ebpf-psa, "
+            "instead of the one given by --target and --arch.  The frontend runs "
+            "once and the other backends reuse its result.  The outputs of each "
+            "target are written in a subdirectory of the output directory named "
+            "after the target."
+        ),
+        action="store",
+        default=None,
+    )
     parser.add_argument(
         "-c",
         "--compile",
@@ -494,16 +551,22 @@ def main():
             "Invalid target and arch tuple: {}\n{}".format(backend, display_supported_targets(cfg))
         )
 
-    # find the backend
-    backend = None
-    for target in cfg.target:
-        regex = target._backend.replace("*", "[a-zA-Z0-9*]*")
-        pattern = re.compile(regex)
-        if pattern.match(opts.target + "-" + opts.arch):
-            backend = target
-            break
-    if backend is None:
-        parser.error("Unknown backend: {}-{}".format(str(opts.target), str(opts.arch)))
+    # find the backends
+    if opts.targets is None:
+        requested = [(opts.target, opts.arch)]
+    else:
+        requested = [tuple(name.strip().split("-", 1)) for name in opts.targets.split(",")]
+    backends = []
+    for target_and_arch in requested:
+        if len(target_and_arch) != 2:
+            parser.error("Invalid target and arch pair: {}".format("-".join(target_and_arch)))
+        backend = find_backend(cfg, *target_and_arch)
+        if backend is None:
+            parser.error("Unknown backend: {}-{}".format(*target_and_arch))
+        if backend in backends:
+            parser.error("Backend {} is given more than once in --targets".format(backend))
+        backends.append(backend)
+    backend = backends[0]
     error_count = 0
 
     JSON_input_specified = env_indicates_developer_build and opts.json_source
@@ -649,6 +712,9 @@ def main():
     ###   as it was before Abe touched this file.
     opts.__setattr__("source_file", string_to_pass_as___source_file)
 
+    if opts.targets is not None:
+        sys.exit(run_backends(opts, requested, backends))
+
     # set all configuration and command line options for backend
     backend.process_command_line_options(opts)
 
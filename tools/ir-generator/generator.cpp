@@ -36,6 +36,7 @@ void usage(const char *progname) {
     fprintf(stderr, "     -t file: file where the tree macro is written\n");
     fprintf(stderr, "     -h: print this message and exit\n");
     fprintf(stderr, "     -P: don't generate #line directives\n");
+    fprintf(stderr, "     -L: order the fields of each class by alignment to reduce padding\n");
 }
 
 int main(int argc, char *argv[]) {
@@ -44,7 +45,7 @@ int main(int argc, char *argv[]) {
     std::ostream *impl = new nullstream();
 
     while (true) {
-        int opt = getopt(argc, argv, "o:i:t:hP");
+        int opt = getopt(argc, argv, "o:i:t:hPL");
         if (opt == -1) break;
 
         switch (opt) {
@@ -66,6 +67,9 @@ int main(int argc, char *argv[]) {
             case 'P':
                 LineDirective::inhibit = true;
                 break;
+            case 'L':
+                IrClass::reorderFields = true;
+                break;
             default:
                 std::cerr << "Unknown option: " << opt << std::endl;
                 usage(argv[0]);
@@ -16,10 +16,13 @@ limitations under the License.
 
 #include "irclass.h"
 
+#include <algorithm>
+
 #include "lib/enumerator.h"
 #include "lib/exceptions.h"
 
 const char *IrClass::indent = "    ";
+bool IrClass::reorderFields = false;
 IrNamespace &IrNamespace::global() {
     static IrNamespace irn(nullptr, nullptr);
     return irn;
@@ -111,6 +114,9 @@ void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &i
 
     impl << "#include \"ir/ir-generated.h\"    // IWYU pragma: keep\n\n"
          << "#include \"ir/ir-inline.h\"       // IWYU pragma: keep\n"
+         << "#include \"ir/binary_loader.h\"   // IWYU pragma: keep\n"
+         << "#include \"ir/binary_writer.h\"   // IWYU pragma: keep\n"
+         << "#include \"ir/equiv_hash.h\"      // IWYU pragma: keep\n"
          << "#include \"ir/json_generator.h\"  // IWYU pragma: keep\n"
          << "#include \"ir/json_loader.h\"     // IWYU pragma: keep\n"
          << "#include \"ir/visitor.h\"         // IWYU pragma: keep\n"
@@ -131,9 +137,14 @@ void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &i
         << std::endl
         << "class JSONLoader;\n"
         << "using NodeFactoryFn = IR::Node*(*)(JSONLoader&);\n"
+        << "class BinaryIRLoader;\n"
+        << "using BinaryNodeFactoryFn = IR::Node*(*)(BinaryIRLoader&);\n"
         << std::endl
         << "namespace IR {\n"
         << "extern std::map<cstring, NodeFactoryFn> unpacker_table;\n"
+        << "extern std::map<cstring, BinaryNodeFactoryFn> binary_unpacker_table;\n"
+        << "// Writes the name and sizeof of every concrete IR class, one class per line\n"
+        << "void printNodeSizes(std::ostream &out);\n"
         << "}\n";
 
     impl << "std::map<cstring, NodeFactoryFn> IR::unpacker_table = {\n";
@@ -152,6 +163,33 @@ void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &i
     }
     impl << " };\n" << std::endl;
 
+    impl << "std::map<cstring, BinaryNodeFactoryFn> IR::binary_unpacker_table = {\n";
+    first = true;
+    for (auto cls : *getClasses()) {
+        if (cls->kind == NodeKind::Concrete) {
+            if (first)
+                first = false;
+            else
+                impl << ",\n";
+            impl << "{\"" << cls->name << "\", BinaryNodeFactoryFn(&IR::";
+            if (cls->containedIn && cls->containedIn->name) impl << cls->containedIn->name << "::";
+            impl << cls->name << "::fromBinary)}";
+        }
+    }
+    impl << " };\n" << std::endl;
+
+    impl << "void IR::printNodeSizes(std::ostream &out) {\n";
+    for (auto cls : *getClasses()) {
+        if (cls->kind == NodeKind::Concrete) {
+            cstring name = cls->name;
+            if (cls->containedIn && cls->containedIn->name)
+                name = cls->containedIn->name + "::" + name;
+            impl << IrClass::indent << "out << \"" << name << " \" << sizeof(IR::" << name
+                 << ") << '\\n';\n";
+        }
+    }
+    impl << "}\n" << std::endl;
+
     for (auto e : elements) {
         e->generate_hdr(out);
         e->generate_impl(impl);
@@ -196,6 +234,23 @@ void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &i
     }
     t << std::endl;
 
+    // Emit the classes a node can actually be an instance of, for type switches
+    t << "#define IRNODE_ALL_CONCRETE_SUBCLASSES(M, ...) \\" << std::endl;
+    for (auto cls : *getClasses())
+        if (cls->kind == NodeKind::Concrete)
+            t << "M(" << cls->containedIn << cls->name << ", ##__VA_ARGS__) \\" << std::endl;
+    t << "M(Vector<IR::Node>, ##__VA_ARGS__) \\" << std::endl;
+    t << "M(IndexedVector<IR::Node>, ##__VA_ARGS__) \\" << std::endl;
+    for (auto cls : *getClasses()) {
+        if (cls->needVector || cls->needIndexedVector)
+            t << "M(Vector<IR::" << cls->containedIn << cls->name << ">, ##__VA_ARGS__) \\"
+              << std::endl;
+        if (cls->needIndexedVector)
+            t << "M(IndexedVector<IR::" << cls->containedIn << cls->name
+              << ">, ##__VA_ARGS__) \\" << std::endl;
+    }
+    t << std::endl;
+
     t << "namespace IR {" << std::endl;
 
     // Emit forward declarations
@@ -411,9 +466,42 @@ void IrClass::generate_hdr(std::ostream &out) const {
     out << " {" << std::endl;
 
     auto access = IrElement::Private;
-    for (auto e : elements) {
+    auto generate = [&out, &access](const IrElement *e) {
         if (e->access != access) out << (access = e->access);
         e->generate_hdr(out);
+    };
+    if (!reorderFields) {
+        for (auto e : elements) generate(e);
+    } else {
+        // All fields are declared where the first one appears in the .def file, each
+        // together with the comments directly before it.
+        std::map<const IrElement *, std::vector<const IrElement *>> fieldComments;
+        std::set<const IrElement *> moved;
+        std::vector<const IrElement *> pending;
+        for (auto e : elements) {
+            if (e->is<CommentBlock>()) {
+                pending.push_back(e);
+                continue;
+            }
+            if (e->is<IrField>() && !e->to<IrField>()->isStatic) {
+                fieldComments[e] = pending;
+                moved.insert(pending.begin(), pending.end());
+                moved.insert(e);
+            }
+            pending.clear();
+        }
+        bool fieldsDone = false;
+        for (auto e : elements) {
+            if (!moved.count(e)) {
+                generate(e);
+            } else if (!fieldsDone) {
+                fieldsDone = true;
+                for (auto field : fieldLayout()) {
+                    for (auto comment : fieldComments[field]) generate(comment);
+                    generate(field);
+                }
+            }
+        }
     }
 
     if (kind != NodeKind::Interface && kind != NodeKind::Nested)
@@ -470,23 +558,41 @@ int IrClass::generateConstructor(const ctor_args_t &arglist, const IrMethod *use
     const char *sep = ":\n    ";
     auto parent = getParent() ? getParent()->qualified_name(containedIn) : cstring();
     const char *end_parent = "";
+    std::vector<const IrField *> fields;
     for (auto &arg : arglist) {
         if (arg.first->optional && (skip_opt & (1U << optargs++))) continue;
         if (arg.second == this) {
-            body << end_parent;
-            end_parent = "";
-        } else if (parent) {
+            fields.push_back(arg.first);
+            continue;
+        }
+        if (parent) {
             body << sep << parent;
             parent = nullptr;
             sep = "(";
             end_parent = ")";
         }
         body << sep << arg.first->name;
-        if (arg.second == this) body << "(" << arg.first->name << ")";
+        sep = ", ";
+    }
+    body << end_parent;
+
+    if (reorderFields) {
+        // initialize the fields in the order they are declared, as -Wreorder expects
+        auto layout = fieldLayout();
+        auto position = [&layout](const IrField *f) {
+            return std::find(layout.begin(), layout.end(), f) - layout.begin();
+        };
+        std::stable_sort(fields.begin(), fields.end(),
+                         [&position](const IrField *a, const IrField *b) {
+                             return position(a) < position(b);
+                         });
+    }
+    for (auto field : fields) {
+        body << sep << field->name << "(" << field->name << ")";
         sep = ", ";
     }
 
-    body << end_parent << std::endl << indent << "{";
+    body << std::endl << indent << "{";
     if (user)
         body << '\n'
              << LineDirective(user->getSourceInfo()) << user->body << '\n'
@@ -514,6 +620,38 @@ Util::Enumerator<IrField *> *IrClass::getFields() const {
         ->where([](IrField *f) { return !f->isStatic; });
 }
 
+// Estimated alignment of the type of a field on a 64-bit host.  Anything that is not a
+// known scalar is assumed to need 8 bytes, which at worst leaves some padding in place.
+static int fieldAlignment(const IrClass *cls, const IrField *field) {
+    const Type *type = field->type;
+    while (auto arr = dynamic_cast<const ArrayType *>(type)) type = arr->base;
+    if (!dynamic_cast<const NamedType *>(type) || type->resolve(cls->containedIn)) return 8;
+    static const std::map<cstring, int> scalars = {
+        {"bool", 1},     {"char", 1},     {"int8_t", 1},   {"uint8_t", 1},  {"short", 2},
+        {"int16_t", 2},  {"uint16_t", 2}, {"int", 4},      {"unsigned", 4}, {"float", 4},
+        {"int32_t", 4},  {"uint32_t", 4}, {"size_t", 8},   {"int64_t", 8},  {"uint64_t", 8},
+        {"double", 8},   {"long", 8},     {"cstring", 8},
+    };
+    cstring name = type->toString();
+    if (auto it = scalars.find(name); it != scalars.end()) return it->second;
+    // enums declared in the class itself have an int underlying type
+    for (auto e : cls->elements) {
+        auto en = e->to<IrEnumType>();
+        if (en && (name == en->name || name.endsWith("::" + en->name))) return 4;
+    }
+    return 8;
+}
+
+std::vector<const IrField *> IrClass::fieldLayout() const {
+    std::vector<const IrField *> rv;
+    for (auto field : *getFields()) rv.push_back(field);
+    if (reorderFields)
+        std::stable_sort(rv.begin(), rv.end(), [this](const IrField *a, const IrField *b) {
+            return fieldAlignment(this, a) > fieldAlignment(this, b);
+        });
+    return rv;
+}
+
 Util::Enumerator<IrMethod *> *IrClass::getUserMethods() const {
     return Util::Enumerator<IrElement *>::createEnumerator(elements)
         ->where([](IrElement *e) { return e->is<IrMethod>(); })
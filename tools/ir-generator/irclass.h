@@ -267,6 +267,8 @@ class IrClass : public IrElement {
     access_t current_access = Public;        // used while parsing the class body
 
     static const char *indent;
+    // declare the fields in order of decreasing alignment instead of the .def order
+    static bool reorderFields;
 
     IrClass(Util::SourceInfo info, IrNamespace *ns, NodeKind kind, cstring name,
             const std::initializer_list<const Type *> &parents,
@@ -320,6 +322,8 @@ class IrClass : public IrElement {
     cstring toString() const override { return name; }
     std::string fullName() const;
     Util::Enumerator<IrField *> *getFields() const;
+    // the non-static fields in the order they are declared in the generated class
+    std::vector<const IrField *> fieldLayout() const;
     Util::Enumerator<IrMethod *> *getUserMethods() const;
     cstring qualified_name(const IrNamespace *ctxt = nullptr) const;
     // name with scope qual if needed in the context
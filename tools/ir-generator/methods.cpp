@@ -70,6 +70,43 @@ const ordered_map<cstring, IrMethod::info_t> IrMethod::Generate = {
           buf << cl->indent << "}";
           return buf.str();
       }}},
+    // Must come before "equiv", so that a user-defined equiv can be told apart from the
+    // generated one: the hash then covers only what the base classes compare.
+    {"computeEquivHash",
+     {&NamedType::Size_t(),
+      {},
+      CONST + IN_IMPL + OVERRIDE,
+      [](IrClass *cl, Util::SourceInfo, cstring) -> cstring {
+          std::stringstream buf;
+          buf << "{" << std::endl;
+          buf << cl->indent << cl->indent << "size_t h = "
+              << cl->getParent()->qualified_name(cl->containedIn) << "::computeEquivHash();"
+              << std::endl;
+          bool userEquiv = Util::Enumerator<IrElement *>::createEnumerator(cl->elements)
+                               ->where([](IrElement *el) {
+                                   auto *m = el->to<IrMethod>();
+                                   return m && m->name == "equiv";
+                               })
+                               ->any();
+          if (!userEquiv) {
+              for (auto f : *cl->getFields()) {
+                  if (*f->type == NamedType::SourceInfo()) continue;
+                  if (dynamic_cast<const ArrayType *>(f->type)) continue;
+                  buf << cl->indent << cl->indent << "h = Util::hash_combine(h, ";
+                  if (f->type->resolve(cl->containedIn) == nullptr)
+                      // This is not an IR pointer
+                      buf << "IR::equivHashValue(" << f->name << ")";
+                  else if (f->isInline)
+                      buf << f->name << ".equivHash()";
+                  else
+                      buf << "(" << f->name << " ? " << f->name << "->equivHash() : 0)";
+                  buf << ");" << std::endl;
+              }
+          }
+          buf << cl->indent << cl->indent << "return h;" << std::endl;
+          buf << cl->indent << "}";
+          return buf.str();
+      }}},
     {"equiv",
      {&NamedType::Bool(),
       {new IrField(new ReferenceType(new NamedType(IrClass::nodeClass()), true), "a_")},
@@ -274,6 +311,51 @@ const ordered_map<cstring, IrMethod::info_t> IrMethod::Generate = {
           buf << "{ return new " << cl->name << "(json); }";
           return buf.str();
       }}},
+    {"toBinary",
+     {&NamedType::Void(),
+      {new IrField(new ReferenceType(&NamedType::BinaryIRWriter()), "bin")},
+      CONST + IN_IMPL + OVERRIDE + INCL_NESTED,
+      [](IrClass *cl, Util::SourceInfo, cstring) -> cstring {
+          std::stringstream buf;
+          buf << "{" << std::endl;
+          if (auto parent = cl->getParent())
+              buf << cl->indent << parent->qualified_name(cl->containedIn) << "::toBinary(bin);"
+                  << std::endl;
+          for (auto f : *cl->getFields()) {
+              if (*f->type == NamedType::SourceInfo()) continue;
+              buf << cl->indent << "bin << this->" << f->name << ";" << std::endl;
+          }
+          buf << "}";
+          return buf.str();
+      }}},
+    // Must read the fields in the order toBinary writes them.
+    {"binary_constructor",
+     {nullptr,
+      {new IrField(new ReferenceType(&NamedType::BinaryIRLoader()), "bin")},
+      IN_IMPL + CONSTRUCTOR + INCL_NESTED,
+      [](IrClass *cl, Util::SourceInfo, cstring) -> cstring {
+          std::stringstream buf;
+          if (auto parent = cl->getParent())
+              buf << ": " << parent->qualified_name(cl->containedIn) << "(bin)";
+          buf << " {" << std::endl;
+          for (auto f : *cl->getFields()) {
+              if (*f->type == NamedType::SourceInfo()) continue;
+              buf << cl->indent << "bin >> " << f->name << ";" << std::endl;
+          }
+          buf << "}";
+          return buf.str();
+      }}},
+    {"fromBinary",
+     {nullptr,
+      {
+          new IrField(new ReferenceType(&NamedType::BinaryIRLoader()), "bin"),
+      },
+      FACTORY + IN_IMPL + CONCRETE_ONLY + INCL_NESTED,
+      [](IrClass *cl, Util::SourceInfo, cstring) -> cstring {
+          std::stringstream buf;
+          buf << "{ return new " << cl->name << "(bin); }";
+          return buf.str();
+      }}},
     {"toString",
      {&NamedType::Cstring(),
       {},
@@ -348,7 +430,7 @@ void IrClass::generateMethods() {
         if (!IrMethod::Generate.count(m->name))
             throw Util::CompilationError("Unrecognized predefined method %1%", m->name);
         auto &info = IrMethod::Generate.at(m->name);
-        if (m->name) {
+        if (m->name && !(info.flags & CONSTRUCTOR)) {
             if (info.rtype) {
                 // This predefined method has an explicit return type.
                 m->rtype = info.rtype;
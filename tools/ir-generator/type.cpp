@@ -80,6 +80,11 @@ NamedType &NamedType::Int() {
     return nt;
 }
 
+NamedType &NamedType::Size_t() {
+    static NamedType nt("size_t");
+    return nt;
+}
+
 NamedType &NamedType::Void() {
     static NamedType nt("void");
     return nt;
@@ -120,6 +125,16 @@ NamedType &NamedType::JSONObject() {
     return nt;
 }
 
+NamedType &NamedType::BinaryIRWriter() {
+    static NamedType nt("BinaryIRWriter");
+    return nt;
+}
+
+NamedType &NamedType::BinaryIRLoader() {
+    static NamedType nt("BinaryIRLoader");
+    return nt;
+}
+
 NamedType &NamedType::SourceInfo() {
     static NamedType nt(new LookupScope("Util"), "SourceInfo");
     return nt;